@@ -6,6 +6,8 @@
  */
 
 #include "SkBenchmark.h"
+#include "SkBitmapProcState.h"
+#include "SkBitmapScaler.h"
 #include "SkCanvas.h"
 #include "SkRandom.h"
 #include "SkShader.h"
@@ -51,12 +53,60 @@ private:
     typedef SkBenchmark INHERITED;
 };
 
+// This bench resizes a small icon with SkBitmapScaler's Mitchell (bicubic) filter over and
+// over, as drawing the same icons at the same scale does, where computing the filter weights
+// costs as much as applying them.
+
+class BicubicResizeBench : public SkBenchmark {
+    enum { N = SkBENCHLOOP(100) };
+    int                 fSrcSize;
+    int                 fDstSize;
+    SkBitmap            fSrc;
+    SkConvolutionProcs  fProcs;
+    SkString            fName;
+
+public:
+    BicubicResizeBench(void* param, int srcSize, int dstSize)
+        : INHERITED(param), fSrcSize(srcSize), fDstSize(dstSize) {
+        fName.printf("bicubic_resize_%d_%d", srcSize, dstSize);
+        fIsRendering = false;
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onPreDraw() {
+        fSrc.setConfig(SkBitmap::kARGB_8888_Config, fSrcSize, fSrcSize);
+        fSrc.allocPixels();
+        fSrc.eraseColor(0x80336699);
+        sk_bzero(&fProcs, sizeof(fProcs));
+        SkBitmapProcState::platformConvolutionProcs(&fProcs);
+    }
+
+    virtual void onDraw(SkCanvas*) {
+        for (int i = 0; i < N; i++) {
+            SkBitmap dst;
+            SkBitmapScaler::Resize(&dst, fSrc, SkBitmapScaler::RESIZE_MITCHELL,
+                                   fDstSize, fDstSize, fProcs);
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
 static SkBenchmark* Fact00(void* p) { return new BicubicBench(p, 10.0f, 10.0f); }
 static SkBenchmark* Fact01(void* p) { return new BicubicBench(p, 2.5f, 10.0f); }
 static SkBenchmark* Fact02(void* p) { return new BicubicBench(p, 10.0f, 2.5f); }
 static SkBenchmark* Fact03(void* p) { return new BicubicBench(p, 2.5f, 2.5f); }
+static SkBenchmark* Fact04(void* p) { return new BicubicResizeBench(p, 32, 24); }
+static SkBenchmark* Fact05(void* p) { return new BicubicResizeBench(p, 64, 48); }
 
 static BenchRegistry gReg00(Fact00);
 static BenchRegistry gReg01(Fact01);
 static BenchRegistry gReg02(Fact02);
 static BenchRegistry gReg03(Fact03);
+static BenchRegistry gReg04(Fact04);
+static BenchRegistry gReg05(Fact05);
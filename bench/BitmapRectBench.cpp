@@ -38,10 +38,18 @@ static void draw_into_bitmap(const SkBitmap& bm) {
     paint : filter-p
  */
 
+enum MatrixType {
+    kIdentity_MatrixType,
+    kSlightTrans_MatrixType,    // fractional translate, almost no scale
+    kScale_MatrixType,          // fractional translate and a real scale
+};
+
+static const char* gMatrixTypeName[] = { "identity", "trans", "scale" };
+
 class BitmapRectBench : public SkBenchmark {
     SkBitmap    fBitmap;
     bool        fDoFilter;
-    bool        fSlightMatrix;
+    MatrixType  fMatrixType;
     uint8_t     fAlpha;
     SkString    fName;
     SkRect      fSrcR, fDstR;
@@ -49,10 +57,11 @@ class BitmapRectBench : public SkBenchmark {
     static const int kHeight = 128;
     enum { N = SkBENCHLOOP(300) };
 public:
-    BitmapRectBench(void* param, U8CPU alpha, bool doFilter, bool slightMatrix) : INHERITED(param) {
+    BitmapRectBench(void* param, U8CPU alpha, bool doFilter, MatrixType matrixType)
+        : INHERITED(param) {
         fAlpha = SkToU8(alpha);
         fDoFilter = doFilter;
-        fSlightMatrix = slightMatrix;
+        fMatrixType = matrixType;
 
         fBitmap.setConfig(SkBitmap::kARGB_8888_Config, kWidth, kHeight);
     }
@@ -61,7 +70,7 @@ protected:
     virtual const char* onGetName() SK_OVERRIDE {
         fName.printf("bitmaprect_%02X_%sfilter_%s",
                      fAlpha, fDoFilter ? "" : "no",
-                     fSlightMatrix ? "trans" : "identity");
+                     gMatrixTypeName[fMatrixType]);
         return fName.c_str();
     }
 
@@ -74,13 +83,18 @@ protected:
         fSrcR.iset(0, 0, kWidth, kHeight);
         fDstR.iset(0, 0, kWidth, kHeight);
 
-        if (fSlightMatrix) {
+        if (kIdentity_MatrixType != fMatrixType) {
             // want fractional translate
             fDstR.offset(SK_Scalar1 / 3, SK_Scalar1 * 5 / 7);
+        }
+        if (kSlightTrans_MatrixType == fMatrixType) {
             // want enough to create a scale matrix, but not enough to scare
             // off our sniffer which tries to see if the matrix is "effectively"
             // translate-only.
             fDstR.fRight += SK_Scalar1 / (kWidth * 60);
+        } else if (kScale_MatrixType == fMatrixType) {
+            fDstR.fRight += SkIntToScalar(kWidth) / 3;
+            fDstR.fBottom += SkIntToScalar(kHeight) / 5;
         }
     }
 
@@ -102,10 +116,14 @@ private:
     typedef SkBenchmark INHERITED;
 };
 
-DEF_BENCH(return new BitmapRectBench(p, 0xFF, false, false))
-DEF_BENCH(return new BitmapRectBench(p, 0x80, false, false))
-DEF_BENCH(return new BitmapRectBench(p, 0xFF, true, false))
-DEF_BENCH(return new BitmapRectBench(p, 0x80, true, false))
+DEF_BENCH(return new BitmapRectBench(p, 0xFF, false, kIdentity_MatrixType))
+DEF_BENCH(return new BitmapRectBench(p, 0x80, false, kIdentity_MatrixType))
+DEF_BENCH(return new BitmapRectBench(p, 0xFF, true, kIdentity_MatrixType))
+DEF_BENCH(return new BitmapRectBench(p, 0x80, true, kIdentity_MatrixType))
+
+DEF_BENCH(return new BitmapRectBench(p, 0xFF, false, kSlightTrans_MatrixType))
+DEF_BENCH(return new BitmapRectBench(p, 0xFF, true, kSlightTrans_MatrixType))
 
-DEF_BENCH(return new BitmapRectBench(p, 0xFF, false, true))
-DEF_BENCH(return new BitmapRectBench(p, 0xFF, true, true))
+DEF_BENCH(return new BitmapRectBench(p, 0xFF, false, kScale_MatrixType))
+DEF_BENCH(return new BitmapRectBench(p, 0xFF, true, kScale_MatrixType))
+DEF_BENCH(return new BitmapRectBench(p, 0x80, true, kScale_MatrixType))
@@ -6,7 +6,10 @@
  */
 
 #include "SkBenchmark.h"
+#include "SkBitmapProcState.h"
+#include "SkBitmapScaler.h"
 #include "SkCanvas.h"
+#include "SkMipMap.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkShader.h"
@@ -103,6 +106,65 @@ private:
     typedef BitmapScaleBench INHERITED;
 };
 
+// Between mip levels, medium filtering blends two of them.
+class BitmapMediumScaleBench: public BitmapScaleBench {
+ public:
+    BitmapMediumScaleBench(void *param, int is, int os) : INHERITED(param, is, os) {
+        setName( "medium" );
+    }
+protected:
+    virtual void doScaleImage() SK_OVERRIDE {
+        SkCanvas canvas( fOutputBitmap );
+        SkPaint paint;
+
+        paint.setFilterLevel(SkPaint::kMedium_FilterLevel);
+        canvas.drawBitmapMatrix( fInputBitmap, fMatrix, &paint );
+    }
+private:
+    typedef BitmapScaleBench INHERITED;
+};
+
+// Builds every level of a mipmap, without the scaled image cache.
+class MipMapBuildScaleBench: public BitmapScaleBench {
+ public:
+    MipMapBuildScaleBench(void *param, int is) : INHERITED(param, is, is / 2) {
+        setName( "mipmap" );
+    }
+protected:
+    virtual void doScaleImage() SK_OVERRIDE {
+        SkAutoTUnref<SkMipMap> mip(SkMipMap::Build(fInputBitmap));
+        if (mip.get()) {
+            mip->getLevel(mip->countLevels(), NULL);
+        }
+    }
+private:
+    typedef BitmapScaleBench INHERITED;
+};
+
+// Calls SkBitmapScaler directly, to measure how the convolution scales with threads.
+class BitmapResizeScaleBench: public BitmapScaleBench {
+ public:
+    BitmapResizeScaleBench(void *param, int is, int os, int threadCount)
+        : INHERITED(param, is, os)
+        , fThreadCount(threadCount) {
+        SkString name;
+        name.printf("resize_threads%d", threadCount);
+        setName( name.c_str() );
+        sk_bzero(&fProcs, sizeof(fProcs));
+        SkBitmapProcState::platformConvolutionProcs(&fProcs);
+    }
+protected:
+    virtual void doScaleImage() SK_OVERRIDE {
+        SkBitmapScaler::Resize(&fOutputBitmap, fInputBitmap, SkBitmapScaler::RESIZE_BEST,
+                               outputSize(), outputSize(), fProcs, NULL, fThreadCount);
+    }
+private:
+    int                 fThreadCount;
+    SkConvolutionProcs  fProcs;
+
+    typedef BitmapScaleBench INHERITED;
+};
+
 DEF_BENCH(return new BitmapFilterScaleBench(p, 10, 90);)
 DEF_BENCH(return new BitmapFilterScaleBench(p, 30, 90);)
 DEF_BENCH(return new BitmapFilterScaleBench(p, 80, 90);)
@@ -112,3 +174,12 @@ DEF_BENCH(return new BitmapFilterScaleBench(p, 90, 30);)
 DEF_BENCH(return new BitmapFilterScaleBench(p, 90, 10);)
 DEF_BENCH(return new BitmapFilterScaleBench(p, 256, 64);)
 DEF_BENCH(return new BitmapFilterScaleBench(p, 64, 256);)
+
+DEF_BENCH(return new BitmapResizeScaleBench(p, 1024, 256, 1);)
+DEF_BENCH(return new BitmapResizeScaleBench(p, 1024, 256, 4);)
+DEF_BENCH(return new BitmapResizeScaleBench(p, 1024, 256, 16);)
+
+DEF_BENCH(return new BitmapMediumScaleBench(p, 512, 360);)
+DEF_BENCH(return new BitmapMediumScaleBench(p, 512, 150);)
+
+DEF_BENCH(return new MipMapBuildScaleBench(p, 1024);)
@@ -7,6 +7,7 @@
  */
 #include "SkBenchmark.h"
 #include "SkBlurMask.h"
+#include "SkBlurMaskCache.h"
 #include "SkCanvas.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
@@ -79,6 +80,60 @@ private:
     typedef SkBenchmark INHERITED;
 };
 
+// Draws the same shadowed rounded rect all over, as for map labels. Each copy is at a different
+// integer offset, so all but the first blur can come from SkBlurMaskCache.
+class BlurRepeatBench : public SkBenchmark {
+    SkScalar    fSigma;
+    bool        fUseCache;
+    size_t      fOldCacheLimit;
+    SkString    fName;
+
+public:
+    BlurRepeatBench(void* param, SkScalar sigma, bool useCache)
+        : INHERITED(param), fSigma(sigma), fUseCache(useCache), fOldCacheLimit(0) {
+        fName.printf("blur_repeat_%d_%s", SkScalarRound(sigma), useCache ? "cached" : "uncached");
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onPreDraw() {
+        if (!fUseCache) {
+            fOldCacheLimit = SkBlurMaskCache::SetByteLimit(0);
+        }
+    }
+
+    virtual void onPostDraw() {
+        if (!fUseCache) {
+            SkBlurMaskCache::SetByteLimit(fOldCacheLimit);
+        }
+    }
+
+    virtual void onDraw(SkCanvas* canvas) {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setAntiAlias(true);
+        paint.setMaskFilter(SkBlurMaskFilter::Create(SkBlurMaskFilter::kNormal_BlurStyle,
+                                                     fSigma))->unref();
+
+        const SkRect r = SkRect::MakeLTRB(SkFloatToScalar(0.5f), SkFloatToScalar(0.5f),
+                                          SkFloatToScalar(60.5f), SkFloatToScalar(20.5f));
+        SkMWCRandom rand;
+        for (int i = 0; i < SkBENCHLOOP(50); i++) {
+            canvas->save();
+            canvas->translate(SkIntToScalar(rand.nextULessThan(500)),
+                              SkIntToScalar(rand.nextULessThan(400)));
+            canvas->drawRoundRect(r, SkIntToScalar(6), SkIntToScalar(6), paint);
+            canvas->restore();
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
 DEF_BENCH(return new BlurBench(p, SMALL, SkBlurMaskFilter::kNormal_BlurStyle);)
 DEF_BENCH(return new BlurBench(p, SMALL, SkBlurMaskFilter::kSolid_BlurStyle);)
 DEF_BENCH(return new BlurBench(p, SMALL, SkBlurMaskFilter::kOuter_BlurStyle);)
@@ -107,4 +162,11 @@ DEF_BENCH(return new BlurBench(p, REALBIG, SkBlurMaskFilter::kNormal_BlurStyle,
 
 DEF_BENCH(return new BlurBench(p, REAL, SkBlurMaskFilter::kNormal_BlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
 
+DEF_BENCH(return new BlurBench(p, BIG, SkBlurMaskFilter::kOuter_BlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
+
+DEF_BENCH(return new BlurBench(p, REALBIG, SkBlurMaskFilter::kOuter_BlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
+
 DEF_BENCH(return new BlurBench(p, 0, SkBlurMaskFilter::kNormal_BlurStyle);)
+
+DEF_BENCH(return new BlurRepeatBench(p, SkIntToScalar(4), true);)
+DEF_BENCH(return new BlurRepeatBench(p, SkIntToScalar(4), false);)
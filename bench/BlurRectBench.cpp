@@ -12,6 +12,8 @@
 #include "SkShader.h"
 #include "SkString.h"
 #include "SkBlurMask.h"
+#include "SkBlurMaskFilter.h"
+#include "SkRRect.h"
 
 #define SMALL   SkIntToScalar(2)
 #define REAL    SkFloatToScalar(1.5f)
@@ -181,6 +183,53 @@ private:
     typedef BlurRectSeparableBench INHERITED;
 };
 
+class BlurRRectBench: public SkBenchmark {
+    SkScalar    fSigma;
+    SkRRect     fRRect;
+    SkString    fName;
+
+    enum {
+        N = SkBENCHLOOP(100)
+    };
+
+public:
+    BlurRRectBench(void* param, SkScalar size, SkScalar sigma) : INHERITED(param), fSigma(sigma) {
+        SkRect r = SkRect::MakeXYWH(SkIntToScalar(10), SkIntToScalar(10), size, size * 3 / 4);
+        fRRect.setRectXY(r, size / 8, size / 8);
+        fName.printf("blurrrect_%d_%.2f", SkScalarRoundToInt(size), SkScalarToFloat(sigma));
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas* canvas) SK_OVERRIDE {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setAntiAlias(true);
+        paint.setMaskFilter(SkBlurMaskFilter::Create(SkBlurMaskFilter::kNormal_BlurStyle, fSigma,
+                                    SkBlurMaskFilter::kHighQuality_BlurFlag))->unref();
+
+        // Move by a fraction of a pixel each time, as a scrolling page would.
+        SkScalar dx = SkFloatToScalar(0.25f);
+        for (int i = 0; i < N; i++) {
+            canvas->save();
+            canvas->translate(dx * (i & 7), 0);
+            canvas->drawRRect(fRRect, paint);
+            canvas->restore();
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+DEF_BENCH(return new BlurRRectBench(p, SkIntToScalar(32), kMedium);)
+DEF_BENCH(return new BlurRRectBench(p, SkIntToScalar(128), kMedium);)
+DEF_BENCH(return new BlurRRectBench(p, SkIntToScalar(128), kMedBig);)
+DEF_BENCH(return new BlurRRectBench(p, SkIntToScalar(400), kMedBig);)
+
 DEF_BENCH(return new BlurRectBoxFilterBench(p, SMALL);)
 DEF_BENCH(return new BlurRectBoxFilterBench(p, BIG);)
 DEF_BENCH(return new BlurRectBoxFilterBench(p, REALBIG);)
@@ -215,6 +215,61 @@ private:
     typedef SkBenchmark INHERITED;
 };
 
+/*
+ *  Dash and stroke a long polyline (like a road on a map), most of which is
+ *  outside of the cull rect when doCull is set. The dashes are stroked one at a
+ *  time, so the result is the only path that grows with the length of the line.
+ */
+class StrokeDashBench : public SkBenchmark {
+    SkString fName;
+    SkPath   fPath;
+    bool     fDoCull;
+    SkAutoTUnref<SkPathEffect> fPE;
+
+    enum {
+        N = SkBENCHLOOP(10)
+    };
+
+public:
+    StrokeDashBench(void* param, bool doCull) : INHERITED(param) {
+        fName.printf("strokedash_polyline_%s", doCull ? "cull" : "nocull");
+        fDoCull = doCull;
+
+        SkRandom rand;
+        fPath.moveTo(0, 0);
+        for (int i = 1; i <= 2000; ++i) {
+            fPath.lineTo(SkIntToScalar(i * 5), rand.nextRangeScalar(0, 480));
+        }
+
+        SkScalar vals[] = { SkIntToScalar(8), SkIntToScalar(4) };
+        fPE.reset(new SkDashPathEffect(vals, 2, 0));
+        fIsRendering = false;
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas*) SK_OVERRIDE {
+        SkPaint paint;
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(SkIntToScalar(3));
+        paint.setStrokeCap(SkPaint::kRound_Cap);
+        paint.setPathEffect(fPE);
+
+        const SkRect cull = { 0, 0, SkIntToScalar(640), SkIntToScalar(480) };
+        SkPath dst;
+        for (int i = 0; i < N; ++i) {
+            paint.getFillPath(fPath, &dst, fDoCull ? &cull : NULL);
+            dst.rewind();
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
 /*
  *  We try to special case square dashes (intervals are equal to strokewidth).
  */
@@ -402,6 +457,8 @@ DEF_BENCH( return new DashBench(p, PARAM(gDots), 4); )
 DEF_BENCH( return new MakeDashBench(p, make_poly, "poly"); )
 DEF_BENCH( return new MakeDashBench(p, make_quad, "quad"); )
 DEF_BENCH( return new MakeDashBench(p, make_cubic, "cubic"); )
+DEF_BENCH( return new StrokeDashBench(p, false); )
+DEF_BENCH( return new StrokeDashBench(p, true); )
 DEF_BENCH( return new DashLineBench(p, 0, false); )
 DEF_BENCH( return new DashLineBench(p, SK_Scalar1, false); )
 DEF_BENCH( return new DashLineBench(p, 2 * SK_Scalar1, false); )
@@ -229,11 +229,18 @@ private:
 class Gradient2Bench : public SkBenchmark {
     SkString fName;
     bool     fHasAlpha;
+    bool     fSameStops;
 
 public:
-    Gradient2Bench(void* param, bool hasAlpha) : INHERITED(param) {
-        fName.printf("gradient_create_%s", hasAlpha ? "alpha" : "opaque");
+    /**
+     *  If sameStops is true, every shader is created with the same colors, so they can share
+     *  their color tables. Otherwise each one differs from the previous one.
+     */
+    Gradient2Bench(void* param, bool hasAlpha, bool sameStops = false) : INHERITED(param) {
+        fName.printf("gradient_create_%s%s", hasAlpha ? "alpha" : "opaque",
+                     sameStops ? "_samestops" : "");
         fHasAlpha = hasAlpha;
+        fSameStops = sameStops;
     }
 
 protected:
@@ -252,7 +259,7 @@ protected:
         };
 
         for (int i = 0; i < SkBENCHLOOP(1000); i++) {
-            const int gray = i % 256;
+            const int gray = fSameStops ? 0x80 : i % 256;
             const int alpha = fHasAlpha ? gray : 0xFF;
             SkColor colors[] = {
                 SK_ColorBLACK,
@@ -273,6 +280,7 @@ private:
 DEF_BENCH( return new GradientBench(p, kLinear_GradType); )
 DEF_BENCH( return new GradientBench(p, kLinear_GradType, gGradData[1]); )
 DEF_BENCH( return new GradientBench(p, kLinear_GradType, gGradData[0], SkShader::kMirror_TileMode); )
+DEF_BENCH( return new GradientBench(p, kLinear_GradType, gGradData[0], SkShader::kRepeat_TileMode); )
 
 // Draw a radial gradient of radius 1/2 on a rectangle; half the lines should
 // be completely pinned, the other half should pe partially pinned
@@ -283,6 +291,7 @@ DEF_BENCH( return new GradientBench(p, kRadial_GradType, gGradData[0], SkShader:
 DEF_BENCH( return new GradientBench(p, kRadial_GradType, gGradData[0], SkShader::kClamp_TileMode, kOval_GeomType); )
 
 DEF_BENCH( return new GradientBench(p, kRadial_GradType, gGradData[0], SkShader::kMirror_TileMode); )
+DEF_BENCH( return new GradientBench(p, kRadial_GradType, gGradData[0], SkShader::kRepeat_TileMode); )
 DEF_BENCH( return new GradientBench(p, kSweep_GradType); )
 DEF_BENCH( return new GradientBench(p, kSweep_GradType, gGradData[1]); )
 DEF_BENCH( return new GradientBench(p, kRadial2_GradType); )
@@ -290,6 +299,10 @@ DEF_BENCH( return new GradientBench(p, kRadial2_GradType, gGradData[1]); )
 DEF_BENCH( return new GradientBench(p, kRadial2_GradType, gGradData[0], SkShader::kMirror_TileMode); )
 DEF_BENCH( return new GradientBench(p, kConical_GradType); )
 DEF_BENCH( return new GradientBench(p, kConical_GradType, gGradData[1]); )
+DEF_BENCH( return new GradientBench(p, kConical_GradType, gGradData[0], SkShader::kMirror_TileMode); )
+DEF_BENCH( return new GradientBench(p, kConical_GradType, gGradData[0], SkShader::kRepeat_TileMode); )
 
 DEF_BENCH( return new Gradient2Bench(p, false); )
 DEF_BENCH( return new Gradient2Bench(p, true); )
+DEF_BENCH( return new Gradient2Bench(p, false, true); )
+DEF_BENCH( return new Gradient2Bench(p, true, true); )
@@ -6,6 +6,7 @@
  */
 
 #include "SkBenchmark.h"
+#include "SkLruImageCache.h"
 #include "SkScaledImageCache.h"
 
 class ImageCacheBench : public SkBenchmark {
@@ -58,3 +59,43 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ImageCacheBench(p); )
+
+// Pin and release every entry of a full SkLruImageCache, as drawing a screenful of lazily decoded
+// bitmaps would.
+class LruImageCachePinBench : public SkBenchmark {
+    SkLruImageCache fCache;
+    intptr_t        fIDs[500];
+
+    enum {
+        N = SkBENCHLOOP(20),
+        CACHE_COUNT = SK_ARRAY_COUNT(fIDs)
+    };
+public:
+    LruImageCachePinBench(void* param) : INHERITED(param), fCache(0) {
+        for (int i = 0; i < CACHE_COUNT; ++i) {
+            fCache.allocAndPinCache(4, &fIDs[i]);
+            fCache.releaseCache(fIDs[i]);
+        }
+        fIsRendering = false;
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return "lruimagecache_pin";
+    }
+
+    virtual void onDraw(SkCanvas*) SK_OVERRIDE {
+        SkImageCache::DataStatus status;
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < CACHE_COUNT; ++j) {
+                (void)fCache.pinCache(fIDs[j], &status);
+                fCache.releaseCache(fIDs[j]);
+            }
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+DEF_BENCH( return new LruImageCachePinBench(p); )
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBenchmark.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkForceLinking.h"
+#include "SkGradientShader.h"
+#include "SkPNGImageEncoder.h"
+#include "SkPaint.h"
+#include "SkString.h"
+#include "SkThreadPool.h"
+
+__SK_FORCE_IMAGE_DECODER_LINKING;
+
+enum EncodeContent {
+    kGradient_EncodeContent,    // smooth colors, like a photo or a hillshade
+    kFlat_EncodeContent,        // a handful of flat colors, like a map tile
+};
+
+class PNGEncodeBench : public SkBenchmark {
+public:
+    PNGEncodeBench(void* p, const char* name, EncodeContent content,
+                   const SkPNGImageEncoder::Options& options)
+        : INHERITED(p)
+        , fContent(content)
+        , fOptions(options) {
+        fName.printf("png_encode_%s_%s",
+                     kGradient_EncodeContent == content ? "gradient" : "flat",
+                     name);
+        fIsRendering = false;
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        fBitmap.setConfig(SkBitmap::kARGB_8888_Config, kSize, kSize);
+        fBitmap.allocPixels();
+        fBitmap.eraseColor(SK_ColorWHITE);
+        fBitmap.setIsOpaque(true);
+
+        SkCanvas canvas(fBitmap);
+        SkPaint paint;
+        if (kGradient_EncodeContent == fContent) {
+            const SkPoint pts[2] = {
+                { 0, 0 },
+                { SkIntToScalar(kSize), SkIntToScalar(kSize) }
+            };
+            const SkColor colors[] = {
+                SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE, SK_ColorYELLOW
+            };
+            paint.setShader(SkGradientShader::CreateLinear(
+                    pts, colors, NULL, SK_ARRAY_COUNT(colors),
+                    SkShader::kMirror_TileMode))->unref();
+            paint.setDither(true);
+            canvas.drawPaint(paint);
+        } else {
+            // Aliased rects and lines, so the color count stays small.
+            static const SkColor gColors[] = {
+                0xFFF2EFE9, 0xFFB5D29C, 0xFFAAD3DF, 0xFFFFFFFF, 0xFFF7FABF,
+                0xFFE892A2, 0xFFD0D0D0,
+            };
+            for (int i = 0; i < 200; ++i) {
+                paint.setColor(gColors[i % SK_ARRAY_COUNT(gColors)]);
+                SkScalar x = SkIntToScalar((i * 37) % kSize);
+                SkScalar y = SkIntToScalar((i * 91) % kSize);
+                canvas.drawRect(SkRect::MakeXYWH(x, y, SkIntToScalar(40),
+                                                 SkIntToScalar(25)), paint);
+                paint.setStrokeWidth(SkIntToScalar(3));
+                canvas.drawLine(x, 0, SkIntToScalar(kSize) - x,
+                                SkIntToScalar(kSize), paint);
+            }
+        }
+    }
+
+    virtual void onDraw(SkCanvas*) SK_OVERRIDE {
+        SkPNGImageEncoder encoder(fOptions);
+        for (int i = 0; i < SkBENCHLOOP(10); ++i) {
+            SkAutoTUnref<SkData> data(encoder.encodeData(fBitmap, 100));
+#ifdef SK_DEBUG
+            if (NULL == data.get()) {
+                SkDebugf("failed to encode %s\n", fName.c_str());
+                return;
+            }
+#endif
+        }
+    }
+
+private:
+    enum { kSize = 512 };
+
+    SkString                        fName;
+    const EncodeContent             fContent;
+    const SkPNGImageEncoder::Options fOptions;
+    SkBitmap                        fBitmap;
+
+    typedef SkBenchmark INHERITED;
+};
+
+static SkBenchmark* NewPNGEncodeBench(void* p, EncodeContent content,
+                                      const char* name, int level,
+                                      SkPNGImageEncoder::FilterStrategy filter,
+                                      bool palette, int threads) {
+    SkPNGImageEncoder::Options options;
+    options.fCompressionLevel = level;
+    options.fFilterStrategy = filter;
+    options.fPaletteReduction = palette;
+    options.fThreadCount = threads;
+    return new PNGEncodeBench(p, name, content, options);
+}
+
+static const int kDefaultLevel = SkPNGImageEncoder::Options::kDefault_CompressionLevel;
+static const int kPerCore = SkThreadPool::kThreadPerCore;
+static const SkPNGImageEncoder::FilterStrategy kDefault = SkPNGImageEncoder::kDefault_FilterStrategy;
+static const SkPNGImageEncoder::FilterStrategy kSub = SkPNGImageEncoder::kSub_FilterStrategy;
+
+DEF_BENCH( return NewPNGEncodeBench(p, kGradient_EncodeContent, "default", kDefaultLevel, kDefault, false, 0); )
+DEF_BENCH( return NewPNGEncodeBench(p, kGradient_EncodeContent, "fast", 1, kSub, false, 0); )
+DEF_BENCH( return NewPNGEncodeBench(p, kGradient_EncodeContent, "palette", kDefaultLevel, kDefault, true, 0); )
+DEF_BENCH( return NewPNGEncodeBench(p, kGradient_EncodeContent, "parallel", kDefaultLevel, kDefault, false, kPerCore); )
+DEF_BENCH( return NewPNGEncodeBench(p, kGradient_EncodeContent, "fast_parallel", 1, kSub, true, kPerCore); )
+
+DEF_BENCH( return NewPNGEncodeBench(p, kFlat_EncodeContent, "default", kDefaultLevel, kDefault, false, 0); )
+DEF_BENCH( return NewPNGEncodeBench(p, kFlat_EncodeContent, "fast", 1, kSub, false, 0); )
+DEF_BENCH( return NewPNGEncodeBench(p, kFlat_EncodeContent, "palette", kDefaultLevel, kDefault, true, 0); )
+DEF_BENCH( return NewPNGEncodeBench(p, kFlat_EncodeContent, "parallel", kDefaultLevel, kDefault, false, kPerCore); )
+DEF_BENCH( return NewPNGEncodeBench(p, kFlat_EncodeContent, "fast_parallel", 1, kSub, true, kPerCore); )
@@ -8,6 +8,7 @@
 #include "SkBitmapSource.h"
 #include "SkCanvas.h"
 #include "SkDevice.h"
+#include "SkGradientShader.h"
 #include "SkLightingImageFilter.h"
 
 #define FILTER_WIDTH_SMALL  SkIntToScalar(32)
@@ -210,6 +211,59 @@ private:
     typedef LightingBaseBench INHERITED;
 };
 
+// Lights a bitmap whose alpha is a radial bump, so that unlike the rects drawn above, the
+// surface normal changes at every pixel and none of the rows are flat.
+class LightingBumpBench : public LightingBaseBench {
+public:
+    LightingBumpBench(void* param, bool specular) : INHERITED(param, false),
+        fSpecular(specular) {
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fSpecular ? "lightingbumppointlitspecular" : "lightingbumppointlitdiffuse";
+    }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        if (!fBump.isNull()) {
+            return;
+        }
+        const int size = SkScalarRoundToInt(FILTER_WIDTH_LARGE);
+        fBump.setConfig(SkBitmap::kARGB_8888_Config, size, size);
+        fBump.allocPixels();
+        SkCanvas canvas(fBump);
+        canvas.clear(0x00000000);
+        SkPoint center = SkPoint::Make(SkScalarHalf(FILTER_WIDTH_LARGE),
+                                       SkScalarHalf(FILTER_HEIGHT_LARGE));
+        SkColor colors[] = { SK_ColorBLACK, SK_ColorTRANSPARENT };
+        SkPaint paint;
+        paint.setShader(SkGradientShader::CreateRadial(center, center.fX, colors, NULL,
+                                                       SK_ARRAY_COUNT(colors),
+                                                       SkShader::kClamp_TileMode))->unref();
+        canvas.drawPaint(paint);
+    }
+
+    virtual void onDraw(SkCanvas* canvas) SK_OVERRIDE {
+        SkPoint3 location(SkScalarHalf(FILTER_WIDTH_LARGE), SkScalarHalf(FILTER_HEIGHT_LARGE),
+                          SkIntToScalar(64));
+        SkAutoTUnref<SkImageFilter> bump(SkNEW_ARGS(SkBitmapSource, (fBump)));
+        SkScalar surfaceScale = SkIntToScalar(10);
+        if (fSpecular) {
+            draw(canvas, SkLightingImageFilter::CreatePointLitSpecular(location, getWhite(),
+                surfaceScale, getKs(), getShininess(), bump));
+        } else {
+            draw(canvas, SkLightingImageFilter::CreatePointLitDiffuse(location, getWhite(),
+                surfaceScale, getKd(), bump));
+        }
+    }
+
+private:
+    bool     fSpecular;
+    SkBitmap fBump;
+
+    typedef LightingBaseBench INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new LightingPointLitDiffuseBench(p, true); )
@@ -224,3 +278,5 @@ DEF_BENCH( return new LightingDistantLitSpecularBench(p, true); )
 DEF_BENCH( return new LightingDistantLitSpecularBench(p, false); )
 DEF_BENCH( return new LightingSpotLitSpecularBench(p, true); )
 DEF_BENCH( return new LightingSpotLitSpecularBench(p, false); )
+DEF_BENCH( return new LightingBumpBench(p, false); )
+DEF_BENCH( return new LightingBumpBench(p, true); )
@@ -429,6 +429,60 @@ private:
     typedef MatrixBench INHERITED;
 };
 
+class MapPointsMatrixBench : public MatrixBench {
+public:
+    MapPointsMatrixBench(void* param, const char* name, int flags)
+        : INHERITED(param, name)
+        , fFlags(flags) {
+        fMatrix.reset();
+        if (flags & kScale_Flag) {
+            fMatrix.postScale(SkFloatToScalar(1.5f), SkFloatToScalar(2.5f));
+        }
+        if (flags & kTranslate_Flag) {
+            fMatrix.postTranslate(SkFloatToScalar(1.5f), SkFloatToScalar(2.5f));
+        }
+        if (flags & kRotate_Flag) {
+            fMatrix.postRotate(SkFloatToScalar(45.0f));
+        }
+        if (flags & kPerspective_Flag) {
+            fMatrix.setPerspX(SkFloatToScalar(0.0015f));
+            fMatrix.setPerspY(SkFloatToScalar(0.0025f));
+        }
+        fMatrix.getType();
+        for (int i = 0; i < kCount; i++) {
+            fSrc[i].fX = fRandom.nextSScalar1();
+            fSrc[i].fY = fRandom.nextSScalar1();
+        }
+    }
+    enum Flag {
+        kScale_Flag             = 0x01,
+        kTranslate_Flag         = 0x02,
+        kRotate_Flag            = 0x04,
+        kPerspective_Flag       = 0x08,
+        kBounds_Flag            = 0x10,
+    };
+protected:
+    virtual void performTest() {
+        if (fFlags & kBounds_Flag) {
+            // as SkPath::transform() does when the bounds can't just be mapped
+            SkRect bounds;
+            always_do(fMatrix.mapPointsWithBounds(fDst, fSrc, kCount, &bounds));
+        } else {
+            fMatrix.mapPoints(fDst, fSrc, kCount);
+        }
+    }
+private:
+    enum {
+        kCount = 100
+    };
+    SkMatrix fMatrix;
+    int fFlags;
+    SkPoint fSrc[kCount];
+    SkPoint fDst[kCount];
+    SkMWCRandom fRandom;
+    typedef MatrixBench INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new EqualsMatrixBench(p); )
@@ -475,3 +529,46 @@ DEF_BENCH( return new InvertMapRectMatrixBench(p,
 
 DEF_BENCH( return new ScaleTransMixedMatrixBench(p); )
 DEF_BENCH( return new ScaleTransDoubleMatrixBench(p); )
+
+DEF_BENCH( return new MapPointsMatrixBench(p, "mappoints_identity", 0); )
+
+DEF_BENCH( return new MapPointsMatrixBench(p,
+                               "mappoints_translate",
+                               MapPointsMatrixBench::kTranslate_Flag); )
+
+DEF_BENCH( return new MapPointsMatrixBench(p,
+                               "mappoints_scale",
+                               MapPointsMatrixBench::kScale_Flag); )
+
+DEF_BENCH( return new MapPointsMatrixBench(p,
+                               "mappoints_scaletrans",
+                               MapPointsMatrixBench::kScale_Flag |
+                               MapPointsMatrixBench::kTranslate_Flag); )
+
+DEF_BENCH( return new MapPointsMatrixBench(p,
+                               "mappoints_affine",
+                               MapPointsMatrixBench::kScale_Flag |
+                               MapPointsMatrixBench::kRotate_Flag |
+                               MapPointsMatrixBench::kTranslate_Flag); )
+
+DEF_BENCH( return new MapPointsMatrixBench(p,
+                               "mappoints_persp",
+                               MapPointsMatrixBench::kPerspective_Flag); )
+
+DEF_BENCH( return new MapPointsMatrixBench(p,
+                               "mappoints_bounds_scaletrans",
+                               MapPointsMatrixBench::kBounds_Flag |
+                               MapPointsMatrixBench::kScale_Flag |
+                               MapPointsMatrixBench::kTranslate_Flag); )
+
+DEF_BENCH( return new MapPointsMatrixBench(p,
+                               "mappoints_bounds_affine",
+                               MapPointsMatrixBench::kBounds_Flag |
+                               MapPointsMatrixBench::kScale_Flag |
+                               MapPointsMatrixBench::kRotate_Flag |
+                               MapPointsMatrixBench::kTranslate_Flag); )
+
+DEF_BENCH( return new MapPointsMatrixBench(p,
+                               "mappoints_bounds_persp",
+                               MapPointsMatrixBench::kBounds_Flag |
+                               MapPointsMatrixBench::kPerspective_Flag); )
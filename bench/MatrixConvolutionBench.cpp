@@ -13,16 +13,55 @@
 
 class MatrixConvolutionBench : public SkBenchmark {
 public:
-    MatrixConvolutionBench(void* param, SkMatrixConvolutionImageFilter::TileMode tileMode, bool convolveAlpha)
+    enum KernelType {
+        k3x3_KernelType,            //!< a 3x3 edge detector
+        k5x5_KernelType,            //!< a 5x5 non-separable kernel
+        kSeparable_KernelType,      //!< a 9x9 binomial blur, applied as two 1D kernels
+        kGeneric_KernelType,        //!< a 7x7 non-separable kernel
+    };
+
+    MatrixConvolutionBench(void* param, SkMatrixConvolutionImageFilter::TileMode tileMode,
+                           bool convolveAlpha, KernelType kernelType = k3x3_KernelType)
         : INHERITED(param), fName("matrixconvolution") {
-        SkISize kernelSize = SkISize::Make(3, 3);
-        SkScalar kernel[9] = {
-            SkIntToScalar( 1), SkIntToScalar( 1), SkIntToScalar( 1),
-            SkIntToScalar( 1), SkIntToScalar(-7), SkIntToScalar( 1),
-            SkIntToScalar( 1), SkIntToScalar( 1), SkIntToScalar( 1),
-        };
+        static const char* gTileModeNames[] = { "clamp", "repeat", "clamptoblack" };
+        static const char* gKernelNames[] = { "3x3", "5x5", "separable", "generic" };
+        fName.appendf("_%s_%s%s", gKernelNames[kernelType], gTileModeNames[tileMode],
+                      convolveAlpha ? "" : "_noalpha");
+
+        SkISize kernelSize;
+        SkScalar kernel[81];
         SkScalar gain = SkFloatToScalar(0.3f), bias = SkIntToScalar(100);
-        SkIPoint target = SkIPoint::Make(1, 1);
+        switch (kernelType) {
+            case k3x3_KernelType: {
+                static const int gEdge[9] = { 1, 1, 1, 1, -7, 1, 1, 1, 1 };
+                kernelSize = SkISize::Make(3, 3);
+                for (int i = 0; i < 9; ++i) {
+                    kernel[i] = SkIntToScalar(gEdge[i]);
+                }
+                break;
+            }
+            case kSeparable_KernelType: {
+                static const int gBinomial[9] = { 1, 8, 28, 56, 70, 56, 28, 8, 1 };
+                kernelSize = SkISize::Make(9, 9);
+                for (int i = 0; i < 81; ++i) {
+                    kernel[i] = SkIntToScalar(gBinomial[i / 9] * gBinomial[i % 9]);
+                }
+                gain = SkScalarInvert(SkIntToScalar(256 * 256));
+                bias = 0;
+                break;
+            }
+            case k5x5_KernelType:
+            case kGeneric_KernelType: {
+                int size = k5x5_KernelType == kernelType ? 5 : 7;
+                kernelSize = SkISize::Make(size, size);
+                for (int i = 0; i < size * size; ++i) {
+                    kernel[i] = SkIntToScalar((i * 7) % 5 - 2);
+                }
+                gain = SkFloatToScalar(0.1f);
+                break;
+            }
+        }
+        SkIPoint target = SkIPoint::Make(kernelSize.width() / 2, kernelSize.height() / 2);
         fFilter = new SkMatrixConvolutionImageFilter(kernelSize, kernel, gain, bias, target, tileMode, convolveAlpha);
     }
 
@@ -59,7 +98,16 @@ static SkBenchmark* Fact01(void* p) { return new MatrixConvolutionBench(p, SkMat
 static SkBenchmark* Fact02(void* p) { return new MatrixConvolutionBench(p, SkMatrixConvolutionImageFilter::kClampToBlack_TileMode, true); }
 static SkBenchmark* Fact03(void* p) { return new MatrixConvolutionBench(p, SkMatrixConvolutionImageFilter::kClampToBlack_TileMode, false); }
 
+static SkBenchmark* Fact04(void* p) { return new MatrixConvolutionBench(p, SkMatrixConvolutionImageFilter::kClamp_TileMode, true, MatrixConvolutionBench::k5x5_KernelType); }
+static SkBenchmark* Fact05(void* p) { return new MatrixConvolutionBench(p, SkMatrixConvolutionImageFilter::kClamp_TileMode, true, MatrixConvolutionBench::kSeparable_KernelType); }
+static SkBenchmark* Fact06(void* p) { return new MatrixConvolutionBench(p, SkMatrixConvolutionImageFilter::kClamp_TileMode, false, MatrixConvolutionBench::kSeparable_KernelType); }
+static SkBenchmark* Fact07(void* p) { return new MatrixConvolutionBench(p, SkMatrixConvolutionImageFilter::kClamp_TileMode, true, MatrixConvolutionBench::kGeneric_KernelType); }
+
 static BenchRegistry gReg00(Fact00);
 static BenchRegistry gReg01(Fact01);
 static BenchRegistry gReg02(Fact02);
 static BenchRegistry gReg03(Fact03);
+static BenchRegistry gReg04(Fact04);
+static BenchRegistry gReg05(Fact05);
+static BenchRegistry gReg06(Fact06);
+static BenchRegistry gReg07(Fact07);
@@ -9,6 +9,7 @@
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
+#include "SkDashPathEffect.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkShader.h"
@@ -219,6 +220,55 @@ private:
     typedef PathBench INHERITED;
 };
 
+/*
+ *  A long stroked (and optionally dashed) path, like a coastline on a map, that wanders far
+ *  outside of the 256x256 tile that it is clipped to.
+ */
+class ClippedLongPathBench : public SkBenchmark {
+    SkString    fName;
+    SkPath      fPath;
+    SkPaint     fPaint;
+    SkAutoTUnref<SkPathEffect> fPE;
+    enum { N = SkBENCHLOOP(10) };
+public:
+    ClippedLongPathBench(void* param, bool doDash) : INHERITED(param) {
+        fName.printf("path_stroke_clipped_long_%s", doDash ? "dash" : "solid");
+
+        SkMWCRandom rand;
+        SkPoint pt = SkPoint::Make(128, 128);
+        fPath.moveTo(pt);
+        for (int i = 0; i < 5000; ++i) {
+            pt.offset(rand.nextRangeScalar(-20, 20), rand.nextRangeScalar(-20, 20));
+            fPath.lineTo(pt);
+        }
+
+        fPaint.setAntiAlias(true);
+        fPaint.setStyle(SkPaint::kStroke_Style);
+        fPaint.setStrokeWidth(SkIntToScalar(4));
+        fPaint.setStrokeJoin(SkPaint::kRound_Join);
+        if (doDash) {
+            SkScalar vals[] = { SkIntToScalar(10), SkIntToScalar(5) };
+            fPE.reset(new SkDashPathEffect(vals, 2, 0));
+            fPaint.setPathEffect(fPE);
+        }
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas* canvas) SK_OVERRIDE {
+        canvas->clipRect(SkRect::MakeWH(SkIntToScalar(256), SkIntToScalar(256)));
+        for (int i = 0; i < N; i++) {
+            canvas->drawPath(fPath, fPaint);
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
 class RandomPathBench : public SkBenchmark {
 public:
     RandomPathBench(void* param) : INHERITED(param) {
@@ -1062,6 +1112,8 @@ DEF_BENCH( return new LongCurvedPathBench(p, FLAGS00); )
 DEF_BENCH( return new LongCurvedPathBench(p, FLAGS01); )
 DEF_BENCH( return new LongLinePathBench(p, FLAGS00); )
 DEF_BENCH( return new LongLinePathBench(p, FLAGS01); )
+DEF_BENCH( return new ClippedLongPathBench(p, false); )
+DEF_BENCH( return new ClippedLongPathBench(p, true); )
 
 DEF_BENCH( return new PathCreateBench(p); )
 DEF_BENCH( return new PathCopyBench(p); )
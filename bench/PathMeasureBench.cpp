@@ -0,0 +1,133 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBenchmark.h"
+#include "SkGraphics.h"
+#include "SkPath.h"
+#include "SkPathMeasure.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkTDArray.h"
+
+// Measures a path of random quads or cubics, as text on a path or a dash
+// effect would: build the measure, and then walk it (one distance at a time,
+// or all at once with the batch getPosTan).
+class PathMeasureBench : public SkBenchmark {
+public:
+    enum Mode {
+        kBuild_Mode,        // only build the segment table
+        kBuildCached_Mode,  // build with the path measure cache enabled
+        kPosTan_Mode,       // getPosTan() for each distance
+        kBatchPosTan_Mode,  // one getPosTan() for all of the distances
+    };
+
+    PathMeasureBench(void* param, bool cubics, Mode mode) : INHERITED(param) {
+        static const char* gModeName[] = {
+            "build", "build_cached", "postan", "postan_batch"
+        };
+        fName.printf("pathmeasure_%s_%s", cubics ? "cubic" : "quad", gModeName[mode]);
+        fMode = mode;
+
+        SkMWCRandom rand;
+        fPath.moveTo(0, 0);
+        for (int i = 0; i < 100; ++i) {
+            SkPoint pts[3];
+            for (int j = 0; j < 3; ++j) {
+                pts[j].set(rand.nextUScalar1() * 640, rand.nextUScalar1() * 480);
+            }
+            if (cubics) {
+                fPath.cubicTo(pts[0], pts[1], pts[2]);
+            } else {
+                fPath.quadTo(pts[0], pts[1]);
+            }
+        }
+
+        SkPathMeasure meas(fPath, false);
+        SkScalar length = meas.getLength();
+        fDistances.setCount(kDistanceCount);
+        fPositions.setCount(kDistanceCount);
+        fTangents.setCount(kDistanceCount);
+        for (int i = 0; i < kDistanceCount; ++i) {
+            fDistances[i] = length * i / kDistanceCount;
+        }
+
+        fIsRendering = false;
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        if (kBuildCached_Mode == fMode) {
+            fOldLimit = SkGraphics::SetPathMeasureCacheByteLimit(1024 * 1024);
+        }
+    }
+
+    virtual void onDraw(SkCanvas*) SK_OVERRIDE {
+        switch (fMode) {
+            case kBuild_Mode:
+            case kBuildCached_Mode:
+                for (int i = 0; i < N; ++i) {
+                    SkPathMeasure meas(fPath, false);
+                    (void)meas.getLength();
+                }
+                break;
+            case kPosTan_Mode: {
+                SkPathMeasure meas(fPath, false);
+                for (int i = 0; i < N; ++i) {
+                    for (int j = 0; j < kDistanceCount; ++j) {
+                        if (!meas.getPosTan(fDistances[j], &fPositions[j], &fTangents[j])) {
+                            return;
+                        }
+                    }
+                }
+            } break;
+            case kBatchPosTan_Mode: {
+                SkPathMeasure meas(fPath, false);
+                for (int i = 0; i < N; ++i) {
+                    if (!meas.getPosTan(fDistances.begin(), kDistanceCount,
+                                        fPositions.begin(), fTangents.begin())) {
+                        return;
+                    }
+                }
+            } break;
+        }
+    }
+
+    virtual void onPostDraw() SK_OVERRIDE {
+        if (kBuildCached_Mode == fMode) {
+            SkGraphics::SetPathMeasureCacheByteLimit(fOldLimit);
+        }
+    }
+
+private:
+    enum {
+        N = SkBENCHLOOP(100),
+        kDistanceCount = 1000
+    };
+
+    SkString            fName;
+    SkPath              fPath;
+    Mode                fMode;
+    size_t              fOldLimit;
+    SkTDArray<SkScalar> fDistances;
+    SkTDArray<SkPoint>  fPositions;
+    SkTDArray<SkVector> fTangents;
+
+    typedef SkBenchmark INHERITED;
+};
+
+DEF_BENCH( return new PathMeasureBench(p, false, PathMeasureBench::kBuild_Mode); )
+DEF_BENCH( return new PathMeasureBench(p, false, PathMeasureBench::kBuildCached_Mode); )
+DEF_BENCH( return new PathMeasureBench(p, false, PathMeasureBench::kPosTan_Mode); )
+DEF_BENCH( return new PathMeasureBench(p, false, PathMeasureBench::kBatchPosTan_Mode); )
+DEF_BENCH( return new PathMeasureBench(p, true, PathMeasureBench::kBuild_Mode); )
+DEF_BENCH( return new PathMeasureBench(p, true, PathMeasureBench::kBuildCached_Mode); )
+DEF_BENCH( return new PathMeasureBench(p, true, PathMeasureBench::kPosTan_Mode); )
+DEF_BENCH( return new PathMeasureBench(p, true, PathMeasureBench::kBatchPosTan_Mode); )
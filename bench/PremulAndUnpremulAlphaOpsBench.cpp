@@ -7,8 +7,11 @@
  */
 
 #include "SkBenchmark.h"
+#include "SkBlitRow.h"
 #include "SkCanvas.h"
 #include "SkConfig8888.h"
+#include "SkConvertRow.h"
+#include "SkRandom.h"
 #include "SkString.h"
 
 class PremulAndUnpremulAlphaOpsBench : public SkBenchmark {
@@ -72,3 +75,103 @@ static SkBenchmark* fact1(void* p) {
 
 static BenchRegistry gReg0(fact0);
 static BenchRegistry gReg1(fact1);
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Times the row procs used to expand decoded pixels into SkPMColors, and to
+// reduce SkPMColors to (dithered) 565, without going through a canvas.
+class ConvertRowBench : public SkBenchmark {
+public:
+    enum {
+        kWidth = 1024,
+        kRows = 64
+    };
+
+    ConvertRowBench(void* param, SkConvertRow::SrcFormat format, const char* name)
+        : INHERITED(param), fFormat(format) {
+        fName.printf("convert_row_%s", name);
+        fIsRendering = false;
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        SkRandom rand;
+        for (size_t i = 0; i < sizeof(fSrc); ++i) {
+            fSrc[i] = rand.nextU() & 0xFF;
+        }
+    }
+
+    virtual void onDraw(SkCanvas*) SK_OVERRIDE {
+        SkConvertRow::Proc proc = SkConvertRow::Factory(fFormat);
+        static const int kLoopCount = SkBENCHLOOP(10);
+        for (int loop = 0; loop < kLoopCount; ++loop) {
+            for (int y = 0; y < kRows; ++y) {
+                proc(fDst, fSrc, kWidth);
+            }
+        }
+    }
+
+private:
+    SkConvertRow::SrcFormat fFormat;
+    SkString                fName;
+    uint8_t                 fSrc[kWidth * 4];
+    SkPMColor               fDst[kWidth];
+
+    typedef SkBenchmark INHERITED;
+};
+
+class Blit565RowBench : public SkBenchmark {
+public:
+    enum {
+        kWidth = 1024,
+        kRows = 64
+    };
+
+    Blit565RowBench(void* param, bool dither) : INHERITED(param), fDither(dither) {
+        fName.printf("convert_row_8888_to_565%s", dither ? "_dither" : "");
+        fIsRendering = false;
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        SkRandom rand;
+        for (int i = 0; i < kWidth; ++i) {
+            fSrc[i] = rand.nextU() | SkPackARGB32(0xFF, 0, 0, 0);
+        }
+    }
+
+    virtual void onDraw(SkCanvas*) SK_OVERRIDE {
+        SkBlitRow::Proc proc = SkBlitRow::Factory(fDither ? SkBlitRow::kDither_Flag : 0,
+                                                  SkBitmap::kRGB_565_Config);
+        static const int kLoopCount = SkBENCHLOOP(10);
+        for (int loop = 0; loop < kLoopCount; ++loop) {
+            for (int y = 0; y < kRows; ++y) {
+                proc(fDst, fSrc, kWidth, 0xFF, 0, y);
+            }
+        }
+    }
+
+private:
+    bool        fDither;
+    SkString    fName;
+    SkPMColor   fSrc[kWidth];
+    uint16_t    fDst[kWidth];
+
+    typedef SkBenchmark INHERITED;
+};
+
+DEF_BENCH( return new ConvertRowBench(p, SkConvertRow::kGray_SrcFormat, "gray"); )
+DEF_BENCH( return new ConvertRowBench(p, SkConvertRow::kRGB_SrcFormat, "rgb"); )
+DEF_BENCH( return new ConvertRowBench(p, SkConvertRow::kRGBX_SrcFormat, "rgbx"); )
+DEF_BENCH( return new ConvertRowBench(p, SkConvertRow::kRGBA_SrcFormat, "rgba_premul"); )
+DEF_BENCH( return new ConvertRowBench(p, SkConvertRow::kBGRA_SrcFormat, "bgra_premul"); )
+DEF_BENCH( return new Blit565RowBench(p, false); )
+DEF_BENCH( return new Blit565RowBench(p, true); )
@@ -89,13 +89,19 @@ class RepeatTileBench : public SkBenchmark {
     SkBitmap         fBitmap;
     bool             fIsOpaque;
     SkBitmap::Config fConfig;
+    SkShader::TileMode fTileMode;
+    bool             fDoScale;
     enum { N = SkBENCHLOOP(20) };
 public:
-    RepeatTileBench(void* param, SkBitmap::Config c, bool isOpaque = false) : INHERITED(param) {
+    RepeatTileBench(void* param, SkBitmap::Config c, bool isOpaque = false,
+                    SkShader::TileMode tileMode = SkShader::kRepeat_TileMode,
+                    bool doScale = false) : INHERITED(param) {
         const int w = 50;
         const int h = 50;
         fConfig = c;
         fIsOpaque = isOpaque;
+        fTileMode = tileMode;
+        fDoScale = doScale;
 
         if (SkBitmap::kIndex8_Config == fConfig) {
             fBitmap.setConfig(SkBitmap::kARGB_8888_Config, w, h);
@@ -103,7 +109,13 @@ public:
             fBitmap.setConfig(fConfig, w, h);
         }
         fName.printf("repeatTile_%s_%c",
-                     gConfigName[fBitmap.config()], isOpaque ? 'X' : 'A');
+                     gConfigName[fConfig], isOpaque ? 'X' : 'A');
+        if (SkShader::kMirror_TileMode == tileMode) {
+            fName.append("_mirror");
+        }
+        if (doScale) {
+            fName.append("_scale");
+        }
     }
 
 protected:
@@ -124,9 +136,12 @@ protected:
             fBitmap = tmp;
         }
 
-        SkShader* s = SkShader::CreateBitmapShader(fBitmap,
-                                                   SkShader::kRepeat_TileMode,
-                                                   SkShader::kRepeat_TileMode);
+        SkShader* s = SkShader::CreateBitmapShader(fBitmap, fTileMode, fTileMode);
+        if (fDoScale) {
+            SkMatrix m;
+            m.setScale(SkIntToScalar(3) / 2, SkIntToScalar(5) / 4);
+            s->setLocalMatrix(m);
+        }
         fPaint.setShader(s)->unref();
     }
 
@@ -148,3 +163,12 @@ DEF_BENCH(return new RepeatTileBench(p, SkBitmap::kARGB_8888_Config, true))
 DEF_BENCH(return new RepeatTileBench(p, SkBitmap::kARGB_8888_Config, false))
 DEF_BENCH(return new RepeatTileBench(p, SkBitmap::kRGB_565_Config))
 DEF_BENCH(return new RepeatTileBench(p, SkBitmap::kIndex8_Config))
+
+DEF_BENCH(return new RepeatTileBench(p, SkBitmap::kARGB_8888_Config, true,
+                                     SkShader::kRepeat_TileMode, true))
+DEF_BENCH(return new RepeatTileBench(p, SkBitmap::kARGB_8888_Config, true,
+                                     SkShader::kMirror_TileMode, true))
+DEF_BENCH(return new RepeatTileBench(p, SkBitmap::kIndex8_Config, false,
+                                     SkShader::kRepeat_TileMode, true))
+DEF_BENCH(return new RepeatTileBench(p, SkBitmap::kIndex8_Config, false,
+                                     SkShader::kMirror_TileMode, true))
@@ -8,6 +8,8 @@
 #include "SkBenchmark.h"
 #include "SkCanvas.h"
 #include "SkPaint.h"
+#include "SkPath.h"
+#include "SkRandom.h"
 #include "SkRRect.h"
 #include "SkString.h"
 
@@ -103,3 +105,52 @@ DEF_BENCH( return new StrokeRRectBench(p, SkPaint::kMiter_Join, draw_rrect); )
 DEF_BENCH( return new StrokeRRectBench(p, SkPaint::kRound_Join, draw_oval); )
 DEF_BENCH( return new StrokeRRectBench(p, SkPaint::kBevel_Join, draw_oval); )
 DEF_BENCH( return new StrokeRRectBench(p, SkPaint::kMiter_Join, draw_oval); )
+
+// Strokes (without drawing) a polyline of 10k line segments, like the roads of
+// a map, which takes the line-only stroker.
+class StrokePolylineBench : public SkBenchmark {
+    SkString fName;
+    SkPaint::Join fJoin;
+    SkPath fPath;
+    enum { N = SkBENCHLOOP(10) };
+public:
+    StrokePolylineBench(void* param, SkPaint::Join j) : SkBenchmark(param) {
+        static const char* gJoinName[] = {
+            "miter", "round", "bevel"
+        };
+
+        fJoin = j;
+        fName.printf("stroke_polyline_10k_%s", gJoinName[j]);
+
+        SkRandom rand;
+        fPath.moveTo(0, 0);
+        for (int i = 1; i <= 10000; ++i) {
+            fPath.lineTo(SkIntToScalar(i % 640), rand.nextRangeScalar(0, 480));
+        }
+        fIsRendering = false;
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas*) {
+        SkPaint paint;
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeJoin(fJoin);
+        paint.setStrokeCap(SkPaint::kRound_Cap);
+        paint.setStrokeWidth(6);
+        for (int i = 0; i < N; ++i) {
+            SkPath dst;
+            paint.getFillPath(fPath, &dst);
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+DEF_BENCH( return new StrokePolylineBench(p, SkPaint::kRound_Join); )
+DEF_BENCH( return new StrokePolylineBench(p, SkPaint::kBevel_Join); )
+DEF_BENCH( return new StrokePolylineBench(p, SkPaint::kMiter_Join); )
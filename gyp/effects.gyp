@@ -18,6 +18,7 @@
         '../include/effects',
         '../src/effects',
         '../src/core',
+        '../src/opts',
       ],
       'direct_dependent_settings': {
         'include_dirs': [
@@ -51,6 +51,15 @@
             '../src/opts/SkBitmapFilter_opts_SSE2.cpp',
             '../src/opts/SkBlitRow_opts_SSE2.cpp',
             '../src/opts/SkBlitRect_opts_SSE2.cpp',
+            '../src/opts/SkBlurImage_opts_SSE2.cpp',
+            '../src/opts/SkConvertRow_opts_SSE2.cpp',
+            '../src/opts/SkGradient_opts_SSE2.cpp',
+            '../src/opts/SkLighting_opts_SSE2.cpp',
+            '../src/opts/SkMatrix_opts_SSE2.cpp',
+            '../src/opts/SkMatrixConvolution_opts_SSE2.cpp',
+            '../src/opts/SkMipMap_opts_SSE2.cpp',
+            '../src/opts/SkMorphology_opts_SSE2.cpp',
+            '../src/opts/SkStroke_opts_SSE2.cpp',
             '../src/opts/SkUtils_opts_SSE2.cpp',
           ],
         }],
@@ -98,6 +107,15 @@
             '../src/opts/SkBitmapProcState_opts_none.cpp',
             '../src/opts/SkBlitMask_opts_none.cpp',
             '../src/opts/SkBlitRow_opts_none.cpp',
+            '../src/opts/SkBlurImage_opts_none.cpp',
+            '../src/opts/SkConvertRow_opts_none.cpp',
+            '../src/opts/SkGradient_opts_none.cpp',
+            '../src/opts/SkLighting_opts_none.cpp',
+            '../src/opts/SkMatrix_opts_none.cpp',
+            '../src/opts/SkMatrixConvolution_opts_none.cpp',
+            '../src/opts/SkMipMap_opts_none.cpp',
+            '../src/opts/SkMorphology_opts_none.cpp',
+            '../src/opts/SkStroke_opts_none.cpp',
             '../src/opts/SkUtils_opts_none.cpp',
           ],
         }],
@@ -128,6 +146,7 @@
         [ 'skia_arch_type == "x86"', {
           'sources': [
             '../src/opts/SkBitmapProcState_opts_SSSE3.cpp',
+            '../src/opts/SkConvertRow_opts_SSSE3.cpp',
           ],
         }],
       ],
@@ -165,11 +184,19 @@
       'sources': [
         '../src/opts/memset16_neon.S',
         '../src/opts/memset32_neon.S',
+        '../src/opts/SkBitmapFilter_opts_arm_neon.cpp',
         '../src/opts/SkBitmapProcState_arm_neon.cpp',
         '../src/opts/SkBitmapProcState_matrixProcs_neon.cpp',
         '../src/opts/SkBitmapProcState_matrix_clamp_neon.h',
         '../src/opts/SkBitmapProcState_matrix_repeat_neon.h',
         '../src/opts/SkBlitRow_opts_arm_neon.cpp',
+        '../src/opts/SkBlurImage_opts_arm_neon.cpp',
+        '../src/opts/SkConvertRow_opts_arm_neon.cpp',
+        '../src/opts/SkGradient_opts_arm_neon.cpp',
+        '../src/opts/SkLighting_opts_arm_neon.cpp',
+        '../src/opts/SkMatrixConvolution_opts_arm_neon.cpp',
+        '../src/opts/SkMipMap_opts_arm_neon.cpp',
+        '../src/opts/SkMorphology_opts_arm_neon.cpp',
       ],
     },
   ],
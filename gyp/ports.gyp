@@ -72,6 +72,16 @@
             '../src/ports/SkFontConfigInterface_direct.cpp',
           ],
         }],
+        [ 'skia_os in ["linux", "chromeos"]', {
+          'sources': [
+            '../src/ports/SkDiscardableMemory_linux.cpp',
+            '../src/ports/SkPurgeableMemoryBlock_linux.cpp',
+          ],
+          'sources!': [
+            '../src/ports/SkDiscardableMemory_none.cpp',
+            '../src/ports/SkPurgeableMemoryBlock_none.cpp',
+          ],
+        }],
         [ 'skia_os == "nacl"', {
           'sources': [
             '../src/ports/SkFontHost_linux.cpp',
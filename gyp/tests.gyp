@@ -30,6 +30,7 @@
         '../tests/BitmapGetColorTest.cpp',
         '../tests/BitmapHasherTest.cpp',
         '../tests/BitmapHeapTest.cpp',
+        '../tests/BitmapScalerTest.cpp',
         '../tests/BitSetTest.cpp',
         '../tests/BlitRowTest.cpp',
         '../tests/BlurTest.cpp',
@@ -43,9 +44,11 @@
         '../tests/ClipperTest.cpp',
         '../tests/ColorFilterTest.cpp',
         '../tests/ColorTest.cpp',
+        '../tests/ConvertRowTest.cpp',
         '../tests/DataRefTest.cpp',
         '../tests/DeferredCanvasTest.cpp',
         '../tests/DequeTest.cpp',
+        '../tests/DiscardableMemoryTest.cpp',
         '../tests/DrawBitmapRectTest.cpp',
         '../tests/DrawPathTest.cpp',
         '../tests/DrawTextTest.cpp',
@@ -83,6 +86,7 @@
         '../tests/MemsetTest.cpp',
         '../tests/MetaDataTest.cpp',
         '../tests/MipMapTest.cpp',
+        '../tests/MovieTest.cpp',
         '../tests/OSPathTest.cpp',
         '../tests/PackBitsTest.cpp',
         '../tests/PaintTest.cpp',
@@ -91,6 +95,7 @@
         '../tests/PathMeasureTest.cpp',
         '../tests/PathTest.cpp',
         '../tests/PathUtilsTest.cpp',
+        '../tests/PNGImageEncoderTest.cpp',
         '../tests/PDFPrimitivesTest.cpp',
         '../tests/PictureTest.cpp',
         '../tests/PictureUtilsTest.cpp',
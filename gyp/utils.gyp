@@ -41,6 +41,7 @@
         '../include/utils/SkDebugUtils.h',
         '../include/utils/SkDeferredCanvas.h',
         '../include/utils/SkDumpCanvas.h',
+        '../include/utils/SkImageFilterTiler.h',
         '../include/utils/SkInterpolator.h',
         '../include/utils/SkLayer.h',
         '../include/utils/SkMatrix44.h',
@@ -74,6 +75,7 @@
         '../src/utils/SkDeferredCanvas.cpp',
         '../src/utils/SkDumpCanvas.cpp',
         '../src/utils/SkFloatUtils.h',
+        '../src/utils/SkImageFilterTiler.cpp',
         '../src/utils/SkInterpolator.cpp',
         '../src/utils/SkLayer.cpp',
         '../src/utils/SkMatrix44.cpp',
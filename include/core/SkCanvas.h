@@ -25,6 +25,7 @@ class SkBounder;
 class SkBaseDevice;
 class SkDraw;
 class SkDrawFilter;
+class SkImageFilterCache;
 class SkMetaData;
 class SkPicture;
 class SkRRect;
@@ -923,6 +924,20 @@ public:
     */
     virtual SkDrawFilter* setDrawFilter(SkDrawFilter* filter);
 
+    /** Get the cache of image filter results (or NULL). Its reference count
+        is not affected.
+    */
+    SkImageFilterCache* getImageFilterCache() const { return fImageFilterCache; }
+
+    /** Set a cache for the results of the image filters applied by this
+        canvas (or NULL, the default, to not cache them). The cache may be
+        shared with other canvases. If a previous cache exists, its refcnt is
+        decremented. If cache is not NULL, its refcnt is incremented.
+        @param cache the new cache (or NULL)
+        @return the new cache
+    */
+    SkImageFilterCache* setImageFilterCache(SkImageFilterCache* cache);
+
     //////////////////////////////////////////////////////////////////////////
 
     /** Return the current matrix on the canvas.
@@ -1059,6 +1074,7 @@ private:
     int         fSaveLayerCount;    // number of successful saveLayer calls
 
     SkMetaData* fMetaData;
+    SkImageFilterCache* fImageFilterCache;
 
     SkSurface_Base*  fSurfaceBase;
     SkSurface_Base* getSurfaceBase() const { return fSurfaceBase; }
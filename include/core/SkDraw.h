@@ -21,6 +21,7 @@ class SkBaseDevice;
 class SkMatrix;
 class SkPath;
 class SkRegion;
+class SkRRect;
 class SkRasterClip;
 struct SkDrawProcs;
 struct SkRect;
@@ -34,6 +35,12 @@ public:
     void    drawPoints(SkCanvas::PointMode, size_t count, const SkPoint[],
                        const SkPaint&, bool forceUseDevice = false) const;
     void    drawRect(const SkRect&, const SkPaint&) const;
+    /**
+     *  Draw a mask filtered rrect as a nine-patch, if the mask filter can.
+     *  Returns false, having drawn nothing, if it can't: the caller should then
+     *  draw the rrect as a path.
+     */
+    bool    drawRRect(const SkRRect&, const SkPaint&) const;
     /**
      *  To save on mallocs, we allow a flag that tells us that srcPath is
      *  mutable, so that we don't have to make copies of it as we transform it.
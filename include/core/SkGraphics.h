@@ -64,6 +64,24 @@ public:
     static size_t GetImageCacheByteLimit();
     static size_t SetImageCacheByteLimit(size_t newLimit);
 
+    /**
+     *  The stroke cache keeps the results of stroking paths, so that drawing
+     *  an unchanged path with the same stroke again can skip the stroker. Its
+     *  limit is 0 (disabled) by default.
+     */
+    static size_t GetStrokeCacheBytesUsed();
+    static size_t GetStrokeCacheByteLimit();
+    static size_t SetStrokeCacheByteLimit(size_t newLimit);
+
+    /**
+     *  The path measure cache keeps the segment tables that SkPathMeasure
+     *  builds, so that measuring an unchanged path again (or a copy of it)
+     *  can skip subdividing its curves. Its limit is 0 (disabled) by default.
+     */
+    static size_t GetPathMeasureCacheBytesUsed();
+    static size_t GetPathMeasureCacheByteLimit();
+    static size_t SetPathMeasureCacheByteLimit(size_t newLimit);
+
     /**
      *  Applications with command line options may pass optional state, such
      *  as cache sizes, here, for instance:
@@ -14,6 +14,7 @@
 class SkBitmap;
 class SkColorFilter;
 class SkBaseDevice;
+class SkImageFilterCache;
 class SkMatrix;
 struct SkIPoint;
 class SkShader;
@@ -43,6 +44,8 @@ public:
         virtual bool filterImage(SkImageFilter*, const SkBitmap& src,
                                  const SkMatrix& ctm,
                                  SkBitmap* result, SkIPoint* offset) = 0;
+        // returns the cache of filter results to use, or NULL to not cache.
+        virtual SkImageFilterCache* cache() { return NULL; }
     };
 
     /**
@@ -57,6 +60,9 @@ public:
      *
      *  If the result image cannot be created, return false, in which case both
      *  the result and offset parameters will be ignored by the caller.
+     *
+     *  If the proxy has a cache(), the result is looked up there first, and
+     *  added to it once computed.
      */
     bool filterImage(Proxy*, const SkBitmap& src, const SkMatrix& ctm,
                      SkBitmap* result, SkIPoint* offset);
@@ -67,6 +73,17 @@ public:
      */
     bool filterBounds(const SkIRect& src, const SkMatrix& ctm, SkIRect* dst);
 
+    /**
+     *  The reverse of filterBounds(): given the bounds of the part of the
+     *  result image that is wanted, this returns the bounds of the src pixels
+     *  that it depends on. Both are relative to the src image, whose top left
+     *  is at (0, 0).
+     *
+     *  Returns false if the filter cannot tell, in which case the result may
+     *  depend on all of src, and may not be computed piecewise.
+     */
+    bool filterInputBounds(const SkIRect& dst, const SkMatrix& ctm, SkIRect* src);
+
     /**
      *  Returns true if the filter can be expressed a single-pass
      *  GrEffect, used to process this filter on the GPU, or false if
@@ -140,6 +157,13 @@ public:
      */
     const SkIRect& cropRect() const { return fCropRect; }
 
+    /**
+     *  Returns a non-zero ID that is unique to this filter instance, used to
+     *  key its results in an SkImageFilterCache. Filters are immutable, so
+     *  the ID never changes.
+     */
+    uint32_t uniqueID() const { return fUniqueID; }
+
 protected:
     SkImageFilter(int inputCount, SkImageFilter** inputs, const SkIRect* cropRect = NULL);
 
@@ -158,8 +182,16 @@ protected:
     // Default impl returns false
     virtual bool onFilterImage(Proxy*, const SkBitmap& src, const SkMatrix&,
                                SkBitmap* result, SkIPoint* offset);
-    // Default impl copies src into dst and returns true
+    // Default impl sets dst to the union of the bounds of the inputs' results
+    // (src for a NULL input, or if there are no inputs) and returns true
     virtual bool onFilterBounds(const SkIRect&, const SkMatrix&, SkIRect*);
+    // Default impl returns false
+    virtual bool onFilterInputBounds(const SkIRect& dst, const SkMatrix&, SkIRect* src);
+
+    // Helper for onFilterInputBounds(): sets "src" to the union of the src
+    // bounds that each input needs to produce the "needed" bounds of its
+    // result. A NULL input needs "needed" from src itself.
+    bool inputsFilterInputBounds(const SkIRect& needed, const SkMatrix&, SkIRect* src);
 
     // Applies "matrix" to the crop rect, and sets "rect" to the intersection of
     // "rect" and the transformed crop rect. If there is no overlap, returns
@@ -171,6 +203,7 @@ private:
     int fInputCount;
     SkImageFilter** fInputs;
     SkIRect fCropRect;
+    uint32_t fUniqueID;
 };
 
 #endif
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkImageFilterCache_DEFINED
+#define SkImageFilterCache_DEFINED
+
+#include "SkBitmap.h"
+#include "SkRefCnt.h"
+#include "SkThread.h"
+
+class SkImageFilter;
+class SkMatrix;
+struct SkIPoint;
+
+/**
+ *  Cache of SkImageFilter results, keyed by the filter's uniqueID(), the
+ *  generation ID and subset of the source bitmap, and the matrix. Installed
+ *  on an SkImageFilter::Proxy (e.g. through SkCanvas::setImageFilterCache()),
+ *  it is consulted for every filter of a graph, so an unchanged graph applied
+ *  to an unchanged bitmap is not filtered again, and a filter that appears
+ *  more than once in a graph is only applied once.
+ *
+ *  Results of sources without a pixelref are not cached. Layers drawn with
+ *  saveLayer() get new pixels every time, so only the filters applied to
+ *  bitmaps (drawBitmap(), drawSprite()) are likely to hit.
+ *
+ *  Unlike SkScaledImageCache, an instance is thread-safe.
+ */
+class SK_API SkImageFilterCache : public SkRefCnt {
+public:
+    SK_DECLARE_INST_COUNT(SkImageFilterCache)
+
+    explicit SkImageFilterCache(size_t byteLimit);
+    virtual ~SkImageFilterCache();
+
+    /**
+     *  If the result of filter for src and ctm is in the cache, set result
+     *  to it, add the amount it is offset from src to offset, and return
+     *  true. Otherwise return false and leave result and offset unchanged.
+     */
+    bool find(const SkImageFilter* filter, const SkBitmap& src, const SkMatrix& ctm,
+              SkBitmap* result, SkIPoint* offset);
+
+    /**
+     *  Add the result of filter for src and ctm, offset from src by offset.
+     *  Results larger than a quarter of the byte limit are not added.
+     */
+    void add(const SkImageFilter* filter, const SkBitmap& src, const SkMatrix& ctm,
+             const SkBitmap& result, const SkIPoint& offset);
+
+    /** Remove all the results. */
+    void purgeAll();
+
+    struct Stats {
+        int     fHits;
+        int     fMisses;
+        int     fCount;
+        size_t  fBytesUsed;
+    };
+    void getStats(Stats*) const;
+
+    size_t getByteLimit() const;
+
+    /**
+     *  Set the maximum number of bytes available to this cache. If the current
+     *  cache exceeds this new value, it will be purged to try to fit within
+     *  this new limit. Returns the previous limit.
+     */
+    size_t setByteLimit(size_t newLimit);
+
+private:
+    struct Key;
+    struct Value;
+    class Cache;
+    Cache*  fCache;
+
+    mutable SkMutex fMutex;
+
+    typedef SkRefCnt INHERITED;
+};
+
+#endif
@@ -20,6 +20,7 @@ class SkBounder;
 class SkMatrix;
 class SkPath;
 class SkRasterClip;
+class SkRRect;
 
 /** \class SkMaskFilter
 
@@ -161,6 +162,15 @@ protected:
                                            const SkIRect& clipBounds,
                                            NinePatch*) const;
 
+    /**
+     *  Similar to filterRectsToNine, except it performs the work on a round rect.
+     *  The default returns kUnimplemented_FilterReturn, in which case the rrect
+     *  is drawn as a path.
+     */
+    virtual FilterReturn filterRRectToNine(const SkRRect&, const SkMatrix&,
+                                           const SkIRect& clipBounds,
+                                           NinePatch*) const;
+
 private:
     friend class SkDraw;
 
@@ -173,6 +183,16 @@ private:
                     const SkRasterClip&, SkBounder*, SkBlitter* blitter,
                     SkPaint::Style style) const;
 
+    /** Helper method that, given a roundRect in device space, will filter it
+     into a nine-patch and draw that with the specified blitter. Returns false,
+     without drawing anything, if filterRRectToNine() does not return
+     kTrue_FilterReturn, so that the caller can draw the rrect as a path.
+     This method is not exported to java.
+     */
+    bool filterRRect(const SkRRect& devRRect, const SkMatrix& devMatrix,
+                     const SkRasterClip&, SkBounder*, SkBlitter* blitter,
+                     SkPaint::Style style) const;
+
     typedef SkFlattenable INHERITED;
 };
 
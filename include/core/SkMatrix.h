@@ -398,6 +398,22 @@ public:
         this->mapPoints(pts, pts, count);
     }
 
+    /** Apply this matrix to the src points as mapPoints() does, and set bounds
+        to the bounds of the transformed points, as SkRect::setBoundsCheck()
+        would (in a single pass, where the platform allows it).
+        @param dst  Where the transformed coordinates are written. It must
+                    contain at least count entries
+        @param src  The original coordinates that are to be transformed. It
+                    must contain at least count entries
+        @param count The number of points in src to read, and then transform
+                     into dst.
+        @param bounds Set to the bounds of dst, or to empty if any of the
+                      transformed points are not finite.
+        @return true if all of the transformed points are finite
+    */
+    bool mapPointsWithBounds(SkPoint dst[], const SkPoint src[], int count,
+                             SkRect* bounds) const;
+
     /** Like mapPoints but with custom byte stride between the points. Stride
      *  should be a multiple of sizeof(SkScalar).
      */
@@ -525,6 +541,23 @@ public:
         return GetMapPtsProc(this->getType());
     }
 
+    typedef bool (*MapPtsBoundsProc)(const SkMatrix& mat, SkPoint dst[],
+                                     const SkPoint src[], int count,
+                                     SkRect* bounds);
+
+    /** Return a platform specific MapPtsProc for matrices of the given type,
+        or NULL if the portable one should be used. It must match the
+        portable results exactly, so it may not flush denormals to zero.
+    */
+    static MapPtsProc PlatformMapPtsProc(TypeMask mask);
+
+    /** Return a platform specific proc that does the work of
+        mapPointsWithBounds() for matrices of the given type in a single pass,
+        or NULL if there is none. Its points must match the portable results
+        exactly.
+    */
+    static MapPtsBoundsProc PlatformMapPtsBoundsProc(TypeMask mask);
+
     /** If the matrix can be stepped in X (not complex perspective)
         then return true and if step[XY] is not null, return the step[XY] value.
         If it cannot, return false and ignore step.
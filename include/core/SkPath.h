@@ -974,6 +974,9 @@ private:
     friend class Iter;
 
     friend class SkPathStroker;
+    friend class SkPolylineStroker;
+    friend class SkStrokeCache;   // reads fPathRef's genID
+    friend class SkPathMeasureCache;  // reads fPathRef's genID
     /*  Append the first contour of path, ignoring path's initial point. If no
         moveTo() call has been made for this contour, the first point is
         automatically set to (0,0).
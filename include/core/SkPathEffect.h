@@ -51,6 +51,16 @@ public:
     virtual bool filterPath(SkPath* dst, const SkPath& src,
                             SkStrokeRec*, const SkRect* cullR) const = 0;
 
+    /**
+     *  As filterPath(), for when this is the paint's own path effect, rather
+     *  than one of the effects of an SkComposePathEffect or SkSumPathEffect:
+     *  the caller applies the resulting stroke-rec to dst directly, so the
+     *  effect may do the stroking itself and change the rec to fill.
+     *  The default just calls filterPath().
+     */
+    virtual bool filterAndStrokePath(SkPath* dst, const SkPath& src,
+                                     SkStrokeRec*, const SkRect* cullR) const;
+
     /**
      *  Compute a conservative bounds for its effect, given the src bounds.
      *  The baseline implementation just assigns src to dst.
@@ -11,6 +11,8 @@
 #include "SkPath.h"
 #include "SkTDArray.h"
 
+class SkPathMeasureTable;
+
 class SK_API SkPathMeasure : SkNoncopyable {
 public:
     SkPathMeasure();
@@ -42,6 +44,16 @@ public:
     bool SK_WARN_UNUSED_RESULT getPosTan(SkScalar distance, SkPoint* position,
                                          SkVector* tangent);
 
+    /** Pins each of the count distances to 0 <= distance <= getLength(), and then
+        computes the corresponding positions and tangents (either array may be null),
+        as getPosTan() does for each. Runs of increasing distances are found with a
+        single forward pass over the segments, rather than a search for each one.
+        Returns false if there is no path, or a zero-length path was specified, in which case
+        positions and tangents are unchanged.
+    */
+    bool SK_WARN_UNUSED_RESULT getPosTan(const SkScalar distances[], int count,
+                                         SkPoint positions[], SkVector tangents[]);
+
     enum MatrixFlags {
         kGetPosition_MatrixFlag     = 0x01,
         kGetTangent_MatrixFlag      = 0x02,
@@ -84,26 +96,21 @@ private:
     int             fFirstPtIndex;      // relative to the current contour
     bool            fIsClosed;          // relative to the current contour
     bool            fForceClosed;
+    int             fContour;           // index of the current contour in fTable
+    int             fFirstSegment;      // relative to the current contour
+    int             fSegmentCount;      // relative to the current contour
 
-    struct Segment {
-        SkScalar    fDistance;  // total distance up to this point
-        unsigned    fPtIndex : 15; // index into the fPts array
-        unsigned    fTValue : 15;
-        unsigned    fType : 2;
-
-        SkScalar getScalarT() const;
-    };
-    SkTDArray<Segment>  fSegments;
-    SkTDArray<SkPoint>  fPts; // Points used to define the segments
-
-    static const Segment* NextSegment(const Segment*);
+    // The contours measured so far. If the path measure cache is enabled, it
+    // holds all of them, and may be shared with other measures of the path.
+    SkPathMeasureTable* fTable;
 
     void     buildSegments();
+    void     buildAllSegments();
     SkScalar compute_quad_segs(const SkPoint pts[3], SkScalar distance,
-                                int mint, int maxt, int ptIndex);
-    SkScalar compute_cubic_segs(const SkPoint pts[3], SkScalar distance,
-                                int mint, int maxt, int ptIndex);
-    const Segment* distanceToSegment(SkScalar distance, SkScalar* t);
+                               int ptIndex);
+    SkScalar compute_cubic_segs(const SkPoint pts[4], SkScalar distance,
+                                int ptIndex);
+    int      distanceToSegment(SkScalar distance, SkScalar* t);
 };
 
 #endif
@@ -11,6 +11,7 @@
 #include "SkRect.h"
 #include "SkPoint.h"
 
+class SkMatrix;
 class SkPath;
 
 // Path forward:
@@ -257,6 +258,15 @@ public:
      */
     bool contains(const SkRect& rect) const;
 
+    /**
+     *  Transform by the specified matrix, and put the result in dst. Only
+     *  scale and translate matrices are supported; returns false, leaving
+     *  dst unchanged, for any other matrix.
+     *
+     *  It is valid for dst == this.
+     */
+    bool transform(const SkMatrix& matrix, SkRRect* dst) const;
+
     SkDEBUGCODE(void validate() const;)
 
     enum {
@@ -69,6 +69,12 @@ public:
         return (kStroke_Style == style) || (kStrokeAndFill_Style == style);
     }
 
+    /**
+     *  Return how far (in x or y) the stroke can reach outside of the path it
+     *  strokes: 1 for hairlines (for antialiasing), and 0 for fills.
+     */
+    SkScalar getInflationRadius() const;
+
     /**
      *  Apply these stroke parameters to the src path, returning the result
      *  in dst.
@@ -77,9 +83,14 @@ public:
      *  false and dst is unchanged. Otherwise returns true and the result is
      *  stored in dst.
      *
+     *  If cullRect is not NULL, only the result inside it matters: segments
+     *  whose stroke cannot reach it are not stroked (unless the path is also
+     *  filled).
+     *
      *  src and dst may be the same path.
      */
-    bool applyToPath(SkPath* dst, const SkPath& src) const;
+    bool applyToPath(SkPath* dst, const SkPath& src,
+                     const SkRect* cullRect = NULL) const;
 
 private:
     SkScalar        fWidth;
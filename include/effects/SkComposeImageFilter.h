@@ -23,6 +23,7 @@ protected:
     virtual bool onFilterImage(Proxy*, const SkBitmap& src, const SkMatrix&,
                                SkBitmap* result, SkIPoint* loc) SK_OVERRIDE;
     virtual bool onFilterBounds(const SkIRect&, const SkMatrix&, SkIRect*) SK_OVERRIDE;
+    virtual bool onFilterInputBounds(const SkIRect&, const SkMatrix&, SkIRect*) SK_OVERRIDE;
 
 private:
     typedef SkImageFilter INHERITED;
@@ -43,6 +43,9 @@ public:
     virtual bool filterPath(SkPath* dst, const SkPath& src,
                             SkStrokeRec*, const SkRect*) const SK_OVERRIDE;
 
+    virtual bool filterAndStrokePath(SkPath* dst, const SkPath& src,
+                                     SkStrokeRec*, const SkRect*) const SK_OVERRIDE;
+
     virtual bool asPoints(PointData* results, const SkPath& src,
                           const SkStrokeRec&, const SkMatrix&,
                           const SkRect*) const SK_OVERRIDE;
@@ -56,6 +59,11 @@ protected:
     virtual void flatten(SkFlattenableWriteBuffer&) const SK_OVERRIDE;
 
 private:
+    // If strokeDashes, the dashes may be stroked as they are made (see
+    // filterAndStrokePath()).
+    bool dashPath(SkPath* dst, const SkPath& src, SkStrokeRec*, const SkRect*,
+                  bool strokeDashes) const;
+
     SkScalar*   fIntervals;
     int32_t     fCount;
     // computed from phase
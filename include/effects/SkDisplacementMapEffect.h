@@ -45,6 +45,7 @@ public:
 protected:
     explicit SkDisplacementMapEffect(SkFlattenableReadBuffer& buffer);
     virtual void flatten(SkFlattenableWriteBuffer&) const SK_OVERRIDE;
+    virtual bool onFilterInputBounds(const SkIRect&, const SkMatrix&, SkIRect*) SK_OVERRIDE;
 
 private:
     ChannelSelectorType fXChannelSelector;
@@ -18,6 +18,7 @@ protected:
     explicit SkDropShadowImageFilter(SkFlattenableReadBuffer&);
     virtual void flatten(SkFlattenableWriteBuffer&) const SK_OVERRIDE;
     virtual bool onFilterImage(Proxy*, const SkBitmap& source, const SkMatrix&, SkBitmap* result, SkIPoint* loc) SK_OVERRIDE;
+    virtual bool onFilterInputBounds(const SkIRect&, const SkMatrix&, SkIRect*) SK_OVERRIDE;
 
 private:
     SkScalar fDx, fDy, fSigma;
@@ -60,6 +60,7 @@ protected:
 
     virtual bool onFilterImage(Proxy*, const SkBitmap& src, const SkMatrix&,
                                SkBitmap* result, SkIPoint* loc) SK_OVERRIDE;
+    virtual bool onFilterInputBounds(const SkIRect&, const SkMatrix&, SkIRect*) SK_OVERRIDE;
 
 #if SK_SUPPORT_GPU
     virtual bool asNewEffect(GrEffectRef** effect, GrTexture*, const SkMatrix& matrix) const SK_OVERRIDE;
@@ -73,14 +74,24 @@ private:
     SkIPoint  fTarget;
     TileMode  fTileMode;
     bool      fConvolveAlpha;
+    // If the kernel is separable, the row and column kernels whose product
+    // it is, else NULL.
+    SkScalar* fKernelX;
+    SkScalar* fKernelY;
     typedef SkImageFilter INHERITED;
 
+    void initSeparableKernels();
     template <class PixelFetcher, bool convolveAlpha>
     void filterPixels(const SkBitmap& src, SkBitmap* result, const SkIRect& rect);
     template <class PixelFetcher>
     void filterPixels(const SkBitmap& src, SkBitmap* result, const SkIRect& rect);
     void filterInteriorPixels(const SkBitmap& src, SkBitmap* result, const SkIRect& rect);
     void filterBorderPixels(const SkBitmap& src, SkBitmap* result, const SkIRect& rect);
+    template <class PixelFetcher, bool convolveAlpha>
+    void filterSeparablePixels(const SkBitmap& src, SkBitmap* result);
+    template <class PixelFetcher>
+    void filterSeparablePixels(const SkBitmap& src, SkBitmap* result);
+    void filterSeparablePixels(const SkBitmap& src, SkBitmap* result);
 };
 
 #endif
@@ -7,7 +7,8 @@
 
 /**
  *  This function's sole purpose is to trick the linker into not discarding
- *  SkImageDecoder subclasses just because we do not directly call them.
+ *  SkImageDecoder (and SkMovie) subclasses just because we do not directly
+ *  call them.
  *  This is necessary in applications that will create image decoders from
  *  a stream.
  *  Call this function with an expression that evaluates to false to ensure
@@ -51,6 +51,22 @@ public:
     // return the right bitmap for the current time code
     const SkBitmap& bitmap();
 
+    /** Allow the movie to keep up to 'bytes' worth of fully composited
+        frames, so that seeking (including looping back to the start) does not
+        have to replay the animation from its first frame. If every frame
+        does not fit, evenly spaced keyframes are kept instead, bounding the
+        number of frames replayed per seek. 0 (the default) disables the
+        cache. Formats that don't composite frames ignore this.
+    */
+    void setFrameCacheLimit(size_t bytes);
+
+    /** Start compositing every frame into the frame cache on a background
+        thread, so that later calls to setTime() and bitmap() are cheap.
+        Returns false if the movie has no frame cache (see
+        setFrameCacheLimit()) or does not support this.
+    */
+    bool predecodeFrames();
+
 protected:
     struct Info {
         SkMSec  fDuration;
@@ -62,6 +78,8 @@ protected:
     virtual bool onGetInfo(Info*) = 0;
     virtual bool onSetTime(SkMSec) = 0;
     virtual bool onGetBitmap(SkBitmap*) = 0;
+    virtual void onSetFrameCacheLimit(size_t) {}
+    virtual bool onPredecodeFrames() { return false; }
 
     // visible for subclasses
     SkMovie();
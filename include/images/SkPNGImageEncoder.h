@@ -0,0 +1,77 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPNGImageEncoder_DEFINED
+#define SkPNGImageEncoder_DEFINED
+
+#include "SkImageEncoder.h"
+
+/** \class SkPNGImageEncoder
+
+    The libpng based encoder that SkImageEncoder::Create(kPNG_Type) returns,
+    exposed so that callers that write a lot of PNGs can trade compression
+    ratio for speed. Only available where SkImageDecoder_libpng.cpp is built
+    (i.e. not on Mac, iOS or Windows).
+*/
+class SkPNGImageEncoder : public SkImageEncoder {
+public:
+    /** Which PNG row filters the encoder may choose from.
+     */
+    enum FilterStrategy {
+        kDefault_FilterStrategy,    //!< libpng's choice (adaptive, or none for palettes)
+        kNone_FilterStrategy,
+        kSub_FilterStrategy,
+        kUp_FilterStrategy,
+        kAverage_FilterStrategy,
+        kPaeth_FilterStrategy,
+        kAdaptive_FilterStrategy,   //!< pick the best of all five filters per row
+    };
+
+    struct Options {
+        Options()
+            : fCompressionLevel(kDefault_CompressionLevel)
+            , fFilterStrategy(kDefault_FilterStrategy)
+            , fPaletteReduction(false)
+            , fThreadCount(0) {}
+
+        enum {
+            kDefault_CompressionLevel = -1
+        };
+
+        /** zlib compression level, 0 (store) to 9 (smallest), or
+            kDefault_CompressionLevel.
+         */
+        int             fCompressionLevel;
+        FilterStrategy  fFilterStrategy;
+        /** If true, an ARGB_8888 bitmap that uses at most 256 distinct colors
+            is written as a (much smaller, much faster to deflate) palette PNG.
+         */
+        bool            fPaletteReduction;
+        /** If non-zero, the image data is split into blocks of rows that are
+            deflated in parallel on this many threads (or one per core if
+            SkThreadPool::kThreadPerCore), and then joined into a single zlib
+            stream. Compresses slightly worse than a single stream.
+         */
+        int             fThreadCount;
+    };
+
+    SkPNGImageEncoder() {}
+    explicit SkPNGImageEncoder(const Options& options) : fOptions(options) {}
+
+    const Options& getOptions() const { return fOptions; }
+    void setOptions(const Options& options) { fOptions = options; }
+
+protected:
+    virtual bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) SK_OVERRIDE;
+
+private:
+    Options fOptions;
+
+    typedef SkImageEncoder INHERITED;
+};
+
+#endif
@@ -14,6 +14,8 @@
 class SkBitmap;
 class SkData;
 class SkImageCache;
+class SkRunnable;
+class SkThreadPool;
 
 /**
  *  Factory for creating a bitmap from encoded data.
@@ -66,6 +68,19 @@ public:
      */
     bool installPixelRef(SkData*, SkBitmap*);
 
+    /**
+     *  Decode the pixels of bitmaps set up by installPixelRef ahead of drawing them, so that the
+     *  first lockPixels finds them in the SkImageCache instead of decoding on the calling thread.
+     *  Afterwards the pixels are left unpinned, so the cache may still purge them if it goes over
+     *  budget. Bitmaps which were decoded immediately are skipped cheaply.
+     *  @param SkBitmap Array of count bitmaps. Their pixel refs are kept alive until decoded.
+     *  @param SkThreadPool Pool on which to queue the decodes. If NULL, they are done before
+     *         Prefetch returns.
+     *  @param done If not NULL, run once for each bitmap after its decode, e.g. an SkCountdown.
+     */
+    static void Prefetch(const SkBitmap bitmaps[], int count, SkThreadPool*,
+                         SkRunnable* done = NULL);
+
     /**
      *  An object for selecting an SkImageCache to use based on an SkImage::Info.
      */
@@ -10,12 +10,15 @@
 
 #include "SkImageCache.h"
 #include "SkThread.h"
-#include "SkTInternalLList.h"
-
-class CachedPixels;
 
 /**
  *  SkImageCache implementation that uses an LRU cache to age out old images.
+ *
+ *  IDs are spread over a fixed number of shards, each with its own lock, hash table and LRU list,
+ *  so that threads pinning and releasing different images rarely contend. The budget is shared
+ *  by all the shards; when it is exceeded, the least recently used unpinned pixels of each shard
+ *  are freed in turn, so the ordering is only approximately LRU across the whole cache. The
+ *  budget and the total usage have their own lock, which is only ever taken after a shard's.
  */
 class SkLruImageCache : public SkImageCache {
 
@@ -45,7 +48,7 @@ public:
      *  Return the number of bytes of memory currently in use by the cache. Can include memory that
      *  is no longer pinned, but has not been freed.
      */
-    size_t getImageCacheUsed() const { return fRamUsed; }
+    size_t getImageCacheUsed() const;
 
     virtual void* allocAndPinCache(size_t bytes, ID*) SK_OVERRIDE;
     virtual void* pinCache(ID, SkImageCache::DataStatus*) SK_OVERRIDE;
@@ -53,39 +56,36 @@ public:
     virtual void throwAwayCache(ID) SK_OVERRIDE;
 
 private:
-    // Linked list of recently used. Head is the most recently used, and tail is the least.
-    SkTInternalLList<CachedPixels> fLRU;
-    typedef SkTInternalLList<CachedPixels>::Iter Iter;
+    class Shard;
 
-#ifdef SK_DEBUG
-    // fMutex is mutable so that getMemoryStatus can be const
-    mutable
-#endif
-    SkMutex fMutex;
-    size_t  fRamBudget;
-    size_t  fRamUsed;
+    enum {
+        kShardBits  = 3,
+        kShardCount = 1 << kShardBits
+    };
 
-    /**
-     *  Find the CachedPixels represented by ID, or NULL if not in the cache. Mutex must be locked
-     *  before calling.
-     */
-    CachedPixels* findByID(ID) const;
+    Shard*  fShards;
+
+    // fRamBudget and fRamUsed are guarded by fBudgetMutex.
+    mutable SkMutex fBudgetMutex;
+    size_t          fRamBudget;
+    size_t          fRamUsed;
+
+    Shard& shardFor(ID) const;
+
+    // Update fRamUsed. The caller must hold the lock of the shard that allocated or freed bytes.
+    void didAllocate(size_t bytes);
+    void didFree(size_t bytes);
 
     /**
      *  If over budget, throw away pixels which are not currently in use until below budget or there
-     *  are no more pixels eligible to be thrown away. Mutex must be locked before calling.
+     *  are no more pixels eligible to be thrown away. No shard may be locked by the caller.
      */
     void purgeIfNeeded();
 
     /**
-     *  Purge until below limit. Mutex must be locked before calling.
+     *  Purge until below limit. No shard may be locked by the caller.
      */
     void purgeTilAtOrBelow(size_t limit);
-
-    /**
-     *  Remove a set of CachedPixels. Mutex must be locked before calling.
-     */
-    void removePixels(CachedPixels*);
 };
 
 #endif // SkLruImageCache_DEFINED
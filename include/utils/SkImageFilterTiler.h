@@ -0,0 +1,49 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkImageFilterTiler_DEFINED
+#define SkImageFilterTiler_DEFINED
+
+#include "SkImageFilter.h"
+
+/**
+ *  Filters an image through an SkImageFilter graph one tile of the result at a time, optionally
+ *  on several threads.
+ *
+ *  Each tile only runs the graph over the part of the source it depends on, as reported by
+ *  SkImageFilter::filterInputBounds(), so every intermediate image is about the size of a tile
+ *  rather than the size of the source. The price is that the borders that neighbouring tiles
+ *  depend on are filtered more than once.
+ *
+ *  Graphs with a filter that cannot report its input bounds are filtered in one piece, as are
+ *  results no larger than a tile.
+ */
+class SK_API SkImageFilterTiler {
+public:
+    /**
+     *  @param tileSize     Width and height of the result tiles.
+     *  @param threadCount  Number of threads to filter the tiles on (or one per core if
+     *                      SkThreadPool::kThreadPerCore). If 0, they are filtered on the
+     *                      calling thread.
+     */
+    explicit SkImageFilterTiler(int tileSize, int threadCount = 0)
+        : fTileSize(tileSize), fThreadCount(threadCount) {}
+
+    /**
+     *  Same as filter->filterImage(proxy, src, ctm, result, offset), except that the result may
+     *  be larger, with transparent borders. If threads are used, the proxy must be safe to call
+     *  from all of them.
+     */
+    bool filterImage(SkImageFilter* filter, SkImageFilter::Proxy* proxy, const SkBitmap& src,
+                     const SkMatrix& ctm, SkBitmap* result, SkIPoint* offset) const;
+
+private:
+    int fTileSize;
+    int fThreadCount;
+};
+
+#endif
@@ -31,6 +31,11 @@ public:
      */
     void add(SkRunnable*);
 
+    /**
+     * The number of threads in the pool.
+     */
+    int count() const { return fThreads.count(); }
+
  private:
     struct LinkedRunnable {
         // Unowned pointer.
@@ -232,6 +232,11 @@ void SkBitmapDevice::drawOval(const SkDraw& draw, const SkRect& oval, const SkPa
 void SkBitmapDevice::drawRRect(const SkDraw& draw, const SkRRect& rrect, const SkPaint& paint) {
     CHECK_FOR_NODRAW_ANNOTATION(paint);
 
+    // SkDraw can draw a blurred rrect as a nine-patch.
+    if (paint.getMaskFilter() && draw.drawRRect(rrect, paint)) {
+        return;
+    }
+
     SkPath  path;
     path.addRRect(rrect);
     // call the VIRTUAL version, so any subclasses who do handle drawPath aren't
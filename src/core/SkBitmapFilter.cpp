@@ -15,6 +15,7 @@
 #include "SkUnPreMultiply.h"
 #include "SkShader.h"
 #include "SkRTConf.h"
+#include "SkResampleCache.h"
 #include "SkMath.h"
 
 // These are the per-scanline callbacks that are used when we must resort to
@@ -94,18 +95,18 @@ void highQualityFilter16(const SkBitmapProcState& s, int x, int y, uint16_t* SK_
 
 SK_CONF_DECLARE(const char *, c_bitmapFilter, "bitmap.filter", "mitchell", "Which scanline bitmap filter to use [mitchell, lanczos, hamming, gaussian, triangle, box]");
 
-SkBitmapFilter *SkBitmapFilter::Allocate() {
-    if (!strcmp(c_bitmapFilter, "mitchell")) {
+static SkBitmapFilter* allocate_filter(const char* name) {
+    if (!strcmp(name, "mitchell")) {
         return SkNEW_ARGS(SkMitchellFilter,(1.f/3.f,1.f/3.f));
-    } else if (!strcmp(c_bitmapFilter, "lanczos")) {
+    } else if (!strcmp(name, "lanczos")) {
         return SkNEW(SkLanczosFilter);
-    } else if (!strcmp(c_bitmapFilter, "hamming")) {
+    } else if (!strcmp(name, "hamming")) {
         return SkNEW(SkHammingFilter);
-    } else if (!strcmp(c_bitmapFilter, "gaussian")) {
+    } else if (!strcmp(name, "gaussian")) {
         return SkNEW_ARGS(SkGaussianFilter,(2));
-    } else if (!strcmp(c_bitmapFilter, "triangle")) {
+    } else if (!strcmp(name, "triangle")) {
         return SkNEW(SkTriangleFilter);
-    } else if (!strcmp(c_bitmapFilter, "box")) {
+    } else if (!strcmp(name, "box")) {
         return SkNEW(SkBoxFilter);
     } else {
         SkDEBUGFAIL("Unknown filter type");
@@ -114,6 +115,30 @@ SkBitmapFilter *SkBitmapFilter::Allocate() {
     return NULL;
 }
 
+SkBitmapFilter *SkBitmapFilter::Allocate() {
+    const char* name = c_bitmapFilter;
+    size_t length = strlen(name);
+
+    SkResampleCache::Key key(SkResampleCache::Key::kBitmapFilter_Kind);
+    key.write32(SkToU32(length));
+    SkAutoSTMalloc<8, uint32_t> padded((length + 3) >> 2);
+    sk_bzero(padded.get(), SkAlign4(length));
+    memcpy(padded.get(), name, length);
+    key.write(padded.get(), SkAlign4(length));
+    key.finish();
+
+    SkBitmapFilter* filter = static_cast<SkBitmapFilter*>(SkResampleCache::Find(key));
+    if (NULL == filter) {
+        filter = allocate_filter(name);
+        if (filter) {
+            // Fill in the tables before the filter is shared.
+            filter->precomputeTable();
+            SkResampleCache::Add(key, filter, sizeof(*filter));
+        }
+    }
+    return filter;
+}
+
 bool SkBitmapProcState::setBitmapFilterProcs() {
     if (fFilterLevel != SkPaint::kHigh_FilterLevel) {
         return false;
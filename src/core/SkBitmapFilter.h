@@ -11,6 +11,7 @@
 #define SkBitmapFilter_DEFINED
 
 #include "SkMath.h"
+#include "SkRefCnt.h"
 
 // size of the precomputed bitmap filter tables for high quality filtering.
 // Used to precompute the shape of the filter kernel.
@@ -18,7 +19,7 @@
 
 #define SKBITMAP_FILTER_TABLE_SIZE 128
 
-class SkBitmapFilter {
+class SkBitmapFilter : public SkRefCnt {
   public:
       SkBitmapFilter(float width)
       : fWidth(width), fInvWidth(1.f/width) {
@@ -49,17 +50,10 @@ class SkBitmapFilter {
       virtual float evaluate(float x) const = 0;
       virtual ~SkBitmapFilter() {}
 
+      /** Return the filter chosen by the bitmap.filter SkRTConf, with its
+          tables computed. It may be shared, so the caller must unref() it. */
       static SkBitmapFilter* Allocate();
-  protected:
-      float fWidth;
-      float fInvWidth;
-
-      float fLookupMultiplier;
 
-      mutable bool fPrecomputed;
-      mutable SkFixed fFilterTable[SKBITMAP_FILTER_TABLE_SIZE];
-      mutable SkScalar fFilterTableScalar[SKBITMAP_FILTER_TABLE_SIZE];
-  private:
       void precomputeTable() const {
           fPrecomputed = true;
           SkFixed *ftp = fFilterTable;
@@ -71,6 +65,15 @@ class SkBitmapFilter {
               *ftp++ = SkFloatToFixed(filter_value);
           }
       }
+  protected:
+      float fWidth;
+      float fInvWidth;
+
+      float fLookupMultiplier;
+
+      mutable bool fPrecomputed;
+      mutable SkFixed fFilterTable[SKBITMAP_FILTER_TABLE_SIZE];
+      mutable SkScalar fFilterTableScalar[SKBITMAP_FILTER_TABLE_SIZE];
 };
 
 class SkMitchellFilter: public SkBitmapFilter {
@@ -25,6 +25,18 @@ extern void  Repeat_S16_D16_filter_DX_shaderproc_neon(const SkBitmapProcState&,
 extern void  SI8_opaque_D32_filter_DX_neon(const SkBitmapProcState&, const uint32_t*, int, SkPMColor*);
 extern void  SI8_opaque_D32_filter_DX_shaderproc_neon(const SkBitmapProcState&, int, int, uint32_t*, int);
 extern void  Clamp_SI8_opaque_D32_filter_DX_shaderproc_neon(const SkBitmapProcState&, int, int, uint32_t*, int);
+extern void  S32_opaque_D32_nofilter_DX_neon(const SkBitmapProcState&, const uint32_t*, int, SkPMColor*);
+extern void  S32_opaque_D32_filter_DX_neon(const SkBitmapProcState&, const uint32_t*, int, SkPMColor*);
+extern void  SI8_opaque_D32_nofilter_DX_neon(const SkBitmapProcState&, const uint32_t*, int, SkPMColor*);
+extern void  Clamp_S32_opaque_D32_filter_DX_shaderproc_neon(const SkBitmapProcState&, int, int, uint32_t*, int);
+extern void  Repeat_S32_opaque_D32_nofilter_DX_shaderproc_neon(const SkBitmapProcState&, int, int, uint32_t*, int);
+extern void  Repeat_S32_opaque_D32_filter_DX_shaderproc_neon(const SkBitmapProcState&, int, int, uint32_t*, int);
+extern void  Mirror_S32_opaque_D32_nofilter_DX_shaderproc_neon(const SkBitmapProcState&, int, int, uint32_t*, int);
+extern void  Mirror_S32_opaque_D32_filter_DX_shaderproc_neon(const SkBitmapProcState&, int, int, uint32_t*, int);
+extern void  Repeat_SI8_opaque_D32_nofilter_DX_shaderproc_neon(const SkBitmapProcState&, int, int, uint32_t*, int);
+extern void  Repeat_SI8_opaque_D32_filter_DX_shaderproc_neon(const SkBitmapProcState&, int, int, uint32_t*, int);
+extern void  Mirror_SI8_opaque_D32_nofilter_DX_shaderproc_neon(const SkBitmapProcState&, int, int, uint32_t*, int);
+extern void  Mirror_SI8_opaque_D32_filter_DX_shaderproc_neon(const SkBitmapProcState&, int, int, uint32_t*, int);
 #endif
 
 #define   NAME_WRAP(x)  x
@@ -237,8 +249,10 @@ void SkBitmapProcState::possiblyScaleImage() {
 
         if (mip) {
             SkScalar levelScale = SkScalarInvert(SkScalarSqrt(scaleSqd));
+            SkFixed levelIndex = SkMipMap::ComputeLevel(levelScale);
+            int index = SkMin32(levelIndex >> 16, mip->countLevels());
             SkMipMap::Level level;
-            if (mip->extractLevel(levelScale, &level)) {
+            if (mip->getLevel(index, &level)) {
                 SkScalar invScaleFixup = level.fScale;
                 fInvMatrix.postScale(invScaleFixup, invScaleFixup);
 
@@ -248,6 +262,24 @@ void SkBitmapProcState::possiblyScaleImage() {
                 fScaledBitmap.setPixels(level.fPixels);
                 fBitmap = &fScaledBitmap;
             }
+
+            // Rather than jumping from one level to the next as the scale
+            // changes, blend in the next smaller level by how far the scale
+            // is towards it. The blending shader proc only knows the clamp
+            // mode's matrix (see chooseProcs), and only the 32 bit procs do
+            // it.
+            unsigned fraction = (levelIndex & 0xFFFF) >> 8;
+            if (fraction > 0 && index < mip->countLevels() &&
+                    SkShader::kClamp_TileMode == fTileModeX &&
+                    SkShader::kClamp_TileMode == fTileModeY &&
+                    mip->getLevel(index + 1, &level)) {
+                fMipBitmap.setConfig(fOrigBitmap.config(),
+                                     level.fWidth, level.fHeight,
+                                     level.fRowBytes);
+                fMipBitmap.setPixels(level.fPixels);
+                fMipScale = level.fScale;
+                fMipWeight = SkAlpha255To256(fraction);
+            }
         }
     }
 
@@ -259,10 +291,15 @@ void SkBitmapProcState::possiblyScaleImage() {
 }
 
 void SkBitmapProcState::endContext() {
-    SkDELETE(fBitmapFilter);
+    SkSafeUnref(fBitmapFilter);
     fBitmapFilter = NULL;
     fScaledBitmap.reset();
 
+    SkDELETE(fMipState);
+    fMipState = NULL;
+    fMipWeight = 0;
+    fMipBitmap.reset();
+
     if (fScaledCacheID) {
         SkScaledImageCache::Unlock(fScaledCacheID);
         fScaledCacheID = NULL;
@@ -273,7 +310,8 @@ SkBitmapProcState::~SkBitmapProcState() {
     if (fScaledCacheID) {
         SkScaledImageCache::Unlock(fScaledCacheID);
     }
-    SkDELETE(fBitmapFilter);
+    SkSafeUnref(fBitmapFilter);
+    SkDELETE(fMipState);
 }
 
 bool SkBitmapProcState::chooseProcs(const SkMatrix& inv, const SkPaint& paint) {
@@ -297,6 +335,8 @@ bool SkBitmapProcState::chooseProcs(const SkMatrix& inv, const SkPaint& paint) {
     // or can't provide as high a quality filtering as the user requested.
 
     fFilterLevel = paint.getFilterLevel();
+    SkASSERT(NULL == fMipState);
+    fMipWeight = 0;
 
 #ifndef SK_IGNORE_IMAGE_PRESCALE
     // possiblyScaleImage will look to see if it can rescale the image as a
@@ -509,21 +549,99 @@ bool SkBitmapProcState::chooseProcs(const SkMatrix& inv, const SkPaint& paint) {
                        SkShader::kRepeat_TileMode == fTileModeY) {
                 fShaderProc16 = SK_ARM_NEON_WRAP(Repeat_S16_D16_filter_DX_shaderproc);
             }
-        } else if (SK_ARM_NEON_WRAP(SI8_opaque_D32_filter_DX) == fSampleProc32 && clampClamp) {
-            fShaderProc32 = SK_ARM_NEON_WRAP(Clamp_SI8_opaque_D32_filter_DX_shaderproc);
         }
 
         if (NULL == fShaderProc32) {
             fShaderProc32 = this->chooseShaderProc32();
         }
+        if (NULL == fShaderProc32) {
+            fShaderProc32 = this->chooseScaleShaderProc32();
+        }
     }
 
     // see if our platform has any accelerated overrides
     this->platformProcs();
 
+    if (fMipWeight && !this->setupMipBlend(inv, paint)) {
+        fMipWeight = 0;
+    }
+
     return true;
 }
 
+bool SkBitmapProcState::setupMipBlend(const SkMatrix& inv,
+                                      const SkPaint& paint) {
+    SkASSERT(SkShader::kClamp_TileMode == fTileModeX &&
+             SkShader::kClamp_TileMode == fTileModeY);
+
+    // For the clamp mode, our matrix is inv scaled by the level's scale, so
+    // the other level's is the same with its scale.
+    SkMatrix mipInv(inv);
+    mipInv.postScale(fMipScale, fMipScale);
+
+    SkPaint mipPaint(paint);
+    mipPaint.setFilterLevel(SkPaint::kLow_FilterLevel);
+
+    fMipState = SkNEW(SkBitmapProcState);
+    fMipState->fTileModeX = fTileModeX;
+    fMipState->fTileModeY = fTileModeY;
+    fMipState->fOrigBitmap = fMipBitmap;
+    fMipState->fOrigBitmap.lockPixels();
+    if (!fMipState->chooseProcs(mipInv, mipPaint)) {
+        SkDELETE(fMipState);
+        fMipState = NULL;
+        return false;
+    }
+
+    fLevelShaderProc32 = fShaderProc32;
+    fShaderProc32 = MipBlend_shaderproc32;
+    return true;
+}
+
+static void shade_span(const SkBitmapProcState& s,
+                       SkBitmapProcState::ShaderProc32 proc,
+                       int x, int y, SkPMColor colors[], int count) {
+    if (proc) {
+        proc(s, x, y, colors, count);
+        return;
+    }
+
+    uint32_t buffer[128];
+    SkBitmapProcState::MatrixProc mproc = s.getMatrixProc();
+    SkBitmapProcState::SampleProc32 sproc = s.getSampleProc32();
+    const int max = s.maxCountForBufferSize(sizeof(buffer));
+    while (count > 0) {
+        int n = SkMin32(count, max);
+        mproc(s, buffer, n, x, y);
+        sproc(s, buffer, n, colors);
+        x += n;
+        colors += n;
+        count -= n;
+    }
+}
+
+void SkBitmapProcState::MipBlend_shaderproc32(const SkBitmapProcState& s,
+                                              int x, int y,
+                                              SkPMColor colors[], int count) {
+    SkASSERT(s.fMipState);
+    const SkBitmapProcState& next = *s.fMipState;
+    const unsigned weight = s.fMipWeight;
+
+    SkPMColor nextColors[128];
+    while (count > 0) {
+        int n = SkMin32(count, SK_ARRAY_COUNT(nextColors));
+        shade_span(s, s.fLevelShaderProc32, x, y, colors, n);
+        shade_span(next, next.getShaderProc32(), x, y, nextColors, n);
+        for (int i = 0; i < n; ++i) {
+            colors[i] = SkFastFourByteInterp256(nextColors[i], colors[i],
+                                                weight);
+        }
+        x += n;
+        colors += n;
+        count -= n;
+    }
+}
+
 static void Clamp_S32_D32_nofilter_trans_shaderproc(const SkBitmapProcState& s,
                                                     int x, int y,
                                                     SkPMColor* SK_RESTRICT colors,
@@ -824,6 +942,52 @@ SkBitmapProcState::ShaderProc32 SkBitmapProcState::chooseShaderProc32() {
     return NULL;
 }
 
+SkBitmapProcState::ShaderProc32 SkBitmapProcState::chooseScaleShaderProc32() {
+    if (fTileModeX != fTileModeY || NULL == fSampleProc32) {
+        return NULL;
+    }
+    // The nofilter sample procs are also used for translates, which have
+    // their own shaderprocs (see chooseShaderProc32).
+    if (0 == (fInvType & SkMatrix::kScale_Mask) ||
+        (fInvType & ~(SkMatrix::kTranslate_Mask | SkMatrix::kScale_Mask))) {
+        return NULL;
+    }
+
+    // For each of the opaque, scale only sample procs, the shaderprocs which
+    // fuse it with the matrixproc of each tile mode. Clamp nofilter has none,
+    // since the clamp matrixprocs do not all step through x the same way (see
+    // SkBitmapProcState_procs.h).
+    const struct {
+        SampleProc32    fSampleProc;
+        ShaderProc32    fShaderProcs[3];    // clamp, repeat, mirror
+    } gProcs[] = {
+        { SK_ARM_NEON_WRAP(S32_opaque_D32_nofilter_DX), {
+            NULL,
+            SK_ARM_NEON_WRAP(Repeat_S32_opaque_D32_nofilter_DX_shaderproc),
+            SK_ARM_NEON_WRAP(Mirror_S32_opaque_D32_nofilter_DX_shaderproc) } },
+        { SK_ARM_NEON_WRAP(S32_opaque_D32_filter_DX), {
+            SK_ARM_NEON_WRAP(Clamp_S32_opaque_D32_filter_DX_shaderproc),
+            SK_ARM_NEON_WRAP(Repeat_S32_opaque_D32_filter_DX_shaderproc),
+            SK_ARM_NEON_WRAP(Mirror_S32_opaque_D32_filter_DX_shaderproc) } },
+        { SK_ARM_NEON_WRAP(SI8_opaque_D32_nofilter_DX), {
+            NULL,
+            SK_ARM_NEON_WRAP(Repeat_SI8_opaque_D32_nofilter_DX_shaderproc),
+            SK_ARM_NEON_WRAP(Mirror_SI8_opaque_D32_nofilter_DX_shaderproc) } },
+        { SK_ARM_NEON_WRAP(SI8_opaque_D32_filter_DX), {
+            SK_ARM_NEON_WRAP(Clamp_SI8_opaque_D32_filter_DX_shaderproc),
+            SK_ARM_NEON_WRAP(Repeat_SI8_opaque_D32_filter_DX_shaderproc),
+            SK_ARM_NEON_WRAP(Mirror_SI8_opaque_D32_filter_DX_shaderproc) } },
+    };
+
+    SkASSERT(fTileModeX < SK_ARRAY_COUNT(gProcs[0].fShaderProcs));
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gProcs); ++i) {
+        if (gProcs[i].fSampleProc == fSampleProc32) {
+            return gProcs[i].fShaderProcs[fTileModeX];
+        }
+    }
+    return NULL;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef SK_DEBUG
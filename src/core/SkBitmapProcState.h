@@ -36,7 +36,8 @@ struct SkConvolutionProcs;
 
 struct SkBitmapProcState {
 
-    SkBitmapProcState(): fScaledCacheID(NULL), fBitmapFilter(NULL) {}
+    SkBitmapProcState(): fScaledCacheID(NULL), fBitmapFilter(NULL),
+                         fMipWeight(0), fMipState(NULL) {}
     ~SkBitmapProcState();
 
     typedef void (*ShaderProc32)(const SkBitmapProcState&, int x, int y,
@@ -113,7 +114,7 @@ struct SkBitmapProcState {
         if we have SIMD versions of them.
       */
 
-    void platformConvolutionProcs(SkConvolutionProcs*);
+    static void platformConvolutionProcs(SkConvolutionProcs*);
 
     /** Given the byte size of the index buffer to be passed to the matrix proc,
         return the maximum number of resulting pixels that can be computed
@@ -159,6 +160,10 @@ private:
     MatrixProc chooseMatrixProc(bool trivial_matrix);
     bool chooseProcs(const SkMatrix& inv, const SkPaint&);
     ShaderProc32 chooseShaderProc32();
+    // For scale only matrices with the same tile mode in x and y, return a
+    // shaderproc which does the work of fMatrixProc and fSampleProc32 in one
+    // pass, or NULL.
+    ShaderProc32 chooseScaleShaderProc32();
 
     void possiblyScaleImage();
 
@@ -171,6 +176,21 @@ private:
     // Return false if we failed to setup for fast translate (e.g. overflow)
     bool setupForTranslate();
 
+    // Trilinear filtering: when possiblyScaleImage picks a mip level, it may
+    // also pick the next smaller one (fMipBitmap, at fMipScale of the
+    // original) to blend in by fMipWeight (1..256). If so, fMipState samples
+    // that level, and fShaderProc32 blends its colors with ours, which
+    // fLevelShaderProc32 (if not NULL) or the matrix and sample procs shade.
+    SkBitmap            fMipBitmap;
+    SkScalar            fMipScale;
+    unsigned            fMipWeight;
+    SkBitmapProcState*  fMipState;
+    ShaderProc32        fLevelShaderProc32;
+
+    bool setupMipBlend(const SkMatrix& inv, const SkPaint&);
+    static void MipBlend_shaderproc32(const SkBitmapProcState&, int x, int y,
+                                      SkPMColor[], int count);
+
 #ifdef SK_DEBUG
     static void DebugMatrixProc(const SkBitmapProcState&,
                                 uint32_t[], int count, int x, int y);
@@ -222,6 +242,27 @@ void ClampX_ClampY_nofilter_affine(const SkBitmapProcState& s,
 void S32_D16_filter_DX(const SkBitmapProcState& s,
                        const uint32_t* xy, int count, uint16_t* colors);
 
+void Repeat_S32_opaque_D32_nofilter_DX_shaderproc(const SkBitmapProcState& s, int x, int y,
+                                                  SkPMColor* colors, int count);
+void Mirror_S32_opaque_D32_nofilter_DX_shaderproc(const SkBitmapProcState& s, int x, int y,
+                                                  SkPMColor* colors, int count);
+void Clamp_S32_opaque_D32_filter_DX_shaderproc(const SkBitmapProcState& s, int x, int y,
+                                               SkPMColor* colors, int count);
+void Repeat_S32_opaque_D32_filter_DX_shaderproc(const SkBitmapProcState& s, int x, int y,
+                                                SkPMColor* colors, int count);
+void Mirror_S32_opaque_D32_filter_DX_shaderproc(const SkBitmapProcState& s, int x, int y,
+                                                SkPMColor* colors, int count);
+void Repeat_SI8_opaque_D32_nofilter_DX_shaderproc(const SkBitmapProcState& s, int x, int y,
+                                                  SkPMColor* colors, int count);
+void Mirror_SI8_opaque_D32_nofilter_DX_shaderproc(const SkBitmapProcState& s, int x, int y,
+                                                  SkPMColor* colors, int count);
+void Clamp_SI8_opaque_D32_filter_DX_shaderproc(const SkBitmapProcState& s, int x, int y,
+                                               SkPMColor* colors, int count);
+void Repeat_SI8_opaque_D32_filter_DX_shaderproc(const SkBitmapProcState& s, int x, int y,
+                                                SkPMColor* colors, int count);
+void Mirror_SI8_opaque_D32_filter_DX_shaderproc(const SkBitmapProcState& s, int x, int y,
+                                                SkPMColor* colors, int count);
+
 void highQualityFilter32(const SkBitmapProcState &s, int x, int y,
                          SkPMColor *SK_RESTRICT colors, int count);
 void highQualityFilter16(const SkBitmapProcState &s, int x, int y,
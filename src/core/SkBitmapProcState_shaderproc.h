@@ -9,6 +9,7 @@
 #include "SkMathPriv.h"
 
 #define SCALE_FILTER_NAME       MAKENAME(_filter_DX_shaderproc)
+#define SCALE_NOFILTER_NAME     MAKENAME(_nofilter_DX_shaderproc)
 
 // Can't be static in the general case because some of these implementations
 // will be defined and referenced in different object files.
@@ -26,8 +27,8 @@ void SCALE_FILTER_NAME(const SkBitmapProcState& s, int x, int y,
 
     const unsigned maxX = s.fBitmap->width() - 1;
     const SkFixed oneX = s.fFilterOneX;
-    const SkFixed dx = s.fInvSx;
-    SkFixed fx;
+    const SkFractionalInt dx = s.fInvSxFractionalInt;
+    SkFractionalInt fx;
     const SRCTYPE* SK_RESTRICT row0;
     const SRCTYPE* SK_RESTRICT row1;
     unsigned subY;
@@ -47,8 +48,8 @@ void SCALE_FILTER_NAME(const SkBitmapProcState& s, int x, int y,
         size_t rb = s.fBitmap->rowBytes();
         row0 = (const SRCTYPE*)(srcAddr + y0 * rb);
         row1 = (const SRCTYPE*)(srcAddr + y1 * rb);
-        // now initialize fx
-        fx = SkScalarToFixed(pt.fX) - (oneX >> 1);
+        // now initialize fx, accumulating it as the matrix procs do
+        fx = SkScalarToFractionalInt(pt.fX) - (SkFixedToFractionalInt(oneX) >> 1);
     }
 
 #ifdef PREAMBLE
@@ -56,9 +57,10 @@ void SCALE_FILTER_NAME(const SkBitmapProcState& s, int x, int y,
 #endif
 
     do {
-        unsigned subX = TILEX_LOW_BITS(fx, maxX);
-        unsigned x0 = TILEX_PROCF(fx, maxX);
-        unsigned x1 = TILEX_PROCF((fx + oneX), maxX);
+        SkFixed fixedFx = SkFractionalIntToFixed(fx);
+        unsigned subX = TILEX_LOW_BITS(fixedFx, maxX);
+        unsigned x0 = TILEX_PROCF(fixedFx, maxX);
+        unsigned x1 = TILEX_PROCF((fixedFx + oneX), maxX);
 
         FILTER_PROC(subX, subY,
                     SRC_TO_FILTER(row0[x0]),
@@ -76,6 +78,58 @@ void SCALE_FILTER_NAME(const SkBitmapProcState& s, int x, int y,
 #endif
 }
 
+// The nofilter version is only generated for sources which can be sampled
+// directly, i.e. if RETURNDST (which turns a source pixel into a DSTTYPE) is
+// defined. It is for scales only: translations have their own shaderprocs.
+#ifdef RETURNDST
+
+void SCALE_NOFILTER_NAME(const SkBitmapProcState& s, int x, int y,
+                         DSTTYPE* SK_RESTRICT colors, int count);
+
+void SCALE_NOFILTER_NAME(const SkBitmapProcState& s, int x, int y,
+                         DSTTYPE* SK_RESTRICT colors, int count) {
+    SkASSERT((s.fInvType & ~(SkMatrix::kTranslate_Mask |
+                             SkMatrix::kScale_Mask)) == 0);
+    SkASSERT(s.fInvKy == 0);
+    SkASSERT(count > 0 && colors != NULL);
+    SkASSERT(s.fFilterLevel == SkPaint::kNone_FilterLevel);
+    SkDEBUGCODE(CHECKSTATE(s);)
+
+    const unsigned maxX = s.fBitmap->width() - 1;
+    const SkFractionalInt dx = s.fInvSxFractionalInt;
+    SkFractionalInt fx;
+    const SRCTYPE* SK_RESTRICT row;
+
+    {
+        SkPoint pt;
+        s.fInvProc(s.fInvMatrix, SkIntToScalar(x) + SK_ScalarHalf,
+                   SkIntToScalar(y) + SK_ScalarHalf, &pt);
+        SkFixed fy = SkFractionalIntToFixed(SkScalarToFractionalInt(pt.fY));
+        const unsigned maxY = s.fBitmap->height() - 1;
+        int y0 = TILEY_PROCF(fy, maxY);
+
+        const char* SK_RESTRICT srcAddr = (const char*)s.fBitmap->getPixels();
+        row = (const SRCTYPE*)(srcAddr + y0 * s.fBitmap->rowBytes());
+        fx = SkScalarToFractionalInt(pt.fX);
+    }
+
+#ifdef PREAMBLE
+    PREAMBLE(s);
+#endif
+
+    do {
+        unsigned x0 = TILEX_PROCF(SkFractionalIntToFixed(fx), maxX);
+        *colors++ = RETURNDST(row[x0]);
+        fx += dx;
+    } while (--count != 0);
+
+#ifdef POSTAMBLE
+    POSTAMBLE(s);
+#endif
+}
+
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #undef TILEX_PROCF
@@ -90,5 +144,7 @@ void SCALE_FILTER_NAME(const SkBitmapProcState& s, int x, int y,
 #undef FILTER_TO_DST
 #undef PREAMBLE
 #undef POSTAMBLE
+#undef RETURNDST
 
 #undef SCALE_FILTER_NAME
+#undef SCALE_NOFILTER_NAME
@@ -4,9 +4,22 @@
 #include "SkTArray.h"
 #include "SkErrorInternals.h"
 #include "SkConvolver.h"
+#include "SkResampleCache.h"
 
 // SkResizeFilter ----------------------------------------------------------------
 
+// A computed filter, shared through SkResampleCache.
+class SkCachedConvolutionFilter : public SkRefCnt {
+public:
+    SkConvolutionFilter1D fFilter;
+
+    // An estimate of the memory used by the filter.
+    size_t bytesUsed() const {
+        return sizeof(*this) + fFilter.numValues() *
+            (4 * sizeof(int) + fFilter.maxFilter() * sizeof(SkConvolutionFilter1D::ConvolutionFixed));
+    }
+};
+
 // Encapsulates computation and storage of the filters required for one complete
 // resize operation.
 class SkResizeFilter {
@@ -21,13 +34,21 @@ public:
     }
 
     // Returns the filled filter values.
-    const SkConvolutionFilter1D& xFilter() { return fXFilter; }
-    const SkConvolutionFilter1D& yFilter() { return fYFilter; }
+    const SkConvolutionFilter1D& xFilter() { return fXFilter->fFilter; }
+    const SkConvolutionFilter1D& yFilter() { return fYFilter->fFilter; }
 
 private:
 
+    // Only allocated if a filter is not found in the cache.
     SkBitmapFilter* fBitmapFilter;
 
+    // Returns the filter for one dimension, from SkResampleCache if it has
+    // been computed before, with a ref that the caller must balance.
+    SkCachedConvolutionFilter* findOrComputeFilters(SkBitmapScaler::ResizeMethod method,
+                                                    int srcSize, int destSize,
+                                                    int destSubsetLo, int destSubsetSize,
+                                                    const SkConvolutionProcs& convolveProcs);
+
     // Computes one set of filters either horizontally or vertically. The caller
     // will specify the "min" and "max" rather than the bottom/top and
     // right/bottom so that the same code can be re-used in each dimension.
@@ -45,52 +66,76 @@ private:
                         SkConvolutionFilter1D* output,
                         const SkConvolutionProcs& convolveProcs);
 
-    SkConvolutionFilter1D fXFilter;
-    SkConvolutionFilter1D fYFilter;
+    SkAutoTUnref<SkCachedConvolutionFilter> fXFilter;
+    SkAutoTUnref<SkCachedConvolutionFilter> fYFilter;
 };
 
-SkResizeFilter::SkResizeFilter(SkBitmapScaler::ResizeMethod method,
-                               int srcFullWidth, int srcFullHeight,
-                               int destWidth, int destHeight,
-                               const SkIRect& destSubset,
-                               const SkConvolutionProcs& convolveProcs) {
-
-    // method will only ever refer to an "algorithm method".
-    SkASSERT((SkBitmapScaler::RESIZE_FIRST_ALGORITHM_METHOD <= method) &&
-             (method <= SkBitmapScaler::RESIZE_LAST_ALGORITHM_METHOD));
-
+static SkBitmapFilter* allocate_filter(SkBitmapScaler::ResizeMethod method) {
     switch(method) {
         case SkBitmapScaler::RESIZE_BOX:
-            fBitmapFilter = SkNEW(SkBoxFilter);
-            break;
+            return SkNEW(SkBoxFilter);
         case SkBitmapScaler::RESIZE_TRIANGLE:
-            fBitmapFilter = SkNEW(SkTriangleFilter);
-            break;
+            return SkNEW(SkTriangleFilter);
         case SkBitmapScaler::RESIZE_MITCHELL:
-            fBitmapFilter = SkNEW_ARGS(SkMitchellFilter, (1.f/3.f, 1.f/3.f));
-            break;
+            return SkNEW_ARGS(SkMitchellFilter, (1.f/3.f, 1.f/3.f));
         case SkBitmapScaler::RESIZE_HAMMING:
-            fBitmapFilter = SkNEW(SkHammingFilter);
-            break;
+            return SkNEW(SkHammingFilter);
         case SkBitmapScaler::RESIZE_LANCZOS3:
-            fBitmapFilter = SkNEW(SkLanczosFilter);
-            break;
+            return SkNEW(SkLanczosFilter);
         default:
             // NOTREACHED:
-            fBitmapFilter = SkNEW_ARGS(SkMitchellFilter, (1.f/3.f, 1.f/3.f));
-            break;
+            return SkNEW_ARGS(SkMitchellFilter, (1.f/3.f, 1.f/3.f));
     }
+}
 
+SkResizeFilter::SkResizeFilter(SkBitmapScaler::ResizeMethod method,
+                               int srcFullWidth, int srcFullHeight,
+                               int destWidth, int destHeight,
+                               const SkIRect& destSubset,
+                               const SkConvolutionProcs& convolveProcs)
+    : fBitmapFilter(NULL) {
 
-    float scaleX = static_cast<float>(destWidth) /
-                   static_cast<float>(srcFullWidth);
-    float scaleY = static_cast<float>(destHeight) /
-                   static_cast<float>(srcFullHeight);
+    // method will only ever refer to an "algorithm method".
+    SkASSERT((SkBitmapScaler::RESIZE_FIRST_ALGORITHM_METHOD <= method) &&
+             (method <= SkBitmapScaler::RESIZE_LAST_ALGORITHM_METHOD));
 
-    this->computeFilters(srcFullWidth, destSubset.fLeft, destSubset.width(),
-                         scaleX, &fXFilter, convolveProcs);
-    this->computeFilters(srcFullHeight, destSubset.fTop, destSubset.height(),
-                         scaleY, &fYFilter, convolveProcs);
+    fXFilter.reset(this->findOrComputeFilters(method, srcFullWidth, destWidth,
+                                              destSubset.fLeft, destSubset.width(),
+                                              convolveProcs));
+    fYFilter.reset(this->findOrComputeFilters(method, srcFullHeight, destHeight,
+                                              destSubset.fTop, destSubset.height(),
+                                              convolveProcs));
+}
+
+SkCachedConvolutionFilter* SkResizeFilter::findOrComputeFilters(
+                                        SkBitmapScaler::ResizeMethod method,
+                                        int srcSize, int destSize,
+                                        int destSubsetLo, int destSubsetSize,
+                                        const SkConvolutionProcs& convolveProcs) {
+    // The filters depend on nothing else. The SIMD padding only appends zeros,
+    // so it is enough to know whether it was applied.
+    SkResampleCache::Key key(SkResampleCache::Key::kConvolutionFilter_Kind);
+    key.write32(method);
+    key.write32(srcSize);
+    key.write32(destSize);
+    key.write32(destSubsetLo);
+    key.write32(destSubsetSize);
+    key.write32(NULL != convolveProcs.fApplySIMDPadding);
+    key.finish();
+
+    SkCachedConvolutionFilter* filter =
+        static_cast<SkCachedConvolutionFilter*>(SkResampleCache::Find(key));
+    if (NULL == filter) {
+        if (NULL == fBitmapFilter) {
+            fBitmapFilter = allocate_filter(method);
+        }
+        filter = SkNEW(SkCachedConvolutionFilter);
+        float scale = static_cast<float>(destSize) / static_cast<float>(srcSize);
+        this->computeFilters(srcSize, destSubsetLo, destSubsetSize, scale,
+                             &filter->fFilter, convolveProcs);
+        SkResampleCache::Add(key, filter, filter->bytesUsed());
+    }
+    return filter;
 }
 
 // TODO(egouriou): Take advantage of periods in the convolution.
@@ -239,7 +284,8 @@ bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
                             int destWidth, int destHeight,
                             const SkIRect& destSubset,
                             const SkConvolutionProcs& convolveProcs,
-                            SkBitmap::Allocator* allocator) {
+                            SkBitmap::Allocator* allocator,
+                            int threadCount) {
   // Ensure that the ResizeMethod enumeration is sound.
     SkASSERT(((RESIZE_FIRST_QUALITY_METHOD <= method) &&
         (method <= RESIZE_LAST_QUALITY_METHOD)) ||
@@ -297,7 +343,7 @@ bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
         !source.isOpaque(), filter.xFilter(), filter.yFilter(),
         static_cast<int>(result.rowBytes()),
         static_cast<unsigned char*>(result.getPixels()),
-        convolveProcs, true);
+        convolveProcs, true, threadCount);
 
     // Preserve the "opaque" flag for use as an optimization later.
     result.setIsOpaque(source.isOpaque());
@@ -311,8 +357,9 @@ bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
                             ResizeMethod method,
                             int destWidth, int destHeight,
                             const SkConvolutionProcs& convolveProcs,
-                            SkBitmap::Allocator* allocator) {
+                            SkBitmap::Allocator* allocator,
+                            int threadCount) {
     SkIRect destSubset = { 0, 0, destWidth, destHeight };
     return Resize(resultPtr, source, method, destWidth, destHeight, destSubset,
-                  convolveProcs, allocator);
+                  convolveProcs, allocator, threadCount);
 }
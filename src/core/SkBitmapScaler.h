@@ -87,13 +87,17 @@ public:
     // will save work if you do not need the entire bitmap.
     //
     // The destination subset must be smaller than the destination image.
+    //
+    // The convolution runs on threadCount threads (see BGRAConvolve2D), or on
+    // the calling thread if threadCount is 0.
     static bool Resize(SkBitmap* result,
                        const SkBitmap& source,
                        ResizeMethod method,
                        int dest_width, int dest_height,
                        const SkIRect& dest_subset,
                        const SkConvolutionProcs&,
-                       SkBitmap::Allocator* allocator = NULL);
+                       SkBitmap::Allocator* allocator = NULL,
+                       int threadCount = 0);
 
     // Alternate version for resizing and returning the entire bitmap rather than
     // a subset.
@@ -102,7 +106,8 @@ public:
                        ResizeMethod method,
                        int dest_width, int dest_height,
                        const SkConvolutionProcs&,
-                       SkBitmap::Allocator* allocator = NULL);
+                       SkBitmap::Allocator* allocator = NULL,
+                       int threadCount = 0);
 };
 
 #endif
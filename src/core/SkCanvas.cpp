@@ -14,6 +14,7 @@
 #include "SkDraw.h"
 #include "SkDrawFilter.h"
 #include "SkDrawLooper.h"
+#include "SkImageFilterCache.h"
 #include "SkMetaData.h"
 #include "SkPathOps.h"
 #include "SkPicture.h"
@@ -491,6 +492,7 @@ SkBaseDevice* SkCanvas::init(SkBaseDevice* device) {
     fDeviceCMDirty = false;
     fSaveLayerCount = 0;
     fMetaData = NULL;
+    fImageFilterCache = NULL;
 
     fMCRec = (MCRec*)fMCStack.push_back();
     new (fMCRec) MCRec(NULL, 0);
@@ -534,6 +536,7 @@ SkCanvas::~SkCanvas() {
 
     SkSafeUnref(fBounder);
     SkDELETE(fMetaData);
+    SkSafeUnref(fImageFilterCache);
 
     dec_canvas();
 }
@@ -552,6 +555,11 @@ SkDrawFilter* SkCanvas::setDrawFilter(SkDrawFilter* filter) {
     return filter;
 }
 
+SkImageFilterCache* SkCanvas::setImageFilterCache(SkImageFilterCache* cache) {
+    SkRefCnt_SafeAssign(fImageFilterCache, cache);
+    return cache;
+}
+
 SkMetaData& SkCanvas::getMetaData() {
     // metadata users are rare, so we lazily allocate it. If that changes we
     // can decide to just make it a field in the device (rather than a ptr)
@@ -996,7 +1004,7 @@ void SkCanvas::internalDrawDevice(SkBaseDevice* srcDev, int x, int y,
         SkImageFilter* filter = paint->getImageFilter();
         SkIPoint pos = { x - iter.getX(), y - iter.getY() };
         if (filter && !dstDev->canHandleImageFilter(filter)) {
-            SkDeviceImageFilterProxy proxy(dstDev);
+            SkDeviceImageFilterProxy proxy(dstDev, fImageFilterCache);
             SkBitmap dst;
             const SkBitmap& src = srcDev->accessBitmap(false);
             SkMatrix matrix = *iter.fMatrix;
@@ -1034,7 +1042,7 @@ void SkCanvas::drawSprite(const SkBitmap& bitmap, int x, int y,
         SkImageFilter* filter = paint->getImageFilter();
         SkIPoint pos = { x - iter.getX(), y - iter.getY() };
         if (filter && !iter.fDevice->canHandleImageFilter(filter)) {
-            SkDeviceImageFilterProxy proxy(iter.fDevice);
+            SkDeviceImageFilterProxy proxy(iter.fDevice, fImageFilterCache);
             SkBitmap dst;
             SkMatrix matrix = *iter.fMatrix;
             matrix.postTranslate(SkIntToScalar(-x), SkIntToScalar(-y));
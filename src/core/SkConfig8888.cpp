@@ -1,4 +1,5 @@
 #include "SkConfig8888.h"
+#include "SkConvertRow.h"
 #include "SkMathPriv.h"
 #include "SkUnPreMultiply.h"
 
@@ -199,6 +200,30 @@ inline void convert_config8888(uint32_t* dstPixels,
     }
 }
 
+/**
+ * Unpremul -> native premul is what every writePixels of decoded data does,
+ * so it gets a row proc that may have a platform (SIMD) implementation.
+ * Returns NULL if there is none for this src config.
+ */
+inline SkConvertRow::Proc premul_to_native_row_proc(SkCanvas::Config8888 srcConfig) {
+    switch (srcConfig) {
+        case SkCanvas::kNative_Unpremul_Config8888:
+#if SK_PMCOLOR_BYTE_ORDER(R,G,B,A)
+            return SkConvertRow::Factory(SkConvertRow::kRGBA_SrcFormat);
+#elif SK_PMCOLOR_BYTE_ORDER(B,G,R,A)
+            return SkConvertRow::Factory(SkConvertRow::kBGRA_SrcFormat);
+#else
+            return NULL;
+#endif
+        case SkCanvas::kRGBA_Unpremul_Config8888:
+            return SkConvertRow::Factory(SkConvertRow::kRGBA_SrcFormat);
+        case SkCanvas::kBGRA_Unpremul_Config8888:
+            return SkConvertRow::Factory(SkConvertRow::kBGRA_SrcFormat);
+        default:
+            return NULL;
+    }
+}
+
 }
 
 void SkConvertConfig8888Pixels(uint32_t* dstPixels,
@@ -230,6 +255,21 @@ void SkConvertConfig8888Pixels(uint32_t* dstPixels,
             return;
         }
     }
+    // The row procs do not support converting in place.
+    if (SkCanvas::kNative_Premul_Config8888 == dstConfig && srcPixels != dstPixels) {
+        SkConvertRow::Proc proc = premul_to_native_row_proc(srcConfig);
+        if (NULL != proc) {
+            intptr_t srcPix = reinterpret_cast<intptr_t>(srcPixels);
+            intptr_t dstPix = reinterpret_cast<intptr_t>(dstPixels);
+            for (int y = 0; y < height; ++y) {
+                proc(reinterpret_cast<SkPMColor*>(dstPix),
+                     reinterpret_cast<const uint8_t*>(srcPix), width);
+                srcPix += srcRowBytes;
+                dstPix += dstRowBytes;
+            }
+            return;
+        }
+    }
     switch(srcConfig) {
         case SkCanvas::kNative_Premul_Config8888:
             convert_config8888<SkCanvas::kNative_Premul_Config8888>(dstPixels, dstRowBytes, dstConfig, srcPixels, srcRowBytes, width, height);
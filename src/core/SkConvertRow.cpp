@@ -0,0 +1,80 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkConvertRow.h"
+#include "SkColorPriv.h"
+
+static bool Gray_To_PMColor(SkPMColor* SK_RESTRICT dst,
+                            const uint8_t* SK_RESTRICT src, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = SkPackARGB32(0xFF, src[i], src[i], src[i]);
+    }
+    return false;
+}
+
+static bool RGB_To_PMColor(SkPMColor* SK_RESTRICT dst,
+                           const uint8_t* SK_RESTRICT src, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = SkPackARGB32(0xFF, src[0], src[1], src[2]);
+        src += 3;
+    }
+    return false;
+}
+
+static bool RGBX_To_PMColor(SkPMColor* SK_RESTRICT dst,
+                            const uint8_t* SK_RESTRICT src, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = SkPackARGB32(0xFF, src[0], src[1], src[2]);
+        src += 4;
+    }
+    return false;
+}
+
+static bool RGBA_To_PMColor(SkPMColor* SK_RESTRICT dst,
+                            const uint8_t* SK_RESTRICT src, int count) {
+    unsigned alphaMask = 0xFF;
+    for (int i = 0; i < count; i++) {
+        unsigned alpha = src[3];
+        dst[i] = SkPreMultiplyARGB(alpha, src[0], src[1], src[2]);
+        alphaMask &= alpha;
+        src += 4;
+    }
+    return alphaMask != 0xFF;
+}
+
+static bool BGRA_To_PMColor(SkPMColor* SK_RESTRICT dst,
+                            const uint8_t* SK_RESTRICT src, int count) {
+    unsigned alphaMask = 0xFF;
+    for (int i = 0; i < count; i++) {
+        unsigned alpha = src[3];
+        dst[i] = SkPreMultiplyARGB(alpha, src[2], src[1], src[0]);
+        alphaMask &= alpha;
+        src += 4;
+    }
+    return alphaMask != 0xFF;
+}
+
+static const SkConvertRow::Proc gDefault_Procs[] = {
+    Gray_To_PMColor,
+    RGB_To_PMColor,
+    RGBX_To_PMColor,
+    RGBA_To_PMColor,
+    BGRA_To_PMColor,
+};
+
+SkConvertRow::Proc SkConvertRow::Factory(SrcFormat format) {
+    SK_COMPILE_ASSERT(SK_ARRAY_COUNT(gDefault_Procs) == kSrcFormatCount,
+                      gDefault_Procs_has_the_wrong_number_of_entries);
+    SkASSERT((unsigned)format < kSrcFormatCount);
+
+    Proc proc = PlatformProcs(format);
+    if (NULL == proc) {
+        proc = gDefault_Procs[format];
+    }
+    SkASSERT(proc);
+    return proc;
+}
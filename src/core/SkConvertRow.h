@@ -0,0 +1,48 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkConvertRow_DEFINED
+#define SkConvertRow_DEFINED
+
+#include "SkColor.h"
+
+/** Row procs that expand tightly packed 8-bit-per-channel source pixels (as
+    produced by the image decoders, or handed to writePixels) into a row of
+    SkPMColors, premultiplying if the source carries alpha.
+ */
+class SkConvertRow {
+public:
+    enum SrcFormat {
+        kGray_SrcFormat,    //!< 1 byte per pixel, opaque
+        kRGB_SrcFormat,     //!< 3 bytes per pixel, R,G,B, opaque
+        kRGBX_SrcFormat,    //!< 4 bytes per pixel, R,G,B,(ignored)
+        kRGBA_SrcFormat,    //!< 4 bytes per pixel, R,G,B,A unpremultiplied
+        kBGRA_SrcFormat,    //!< 4 bytes per pixel, B,G,R,A unpremultiplied
+
+        kSrcFormatCount
+    };
+
+    /** Function pointer that reads count src pixels (bytes in the layout of
+        the SrcFormat passed to the Factory) and writes count SkPMColors.
+        dst and src may not overlap.
+
+        @return true if any of the src pixels had alpha != 0xFF
+     */
+    typedef bool (*Proc)(SkPMColor* SK_RESTRICT dst,
+                         const uint8_t* SK_RESTRICT src, int count);
+
+    //! Public entry-point to return a conversion function ptr (never NULL)
+    static Proc Factory(SrcFormat);
+
+    /** Called by Factory, this should return either NULL, or a
+        platform-specific function-ptr to be used in place of the
+        system default.
+     */
+    static Proc PlatformProcs(SrcFormat);
+};
+
+#endif
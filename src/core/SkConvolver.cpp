@@ -3,7 +3,9 @@
 // found in the LICENSE file.
 
 #include "SkConvolver.h"
+#include "SkRunnable.h"
 #include "SkSize.h"
+#include "SkThreadPool.h"
 #include "SkTypes.h"
 
 namespace {
@@ -330,15 +332,31 @@ const SkConvolutionFilter1D::ConvolutionFixed* SkConvolutionFilter1D::GetSingleF
     return &fFilterValues[filter.fDataLocation];
 }
 
-void BGRAConvolve2D(const unsigned char* sourceData,
-                    int sourceByteRowStride,
-                    bool sourceHasAlpha,
-                    const SkConvolutionFilter1D& filterX,
-                    const SkConvolutionFilter1D& filterY,
-                    int outputByteRowStride,
-                    unsigned char* output,
-                    const SkConvolutionProcs& convolveProcs,
-                    bool useSimdIfPossible) {
+namespace {
+
+// Everything that the convolution of a band of output rows needs to know.
+struct ConvolveParams {
+    const unsigned char* fSourceData;
+    int fSourceByteRowStride;
+    bool fSourceHasAlpha;
+    const SkConvolutionFilter1D* fFilterX;
+    const SkConvolutionFilter1D* fFilterY;
+    int fOutputByteRowStride;
+    unsigned char* fOutput;
+    const SkConvolutionProcs* fProcs;
+};
+
+// Produces output rows [firstOutY, endOutY). Only the rows of the source that
+// their vertical filters touch are convolved horizontally, into a circular
+// buffer that is private to the call, so bands of rows can be convolved
+// concurrently.
+void ConvolveRows(const ConvolveParams& params, int firstOutY, int endOutY) {
+    const unsigned char* sourceData = params.fSourceData;
+    int sourceByteRowStride = params.fSourceByteRowStride;
+    bool sourceHasAlpha = params.fSourceHasAlpha;
+    const SkConvolutionFilter1D& filterX = *params.fFilterX;
+    const SkConvolutionFilter1D& filterY = *params.fFilterY;
+    const SkConvolutionProcs& convolveProcs = *params.fProcs;
 
     int maxYFilterSize = filterY.maxFilter();
 
@@ -349,7 +367,7 @@ void BGRAConvolve2D(const unsigned char* sourceData,
     // row for convolution as the first pixel for the first vertical filter.
     int filterOffset, filterLength;
     const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
-        filterY.FilterForValue(0, &filterOffset, &filterLength);
+        filterY.FilterForValue(firstOutY, &filterOffset, &filterLength);
     int nextXRow = filterOffset;
 
     // We loop over each row in the input doing a horizontal convolution. This
@@ -369,11 +387,6 @@ void BGRAConvolve2D(const unsigned char* sourceData,
                                 rowBufferHeight,
                                 filterOffset);
 
-    // Loop over every possible output row, processing just enough horizontal
-    // convolutions to run each subsequent vertical convolution.
-    SkASSERT(outputByteRowStride >= filterX.numValues() * 4);
-    int numOutputRows = filterY.numValues();
-
     // We need to check which is the last line to convolve before we advance 4
     // lines in one iteration.
     int lastFilterOffset, lastFilterLength;
@@ -390,10 +403,14 @@ void BGRAConvolve2D(const unsigned char* sourceData,
     int avoidSimdRows = 1 + convolveProcs.fExtraHorizontalReads /
         (lastFilterOffset + lastFilterLength);
 
-    filterY.FilterForValue(numOutputRows - 1, &lastFilterOffset,
+    // This is the last row of the whole image, not of the band, so that every
+    // band makes the same choice between the SIMD and C++ code for a row.
+    filterY.FilterForValue(filterY.numValues() - 1, &lastFilterOffset,
                            &lastFilterLength);
 
-    for (int outY = 0; outY < numOutputRows; outY++) {
+    // Loop over every output row of the band, processing just enough horizontal
+    // convolutions to run each subsequent vertical convolution.
+    for (int outY = firstOutY; outY < endOutY; outY++) {
         filterValues = filterY.FilterForValue(outY,
                                               &filterOffset, &filterLength);
 
@@ -434,7 +451,7 @@ void BGRAConvolve2D(const unsigned char* sourceData,
         }
 
         // Compute where in the output image this row of final data will go.
-        unsigned char* curOutputRow = &output[outY * outputByteRowStride];
+        unsigned char* curOutputRow = &params.fOutput[outY * params.fOutputByteRowStride];
 
         // Get the list of rows that the circular buffer has, in order.
         int firstRowInCircularBuffer;
@@ -459,3 +476,68 @@ void BGRAConvolve2D(const unsigned char* sourceData,
         }
     }
 }
+
+class ConvolveBand : public SkRunnable {
+public:
+    ConvolveBand(const ConvolveParams& params, int firstOutY, int endOutY)
+        : fParams(params), fFirstOutY(firstOutY), fEndOutY(endOutY) {}
+
+    virtual void run() SK_OVERRIDE {
+        ConvolveRows(fParams, fFirstOutY, fEndOutY);
+    }
+
+private:
+    const ConvolveParams& fParams;
+    int fFirstOutY;
+    int fEndOutY;
+};
+
+}  // namespace
+
+void BGRAConvolve2D(const unsigned char* sourceData,
+                    int sourceByteRowStride,
+                    bool sourceHasAlpha,
+                    const SkConvolutionFilter1D& filterX,
+                    const SkConvolutionFilter1D& filterY,
+                    int outputByteRowStride,
+                    unsigned char* output,
+                    const SkConvolutionProcs& convolveProcs,
+                    bool useSimdIfPossible,
+                    int threadCount) {
+    SkASSERT(outputByteRowStride >= filterX.numValues() * 4);
+
+    ConvolveParams params;
+    params.fSourceData = sourceData;
+    params.fSourceByteRowStride = sourceByteRowStride;
+    params.fSourceHasAlpha = sourceHasAlpha;
+    params.fFilterX = &filterX;
+    params.fFilterY = &filterY;
+    params.fOutputByteRowStride = outputByteRowStride;
+    params.fOutput = output;
+    params.fProcs = &convolveProcs;
+
+    int numOutputRows = filterY.numValues();
+    if (0 == threadCount || 1 == threadCount || numOutputRows < 2) {
+        ConvolveRows(params, 0, numOutputRows);
+        return;
+    }
+
+    // Give each thread one band of rows. The rows that the vertical filters of
+    // neighboring bands share are convolved horizontally by both, so more bands
+    // than threads would only add work.
+    SkTDArray<ConvolveBand*> bands;
+    {
+        // The pool's destructor waits for all of the bands to finish.
+        SkThreadPool pool(threadCount);
+        int bandCount = SkTMin(SkTMax(pool.count(), 1), numOutputRows);
+        for (int i = 0; i < bandCount; i++) {
+            *bands.append() = SkNEW_ARGS(ConvolveBand,
+                                         (params, numOutputRows * i / bandCount,
+                                          numOutputRows * (i + 1) / bandCount));
+        }
+        for (int i = 0; i < bandCount; i++) {
+            pool.add(bands[i]);
+        }
+    }
+    bands.deleteAll();
+}
@@ -190,6 +190,10 @@ struct SkConvolutionProcs {
 //
 // The layout in memory is assumed to be 4-bytes per pixel in B-G-R-A order
 // (this is ARGB when loaded into 32-bit words on a little-endian machine).
+//
+// If |threadCount| is more than 1 (or SkThreadPool::kThreadPerCore), the
+// output rows are split into one band per thread, which are convolved
+// concurrently. The result is the same as on one thread.
 SK_API void BGRAConvolve2D(const unsigned char* sourceData,
     int sourceByteRowStride,
     bool sourceHasAlpha,
@@ -198,6 +202,7 @@ SK_API void BGRAConvolve2D(const unsigned char* sourceData,
     int outputByteRowStride,
     unsigned char* output,
     const SkConvolutionProcs&,
-    bool useSimdIfPossible);
+    bool useSimdIfPossible,
+    int threadCount = 0);
 
 #endif  // SK_CONVOLVER_H
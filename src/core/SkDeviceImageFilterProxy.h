@@ -12,7 +12,8 @@
 
 class SkDeviceImageFilterProxy : public SkImageFilter::Proxy {
 public:
-    SkDeviceImageFilterProxy(SkBaseDevice* device) : fDevice(device) {}
+    SkDeviceImageFilterProxy(SkBaseDevice* device, SkImageFilterCache* cache = NULL)
+        : fDevice(device), fCache(cache) {}
 
     virtual SkBaseDevice* createDevice(int w, int h) SK_OVERRIDE {
         return fDevice->createCompatibleDevice(SkBitmap::kARGB_8888_Config,
@@ -26,9 +27,13 @@ public:
                              SkBitmap* result, SkIPoint* offset) SK_OVERRIDE {
         return fDevice->filterImage(filter, src, ctm, result, offset);
     }
+    virtual SkImageFilterCache* cache() SK_OVERRIDE {
+        return fCache;
+    }
 
 private:
     SkBaseDevice* fDevice;
+    SkImageFilterCache* fCache;
 };
 
 #endif
@@ -18,6 +18,7 @@
 #include "SkPathEffect.h"
 #include "SkRasterClip.h"
 #include "SkRasterizer.h"
+#include "SkRRect.h"
 #include "SkScan.h"
 #include "SkShader.h"
 #include "SkString.h"
@@ -1022,6 +1023,33 @@ bool SkDrawTreatAsHairline(const SkPaint& paint, const SkMatrix& matrix,
     return false;
 }
 
+bool SkDraw::drawRRect(const SkRRect& rrect, const SkPaint& paint) const {
+    SkDEBUGCODE(this->validate();)
+
+    // nothing to draw
+    if (fRC->isEmpty()) {
+        return true;
+    }
+
+    // Only a blurred (or otherwise mask filtered) fill has a shortcut; it
+    // draws a nine-patch instead of filtering a mask of the whole rrect.
+    SkScalar coverage;
+    if (paint.getMaskFilter() && !paint.getPathEffect() && !paint.getRasterizer() &&
+            SkPaint::kFill_Style == paint.getStyle() &&
+            !SkDrawTreatAsHairline(paint, *fMatrix, &coverage)) {
+        SkRRect devRRect;
+        if (rrect.transform(*fMatrix, &devRRect)) {
+            SkAutoBlitterChoose blitter(*fBitmap, *fMatrix, paint);
+            if (paint.getMaskFilter()->filterRRect(devRRect, *fMatrix, *fRC,
+                                                   fBounder, blitter.get(),
+                                                   SkPaint::kFill_Style)) {
+                return true; // filterRRect() called the blitter, so we're done
+            }
+        }
+    }
+    return false;
+}
+
 void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
                       const SkMatrix* prePathMatrix, bool pathIsMutable) const {
     SkDEBUGCODE(this->validate();)
@@ -1088,7 +1116,10 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
     if (paint->getPathEffect() || paint->getStyle() != SkPaint::kFill_Style) {
         SkRect cullRect;
         const SkRect* cullRectPtr = NULL;
-        if (this->computeConservativeLocalClipBounds(&cullRect)) {
+        // mask filters and rasterizers can spread geometry that is outside
+        // of the clip into it, so nothing can be culled for them
+        if (NULL == paint->getMaskFilter() && NULL == paint->getRasterizer() &&
+                this->computeConservativeLocalClipBounds(&cullRect)) {
             cullRectPtr = &cullRect;
         }
         doFill = paint->getFillPath(*pathPtr, &tmpPath, cullRectPtr);
@@ -135,13 +135,20 @@ void SkGraphics::Term() {
 
 static const char kFontCacheLimitStr[] = "font-cache-limit";
 static const size_t kFontCacheLimitLen = sizeof(kFontCacheLimitStr) - 1;
+static const char kStrokeCacheLimitStr[] = "stroke-cache-limit";
+static const size_t kStrokeCacheLimitLen = sizeof(kStrokeCacheLimitStr) - 1;
+static const char kPathMeasureCacheLimitStr[] = "path-measure-cache-limit";
+static const size_t kPathMeasureCacheLimitLen = sizeof(kPathMeasureCacheLimitStr) - 1;
 
 static const struct {
     const char* fStr;
     size_t fLen;
     size_t (*fFunc)(size_t);
 } gFlags[] = {
-    { kFontCacheLimitStr, kFontCacheLimitLen, SkGraphics::SetFontCacheLimit }
+    { kFontCacheLimitStr, kFontCacheLimitLen, SkGraphics::SetFontCacheLimit },
+    { kStrokeCacheLimitStr, kStrokeCacheLimitLen, SkGraphics::SetStrokeCacheByteLimit },
+    { kPathMeasureCacheLimitStr, kPathMeasureCacheLimitLen,
+      SkGraphics::SetPathMeasureCacheByteLimit },
 };
 
 /* flags are of the form param; or param=value; */
@@ -9,7 +9,9 @@
 
 #include "SkBitmap.h"
 #include "SkFlattenableBuffers.h"
+#include "SkImageFilterCache.h"
 #include "SkRect.h"
+#include "SkThread.h"
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
 #include "GrTexture.h"
@@ -18,10 +20,22 @@
 
 SK_DEFINE_INST_COUNT(SkImageFilter)
 
+static uint32_t next_image_filter_unique_id() {
+    static int32_t gImageFilterUniqueID;
+
+    // Never return 0.
+    int32_t id;
+    do {
+        id = sk_atomic_inc(&gImageFilterUniqueID) + 1;
+    } while (0 == id);
+    return id;
+}
+
 SkImageFilter::SkImageFilter(int inputCount, SkImageFilter** inputs, const SkIRect* cropRect)
   : fInputCount(inputCount),
     fInputs(new SkImageFilter*[inputCount]),
-    fCropRect(cropRect ? *cropRect : SkIRect::MakeLargest()) {
+    fCropRect(cropRect ? *cropRect : SkIRect::MakeLargest()),
+    fUniqueID(next_image_filter_unique_id()) {
     for (int i = 0; i < inputCount; ++i) {
         fInputs[i] = inputs[i];
         SkSafeRef(fInputs[i]);
@@ -31,14 +45,16 @@ SkImageFilter::SkImageFilter(int inputCount, SkImageFilter** inputs, const SkIRe
 SkImageFilter::SkImageFilter(SkImageFilter* input, const SkIRect* cropRect)
   : fInputCount(1),
     fInputs(new SkImageFilter*[1]),
-    fCropRect(cropRect ? *cropRect : SkIRect::MakeLargest()) {
+    fCropRect(cropRect ? *cropRect : SkIRect::MakeLargest()),
+    fUniqueID(next_image_filter_unique_id()) {
     fInputs[0] = input;
     SkSafeRef(fInputs[0]);
 }
 
 SkImageFilter::SkImageFilter(SkImageFilter* input1, SkImageFilter* input2, const SkIRect* cropRect)
   : fInputCount(2), fInputs(new SkImageFilter*[2]),
-  fCropRect(cropRect ? *cropRect : SkIRect::MakeLargest()) {
+  fCropRect(cropRect ? *cropRect : SkIRect::MakeLargest()),
+  fUniqueID(next_image_filter_unique_id()) {
     fInputs[0] = input1;
     fInputs[1] = input2;
     SkSafeRef(fInputs[0]);
@@ -53,7 +69,8 @@ SkImageFilter::~SkImageFilter() {
 }
 
 SkImageFilter::SkImageFilter(SkFlattenableReadBuffer& buffer)
-    : fInputCount(buffer.readInt()), fInputs(new SkImageFilter*[fInputCount]) {
+    : fInputCount(buffer.readInt()), fInputs(new SkImageFilter*[fInputCount]),
+      fUniqueID(next_image_filter_unique_id()) {
     for (int i = 0; i < fInputCount; i++) {
         if (buffer.readBool()) {
             fInputs[i] = static_cast<SkImageFilter*>(buffer.readFlattenable());
@@ -81,12 +98,23 @@ bool SkImageFilter::filterImage(Proxy* proxy, const SkBitmap& src,
                                 SkBitmap* result, SkIPoint* loc) {
     SkASSERT(result);
     SkASSERT(loc);
+    SkImageFilterCache* cache = proxy ? proxy->cache() : NULL;
+    if (cache && cache->find(this, src, ctm, result, loc)) {
+        return true;
+    }
+    SkIPoint srcLoc = *loc;
     /*
      *  Give the proxy first shot at the filter. If it returns false, ask
      *  the filter to do it.
      */
-    return (proxy && proxy->filterImage(this, src, ctm, result, loc)) ||
-           this->onFilterImage(proxy, src, ctm, result, loc);
+    if (!(proxy && proxy->filterImage(this, src, ctm, result, loc)) &&
+        !this->onFilterImage(proxy, src, ctm, result, loc)) {
+        return false;
+    }
+    if (cache) {
+        cache->add(this, src, ctm, *result, *loc - srcLoc);
+    }
+    return true;
 }
 
 bool SkImageFilter::filterBounds(const SkIRect& src, const SkMatrix& ctm,
@@ -96,6 +124,12 @@ bool SkImageFilter::filterBounds(const SkIRect& src, const SkMatrix& ctm,
     return this->onFilterBounds(src, ctm, dst);
 }
 
+bool SkImageFilter::filterInputBounds(const SkIRect& dst, const SkMatrix& ctm,
+                                      SkIRect* src) {
+    SkASSERT(src);
+    return this->onFilterInputBounds(dst, ctm, src);
+}
+
 bool SkImageFilter::onFilterImage(Proxy*, const SkBitmap&, const SkMatrix&,
                                   SkBitmap*, SkIPoint*) {
     return false;
@@ -169,7 +203,43 @@ bool SkImageFilter::applyCropRect(SkIRect* rect, const SkMatrix& matrix) const {
 
 bool SkImageFilter::onFilterBounds(const SkIRect& src, const SkMatrix& ctm,
                                    SkIRect* dst) {
-    *dst = src;
+    SkIRect totalBounds = src;
+    for (int i = 0; i < fInputCount; ++i) {
+        SkImageFilter* input = this->getInput(i);
+        SkIRect r = src;
+        if (input && !input->filterBounds(src, ctm, &r)) {
+            return false;
+        }
+        if (0 == i) {
+            totalBounds = r;
+        } else {
+            totalBounds.join(r);
+        }
+    }
+    *dst = totalBounds;
+    return true;
+}
+
+bool SkImageFilter::onFilterInputBounds(const SkIRect&, const SkMatrix&, SkIRect*) {
+    return false;
+}
+
+bool SkImageFilter::inputsFilterInputBounds(const SkIRect& needed, const SkMatrix& ctm,
+                                            SkIRect* src) {
+    SkIRect totalBounds = needed;
+    for (int i = 0; i < fInputCount; ++i) {
+        SkImageFilter* input = this->getInput(i);
+        SkIRect r = needed;
+        if (input && !input->filterInputBounds(needed, ctm, &r)) {
+            return false;
+        }
+        if (0 == i) {
+            totalBounds = r;
+        } else {
+            totalBounds.join(r);
+        }
+    }
+    *src = totalBounds;
     return true;
 }
 
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkImageFilterCache.h"
+#include "SkChecksum.h"
+#include "SkImageFilter.h"
+#include "SkMatrix.h"
+#include "SkTLRUCache.h"
+
+SK_DEFINE_INST_COUNT(SkImageFilterCache)
+
+struct SkImageFilterCache::Key {
+    enum {
+        kFilterID,
+        kGenerationID,
+        kPixelRefOffsetLo,
+        kPixelRefOffsetHi,
+        kWidth,
+        kHeight,
+        kMatrix,
+        kCount = kMatrix + 9
+    };
+
+    /** Returns false if results for src cannot be cached. */
+    bool init(const SkImageFilter* filter, const SkBitmap& src, const SkMatrix& ctm) {
+        if (NULL == src.pixelRef()) {
+            return false;
+        }
+        uint64_t pixelRefOffset = src.pixelRefOffset();
+        fData[kFilterID] = filter->uniqueID();
+        fData[kGenerationID] = src.getGenerationID();
+        fData[kPixelRefOffsetLo] = static_cast<uint32_t>(pixelRefOffset);
+        fData[kPixelRefOffsetHi] = static_cast<uint32_t>(pixelRefOffset >> 32);
+        fData[kWidth] = src.width();
+        fData[kHeight] = src.height();
+        SK_COMPILE_ASSERT(sizeof(SkScalar) == sizeof(uint32_t), scalar_is_32_bits);
+        for (int i = 0; i < 9; ++i) {
+            SkScalar value = ctm[i];
+            memcpy(&fData[kMatrix + i], &value, sizeof(uint32_t));
+        }
+        fHash = SkChecksum::Compute(fData, sizeof(fData));
+        return true;
+    }
+
+    uint32_t hash() const { return fHash; }
+
+    bool operator==(const Key& other) const {
+        return fHash == other.fHash && 0 == memcmp(fData, other.fData, sizeof(fData));
+    }
+
+    uint32_t fData[kCount];
+    uint32_t fHash;
+};
+
+struct SkImageFilterCache::Value {
+    SkBitmap    fResult;
+    SkIPoint    fOffset;
+};
+
+class SkImageFilterCache::Cache : public SkTLRUCache<Key, Value> {
+public:
+    Cache(size_t byteLimit) : SkTLRUCache<Key, Value>(byteLimit) {}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkImageFilterCache::SkImageFilterCache(size_t byteLimit) {
+    fCache = SkNEW_ARGS(Cache, (byteLimit));
+}
+
+SkImageFilterCache::~SkImageFilterCache() {
+    SkDELETE(fCache);
+}
+
+bool SkImageFilterCache::find(const SkImageFilter* filter, const SkBitmap& src,
+                              const SkMatrix& ctm, SkBitmap* result, SkIPoint* offset) {
+    Key key;
+    if (!key.init(filter, src, ctm)) {
+        return false;
+    }
+
+    SkAutoMutexAcquire am(fMutex);
+    const Value* value = fCache->find(key);
+    if (NULL == value) {
+        return false;
+    }
+    *result = value->fResult;
+    offset->fX += value->fOffset.fX;
+    offset->fY += value->fOffset.fY;
+    return true;
+}
+
+void SkImageFilterCache::add(const SkImageFilter* filter, const SkBitmap& src,
+                             const SkMatrix& ctm, const SkBitmap& result,
+                             const SkIPoint& offset) {
+    Key key;
+    if (!key.init(filter, src, ctm) || NULL == result.pixelRef()) {
+        return;
+    }
+
+    SkAutoMutexAcquire am(fMutex);
+    Value* value = fCache->add(key, result.getSize());
+    if (value) {
+        value->fResult = result;
+        value->fOffset = offset;
+    }
+}
+
+void SkImageFilterCache::purgeAll() {
+    SkAutoMutexAcquire am(fMutex);
+    fCache->purgeAll();
+}
+
+void SkImageFilterCache::getStats(Stats* stats) const {
+    SkAutoMutexAcquire am(fMutex);
+    Cache::Stats cacheStats;
+    fCache->getStats(&cacheStats);
+    stats->fHits = cacheStats.fHits;
+    stats->fMisses = cacheStats.fMisses;
+    stats->fCount = cacheStats.fCount;
+    stats->fBytesUsed = cacheStats.fBytesUsed;
+}
+
+size_t SkImageFilterCache::getByteLimit() const {
+    SkAutoMutexAcquire am(fMutex);
+    return fCache->getByteLimit();
+}
+
+size_t SkImageFilterCache::setByteLimit(size_t newLimit) {
+    SkAutoMutexAcquire am(fMutex);
+    return fCache->setByteLimit(newLimit);
+}
@@ -266,12 +266,42 @@ bool SkMaskFilter::filterPath(const SkPath& devPath, const SkMatrix& matrix,
     return true;
 }
 
+bool SkMaskFilter::filterRRect(const SkRRect& devRRect, const SkMatrix& matrix,
+                               const SkRasterClip& clip, SkBounder* bounder,
+                               SkBlitter* blitter, SkPaint::Style style) const {
+    if (SkPaint::kFill_Style != style) {
+        return false;
+    }
+
+    NinePatch patch;
+    patch.fMask.fImage = NULL;
+    if (kTrue_FilterReturn != this->filterRRectToNine(devRRect, matrix,
+                                                      clip.getBounds(),
+                                                      &patch)) {
+        SkASSERT(NULL == patch.fMask.fImage);
+        return false;
+    }
+    // The center of the mask holds the (possibly empty) inside of the rrect.
+    const SkIPoint& center = patch.fCenter;
+    const bool fillCenter = 0xFF == *patch.fMask.getAddr8(center.fX, center.fY);
+    draw_nine(patch.fMask, patch.fOuterRect, center, fillCenter, clip,
+              bounder, blitter);
+    SkMask::FreeImage(patch.fMask.fImage);
+    return true;
+}
+
 SkMaskFilter::FilterReturn
 SkMaskFilter::filterRectsToNine(const SkRect[], int count, const SkMatrix&,
                                 const SkIRect& clipBounds, NinePatch*) const {
     return kUnimplemented_FilterReturn;
 }
 
+SkMaskFilter::FilterReturn
+SkMaskFilter::filterRRectToNine(const SkRRect&, const SkMatrix&,
+                                const SkIRect&, NinePatch*) const {
+    return kUnimplemented_FilterReturn;
+}
+
 #if SK_SUPPORT_GPU
 bool SkMaskFilter::asNewEffect(GrEffectRef** effect, GrTexture*) const {
     return false;
@@ -1217,12 +1217,41 @@ const SkMatrix::MapPtsProc SkMatrix::gMapPtsProcs[] = {
     SkMatrix::Persp_pts,    SkMatrix::Persp_pts
 };
 
+// The platform procs work on 4 points at a time; for fewer, the portable ones
+// are used.
+static const int kMinPlatformMapPtsCount = 4;
+
 void SkMatrix::mapPoints(SkPoint dst[], const SkPoint src[], int count) const {
     SkASSERT((dst && src && count > 0) || 0 == count);
     // no partial overlap
     SkASSERT(src == dst || SkAbs32((int32_t)(src - dst)) >= count);
 
-    this->getMapPtsProc()(*this, dst, src, count);
+    TypeMask mask = this->getType();
+    MapPtsProc proc = NULL;
+    if (count >= kMinPlatformMapPtsCount) {
+        proc = PlatformMapPtsProc(mask);
+    }
+    if (NULL == proc) {
+        proc = GetMapPtsProc(mask);
+    }
+    proc(*this, dst, src, count);
+}
+
+bool SkMatrix::mapPointsWithBounds(SkPoint dst[], const SkPoint src[], int count,
+                                   SkRect* bounds) const {
+    SkASSERT(bounds);
+    SkASSERT((dst && src && count > 0) || 0 == count);
+    // no partial overlap
+    SkASSERT(src == dst || SkAbs32((int32_t)(src - dst)) >= count);
+
+    if (count >= kMinPlatformMapPtsCount) {
+        MapPtsBoundsProc proc = PlatformMapPtsBoundsProc(this->getType());
+        if (proc) {
+            return proc(*this, dst, src, count, bounds);
+        }
+    }
+    this->mapPoints(dst, src, count);
+    return bounds->setBoundsCheck(dst, count);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1296,8 +1325,7 @@ bool SkMatrix::mapRect(SkRect* dst, const SkRect& src) const {
         SkPoint quad[4];
 
         src.toQuad(quad);
-        this->mapPoints(quad, quad, 4);
-        dst->set(quad, 4);
+        this->mapPointsWithBounds(quad, quad, 4, dst);
         return false;
     }
 }
@@ -9,32 +9,24 @@
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
 
-static void downsampleby2_proc32(SkBitmap* dst, int x, int y,
-                                 const SkBitmap& src) {
-    x <<= 1;
-    y <<= 1;
-    const SkPMColor* p = src.getAddr32(x, y);
-    const SkPMColor* baseP = p;
-    SkPMColor c, ag, rb;
-
-    c = *p; ag = (c >> 8) & 0xFF00FF; rb = c & 0xFF00FF;
-    if (x < src.width() - 1) {
-        p += 1;
+static void downsample_row32(void* dst, const void* src0, const void* src1,
+                             int count) {
+    SkPMColor* d = (SkPMColor*)dst;
+    const SkPMColor* p0 = (const SkPMColor*)src0;
+    const SkPMColor* p1 = (const SkPMColor*)src1;
+
+    for (int i = 0; i < count; ++i) {
+        SkPMColor c, ag, rb;
+
+        c = p0[0]; ag = (c >> 8) & 0xFF00FF; rb = c & 0xFF00FF;
+        c = p0[1]; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+        c = p1[0]; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+        c = p1[1]; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+
+        d[i] = ((rb >> 2) & 0xFF00FF) | ((ag << 6) & 0xFF00FF00);
+        p0 += 2;
+        p1 += 2;
     }
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-
-    p = baseP;
-    if (y < src.height() - 1) {
-        p += src.rowBytes() >> 2;
-    }
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-    if (x < src.width() - 1) {
-        p += 1;
-    }
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-
-    *dst->getAddr32(x >> 1, y >> 1) =
-    ((rb >> 2) & 0xFF00FF) | ((ag << 6) & 0xFF00FF00);
 }
 
 static inline uint32_t expand16(U16CPU c) {
@@ -47,31 +39,19 @@ static inline U16CPU pack16(uint32_t c) {
     return (c & ~SK_G16_MASK_IN_PLACE) | ((c >> 16) & SK_G16_MASK_IN_PLACE);
 }
 
-static void downsampleby2_proc16(SkBitmap* dst, int x, int y,
-                                 const SkBitmap& src) {
-    x <<= 1;
-    y <<= 1;
-    const uint16_t* p = src.getAddr16(x, y);
-    const uint16_t* baseP = p;
-    SkPMColor       c;
-
-    c = expand16(*p);
-    if (x < src.width() - 1) {
-        p += 1;
-    }
-    c += expand16(*p);
-
-    p = baseP;
-    if (y < src.height() - 1) {
-        p += src.rowBytes() >> 1;
-    }
-    c += expand16(*p);
-    if (x < src.width() - 1) {
-        p += 1;
+static void downsample_row16(void* dst, const void* src0, const void* src1,
+                             int count) {
+    uint16_t* d = (uint16_t*)dst;
+    const uint16_t* p0 = (const uint16_t*)src0;
+    const uint16_t* p1 = (const uint16_t*)src1;
+
+    for (int i = 0; i < count; ++i) {
+        uint32_t c = expand16(p0[0]) + expand16(p0[1]) +
+                     expand16(p1[0]) + expand16(p1[1]);
+        d[i] = (uint16_t)pack16(c >> 2);
+        p0 += 2;
+        p1 += 2;
     }
-    c += expand16(*p);
-
-    *dst->getAddr16(x >> 1, y >> 1) = (uint16_t)pack16(c >> 2);
 }
 
 static uint32_t expand4444(U16CPU c) {
@@ -82,31 +62,51 @@ static U16CPU collaps4444(uint32_t c) {
     return (c & 0xF0F) | ((c >> 12) & ~0xF0F);
 }
 
-static void downsampleby2_proc4444(SkBitmap* dst, int x, int y,
-                                   const SkBitmap& src) {
-    x <<= 1;
-    y <<= 1;
-    const uint16_t* p = src.getAddr16(x, y);
-    const uint16_t* baseP = p;
-    uint32_t        c;
-
-    c = expand4444(*p);
-    if (x < src.width() - 1) {
-        p += 1;
+static void downsample_row4444(void* dst, const void* src0, const void* src1,
+                               int count) {
+    uint16_t* d = (uint16_t*)dst;
+    const uint16_t* p0 = (const uint16_t*)src0;
+    const uint16_t* p1 = (const uint16_t*)src1;
+
+    for (int i = 0; i < count; ++i) {
+        uint32_t c = expand4444(p0[0]) + expand4444(p0[1]) +
+                     expand4444(p1[0]) + expand4444(p1[1]);
+        d[i] = (uint16_t)collaps4444(c >> 2);
+        p0 += 2;
+        p1 += 2;
     }
-    c += expand4444(*p);
+}
 
-    p = baseP;
-    if (y < src.height() - 1) {
-        p += src.rowBytes() >> 1;
+static SkMipMap::DownsampleProc choose_downsample_proc(SkBitmap::Config config) {
+    SkMipMap::DownsampleProc proc = SkMipMap::PlatformDownsampleProc(config);
+    if (proc) {
+        return proc;
     }
-    c += expand4444(*p);
-    if (x < src.width() - 1) {
-        p += 1;
+    switch (config) {
+        case SkBitmap::kARGB_8888_Config:
+            return downsample_row32;
+        case SkBitmap::kRGB_565_Config:
+            return downsample_row16;
+        case SkBitmap::kARGB_4444_Config:
+            return downsample_row4444;
+        case SkBitmap::kIndex8_Config:
+        case SkBitmap::kA8_Config:
+        default:
+            return NULL; // don't build mipmaps for these configs
     }
-    c += expand4444(*p);
+}
 
-    *dst->getAddr16(x >> 1, y >> 1) = (uint16_t)collaps4444(c >> 2);
+// Since a level is floor(half) the size of its source, every 2x2 block that
+// it averages lies entirely within the source.
+static void downsample(SkMipMap::DownsampleProc proc, const void* srcPixels,
+                       size_t srcRowBytes, const SkMipMap::Level& dst) {
+    const char* src = (const char*)srcPixels;
+    char* d = (char*)dst.fPixels;
+    for (uint32_t y = 0; y < dst.fHeight; ++y) {
+        proc(d, src, src + srcRowBytes, dst.fWidth);
+        src += 2 * srcRowBytes;
+        d += dst.fRowBytes;
+    }
 }
 
 static bool isPos32Bits(const Sk64& value) {
@@ -127,23 +127,10 @@ SkMipMap::Level* SkMipMap::AllocLevels(int levelCount, size_t pixelSize) {
 }
 
 SkMipMap* SkMipMap::Build(const SkBitmap& src) {
-    void (*proc)(SkBitmap* dst, int x, int y, const SkBitmap& src);
-
     const SkBitmap::Config config = src.getConfig();
-    switch (config) {
-        case SkBitmap::kARGB_8888_Config:
-            proc = downsampleby2_proc32;
-            break;
-        case SkBitmap::kRGB_565_Config:
-            proc = downsampleby2_proc16;
-            break;
-        case SkBitmap::kARGB_4444_Config:
-            proc = downsampleby2_proc4444;
-            break;
-        case SkBitmap::kIndex8_Config:
-        case SkBitmap::kA8_Config:
-        default:
-            return NULL; // don't build mipmaps for these configs
+    DownsampleProc proc = choose_downsample_proc(config);
+    if (NULL == proc) {
+        return NULL;
     }
 
     SkAutoLockPixels alp(src);
@@ -181,7 +168,6 @@ SkMipMap* SkMipMap::Build(const SkBitmap& src) {
     int         width = src.width();
     int         height = src.height();
     uint32_t    rowBytes;
-    SkBitmap    srcBM(src);
 
     for (int i = 0; i < countLevels; ++i) {
         width >>= 1;
@@ -194,32 +180,25 @@ SkMipMap* SkMipMap::Build(const SkBitmap& src) {
         levels[i].fRowBytes = rowBytes;
         levels[i].fScale    = (float)width / src.width();
 
-        SkBitmap dstBM;
-        dstBM.setConfig(config, width, height, rowBytes);
-        dstBM.setPixels(addr);
-
-        srcBM.lockPixels();
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                proc(&dstBM, x, y, srcBM);
-            }
-        }
-        srcBM.unlockPixels();
-
-        srcBM = dstBM;
         addr += height * rowBytes;
     }
     SkASSERT(addr == baseAddr + size);
 
-    return SkNEW_ARGS(SkMipMap, (levels, countLevels, size));
+    // We won't have the source later, so build the first level now. The
+    // others are built from it on demand.
+    downsample(proc, src.getPixels(), src.rowBytes(), levels[0]);
+
+    return SkNEW_ARGS(SkMipMap, (levels, countLevels, size, config));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 //static int gCounter;
 
-SkMipMap::SkMipMap(Level* levels, int count, size_t size)
-    : fSize(size), fLevels(levels), fCount(count) {
+SkMipMap::SkMipMap(Level* levels, int count, size_t size,
+                   SkBitmap::Config config)
+    : fSize(size), fLevels(levels), fCount(count), fConfig(config)
+    , fBuiltCount(1) {
     SkASSERT(levels);
     SkASSERT(count > 0);
 //    SkDebugf("mips %d\n", ++gCounter);
@@ -230,7 +209,7 @@ SkMipMap::~SkMipMap() {
 //    SkDebugf("mips %d\n", --gCounter);
 }
 
-static SkFixed compute_level(SkScalar scale) {
+SkFixed SkMipMap::ComputeLevel(SkScalar scale) {
     SkFixed s = SkAbs32(SkScalarToFixed(SkScalarInvert(scale)));
 
     if (s < SK_Fixed1) {
@@ -241,12 +220,35 @@ static SkFixed compute_level(SkScalar scale) {
     return SkIntToFixed(15 - clz) + ((unsigned)(s << (clz + 1)) >> 16);
 }
 
+bool SkMipMap::getLevel(int index, Level* levelPtr) const {
+    if (index < 1 || index > fCount) {
+        return false;
+    }
+
+    {
+        SkAutoMutexAcquire ama(fMutex);
+        if (fBuiltCount < index) {
+            DownsampleProc proc = choose_downsample_proc(fConfig);
+            for (int i = fBuiltCount; i < index; ++i) {
+                downsample(proc, fLevels[i - 1].fPixels,
+                           fLevels[i - 1].fRowBytes, fLevels[i]);
+            }
+            fBuiltCount = index;
+        }
+    }
+
+    if (levelPtr) {
+        *levelPtr = fLevels[index - 1];
+    }
+    return true;
+}
+
 bool SkMipMap::extractLevel(SkScalar scale, Level* levelPtr) const {
     if (scale >= SK_Scalar1) {
         return false;
     }
 
-    int level = compute_level(scale) >> 16;
+    int level = ComputeLevel(scale) >> 16;
     SkASSERT(level >= 0);
     if (level <= 0) {
         return false;
@@ -255,8 +257,5 @@ bool SkMipMap::extractLevel(SkScalar scale, Level* levelPtr) const {
     if (level > fCount) {
         level = fCount;
     }
-    if (levelPtr) {
-        *levelPtr = fLevels[level - 1];
-    }
-    return true;
+    return this->getLevel(level, levelPtr);
 }
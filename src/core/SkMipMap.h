@@ -8,10 +8,10 @@
 #ifndef SkMipMap_DEFINED
 #define SkMipMap_DEFINED
 
+#include "SkBitmap.h"
 #include "SkRefCnt.h"
 #include "SkScalar.h"
-
-class SkBitmap;
+#include "SkThread.h"
 
 class SkMipMap : public SkRefCnt {
 public:
@@ -26,15 +26,53 @@ public:
 
     bool extractLevel(SkScalar scale, Level*) const;
 
+    /**
+     *  Return which level to draw with at the given scale, in 16.16: the
+     *  integer part is the level index (0 being the source bitmap), and the
+     *  fraction how far the scale is towards the next smaller level.
+     */
+    static SkFixed ComputeLevel(SkScalar scale);
+
+    int countLevels() const { return fCount; }
+
+    /**
+     *  Return level index, for 1 <= index <= countLevels(). Only the first
+     *  level is built by Build(); the others are built from it the first time
+     *  they (or a smaller level) are asked for.
+     */
+    bool getLevel(int index, Level*) const;
+
+    /**
+     *  The memory for all of the levels is allocated up front, so this is
+     *  the size of the whole chain whether or not it has been built yet.
+     */
     size_t getSize() const { return fSize; }
 
+    /**
+     *  Average each 2x2 block of pixels in the rows src0 and src1 (which hold
+     *  2 * count pixels each) into one of the count pixels of dst.
+     */
+    typedef void (*DownsampleProc)(void* dst, const void* src0,
+                                   const void* src1, int count);
+
+    /**
+     *  Return a platform specific DownsampleProc for the config, or NULL if
+     *  the portable one should be used. It must match the portable results
+     *  exactly.
+     */
+    static DownsampleProc PlatformDownsampleProc(SkBitmap::Config);
+
 private:
-    size_t  fSize;
-    Level*  fLevels;
-    int     fCount;
+    size_t              fSize;
+    Level*              fLevels;
+    int                 fCount;
+    SkBitmap::Config    fConfig;
+
+    mutable SkMutex     fMutex;
+    mutable int         fBuiltCount;    // guarded by fMutex
 
     // we take ownership of levels, and will free it with sk_free()
-    SkMipMap(Level* levels, int count, size_t size);
+    SkMipMap(Level* levels, int count, size_t size, SkBitmap::Config);
     virtual ~SkMipMap();
 
     static Level* AllocLevels(int levelCount, size_t pixelSize);
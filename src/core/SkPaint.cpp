@@ -2230,11 +2230,11 @@ bool SkPaint::getFillPath(const SkPath& src, SkPath* dst,
     const SkPath* srcPtr = &src;
     SkPath tmpPath;
 
-    if (fPathEffect && fPathEffect->filterPath(&tmpPath, src, &rec, cullRect)) {
+    if (fPathEffect && fPathEffect->filterAndStrokePath(&tmpPath, src, &rec, cullRect)) {
         srcPtr = &tmpPath;
     }
 
-    if (!rec.applyToPath(dst, *srcPtr)) {
+    if (!rec.applyToPath(dst, *srcPtr, cullRect)) {
         if (srcPtr == &tmpPath) {
             // If path's were copy-on-write, this trick would not be needed.
             // As it is, we want to save making a deep-copy from tmpPath -> dst
@@ -1689,12 +1689,14 @@ void SkPath::transform(const SkMatrix& matrix, SkPath* dst) const {
          *  Here we also want to optimize bounds, by noting if the bounds are
          *  already known, and if so, we just transform those as well and mark
          *  them as "known", rather than force the transformed path to have to
-         *  recompute them.
+         *  recompute them. Otherwise we find the new bounds as the points are
+         *  transformed, which is cheaper than another pass over them later.
          *
          *  Special gotchas if the path is effectively empty (<= 1 point) or
          *  if it is non-finite. In those cases bounds need to stay empty,
          *  regardless of the matrix.
          */
+        SkRect* bounds = NULL;
         if (!fBoundsIsDirty && matrix.rectStaysRect() && fPathRef->countPoints() > 1) {
             dst->fBoundsIsDirty = false;
             if (fIsFinite) {
@@ -1708,10 +1710,19 @@ void SkPath::transform(const SkMatrix& matrix, SkPath* dst) const {
             }
         } else {
             GEN_ID_PTR_INC(dst);
-            dst->fBoundsIsDirty = true;
+            if (fPathRef->countPoints() > 1) {
+                bounds = &dst->fBounds;
+            } else {
+                dst->fBoundsIsDirty = true;
+            }
         }
 
-        SkPathRef::CreateTransformedCopy(&dst->fPathRef, *fPathRef.get(), matrix);
+        bool isFinite = SkPathRef::CreateTransformedCopy(&dst->fPathRef, *fPathRef.get(),
+                                                         matrix, bounds);
+        if (bounds) {
+            dst->fBoundsIsDirty = false;
+            dst->fIsFinite = isFinite;
+        }
 
         if (this != dst) {
             dst->fFillType = fFillType;
@@ -18,6 +18,11 @@ void SkPathEffect::computeFastBounds(SkRect* dst, const SkRect& src) const {
     *dst = src;
 }
 
+bool SkPathEffect::filterAndStrokePath(SkPath* dst, const SkPath& src,
+                                       SkStrokeRec* rec, const SkRect* cullR) const {
+    return this->filterPath(dst, src, rec, cullR);
+}
+
 bool SkPathEffect::asPoints(PointData* results, const SkPath& src,
                     const SkStrokeRec&, const SkMatrix&, const SkRect*) const {
     return false;
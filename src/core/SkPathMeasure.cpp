@@ -10,8 +10,11 @@
 #include "SkPathMeasure.h"
 #include "SkGeometry.h"
 #include "SkPath.h"
+#include "SkPathMeasureCache.h"
 #include "SkTSearch.h"
 
+typedef SkPathMeasureTable::Segment Segment;
+
 // these must be 0,1,2 since they are in our 2-bit field
 enum {
     kLine_SegType,
@@ -21,29 +24,6 @@ enum {
 
 #define kMaxTValue  32767
 
-static inline SkScalar tValue2Scalar(int t) {
-    SkASSERT((unsigned)t <= kMaxTValue);
-
-#ifdef SK_SCALAR_IS_FLOAT
-    return t * 3.05185e-5f; // t / 32767
-#else
-    return (t + (t >> 14)) << 1;
-#endif
-}
-
-SkScalar SkPathMeasure::Segment::getScalarT() const {
-    return tValue2Scalar(fTValue);
-}
-
-const SkPathMeasure::Segment* SkPathMeasure::NextSegment(const Segment* seg) {
-    unsigned ptIndex = seg->fPtIndex;
-
-    do {
-        ++seg;
-    } while (seg->fPtIndex == ptIndex);
-    return seg;
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 
 static inline int tspan_big_enough(int tspan) {
@@ -56,81 +36,160 @@ static inline int tspan_big_enough(int tspan) {
 // so we compare midpoints
 #define CHEAP_DIST_LIMIT    (SK_Scalar1/2)  // just made this value up
 
-static bool quad_too_curvy(const SkPoint pts[3]) {
-    // diff = (a/4 + b/2 + c/4) - (a/2 + c/2)
-    // diff = -a/4 + b/2 - c/4
-    SkScalar dx = SkScalarHalf(pts[1].fX) -
-                        SkScalarHalf(SkScalarHalf(pts[0].fX + pts[2].fX));
-    SkScalar dy = SkScalarHalf(pts[1].fY) -
-                        SkScalarHalf(SkScalarHalf(pts[0].fY + pts[2].fY));
-
-    SkScalar dist = SkMaxScalar(SkScalarAbs(dx), SkScalarAbs(dy));
-    return dist > CHEAP_DIST_LIMIT;
+// Curves are measured by splitting them in half until each piece is flat
+// enough (or its tspan is too small to split), and adding up the lengths of
+// the pieces' chords. A quad piece is too curvy if its control point strays
+// from the midpoint of its chord, and a cubic if either control point strays
+// from its place a third of the way along the chord.
+//
+// Rather than chopping the curves to find each piece's control points, we
+// track the differences between them that these tests look at, which are
+// simple multiples of the curve's higher derivatives (see quad_deviation() and
+// cubic_deviation()), and only evaluate the curve at the ends of the pieces
+// that are kept.
+
+static inline SkVector scaled(const SkVector& v, SkScalar scale) {
+    return SkVector::Make(SkScalarMul(v.fX, scale), SkScalarMul(v.fY, scale));
 }
 
-static bool cheap_dist_exceeds_limit(const SkPoint& pt,
-                                     SkScalar x, SkScalar y) {
-    SkScalar dist = SkMaxScalar(SkScalarAbs(x - pt.fX), SkScalarAbs(y - pt.fY));
-    // just made up the 1/2
-    return dist > CHEAP_DIST_LIMIT;
+static bool exceeds_limit(const SkVector& v) {
+    return SkMaxScalar(SkScalarAbs(v.fX), SkScalarAbs(v.fY)) > CHEAP_DIST_LIMIT;
 }
 
-static bool cubic_too_curvy(const SkPoint pts[4]) {
-    return  cheap_dist_exceeds_limit(pts[1],
-                         SkScalarInterp(pts[0].fX, pts[3].fX, SK_Scalar1/3),
-                         SkScalarInterp(pts[0].fY, pts[3].fY, SK_Scalar1/3))
-                         ||
-            cheap_dist_exceeds_limit(pts[2],
-                         SkScalarInterp(pts[0].fX, pts[3].fX, SK_Scalar1*2/3),
-                         SkScalarInterp(pts[0].fY, pts[3].fY, SK_Scalar1*2/3));
-}
-
-SkScalar SkPathMeasure::compute_quad_segs(const SkPoint pts[3],
-                          SkScalar distance, int mint, int maxt, int ptIndex) {
-    if (tspan_big_enough(maxt - mint) && quad_too_curvy(pts)) {
-        SkPoint tmp[5];
-        int     halft = (mint + maxt) >> 1;
-
-        SkChopQuadAtHalf(pts, tmp);
-        distance = this->compute_quad_segs(tmp, distance, mint, halft, ptIndex);
-        distance = this->compute_quad_segs(&tmp[2], distance, halft, maxt, ptIndex);
-    } else {
-        SkScalar d = SkPoint::Distance(pts[0], pts[2]);
-        SkScalar prevD = distance;
-        distance += d;
-        if (distance > prevD) {
-            Segment* seg = fSegments.append();
-            seg->fDistance = distance;
-            seg->fPtIndex = ptIndex;
-            seg->fType = kQuad_SegType;
+// Appends the segments for one curve, and adds up their lengths.
+class CurveSegmenter {
+public:
+    CurveSegmenter(SkTDArray<Segment>* segments, int segType, int ptIndex,
+                   const SkPoint& start, SkScalar distance)
+        : fSegments(segments), fPrev(start), fDistance(distance),
+          fType(segType), fPtIndex(ptIndex) {}
+
+    SkScalar distance() const { return fDistance; }
+
+    // Add the piece of the curve that ends at pt (at maxt).
+    void addPiece(const SkPoint& pt, int maxt) {
+        SkScalar prevD = fDistance;
+        fDistance += SkPoint::Distance(fPrev, pt);
+        if (fDistance > prevD) {
+            Segment* seg = fSegments->append();
+            seg->fDistance = fDistance;
+            seg->fPtIndex = fPtIndex;
+            seg->fType = fType;
             seg->fTValue = maxt;
         }
+        fPrev = pt;
+    }
+
+private:
+    SkTDArray<Segment>* fSegments;
+    SkPoint             fPrev;
+    SkScalar            fDistance;
+    int                 fType;
+    int                 fPtIndex;
+};
+
+// Quad(t) = (A*t + B)*t + C. The control point's deviation from the middle
+// of the chord is A/4 for the whole quad, and a quarter of its parent's for
+// each half.
+struct QuadPieces {
+    SkPoint         fPts[3];
+    SkVector        fA, fB;
+    CurveSegmenter* fSegmenter;
+
+    SkPoint evalAt(SkScalar t) const {
+        if (SK_Scalar1 == t) {
+            return fPts[2];
+        }
+        return SkPoint::Make(SkScalarMul(SkScalarMul(fA.fX, t) + fB.fX, t) + fPts[0].fX,
+                             SkScalarMul(SkScalarMul(fA.fY, t) + fB.fY, t) + fPts[0].fY);
+    }
+
+    void split(int mint, int maxt, SkScalar stopT, SkScalar halfSpan,
+               const SkVector& deviation) {
+        if (tspan_big_enough(maxt - mint) && exceeds_limit(deviation)) {
+            int         halft = (mint + maxt) >> 1;
+            SkScalar    quarterSpan = SkScalarHalf(halfSpan);
+            SkVector    childDeviation = scaled(deviation, SK_Scalar1 / 4);
+            this->split(mint, halft, stopT - halfSpan, quarterSpan, childDeviation);
+            this->split(halft, maxt, stopT, quarterSpan, childDeviation);
+        } else {
+            fSegmenter->addPiece(this->evalAt(stopT), maxt);
+        }
     }
-    return distance;
+};
+
+SkScalar SkPathMeasure::compute_quad_segs(const SkPoint pts[3],
+                                          SkScalar distance, int ptIndex) {
+    QuadPieces quad;
+    memcpy(quad.fPts, pts, sizeof(quad.fPts));
+    quad.fA.set(pts[0].fX - 2 * pts[1].fX + pts[2].fX,
+                pts[0].fY - 2 * pts[1].fY + pts[2].fY);
+    quad.fB.set(2 * (pts[1].fX - pts[0].fX), 2 * (pts[1].fY - pts[0].fY));
+
+    CurveSegmenter segmenter(&fTable->fSegments, kQuad_SegType, ptIndex, pts[0], distance);
+    quad.fSegmenter = &segmenter;
+
+    quad.split(0, kMaxTValue, SK_Scalar1, SK_ScalarHalf, scaled(quad.fA, SK_Scalar1 / 4));
+    return segmenter.distance();
 }
 
-SkScalar SkPathMeasure::compute_cubic_segs(const SkPoint pts[4],
-                           SkScalar distance, int mint, int maxt, int ptIndex) {
-    if (tspan_big_enough(maxt - mint) && cubic_too_curvy(pts)) {
-        SkPoint tmp[7];
-        int     halft = (mint + maxt) >> 1;
-
-        SkChopCubicAtHalf(pts, tmp);
-        distance = this->compute_cubic_segs(tmp, distance, mint, halft, ptIndex);
-        distance = this->compute_cubic_segs(&tmp[3], distance, halft, maxt, ptIndex);
-    } else {
-        SkScalar d = SkPoint::Distance(pts[0], pts[3]);
-        SkScalar prevD = distance;
-        distance += d;
-        if (distance > prevD) {
-            Segment* seg = fSegments.append();
-            seg->fDistance = distance;
-            seg->fPtIndex = ptIndex;
-            seg->fType = kCubic_SegType;
-            seg->fTValue = maxt;
+// With the cubic's differences D1 = p1 - p0, D2 = p2 - 2*p1 + p0 and
+// D3 = p3 - 3*p2 + 3*p1 - p0, Cubic(t) = p0 + 3*D1*t + 3*D2*t^2 + D3*t^3, and
+// the control points deviate from their places on the chord by D2 + D3/3 and
+// D2 + 2*D3/3. Halving the t range maps D2 to D2/4 (first half) or
+// (D2 + D3/2)/4 (second half), and D3 to D3/8.
+struct CubicPieces {
+    SkPoint         fPts[4];
+    SkVector        fA, fB, fC;
+    CurveSegmenter* fSegmenter;
+
+    SkPoint evalAt(SkScalar t) const {
+        if (SK_Scalar1 == t) {
+            return fPts[3];
+        }
+        return SkPoint::Make(
+            SkScalarMul(SkScalarMul(SkScalarMul(fA.fX, t) + fB.fX, t) + fC.fX, t) + fPts[0].fX,
+            SkScalarMul(SkScalarMul(SkScalarMul(fA.fY, t) + fB.fY, t) + fC.fY, t) + fPts[0].fY);
+    }
+
+    static bool TooCurvy(const SkVector& d2, const SkVector& d3) {
+        SkVector third = scaled(d3, SK_Scalar1 / 3);
+        return exceeds_limit(d2 + third) || exceeds_limit(d2 + third + third);
+    }
+
+    void split(int mint, int maxt, SkScalar stopT, SkScalar halfSpan,
+               const SkVector& d2, const SkVector& d3) {
+        if (tspan_big_enough(maxt - mint) && TooCurvy(d2, d3)) {
+            int         halft = (mint + maxt) >> 1;
+            SkScalar    quarterSpan = SkScalarHalf(halfSpan);
+            SkVector    childD3 = scaled(d3, SK_Scalar1 / 8);
+            this->split(mint, halft, stopT - halfSpan, quarterSpan,
+                        scaled(d2, SK_Scalar1 / 4), childD3);
+            this->split(halft, maxt, stopT, quarterSpan,
+                        scaled(d2 + scaled(d3, SK_ScalarHalf), SK_Scalar1 / 4), childD3);
+        } else {
+            fSegmenter->addPiece(this->evalAt(stopT), maxt);
         }
     }
-    return distance;
+};
+
+SkScalar SkPathMeasure::compute_cubic_segs(const SkPoint pts[4],
+                                           SkScalar distance, int ptIndex) {
+    SkVector d1 = pts[1] - pts[0];
+    SkVector d2 = pts[2] - pts[1] - d1;
+    SkVector d3 = pts[3] - pts[0] + scaled(pts[1] - pts[2], 3);
+
+    CubicPieces cubic;
+    memcpy(cubic.fPts, pts, sizeof(cubic.fPts));
+    cubic.fA = d3;
+    cubic.fB = scaled(d2, 3);
+    cubic.fC = scaled(d1, 3);
+
+    CurveSegmenter segmenter(&fTable->fSegments, kCubic_SegType, ptIndex, pts[0], distance);
+    cubic.fSegmenter = &segmenter;
+
+    cubic.split(0, kMaxTValue, SK_Scalar1, SK_ScalarHalf, d2, d3);
+    return segmenter.distance();
 }
 
 void SkPathMeasure::buildSegments() {
@@ -141,6 +200,10 @@ void SkPathMeasure::buildSegments() {
     bool            firstMoveTo = ptIndex < 0;
     Segment*        seg;
 
+    SkTDArray<Segment>& segments = fTable->fSegments;
+    SkTDArray<SkPoint>& points = fTable->fPts;
+    const int       firstSegment = segments.count();
+
     /*  Note:
      *  as we accumulate distance, we have to check that the result of +=
      *  actually made it larger, since a very small delta might be > 0, but
@@ -148,7 +211,6 @@ void SkPathMeasure::buildSegments() {
      *
      *  We do this check below, and in compute_quad_segs and compute_cubic_segs
      */
-    fSegments.reset();
     bool done = false;
     do {
         switch (fIter.next(pts)) {
@@ -157,7 +219,7 @@ void SkPathMeasure::buildSegments() {
                 break;
             case SkPath::kMove_Verb:
                 ptIndex += 1;
-                fPts.append(1, pts);
+                points.append(1, pts);
                 if (!firstMoveTo) {
                     done = true;
                     break;
@@ -171,32 +233,30 @@ void SkPathMeasure::buildSegments() {
                 SkScalar prevD = distance;
                 distance += d;
                 if (distance > prevD) {
-                    seg = fSegments.append();
+                    seg = segments.append();
                     seg->fDistance = distance;
                     seg->fPtIndex = ptIndex;
                     seg->fType = kLine_SegType;
                     seg->fTValue = kMaxTValue;
-                    fPts.append(1, pts + 1);
+                    points.append(1, pts + 1);
                     ptIndex++;
                 }
             } break;
 
             case SkPath::kQuad_Verb: {
                 SkScalar prevD = distance;
-                distance = this->compute_quad_segs(pts, distance, 0,
-                                                   kMaxTValue, ptIndex);
+                distance = this->compute_quad_segs(pts, distance, ptIndex);
                 if (distance > prevD) {
-                    fPts.append(2, pts + 1);
+                    points.append(2, pts + 1);
                     ptIndex += 2;
                 }
             } break;
 
             case SkPath::kCubic_Verb: {
                 SkScalar prevD = distance;
-                distance = this->compute_cubic_segs(pts, distance, 0,
-                                                    kMaxTValue, ptIndex);
+                distance = this->compute_cubic_segs(pts, distance, ptIndex);
                 if (distance > prevD) {
-                    fPts.append(3, pts + 1);
+                    points.append(3, pts + 1);
                     ptIndex += 3;
                 }
             } break;
@@ -211,14 +271,17 @@ void SkPathMeasure::buildSegments() {
         }
     } while (!done);
 
-    fLength = distance;
-    fIsClosed = isClosed;
+    SkPathMeasureTable::Contour* contour = fTable->fContours.append();
+    contour->fFirstSegment = firstSegment;
+    contour->fSegmentCount = segments.count() - firstSegment;
+    contour->fLength = distance;
+    contour->fIsClosed = isClosed;
     fFirstPtIndex = ptIndex;
 
 #ifdef SK_DEBUG
     {
-        const Segment* seg = fSegments.begin();
-        const Segment* stop = fSegments.end();
+        const Segment* seg = segments.begin() + firstSegment;
+        const Segment* stop = segments.end();
         unsigned        ptIndex = 0;
         SkScalar        distance = 0;
 
@@ -243,6 +306,15 @@ void SkPathMeasure::buildSegments() {
 #endif
 }
 
+// Measure every contour that nextContour() can reach, so that the table can be
+// cached.
+void SkPathMeasure::buildAllSegments() {
+    do {
+        this->buildSegments();
+    } while (fTable->fContours.top().fLength > 0);
+    fTable->fComplete = true;
+}
+
 static void compute_pos_tan(const SkPoint pts[], int segType,
                             SkScalar t, SkPoint* pos, SkVector* tangent) {
     switch (segType) {
@@ -341,22 +413,18 @@ static void seg_to(const SkPoint pts[], int segType,
 ////////////////////////////////////////////////////////////////////////////////
 
 SkPathMeasure::SkPathMeasure() {
-    fPath = NULL;
-    fLength = -1;   // signal we need to compute it
-    fForceClosed = false;
-    fFirstPtIndex = -1;
+    fTable = NULL;
+    this->setPath(NULL, false);
 }
 
 SkPathMeasure::SkPathMeasure(const SkPath& path, bool forceClosed) {
-    fPath = &path;
-    fLength = -1;   // signal we need to compute it
-    fForceClosed = forceClosed;
-    fFirstPtIndex = -1;
-
-    fIter.setPath(path, forceClosed);
+    fTable = NULL;
+    this->setPath(&path, forceClosed);
 }
 
-SkPathMeasure::~SkPathMeasure() {}
+SkPathMeasure::~SkPathMeasure() {
+    SkSafeUnref(fTable);
+}
 
 /** Assign a new path, or null to have none.
 */
@@ -365,12 +433,29 @@ void SkPathMeasure::setPath(const SkPath* path, bool forceClosed) {
     fLength = -1;   // signal we need to compute it
     fForceClosed = forceClosed;
     fFirstPtIndex = -1;
-
-    if (path) {
-        fIter.setPath(*path, forceClosed);
+    fContour = -1;
+    fIsClosed = false;
+    fFirstSegment = 0;
+    fSegmentCount = 0;
+
+    SkSafeUnref(fTable);
+    fTable = NULL;
+    if (NULL == path) {
+        return;
+    }
+    fIter.setPath(*path, forceClosed);
+
+    if (SkPathMeasureCache::GetByteLimit() > 0) {
+        SkPathMeasureCache::Key key(*path, forceClosed);
+        fTable = SkPathMeasureCache::Find(key);
+        if (NULL == fTable) {
+            fTable = SkNEW(SkPathMeasureTable);
+            this->buildAllSegments();
+            SkPathMeasureCache::Add(key, fTable);
+        }
+    } else {
+        fTable = SkNEW(SkPathMeasureTable);
     }
-    fSegments.reset();
-    fPts.reset();
 }
 
 SkScalar SkPathMeasure::getLength() {
@@ -378,26 +463,35 @@ SkScalar SkPathMeasure::getLength() {
         return 0;
     }
     if (fLength < 0) {
-        this->buildSegments();
+        fContour += 1;
+        if (fContour == fTable->fContours.count() && !fTable->fComplete) {
+            this->buildSegments();
+        }
+        if (fContour < fTable->fContours.count()) {
+            const SkPathMeasureTable::Contour& contour = fTable->fContours[fContour];
+            fLength = contour.fLength;
+            fIsClosed = contour.fIsClosed;
+            fFirstSegment = contour.fFirstSegment;
+            fSegmentCount = contour.fSegmentCount;
+        } else {
+            // a complete table ends with the first empty contour
+            fContour = fTable->fContours.count();
+            fLength = 0;
+            fIsClosed = fForceClosed;
+            fFirstSegment = fTable->fSegments.count();
+            fSegmentCount = 0;
+        }
     }
     SkASSERT(fLength >= 0);
     return fLength;
 }
 
-const SkPathMeasure::Segment* SkPathMeasure::distanceToSegment(
-                                            SkScalar distance, SkScalar* t) {
-    SkDEBUGCODE(SkScalar length = ) this->getLength();
-    SkASSERT(distance >= 0 && distance <= length);
-
-    const Segment*  seg = fSegments.begin();
-    int             count = fSegments.count();
-
-    int index = SkTSearch<SkScalar>(&seg->fDistance, count, distance, sizeof(Segment));
-    // don't care if we hit an exact match or not, so we xor index if it is negative
-    index ^= (index >> 31);
-    seg = &seg[index];
+// Return the t value on seg (at index in segs) that distance falls at, by
+// interpolating between it and the previous segment, if that is on the same
+// curve.
+static SkScalar segment_t(const Segment segs[], int index, SkScalar distance) {
+    const Segment* seg = &segs[index];
 
-    // now interpolate t-values with the prev segment (if possible)
     SkScalar    startT = 0, startD = 0;
     // check if the prev segment is legal, and references the same set of points
     if (index > 0) {
@@ -412,10 +506,24 @@ const SkPathMeasure::Segment* SkPathMeasure::distanceToSegment(
     SkASSERT(distance >= startD);
     SkASSERT(seg->fDistance > startD);
 
-    *t = startT + SkScalarMulDiv(seg->getScalarT() - startT,
-                                 distance - startD,
-                                 seg->fDistance - startD);
-    return seg;
+    return startT + SkScalarMulDiv(seg->getScalarT() - startT,
+                                   distance - startD,
+                                   seg->fDistance - startD);
+}
+
+// Returns the index of the segment (relative to the current contour).
+int SkPathMeasure::distanceToSegment(SkScalar distance, SkScalar* t) {
+    SkDEBUGCODE(SkScalar length = ) this->getLength();
+    SkASSERT(distance >= 0 && distance <= length);
+
+    const Segment*  segs = fTable->fSegments.begin() + fFirstSegment;
+
+    int index = SkTSearch<SkScalar>(&segs->fDistance, fSegmentCount, distance, sizeof(Segment));
+    // don't care if we hit an exact match or not, so we xor index if it is negative
+    index ^= (index >> 31);
+
+    *t = segment_t(segs, index, distance);
+    return index;
 }
 
 bool SkPathMeasure::getPosTan(SkScalar distance, SkPoint* pos,
@@ -425,9 +533,8 @@ bool SkPathMeasure::getPosTan(SkScalar distance, SkPoint* pos,
     }
 
     SkScalar    length = this->getLength(); // call this to force computing it
-    int         count = fSegments.count();
 
-    if (count == 0 || length == 0) {
+    if (fSegmentCount == 0 || length == 0) {
         return false;
     }
 
@@ -439,9 +546,56 @@ bool SkPathMeasure::getPosTan(SkScalar distance, SkPoint* pos,
     }
 
     SkScalar        t;
-    const Segment*  seg = this->distanceToSegment(distance, &t);
+    const Segment*  seg = &fTable->fSegments[fFirstSegment + this->distanceToSegment(distance, &t)];
+
+    compute_pos_tan(&fTable->fPts[seg->fPtIndex], seg->fType, t, pos, tangent);
+    return true;
+}
+
+bool SkPathMeasure::getPosTan(const SkScalar distances[], int count,
+                              SkPoint positions[], SkVector tangents[]) {
+    if (NULL == fPath) {
+        return false;
+    }
+
+    SkScalar    length = this->getLength(); // call this to force computing it
+
+    if (fSegmentCount == 0 || length == 0) {
+        return false;
+    }
+
+    const Segment*  segs = fTable->fSegments.begin() + fFirstSegment;
+    const SkPoint*  pts = fTable->fPts.begin();
+    const int       lastIndex = fSegmentCount - 1;
+    SkScalar        prevDistance = 0;
+    int             index = 0;
+
+    for (int i = 0; i < count; ++i) {
+        // pin the distance to a legal range
+        SkScalar distance = distances[i];
+        if (distance < 0) {
+            distance = 0;
+        } else if (distance > length) {
+            distance = length;
+        }
 
-    compute_pos_tan(&fPts[seg->fPtIndex], seg->fType, t, pos, tangent);
+        if (distance < prevDistance) {
+            // going backwards: search for it as getPosTan(distance) does
+            index = SkTSearch<SkScalar>(&segs->fDistance, fSegmentCount, distance,
+                                        sizeof(Segment));
+            index ^= (index >> 31);
+        } else {
+            // the first segment that ends at or after distance
+            while (index < lastIndex && segs[index].fDistance < distance) {
+                ++index;
+            }
+        }
+        prevDistance = distance;
+
+        const Segment* seg = &segs[index];
+        compute_pos_tan(&pts[seg->fPtIndex], seg->fType, segment_t(segs, index, distance),
+                        positions ? &positions[i] : NULL, tangents ? &tangents[i] : NULL);
+    }
     return true;
 }
 
@@ -486,26 +640,29 @@ bool SkPathMeasure::getSegment(SkScalar startD, SkScalar stopD, SkPath* dst,
         return false;
     }
 
+    const Segment*  segs = fTable->fSegments.begin() + fFirstSegment;
+    const SkPoint*  pts = fTable->fPts.begin();
+
     SkPoint  p;
     SkScalar startT, stopT;
-    const Segment* seg = this->distanceToSegment(startD, &startT);
-    const Segment* stopSeg = this->distanceToSegment(stopD, &stopT);
+    const Segment* seg = &segs[this->distanceToSegment(startD, &startT)];
+    const Segment* stopSeg = &segs[this->distanceToSegment(stopD, &stopT)];
     SkASSERT(seg <= stopSeg);
 
     if (startWithMoveTo) {
-        compute_pos_tan(&fPts[seg->fPtIndex], seg->fType, startT, &p, NULL);
+        compute_pos_tan(&pts[seg->fPtIndex], seg->fType, startT, &p, NULL);
         dst->moveTo(p);
     }
 
     if (seg->fPtIndex == stopSeg->fPtIndex) {
-        seg_to(&fPts[seg->fPtIndex], seg->fType, startT, stopT, dst);
+        seg_to(&pts[seg->fPtIndex], seg->fType, startT, stopT, dst);
     } else {
         do {
-            seg_to(&fPts[seg->fPtIndex], seg->fType, startT, SK_Scalar1, dst);
-            seg = SkPathMeasure::NextSegment(seg);
+            seg_to(&pts[seg->fPtIndex], seg->fType, startT, SK_Scalar1, dst);
+            seg = SkPathMeasureTable::NextSegment(seg);
             startT = 0;
         } while (seg->fPtIndex < stopSeg->fPtIndex);
-        seg_to(&fPts[seg->fPtIndex], seg->fType, 0, stopT, dst);
+        seg_to(&pts[seg->fPtIndex], seg->fType, 0, stopT, dst);
     }
     return true;
 }
@@ -529,10 +686,10 @@ bool SkPathMeasure::nextContour() {
 #ifdef SK_DEBUG
 
 void SkPathMeasure::dump() {
-    SkDebugf("pathmeas: length=%g, segs=%d\n", fLength, fSegments.count());
+    SkDebugf("pathmeas: length=%g, segs=%d\n", fLength, fSegmentCount);
 
-    for (int i = 0; i < fSegments.count(); i++) {
-        const Segment* seg = &fSegments[i];
+    for (int i = 0; i < fSegmentCount; i++) {
+        const Segment* seg = &fTable->fSegments[fFirstSegment + i];
         SkDebugf("pathmeas: seg[%d] distance=%g, point=%d, t=%g, type=%d\n",
                 i, seg->fDistance, seg->fPtIndex, seg->getScalarT(),
                  seg->fType);
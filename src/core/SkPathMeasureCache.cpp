@@ -0,0 +1,132 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPathMeasureCache.h"
+#include "SkBuffer.h"
+#include "SkChecksum.h"
+#include "SkPathRef.h"
+
+SK_DEFINE_INST_COUNT(SkPathMeasureTable)
+
+// Off unless the client asks for it, as most paths are only measured once.
+#ifndef SK_DEFAULT_PATH_MEASURE_CACHE_LIMIT
+    #define SK_DEFAULT_PATH_MEASURE_CACHE_LIMIT     0
+#endif
+
+#define kMaxTValue  32767
+
+static inline SkScalar tValue2Scalar(int t) {
+    SkASSERT((unsigned)t <= kMaxTValue);
+
+#ifdef SK_SCALAR_IS_FLOAT
+    return t * 3.05185e-5f; // t / 32767
+#else
+    return (t + (t >> 14)) << 1;
+#endif
+}
+
+SkScalar SkPathMeasureTable::Segment::getScalarT() const {
+    return tValue2Scalar(fTValue);
+}
+
+const SkPathMeasureTable::Segment* SkPathMeasureTable::NextSegment(const Segment* seg) {
+    unsigned ptIndex = seg->fPtIndex;
+
+    do {
+        ++seg;
+    } while (seg->fPtIndex == ptIndex);
+    return seg;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkPathMeasureCache::Key::Key(const SkPath& path, bool forceClosed) {
+    fPathID = path.fPathRef->genID();
+    fForceClosed = forceClosed;
+    fHash = SkChecksum::Compute(reinterpret_cast<const uint32_t*>(this),
+                                SK_OFFSETOF(Key, fHash));
+}
+
+SkPathMeasureTable* SkPathMeasureCache::find(const Key& key) {
+    const SkAutoTUnref<SkPathMeasureTable>* table = fCache.find(key);
+    return table ? SkRef(table->get()) : NULL;
+}
+
+void SkPathMeasureCache::add(const Key& key, SkPathMeasureTable* table) {
+    SkASSERT(table->fComplete);
+    SkAutoTUnref<SkPathMeasureTable>* value = fCache.add(key, table->bytesUsed());
+    if (value) {
+        value->reset(SkRef(table));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SkThread.h"
+
+SK_DECLARE_STATIC_MUTEX(gMutex);
+
+static SkPathMeasureCache* get_cache() {
+    static SkPathMeasureCache* gCache;
+    if (!gCache) {
+        gCache = SkNEW_ARGS(SkPathMeasureCache, (SK_DEFAULT_PATH_MEASURE_CACHE_LIMIT));
+    }
+    return gCache;
+}
+
+SkPathMeasureTable* SkPathMeasureCache::Find(const Key& key) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->find(key);
+}
+
+void SkPathMeasureCache::Add(const Key& key, SkPathMeasureTable* table) {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->add(key, table);
+}
+
+void SkPathMeasureCache::GetStats(Stats* stats) {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->getStats(stats);
+}
+
+void SkPathMeasureCache::ResetStats() {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->resetStats();
+}
+
+void SkPathMeasureCache::PurgeAll() {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->purgeAll();
+}
+
+size_t SkPathMeasureCache::GetByteLimit() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getByteLimit();
+}
+
+size_t SkPathMeasureCache::SetByteLimit(size_t newLimit) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->setByteLimit(newLimit);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SkGraphics.h"
+
+size_t SkGraphics::GetPathMeasureCacheBytesUsed() {
+    SkPathMeasureCache::Stats stats;
+    SkPathMeasureCache::GetStats(&stats);
+    return stats.fBytesUsed;
+}
+
+size_t SkGraphics::GetPathMeasureCacheByteLimit() {
+    return SkPathMeasureCache::GetByteLimit();
+}
+
+size_t SkGraphics::SetPathMeasureCacheByteLimit(size_t newLimit) {
+    return SkPathMeasureCache::SetByteLimit(newLimit);
+}
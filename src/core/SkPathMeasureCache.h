@@ -0,0 +1,139 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPathMeasureCache_DEFINED
+#define SkPathMeasureCache_DEFINED
+
+#include "SkPath.h"
+#include "SkRefCnt.h"
+#include "SkTDArray.h"
+#include "SkTLRUCache.h"
+
+/**
+ *  The segments that SkPathMeasure breaks the contours of a path into, with
+ *  their running lengths, in the order that nextContour() visits them.
+ *
+ *  A table is built a contour at a time by the SkPathMeasure that owns it,
+ *  unless it is complete: then it holds every contour that nextContour() can
+ *  reach, is never changed again, and may be shared through
+ *  SkPathMeasureCache.
+ */
+class SkPathMeasureTable : public SkRefCnt {
+public:
+    SK_DECLARE_INST_COUNT(SkPathMeasureTable)
+
+    SkPathMeasureTable() : fComplete(false) {}
+
+    struct Segment {
+        SkScalar    fDistance;  // total distance up to this point
+        unsigned    fPtIndex : 15; // index into the fPts array
+        unsigned    fTValue : 15;
+        unsigned    fType : 2;
+
+        SkScalar getScalarT() const;
+    };
+
+    struct Contour {
+        int         fFirstSegment;  // index into the fSegments array
+        int         fSegmentCount;
+        SkScalar    fLength;
+        bool        fIsClosed;
+    };
+
+    static const Segment* NextSegment(const Segment*);
+
+    size_t bytesUsed() const {
+        return sizeof(SkPathMeasureTable) + fSegments.count() * sizeof(Segment) +
+               fPts.count() * sizeof(SkPoint) + fContours.count() * sizeof(Contour);
+    }
+
+    SkTDArray<Segment>  fSegments;
+    SkTDArray<SkPoint>  fPts;   // Points used to define the segments
+    SkTDArray<Contour>  fContours;
+    bool                fComplete;
+
+private:
+    typedef SkRefCnt INHERITED;
+};
+
+/**
+ *  Cache of complete SkPathMeasureTables, so that measuring the same path
+ *  again (e.g. to place the labels along a road on every frame) does not
+ *  subdivide its curves and add up its lengths again.
+ *
+ *  Entries are keyed by the generation ID of the path's SkPathRef, which
+ *  changes whenever the points or verbs are edited, and forceClosed. The
+ *  cached tables are shared with the measures that use them.
+ *
+ *  The global cache has a limit of 0 by default, which disables it: clients
+ *  that measure the same paths again turn it on with
+ *  SkGraphics::SetPathMeasureCacheByteLimit().
+ */
+class SkPathMeasureCache {
+public:
+    class Key {
+    public:
+        Key(const SkPath& path, bool forceClosed);
+
+        uint32_t hash() const { return fHash; }
+
+        bool operator==(const Key& other) const {
+            return 0 == memcmp(this, &other, sizeof(Key));
+        }
+
+    private:
+        int32_t     fPathID;
+        uint32_t    fForceClosed;
+        uint32_t    fHash;
+    };
+
+    typedef SkTLRUCache<Key, SkAutoTUnref<SkPathMeasureTable> >::Stats Stats;
+
+    /*
+     *  The following static methods are thread-safe wrappers around a global
+     *  instance of this cache.
+     */
+
+    static SkPathMeasureTable* Find(const Key&);
+    static void Add(const Key&, SkPathMeasureTable*);
+
+    static void GetStats(Stats*);
+    static void ResetStats();
+    static void PurgeAll();
+
+    static size_t GetByteLimit();
+    static size_t SetByteLimit(size_t newLimit);
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    SkPathMeasureCache(size_t byteLimit) : fCache(byteLimit) {}
+
+    /**
+     *  Search the cache for key. If it is found, return its table with its
+     *  reference count incremented (the caller must unref it). Otherwise
+     *  return NULL.
+     */
+    SkPathMeasureTable* find(const Key&);
+
+    /**
+     *  Add table, which must be complete, to the cache. The cache takes its
+     *  own reference to it.
+     */
+    void add(const Key&, SkPathMeasureTable*);
+
+    void getStats(Stats* stats) const { fCache.getStats(stats); }
+    void resetStats() { fCache.resetStats(); }
+    void purgeAll() { fCache.purgeAll(); }
+
+    size_t getByteLimit() const { return fCache.getByteLimit(); }
+    size_t setByteLimit(size_t newLimit) { return fCache.setByteLimit(newLimit); }
+
+private:
+    SkTLRUCache<Key, SkAutoTUnref<SkPathMeasureTable> > fCache;
+};
+
+#endif
@@ -130,10 +130,14 @@ public:
 
     /**
      * Transforms a path ref by a matrix, allocating a new one only if necessary.
+     * If bounds is not null, it is set to the bounds of the transformed points
+     * (found as they are transformed), and the return value is whether those
+     * points are all finite, as with SkRect::setBoundsCheck().
      */
-    static void CreateTransformedCopy(SkAutoTUnref<SkPathRef>* dst,
+    static bool CreateTransformedCopy(SkAutoTUnref<SkPathRef>* dst,
                                       const SkPathRef& src,
-                                      const SkMatrix& matrix) {
+                                      const SkMatrix& matrix,
+                                      SkRect* bounds = NULL) {
         src.validate();
         if (matrix.isIdentity()) {
             if (*dst != &src) {
@@ -141,20 +145,23 @@ public:
                 dst->reset(const_cast<SkPathRef*>(&src));
                 (*dst)->validate();
             }
-            return;
+            return bounds ? bounds->setBoundsCheck(src.points(), src.fPointCnt) : true;
         }
         bool dstUnique = (*dst)->unique();
         if (&src == *dst && dstUnique) {
-            matrix.mapPoints((*dst)->fPoints, (*dst)->fPointCnt);
-            return;
+            // The points move without an Editor, so the ID has to be reset here.
+            (*dst)->fGenerationID = 0;
+            return MapPoints(matrix, (*dst)->fPoints, (*dst)->fPoints, (*dst)->fPointCnt,
+                             bounds);
         } else if (!dstUnique) {
             dst->reset(SkNEW(SkPathRef));
         }
         (*dst)->resetToSize(src.fVerbCnt, src.fPointCnt, src.fConicWeights.count());
         memcpy((*dst)->verbsMemWritable(), src.verbsMemBegin(), src.fVerbCnt * sizeof(uint8_t));
-        matrix.mapPoints((*dst)->fPoints, src.points(), src.fPointCnt);
+        bool isFinite = MapPoints(matrix, (*dst)->fPoints, src.points(), src.fPointCnt, bounds);
         (*dst)->fConicWeights = src.fConicWeights;
         (*dst)->validate();
+        return isFinite;
     }
 
     static SkPathRef* CreateFromBuffer(SkRBuffer* buffer) {
@@ -317,6 +324,29 @@ public:
                fConicWeights.bytes();
     }
 
+    /**
+     * Gets an ID that uniquely identifies the contents of the path ref. If two path refs have the
+     * same ID then they have the same verbs and points. However, two path refs may have the same
+     * contents but different genIDs. Zero is reserved and means an ID has not yet been determined
+     * for the path ref.
+     */
+    int32_t genID() const {
+        SkASSERT(!fEditorsAttached);
+        if (!fGenerationID) {
+            if (0 == fPointCnt && 0 == fVerbCnt) {
+                fGenerationID = kEmptyGenID;
+            } else {
+                static int32_t  gPathRefGenerationID;
+                // do a loop in case our global wraps around, as we never want to return a 0 or the
+                // empty ID
+                do {
+                    fGenerationID = sk_atomic_inc(&gPathRefGenerationID) + 1;
+                } while (fGenerationID <= kEmptyGenID);
+            }
+        }
+        return fGenerationID;
+    }
+
 private:
     SkPathRef() {
         fPointCnt = 0;
@@ -342,6 +372,16 @@ private:
         this->validate();
     }
 
+    /** Maps the points for CreateTransformedCopy(), finding their bounds too if asked */
+    static bool MapPoints(const SkMatrix& matrix, SkPoint dst[], const SkPoint src[], int count,
+                          SkRect* bounds) {
+        if (bounds) {
+            return matrix.mapPointsWithBounds(dst, src, count, bounds);
+        }
+        matrix.mapPoints(dst, src, count);
+        return true;
+    }
+
     /** Makes additional room but does not change the counts or change the genID */
     void incReserve(int additionalVerbs, int additionalPoints) {
         this->validate();
@@ -491,29 +531,6 @@ private:
         return reinterpret_cast<intptr_t>(fVerbs) - reinterpret_cast<intptr_t>(fPoints);
     }
 
-    /**
-     * Gets an ID that uniquely identifies the contents of the path ref. If two path refs have the
-     * same ID then they have the same verbs and points. However, two path refs may have the same
-     * contents but different genIDs. Zero is reserved and means an ID has not yet been determined
-     * for the path ref.
-     */
-    int32_t genID() const {
-        SkASSERT(!fEditorsAttached);
-        if (!fGenerationID) {
-            if (0 == fPointCnt && 0 == fVerbCnt) {
-                fGenerationID = kEmptyGenID;
-            } else {
-                static int32_t  gPathRefGenerationID;
-                // do a loop in case our global wraps around, as we never want to return a 0 or the
-                // empty ID
-                do {
-                    fGenerationID = sk_atomic_inc(&gPathRefGenerationID) + 1;
-                } while (fGenerationID <= kEmptyGenID);
-            }
-        }
-        return fGenerationID;
-    }
-
     void validate() const {
         SkASSERT(static_cast<ptrdiff_t>(fFreeSpace) >= 0);
         SkASSERT(reinterpret_cast<intptr_t>(fVerbs) - reinterpret_cast<intptr_t>(fPoints) >= 0);
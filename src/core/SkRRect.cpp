@@ -6,6 +6,7 @@
  */
 
 #include "SkRRect.h"
+#include "SkMatrix.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -278,6 +279,34 @@ void SkRRect::inset(SkScalar dx, SkScalar dy, SkRRect* dst) const {
     dst->setRectRadii(r, radii);
 }
 
+bool SkRRect::transform(const SkMatrix& matrix, SkRRect* dst) const {
+    if (matrix.getType() & ~(SkMatrix::kScale_Mask | SkMatrix::kTranslate_Mask)) {
+        return false;
+    }
+
+    SkRect r;
+    matrix.mapRect(&r, fRect);
+
+    const SkScalar sx = matrix.getScaleX();
+    const SkScalar sy = matrix.getScaleY();
+    SkVector radii[4];
+    for (int i = 0; i < 4; ++i) {
+        radii[i].set(SkScalarMul(fRadii[i].fX, SkScalarAbs(sx)),
+                     SkScalarMul(fRadii[i].fY, SkScalarAbs(sy)));
+    }
+    // A negative scale flips the rect, and so which corner is which.
+    if (sx < 0) {
+        SkTSwap(radii[kUpperLeft_Corner], radii[kUpperRight_Corner]);
+        SkTSwap(radii[kLowerLeft_Corner], radii[kLowerRight_Corner]);
+    }
+    if (sy < 0) {
+        SkTSwap(radii[kUpperLeft_Corner], radii[kLowerLeft_Corner]);
+        SkTSwap(radii[kUpperRight_Corner], radii[kLowerRight_Corner]);
+    }
+    dst->setRectRadii(r, radii);
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 uint32_t SkRRect::writeToMemory(void* buffer) const {
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkResampleCache.h"
+
+#ifndef SK_DEFAULT_RESAMPLE_CACHE_LIMIT
+    #define SK_DEFAULT_RESAMPLE_CACHE_LIMIT   (1024 * 1024)
+#endif
+
+SkRefCnt* SkResampleCache::find(const Key& key) {
+    const SkAutoTUnref<SkRefCnt>* value = fCache.find(key);
+    return value ? SkRef(value->get()) : NULL;
+}
+
+void SkResampleCache::add(const Key& key, SkRefCnt* value, size_t bytes) {
+    SkAutoTUnref<SkRefCnt>* slot = fCache.add(key, key.size() + bytes);
+    if (slot) {
+        slot->reset(SkRef(value));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SkThread.h"
+
+SK_DECLARE_STATIC_MUTEX(gMutex);
+
+static SkResampleCache* get_cache() {
+    static SkResampleCache* gCache;
+    if (!gCache) {
+        gCache = SkNEW_ARGS(SkResampleCache, (SK_DEFAULT_RESAMPLE_CACHE_LIMIT));
+    }
+    return gCache;
+}
+
+SkRefCnt* SkResampleCache::Find(const Key& key) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->find(key);
+}
+
+void SkResampleCache::Add(const Key& key, SkRefCnt* value, size_t bytes) {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->add(key, value, bytes);
+}
+
+void SkResampleCache::GetStats(Stats* stats) {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->getStats(stats);
+}
+
+void SkResampleCache::ResetStats() {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->resetStats();
+}
+
+void SkResampleCache::PurgeAll() {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->purgeAll();
+}
+
+size_t SkResampleCache::GetByteLimit() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getByteLimit();
+}
+
+size_t SkResampleCache::SetByteLimit(size_t newLimit) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->setByteLimit(newLimit);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkResampleCache_DEFINED
+#define SkResampleCache_DEFINED
+
+#include "SkRefCnt.h"
+#include "SkTLRUCache.h"
+
+/**
+ *  Cache of the filter weights that high quality resampling computes: the convolution
+ *  filters of SkBitmapScaler, the kernel tables of SkBitmapFilter and the per axis plans of
+ *  SkBicubicImageFilter. These depend only on the filter and the source and destination
+ *  sizes, which repeat constantly when the same images (e.g. icons) are drawn at the same
+ *  scale, so a hit skips all of the weight computation.
+ *
+ *  Values are ref counted objects, whose type is determined by the Kind of their key. The
+ *  cache holds a ref on each value, and gives one out to each caller that finds it, so
+ *  values must not be changed once they are added.
+ */
+class SkResampleCache {
+public:
+    class Key : public SkLRUCacheKey {
+    public:
+        enum Kind {
+            kConvolutionFilter_Kind,    //!< SkBitmapScaler's SkConvolutionFilter1D
+            kBitmapFilter_Kind,         //!< SkBitmapFilter, with its tables computed
+            kBicubicPlan_Kind,          //!< SkBicubicImageFilter's taps along one axis
+        };
+
+        explicit Key(Kind kind) { this->write32(kind); }
+    };
+
+    typedef SkTLRUCache<Key, SkAutoTUnref<SkRefCnt> >::Stats Stats;
+
+    /*
+     *  The following static methods are thread-safe wrappers around a global
+     *  instance of this cache.
+     */
+
+    static SkRefCnt* Find(const Key&);
+    static void Add(const Key&, SkRefCnt* value, size_t bytes);
+
+    static void GetStats(Stats*);
+    static void ResetStats();
+    static void PurgeAll();
+
+    static size_t GetByteLimit();
+    static size_t SetByteLimit(size_t newLimit);
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    SkResampleCache(size_t byteLimit) : fCache(byteLimit) {}
+
+    /**
+     *  Search the cache for key. If it is found, return its value with a ref that the caller
+     *  must balance with unref(). Otherwise return NULL.
+     */
+    SkRefCnt* find(const Key&);
+
+    /**
+     *  Add value to the cache, which takes a ref on it. bytes is the memory that the value
+     *  uses, which counts against the cache's limit.
+     */
+    void add(const Key&, SkRefCnt* value, size_t bytes);
+
+    void getStats(Stats* stats) const { fCache.getStats(stats); }
+    void resetStats() { fCache.resetStats(); }
+    void purgeAll() { fCache.purgeAll(); }
+
+    size_t getByteLimit() const { return fCache.getByteLimit(); }
+    size_t setByteLimit(size_t newLimit) { return fCache.setByteLimit(newLimit); }
+
+private:
+    SkTLRUCache<Key, SkAutoTUnref<SkRefCnt> > fCache;
+};
+
+#endif
@@ -6,8 +6,11 @@
  */
 
 #include "SkStrokerPriv.h"
+#include "SkBuffer.h"
 #include "SkGeometry.h"
 #include "SkPath.h"
+#include "SkPathRef.h"
+#include "SkStrokeCache.h"
 
 #define kMaxQuadSubdivide   5
 #define kMaxCubicSubdivide  7
@@ -468,6 +471,182 @@ void SkPathStroker::cubicTo(const SkPoint& pt1, const SkPoint& pt2,
     this->postJoinTo(pt3, normalCD, unitCD);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+/*  Strokes paths that only have lines, with the same results as SkPathStroker.
+    Each contour's points are collected first, so that the unit normals of all
+    of its lines can be computed in one batch (with SIMD where available), and
+    the outline is built in SkStrokeBuffers, which are copied into the result
+    once at the end, instead of growing SkPaths a point at a time.
+*/
+class SkPolylineStroker {
+public:
+    SkPolylineStroker(const SkPath& src,
+                      SkScalar radius, SkScalar miterLimit, SkPaint::Cap cap,
+                      SkPaint::Join join);
+
+    void moveTo(const SkPoint&);
+    void lineTo(const SkPoint& pt) { *fContour.append() = pt; }
+    void close(bool isLine) { this->finishContour(true, isLine); }
+
+    void done(SkPath* dst, bool isLine);
+
+private:
+    SkScalar    fRadius;
+    SkScalar    fInvMiterLimit;
+
+    SkStrokerPriv::BufferCapProc    fCapper;
+    SkStrokerPriv::BufferJoinProc   fJoiner;
+    SkStrokerPriv::UnitNormalsProc  fUnitNormals;
+
+    SkTDArray<SkPoint>  fContour;       // the points of the current contour
+    SkTDArray<SkVector> fContourUnitNormals;
+
+    SkStrokeBuffer  fInner, fOuter; // outer is our working answer, inner is temp
+
+    void    finishContour(bool close, bool isLine);
+};
+
+SkPolylineStroker::SkPolylineStroker(const SkPath& src,
+                                     SkScalar radius, SkScalar miterLimit,
+                                     SkPaint::Cap cap, SkPaint::Join join)
+        : fRadius(radius) {
+    fInvMiterLimit = 0;
+
+    if (join == SkPaint::kMiter_Join) {
+        if (miterLimit <= SK_Scalar1) {
+            join = SkPaint::kBevel_Join;
+        } else {
+            fInvMiterLimit = SkScalarInvert(miterLimit);
+        }
+    }
+    fCapper = SkStrokerPriv::BufferCapFactory(cap);
+    fJoiner = SkStrokerPriv::BufferJoinFactory(join);
+    fUnitNormals = SkStrokerPriv::PlatformUnitNormalsProc();
+    if (NULL == fUnitNormals) {
+        fUnitNormals = SkStrokerPriv::UnitNormals;
+    }
+
+    // same estimates as SkPathStroker
+    fOuter.incReserve(src.countPoints() * 3);
+    fInner.incReserve(src.countPoints());
+}
+
+void SkPolylineStroker::moveTo(const SkPoint& pt) {
+    if (fContour.count() > 1) {
+        this->finishContour(false, false);
+    }
+    fContour.rewind();
+    *fContour.append() = pt;
+}
+
+// The same steps as SkPathStroker's moveTo(), lineTo()s and finishContour().
+void SkPolylineStroker::finishContour(bool close, bool currIsLine) {
+    const SkPoint* pts = fContour.begin();
+    const int count = fContour.count() - 1;
+    if (count <= 0) {
+        fContour.rewind();
+        return;
+    }
+
+    fContourUnitNormals.setCount(count);
+    const SkVector* unitNormals = fContourUnitNormals.begin();
+    fUnitNormals(pts, count, fContourUnitNormals.begin());
+
+    SkVector    normal, unitNormal;
+    SkVector    firstNormal, prevNormal, firstUnitNormal, prevUnitNormal;
+    SkPoint     firstOuterPt;
+    int         prevIndex = 0;
+    int         segmentCount = 0;
+
+    for (int i = 1; i <= count; ++i) {
+        const SkPoint& prevPt = pts[prevIndex];
+        const SkPoint& currPt = pts[i];
+        if (prevIndex == i - 1) {
+            unitNormal = unitNormals[i - 1];
+            if (0 == unitNormal.fX && 0 == unitNormal.fY) {
+                continue;   // degenerate
+            }
+        } else {
+            // A degenerate line was skipped, so the batch has no normal for this one.
+            if (SkPath::IsLineDegenerate(prevPt, currPt)) {
+                continue;
+            }
+            unitNormal.setNormalize(currPt.fX - prevPt.fX, currPt.fY - prevPt.fY);
+            unitNormal.rotateCCW();
+        }
+        unitNormal.scale(fRadius, &normal);
+
+        if (0 == segmentCount) {
+            firstNormal = normal;
+            firstUnitNormal = unitNormal;
+            firstOuterPt.set(prevPt.fX + normal.fX, prevPt.fY + normal.fY);
+
+            fOuter.moveTo(firstOuterPt.fX, firstOuterPt.fY);
+            fInner.moveTo(prevPt.fX - normal.fX, prevPt.fY - normal.fY);
+        } else {
+            fJoiner(&fOuter, &fInner, prevUnitNormal, prevPt, unitNormal,
+                    fRadius, fInvMiterLimit, true, true);
+        }
+        fOuter.lineTo(currPt.fX + normal.fX, currPt.fY + normal.fY);
+        fInner.lineTo(currPt.fX - normal.fX, currPt.fY - normal.fY);
+
+        prevIndex = i;
+        prevUnitNormal = unitNormal;
+        prevNormal = normal;
+        segmentCount += 1;
+    }
+
+    if (segmentCount > 0) {
+        const SkPoint& prevPt = pts[prevIndex];
+        SkPoint pt;
+
+        if (close) {
+            fJoiner(&fOuter, &fInner, prevUnitNormal, prevPt,
+                    firstUnitNormal, fRadius, fInvMiterLimit,
+                    true, currIsLine);
+            fOuter.close();
+            // now add fInner as its own contour
+            fInner.getLastPt(&pt);
+            fOuter.moveTo(pt.fX, pt.fY);
+            fOuter.reversePathTo(fInner);
+            fOuter.close();
+        } else {    // add caps to start and end
+            // cap the end
+            fInner.getLastPt(&pt);
+            fCapper(&fOuter, prevPt, prevNormal, pt,
+                    currIsLine ? &fInner : NULL);
+            fOuter.reversePathTo(fInner);
+            // cap the start
+            fCapper(&fOuter, pts[0], -firstNormal, firstOuterPt, &fInner);
+            fOuter.close();
+        }
+    }
+    fInner.rewind();
+    fContour.rewind();
+}
+
+void SkPolylineStroker::done(SkPath* dst, bool isLine) {
+    this->finishContour(false, isLine);
+
+    SkPath result;
+    const int verbCount = fOuter.fVerbs.count();
+    const int ptCount = fOuter.fPts.count();
+    if (verbCount > 0) {
+        SkPathRef::Editor ed(&result.fPathRef);
+        uint8_t* verbs;
+        SkPoint* pts;
+        ed.grow(verbCount, ptCount, &verbs, &pts);
+        memcpy(pts, fOuter.fPts.begin(), ptCount * sizeof(SkPoint));
+        for (int i = 0; i < verbCount; ++i) {
+            verbs[~i] = fOuter.fVerbs[i];
+        }
+        result.fSegmentMask = fOuter.fSegmentMask;
+        result.fLastMoveToIndex = fOuter.fLastMoveToIndex;
+    }
+    dst->swap(result);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -479,6 +658,7 @@ SkStroke::SkStroke() {
     fCap        = SkPaint::kDefault_Cap;
     fJoin       = SkPaint::kDefault_Join;
     fDoFill     = false;
+    fUseCache   = true;
 }
 
 SkStroke::SkStroke(const SkPaint& p) {
@@ -487,6 +667,7 @@ SkStroke::SkStroke(const SkPaint& p) {
     fCap        = (uint8_t)p.getStrokeCap();
     fJoin       = (uint8_t)p.getStrokeJoin();
     fDoFill     = SkToU8(p.getStyle() == SkPaint::kStrokeAndFill_Style);
+    fUseCache   = true;
 }
 
 SkStroke::SkStroke(const SkPaint& p, SkScalar width) {
@@ -495,6 +676,7 @@ SkStroke::SkStroke(const SkPaint& p, SkScalar width) {
     fCap        = (uint8_t)p.getStrokeCap();
     fJoin       = (uint8_t)p.getStrokeJoin();
     fDoFill     = SkToU8(p.getStyle() == SkPaint::kStrokeAndFill_Style);
+    fUseCache   = true;
 }
 
 void SkStroke::setWidth(SkScalar width) {
@@ -556,6 +738,50 @@ void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
         return;
     }
 
+    if (!fUseCache || !SkStrokeCache::IsEnabled()) {
+        this->strokeUncachedPath(src, dst);
+        return;
+    }
+
+    SkStrokeCache::Key key(src, *this);
+    if (SkStrokeCache::Find(key, dst)) {
+        return;
+    }
+    this->strokeUncachedPath(src, dst);
+    SkStrokeCache::Add(key, *dst);
+}
+
+void SkStroke::strokePath(const SkPath& src, const SkRect& bounds, SkPath* dst) const {
+    SkASSERT(&src != NULL && dst != NULL);
+
+    SkPath culled;
+    if (!CullPath(src, bounds, &culled)) {
+        this->strokePath(src, dst);
+        return;
+    }
+
+    if (!fUseCache || !SkStrokeCache::IsEnabled() || SkScalarHalf(fWidth) <= 0) {
+        SkStroke stroker(*this);
+        stroker.setUseCache(false);
+        stroker.strokePath(culled, dst);
+        return;
+    }
+
+    // culled is new every time, so the culled stroke is cached for src and
+    // bounds. dst may be src, so make the keys before anything is found.
+    SkStrokeCache::Key key(src, *this);
+    SkStrokeCache::Key culledKey(src, *this, &bounds);
+    if (SkStrokeCache::Find(key, dst) || SkStrokeCache::Find(culledKey, dst)) {
+        return;
+    }
+    dst->reset();
+    this->strokeUncachedPath(culled, dst);
+    SkStrokeCache::Add(culledKey, *dst);
+}
+
+void SkStroke::strokeUncachedPath(const SkPath& src, SkPath* dst) const {
+    SkScalar radius = SkScalarHalf(fWidth);
+
     // If src is really a rect, call our specialty strokeRect() method
     {
         bool isClosed;
@@ -571,52 +797,82 @@ void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
         }
     }
 
-    SkAutoConicToQuads converter;
-    const SkScalar conicTol = SK_Scalar1 / 4;
-
-    SkPathStroker   stroker(src, radius, fMiterLimit, this->getCap(),
-                            this->getJoin());
-    SkPath::Iter    iter(src, false);
-    SkPath::Verb    lastSegment = SkPath::kMove_Verb;
-
-    for (;;) {
-        SkPoint  pts[4];
-        switch (iter.next(pts, false)) {
-            case SkPath::kMove_Verb:
-                stroker.moveTo(pts[0]);
-                break;
-            case SkPath::kLine_Verb:
-                stroker.lineTo(pts[1]);
-                lastSegment = SkPath::kLine_Verb;
-                break;
-            case SkPath::kQuad_Verb:
-                stroker.quadTo(pts[1], pts[2]);
-                lastSegment = SkPath::kQuad_Verb;
-                break;
-            case SkPath::kConic_Verb: {
-                // todo: if we had maxcurvature for conics, perhaps we should
-                // natively extrude the conic instead of converting to quads.
-                const SkPoint* quadPts =
-                    converter.computeQuads(pts, iter.conicWeight(), conicTol);
-                for (int i = 0; i < converter.countQuads(); ++i) {
-                    stroker.quadTo(quadPts[1], quadPts[2]);
-                    quadPts += 2;
-                }
-                lastSegment = SkPath::kQuad_Verb;
-            } break;
-            case SkPath::kCubic_Verb:
-                stroker.cubicTo(pts[1], pts[2], pts[3]);
-                lastSegment = SkPath::kCubic_Verb;
-                break;
-            case SkPath::kClose_Verb:
-                stroker.close(lastSegment == SkPath::kLine_Verb);
-                break;
-            case SkPath::kDone_Verb:
-                goto DONE;
+    if (SkPath::kLine_SegmentMask == src.getSegmentMasks()) {
+        SkPolylineStroker   stroker(src, radius, fMiterLimit, this->getCap(),
+                                    this->getJoin());
+        SkPath::Iter        iter(src, false);
+        SkPath::Verb        lastSegment = SkPath::kMove_Verb;
+
+        for (;;) {
+            SkPoint  pts[4];
+            switch (iter.next(pts, false)) {
+                case SkPath::kMove_Verb:
+                    stroker.moveTo(pts[0]);
+                    break;
+                case SkPath::kLine_Verb:
+                    stroker.lineTo(pts[1]);
+                    lastSegment = SkPath::kLine_Verb;
+                    break;
+                case SkPath::kClose_Verb:
+                    stroker.close(lastSegment == SkPath::kLine_Verb);
+                    break;
+                case SkPath::kDone_Verb:
+                    goto POLYLINE_DONE;
+                default:
+                    SkDEBUGFAIL("unexpected verb");
+                    break;
+            }
+        }
+POLYLINE_DONE:
+        stroker.done(dst, lastSegment == SkPath::kLine_Verb);
+    } else {
+        SkAutoConicToQuads converter;
+        const SkScalar conicTol = SK_Scalar1 / 4;
+
+        SkPathStroker   stroker(src, radius, fMiterLimit, this->getCap(),
+                                this->getJoin());
+        SkPath::Iter    iter(src, false);
+        SkPath::Verb    lastSegment = SkPath::kMove_Verb;
+
+        for (;;) {
+            SkPoint  pts[4];
+            switch (iter.next(pts, false)) {
+                case SkPath::kMove_Verb:
+                    stroker.moveTo(pts[0]);
+                    break;
+                case SkPath::kLine_Verb:
+                    stroker.lineTo(pts[1]);
+                    lastSegment = SkPath::kLine_Verb;
+                    break;
+                case SkPath::kQuad_Verb:
+                    stroker.quadTo(pts[1], pts[2]);
+                    lastSegment = SkPath::kQuad_Verb;
+                    break;
+                case SkPath::kConic_Verb: {
+                    // todo: if we had maxcurvature for conics, perhaps we should
+                    // natively extrude the conic instead of converting to quads.
+                    const SkPoint* quadPts =
+                        converter.computeQuads(pts, iter.conicWeight(), conicTol);
+                    for (int i = 0; i < converter.countQuads(); ++i) {
+                        stroker.quadTo(quadPts[1], quadPts[2]);
+                        quadPts += 2;
+                    }
+                    lastSegment = SkPath::kQuad_Verb;
+                } break;
+                case SkPath::kCubic_Verb:
+                    stroker.cubicTo(pts[1], pts[2], pts[3]);
+                    lastSegment = SkPath::kCubic_Verb;
+                    break;
+                case SkPath::kClose_Verb:
+                    stroker.close(lastSegment == SkPath::kLine_Verb);
+                    break;
+                case SkPath::kDone_Verb:
+                    goto DONE;
+            }
         }
-    }
 DONE:
-    stroker.done(dst, lastSegment == SkPath::kLine_Verb);
+        stroker.done(dst, lastSegment == SkPath::kLine_Verb);
+    }
 
     if (fDoFill) {
         if (src.cheapIsDirection(SkPath::kCCW_Direction)) {
@@ -732,3 +988,151 @@ void SkStroke::strokeRect(const SkRect& origRect, SkPath* dst,
         dst->addRect(r, reverse_direction(dir));
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Like SkRect::intersects(), but also true for empty (e.g. horizontal) rects
+// that touch r.
+static bool bounds_intersect(const SkPoint pts[], int count, const SkRect& r) {
+    SkRect bounds;
+    bounds.set(pts, count);
+    return bounds.fLeft <= r.fRight && r.fLeft <= bounds.fRight &&
+           bounds.fTop <= r.fBottom && r.fTop <= bounds.fBottom;
+}
+
+static void append_segment(SkPath* path, SkPath::Verb verb, const SkPoint pts[],
+                           SkScalar weight) {
+    switch (verb) {
+        case SkPath::kLine_Verb:
+            path->lineTo(pts[1]);
+            break;
+        case SkPath::kQuad_Verb:
+            path->quadTo(pts[1], pts[2]);
+            break;
+        case SkPath::kConic_Verb:
+            path->conicTo(pts[1], pts[2], weight);
+            break;
+        case SkPath::kCubic_Verb:
+            path->cubicTo(pts[1], pts[2], pts[3]);
+            break;
+        default:
+            SkDEBUGFAIL("unexpected verb");
+            break;
+    }
+}
+
+// Builds the culled copy of a path, a contour at a time. The segments before
+// the first dropped one are held back in fFirstRun: if the contour is closed
+// and its last segment is kept, they continue the last run, so that the join
+// at the start of the contour is not replaced by two caps.
+class SkStrokeCuller {
+public:
+    SkStrokeCuller(const SkRect& bounds, SkPath* dst) : fBounds(bounds), fDst(dst) {
+        this->reset();
+    }
+
+    void moveTo() {
+        this->finishContour();
+        this->reset();
+    }
+
+    void segment(SkPath::Verb verb, const SkPoint pts[], int count, SkScalar weight) {
+        if (!bounds_intersect(pts, count, fBounds)) {
+            fDropped = true;
+            fInRun = false;
+            return;
+        }
+
+        SkPath* run = fDropped ? fDst : &fFirstRun;
+        if (!fInRun) {
+            run->moveTo(pts[0]);
+            fInRun = true;
+        }
+        append_segment(run, verb, pts, weight);
+    }
+
+    void close() { fClosed = true; }
+
+    void finishContour() {
+        if (fFirstRun.isEmpty()) {
+            return;
+        }
+        if (!fDropped) {
+            fDst->addPath(fFirstRun);
+            if (fClosed) {
+                fDst->close();
+            }
+        } else if (fClosed && fInRun) {
+            SkPath::Iter    iter(fFirstRun, false);
+            SkPoint         pts[4];
+            SkPath::Verb    verb;
+            while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+                if (SkPath::kMove_Verb != verb) {
+                    SkScalar weight = SkPath::kConic_Verb == verb ? iter.conicWeight() : 0;
+                    append_segment(fDst, verb, pts, weight);
+                }
+            }
+        } else {
+            fDst->addPath(fFirstRun);
+        }
+    }
+
+private:
+    const SkRect&   fBounds;
+    SkPath*         fDst;
+    SkPath          fFirstRun;
+    bool            fDropped;   // any segment of this contour
+    bool            fInRun;     // the last segment was kept
+    bool            fClosed;
+
+    void reset() {
+        fFirstRun.rewind();
+        fDropped = false;
+        fInRun = false;
+        fClosed = false;
+    }
+};
+
+bool SkStroke::CullPath(const SkPath& src, const SkRect& bounds, SkPath* dst) {
+    SkASSERT(&src != dst);
+
+    const SkRect& srcBounds = src.getBounds();
+    if (bounds.fLeft <= srcBounds.fLeft && bounds.fTop <= srcBounds.fTop &&
+            bounds.fRight >= srcBounds.fRight && bounds.fBottom >= srcBounds.fBottom) {
+        return false;
+    }
+
+    dst->reset();
+    dst->setFillType(src.getFillType());
+
+    SkStrokeCuller  culler(bounds, dst);
+    SkPath::Iter    iter(src, false);
+    SkPoint         pts[4];
+
+    for (;;) {
+        SkPath::Verb verb = iter.next(pts, false);
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                culler.moveTo();
+                break;
+            case SkPath::kLine_Verb:
+                culler.segment(verb, pts, 2, 0);
+                break;
+            case SkPath::kQuad_Verb:
+                culler.segment(verb, pts, 3, 0);
+                break;
+            case SkPath::kConic_Verb:
+                culler.segment(verb, pts, 3, iter.conicWeight());
+                break;
+            case SkPath::kCubic_Verb:
+                culler.segment(verb, pts, 4, 0);
+                break;
+            case SkPath::kClose_Verb:
+                culler.close();
+                break;
+            case SkPath::kDone_Verb:
+                culler.finishContour();
+                return true;
+        }
+    }
+}
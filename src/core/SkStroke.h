@@ -30,25 +30,63 @@ public:
     SkPaint::Join   getJoin() const { return (SkPaint::Join)fJoin; }
     void        setJoin(SkPaint::Join);
 
+    SkScalar getMiterLimit() const { return fMiterLimit; }
     void    setMiterLimit(SkScalar);
+
+    SkScalar getWidth() const { return fWidth; }
     void    setWidth(SkScalar);
 
     bool    getDoFill() const { return SkToBool(fDoFill); }
     void    setDoFill(bool doFill) { fDoFill = SkToU8(doFill); }
 
+    /**
+     *  Paths that are only ever stroked once (such as the dashes of a dashed
+     *  path) should not use SkStrokeCache. The default is true.
+     */
+    bool    getUseCache() const { return SkToBool(fUseCache); }
+    void    setUseCache(bool useCache) { fUseCache = SkToU8(useCache); }
+
     /**
      *  Stroke the specified rect, winding it in the specified direction..
      */
     void    strokeRect(const SkRect& rect, SkPath* result,
                        SkPath::Direction = SkPath::kCW_Direction) const;
+    /**
+     *  Stroke the path. If SkStrokeCache is enabled (and getUseCache()), the
+     *  result is looked up there first, and added to it if it is not found.
+     */
     void    strokePath(const SkPath& path, SkPath*) const;
 
+    /**
+     *  Stroke the path as CullPath() culls it to bounds. If SkStrokeCache is
+     *  enabled (and getUseCache()), a cached stroke of the whole path is used
+     *  if there is one; otherwise the stroke of the culled path is cached for
+     *  path and bounds, so that drawing the same path into the same bounds
+     *  again (e.g. the same tile) hits the cache.
+     */
+    void    strokePath(const SkPath& path, const SkRect& bounds, SkPath*) const;
+
+    /**
+     *  Copy into dst only the segments of src whose control points' bounds
+     *  intersect bounds, breaking contours where the others are dropped. If
+     *  bounds is the area of interest outset by how far the stroke can reach,
+     *  stroking dst looks the same as stroking src inside that area (but
+     *  filling it does not).
+     *
+     *  Returns false, leaving dst unchanged, if nothing would be dropped.
+     */
+    static bool CullPath(const SkPath& src, const SkRect& bounds, SkPath* dst);
+
     ////////////////////////////////////////////////////////////////
 
 private:
+    // strokePath() without the SkStrokeCache lookup. dst must not be src.
+    void    strokeUncachedPath(const SkPath& src, SkPath* dst) const;
+
     SkScalar    fWidth, fMiterLimit;
     uint8_t     fCap, fJoin;
     SkBool8     fDoFill;
+    SkBool8     fUseCache;
 
     friend class SkPaint;
 };
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkStrokeCache.h"
+#include "SkBuffer.h"
+#include "SkChecksum.h"
+#include "SkPathRef.h"
+#include "SkStroke.h"
+
+// Off unless the client asks for it, as most paths are only stroked once.
+#ifndef SK_DEFAULT_STROKE_CACHE_LIMIT
+    #define SK_DEFAULT_STROKE_CACHE_LIMIT   0
+#endif
+
+SkStrokeCache::Key::Key(const SkPath& src, const SkStroke& stroke, const SkRect* cullBounds) {
+    fPathID = src.fPathRef->genID();
+    fFlags = (stroke.getCap() << 0) | (stroke.getJoin() << 8) |
+             (stroke.getDoFill() << 16) | (src.isInverseFillType() << 17) |
+             ((NULL != cullBounds) << 18);
+    fWidth = stroke.getWidth();
+    // The miter limit only changes the result of miter joins.
+    fMiterLimit = SkPaint::kMiter_Join == stroke.getJoin() ? stroke.getMiterLimit() : 0;
+    if (cullBounds) {
+        fCullBounds = *cullBounds;
+    } else {
+        fCullBounds.setEmpty();
+    }
+    fHash = SkChecksum::Compute(reinterpret_cast<const uint32_t*>(this),
+                                SK_OFFSETOF(Key, fHash));
+}
+
+bool SkStrokeCache::find(const Key& key, SkPath* result) {
+    const SkPath* path = fCache.find(key);
+    if (NULL == path) {
+        return false;
+    }
+    *result = *path;
+    return true;
+}
+
+void SkStrokeCache::add(const Key& key, const SkPath& result) {
+    size_t bytes = result.countPoints() * sizeof(SkPoint) + result.countVerbs();
+    SkPath* path = fCache.add(key, bytes);
+    if (path) {
+        *path = result;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SkThread.h"
+
+SK_DECLARE_STATIC_MUTEX(gMutex);
+
+// Whether the global cache's limit is above 0, written with gMutex held and read without it.
+static volatile bool gEnabled = SK_DEFAULT_STROKE_CACHE_LIMIT > 0;
+
+static SkStrokeCache* get_cache() {
+    static SkStrokeCache* gCache;
+    if (!gCache) {
+        gCache = SkNEW_ARGS(SkStrokeCache, (SK_DEFAULT_STROKE_CACHE_LIMIT));
+    }
+    return gCache;
+}
+
+bool SkStrokeCache::Find(const Key& key, SkPath* result) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->find(key, result);
+}
+
+void SkStrokeCache::Add(const Key& key, const SkPath& result) {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->add(key, result);
+}
+
+void SkStrokeCache::GetStats(Stats* stats) {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->getStats(stats);
+}
+
+void SkStrokeCache::ResetStats() {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->resetStats();
+}
+
+void SkStrokeCache::PurgeAll() {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->purgeAll();
+}
+
+size_t SkStrokeCache::GetByteLimit() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getByteLimit();
+}
+
+size_t SkStrokeCache::SetByteLimit(size_t newLimit) {
+    SkAutoMutexAcquire am(gMutex);
+    gEnabled = newLimit > 0;
+    return get_cache()->setByteLimit(newLimit);
+}
+
+bool SkStrokeCache::IsEnabled() {
+    return gEnabled;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SkGraphics.h"
+
+size_t SkGraphics::GetStrokeCacheBytesUsed() {
+    SkStrokeCache::Stats stats;
+    SkStrokeCache::GetStats(&stats);
+    return stats.fBytesUsed;
+}
+
+size_t SkGraphics::GetStrokeCacheByteLimit() {
+    return SkStrokeCache::GetByteLimit();
+}
+
+size_t SkGraphics::SetStrokeCacheByteLimit(size_t newLimit) {
+    return SkStrokeCache::SetByteLimit(newLimit);
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStrokeCache_DEFINED
+#define SkStrokeCache_DEFINED
+
+#include "SkPath.h"
+#include "SkRect.h"
+#include "SkTLRUCache.h"
+
+class SkStroke;
+
+/**
+ *  Cache of the paths that SkStroke::strokePath() builds, so that drawing the same path with
+ *  the same stroke again (e.g. the roads of a map, redrawn on every frame) does not stroke it
+ *  again.
+ *
+ *  Entries are keyed by the generation ID of the source path's SkPathRef, which changes
+ *  whenever the points or verbs are edited, along with every stroke parameter that the
+ *  result depends on. The cached paths share their storage with the paths handed out for
+ *  them, so a hit costs no more than a path copy.
+ *
+ *  The global cache has a limit of 0 by default, which disables it: clients that redraw
+ *  the same strokes turn it on with SkGraphics::SetStrokeCacheByteLimit().
+ */
+class SkStrokeCache {
+public:
+    class Key {
+    public:
+        /**
+         *  If cullBounds is not NULL, the key is for the stroke of src culled
+         *  to cullBounds by SkStroke::CullPath().
+         */
+        Key(const SkPath& src, const SkStroke&, const SkRect* cullBounds = NULL);
+
+        uint32_t hash() const { return fHash; }
+
+        bool operator==(const Key& other) const {
+            return 0 == memcmp(this, &other, sizeof(Key));
+        }
+
+    private:
+        int32_t     fPathID;
+        uint32_t    fFlags;     // cap, join, doFill, the src inverse bit and culled
+        SkScalar    fWidth;
+        SkScalar    fMiterLimit;
+        SkRect      fCullBounds;
+        uint32_t    fHash;
+    };
+
+    typedef SkTLRUCache<Key, SkPath>::Stats Stats;
+
+    /*
+     *  The following static methods are thread-safe wrappers around a global
+     *  instance of this cache.
+     */
+
+    static bool Find(const Key&, SkPath* result);
+    static void Add(const Key&, const SkPath& result);
+
+    static void GetStats(Stats*);
+    static void ResetStats();
+    static void PurgeAll();
+
+    static size_t GetByteLimit();
+    static size_t SetByteLimit(size_t newLimit);
+
+    /**
+     *  Return whether the global cache's limit is above 0. This does not take the mutex, so a
+     *  call racing with SetByteLimit() may see the old state, but it lets strokes skip building
+     *  a key and locking while the cache is off.
+     */
+    static bool IsEnabled();
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    SkStrokeCache(size_t byteLimit) : fCache(byteLimit) {}
+
+    /**
+     *  Search the cache for key. If it is found, copy its stroked path into result and return
+     *  true. Otherwise return false and leave result unchanged.
+     */
+    bool find(const Key&, SkPath* result);
+
+    /**
+     *  Add a copy of the stroked path result to the cache.
+     */
+    void add(const Key&, const SkPath& result);
+
+    void getStats(Stats* stats) const { fCache.getStats(stats); }
+    void resetStats() { fCache.resetStats(); }
+    void purgeAll() { fCache.purgeAll(); }
+
+    size_t getByteLimit() const { return fCache.getByteLimit(); }
+    size_t setByteLimit(size_t newLimit) { return fCache.setByteLimit(newLimit); }
+
+private:
+    SkTLRUCache<Key, SkPath> fCache;
+};
+
+#endif
@@ -89,7 +89,26 @@ void SkStrokeRec::setStrokeStyle(SkScalar width, bool strokeAndFill) {
 
 #include "SkStroke.h"
 
-bool SkStrokeRec::applyToPath(SkPath* dst, const SkPath& src) const {
+SkScalar SkStrokeRec::getInflationRadius() const {
+    if (fWidth < 0) {   // fill
+        return 0;
+    }
+    SkScalar radius = SkScalarHalf(fWidth);
+    if (0 == radius) {
+        radius = SK_Scalar1;    // hairlines
+    }
+    SkScalar scale = SK_Scalar1;
+    if (SkPaint::kMiter_Join == fJoin) {
+        scale = SkMaxScalar(scale, fMiterLimit);
+    }
+    if (SkPaint::kSquare_Cap == fCap) {
+        scale = SkMaxScalar(scale, SK_ScalarSqrt2);
+    }
+    return SkScalarMul(radius, scale);
+}
+
+bool SkStrokeRec::applyToPath(SkPath* dst, const SkPath& src,
+                              const SkRect* cullRect) const {
     if (fWidth <= 0) {  // hairline or fill
         return false;
     }
@@ -100,6 +119,16 @@ bool SkStrokeRec::applyToPath(SkPath* dst, const SkPath& src) const {
     stroker.setMiterLimit(fMiterLimit);
     stroker.setWidth(fWidth);
     stroker.setDoFill(fStrokeAndFill);
+
+    if (cullRect && !fStrokeAndFill) {
+        SkRect bounds = *cullRect;
+        SkScalar radius = this->getInflationRadius();
+        bounds.outset(radius, radius);
+
+        stroker.strokePath(src, bounds, dst);
+        return true;
+    }
+
     stroker.strokePath(src, dst);
     return true;
 }
@@ -11,16 +11,18 @@
 #include "SkGeometry.h"
 #include "SkPath.h"
 
-static void ButtCapper(SkPath* path, const SkPoint& pivot,
+template <typename Path>
+static void ButtCapper(Path* path, const SkPoint& pivot,
                        const SkVector& normal, const SkPoint& stop,
-                       SkPath*)
+                       Path*)
 {
     path->lineTo(stop.fX, stop.fY);
 }
 
-static void RoundCapper(SkPath* path, const SkPoint& pivot,
+template <typename Path>
+static void RoundCapper(Path* path, const SkPoint& pivot,
                         const SkVector& normal, const SkPoint& stop,
-                        SkPath*)
+                        Path*)
 {
     SkScalar    px = pivot.fX;
     SkScalar    py = pivot.fY;
@@ -37,9 +39,10 @@ static void RoundCapper(SkPath* path, const SkPoint& pivot,
                   stop.fX, stop.fY);
 }
 
-static void SquareCapper(SkPath* path, const SkPoint& pivot,
+template <typename Path>
+static void SquareCapper(Path* path, const SkPoint& pivot,
                          const SkVector& normal, const SkPoint& stop,
-                         SkPath* otherPath)
+                         Path* otherPath)
 {
     SkVector parallel;
     normal.rotateCW(&parallel);
@@ -82,7 +85,8 @@ static AngleType Dot2AngleType(SkScalar dot)
         return SkScalarNearlyZero(SK_Scalar1 + dot) ? kNearly180_AngleType : kSharp_AngleType;
 }
 
-static void HandleInnerJoin(SkPath* inner, const SkPoint& pivot, const SkVector& after)
+template <typename Path>
+static void HandleInnerJoin(Path* inner, const SkPoint& pivot, const SkVector& after)
 {
 #if 1
     /*  In the degenerate case that the stroke radius is larger than our segments
@@ -97,7 +101,8 @@ static void HandleInnerJoin(SkPath* inner, const SkPoint& pivot, const SkVector&
     inner->lineTo(pivot.fX - after.fX, pivot.fY - after.fY);
 }
 
-static void BluntJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnitNormal,
+template <typename Path>
+static void BluntJoiner(Path* outer, Path* inner, const SkVector& beforeUnitNormal,
                         const SkPoint& pivot, const SkVector& afterUnitNormal,
                         SkScalar radius, SkScalar invMiterLimit, bool, bool)
 {
@@ -106,7 +111,7 @@ static void BluntJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnit
 
     if (!is_clockwise(beforeUnitNormal, afterUnitNormal))
     {
-        SkTSwap<SkPath*>(outer, inner);
+        SkTSwap<Path*>(outer, inner);
         after.negate();
     }
 
@@ -114,7 +119,8 @@ static void BluntJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnit
     HandleInnerJoin(inner, pivot, after);
 }
 
-static void RoundJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnitNormal,
+template <typename Path>
+static void RoundJoiner(Path* outer, Path* inner, const SkVector& beforeUnitNormal,
                         const SkPoint& pivot, const SkVector& afterUnitNormal,
                         SkScalar radius, SkScalar invMiterLimit, bool, bool)
 {
@@ -130,7 +136,7 @@ static void RoundJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnit
 
     if (!is_clockwise(before, after))
     {
-        SkTSwap<SkPath*>(outer, inner);
+        SkTSwap<Path*>(outer, inner);
         before.negate();
         after.negate();
         dir = kCCW_SkRotationDirection;
@@ -159,7 +165,8 @@ static void RoundJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnit
     #define kOneOverSqrt2   (46341)
 #endif
 
-static void MiterJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnitNormal,
+template <typename Path>
+static void MiterJoiner(Path* outer, Path* inner, const SkVector& beforeUnitNormal,
                         const SkPoint& pivot, const SkVector& afterUnitNormal,
                         SkScalar radius, SkScalar invMiterLimit,
                         bool prevIsLine, bool currIsLine)
@@ -184,7 +191,7 @@ static void MiterJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnit
     ccw = !is_clockwise(before, after);
     if (ccw)
     {
-        SkTSwap<SkPath*>(outer, inner);
+        SkTSwap<Path*>(outer, inner);
         before.negate();
         after.negate();
     }
@@ -246,7 +253,7 @@ DO_BLUNT:
 SkStrokerPriv::CapProc SkStrokerPriv::CapFactory(SkPaint::Cap cap)
 {
     static const SkStrokerPriv::CapProc gCappers[] = {
-        ButtCapper, RoundCapper, SquareCapper
+        ButtCapper<SkPath>, RoundCapper<SkPath>, SquareCapper<SkPath>
     };
 
     SkASSERT((unsigned)cap < SkPaint::kCapCount);
@@ -256,9 +263,137 @@ SkStrokerPriv::CapProc SkStrokerPriv::CapFactory(SkPaint::Cap cap)
 SkStrokerPriv::JoinProc SkStrokerPriv::JoinFactory(SkPaint::Join join)
 {
     static const SkStrokerPriv::JoinProc gJoiners[] = {
-        MiterJoiner, RoundJoiner, BluntJoiner
+        MiterJoiner<SkPath>, RoundJoiner<SkPath>, BluntJoiner<SkPath>
     };
 
     SkASSERT((unsigned)join < SkPaint::kJoinCount);
     return gJoiners[join];
 }
+
+SkStrokerPriv::BufferCapProc SkStrokerPriv::BufferCapFactory(SkPaint::Cap cap)
+{
+    static const SkStrokerPriv::BufferCapProc gCappers[] = {
+        ButtCapper<SkStrokeBuffer>, RoundCapper<SkStrokeBuffer>, SquareCapper<SkStrokeBuffer>
+    };
+
+    SkASSERT((unsigned)cap < SkPaint::kCapCount);
+    return gCappers[cap];
+}
+
+SkStrokerPriv::BufferJoinProc SkStrokerPriv::BufferJoinFactory(SkPaint::Join join)
+{
+    static const SkStrokerPriv::BufferJoinProc gJoiners[] = {
+        MiterJoiner<SkStrokeBuffer>, RoundJoiner<SkStrokeBuffer>, BluntJoiner<SkStrokeBuffer>
+    };
+
+    SkASSERT((unsigned)join < SkPaint::kJoinCount);
+    return gJoiners[join];
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void SkStrokeBuffer::quadTo(SkScalar x1, SkScalar y1, SkScalar x2, SkScalar y2)
+{
+    SkASSERT(fVerbs.count() > 0);
+    *fVerbs.append() = SkPath::kQuad_Verb;
+    SkPoint* pts = fPts.append(2);
+    pts[0].set(x1, y1);
+    pts[1].set(x2, y2);
+    fSegmentMask |= SkPath::kQuad_SegmentMask;
+}
+
+void SkStrokeBuffer::cubicTo(SkScalar x1, SkScalar y1, SkScalar x2, SkScalar y2,
+                             SkScalar x3, SkScalar y3)
+{
+    SkASSERT(fVerbs.count() > 0);
+    *fVerbs.append() = SkPath::kCubic_Verb;
+    SkPoint* pts = fPts.append(3);
+    pts[0].set(x1, y1);
+    pts[1].set(x2, y2);
+    pts[2].set(x3, y3);
+    fSegmentMask |= SkPath::kCubic_SegmentMask;
+}
+
+void SkStrokeBuffer::close()
+{
+    if (fVerbs.count() > 0 && SkPath::kClose_Verb != fVerbs.top()) {
+        *fVerbs.append() = SkPath::kClose_Verb;
+    }
+    // signal that we need a moveTo to follow us, as SkPath::close() does
+    fLastMoveToIndex ^= ~fLastMoveToIndex >> (8 * sizeof(fLastMoveToIndex) - 1);
+}
+
+bool SkStrokeBuffer::getLastPt(SkPoint* lastPt) const
+{
+    if (fPts.count() > 0) {
+        *lastPt = fPts.top();
+        return true;
+    }
+    lastPt->set(0, 0);
+    return false;
+}
+
+void SkStrokeBuffer::setLastPt(SkScalar x, SkScalar y)
+{
+    if (fPts.count() == 0) {
+        this->moveTo(x, y);
+    } else {
+        fPts.top().set(x, y);
+    }
+}
+
+void SkStrokeBuffer::reversePathTo(const SkStrokeBuffer& path)
+{
+    int i, vcount = path.fVerbs.count();
+    // exit early if the path is empty, or just has a moveTo.
+    if (vcount < 2) {
+        return;
+    }
+
+    const uint8_t*  verbs = path.fVerbs.begin();
+    const SkPoint*  pts = path.fPts.begin();
+
+    static const uint8_t gPtsInVerb[] = { 1, 1, 2, 2, 3, 0, 0 };
+
+    SkASSERT(SkPath::kMove_Verb == verbs[0]);
+    for (i = 1; i < vcount; ++i) {
+        int n = gPtsInVerb[verbs[i]];
+        if (n == 0) {
+            break;
+        }
+        pts += n;
+    }
+
+    while (--i > 0) {
+        switch (verbs[i]) {
+            case SkPath::kLine_Verb:
+                this->lineTo(pts[-1].fX, pts[-1].fY);
+                break;
+            case SkPath::kQuad_Verb:
+                this->quadTo(pts[-1].fX, pts[-1].fY, pts[-2].fX, pts[-2].fY);
+                break;
+            case SkPath::kCubic_Verb:
+                this->cubicTo(pts[-1].fX, pts[-1].fY, pts[-2].fX, pts[-2].fY,
+                              pts[-3].fX, pts[-3].fY);
+                break;
+            default:
+                SkDEBUGFAIL("bad verb");
+                break;
+        }
+        pts -= gPtsInVerb[verbs[i]];
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void SkStrokerPriv::UnitNormals(const SkPoint pts[], int count, SkVector unitNormals[])
+{
+    for (int i = 0; i < count; ++i) {
+        if (SkPath::IsLineDegenerate(pts[i], pts[i + 1])) {
+            unitNormals[i].set(0, 0);
+        } else {
+            unitNormals[i].setNormalize(pts[i + 1].fX - pts[i].fX, pts[i + 1].fY - pts[i].fY);
+            unitNormals[i].rotateCCW();
+        }
+    }
+}
@@ -11,6 +11,7 @@
 #define SkStrokerPriv_DEFINED
 
 #include "SkStroke.h"
+#include "SkTDArray.h"
 
 #define CWX(x, y)   (-y)
 #define CWY(x, y)   (x)
@@ -19,6 +20,55 @@
 
 #define CUBIC_ARC_FACTOR    ((SK_ScalarSqrt2 - SK_Scalar1) * 4 / 3)
 
+/**
+ *  The subset of SkPath that the cap and join procs use, recording into plain arrays, for
+ *  the polyline stroker. It builds the same verbs and points as an SkPath would, except that
+ *  the verbs are in forward order and no moveTo is ever injected.
+ */
+class SkStrokeBuffer {
+public:
+    SkStrokeBuffer() : fSegmentMask(0), fLastMoveToIndex(~0) {}
+
+    void moveTo(SkScalar x, SkScalar y) {
+        fLastMoveToIndex = fPts.count();
+        *fVerbs.append() = SkPath::kMove_Verb;
+        fPts.append()->set(x, y);
+    }
+    void lineTo(SkScalar x, SkScalar y) {
+        SkASSERT(fVerbs.count() > 0);
+        *fVerbs.append() = SkPath::kLine_Verb;
+        fPts.append()->set(x, y);
+        fSegmentMask |= SkPath::kLine_SegmentMask;
+    }
+    void quadTo(SkScalar x1, SkScalar y1, SkScalar x2, SkScalar y2);
+    void cubicTo(SkScalar x1, SkScalar y1, SkScalar x2, SkScalar y2,
+                 SkScalar x3, SkScalar y3);
+    void close();
+
+    bool getLastPt(SkPoint* lastPt) const;
+    void setLastPt(SkScalar x, SkScalar y);
+
+    /** Same as SkPath::reversePathTo(): append the first contour of path, backwards. */
+    void reversePathTo(const SkStrokeBuffer& path);
+
+    void incReserve(int extraPtCount) {
+        fVerbs.setReserve(fVerbs.count() + extraPtCount);
+        fPts.setReserve(fPts.count() + extraPtCount);
+    }
+
+    void rewind() {
+        fVerbs.rewind();
+        fPts.rewind();
+        fSegmentMask = 0;
+        fLastMoveToIndex = ~0;
+    }
+
+    SkTDArray<uint8_t>  fVerbs;
+    SkTDArray<SkPoint>  fPts;
+    uint32_t            fSegmentMask;
+    int                 fLastMoveToIndex;   // as in SkPath
+};
+
 class SkStrokerPriv {
 public:
     typedef void (*CapProc)(SkPath* path,
@@ -36,6 +86,38 @@ public:
 
     static CapProc  CapFactory(SkPaint::Cap);
     static JoinProc JoinFactory(SkPaint::Join);
+
+    // The same procs, writing to SkStrokeBuffers
+    typedef void (*BufferCapProc)(SkStrokeBuffer* path,
+                                  const SkPoint& pivot,
+                                  const SkVector& normal,
+                                  const SkPoint& stop,
+                                  SkStrokeBuffer* otherPath);
+
+    typedef void (*BufferJoinProc)(SkStrokeBuffer* outer, SkStrokeBuffer* inner,
+                                   const SkVector& beforeUnitNormal,
+                                   const SkPoint& pivot,
+                                   const SkVector& afterUnitNormal,
+                                   SkScalar radius, SkScalar invMiterLimit,
+                                   bool prevIsLine, bool currIsLine);
+
+    static BufferCapProc  BufferCapFactory(SkPaint::Cap);
+    static BufferJoinProc BufferJoinFactory(SkPaint::Join);
+
+    /**
+     *  Set unitNormals[i] to the counter-clockwise unit normal of the line from pts[i] to
+     *  pts[i + 1], for 0 <= i < count, as SkPoint::setNormalize() and rotateCCW() would
+     *  compute it, or to (0, 0) if SkPath::IsLineDegenerate() is true for the line.
+     */
+    typedef void (*UnitNormalsProc)(const SkPoint pts[], int count, SkVector unitNormals[]);
+
+    static void UnitNormals(const SkPoint pts[], int count, SkVector unitNormals[]);
+
+    /**
+     *  Return a platform specific UnitNormalsProc, or NULL if UnitNormals() should be used.
+     *  It must match UnitNormals() exactly.
+     */
+    static UnitNormalsProc PlatformUnitNormalsProc();
 };
 
 #endif
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTLRUCache_DEFINED
+#define SkTLRUCache_DEFINED
+
+#include "SkChecksum.h"
+#include "SkScalar.h"
+#include "SkTDArray.h"
+#include "SkTDynamicHash.h"
+#include "SkTInternalLList.h"
+
+/**
+ *  Key for an SkTLRUCache, made of the 32 bit words written to it. The caches subclass it to
+ *  write what kind of entry they hold first, so keys of different kinds never compare equal.
+ */
+class SkLRUCacheKey {
+public:
+    SkLRUCacheKey() : fHash(0) {}
+
+    void write32(uint32_t value) { *fData.append() = value; }
+
+    void writeScalar(SkScalar value) {
+        SK_COMPILE_ASSERT(sizeof(SkScalar) == sizeof(uint32_t), scalar_is_32_bits);
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        this->write32(bits);
+    }
+
+    /** Append size bytes of data, where size must be a multiple of 4. */
+    void write(const void* data, size_t size) {
+        SkASSERT(SkIsAlign4(size));
+        memcpy(this->append32(SkToS32(size >> 2)), data, size);
+    }
+
+    uint32_t hash() const { return fHash; }
+    size_t size() const { return fData.count() * sizeof(uint32_t); }
+
+    /** Must be called after the last write and before the key is used. */
+    void finish() {
+        fHash = SkChecksum::Compute(fData.begin(), this->size());
+    }
+
+    bool operator==(const SkLRUCacheKey& other) const {
+        return fHash == other.fHash && fData.count() == other.fData.count() &&
+               0 == memcmp(fData.begin(), other.fData.begin(), this->size());
+    }
+
+protected:
+    /** Append count words for the caller to fill in. */
+    uint32_t* append32(int count) { return fData.append(count); }
+
+private:
+    SkTDArray<uint32_t> fData;
+    uint32_t            fHash;
+};
+
+/**
+ *  Cache of Values found by their Key, which purges the least recently used entries to stay
+ *  within a byte limit. Key must be copyable and have hash() and operator==, like the
+ *  subclasses of SkLRUCacheKey. Values are default constructed by the cache, set by the
+ *  caller of add(), and never copied, so a Value that owns memory or a ref (e.g. a
+ *  SkAutoTUnref) releases it when it is purged.
+ *
+ *  An instance is not thread-safe. The caches built on it (e.g. SkBlurMaskCache) have static
+ *  methods which are thread-safe wrappers around a global instance.
+ */
+template <typename Key, typename Value> class SkTLRUCache : SkNoncopyable {
+public:
+    struct Stats {
+        int     fHits;
+        int     fMisses;
+        int     fCount;
+        size_t  fBytesUsed;
+    };
+
+    SkTLRUCache(size_t byteLimit)
+        : fBytesUsed(0)
+        , fByteLimit(byteLimit)
+        , fCount(0)
+        , fHits(0)
+        , fMisses(0) {}
+
+    ~SkTLRUCache() {
+        Entry* entry;
+        while (NULL != (entry = fLRU.head())) {
+            fLRU.remove(entry);
+            SkDELETE(entry);
+        }
+    }
+
+    /**
+     *  Search the cache for key. If it is found, make it the most recently used entry and
+     *  return its value, which stays valid until the cache is next changed. Otherwise return
+     *  NULL.
+     */
+    const Value* find(const Key& key) {
+        Entry* entry = fHash.find(key);
+        if (NULL == entry) {
+            fMisses += 1;
+            return NULL;
+        }
+        fHits += 1;
+        fLRU.remove(entry);
+        fLRU.addToHead(entry);
+        return &entry->fValue;
+    }
+
+    /**
+     *  Add an entry for key to the cache, and return its value for the caller to set. bytes is
+     *  the memory that the entry uses outside of sizeof(Key) and sizeof(Value), e.g. the key's
+     *  data and the value's pixels. If key is already in the cache, or the entry would use more
+     *  than a quarter of it, nothing is added and NULL is returned.
+     */
+    Value* add(const Key& key, size_t bytes) {
+        if (sizeof(Entry) + bytes > fByteLimit / 4) {
+            return NULL;
+        }
+        if (fHash.find(key)) {
+            // Another thread computed the same value at the same time.
+            return NULL;
+        }
+
+        Entry* entry = SkNEW_ARGS(Entry, (key, bytes));
+        fLRU.addToHead(entry);
+        fHash.add(entry);
+        fBytesUsed += entry->fBytesUsed;
+        fCount += 1;
+
+        // We may (now) be overbudget, so see if we need to purge something. The new entry is
+        // the most recently used, and within the limit, so it is not purged.
+        this->purgeAsNeeded();
+        return &entry->fValue;
+    }
+
+    void getStats(Stats* stats) const {
+        stats->fHits = fHits;
+        stats->fMisses = fMisses;
+        stats->fCount = fCount;
+        stats->fBytesUsed = fBytesUsed;
+    }
+
+    void resetStats() {
+        fHits = 0;
+        fMisses = 0;
+    }
+
+    void purgeAll() {
+        size_t limit = fByteLimit;
+        fByteLimit = 0;
+        this->purgeAsNeeded();
+        fByteLimit = limit;
+    }
+
+    size_t getByteLimit() const { return fByteLimit; }
+
+    /**
+     *  Set the maximum number of bytes available to this cache. If the current
+     *  cache exceeds this new value, it will be purged to try to fit within
+     *  this new limit.
+     */
+    size_t setByteLimit(size_t newLimit) {
+        size_t prevLimit = fByteLimit;
+        fByteLimit = newLimit;
+        if (newLimit < prevLimit) {
+            this->purgeAsNeeded();
+        }
+        return prevLimit;
+    }
+
+private:
+    struct Entry {
+        Entry(const Key& key, size_t bytes) : fKey(key), fBytesUsed(sizeof(Entry) + bytes) {}
+
+        Key     fKey;
+        Value   fValue;
+        size_t  fBytesUsed;
+
+        SK_DECLARE_INTERNAL_LLIST_INTERFACE(Entry);
+    };
+
+    static const Key& KeyFromEntry(const Entry& entry) { return entry.fKey; }
+    static uint32_t HashFromKey(const Key& key) { return key.hash(); }
+    static bool EqEntryKey(const Entry& entry, const Key& key) { return entry.fKey == key; }
+
+    // Head is the most recently used entry, and tail the least.
+    SkTInternalLList<Entry> fLRU;
+    SkTDynamicHash<Entry, Key, KeyFromEntry, HashFromKey, EqEntryKey> fHash;
+
+    size_t  fBytesUsed;
+    size_t  fByteLimit;
+    int     fCount;
+    int     fHits;
+    int     fMisses;
+
+    void purgeAsNeeded() {
+        Entry* entry;
+        while (fBytesUsed > fByteLimit && NULL != (entry = fLRU.tail())) {
+            SkASSERT(entry->fBytesUsed <= fBytesUsed);
+            fBytesUsed -= entry->fBytesUsed;
+            fLRU.remove(entry);
+            fHash.remove(entry->fKey);
+            SkDELETE(entry);
+            fCount -= 1;
+        }
+    }
+};
+
+#endif
@@ -11,6 +11,8 @@
 #include "SkFlattenableBuffers.h"
 #include "SkMatrix.h"
 #include "SkRect.h"
+#include "SkResampleCache.h"
+#include "SkTemplates.h"
 #include "SkUnPreMultiply.h"
 
 #if SK_SUPPORT_GPU
@@ -57,14 +59,16 @@ void SkBicubicImageFilter::flatten(SkFlattenableWriteBuffer& buffer) const {
 SkBicubicImageFilter::~SkBicubicImageFilter() {
 }
 
-inline SkPMColor cubicBlend(const SkScalar c[16], SkScalar t, SkPMColor c0, SkPMColor c1, SkPMColor c2, SkPMColor c3) {
+// The weights of the four pixels around a sample with fraction t.
+inline void cubicWeights(const SkScalar c[16], SkScalar t, SkScalar cc[4]) {
     SkScalar t2 = t * t, t3 = t2 * t;
-    SkScalar cc[4];
-    // FIXME:  For the fractx case, this should be refactored out of this function.
     cc[0] = c[0]  + SkScalarMul(c[1], t) + SkScalarMul(c[2], t2) + SkScalarMul(c[3], t3);
     cc[1] = c[4]  + SkScalarMul(c[5], t) + SkScalarMul(c[6], t2) + SkScalarMul(c[7], t3);
     cc[2] = c[8]  + SkScalarMul(c[9], t) + SkScalarMul(c[10], t2) + SkScalarMul(c[11], t3);
     cc[3] = c[12] + SkScalarMul(c[13], t) + SkScalarMul(c[14], t2) + SkScalarMul(c[15], t3);
+}
+
+inline SkPMColor cubicBlend(const SkScalar cc[4], SkPMColor c0, SkPMColor c1, SkPMColor c2, SkPMColor c3) {
     SkScalar a = SkScalarClampMax(SkScalarMul(cc[0], SkGetPackedA32(c0)) + SkScalarMul(cc[1], SkGetPackedA32(c1)) + SkScalarMul(cc[2], SkGetPackedA32(c2)) + SkScalarMul(cc[3], SkGetPackedA32(c3)), 255);
     SkScalar r = SkScalarMul(cc[0], SkGetPackedR32(c0)) + SkScalarMul(cc[1], SkGetPackedR32(c1)) + SkScalarMul(cc[2], SkGetPackedR32(c2)) + SkScalarMul(cc[3], SkGetPackedR32(c3));
     SkScalar g = SkScalarMul(cc[0], SkGetPackedG32(c0)) + SkScalarMul(cc[1], SkGetPackedG32(c1)) + SkScalarMul(cc[2], SkGetPackedG32(c2)) + SkScalarMul(cc[3], SkGetPackedG32(c3));
@@ -75,6 +79,57 @@ inline SkPMColor cubicBlend(const SkScalar c[16], SkScalar t, SkPMColor c0, SkPM
                         SkScalarRoundToInt(SkScalarClampMax(b, a)));
 }
 
+namespace {
+
+// The source pixels and weights that one destination column (or row) samples.
+struct BicubicTap {
+    int      fIndex[4];
+    SkScalar fWeight[4];
+};
+
+// The taps of a run of destination columns (or rows), shared through SkResampleCache.
+class BicubicPlan : public SkRefCnt {
+public:
+    SkTDArray<BicubicTap> fTaps;
+};
+
+}
+
+// Return the taps of count destination pixels along one axis, starting at lo, where
+// destination pixel i maps to source coordinate i * scale + trans. The plan is found in
+// SkResampleCache if it has been computed before. The caller must unref it.
+static BicubicPlan* find_or_compute_plan(const SkScalar coefficients[16], int srcSize,
+                                         int lo, int count, SkScalar scale, SkScalar trans) {
+    SkResampleCache::Key key(SkResampleCache::Key::kBicubicPlan_Kind);
+    key.write(coefficients, 16 * sizeof(SkScalar));
+    key.write32(srcSize);
+    key.write32(lo);
+    key.write32(count);
+    key.write(&scale, sizeof(scale));
+    key.write(&trans, sizeof(trans));
+    key.finish();
+
+    BicubicPlan* plan = static_cast<BicubicPlan*>(SkResampleCache::Find(key));
+    if (plan) {
+        return plan;
+    }
+
+    plan = SkNEW(BicubicPlan);
+    BicubicTap* tap = plan->fTaps.append(count);
+    for (int i = lo; i < lo + count; ++i, ++tap) {
+        // The same arithmetic as SkMatrix::mapPoints() for a scale + translate matrix.
+        SkScalar src = SkScalarMulAdd(SkIntToScalar(i), scale, trans);
+        SkScalar frac = src - SkScalarFloorToScalar(src);
+        int s = SkScalarFloorToInt(src);
+        for (int k = 0; k < 4; ++k) {
+            tap->fIndex[k] = SkClampMax(s - 1 + k, srcSize - 1);
+        }
+        cubicWeights(coefficients, frac, tap->fWeight);
+    }
+    SkResampleCache::Add(key, plan, sizeof(BicubicPlan) + count * sizeof(BicubicTap));
+    return plan;
+}
+
 bool SkBicubicImageFilter::onFilterImage(Proxy* proxy,
                                          const SkBitmap& source,
                                          const SkMatrix& matrix,
@@ -110,44 +165,43 @@ bool SkBicubicImageFilter::onFilterImage(Proxy* proxy,
     inverse.setRectToRect(dstRect, srcRect, SkMatrix::kFill_ScaleToFit);
     inverse.postTranslate(SkFloatToScalar(-0.5f), SkFloatToScalar(-0.5f));
 
-    for (int y = dstIRect.fTop; y < dstIRect.fBottom; ++y) {
-        SkPMColor* dptr = result->getAddr32(dstIRect.fLeft, y);
-        for (int x = dstIRect.fLeft; x < dstIRect.fRight; ++x) {
-            SkPoint srcPt, dstPt = SkPoint::Make(SkIntToScalar(x), SkIntToScalar(y));
-            inverse.mapPoints(&srcPt, &dstPt, 1);
-            SkScalar fractx = srcPt.fX - SkScalarFloorToScalar(srcPt.fX);
-            SkScalar fracty = srcPt.fY - SkScalarFloorToScalar(srcPt.fY);
-            int sx = SkScalarFloorToInt(srcPt.fX);
-            int sy = SkScalarFloorToInt(srcPt.fY);
-            int x0 = SkClampMax(sx - 1, src.width() - 1);
-            int x1 = SkClampMax(sx    , src.width() - 1);
-            int x2 = SkClampMax(sx + 1, src.width() - 1);
-            int x3 = SkClampMax(sx + 2, src.width() - 1);
-            int y0 = SkClampMax(sy - 1, src.height() - 1);
-            int y1 = SkClampMax(sy    , src.height() - 1);
-            int y2 = SkClampMax(sy + 1, src.height() - 1);
-            int y3 = SkClampMax(sy + 2, src.height() - 1);
-            SkPMColor s00 = *src.getAddr32(x0, y0);
-            SkPMColor s10 = *src.getAddr32(x1, y0);
-            SkPMColor s20 = *src.getAddr32(x2, y0);
-            SkPMColor s30 = *src.getAddr32(x3, y0);
-            SkPMColor s0 = cubicBlend(fCoefficients, fractx, s00, s10, s20, s30);
-            SkPMColor s01 = *src.getAddr32(x0, y1);
-            SkPMColor s11 = *src.getAddr32(x1, y1);
-            SkPMColor s21 = *src.getAddr32(x2, y1);
-            SkPMColor s31 = *src.getAddr32(x3, y1);
-            SkPMColor s1 = cubicBlend(fCoefficients, fractx, s01, s11, s21, s31);
-            SkPMColor s02 = *src.getAddr32(x0, y2);
-            SkPMColor s12 = *src.getAddr32(x1, y2);
-            SkPMColor s22 = *src.getAddr32(x2, y2);
-            SkPMColor s32 = *src.getAddr32(x3, y2);
-            SkPMColor s2 = cubicBlend(fCoefficients, fractx, s02, s12, s22, s32);
-            SkPMColor s03 = *src.getAddr32(x0, y3);
-            SkPMColor s13 = *src.getAddr32(x1, y3);
-            SkPMColor s23 = *src.getAddr32(x2, y3);
-            SkPMColor s33 = *src.getAddr32(x3, y3);
-            SkPMColor s3 = cubicBlend(fCoefficients, fractx, s03, s13, s23, s33);
-            *dptr++ = cubicBlend(fCoefficients, fracty, s0, s1, s2, s3);
+    // The matrix only scales and translates, so the source pixels and weights of a
+    // destination pixel are those of its column along x, and of its row along y.
+    SkAutoTUnref<BicubicPlan> xPlan(find_or_compute_plan(fCoefficients, src.width(),
+                                                         dstIRect.fLeft, dstIRect.width(),
+                                                         inverse.getScaleX(),
+                                                         inverse.getTranslateX()));
+    SkAutoTUnref<BicubicPlan> yPlan(find_or_compute_plan(fCoefficients, src.height(),
+                                                         dstIRect.fTop, dstIRect.height(),
+                                                         inverse.getScaleY(),
+                                                         inverse.getTranslateY()));
+
+    // Source rows blended along x, for the four rows around the current destination row.
+    // Those are consecutive (or clamped to the same row), so each has its own slot.
+    int width = dstIRect.width();
+    SkAutoTMalloc<SkPMColor> blendedRows(4 * width);
+    int blendedRowIndex[4] = { -1, -1, -1, -1 };
+
+    for (int y = 0; y < dstIRect.height(); ++y) {
+        const BicubicTap& yTap = yPlan->fTaps[y];
+        const SkPMColor* rows[4];
+        for (int k = 0; k < 4; ++k) {
+            int sy = yTap.fIndex[k];
+            SkPMColor* row = blendedRows.get() + (sy & 3) * width;
+            if (blendedRowIndex[sy & 3] != sy) {
+                const SkPMColor* sptr = src.getAddr32(0, sy);
+                for (int x = 0; x < width; ++x) {
+                    const BicubicTap& xTap = xPlan->fTaps[x];
+                    row[x] = cubicBlend(xTap.fWeight, sptr[xTap.fIndex[0]], sptr[xTap.fIndex[1]],
+                                        sptr[xTap.fIndex[2]], sptr[xTap.fIndex[3]]);
+                }
+                blendedRowIndex[sy & 3] = sy;
+            }
+            rows[k] = row;
+        }
+        SkPMColor* dptr = result->getAddr32(dstIRect.fLeft, dstIRect.fTop + y);
+        for (int x = 0; x < width; ++x) {
+            *dptr++ = cubicBlend(yTap.fWeight, rows[0][x], rows[1][x], rows[2][x], rows[3][x]);
         }
     }
     return true;
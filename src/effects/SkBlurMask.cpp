@@ -8,6 +8,7 @@
 
 
 #include "SkBlurMask.h"
+#include "SkBlurImage_opts.h"
 #include "SkMath.h"
 #include "SkTemplates.h"
 #include "SkEndian.h"
@@ -278,18 +279,24 @@ static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
  *  return new_width;
  */
 
+static void getInterpScales(int radius, uint8_t outer_weight,
+                            uint32_t* outer_scale, uint32_t* inner_scale) {
+    int kernelSize = radius * 2 + 1;
+    int inner_weight = 255 - outer_weight;
+    outer_weight += outer_weight >> 7;
+    inner_weight += inner_weight >> 7;
+    *outer_scale = (outer_weight << 16) / kernelSize;
+    *inner_scale = (inner_weight << 16) / (kernelSize - 2);
+}
+
 static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
                          int radius, int width, int height,
                          bool transpose, uint8_t outer_weight)
 {
     int diameter = radius * 2;
-    int kernelSize = diameter + 1;
     int border = SkMin32(width, diameter);
-    int inner_weight = 255 - outer_weight;
-    outer_weight += outer_weight >> 7;
-    inner_weight += inner_weight >> 7;
-    uint32_t outer_scale = (outer_weight << 16) / kernelSize;
-    uint32_t inner_scale = (inner_weight << 16) / (kernelSize - 2);
+    uint32_t outer_scale, inner_scale;
+    getInterpScales(radius, outer_weight, &outer_scale, &inner_scale);
 #ifndef SK_DISABLE_BLUR_ROUNDING
     uint32_t half = 1 << 23;
 #else
@@ -491,6 +498,33 @@ bool SkBlurMask::Blur(SkMask* dst, const SkMask& src,
                                style, quality, margin);
 }
 
+// The same passes as boxBlur() and boxBlurInterp(), run by the platform proc when there is one.
+static int boxBlurPass(SkBoxBlurA8Proc proc, const uint8_t* src, int src_y_stride,
+                       uint8_t* dst, int leftRadius, int rightRadius, int width, int height,
+                       bool transpose) {
+    if (NULL == proc) {
+        return boxBlur(src, src_y_stride, dst, leftRadius, rightRadius, width, height,
+                       transpose);
+    }
+    proc(src, src_y_stride, dst, leftRadius, rightRadius, width, height, transpose,
+         (1 << 24) / (leftRadius + rightRadius + 1), 0);
+    return width + SkMax32(leftRadius, rightRadius) * 2;
+}
+
+static int boxBlurInterpPass(SkBoxBlurA8Proc proc, const uint8_t* src, int src_y_stride,
+                             uint8_t* dst, int radius, int width, int height,
+                             bool transpose, uint8_t outer_weight) {
+    if (NULL == proc) {
+        return boxBlurInterp(src, src_y_stride, dst, radius, width, height, transpose,
+                             outer_weight);
+    }
+    uint32_t outer_scale, inner_scale;
+    getInterpScales(radius, outer_weight, &outer_scale, &inner_scale);
+    proc(src, src_y_stride, dst, radius, radius, width, height, transpose,
+         outer_scale, inner_scale);
+    return width + radius * 2;
+}
+
 bool SkBlurMask::BoxBlur(SkMask* dst, const SkMask& src,
                          SkScalar sigma, Style style, Quality quality,
                          SkIPoint* margin) {
@@ -561,35 +595,36 @@ bool SkBlurMask::BoxBlur(SkMask* dst, const SkMask& src,
         uint8_t*                tp = tmpBuffer.get();
         int w = sw, h = sh;
 
+        SkBoxBlurA8Proc proc = SkBoxBlurA8GetPlatformProc();
         if (outerWeight == 255) {
             int loRadius, hiRadius;
             get_adjusted_radii(passRadius, &loRadius, &hiRadius);
             if (kHigh_Quality == quality) {
                 // Do three X blurs, with a transpose on the final one.
-                w = boxBlur(sp, src.fRowBytes, tp, loRadius, hiRadius, w, h, false);
-                w = boxBlur(tp, w,             dp, hiRadius, loRadius, w, h, false);
-                w = boxBlur(dp, w,             tp, hiRadius, hiRadius, w, h, true);
+                w = boxBlurPass(proc, sp, src.fRowBytes, tp, loRadius, hiRadius, w, h, false);
+                w = boxBlurPass(proc, tp, w,             dp, hiRadius, loRadius, w, h, false);
+                w = boxBlurPass(proc, dp, w,             tp, hiRadius, hiRadius, w, h, true);
                 // Do three Y blurs, with a transpose on the final one.
-                h = boxBlur(tp, h,             dp, loRadius, hiRadius, h, w, false);
-                h = boxBlur(dp, h,             tp, hiRadius, loRadius, h, w, false);
-                h = boxBlur(tp, h,             dp, hiRadius, hiRadius, h, w, true);
+                h = boxBlurPass(proc, tp, h,             dp, loRadius, hiRadius, h, w, false);
+                h = boxBlurPass(proc, dp, h,             tp, hiRadius, loRadius, h, w, false);
+                h = boxBlurPass(proc, tp, h,             dp, hiRadius, hiRadius, h, w, true);
             } else {
-                w = boxBlur(sp, src.fRowBytes, tp, rx, rx, w, h, true);
-                h = boxBlur(tp, h,             dp, ry, ry, h, w, true);
+                w = boxBlurPass(proc, sp, src.fRowBytes, tp, rx, rx, w, h, true);
+                h = boxBlurPass(proc, tp, h,             dp, ry, ry, h, w, true);
             }
         } else {
             if (kHigh_Quality == quality) {
                 // Do three X blurs, with a transpose on the final one.
-                w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, false, outerWeight);
-                w = boxBlurInterp(tp, w,             dp, rx, w, h, false, outerWeight);
-                w = boxBlurInterp(dp, w,             tp, rx, w, h, true, outerWeight);
+                w = boxBlurInterpPass(proc, sp, src.fRowBytes, tp, rx, w, h, false, outerWeight);
+                w = boxBlurInterpPass(proc, tp, w,             dp, rx, w, h, false, outerWeight);
+                w = boxBlurInterpPass(proc, dp, w,             tp, rx, w, h, true, outerWeight);
                 // Do three Y blurs, with a transpose on the final one.
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, false, outerWeight);
-                h = boxBlurInterp(dp, h,             tp, ry, h, w, false, outerWeight);
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight);
+                h = boxBlurInterpPass(proc, tp, h,             dp, ry, h, w, false, outerWeight);
+                h = boxBlurInterpPass(proc, dp, h,             tp, ry, h, w, false, outerWeight);
+                h = boxBlurInterpPass(proc, tp, h,             dp, ry, h, w, true, outerWeight);
             } else {
-                w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, true, outerWeight);
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight);
+                w = boxBlurInterpPass(proc, sp, src.fRowBytes, tp, rx, w, h, true, outerWeight);
+                h = boxBlurInterpPass(proc, tp, h,             dp, ry, h, w, true, outerWeight);
             }
         }
 
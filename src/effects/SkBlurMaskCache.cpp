@@ -0,0 +1,111 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBlurMaskCache.h"
+
+#ifndef SK_DEFAULT_BLUR_MASK_CACHE_LIMIT
+    #define SK_DEFAULT_BLUR_MASK_CACHE_LIMIT     (2 * 1024 * 1024)
+#endif
+
+SkBlurMaskCache::Key::Key(Kind kind, SkScalar sigma, SkBlurMask::Style style,
+                          SkBlurMask::Quality quality) {
+    this->write32(kind);
+    this->writeScalar(sigma);
+    this->write32(style);
+    this->write32(quality);
+}
+
+void SkBlurMaskCache::Key::writeA8(const uint8_t image[], size_t rowBytes,
+                                   int width, int height) {
+    size_t size = width * height;
+    uint32_t* words = this->append32(SkToS32(SkAlign4(size) >> 2));
+    uint8_t* dst = reinterpret_cast<uint8_t*>(words);
+    for (int y = 0; y < height; ++y) {
+        memcpy(dst, image, width);
+        dst += width;
+        image += rowBytes;
+    }
+    // Zero the padding, so it compares equal.
+    memset(dst, 0, SkAlign4(size) - size);
+}
+
+bool SkBlurMaskCache::find(const Key& key, SkMask* mask, SkIPoint* margin) {
+    const Value* value = fCache.find(key);
+    if (NULL == value) {
+        return false;
+    }
+
+    size_t size = value->fMask.computeImageSize();
+    uint8_t* image = SkMask::AllocImage(size);
+    memcpy(image, value->fMask.fImage, size);
+    *mask = value->fMask;
+    mask->fImage = image;
+    if (margin) {
+        *margin = value->fMargin;
+    }
+    return true;
+}
+
+void SkBlurMaskCache::add(const Key& key, const SkMask& mask, const SkIPoint& margin) {
+    SkASSERT(SkMask::kA8_Format == mask.fFormat);
+    if (NULL == mask.fImage) {
+        return;
+    }
+
+    size_t size = mask.computeImageSize();
+    Value* value = fCache.add(key, key.size() + size);
+    if (value) {
+        value->fMask = mask;
+        value->fMask.fImage = SkMask::AllocImage(size);
+        memcpy(value->fMask.fImage, mask.fImage, size);
+        value->fMargin = margin;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SkThread.h"
+
+SK_DECLARE_STATIC_MUTEX(gMutex);
+
+static SkBlurMaskCache* get_cache() {
+    static SkBlurMaskCache* gCache;
+    if (!gCache) {
+        gCache = SkNEW_ARGS(SkBlurMaskCache, (SK_DEFAULT_BLUR_MASK_CACHE_LIMIT));
+    }
+    return gCache;
+}
+
+bool SkBlurMaskCache::Find(const Key& key, SkMask* mask, SkIPoint* margin) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->find(key, mask, margin);
+}
+
+void SkBlurMaskCache::Add(const Key& key, const SkMask& mask, const SkIPoint& margin) {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->add(key, mask, margin);
+}
+
+void SkBlurMaskCache::GetStats(Stats* stats) {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->getStats(stats);
+}
+
+void SkBlurMaskCache::ResetStats() {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->resetStats();
+}
+
+size_t SkBlurMaskCache::GetByteLimit() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getByteLimit();
+}
+
+size_t SkBlurMaskCache::SetByteLimit(size_t newLimit) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->setByteLimit(newLimit);
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBlurMaskCache_DEFINED
+#define SkBlurMaskCache_DEFINED
+
+#include "SkBlurMask.h"
+#include "SkTLRUCache.h"
+
+/**
+ *  Cache of blurred A8 masks, so that drawing the same blurred shape again, wherever it is,
+ *  does not blur it again.
+ *
+ *  An entry is found by a Key that describes the blur (sigma, style, quality) and the shape,
+ *  either its geometry or the contents of the unblurred mask. Keys should not include the
+ *  integer position of the shape, and the cached masks are stored with their bounds relative
+ *  to the shape, so that blurs which only differ by translation share an entry.
+ */
+class SkBlurMaskCache {
+public:
+    class Key : public SkLRUCacheKey {
+    public:
+        enum Kind {
+            kMask_Kind,     //!< followed by the dimensions and contents of the source mask
+            kRects_Kind,    //!< followed by the geometry of a rect nine-patch
+            kRRect_Kind,    //!< followed by the geometry of a rrect nine-patch
+        };
+
+        Key(Kind, SkScalar sigma, SkBlurMask::Style, SkBlurMask::Quality);
+
+        /** Append the width x height bytes of an A8 image. */
+        void writeA8(const uint8_t image[], size_t rowBytes, int width, int height);
+    };
+
+private:
+    struct Value;
+
+public:
+    typedef SkTLRUCache<Key, Value>::Stats Stats;
+
+    /*
+     *  The following static methods are thread-safe wrappers around a global
+     *  instance of this cache.
+     */
+
+    static bool Find(const Key&, SkMask* mask, SkIPoint* margin);
+    static void Add(const Key&, const SkMask& mask, const SkIPoint& margin);
+
+    static void GetStats(Stats*);
+    static void ResetStats();
+
+    static size_t GetByteLimit();
+    static size_t SetByteLimit(size_t newLimit);
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    SkBlurMaskCache(size_t byteLimit) : fCache(byteLimit) {}
+
+    /**
+     *  Search the cache for key. If it is found, mask is set to a copy of the cached mask, which
+     *  the caller must free with SkMask::FreeImage(), margin is set to the cached margin, and
+     *  true is returned. Otherwise mask and margin are unchanged.
+     */
+    bool find(const Key&, SkMask* mask, SkIPoint* margin);
+
+    /**
+     *  Add a copy of mask to the cache.
+     */
+    void add(const Key&, const SkMask& mask, const SkIPoint& margin);
+
+    void getStats(Stats* stats) const { fCache.getStats(stats); }
+    void resetStats() { fCache.resetStats(); }
+
+    size_t getByteLimit() const { return fCache.getByteLimit(); }
+    size_t setByteLimit(size_t newLimit) { return fCache.setByteLimit(newLimit); }
+
+private:
+    struct Value {
+        Value() { fMask.fImage = NULL; }
+        ~Value() { SkMask::FreeImage(fMask.fImage); }
+
+        SkMask      fMask;
+        SkIPoint    fMargin;
+    };
+
+    SkTLRUCache<Key, Value> fCache;
+};
+
+#endif
@@ -8,9 +8,11 @@
 
 #include "SkBlurMaskFilter.h"
 #include "SkBlurMask.h"
+#include "SkBlurMaskCache.h"
 #include "SkGpuBlurUtils.h"
 #include "SkFlattenableBuffers.h"
 #include "SkMaskFilter.h"
+#include "SkRRect.h"
 #include "SkRTConf.h"
 #include "SkStringUtils.h"
 #include "SkStrokeRec.h"
@@ -52,8 +54,14 @@ protected:
                                            const SkIRect& clipBounds,
                                            NinePatch*) const SK_OVERRIDE;
 
+    virtual FilterReturn filterRRectToNine(const SkRRect&, const SkMatrix&,
+                                           const SkIRect& clipBounds,
+                                           NinePatch*) const SK_OVERRIDE;
+
     bool filterRectMask(SkMask* dstM, const SkRect& r, const SkMatrix& matrix,
                         SkIPoint* margin, SkMask::CreateMode createMode) const;
+    bool blurMask(SkMask* dst, const SkMask& src, const SkMatrix& matrix,
+                  SkIPoint* margin) const;
 
 private:
     // To avoid unseemly allocation requests (esp. for finite platforms like
@@ -75,6 +83,11 @@ private:
         return SkMinScalar(xformedSigma, kMAX_BLUR_SIGMA);
     }
 
+    SkBlurMask::Quality getQuality() const {
+        return (fBlurFlags & SkBlurMaskFilter::kHighQuality_BlurFlag) ?
+                SkBlurMask::kHigh_Quality : SkBlurMask::kLow_Quality;
+    }
+
     typedef SkMaskFilter INHERITED;
 };
 
@@ -134,14 +147,45 @@ SkMask::Format SkBlurMaskFilterImpl::getFormat() const {
 bool SkBlurMaskFilterImpl::filterMask(SkMask* dst, const SkMask& src,
                                       const SkMatrix& matrix,
                                       SkIPoint* margin) const{
-    SkScalar sigma = this->computeXformedSigma(matrix);
+    if (NULL == src.fImage || SkMask::kA8_Format != src.fFormat ||
+        src.computeImageSize() > SkBlurMaskCache::GetByteLimit() / 4) {
+        return this->blurMask(dst, src, matrix, margin);
+    }
 
-    SkBlurMask::Quality blurQuality =
-        (fBlurFlags & SkBlurMaskFilter::kHighQuality_BlurFlag) ?
-            SkBlurMask::kHigh_Quality : SkBlurMask::kLow_Quality;
+    // The blur of a mask only depends on its contents, so the same glyph or shape drawn
+    // anywhere else can reuse it.
+    SkBlurMaskCache::Key key(SkBlurMaskCache::Key::kMask_Kind,
+                             this->computeXformedSigma(matrix),
+                             (SkBlurMask::Style)fBlurStyle, this->getQuality());
+    key.write32(src.fBounds.width());
+    key.write32(src.fBounds.height());
+    key.writeA8(src.fImage, src.fRowBytes, src.fBounds.width(), src.fBounds.height());
+    key.finish();
+
+    SkIPoint blurMargin;
+    if (SkBlurMaskCache::Find(key, dst, &blurMargin)) {
+        dst->fBounds.offset(src.fBounds.fLeft, src.fBounds.fTop);
+    } else {
+        if (!this->blurMask(dst, src, matrix, &blurMargin)) {
+            return false;
+        }
+        SkMask relative = *dst;
+        relative.fBounds.offset(-src.fBounds.fLeft, -src.fBounds.fTop);
+        SkBlurMaskCache::Add(key, relative, blurMargin);
+    }
+    if (margin) {
+        *margin = blurMargin;
+    }
+    return true;
+}
+
+bool SkBlurMaskFilterImpl::blurMask(SkMask* dst, const SkMask& src,
+                                    const SkMatrix& matrix,
+                                    SkIPoint* margin) const{
+    SkScalar sigma = this->computeXformedSigma(matrix);
 
     return SkBlurMask::BoxBlur(dst, src, sigma, (SkBlurMask::Style)fBlurStyle,
-                               blurQuality, margin);
+                               this->getQuality(), margin);
 }
 
 bool SkBlurMaskFilterImpl::filterRectMask(SkMask* dst, const SkRect& r,
@@ -192,6 +236,48 @@ static bool drawRectsIntoMask(const SkRect rects[], int count, SkMask* mask) {
     return true;
 }
 
+// Writes edge as its integer offset from origin and its fractional part, so that rects
+// which only differ by an integer translation have the same key.
+static void write_edge(SkBlurMaskCache::Key* key, SkScalar edge, int origin) {
+    SkScalar floorEdge = SkScalarFloorToScalar(edge);
+    key->write32(SkScalarFloorToInt(edge) - origin);
+    key->writeScalar(edge - floorEdge);
+}
+
+static void write_rect(SkBlurMaskCache::Key* key, const SkRect& r, const SkIPoint& origin) {
+    write_edge(key, r.fLeft, origin.fX);
+    write_edge(key, r.fTop, origin.fY);
+    write_edge(key, r.fRight, origin.fX);
+    write_edge(key, r.fBottom, origin.fY);
+}
+
+static bool draw_rrect_into_mask(const SkRRect& rrect, SkMask* mask) {
+    rrect.rect().roundOut(&mask->fBounds);
+    mask->fRowBytes = SkAlign4(mask->fBounds.width());
+    mask->fFormat = SkMask::kA8_Format;
+    size_t size = mask->computeImageSize();
+    mask->fImage = SkMask::AllocImage(size);
+    if (NULL == mask->fImage) {
+        return false;
+    }
+    sk_bzero(mask->fImage, size);
+
+    SkBitmap bitmap;
+    bitmap.setConfig(SkBitmap::kA8_Config,
+                     mask->fBounds.width(), mask->fBounds.height(),
+                     mask->fRowBytes);
+    bitmap.setPixels(mask->fImage);
+
+    SkCanvas canvas(bitmap);
+    canvas.translate(-SkIntToScalar(mask->fBounds.left()),
+                     -SkIntToScalar(mask->fBounds.top()));
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    canvas.drawRRect(rrect, paint);
+    return true;
+}
+
 static bool rect_exceeds(const SkRect& r, SkScalar v) {
     return r.fLeft < -v || r.fTop < -v || r.fRight > v || r.fBottom > v ||
            r.width() > v || r.height() > v;
@@ -301,25 +387,167 @@ SkBlurMaskFilterImpl::filterRectsToNine(const SkRect rects[], int count,
         SkASSERT(!smallR[1].isEmpty());
     }
 
-    if (count > 1 || !c_analyticBlurNinepatch) {
-        if (!drawRectsIntoMask(smallR, count, &srcM)) {
-            return kFalse_FilterReturn;
+    const bool analytic = 1 == count && c_analyticBlurNinepatch;
+    SkBlurMaskCache::Key key(SkBlurMaskCache::Key::kRects_Kind,
+                             this->computeXformedSigma(matrix),
+                             (SkBlurMask::Style)fBlurStyle, this->getQuality());
+    key.write32(count);
+    key.write32(analytic);
+    const SkIPoint origin = SkIPoint::Make(SkScalarFloorToInt(smallR[0].fLeft),
+                                           SkScalarFloorToInt(smallR[0].fTop));
+    for (int i = 0; i < count; ++i) {
+        write_rect(&key, smallR[i], origin);
+    }
+    key.finish();
+
+    if (!SkBlurMaskCache::Find(key, &patch->fMask, NULL)) {
+        if (!analytic) {
+            if (!drawRectsIntoMask(smallR, count, &srcM)) {
+                return kFalse_FilterReturn;
+            }
+
+            SkAutoMaskFreeImage amf(srcM.fImage);
+
+            if (!this->blurMask(&patch->fMask, srcM, matrix, &margin)) {
+                return kFalse_FilterReturn;
+            }
+        } else {
+            if (!this->filterRectMask(&patch->fMask, smallR[0], matrix, &margin,
+                                      SkMask::kComputeBoundsAndRenderImage_CreateMode)) {
+                return kFalse_FilterReturn;
+            }
         }
+        patch->fMask.fBounds.offsetTo(0, 0);
+        SkBlurMaskCache::Add(key, patch->fMask, margin);
+    }
+    patch->fOuterRect = dstM.fBounds;
+    patch->fCenter = center;
+    return kTrue_FilterReturn;
+}
 
-        SkAutoMaskFreeImage amf(srcM.fImage);
+SkMaskFilter::FilterReturn
+SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& matrix,
+                                        const SkIRect& clipBounds,
+                                        NinePatch* patch) const {
+    switch (rrect.getType()) {
+        case SkRRect::kUnknown_Type:
+            // Unknown should never be returned.
+            SkASSERT(false);
+            // Fall through.
+        case SkRRect::kEmpty_Type:
+            // Nothing to draw.
+            return kFalse_FilterReturn;
+
+        case SkRRect::kRect_Type:
+            // SkCanvas draws these as rects.
+        case SkRRect::kOval_Type:
+            // There is no straight edge to stretch.
+            return kUnimplemented_FilterReturn;
+
+        case SkRRect::kSimple_Type:
+        case SkRRect::kComplex_Type:
+            break;
+    }
+
+    // TODO: report correct metrics for innerstyle, where we do not grow the
+    // total bounds, but we do need an inset the size of our blur-radius
+    if (SkBlurMaskFilter::kInner_BlurStyle == fBlurStyle) {
+        return kUnimplemented_FilterReturn;
+    }
+
+    const SkRect& rect = rrect.rect();
+    // TODO: take clipBounds into account to limit our coordinates up front
+    // for now, just skip too-large src rects (to take the old code path).
+    if (rect_exceeds(rect, SkIntToScalar(32767))) {
+        return kUnimplemented_FilterReturn;
+    }
 
-        if (!this->filterMask(&patch->fMask, srcM, matrix, &margin)) {
+    SkIPoint margin;
+    SkMask  srcM, dstM;
+    rect.roundOut(&srcM.fBounds);
+    srcM.fImage = NULL;
+    srcM.fFormat = SkMask::kA8_Format;
+    srcM.fRowBytes = 0;
+
+    // don't actually do the blur, just compute the correct size
+    if (!this->blurMask(&dstM, srcM, matrix, &margin)) {
+        return kFalse_FilterReturn;
+    }
+
+    /*
+     *  The small rrect keeps the corners, and enough of the straight edges
+     *  between them that the blur of each corner (reaching 2 * margin in from
+     *  the curve's end) is followed by a column/row that only sees the edges.
+     *  +3 covers a fractional edge on either side, and that 1 center col/row.
+     */
+    SkVector radii[4];
+    for (int i = 0; i < 4; ++i) {
+        radii[i] = rrect.radii((SkRRect::Corner)i);
+    }
+    const SkScalar leftUnstretched = SkMaxScalar(radii[SkRRect::kUpperLeft_Corner].fX,
+                                                 radii[SkRRect::kLowerLeft_Corner].fX) +
+                                     SkIntToScalar(2 * margin.fX);
+    const SkScalar rightUnstretched = SkMaxScalar(radii[SkRRect::kUpperRight_Corner].fX,
+                                                  radii[SkRRect::kLowerRight_Corner].fX) +
+                                      SkIntToScalar(2 * margin.fX);
+    const SkScalar topUnstretched = SkMaxScalar(radii[SkRRect::kUpperLeft_Corner].fY,
+                                                radii[SkRRect::kUpperRight_Corner].fY) +
+                                    SkIntToScalar(2 * margin.fY);
+    const SkScalar bottomUnstretched = SkMaxScalar(radii[SkRRect::kLowerLeft_Corner].fY,
+                                                   radii[SkRRect::kLowerRight_Corner].fY) +
+                                       SkIntToScalar(2 * margin.fY);
+    const SkScalar stretchSize = SkIntToScalar(3);
+
+    const SkScalar extraW = rect.width() - (leftUnstretched + rightUnstretched + stretchSize);
+    const SkScalar extraH = rect.height() - (topUnstretched + bottomUnstretched + stretchSize);
+    if (extraW < 0 || extraH < 0) {
+        // we're too small, relative to our blur and radii, to break into
+        // nine-patch, so we ask to have our normal filterMask() be called.
+        return kUnimplemented_FilterReturn;
+    }
+
+    // Shrink by whole pixels, so that no edge changes its fractional phase.
+    const SkScalar dx = SkScalarFloorToScalar(extraW);
+    const SkScalar dy = SkScalarFloorToScalar(extraH);
+    SkRect smallR = rect;
+    smallR.fRight -= dx;
+    smallR.fBottom -= dy;
+
+    SkBlurMaskCache::Key key(SkBlurMaskCache::Key::kRRect_Kind,
+                             this->computeXformedSigma(matrix),
+                             (SkBlurMask::Style)fBlurStyle, this->getQuality());
+    write_rect(&key, smallR, SkIPoint::Make(SkScalarFloorToInt(smallR.fLeft),
+                                            SkScalarFloorToInt(smallR.fTop)));
+    for (int i = 0; i < 4; ++i) {
+        key.writeScalar(radii[i].fX);
+        key.writeScalar(radii[i].fY);
+    }
+    key.finish();
+
+    if (!SkBlurMaskCache::Find(key, &patch->fMask, NULL)) {
+        SkRRect smallRR;
+        smallRR.setRectRadii(smallR, radii);
+        if (!draw_rrect_into_mask(smallRR, &srcM)) {
             return kFalse_FilterReturn;
         }
-    } else {
-        if (!this->filterRectMask(&patch->fMask, smallR[0], matrix, &margin,
-                                  SkMask::kComputeBoundsAndRenderImage_CreateMode)) {
+
+        SkAutoMaskFreeImage amf(srcM.fImage);
+
+        if (!this->blurMask(&patch->fMask, srcM, matrix, &margin)) {
             return kFalse_FilterReturn;
         }
+        patch->fMask.fBounds.offsetTo(0, 0);
+        SkBlurMaskCache::Add(key, patch->fMask, margin);
     }
-    patch->fMask.fBounds.offsetTo(0, 0);
+
+    // The mask starts margin to the left of (and above) the rrect's first
+    // pixel, so the first column/row only touched by the edges is at
+    // fraction + unstretched.
     patch->fOuterRect = dstM.fBounds;
-    patch->fCenter = center;
+    patch->fCenter.set(SkScalarCeilToInt(rect.fLeft - SkScalarFloorToScalar(rect.fLeft) +
+                                         leftUnstretched),
+                       SkScalarCeilToInt(rect.fTop - SkScalarFloorToScalar(rect.fTop) +
+                                         topUnstretched));
     return kTrue_FilterReturn;
 }
 
@@ -125,6 +125,11 @@ bool SkColorFilterImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& sourc
     return true;
 }
 
+bool SkColorFilterImageFilter::onFilterInputBounds(const SkIRect& dst, const SkMatrix& ctm,
+                                                   SkIRect* src) {
+    return this->inputsFilterInputBounds(dst, ctm, src);
+}
+
 bool SkColorFilterImageFilter::asColorFilter(SkColorFilter** filter) const {
     if (cropRect().isLargest()) {
         if (filter) {
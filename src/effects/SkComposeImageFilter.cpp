@@ -52,5 +52,24 @@ bool SkComposeImageFilter::onFilterBounds(const SkIRect& src,
            outer->filterBounds(tmp, ctm, dst);
 }
 
+bool SkComposeImageFilter::onFilterInputBounds(const SkIRect& dst,
+                                               const SkMatrix& ctm,
+                                               SkIRect* src) {
+    SkImageFilter* outer = getInput(0);
+    SkImageFilter* inner = getInput(1);
+
+    if (!outer && !inner) {
+        return false;
+    }
+
+    if (!outer || !inner) {
+        return (outer ? outer : inner)->filterInputBounds(dst, ctm, src);
+    }
+
+    SkIRect tmp;
+    return outer->filterInputBounds(dst, ctm, &tmp) &&
+           inner->filterInputBounds(tmp, ctm, src);
+}
+
 SkComposeImageFilter::SkComposeImageFilter(SkFlattenableReadBuffer& buffer) : INHERITED(buffer) {
 }
@@ -10,6 +10,7 @@
 #include "SkDashPathEffect.h"
 #include "SkFlattenableBuffers.h"
 #include "SkPathMeasure.h"
+#include "SkStroke.h"
 
 static inline int is_even(int x) {
     return (~x) << 31;
@@ -89,13 +90,7 @@ SkDashPathEffect::~SkDashPathEffect() {
 }
 
 static void outset_for_stroke(SkRect* rect, const SkStrokeRec& rec) {
-    SkScalar radius = SkScalarHalf(rec.getWidth());
-    if (0 == radius) {
-        radius = SK_Scalar1;    // hairlines
-    }
-    if (SkPaint::kMiter_Join == rec.getJoin()) {
-        radius = SkScalarMul(radius, rec.getMiter());
-    }
+    SkScalar radius = rec.getInflationRadius();
     rect->outset(radius, radius);
 }
 
@@ -228,8 +223,128 @@ private:
     SkScalar fPathLength;
 };
 
+// Takes the dashes of paths that SpecialLineRec does not handle, one at a time,
+// so that the whole dashed path is never built. Dashes that are outside of the
+// cull rect are dropped, and if the paint strokes (and the caller lets us), the
+// dashes are stroked in small batches (stroking contours together is the same
+// as stroking them one at a time, but cheaper) and only their outlines are
+// added to the result.
+class DashSegmentRec {
+public:
+    bool init(const SkStrokeRec& rec, const SkRect* cullRect, bool canStroke) {
+        fStroking = canStroke && SkStrokeRec::kStroke_Style == rec.getStyle();
+        if (!fStroking && NULL == cullRect) {
+            return false;
+        }
+
+        fCullRect = cullRect;
+        fOutset = rec.getInflationRadius();
+        if (fStroking) {
+            fStroke.setCap(rec.getCap());
+            fStroke.setJoin(rec.getJoin());
+            fStroke.setMiterLimit(rec.getMiter());
+            fStroke.setWidth(rec.getWidth());
+            // each dash is only stroked once
+            fStroke.setUseCache(false);
+        }
+        return true;
+    }
+
+    // If the dashes were stroked, the caller must not stroke them again.
+    bool isStroking() const { return fStroking; }
+
+    // The current dash, for SkPathMeasure::getSegment() to append to. Without
+    // a cull rect, there is nothing to check it for, so it goes straight into
+    // the batch.
+    SkPath* dash() { return fCullRect ? &fDash : &fBatch; }
+
+    // Return true if the dash from distance to distance + length certainly
+    // misses the cull rect, and need not be measured out: none of its points
+    // are further from its start than its length.
+    bool cull(SkPathMeasure& meas, SkScalar distance, SkScalar length) const {
+        if (NULL == fCullRect) {
+            return false;
+        }
+        SkPoint start;
+        if (!meas.getPosTan(distance, &start, NULL)) {
+            return false;
+        }
+        SkScalar reach = length + fOutset;
+        return start.fX < fCullRect->fLeft - reach || start.fX > fCullRect->fRight + reach ||
+               start.fY < fCullRect->fTop - reach || start.fY > fCullRect->fBottom + reach;
+    }
+
+    // Add the current dash (or its outline) to path, unless it is culled.
+    void flush(SkPath* path) {
+        if (NULL == fCullRect) {
+            if (fBatch.countPoints() >= kMaxBatchPoints) {
+                this->strokeBatch(path);
+            }
+            return;
+        }
+        if (fDash.isEmpty()) {
+            return;
+        }
+        SkRect bounds = fDash.getBounds();
+        bounds.outset(fOutset, fOutset);
+        if (SkRect::Intersects(bounds, *fCullRect)) {
+            if (fStroking) {
+                fBatch.addPath(fDash);
+                if (fBatch.countPoints() >= kMaxBatchPoints) {
+                    this->strokeBatch(path);
+                }
+            } else {
+                path->addPath(fDash);
+            }
+        }
+        fDash.rewind();
+    }
+
+    // Add the last dash, and the outlines of any that are still batched, to path.
+    void finish(SkPath* path) {
+        this->flush(path);
+        if (fStroking) {
+            this->strokeBatch(path);
+        }
+    }
+
+private:
+    enum {
+        kMaxBatchPoints = 256
+    };
+
+    SkStroke        fStroke;
+    SkPath          fDash;
+    SkPath          fBatch;     // the dashes that have not been stroked yet
+    SkPath          fStroked;
+    const SkRect*   fCullRect;
+    SkScalar        fOutset;
+    bool            fStroking;
+
+    void strokeBatch(SkPath* path) {
+        if (fBatch.isEmpty()) {
+            return;
+        }
+        fStroke.strokePath(fBatch, &fStroked);
+        path->addPath(fStroked);
+        fBatch.rewind();
+    }
+};
+
 bool SkDashPathEffect::filterPath(SkPath* dst, const SkPath& src,
                               SkStrokeRec* rec, const SkRect* cullRect) const {
+    // We may be one of the effects of an SkComposePathEffect or SkSumPathEffect,
+    // whose other effects expect the dashes, and the rec, as they were.
+    return this->dashPath(dst, src, rec, cullRect, false);
+}
+
+bool SkDashPathEffect::filterAndStrokePath(SkPath* dst, const SkPath& src,
+                                           SkStrokeRec* rec, const SkRect* cullRect) const {
+    return this->dashPath(dst, src, rec, cullRect, true);
+}
+
+bool SkDashPathEffect::dashPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec,
+                                const SkRect* cullRect, bool strokeDashes) const {
     // we do nothing if the src wants to be filled, or if our dashlength is 0
     if (rec->isFillStyle() || fInitialDashLength < 0) {
         return false;
@@ -248,6 +363,9 @@ bool SkDashPathEffect::filterPath(SkPath* dst, const SkPath& src,
     SpecialLineRec lineRec;
     bool specialLine = lineRec.init(*srcPtr, dst, rec, fCount >> 1, fIntervalLength);
 
+    DashSegmentRec segmentRec;
+    bool bySegment = !specialLine && segmentRec.init(*rec, cullRect, strokeDashes);
+
     SkPathMeasure   meas(*srcPtr, false);
 
     do {
@@ -298,6 +416,14 @@ bool SkDashPathEffect::filterPath(SkPath* dst, const SkPath& src,
                     lineRec.addSegment(SkDoubleToScalar(distance),
                                        SkDoubleToScalar(distance + dlen),
                                        dst);
+                } else if (bySegment) {
+                    segmentRec.flush(dst);
+                    if (!segmentRec.cull(meas, SkDoubleToScalar(distance),
+                                         SkDoubleToScalar(dlen))) {
+                        meas.getSegment(SkDoubleToScalar(distance),
+                                        SkDoubleToScalar(distance + dlen),
+                                        segmentRec.dash(), true);
+                    }
                 } else {
                     meas.getSegment(SkDoubleToScalar(distance),
                                     SkDoubleToScalar(distance + dlen),
@@ -323,11 +449,31 @@ bool SkDashPathEffect::filterPath(SkPath* dst, const SkPath& src,
         // extend if we ended on a segment and we need to join up with the (skipped) initial segment
         if (meas.isClosed() && is_even(fInitialDashIndex) &&
                 fInitialDashLength > 0) {
-            meas.getSegment(0, SkScalarMul(fInitialDashLength, scale), dst, !addedSegment);
+            SkPath* segDst = dst;
+            bool startWithMoveTo = !addedSegment;
+            if (bySegment) {
+                if (!addedSegment) {
+                    segmentRec.flush(dst);
+                }
+                segDst = segmentRec.dash();
+                if (segDst->isEmpty()) {
+                    // the dash we ended on was culled
+                    startWithMoveTo = true;
+                }
+            }
+            meas.getSegment(0, SkScalarMul(fInitialDashLength, scale), segDst, startWithMoveTo);
             ++segCount;
         }
     } while (meas.nextContour());
 
+    if (bySegment) {
+        segmentRec.finish(dst);
+        if (segmentRec.isStroking()) {
+            // we took care of the stroking
+            rec->setFillStyle();
+        }
+    }
+
     if (segCount > 1) {
         dst->setConvexity(SkPath::kConcave_Convexity);
     }
@@ -195,6 +195,15 @@ bool SkDisplacementMapEffect::onFilterImage(Proxy* proxy,
     return true;
 }
 
+bool SkDisplacementMapEffect::onFilterInputBounds(const SkIRect& dst, const SkMatrix& ctm,
+                                                  SkIRect* src) {
+    // Pixels are displaced by at most half the scale, plus one for the truncation.
+    int margin = SkScalarCeilToInt(SkScalarHalf(SkScalarAbs(fScale))) + 1;
+    SkIRect needed = dst;
+    needed.outset(margin, margin);
+    return this->inputsFilterInputBounds(needed, ctm, src);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #if SK_SUPPORT_GPU
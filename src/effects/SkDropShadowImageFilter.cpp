@@ -60,3 +60,13 @@ bool SkDropShadowImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& source
     *result = device->accessBitmap(false);
     return true;
 }
+
+bool SkDropShadowImageFilter::onFilterInputBounds(const SkIRect& dst, const SkMatrix& ctm,
+                                                  SkIRect* src)
+{
+    SkIRect needed = dst;
+    needed.outset(SkScalarCeilToInt(SkScalarAbs(fDx)), SkScalarCeilToInt(SkScalarAbs(fDy)));
+    SkAutoTUnref<SkImageFilter> blurFilter(new SkBlurImageFilter(fSigma, fSigma));
+    return blurFilter->filterInputBounds(needed, ctm, &needed) &&
+           this->inputsFilterInputBounds(needed, ctm, src);
+}
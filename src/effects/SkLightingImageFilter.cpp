@@ -9,8 +9,10 @@
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
 #include "SkFlattenableBuffers.h"
+#include "SkLighting_opts.h"
 #include "SkOrderedReadBuffer.h"
 #include "SkOrderedWriteBuffer.h"
+#include "SkTemplates.h"
 #include "SkTypes.h"
 
 #if SK_SUPPORT_GPU
@@ -106,141 +108,148 @@ inline SkPoint3 pointToNormal(SkScalar x, SkScalar y, SkScalar surfaceScale) {
     return vector;
 }
 
-inline SkPoint3 topLeftNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(0, 0, m[4], m[5], m[7], m[8], gTwoThirds),
-                         sobel(0, 0, m[4], m[7], m[5], m[8], gTwoThirds),
-                         surfaceScale);
+inline SkPoint topLeftGradient(int m[9]) {
+    return SkPoint::Make(sobel(0, 0, m[4], m[5], m[7], m[8], gTwoThirds),
+                         sobel(0, 0, m[4], m[7], m[5], m[8], gTwoThirds));
 }
 
-inline SkPoint3 topNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(   0,    0, m[3], m[5], m[6], m[8], gOneThird),
-                         sobel(m[3], m[6], m[4], m[7], m[5], m[8], gOneHalf),
-                         surfaceScale);
+inline SkPoint topGradient(int m[9]) {
+    return SkPoint::Make(sobel(   0,    0, m[3], m[5], m[6], m[8], gOneThird),
+                         sobel(m[3], m[6], m[4], m[7], m[5], m[8], gOneHalf));
 }
 
-inline SkPoint3 topRightNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(   0,    0, m[3], m[4], m[6], m[7], gTwoThirds),
-                         sobel(m[3], m[6], m[4], m[7],    0,    0, gTwoThirds),
-                         surfaceScale);
+inline SkPoint topRightGradient(int m[9]) {
+    return SkPoint::Make(sobel(   0,    0, m[3], m[4], m[6], m[7], gTwoThirds),
+                         sobel(m[3], m[6], m[4], m[7],    0,    0, gTwoThirds));
 }
 
-inline SkPoint3 leftNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(m[1], m[2], m[4], m[5], m[7], m[8], gOneHalf),
-                         sobel(   0,    0, m[1], m[7], m[2], m[8], gOneThird),
-                         surfaceScale);
+inline SkPoint leftGradient(int m[9]) {
+    return SkPoint::Make(sobel(m[1], m[2], m[4], m[5], m[7], m[8], gOneHalf),
+                         sobel(   0,    0, m[1], m[7], m[2], m[8], gOneThird));
 }
 
 
-inline SkPoint3 interiorNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(m[0], m[2], m[3], m[5], m[6], m[8], gOneQuarter),
-                         sobel(m[0], m[6], m[1], m[7], m[2], m[8], gOneQuarter),
-                         surfaceScale);
+inline SkPoint interiorGradient(int m[9]) {
+    return SkPoint::Make(sobel(m[0], m[2], m[3], m[5], m[6], m[8], gOneQuarter),
+                         sobel(m[0], m[6], m[1], m[7], m[2], m[8], gOneQuarter));
 }
 
-inline SkPoint3 rightNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(m[0], m[1], m[3], m[4], m[6], m[7], gOneHalf),
-                         sobel(m[0], m[6], m[1], m[7],    0,    0, gOneThird),
-                         surfaceScale);
+inline SkPoint rightGradient(int m[9]) {
+    return SkPoint::Make(sobel(m[0], m[1], m[3], m[4], m[6], m[7], gOneHalf),
+                         sobel(m[0], m[6], m[1], m[7],    0,    0, gOneThird));
 }
 
-inline SkPoint3 bottomLeftNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(m[1], m[2], m[4], m[5],    0,    0, gTwoThirds),
-                         sobel(   0,    0, m[1], m[4], m[2], m[5], gTwoThirds),
-                         surfaceScale);
+inline SkPoint bottomLeftGradient(int m[9]) {
+    return SkPoint::Make(sobel(m[1], m[2], m[4], m[5],    0,    0, gTwoThirds),
+                         sobel(   0,    0, m[1], m[4], m[2], m[5], gTwoThirds));
 }
 
-inline SkPoint3 bottomNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(m[0], m[2], m[3], m[5],    0,    0, gOneThird),
-                         sobel(m[0], m[3], m[1], m[4], m[2], m[5], gOneHalf),
-                         surfaceScale);
+inline SkPoint bottomGradient(int m[9]) {
+    return SkPoint::Make(sobel(m[0], m[2], m[3], m[5],    0,    0, gOneThird),
+                         sobel(m[0], m[3], m[1], m[4], m[2], m[5], gOneHalf));
 }
 
-inline SkPoint3 bottomRightNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(m[0], m[1], m[3], m[4], 0,  0, gTwoThirds),
-                         sobel(m[0], m[3], m[1], m[4], 0,  0, gTwoThirds),
-                         surfaceScale);
+inline SkPoint bottomRightGradient(int m[9]) {
+    return SkPoint::Make(sobel(m[0], m[1], m[3], m[4], 0,  0, gTwoThirds),
+                         sobel(m[0], m[3], m[1], m[4], 0,  0, gTwoThirds));
 }
 
-template <class LightingType, class LightType> void lightBitmap(const LightingType& lightingType, const SkLight* light, const SkBitmap& src, SkBitmap* dst, SkScalar surfaceScale, const SkIRect& bounds) {
-    SkASSERT(dst->width() == bounds.width() && dst->height() == bounds.height());
-    const LightType* l = static_cast<const LightType*>(light);
-    int left = bounds.left(), right = bounds.right();
-    int bottom = bounds.bottom();
-    int y = bounds.top();
-    SkPMColor* dptr = dst->getAddr32(0, 0);
-    {
-        int x = left;
-        const SkPMColor* row1 = src.getAddr32(x, y);
-        const SkPMColor* row2 = src.getAddr32(x, y + 1);
-        int m[9];
-        m[4] = SkGetPackedA32(*row1++);
-        m[5] = SkGetPackedA32(*row1++);
-        m[7] = SkGetPackedA32(*row2++);
-        m[8] = SkGetPackedA32(*row2++);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(topLeftNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x)
-        {
-            shiftMatrixLeft(m);
-            m[5] = SkGetPackedA32(*row1++);
-            m[8] = SkGetPackedA32(*row2++);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(topNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
-        }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(topRightNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
-    }
+// The kernels for the top, middle and bottom rows of the bounds.
+struct TopRow {
+    static SkPoint Left(int m[9]) { return topLeftGradient(m); }
+    static SkPoint Interior(int m[9]) { return topGradient(m); }
+    static SkPoint Right(int m[9]) { return topRightGradient(m); }
+};
+
+struct MiddleRow {
+    static SkPoint Left(int m[9]) { return leftGradient(m); }
+    static SkPoint Interior(int m[9]) { return interiorGradient(m); }
+    static SkPoint Right(int m[9]) { return rightGradient(m); }
+};
+
+struct BottomRow {
+    static SkPoint Left(int m[9]) { return bottomLeftGradient(m); }
+    static SkPoint Interior(int m[9]) { return bottomGradient(m); }
+    static SkPoint Right(int m[9]) { return bottomRightGradient(m); }
+};
 
-    for (++y; y < bottom - 1; ++y) {
-        int x = left;
-        const SkPMColor* row0 = src.getAddr32(x, y - 1);
-        const SkPMColor* row1 = src.getAddr32(x, y);
-        const SkPMColor* row2 = src.getAddr32(x, y + 1);
-        int m[9];
-        m[1] = SkGetPackedA32(*row0++);
+// Computes the Sobel gradients of the alpha channel, and the alpha, of the width pixels of
+// row1. At the top and bottom of the bounds, row0 or row2 may point at row1 instead, as the
+// edge kernels ignore the row that is outside.
+template <class Row> void gradientRow(const SkPMColor* row0, const SkPMColor* row1,
+                                      const SkPMColor* row2, int width,
+                                      float gradientX[], float gradientY[], int alpha[]) {
+    int m[9];
+    m[1] = SkGetPackedA32(*row0++);
+    m[2] = SkGetPackedA32(*row0++);
+    m[4] = SkGetPackedA32(*row1++);
+    m[5] = SkGetPackedA32(*row1++);
+    m[7] = SkGetPackedA32(*row2++);
+    m[8] = SkGetPackedA32(*row2++);
+    SkPoint gradient = Row::Left(m);
+    gradientX[0] = SkScalarToFloat(gradient.fX);
+    gradientY[0] = SkScalarToFloat(gradient.fY);
+    alpha[0] = m[4];
+    int x;
+    for (x = 1; x < width - 1; ++x) {
+        shiftMatrixLeft(m);
         m[2] = SkGetPackedA32(*row0++);
-        m[4] = SkGetPackedA32(*row1++);
         m[5] = SkGetPackedA32(*row1++);
-        m[7] = SkGetPackedA32(*row2++);
         m[8] = SkGetPackedA32(*row2++);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(leftNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x) {
-            shiftMatrixLeft(m);
-            m[2] = SkGetPackedA32(*row0++);
-            m[5] = SkGetPackedA32(*row1++);
-            m[8] = SkGetPackedA32(*row2++);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(interiorNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
-        }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(rightNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
+        gradient = Row::Interior(m);
+        gradientX[x] = SkScalarToFloat(gradient.fX);
+        gradientY[x] = SkScalarToFloat(gradient.fY);
+        alpha[x] = m[4];
+    }
+    shiftMatrixLeft(m);
+    gradient = Row::Right(m);
+    gradientX[x] = SkScalarToFloat(gradient.fX);
+    gradientY[x] = SkScalarToFloat(gradient.fY);
+    alpha[x] = m[4];
+}
+
+// The portable version of SkLightingRowProc.
+template <class LightingType, class LightType> void lightRow(const LightingType& lightingType, const LightType* l, const float gradientX[], const float gradientY[], const int alpha[], int x, int y, int count, SkScalar surfaceScale, SkPMColor dst[]) {
+    for (int i = 0; i < count; ++i) {
+        SkPoint3 normal = pointToNormal(SkFloatToScalar(gradientX[i]),
+                                        SkFloatToScalar(gradientY[i]), surfaceScale);
+        SkPoint3 surfaceToLight = l->surfaceToLight(x + i, y, alpha[i], surfaceScale);
+        dst[i] = lightingType.light(normal, surfaceToLight, l->lightColor(surfaceToLight));
     }
+}
 
-    {
-        int x = left;
-        const SkPMColor* row0 = src.getAddr32(x, bottom - 2);
-        const SkPMColor* row1 = src.getAddr32(x, bottom - 1);
-        int m[9];
-        m[1] = SkGetPackedA32(*row0++);
-        m[2] = SkGetPackedA32(*row0++);
-        m[4] = SkGetPackedA32(*row1++);
-        m[5] = SkGetPackedA32(*row1++);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(bottomLeftNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x)
-        {
-            shiftMatrixLeft(m);
-            m[2] = SkGetPackedA32(*row0++);
-            m[5] = SkGetPackedA32(*row1++);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(bottomNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
+// Lights the bounds of src a row at a time: the normals of a row are computed first, then the
+// whole row is lit, by proc if it is not NULL.
+template <class LightingType, class LightType> void lightBitmap(const LightingType& lightingType, const SkLight* light, const SkBitmap& src, SkBitmap* dst, SkScalar surfaceScale, const SkIRect& bounds, SkLightingRowProc proc, const SkLightingParams& params) {
+    SkASSERT(dst->width() == bounds.width() && dst->height() == bounds.height());
+    SkASSERT(bounds.width() >= 2 && bounds.height() >= 2);
+    const LightType* l = static_cast<const LightType*>(light);
+    int left = bounds.left(), top = bounds.top(), bottom = bounds.bottom();
+    int width = bounds.width();
+    SkAutoTMalloc<float> storage(2 * width);
+    SkAutoTMalloc<int> alpha(width);
+    float* gradientX = storage.get();
+    float* gradientY = gradientX + width;
+    for (int y = top; y < bottom; ++y) {
+        const SkPMColor* row1 = src.getAddr32(left, y);
+        if (y == top) {
+            gradientRow<TopRow>(row1, row1, src.getAddr32(left, y + 1), width,
+                                gradientX, gradientY, alpha.get());
+        } else if (y == bottom - 1) {
+            gradientRow<BottomRow>(src.getAddr32(left, y - 1), row1, row1, width,
+                                   gradientX, gradientY, alpha.get());
+        } else {
+            gradientRow<MiddleRow>(src.getAddr32(left, y - 1), row1,
+                                   src.getAddr32(left, y + 1), width,
+                                   gradientX, gradientY, alpha.get());
+        }
+        SkPMColor* dptr = dst->getAddr32(0, y - top);
+        if (proc) {
+            proc(params, gradientX, gradientY, alpha.get(), left, y, width, dptr);
+        } else {
+            lightRow<LightingType, LightType>(lightingType, l, gradientX, gradientY, alpha.get(),
+                                              left, y, width, surfaceScale, dptr);
         }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(bottomRightNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
     }
 }
 
@@ -790,6 +799,52 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Returns the platform proc that lights rows with light, and sets params for it, or returns
+// NULL if the portable code should be used.
+static SkLightingRowProc get_lighting_row_proc(const SkLight* light, SkLightingType lightingType,
+                                               SkScalar surfaceScale, SkScalar k,
+                                               SkScalar shininess, SkLightingParams* params) {
+    SkLightingLightType lightType;
+    SkPoint3 lightPoint;
+    switch (light->type()) {
+        case SkLight::kDistant_LightType:
+            lightType = kDistant_SkLightingLightType;
+            lightPoint = static_cast<const SkDistantLight*>(light)->direction();
+            break;
+        case SkLight::kPoint_LightType:
+            lightType = kPoint_SkLightingLightType;
+            lightPoint = static_cast<const SkPointLight*>(light)->location();
+            break;
+        case SkLight::kSpot_LightType: {
+            lightType = kSpot_SkLightingLightType;
+            const SkSpotLight* spot = static_cast<const SkSpotLight*>(light);
+            lightPoint = spot->location();
+            params->fS[0] = SkScalarToFloat(spot->s().fX);
+            params->fS[1] = SkScalarToFloat(spot->s().fY);
+            params->fS[2] = SkScalarToFloat(spot->s().fZ);
+            params->fSpecularExponent = SkScalarToFloat(spot->specularExponent());
+            params->fCosOuterConeAngle = SkScalarToFloat(spot->cosOuterConeAngle());
+            params->fCosInnerConeAngle = SkScalarToFloat(spot->cosInnerConeAngle());
+            params->fConeScale = SkScalarToFloat(spot->coneScale());
+            break;
+        }
+        default:
+            return NULL;
+    }
+    params->fSurfaceScale = SkScalarToFloat(surfaceScale);
+    params->fLight[0] = SkScalarToFloat(lightPoint.fX);
+    params->fLight[1] = SkScalarToFloat(lightPoint.fY);
+    params->fLight[2] = SkScalarToFloat(lightPoint.fZ);
+    params->fColor[0] = SkScalarToFloat(light->color().fX);
+    params->fColor[1] = SkScalarToFloat(light->color().fY);
+    params->fColor[2] = SkScalarToFloat(light->color().fZ);
+    params->fK = SkScalarToFloat(k);
+    params->fShininess = SkScalarToFloat(shininess);
+    return SkLightingGetPlatformProc(lightType, lightingType);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 SkLightingImageFilter::SkLightingImageFilter(SkLight* light, SkScalar surfaceScale, SkImageFilter* input, const SkIRect* cropRect)
   : INHERITED(input, cropRect),
     fLight(light),
@@ -870,6 +925,14 @@ void SkLightingImageFilter::flatten(SkFlattenableWriteBuffer& buffer) const {
     buffer.writeScalar(fSurfaceScale);
 }
 
+bool SkLightingImageFilter::onFilterInputBounds(const SkIRect& dst, const SkMatrix& ctm,
+                                                SkIRect* src) {
+    // The surface normals are computed from the 3x3 neighbourhood of each pixel.
+    SkIRect needed = dst;
+    needed.outset(1, 1);
+    return this->inputsFilterInputBounds(needed, ctm, src);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 SkDiffuseLightingImageFilter::SkDiffuseLightingImageFilter(SkLight* light, SkScalar surfaceScale, SkScalar kd, SkImageFilter* input, const SkIRect* cropRect = NULL)
@@ -918,15 +981,18 @@ bool SkDiffuseLightingImageFilter::onFilterImage(Proxy*,
     SkAutoTUnref<SkLight> transformedLight(light()->transform(ctm));
 
     DiffuseLightingType lightingType(fKD);
+    SkLightingParams params;
+    SkLightingRowProc proc = get_lighting_row_proc(transformedLight, kDiffuse_SkLightingType,
+                                                   surfaceScale(), fKD, 0, &params);
     switch (transformedLight->type()) {
         case SkLight::kDistant_LightType:
-            lightBitmap<DiffuseLightingType, SkDistantLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds);
+            lightBitmap<DiffuseLightingType, SkDistantLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds, proc, params);
             break;
         case SkLight::kPoint_LightType:
-            lightBitmap<DiffuseLightingType, SkPointLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds);
+            lightBitmap<DiffuseLightingType, SkPointLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds, proc, params);
             break;
         case SkLight::kSpot_LightType:
-            lightBitmap<DiffuseLightingType, SkSpotLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds);
+            lightBitmap<DiffuseLightingType, SkSpotLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds, proc, params);
             break;
     }
 
@@ -995,15 +1061,18 @@ bool SkSpecularLightingImageFilter::onFilterImage(Proxy*,
 
     SpecularLightingType lightingType(fKS, fShininess);
     SkAutoTUnref<SkLight> transformedLight(light()->transform(ctm));
+    SkLightingParams params;
+    SkLightingRowProc proc = get_lighting_row_proc(transformedLight, kSpecular_SkLightingType,
+                                                   surfaceScale(), fKS, fShininess, &params);
     switch (transformedLight->type()) {
         case SkLight::kDistant_LightType:
-            lightBitmap<SpecularLightingType, SkDistantLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds);
+            lightBitmap<SpecularLightingType, SkDistantLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds, proc, params);
             break;
         case SkLight::kPoint_LightType:
-            lightBitmap<SpecularLightingType, SkPointLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds);
+            lightBitmap<SpecularLightingType, SkPointLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds, proc, params);
             break;
         case SkLight::kSpot_LightType:
-            lightBitmap<SpecularLightingType, SkSpotLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds);
+            lightBitmap<SpecularLightingType, SkSpotLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds, proc, params);
             break;
     }
     offset->fX += bounds.left();
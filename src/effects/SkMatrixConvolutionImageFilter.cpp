@@ -9,7 +9,9 @@
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
 #include "SkFlattenableBuffers.h"
+#include "SkMatrixConvolution_opts.h"
 #include "SkRect.h"
+#include "SkTemplates.h"
 #include "SkUnPreMultiply.h"
 
 #if SK_SUPPORT_GPU
@@ -36,6 +38,7 @@ SkMatrixConvolutionImageFilter::SkMatrixConvolutionImageFilter(const SkISize& ke
     SkASSERT(kernelSize.fWidth >= 1 && kernelSize.fHeight >= 1);
     SkASSERT(target.fX >= 0 && target.fX < kernelSize.fWidth);
     SkASSERT(target.fY >= 0 && target.fY < kernelSize.fHeight);
+    this->initSeparableKernels();
 }
 
 SkMatrixConvolutionImageFilter::SkMatrixConvolutionImageFilter(SkFlattenableReadBuffer& buffer) : INHERITED(buffer) {
@@ -51,6 +54,7 @@ SkMatrixConvolutionImageFilter::SkMatrixConvolutionImageFilter(SkFlattenableRead
     fTarget.fY = buffer.readInt();
     fTileMode = (TileMode) buffer.readInt();
     fConvolveAlpha = buffer.readBool();
+    this->initSeparableKernels();
 }
 
 void SkMatrixConvolutionImageFilter::flatten(SkFlattenableWriteBuffer& buffer) const {
@@ -68,6 +72,47 @@ void SkMatrixConvolutionImageFilter::flatten(SkFlattenableWriteBuffer& buffer) c
 
 SkMatrixConvolutionImageFilter::~SkMatrixConvolutionImageFilter() {
     delete[] fKernel;
+    delete[] fKernelX;
+    delete[] fKernelY;
+}
+
+void SkMatrixConvolutionImageFilter::initSeparableKernels() {
+    fKernelX = fKernelY = NULL;
+    int width = fKernelSize.width(), height = fKernelSize.height();
+    // A single row or column is already as cheap as it gets.
+    if (width < 2 || height < 2) {
+        return;
+    }
+    int pivot = 0;
+    for (int i = 1; i < width * height; ++i) {
+        if (SkScalarAbs(fKernel[i]) > SkScalarAbs(fKernel[pivot])) {
+            pivot = i;
+        }
+    }
+    SkScalar p = fKernel[pivot];
+    if (0 == p) {
+        return;
+    }
+    // The kernel is separable (has rank 1) if every element is the product of the elements
+    // in the pivot's row and column, divided by the pivot.
+    int px = pivot % width, py = pivot / width;
+    SkScalar tolerance = SkScalarMul(SkScalarMul(p, p), SkFloatToScalar(1e-6f));
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            SkScalar product = SkScalarMul(fKernel[y * width + px], fKernel[py * width + x]);
+            if (SkScalarAbs(SkScalarMul(fKernel[y * width + x], p) - product) > tolerance) {
+                return;
+            }
+        }
+    }
+    fKernelX = SkNEW_ARRAY(SkScalar, width);
+    fKernelY = SkNEW_ARRAY(SkScalar, height);
+    for (int x = 0; x < width; ++x) {
+        fKernelX[x] = SkScalarDiv(fKernel[py * width + x], p);
+    }
+    for (int y = 0; y < height; ++y) {
+        fKernelY[y] = fKernel[y * width + px];
+    }
 }
 
 class UncheckedPixelFetcher {
@@ -156,7 +201,33 @@ void SkMatrixConvolutionImageFilter::filterPixels(const SkBitmap& src, SkBitmap*
 }
 
 void SkMatrixConvolutionImageFilter::filterInteriorPixels(const SkBitmap& src, SkBitmap* result, const SkIRect& rect) {
-    filterPixels<UncheckedPixelFetcher>(src, result, rect);
+    SkMatrixConvolutionProc proc = SkMatrixConvolutionGetPlatformProc(fKernelSize.width(),
+                                                                      fKernelSize.height(),
+                                                                      fConvolveAlpha);
+    if (NULL == proc || rect.isEmpty()) {
+        filterPixels<UncheckedPixelFetcher>(src, result, rect);
+        return;
+    }
+    int count = fKernelSize.width() * fKernelSize.height();
+    SkAutoSTArray<25, float> kernel(count);
+    for (int i = 0; i < count; ++i) {
+        kernel[i] = SkScalarToFloat(fKernel[i]);
+    }
+    for (int y = rect.fTop; y < rect.fBottom; ++y) {
+        SkPMColor* dptr = result->getAddr32(rect.fLeft, y);
+        proc(src.getAddr32(rect.fLeft - fTarget.fX, y - fTarget.fY), src.rowBytesAsPixels(),
+             kernel.get(), fKernelSize.width(), fKernelSize.height(),
+             SkScalarToFloat(fGain), SkScalarToFloat(fBias), dptr, rect.width());
+        if (!fConvolveAlpha) {
+            // The proc leaves the colors unpremultiplied, and opaque.
+            const SkPMColor* sptr = src.getAddr32(rect.fLeft, y);
+            for (int x = 0; x < rect.width(); ++x) {
+                SkPMColor c = dptr[x];
+                dptr[x] = SkPreMultiplyARGB(SkGetPackedA32(sptr[x]), SkGetPackedR32(c),
+                                            SkGetPackedG32(c), SkGetPackedB32(c));
+            }
+        }
+    }
 }
 
 void SkMatrixConvolutionImageFilter::filterBorderPixels(const SkBitmap& src, SkBitmap* result, const SkIRect& rect) {
@@ -173,6 +244,125 @@ void SkMatrixConvolutionImageFilter::filterBorderPixels(const SkBitmap& src, SkB
     }
 }
 
+// Separable kernels with up to this many elements are faster applied directly, with the
+// platform procs.
+static const int kMaxDirectKernelSize = 25;
+
+// Sets sums[4 * x] to the A, R, G and B sums of the row kernel around pixel x, in row y, for
+// each x in [left, right).
+template<class PixelFetcher, bool convolveAlpha>
+static void convolve_row(const SkBitmap& src, int y, int left, int right,
+                         const SkScalar kernel[], int kernelWidth, int targetX, SkScalar sums[]) {
+    for (int x = left; x < right; ++x) {
+        SkScalar sumA = 0, sumR = 0, sumG = 0, sumB = 0;
+        for (int cx = 0; cx < kernelWidth; cx++) {
+            SkPMColor s = PixelFetcher::fetch(src, x + cx - targetX, y);
+            SkScalar k = kernel[cx];
+            if (convolveAlpha) {
+                sumA += SkScalarMul(SkIntToScalar(SkGetPackedA32(s)), k);
+            }
+            sumR += SkScalarMul(SkIntToScalar(SkGetPackedR32(s)), k);
+            sumG += SkScalarMul(SkIntToScalar(SkGetPackedG32(s)), k);
+            sumB += SkScalarMul(SkIntToScalar(SkGetPackedB32(s)), k);
+        }
+        sums[4 * x + 0] = sumA;
+        sums[4 * x + 1] = sumR;
+        sums[4 * x + 2] = sumG;
+        sums[4 * x + 3] = sumB;
+    }
+}
+
+template<class PixelFetcher, bool convolveAlpha>
+void SkMatrixConvolutionImageFilter::filterSeparablePixels(const SkBitmap& src, SkBitmap* result) {
+    int width = src.width(), height = src.height();
+    int kernelWidth = fKernelSize.width(), kernelHeight = fKernelSize.height();
+    // The pixels whose row kernel is inside src.
+    int interiorLeft = SkMin32(fTarget.fX, width);
+    int interiorRight = SkMax32(width - kernelWidth + fTarget.fX + 1, interiorLeft);
+
+    // The rows convolved with the row kernel, kept in a ring of kernelHeight rows: row y is in
+    // slot y mod kernelHeight, if the slot's tag is y. The rows may be outside src.
+    SkAutoTMalloc<SkScalar> sums(kernelHeight * width * 4);
+    SkAutoSTArray<16, int> tags(kernelHeight);
+    for (int i = 0; i < kernelHeight; ++i) {
+        tags[i] = SK_MinS32;
+    }
+    SkAutoSTArray<16, const SkScalar*> rows(kernelHeight);
+
+    for (int y = 0; y < height; ++y) {
+        for (int cy = 0; cy < kernelHeight; cy++) {
+            int sy = y + cy - fTarget.fY;
+            int slot = (sy % kernelHeight + kernelHeight) % kernelHeight;
+            SkScalar* row = sums.get() + slot * width * 4;
+            if (tags[slot] != sy) {
+                if (sy >= 0 && sy < height) {
+                    convolve_row<PixelFetcher, convolveAlpha>(src, sy, 0, interiorLeft,
+                        fKernelX, kernelWidth, fTarget.fX, row);
+                    convolve_row<UncheckedPixelFetcher, convolveAlpha>(src, sy, interiorLeft,
+                        interiorRight, fKernelX, kernelWidth, fTarget.fX, row);
+                    convolve_row<PixelFetcher, convolveAlpha>(src, sy, interiorRight, width,
+                        fKernelX, kernelWidth, fTarget.fX, row);
+                } else {
+                    convolve_row<PixelFetcher, convolveAlpha>(src, sy, 0, width,
+                        fKernelX, kernelWidth, fTarget.fX, row);
+                }
+                tags[slot] = sy;
+            }
+            rows[cy] = row;
+        }
+
+        SkPMColor* dptr = result->getAddr32(0, y);
+        for (int x = 0; x < width; ++x) {
+            SkScalar sumA = 0, sumR = 0, sumG = 0, sumB = 0;
+            for (int cy = 0; cy < kernelHeight; cy++) {
+                const SkScalar* s = rows[cy] + 4 * x;
+                SkScalar k = fKernelY[cy];
+                if (convolveAlpha) {
+                    sumA += SkScalarMul(s[0], k);
+                }
+                sumR += SkScalarMul(s[1], k);
+                sumG += SkScalarMul(s[2], k);
+                sumB += SkScalarMul(s[3], k);
+            }
+            int a = convolveAlpha
+                  ? SkClampMax(SkScalarFloorToInt(SkScalarMul(sumA, fGain) + fBias), 255)
+                  : 255;
+            int r = SkClampMax(SkScalarFloorToInt(SkScalarMul(sumR, fGain) + fBias), a);
+            int g = SkClampMax(SkScalarFloorToInt(SkScalarMul(sumG, fGain) + fBias), a);
+            int b = SkClampMax(SkScalarFloorToInt(SkScalarMul(sumB, fGain) + fBias), a);
+            if (!convolveAlpha) {
+                a = SkGetPackedA32(*src.getAddr32(x, y));
+                *dptr++ = SkPreMultiplyARGB(a, r, g, b);
+            } else {
+                *dptr++ = SkPackARGB32(a, r, g, b);
+            }
+        }
+    }
+}
+
+template<class PixelFetcher>
+void SkMatrixConvolutionImageFilter::filterSeparablePixels(const SkBitmap& src, SkBitmap* result) {
+    if (fConvolveAlpha) {
+        filterSeparablePixels<PixelFetcher, true>(src, result);
+    } else {
+        filterSeparablePixels<PixelFetcher, false>(src, result);
+    }
+}
+
+void SkMatrixConvolutionImageFilter::filterSeparablePixels(const SkBitmap& src, SkBitmap* result) {
+    switch (fTileMode) {
+        case kClamp_TileMode:
+            filterSeparablePixels<ClampPixelFetcher>(src, result);
+            break;
+        case kRepeat_TileMode:
+            filterSeparablePixels<RepeatPixelFetcher>(src, result);
+            break;
+        case kClampToBlack_TileMode:
+            filterSeparablePixels<ClampToBlackPixelFetcher>(src, result);
+            break;
+    }
+}
+
 // FIXME:  This should be refactored to SkImageFilterUtils for
 // use by other filters.  For now, we assume the input is always
 // premultiplied and unpremultiply it
@@ -224,6 +414,13 @@ bool SkMatrixConvolutionImageFilter::onFilterImage(Proxy* proxy,
     result->setConfig(src.config(), src.width(), src.height());
     result->allocPixels();
 
+    // A separable kernel is applied as a row kernel followed by a column kernel, which is
+    // cheaper unless the whole kernel is small enough for the platform procs.
+    if (fKernelX && fKernelSize.width() * fKernelSize.height() > kMaxDirectKernelSize) {
+        this->filterSeparablePixels(src, result);
+        return true;
+    }
+
     SkIRect interior = SkIRect::MakeXYWH(fTarget.fX, fTarget.fY,
                                          src.width() - fKernelSize.fWidth + 1,
                                          src.height() - fKernelSize.fHeight + 1);
@@ -242,6 +439,20 @@ bool SkMatrixConvolutionImageFilter::onFilterImage(Proxy* proxy,
     return true;
 }
 
+bool SkMatrixConvolutionImageFilter::onFilterInputBounds(const SkIRect& dst,
+                                                         const SkMatrix& ctm,
+                                                         SkIRect* src) {
+    // Repeat tiling reads from the opposite edge of the whole image.
+    if (kRepeat_TileMode == fTileMode) {
+        return false;
+    }
+    SkIRect needed = SkIRect::MakeLTRB(dst.left() - fTarget.fX,
+                                       dst.top() - fTarget.fY,
+                                       dst.right() + fKernelSize.fWidth - fTarget.fX - 1,
+                                       dst.bottom() + fKernelSize.fHeight - fTarget.fY - 1);
+    return this->inputsFilterInputBounds(needed, ctm, src);
+}
+
 #if SK_SUPPORT_GPU
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,8 @@
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
 #include "SkFlattenableBuffers.h"
+#include "SkMorphology_opts.h"
+#include "SkTemplates.h"
 #include "SkRect.h"
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
@@ -37,100 +39,122 @@ void SkMorphologyImageFilter::flatten(SkFlattenableWriteBuffer& buffer) const {
     buffer.writeInt(fRadius.fHeight);
 }
 
-static void erode(const SkPMColor* src, SkPMColor* dst,
-                  int radius, int width, int height,
-                  int srcStrideX, int srcStrideY,
-                  int dstStrideX, int dstStrideY)
-{
-    radius = SkMin32(radius, width - 1);
-    const SkPMColor* upperSrc = src + radius * srcStrideX;
-    for (int x = 0; x < width; ++x) {
-        const SkPMColor* lp = src;
-        const SkPMColor* up = upperSrc;
-        SkPMColor* dptr = dst;
-        for (int y = 0; y < height; ++y) {
-            int minB = 255, minG = 255, minR = 255, minA = 255;
-            for (const SkPMColor* p = lp; p <= up; p += srcStrideX) {
-                int b = SkGetPackedB32(*p);
-                int g = SkGetPackedG32(*p);
-                int r = SkGetPackedR32(*p);
-                int a = SkGetPackedA32(*p);
-                if (b < minB) minB = b;
-                if (g < minG) minG = g;
-                if (r < minR) minR = r;
-                if (a < minA) minA = a;
-            }
-            *dptr = SkPackARGB32(minA, minR, minG, minB);
-            dptr += dstStrideY;
-            lp += srcStrideY;
-            up += srcStrideY;
-        }
-        if (x >= radius) src += srcStrideX;
-        if (x + radius < width - 1) upperSrc += srcStrideX;
-        dst += dstStrideX;
-    }
+bool SkMorphologyImageFilter::onFilterInputBounds(const SkIRect& dst, const SkMatrix& ctm,
+                                                  SkIRect* src) {
+    SkIRect needed = dst;
+    needed.outset(fRadius.width(), fRadius.height());
+    return this->inputsFilterInputBounds(needed, ctm, src);
 }
 
-static void erodeX(const SkBitmap& src, SkBitmap* dst, int radiusX)
-{
-    erode(src.getAddr32(0, 0), dst->getAddr32(0, 0),
-          radiusX, src.width(), src.height(),
-          1, src.rowBytesAsPixels(), 1, dst->rowBytesAsPixels());
+namespace {
+
+enum MorphType {
+    kErode_MorphType,
+    kDilate_MorphType
+};
+
+enum MorphDirection {
+    kX_MorphDirection,
+    kY_MorphDirection
+};
+
 }
 
-static void erodeY(const SkBitmap& src, SkBitmap* dst, int radiusY)
-{
-    erode(src.getAddr32(0, 0), dst->getAddr32(0, 0),
-          radiusY, src.height(), src.width(),
-          src.rowBytesAsPixels(), 1, dst->rowBytesAsPixels(), 1);
+// Lines along columns are filtered this many at a time, so that every row of the window is
+// read as one run of adjacent pixels.
+static const int kMaxLanes = 16;
+
+template<MorphType type>
+static inline SkPMColor morph_op(SkPMColor a, SkPMColor b) {
+    SkPMColor result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        int ca = (a >> shift) & 0xFF;
+        int cb = (b >> shift) & 0xFF;
+        result |= (kDilate_MorphType == type ? SkMax32(ca, cb) : SkMin32(ca, cb)) << shift;
+    }
+    return result;
 }
 
-static void dilate(const SkPMColor* src, SkPMColor* dst,
-                   int radius, int width, int height,
-                   int srcStrideX, int srcStrideY,
-                   int dstStrideX, int dstStrideY)
-{
-    radius = SkMin32(radius, width - 1);
-    const SkPMColor* upperSrc = src + radius * srcStrideX;
+/*
+ *  van Herk/Gil-Werman: the line, padded with radius identity pixels at either end, is cut into
+ *  blocks of one window (2 * radius + 1) each. g holds the running min/max from the start of
+ *  each block, h the running min/max to the end of each block. Every window spans at most two
+ *  blocks, so its result is op(h[x], g[x + 2 * radius]), whatever the radius.
+ *  g and h hold lanes interleaved pixels per padded position.
+ */
+template<MorphType type>
+static void morph_lanes(const SkPMColor* src, SkPMColor* dst, int radius, int width, int lanes,
+                        int srcStrideX, int srcStrideY, int dstStrideX, int dstStrideY,
+                        SkPMColor* g, SkPMColor* h) {
+    const SkPMColor identity = kDilate_MorphType == type ? 0 : 0xFFFFFFFF;
+    const int window = 2 * radius + 1;
+    const int n = width + 2 * radius;
+
+    int pos = 0;
+    for (int i = 0; i < n; ++i) {
+        SkPMColor* gi = g + i * lanes;
+        bool inside = i >= radius && i < radius + width;
+        const SkPMColor* p = src + (i - radius) * srcStrideX;
+        for (int j = 0; j < lanes; ++j) {
+            SkPMColor e = inside ? p[j * srcStrideY] : identity;
+            gi[j] = 0 == pos ? e : morph_op<type>(gi[j - lanes], e);
+        }
+        if (++pos == window) {
+            pos = 0;
+        }
+    }
+
+    pos = (n - 1) % window;
+    for (int i = n - 1; i >= 0; --i) {
+        SkPMColor* hi = h + i * lanes;
+        bool inside = i >= radius && i < radius + width;
+        const SkPMColor* p = src + (i - radius) * srcStrideX;
+        bool blockEnd = window - 1 == pos || n - 1 == i;
+        for (int j = 0; j < lanes; ++j) {
+            SkPMColor e = inside ? p[j * srcStrideY] : identity;
+            hi[j] = blockEnd ? e : morph_op<type>(hi[j + lanes], e);
+        }
+        if (--pos < 0) {
+            pos = window - 1;
+        }
+    }
+
     for (int x = 0; x < width; ++x) {
-        const SkPMColor* lp = src;
-        const SkPMColor* up = upperSrc;
-        SkPMColor* dptr = dst;
-        for (int y = 0; y < height; ++y) {
-            int maxB = 0, maxG = 0, maxR = 0, maxA = 0;
-            for (const SkPMColor* p = lp; p <= up; p += srcStrideX) {
-                int b = SkGetPackedB32(*p);
-                int g = SkGetPackedG32(*p);
-                int r = SkGetPackedR32(*p);
-                int a = SkGetPackedA32(*p);
-                if (b > maxB) maxB = b;
-                if (g > maxG) maxG = g;
-                if (r > maxR) maxR = r;
-                if (a > maxA) maxA = a;
-            }
-            *dptr = SkPackARGB32(maxA, maxR, maxG, maxB);
-            dptr += dstStrideY;
-            lp += srcStrideY;
-            up += srcStrideY;
+        const SkPMColor* hx = h + x * lanes;
+        const SkPMColor* gx = g + (x + 2 * radius) * lanes;
+        SkPMColor* d = dst + x * dstStrideX;
+        for (int j = 0; j < lanes; ++j) {
+            d[j * dstStrideY] = morph_op<type>(hx[j], gx[j]);
         }
-        if (x >= radius) src += srcStrideX;
-        if (x + radius < width - 1) upperSrc += srcStrideX;
-        dst += dstStrideX;
     }
 }
 
-static void dilateX(const SkBitmap& src, SkBitmap* dst, int radiusX)
+template<MorphType type, MorphDirection direction>
+static void morph(const SkPMColor* src, SkPMColor* dst, int radius, int width, int height,
+                  int srcStrideX, int srcStrideY, int dstStrideX, int dstStrideY)
+{
+    radius = SkMin32(radius, width - 1);
+    const int maxLanes = kY_MorphDirection == direction ? kMaxLanes : 1;
+    SkAutoTMalloc<SkPMColor> storage(2 * (width + 2 * radius) * maxLanes);
+    SkPMColor* g = storage.get();
+    SkPMColor* h = g + (width + 2 * radius) * maxLanes;
+    for (int y = 0; y < height; y += maxLanes) {
+        int lanes = SkMin32(maxLanes, height - y);
+        morph_lanes<type>(src + y * srcStrideY, dst + y * dstStrideY, radius, width, lanes,
+                          srcStrideX, srcStrideY, dstStrideX, dstStrideY, g, h);
+    }
+}
+
+static void callProcX(SkMorphologyProc procX, const SkBitmap& src, SkBitmap* dst, int radiusX)
 {
-    dilate(src.getAddr32(0, 0), dst->getAddr32(0, 0),
-           radiusX, src.width(), src.height(),
-           1, src.rowBytesAsPixels(), 1, dst->rowBytesAsPixels());
+    procX(src.getAddr32(0, 0), dst->getAddr32(0, 0), radiusX, src.width(), src.height(),
+          1, src.rowBytesAsPixels(), 1, dst->rowBytesAsPixels());
 }
 
-static void dilateY(const SkBitmap& src, SkBitmap* dst, int radiusY)
+static void callProcY(SkMorphologyProc procY, const SkBitmap& src, SkBitmap* dst, int radiusY)
 {
-    dilate(src.getAddr32(0, 0), dst->getAddr32(0, 0),
-           radiusY, src.height(), src.width(),
-           src.rowBytesAsPixels(), 1, dst->rowBytesAsPixels(), 1);
+    procY(src.getAddr32(0, 0), dst->getAddr32(0, 0), radiusY, src.height(), src.width(),
+          src.rowBytesAsPixels(), 1, dst->rowBytesAsPixels(), 1);
 }
 
 bool SkErodeImageFilter::onFilterImage(Proxy* proxy,
@@ -171,13 +195,22 @@ bool SkErodeImageFilter::onFilterImage(Proxy* proxy,
         return false;
     }
 
+    SkMorphologyProc erodeXProc = SkMorphologyGetPlatformProc(kErodeX_SkMorphologyProcType);
+    if (!erodeXProc) {
+        erodeXProc = morph<kErode_MorphType, kX_MorphDirection>;
+    }
+    SkMorphologyProc erodeYProc = SkMorphologyGetPlatformProc(kErodeY_SkMorphologyProcType);
+    if (!erodeYProc) {
+        erodeYProc = morph<kErode_MorphType, kY_MorphDirection>;
+    }
+
     if (width > 0 && height > 0) {
-        erodeX(src, &temp, width);
-        erodeY(temp, dst, height);
+        callProcX(erodeXProc, src, &temp, width);
+        callProcY(erodeYProc, temp, dst, height);
     } else if (width > 0) {
-        erodeX(src, dst, width);
+        callProcX(erodeXProc, src, dst, width);
     } else if (height > 0) {
-        erodeY(src, dst, height);
+        callProcY(erodeYProc, src, dst, height);
     }
     return true;
 }
@@ -219,13 +252,22 @@ bool SkDilateImageFilter::onFilterImage(Proxy* proxy,
         return false;
     }
 
+    SkMorphologyProc dilateXProc = SkMorphologyGetPlatformProc(kDilateX_SkMorphologyProcType);
+    if (!dilateXProc) {
+        dilateXProc = morph<kDilate_MorphType, kX_MorphDirection>;
+    }
+    SkMorphologyProc dilateYProc = SkMorphologyGetPlatformProc(kDilateY_SkMorphologyProcType);
+    if (!dilateYProc) {
+        dilateYProc = morph<kDilate_MorphType, kY_MorphDirection>;
+    }
+
     if (width > 0 && height > 0) {
-        dilateX(src, &temp, width);
-        dilateY(temp, dst, height);
+        callProcX(dilateXProc, src, &temp, width);
+        callProcY(dilateYProc, temp, dst, height);
     } else if (width > 0) {
-        dilateX(src, dst, width);
+        callProcX(dilateXProc, src, dst, width);
     } else if (height > 0) {
-        dilateY(src, dst, height);
+        callProcY(dilateYProc, src, dst, height);
     }
     return true;
 }
@@ -38,6 +38,16 @@ bool SkOffsetImageFilter::onFilterBounds(const SkIRect& src, const SkMatrix& ctm
     return true;
 }
 
+bool SkOffsetImageFilter::onFilterInputBounds(const SkIRect& dst, const SkMatrix& ctm,
+                                              SkIRect* src) {
+    SkVector vec;
+    ctm.mapVectors(&vec, &fOffset, 1);
+
+    SkIRect needed = dst;
+    needed.offset(-SkScalarRoundToInt(vec.fX), -SkScalarRoundToInt(vec.fY));
+    return this->inputsFilterInputBounds(needed, ctm, src);
+}
+
 void SkOffsetImageFilter::flatten(SkFlattenableWriteBuffer& buffer) const {
     this->INHERITED::flatten(buffer);
     buffer.writePoint(fOffset);
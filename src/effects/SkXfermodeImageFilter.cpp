@@ -74,6 +74,11 @@ bool SkXfermodeImageFilter::onFilterImage(Proxy* proxy,
     return true;
 }
 
+bool SkXfermodeImageFilter::onFilterInputBounds(const SkIRect& dst, const SkMatrix& ctm,
+                                                SkIRect* src) {
+    return this->inputsFilterInputBounds(dst, ctm, src);
+}
+
 #if SK_SUPPORT_GPU
 
 bool SkXfermodeImageFilter::filterImageGPU(Proxy* proxy,
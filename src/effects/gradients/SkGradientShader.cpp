@@ -6,6 +6,7 @@
  */
 
 #include "SkGradientShaderPriv.h"
+#include "SkOrderedWriteBuffer.h"
 #include "SkLinearGradient.h"
 #include "SkRadialGradient.h"
 #include "SkTwoPointRadialGradient.h"
@@ -26,8 +27,9 @@ SkGradientShaderBase::SkGradientShaderBase(const Descriptor& desc) {
     fTileMode = desc.fTileMode;
     fTileProc = gTileProcs[desc.fTileMode];
 
-    fCache16 = fCache16Storage = NULL;
+    fCache16 = NULL;
     fCache32 = NULL;
+    fCache16PixelRef = NULL;
     fCache32PixelRef = NULL;
 
     /*  Note: we let the caller skip the first and/or last position.
@@ -148,8 +150,9 @@ SkGradientShaderBase::SkGradientShaderBase(SkFlattenableReadBuffer& buffer) : IN
 
     fMapper = buffer.readFlattenableT<SkUnitMapper>();
 
-    fCache16 = fCache16Storage = NULL;
+    fCache16 = NULL;
     fCache32 = NULL;
+    fCache16PixelRef = NULL;
     fCache32PixelRef = NULL;
 
     int colorCount = fColorCount = buffer.getArrayCount();
@@ -181,9 +184,7 @@ SkGradientShaderBase::SkGradientShaderBase(SkFlattenableReadBuffer& buffer) : IN
 }
 
 SkGradientShaderBase::~SkGradientShaderBase() {
-    if (fCache16Storage) {
-        sk_free(fCache16Storage);
-    }
+    SkSafeUnref(fCache16PixelRef);
     SkSafeUnref(fCache32PixelRef);
     if (fOrigColors != fStorage) {
         sk_free(fOrigColors);
@@ -256,16 +257,12 @@ bool SkGradientShaderBase::setContext(const SkBitmap& device,
 
 void SkGradientShaderBase::setCacheAlpha(U8CPU alpha) const {
     // if the new alpha differs from the previous time we were called, inval our cache
-    // this will trigger the cache to be rebuilt.
+    // this will trigger the 32bit table for the new alpha to be found or rebuilt.
     // we don't care about the first time, since the cache ptrs will already be NULL
+    // the 16bit table ignores alpha, so it stays valid
     if (fCacheAlpha != alpha) {
-        fCache16 = NULL;            // inval the cache
         fCache32 = NULL;            // inval the cache
         fCacheAlpha = alpha;        // record the new alpha
-        // inform our subclasses
-        if (fCache32PixelRef) {
-            fCache32PixelRef->notifyPixelsChanged();
-        }
     }
 }
 
@@ -468,95 +465,149 @@ static inline U16CPU bitsTo16(unsigned x, const unsigned bits) {
     return 0;
 }
 
-const uint16_t* SkGradientShaderBase::getCache16() const {
-    if (fCache16 == NULL) {
-        // double the count for dither entries
-        const int entryCount = kCache16Count * 2;
-        const size_t allocSize = sizeof(uint16_t) * entryCount;
-
-        if (fCache16Storage == NULL) { // set the storage and our working ptr
-            fCache16Storage = (uint16_t*)sk_malloc_throw(allocSize);
+/*
+ *  Tables are keyed by everything they are built from: the colors, the positions, the
+ *  flags and the mapper, plus the paint alpha for 32bit tables. Mappers are keyed by their
+ *  flattened contents, so a mapper that cannot be flattened keeps its tables to itself.
+ */
+bool SkGradientShaderBase::writeTableKey(SkGradientTableCache::Key* key) const {
+    if (fMapper) {
+        if (NULL == fMapper->getFactory()) {
+            return false;
         }
-        fCache16 = fCache16Storage;
-        if (fColorCount == 2) {
-            Build16bitCache(fCache16, fOrigColors[0], fOrigColors[1],
-                            kCache16Count);
-        } else {
-            Rec* rec = fRecs;
-            int prevIndex = 0;
-            for (int i = 1; i < fColorCount; i++) {
-                int nextIndex = SkFixedToFFFF(rec[i].fPos) >> kCache16Shift;
-                SkASSERT(nextIndex < kCache16Count);
-
-                if (nextIndex > prevIndex)
-                    Build16bitCache(fCache16 + prevIndex, fOrigColors[i-1], fOrigColors[i], nextIndex - prevIndex + 1);
-                prevIndex = nextIndex;
-            }
+        SkOrderedWriteBuffer buffer(64);
+        buffer.writeFlattenable(fMapper);
+        size_t size = buffer.bytesWritten();
+        SkAutoSTMalloc<16, uint32_t> storage(size >> 2);
+        buffer.writeToMemory(storage.get());
+        key->write32(SkToU32(size));
+        key->write(storage.get(), size);
+    } else {
+        key->write32(0);
+    }
+    key->write32(fGradFlags);
+    key->write32(fColorCount);
+    key->write(fOrigColors, fColorCount * sizeof(SkColor));
+    if (fColorCount > 2) {
+        for (int i = 1; i < fColorCount; i++) {
+            key->write32(fRecs[i].fPos);
         }
+    }
+    key->finish();
+    return true;
+}
 
-        if (fMapper) {
-            fCache16Storage = (uint16_t*)sk_malloc_throw(allocSize);
-            uint16_t* linear = fCache16;         // just computed linear data
-            uint16_t* mapped = fCache16Storage;  // storage for mapped data
-            SkUnitMapper* map = fMapper;
-            for (int i = 0; i < kCache16Count; i++) {
-                int index = map->mapUnit16(bitsTo16(i, kCache16Bits)) >> kCache16Shift;
-                mapped[i] = linear[index];
-                mapped[i + kCache16Count] = linear[index + kCache16Count];
-            }
-            sk_free(fCache16);
-            fCache16 = fCache16Storage;
-        }
+SkMallocPixelRef* SkGradientShaderBase::refTable(SkGradientTableCache::Key::Kind kind) const {
+    bool is32 = SkGradientTableCache::Key::k32_Kind == kind;
+    SkGradientTableCache::Key key(kind, is32 ? fCacheAlpha : 0xFF);
+    if (!this->writeTableKey(&key)) {
+        return is32 ? this->build32bitTable() : this->build16bitTable();
     }
-    return fCache16;
+    SkMallocPixelRef* table = SkGradientTableCache::Find(key);
+    if (NULL == table) {
+        table = is32 ? this->build32bitTable() : this->build16bitTable();
+        SkGradientTableCache::Add(key, table);
+    }
+    return table;
 }
 
-const SkPMColor* SkGradientShaderBase::getCache32() const {
-    if (fCache32 == NULL) {
-        // double the count for dither entries
-        const int entryCount = kCache32Count * 4;
-        const size_t allocSize = sizeof(SkPMColor) * entryCount;
+SkMallocPixelRef* SkGradientShaderBase::build16bitTable() const {
+    // double the count for dither entries
+    const int entryCount = kCache16Count * 2;
+    const size_t allocSize = sizeof(uint16_t) * entryCount;
 
-        if (NULL == fCache32PixelRef) {
-            fCache32PixelRef = SkNEW_ARGS(SkMallocPixelRef,
-                                          (NULL, allocSize, NULL));
+    SkMallocPixelRef* table = SkNEW_ARGS(SkMallocPixelRef, (NULL, allocSize, NULL));
+    uint16_t* cache = (uint16_t*)table->getAddr();
+    if (fColorCount == 2) {
+        Build16bitCache(cache, fOrigColors[0], fOrigColors[1], kCache16Count);
+    } else {
+        Rec* rec = fRecs;
+        int prevIndex = 0;
+        for (int i = 1; i < fColorCount; i++) {
+            int nextIndex = SkFixedToFFFF(rec[i].fPos) >> kCache16Shift;
+            SkASSERT(nextIndex < kCache16Count);
+
+            if (nextIndex > prevIndex)
+                Build16bitCache(cache + prevIndex, fOrigColors[i-1], fOrigColors[i], nextIndex - prevIndex + 1);
+            prevIndex = nextIndex;
         }
-        fCache32 = (SkPMColor*)fCache32PixelRef->getAddr();
-        if (fColorCount == 2) {
-            Build32bitCache(fCache32, fOrigColors[0], fOrigColors[1],
-                            kCache32Count, fCacheAlpha, fGradFlags);
-        } else {
-            Rec* rec = fRecs;
-            int prevIndex = 0;
-            for (int i = 1; i < fColorCount; i++) {
-                int nextIndex = SkFixedToFFFF(rec[i].fPos) >> kCache32Shift;
-                SkASSERT(nextIndex < kCache32Count);
-
-                if (nextIndex > prevIndex)
-                    Build32bitCache(fCache32 + prevIndex, fOrigColors[i-1],
-                                    fOrigColors[i], nextIndex - prevIndex + 1,
-                                    fCacheAlpha, fGradFlags);
-                prevIndex = nextIndex;
-            }
+    }
+
+    if (fMapper) {
+        SkMallocPixelRef* newTable = SkNEW_ARGS(SkMallocPixelRef, (NULL, allocSize, NULL));
+        uint16_t* linear = cache;            // just computed linear data
+        uint16_t* mapped = (uint16_t*)newTable->getAddr();   // storage for mapped data
+        SkUnitMapper* map = fMapper;
+        for (int i = 0; i < kCache16Count; i++) {
+            int index = map->mapUnit16(bitsTo16(i, kCache16Bits)) >> kCache16Shift;
+            mapped[i] = linear[index];
+            mapped[i + kCache16Count] = linear[index + kCache16Count];
         }
+        table->unref();
+        table = newTable;
+    }
+    return table;
+}
 
-        if (fMapper) {
-            SkMallocPixelRef* newPR = SkNEW_ARGS(SkMallocPixelRef,
-                                                 (NULL, allocSize, NULL));
-            SkPMColor* linear = fCache32;           // just computed linear data
-            SkPMColor* mapped = (SkPMColor*)newPR->getAddr();    // storage for mapped data
-            SkUnitMapper* map = fMapper;
-            for (int i = 0; i < kCache32Count; i++) {
-                int index = map->mapUnit16((i << 8) | i) >> 8;
-                mapped[i + kCache32Count*0] = linear[index + kCache32Count*0];
-                mapped[i + kCache32Count*1] = linear[index + kCache32Count*1];
-                mapped[i + kCache32Count*2] = linear[index + kCache32Count*2];
-                mapped[i + kCache32Count*3] = linear[index + kCache32Count*3];
-            }
-            fCache32PixelRef->unref();
-            fCache32PixelRef = newPR;
-            fCache32 = (SkPMColor*)newPR->getAddr();
+SkMallocPixelRef* SkGradientShaderBase::build32bitTable() const {
+    // double the count for dither entries
+    const int entryCount = kCache32Count * 4;
+    const size_t allocSize = sizeof(SkPMColor) * entryCount;
+
+    SkMallocPixelRef* table = SkNEW_ARGS(SkMallocPixelRef, (NULL, allocSize, NULL));
+    SkPMColor* cache = (SkPMColor*)table->getAddr();
+    if (fColorCount == 2) {
+        Build32bitCache(cache, fOrigColors[0], fOrigColors[1],
+                        kCache32Count, fCacheAlpha, fGradFlags);
+    } else {
+        Rec* rec = fRecs;
+        int prevIndex = 0;
+        for (int i = 1; i < fColorCount; i++) {
+            int nextIndex = SkFixedToFFFF(rec[i].fPos) >> kCache32Shift;
+            SkASSERT(nextIndex < kCache32Count);
+
+            if (nextIndex > prevIndex)
+                Build32bitCache(cache + prevIndex, fOrigColors[i-1],
+                                fOrigColors[i], nextIndex - prevIndex + 1,
+                                fCacheAlpha, fGradFlags);
+            prevIndex = nextIndex;
+        }
+    }
+
+    if (fMapper) {
+        SkMallocPixelRef* newTable = SkNEW_ARGS(SkMallocPixelRef, (NULL, allocSize, NULL));
+        SkPMColor* linear = cache;           // just computed linear data
+        SkPMColor* mapped = (SkPMColor*)newTable->getAddr();    // storage for mapped data
+        SkUnitMapper* map = fMapper;
+        for (int i = 0; i < kCache32Count; i++) {
+            int index = map->mapUnit16((i << 8) | i) >> 8;
+            mapped[i + kCache32Count*0] = linear[index + kCache32Count*0];
+            mapped[i + kCache32Count*1] = linear[index + kCache32Count*1];
+            mapped[i + kCache32Count*2] = linear[index + kCache32Count*2];
+            mapped[i + kCache32Count*3] = linear[index + kCache32Count*3];
         }
+        table->unref();
+        table = newTable;
+    }
+    return table;
+}
+
+const uint16_t* SkGradientShaderBase::getCache16() const {
+    if (fCache16 == NULL) {
+        SkMallocPixelRef* table = this->refTable(SkGradientTableCache::Key::k16_Kind);
+        SkSafeUnref(fCache16PixelRef);
+        fCache16PixelRef = table;
+        fCache16 = (uint16_t*)table->getAddr();
+    }
+    return fCache16;
+}
+
+const SkPMColor* SkGradientShaderBase::getCache32() const {
+    if (fCache32 == NULL) {
+        SkMallocPixelRef* table = this->refTable(SkGradientTableCache::Key::k32_Kind);
+        SkSafeUnref(fCache32PixelRef);
+        fCache32PixelRef = table;
+        fCache32 = (SkPMColor*)table->getAddr();
     }
     return fCache32;
 }
@@ -565,65 +616,18 @@ const SkPMColor* SkGradientShaderBase::getCache32() const {
  *  Because our caller might rebuild the same (logically the same) gradient
  *  over and over, we'd like to return exactly the same "bitmap" if possible,
  *  allowing the client to utilize a cache of our bitmap (e.g. with a GPU).
- *  To do that, we maintain a private cache of built-bitmaps, based on our
- *  colors and positions. Note: we don't try to flatten the fMapper, so if one
- *  is present, we skip the cache for now.
+ *  Equal gradients share their tables through SkGradientTableCache, so the
+ *  pixel ref of our 32bit table serves that purpose.
  */
 void SkGradientShaderBase::getGradientTableBitmap(SkBitmap* bitmap) const {
     // our caller assumes no external alpha, so we ensure that our cache is
     // built with 0xFF
     this->setCacheAlpha(0xFF);
 
-    // don't have a way to put the mapper into our cache-key yet
-    if (fMapper) {
-        // force our cahce32pixelref to be built
-        (void)this->getCache32();
-        bitmap->setConfig(SkBitmap::kARGB_8888_Config, kCache32Count, 1);
-        bitmap->setPixelRef(fCache32PixelRef);
-        return;
-    }
-
-    // build our key: [numColors + colors[] + {positions[]} + flags ]
-    int count = 1 + fColorCount + 1;
-    if (fColorCount > 2) {
-        count += fColorCount - 1;    // fRecs[].fPos
-    }
-
-    SkAutoSTMalloc<16, int32_t> storage(count);
-    int32_t* buffer = storage.get();
-
-    *buffer++ = fColorCount;
-    memcpy(buffer, fOrigColors, fColorCount * sizeof(SkColor));
-    buffer += fColorCount;
-    if (fColorCount > 2) {
-        for (int i = 1; i < fColorCount; i++) {
-            *buffer++ = fRecs[i].fPos;
-        }
-    }
-    *buffer++ = fGradFlags;
-    SkASSERT(buffer - storage.get() == count);
-
-    ///////////////////////////////////
-
-    SK_DECLARE_STATIC_MUTEX(gMutex);
-    static SkBitmapCache* gCache;
-    // each cache cost 1K of RAM, since each bitmap will be 1x256 at 32bpp
-    static const int MAX_NUM_CACHED_GRADIENT_BITMAPS = 32;
-    SkAutoMutexAcquire ama(gMutex);
-
-    if (NULL == gCache) {
-        gCache = SkNEW_ARGS(SkBitmapCache, (MAX_NUM_CACHED_GRADIENT_BITMAPS));
-    }
-    size_t size = count * sizeof(int32_t);
-
-    if (!gCache->find(storage.get(), size, bitmap)) {
-        // force our cahce32pixelref to be built
-        (void)this->getCache32();
-        bitmap->setConfig(SkBitmap::kARGB_8888_Config, kCache32Count, 1);
-        bitmap->setPixelRef(fCache32PixelRef);
-
-        gCache->add(storage.get(), size, *bitmap);
-    }
+    // force our cache32pixelref to be built
+    (void)this->getCache32();
+    bitmap->setConfig(SkBitmap::kARGB_8888_Config, kCache32Count, 1);
+    bitmap->setPixelRef(fCache32PixelRef);
 }
 
 void SkGradientShaderBase::commonAsAGradient(GradientInfo* info) const {
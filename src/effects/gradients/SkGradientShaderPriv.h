@@ -16,7 +16,7 @@
 #include "SkUnitMapper.h"
 #include "SkUtils.h"
 #include "SkTemplates.h"
-#include "SkBitmapCache.h"
+#include "SkGradientTableCache.h"
 #include "SkShader.h"
 
 static inline void sk_memset32_dither(uint32_t dst[], uint32_t v0, uint32_t v1,
@@ -168,7 +168,9 @@ private:
     mutable uint16_t*   fCache16;   // working ptr. If this is NULL, we need to recompute the cache values
     mutable SkPMColor*  fCache32;   // working ptr. If this is NULL, we need to recompute the cache values
 
-    mutable uint16_t*   fCache16Storage;    // storage for fCache16, allocated on demand
+    // The tables are shared with other gradients through SkGradientTableCache, so they
+    // must not be written to once they are built.
+    mutable SkMallocPixelRef* fCache16PixelRef;
     mutable SkMallocPixelRef* fCache32PixelRef;
     mutable unsigned    fCacheAlpha;        // the alpha value we used when we computed the cache. larger than 8bits so we can store uninitialized value
 
@@ -176,6 +178,10 @@ private:
     static void Build32bitCache(SkPMColor[], SkColor c0, SkColor c1, int count,
                                 U8CPU alpha, uint32_t gradFlags);
     void setCacheAlpha(U8CPU alpha) const;
+    bool writeTableKey(SkGradientTableCache::Key*) const;
+    SkMallocPixelRef* refTable(SkGradientTableCache::Key::Kind) const;
+    SkMallocPixelRef* build16bitTable() const;
+    SkMallocPixelRef* build32bitTable() const;
     void initCommon();
 
     typedef SkShader INHERITED;
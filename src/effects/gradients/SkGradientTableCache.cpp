@@ -0,0 +1,74 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGradientTableCache.h"
+
+#ifndef SK_DEFAULT_GRADIENT_TABLE_CACHE_LIMIT
+    #define SK_DEFAULT_GRADIENT_TABLE_CACHE_LIMIT   (512 * 1024)
+#endif
+
+SkMallocPixelRef* SkGradientTableCache::find(const Key& key) {
+    const SkAutoTUnref<SkMallocPixelRef>* table = fCache.find(key);
+    return table ? SkRef(table->get()) : NULL;
+}
+
+void SkGradientTableCache::add(const Key& key, SkMallocPixelRef* table) {
+    SkAutoTUnref<SkMallocPixelRef>* value = fCache.add(key, key.size() + table->getSize());
+    if (value) {
+        table->setImmutable();
+        value->reset(SkRef(table));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SkThread.h"
+
+SK_DECLARE_STATIC_MUTEX(gMutex);
+
+static SkGradientTableCache* get_cache() {
+    static SkGradientTableCache* gCache;
+    if (!gCache) {
+        gCache = SkNEW_ARGS(SkGradientTableCache, (SK_DEFAULT_GRADIENT_TABLE_CACHE_LIMIT));
+    }
+    return gCache;
+}
+
+SkMallocPixelRef* SkGradientTableCache::Find(const Key& key) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->find(key);
+}
+
+void SkGradientTableCache::Add(const Key& key, SkMallocPixelRef* table) {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->add(key, table);
+}
+
+void SkGradientTableCache::GetStats(Stats* stats) {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->getStats(stats);
+}
+
+void SkGradientTableCache::ResetStats() {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->resetStats();
+}
+
+void SkGradientTableCache::PurgeAll() {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->purgeAll();
+}
+
+size_t SkGradientTableCache::GetByteLimit() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getByteLimit();
+}
+
+size_t SkGradientTableCache::SetByteLimit(size_t newLimit) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->setByteLimit(newLimit);
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGradientTableCache_DEFINED
+#define SkGradientTableCache_DEFINED
+
+#include "SkMallocPixelRef.h"
+#include "SkTLRUCache.h"
+
+/**
+ *  Cache of the color tables that gradient shaders build, so that gradients with the same
+ *  colors, positions, mapper and flags share one table instead of each building its own.
+ *
+ *  Entries hold a ref on an immutable SkMallocPixelRef, and give one out to each shader that
+ *  finds them. Since equal gradients get the same pixel ref, its generation ID can also be
+ *  used to cache the table on the GPU.
+ */
+class SkGradientTableCache {
+public:
+    class Key : public SkLRUCacheKey {
+    public:
+        enum Kind {
+            k32_Kind,   //!< 32 bit table, for the given paint alpha
+            k16_Kind,   //!< 16 bit table, which does not depend on the alpha
+        };
+
+        Key(Kind kind, U8CPU alpha) {
+            this->write32(kind);
+            this->write32(alpha);
+        }
+    };
+
+    typedef SkTLRUCache<Key, SkAutoTUnref<SkMallocPixelRef> >::Stats Stats;
+
+    /*
+     *  The following static methods are thread-safe wrappers around a global
+     *  instance of this cache.
+     */
+
+    static SkMallocPixelRef* Find(const Key&);
+    static void Add(const Key&, SkMallocPixelRef*);
+
+    static void GetStats(Stats*);
+    static void ResetStats();
+    static void PurgeAll();
+
+    static size_t GetByteLimit();
+    static size_t SetByteLimit(size_t newLimit);
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    SkGradientTableCache(size_t byteLimit) : fCache(byteLimit) {}
+
+    /**
+     *  Search the cache for key. If it is found, return its table with a ref that the caller
+     *  must balance with unref(). Otherwise return NULL.
+     */
+    SkMallocPixelRef* find(const Key&);
+
+    /**
+     *  Add table to the cache, which takes a ref on it and makes it immutable. The caller must
+     *  not change the table's pixels after adding it.
+     */
+    void add(const Key&, SkMallocPixelRef* table);
+
+    void getStats(Stats* stats) const { fCache.getStats(stats); }
+    void resetStats() { fCache.resetStats(); }
+    void purgeAll() { fCache.purgeAll(); }
+
+    size_t getByteLimit() const { return fCache.getByteLimit(); }
+    size_t setByteLimit(size_t newLimit) { return fCache.setByteLimit(newLimit); }
+
+private:
+    SkTLRUCache<Key, SkAutoTUnref<SkMallocPixelRef> > fCache;
+};
+
+#endif
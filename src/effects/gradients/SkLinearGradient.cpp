@@ -7,6 +7,7 @@
  */
 
 #include "SkLinearGradient.h"
+#include "SkGradient_opts.h"
 
 static inline int repeat_bits(int x, const int bits) {
     return x & ((1 << bits) - 1);
@@ -147,18 +148,28 @@ void shadeSpan_linear_clamp(TileProc proc, SkFixed dx, SkFixed fx,
         dstC += count;
     }
     if ((count = range.fCount1) > 0) {
-        int unroll = count >> 3;
-        fx = range.fFx1;
-        for (int i = 0; i < unroll; i++) {
-            NO_CHECK_ITER;  NO_CHECK_ITER;
-            NO_CHECK_ITER;  NO_CHECK_ITER;
-            NO_CHECK_ITER;  NO_CHECK_ITER;
-            NO_CHECK_ITER;  NO_CHECK_ITER;
-        }
-        if ((count &= 7) > 0) {
-            do {
-                NO_CHECK_ITER;
-            } while (--count != 0);
+        SkLinearGradientSpanProc platformProc =
+                SkLinearGradientGetPlatformProc(SkShader::kClamp_TileMode);
+        if (platformProc) {
+            platformProc(range.fFx1, dx, cache, toggle, dstC, count);
+            dstC += count;
+            if (count & 1) {
+                toggle = next_dither_toggle(toggle);
+            }
+        } else {
+            int unroll = count >> 3;
+            fx = range.fFx1;
+            for (int i = 0; i < unroll; i++) {
+                NO_CHECK_ITER;  NO_CHECK_ITER;
+                NO_CHECK_ITER;  NO_CHECK_ITER;
+                NO_CHECK_ITER;  NO_CHECK_ITER;
+                NO_CHECK_ITER;  NO_CHECK_ITER;
+            }
+            if ((count &= 7) > 0) {
+                do {
+                    NO_CHECK_ITER;
+                } while (--count != 0);
+            }
         }
     }
     if ((count = range.fCount2) > 0) {
@@ -173,6 +184,12 @@ void shadeSpan_linear_mirror(TileProc proc, SkFixed dx, SkFixed fx,
                              SkPMColor* SK_RESTRICT dstC,
                              const SkPMColor* SK_RESTRICT cache,
                              int toggle, int count) {
+    SkLinearGradientSpanProc platformProc =
+            SkLinearGradientGetPlatformProc(SkShader::kMirror_TileMode);
+    if (platformProc) {
+        platformProc(fx, dx, cache, toggle, dstC, count);
+        return;
+    }
     do {
         unsigned fi = mirror_8bits(fx >> 8);
         SkASSERT(fi <= 0xFF);
@@ -186,6 +203,12 @@ void shadeSpan_linear_repeat(TileProc proc, SkFixed dx, SkFixed fx,
         SkPMColor* SK_RESTRICT dstC,
         const SkPMColor* SK_RESTRICT cache,
         int toggle, int count) {
+    SkLinearGradientSpanProc platformProc =
+            SkLinearGradientGetPlatformProc(SkShader::kRepeat_TileMode);
+    if (platformProc) {
+        platformProc(fx, dx, cache, toggle, dstC, count);
+        return;
+    }
     do {
         unsigned fi = repeat_8bits(fx >> 8);
         SkASSERT(fi <= 0xFF);
@@ -8,6 +8,7 @@
 
 #include "SkRadialGradient.h"
 #include "SkRadialGradient_Table.h"
+#include "SkGradient_opts.h"
 
 #define kSQRT_TABLE_BITS    11
 #define kSQRT_TABLE_SIZE    (1 << kSQRT_TABLE_BITS)
@@ -316,12 +317,16 @@ void shadeSpan_radial_clamp(SkScalar sfx, SkScalar sdx,
     SkFixed dx = SkScalarToFixed(sdx) >> 1;
     SkFixed fy = SkScalarToFixed(sfy) >> 1;
     SkFixed dy = SkScalarToFixed(sdy) >> 1;
+    SkRadialGradientSpanProc platformProc =
+            SkRadialGradientGetPlatformProc(SkShader::kClamp_TileMode);
     if ((count > 4) && radial_completely_pinned(fx, dx, fy, dy)) {
         unsigned fi = SkGradientShaderBase::kCache32Count - 1;
         sk_memset32_dither(dstC,
             cache[toggle + fi],
             cache[next_dither_toggle(toggle) + fi],
             count);
+    } else if (platformProc) {
+        platformProc(sfx, sdx, sfy, sdy, sqrt_table, cache, toggle, dstC, count);
     } else if ((count > 4) &&
                no_need_for_radial_pin(fx, dx, fy, dy, count)) {
         unsigned fi;
@@ -371,6 +376,12 @@ void shadeSpan_radial_mirror(SkScalar sfx, SkScalar sdx,
         SkScalar sfy, SkScalar sdy,
         SkPMColor* SK_RESTRICT dstC, const SkPMColor* SK_RESTRICT cache,
         int count, int toggle) {
+    SkRadialGradientSpanProc platformProc =
+            SkRadialGradientGetPlatformProc(SkShader::kMirror_TileMode);
+    if (platformProc) {
+        platformProc(sfx, sdx, sfy, sdy, gSqrt8Table, cache, toggle, dstC, count);
+        return;
+    }
     do {
 #ifdef SK_SCALAR_IS_FLOAT
         float fdist = sk_float_sqrt(sfx*sfx + sfy*sfy);
@@ -395,6 +406,12 @@ void shadeSpan_radial_repeat(SkScalar sfx, SkScalar sdx,
         SkScalar sfy, SkScalar sdy,
         SkPMColor* SK_RESTRICT dstC, const SkPMColor* SK_RESTRICT cache,
         int count, int toggle) {
+    SkRadialGradientSpanProc platformProc =
+            SkRadialGradientGetPlatformProc(SkShader::kRepeat_TileMode);
+    if (platformProc) {
+        platformProc(sfx, sdx, sfy, sdy, gSqrt8Table, cache, toggle, dstC, count);
+        return;
+    }
     SkFixed fx = SkScalarToFixed(sfx);
     SkFixed dx = SkScalarToFixed(sdx);
     SkFixed fy = SkScalarToFixed(sfy);
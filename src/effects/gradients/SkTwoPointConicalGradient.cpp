@@ -7,6 +7,7 @@
  */
 
 #include "SkTwoPointConicalGradient.h"
+#include "SkGradient_opts.h"
 
 static int valid_divide(float numer, float denom, float* ratio) {
     SkASSERT(ratio);
@@ -235,7 +236,26 @@ void SkTwoPointConicalGradient::shadeSpan(int x, int y, SkPMColor* dstCParam,
         }
 
         fRec.setup(fx, fy, dx, dy);
-        (*shadeProc)(&fRec, dstC, cache, toggle, count);
+        SkConicalGradientSpanProc platformProc = NULL;
+        if (0 != fRec.fA) {
+            platformProc = SkConicalGradientGetPlatformProc(fTileMode);
+        }
+        if (platformProc) {
+            SkConicalSpanParams params;
+            params.fA = fRec.fA;
+            params.fRadius = fRec.fRadius;
+            params.fDRadius = fRec.fDRadius;
+            params.fRadius2 = fRec.fRadius2;
+            params.fRelX = fRec.fRelX;
+            params.fRelY = fRec.fRelY;
+            params.fIncX = fRec.fIncX;
+            params.fIncY = fRec.fIncY;
+            params.fB = fRec.fB;
+            params.fDB = fRec.fDB;
+            platformProc(params, cache, toggle, dstC, count);
+        } else {
+            (*shadeProc)(&fRec, dstC, cache, toggle, count);
+        }
     } else {    // perspective case
         SkScalar dstX = SkIntToScalar(x);
         SkScalar dstY = SkIntToScalar(y);
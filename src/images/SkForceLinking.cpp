@@ -7,6 +7,8 @@
 
 #include "SkForceLinking.h"
 #include "SkImageDecoder.h"
+#include "SkMovie_gif.h"
+#include "SkStream.h"
 
 // This method is required to fool the linker into not discarding the pre-main
 // initialization and registration of the decoder classes. Passing true will
@@ -23,6 +25,8 @@ int SkForceLinking(bool doNotPassTrue) {
 #if !defined(SK_BUILD_FOR_MAC) && !defined(SK_BUILD_FOR_WIN) && !defined(SK_BUILD_FOR_NACL) \
         && !defined(SK_BUILD_FOR_IOS)
         CreateGIFImageDecoder();
+        SkMemoryStream empty;
+        CreateGIFMovie(&empty);
 #endif
 #if !defined(SK_BUILD_FOR_MAC) && !defined(SK_BUILD_FOR_WIN) && !defined(SK_BUILD_FOR_IOS)
         CreatePNGImageDecoder();
@@ -9,6 +9,7 @@
 
 #include "SkImageDecoder.h"
 #include "SkImageEncoder.h"
+#include "SkPNGImageEncoder.h"
 #include "SkColor.h"
 #include "SkColorPriv.h"
 #include "SkDither.h"
@@ -1015,20 +1016,482 @@ static inline int pack_palette(SkColorTable* ctable,
     return num_trans;
 }
 
-class SkPNGImageEncoder : public SkImageEncoder {
-protected:
-    virtual bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) SK_OVERRIDE;
+///////////////////////////////////////////////////////////////////////////////
+// Palette reduction
+
+// Maps up to 256 distinct SkPMColors to palette indices, in the order they
+// were first seen.
+class SkPNGPaletteBuilder {
+public:
+    SkPNGPaletteBuilder() : fCount(0) {
+        memset(fUsed, 0, sizeof(fUsed));
+    }
+
+    /** Return the index of c, adding it to the palette if this is the first
+        time we've seen it, or -1 if the palette is already full.
+     */
+    int lookup(SkPMColor c) {
+        unsigned slot = Hash(c);
+        while (fUsed[slot]) {
+            if (fKeys[slot] == c) {
+                return fIndices[slot];
+            }
+            slot = (slot + 1) & (kSlotCount - 1);
+        }
+        if (256 == fCount) {
+            return -1;
+        }
+        fUsed[slot] = true;
+        fKeys[slot] = c;
+        fIndices[slot] = fCount;
+        fColors[fCount] = c;
+        return fCount++;
+    }
+
+    int count() const { return fCount; }
+    const SkPMColor* colors() const { return fColors; }
+
 private:
-    bool doEncode(SkWStream* stream, const SkBitmap& bm,
-                  const bool& hasAlpha, int colorType,
-                  int bitDepth, SkBitmap::Config config,
-                  png_color_8& sig_bit);
+    // Twice the palette size, so probe sequences stay short.
+    enum { kSlotCount = 512 };
 
-    typedef SkImageEncoder INHERITED;
+    static unsigned Hash(SkPMColor c) {
+        // Fibonacci hashing, keeping the top 9 bits.
+        return (uint32_t)(c * 0x9E3779B1) >> 23;
+    }
+
+    SkPMColor   fKeys[kSlotCount];
+    uint8_t     fIndices[kSlotCount];
+    bool        fUsed[kSlotCount];
+    SkPMColor   fColors[256];
+    int         fCount;
 };
 
-bool SkPNGImageEncoder::onEncode(SkWStream* stream, const SkBitmap& bitmap,
-                                 int /*quality*/) {
+/*  If the 8888 bitmap 'src' uses at most 256 colors, set 'dst' to an equivalent
+    kIndex8 bitmap whose indices live in 'storage', and return true.
+
+    The palette is ordered with the translucent colors first, so that
+    pack_palette() can write the shortest possible tRNS chunk.
+*/
+static bool reduce_to_palette(const SkBitmap& src, SkBitmap* dst,
+                              SkAutoMalloc* storage) {
+    SkASSERT(SkBitmap::kARGB_8888_Config == src.config());
+
+    SkAutoLockPixels alp(src);
+    if (NULL == src.getPixels() || src.width() <= 0 || src.height() <= 0) {
+        return false;
+    }
+
+    const int width = src.width();
+    const int height = src.height();
+    uint8_t* indices = (uint8_t*)storage->reset(width * height);
+
+    SkPNGPaletteBuilder builder;
+    // Tiles tend to have long runs of a single color, so remember the last
+    // lookup and skip the hash table while the color doesn't change.
+    SkPMColor lastColor = *src.getAddr32(0, 0);
+    int lastIndex = builder.lookup(lastColor);
+    for (int y = 0; y < height; y++) {
+        const SkPMColor* SK_RESTRICT row = src.getAddr32(0, y);
+        uint8_t* SK_RESTRICT dstRow = indices + y * width;
+        for (int x = 0; x < width; x++) {
+            const SkPMColor c = row[x];
+            if (c != lastColor) {
+                lastIndex = builder.lookup(c);
+                if (lastIndex < 0) {
+                    return false;
+                }
+                lastColor = c;
+            }
+            dstRow[x] = lastIndex;
+        }
+    }
+
+    const int count = builder.count();
+    const SkPMColor* colors = builder.colors();
+
+    // Stable partition into translucent colors followed by opaque ones.
+    SkPMColor sorted[256];
+    uint8_t remap[256];
+    int numTrans = 0;
+    for (int i = 0; i < count; i++) {
+        if (SkGetPackedA32(colors[i]) != 0xFF) {
+            numTrans += 1;
+        }
+    }
+    bool needsRemap = false;
+    int nextTrans = 0;
+    int nextOpaque = numTrans;
+    for (int i = 0; i < count; i++) {
+        int newIndex = (SkGetPackedA32(colors[i]) != 0xFF) ? nextTrans++
+                                                            : nextOpaque++;
+        sorted[newIndex] = colors[i];
+        remap[i] = newIndex;
+        needsRemap |= (newIndex != i);
+    }
+    if (needsRemap) {
+        for (int i = 0; i < width * height; i++) {
+            indices[i] = remap[indices[i]];
+        }
+    }
+
+    SkColorTable* ctable = SkNEW_ARGS(SkColorTable, (sorted, count));
+    if (0 == numTrans) {
+        ctable->setFlags(ctable->getFlags() | SkColorTable::kColorsAreOpaque_Flag);
+    }
+    dst->setConfig(SkBitmap::kIndex8_Config, width, height);
+    dst->setPixels(indices, ctable);
+    ctable->unref();
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Row filtering and parallel deflate
+
+#include "SkData.h"
+#include "SkRunnable.h"
+#include "SkThreadPool.h"
+
+// png.h no longer pulls this in as of libpng 1.5.
+#include "zlib.h"
+
+// Describes how to turn bitmap rows into unfiltered PNG rows.
+struct SkPNGRowSource {
+    const char*             fPixels;
+    size_t                  fRowBytes;
+    int                     fWidth;
+    transform_scanline_proc fProc;
+    // Size of a transformed row, and of one whole pixel within it.
+    size_t                  fPNGRowBytes;
+    int                     fBytesPerPixel;
+
+    void transformRow(int y, uint8_t* dst) const {
+        fProc(fPixels + y * fRowBytes, fWidth, (char*)dst);
+    }
+};
+
+// Filter value for SkPNGDeflateBlock that tries all of the filters per row.
+static const int kAdaptive_PNGFilter = -1;
+
+static inline int paeth_predictor(int a, int b, int c) {
+    int p = b - c;
+    int pc = a - c;
+    int pa = SkAbs32(p);
+    int pb = SkAbs32(pc);
+    pc = SkAbs32(p + pc);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return (pb <= pc) ? b : c;
+}
+
+/*  Write the filter type byte followed by 'row' filtered against 'prev' into
+    'dst', and return the sum of the filtered bytes treated as signed values,
+    which is the usual heuristic for how well the row will compress.
+*/
+static uint32_t filter_row(int filter, const uint8_t* SK_RESTRICT row,
+                           const uint8_t* SK_RESTRICT prev, size_t rowBytes,
+                           int bpp, uint8_t* SK_RESTRICT dst) {
+    *dst++ = filter;
+    size_t i = 0;
+    switch (filter) {
+        case PNG_FILTER_VALUE_NONE:
+            memcpy(dst, row, rowBytes);
+            break;
+        case PNG_FILTER_VALUE_SUB:
+            for (; i < (size_t)bpp && i < rowBytes; i++) {
+                dst[i] = row[i];
+            }
+            for (; i < rowBytes; i++) {
+                dst[i] = row[i] - row[i - bpp];
+            }
+            break;
+        case PNG_FILTER_VALUE_UP:
+            for (; i < rowBytes; i++) {
+                dst[i] = row[i] - prev[i];
+            }
+            break;
+        case PNG_FILTER_VALUE_AVG:
+            for (; i < (size_t)bpp && i < rowBytes; i++) {
+                dst[i] = row[i] - (prev[i] >> 1);
+            }
+            for (; i < rowBytes; i++) {
+                dst[i] = row[i] - ((row[i - bpp] + prev[i]) >> 1);
+            }
+            break;
+        case PNG_FILTER_VALUE_PAETH:
+            for (; i < (size_t)bpp && i < rowBytes; i++) {
+                dst[i] = row[i] - prev[i];
+            }
+            for (; i < rowBytes; i++) {
+                dst[i] = row[i] - paeth_predictor(row[i - bpp], prev[i],
+                                                  prev[i - bpp]);
+            }
+            break;
+        default:
+            SkASSERT(false);
+            break;
+    }
+
+    uint32_t sum = 0;
+    for (i = 0; i < rowBytes; i++) {
+        sum += (dst[i] < 128) ? dst[i] : 256 - dst[i];
+    }
+    return sum;
+}
+
+/*  Filters and deflates rows [fStartY, fStopY) of an image into a raw deflate
+    stream. Every block but the last ends with a sync flush rather than a
+    final block, so the blocks' outputs can simply be concatenated.
+*/
+class SkPNGDeflateBlock : public SkRunnable {
+public:
+    SkPNGDeflateBlock(const SkPNGRowSource& source, int startY, int stopY,
+                      int level, int filter, bool isLast)
+        : fSource(source)
+        , fStartY(startY)
+        , fStopY(stopY)
+        , fLevel(level)
+        , fFilter(filter)
+        , fIsLast(isLast)
+        , fSuccess(false)
+        , fAdler(1)
+        , fInputLength(0) {}
+
+    virtual void run() SK_OVERRIDE {
+        fSuccess = this->deflateRows();
+    }
+
+    bool success() const { return fSuccess; }
+    // Adler-32 and length of the filtered (uncompressed) data.
+    uLong adler() const { return fAdler; }
+    uLong inputLength() const { return fInputLength; }
+    SkDynamicMemoryWStream& output() { return fOutput; }
+
+private:
+    enum { kBufferSize = 16 * 1024 };
+
+    bool deflateRows() {
+        const size_t rowBytes = fSource.fPNGRowBytes;
+        const size_t filteredBytes = rowBytes + 1;
+        const int filterCount = (kAdaptive_PNGFilter == fFilter) ?
+                                PNG_FILTER_VALUE_LAST : 1;
+
+        // prev, curr, then one filtered row per candidate filter.
+        SkAutoMalloc storage(2 * rowBytes + filterCount * filteredBytes);
+        uint8_t* prev = (uint8_t*)storage.get();
+        uint8_t* curr = prev + rowBytes;
+        uint8_t* filtered = curr + rowBytes;
+
+        // The first row of the image is filtered against a row of zeros.
+        if (fStartY > 0) {
+            fSource.transformRow(fStartY - 1, prev);
+        } else {
+            memset(prev, 0, rowBytes);
+        }
+
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        // Negative window bits: no zlib header or trailer, the join adds them.
+        if (Z_OK != deflateInit2(&stream, fLevel, Z_DEFLATED, -MAX_WBITS, 8,
+                                 Z_DEFAULT_STRATEGY)) {
+            return false;
+        }
+
+        uint8_t outBuffer[kBufferSize];
+        bool ok = true;
+        for (int y = fStartY; y < fStopY && ok; y++) {
+            fSource.transformRow(y, curr);
+
+            const uint8_t* best = filtered;
+            if (kAdaptive_PNGFilter == fFilter) {
+                uint32_t bestSum = SK_MaxU32;
+                for (int f = 0; f < PNG_FILTER_VALUE_LAST; f++) {
+                    uint8_t* candidate = filtered + f * filteredBytes;
+                    uint32_t sum = filter_row(f, curr, prev, rowBytes,
+                                              fSource.fBytesPerPixel, candidate);
+                    if (sum < bestSum) {
+                        bestSum = sum;
+                        best = candidate;
+                    }
+                }
+            } else {
+                filter_row(fFilter, curr, prev, rowBytes,
+                           fSource.fBytesPerPixel, filtered);
+            }
+            fAdler = adler32(fAdler, best, filteredBytes);
+            fInputLength += filteredBytes;
+
+            int flush = Z_NO_FLUSH;
+            if (y == fStopY - 1) {
+                flush = fIsLast ? Z_FINISH : Z_SYNC_FLUSH;
+            }
+            stream.next_in = (Bytef*)best;
+            stream.avail_in = filteredBytes;
+            do {
+                stream.next_out = outBuffer;
+                stream.avail_out = kBufferSize;
+                int rc = deflate(&stream, flush);
+                if (Z_STREAM_ERROR == rc) {
+                    ok = false;
+                    break;
+                }
+                size_t produced = kBufferSize - stream.avail_out;
+                if (produced > 0 && !fOutput.write(outBuffer, produced)) {
+                    ok = false;
+                    break;
+                }
+            } while (0 == stream.avail_out);
+
+            SkTSwap(prev, curr);
+        }
+        deflateEnd(&stream);
+        return ok;
+    }
+
+    const SkPNGRowSource    fSource;
+    const int               fStartY;
+    const int               fStopY;
+    const int               fLevel;
+    const int               fFilter;
+    const bool              fIsLast;
+
+    bool                    fSuccess;
+    uLong                   fAdler;
+    uLong                   fInputLength;
+    SkDynamicMemoryWStream  fOutput;
+};
+
+/*  Splits the image data into blocks of rows, deflates them on a thread pool,
+    and writes the result as one zlib stream in a series of IDAT chunks. This
+    is the approach pigz takes, minus priming each block with the previous
+    block's window, so it compresses slightly worse than a single stream.
+*/
+class SkPNGParallelDeflater {
+public:
+    ~SkPNGParallelDeflater() {
+        fBlocks.deleteAll();
+    }
+
+    /** Deflate all of the rows. Returns false (having done nothing) if the
+        image is too small to be worth splitting up, or if deflate failed.
+     */
+    bool deflate(const SkPNGRowSource& source, int height, int level,
+                 int filter, int threadCount) {
+        SkASSERT(fBlocks.isEmpty());
+
+        // Big enough that each block's compression gets up to speed, small
+        // enough that a typical 512x512 tile keeps a few threads busy.
+        static const size_t kTargetBlockBytes = 128 * 1024;
+        const size_t filteredBytes = source.fPNGRowBytes + 1;
+        int rowsPerBlock = SkTMax<int>(1, kTargetBlockBytes / filteredBytes);
+        if (rowsPerBlock >= height) {
+            return false;
+        }
+
+        fLevel = level;
+        for (int y = 0; y < height; y += rowsPerBlock) {
+            int stopY = SkTMin(y + rowsPerBlock, height);
+            *fBlocks.append() = SkNEW_ARGS(SkPNGDeflateBlock,
+                                           (source, y, stopY, level, filter,
+                                            stopY == height));
+        }
+
+        {
+            // The pool's destructor waits for all of the blocks to finish.
+            SkThreadPool pool(threadCount);
+            for (int i = 0; i < fBlocks.count(); i++) {
+                pool.add(fBlocks[i]);
+            }
+        }
+
+        for (int i = 0; i < fBlocks.count(); i++) {
+            if (!fBlocks[i]->success()) {
+                fBlocks.deleteAll();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /** Write the deflated data as IDAT chunks, followed by IEND. This replaces
+        png_write_end(), which insists on libpng having written the IDATs.
+     */
+    void writeChunks(png_structp png_ptr) {
+        static const png_byte kIDAT[5] = { 'I', 'D', 'A', 'T', '\0' };
+        static const png_byte kIEND[5] = { 'I', 'E', 'N', 'D', '\0' };
+
+        // zlib header (RFC 1950): deflate with a 32K window, the level hint,
+        // and check bits making the pair a multiple of 31.
+        png_byte header[2];
+        header[0] = 0x78;
+        int levelHint;
+        if (fLevel == Z_DEFAULT_COMPRESSION || fLevel == 6) {
+            levelHint = 2;
+        } else if (fLevel < 2) {
+            levelHint = 0;
+        } else if (fLevel < 6) {
+            levelHint = 1;
+        } else {
+            levelHint = 3;
+        }
+        header[1] = levelHint << 6;
+        header[1] += 31 - ((header[0] << 8) + header[1]) % 31;
+
+        uLong adler = 1;
+        for (int i = 0; i < fBlocks.count(); i++) {
+            SkPNGDeflateBlock* block = fBlocks[i];
+            adler = adler32_combine(adler, block->adler(),
+                                    (z_off_t)block->inputLength());
+        }
+        png_byte trailer[4];
+        trailer[0] = (adler >> 24) & 0xFF;
+        trailer[1] = (adler >> 16) & 0xFF;
+        trailer[2] = (adler >> 8) & 0xFF;
+        trailer[3] = adler & 0xFF;
+
+        // One IDAT per block, with the zlib header in the first and the
+        // checksum in the last.
+        for (int i = 0; i < fBlocks.count(); i++) {
+            const bool isFirst = (0 == i);
+            const bool isLast = (fBlocks.count() - 1 == i);
+            SkAutoTUnref<SkData> data(fBlocks[i]->output().copyToData());
+
+            size_t length = data->size();
+            if (isFirst) {
+                length += sizeof(header);
+            }
+            if (isLast) {
+                length += sizeof(trailer);
+            }
+            png_write_chunk_start(png_ptr, (png_bytep)kIDAT, length);
+            if (isFirst) {
+                png_write_chunk_data(png_ptr, header, sizeof(header));
+            }
+            png_write_chunk_data(png_ptr, (png_bytep)data->data(), data->size());
+            if (isLast) {
+                png_write_chunk_data(png_ptr, trailer, sizeof(trailer));
+            }
+            png_write_chunk_end(png_ptr);
+        }
+        png_write_chunk(png_ptr, (png_bytep)kIEND, NULL, 0);
+    }
+
+private:
+    SkTDArray<SkPNGDeflateBlock*>   fBlocks;
+    int                             fLevel;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+static bool do_encode(SkWStream* stream, const SkBitmap& bitmap,
+                      const SkPNGImageEncoder::Options& options,
+                      const bool& hasAlpha, int colorType,
+                      int bitDepth, SkBitmap::Config config,
+                      png_color_8& sig_bit);
+
+static bool encode_bitmap(SkWStream* stream, const SkBitmap& bitmap,
+                          const SkPNGImageEncoder::Options& options) {
     SkBitmap::Config config = bitmap.getConfig();
 
     const bool hasAlpha = !bitmap.isOpaque();
@@ -1087,14 +1550,95 @@ bool SkPNGImageEncoder::onEncode(SkWStream* stream, const SkBitmap& bitmap,
         bitDepth = computeBitDepth(ctable->count());
     }
 
-    return doEncode(stream, bitmap, hasAlpha, colorType,
-                    bitDepth, config, sig_bit);
+    return do_encode(stream, bitmap, options, hasAlpha, colorType,
+                     bitDepth, config, sig_bit);
 }
 
-bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
-                  const bool& hasAlpha, int colorType,
-                  int bitDepth, SkBitmap::Config config,
-                  png_color_8& sig_bit) {
+bool SkPNGImageEncoder::onEncode(SkWStream* stream, const SkBitmap& bitmap,
+                                 int /*quality*/) {
+    if (fOptions.fPaletteReduction &&
+        SkBitmap::kARGB_8888_Config == bitmap.getConfig()) {
+        SkBitmap indexed;
+        SkAutoMalloc indices;
+        if (reduce_to_palette(bitmap, &indexed, &indices)) {
+            return encode_bitmap(stream, indexed, fOptions);
+        }
+    }
+    return encode_bitmap(stream, bitmap, fOptions);
+}
+
+static int png_filter_flags(SkPNGImageEncoder::FilterStrategy strategy) {
+    switch (strategy) {
+        case SkPNGImageEncoder::kNone_FilterStrategy:
+            return PNG_FILTER_NONE;
+        case SkPNGImageEncoder::kSub_FilterStrategy:
+            return PNG_FILTER_SUB;
+        case SkPNGImageEncoder::kUp_FilterStrategy:
+            return PNG_FILTER_UP;
+        case SkPNGImageEncoder::kAverage_FilterStrategy:
+            return PNG_FILTER_AVG;
+        case SkPNGImageEncoder::kPaeth_FilterStrategy:
+            return PNG_FILTER_PAETH;
+        default:
+            return PNG_ALL_FILTERS;
+    }
+}
+
+// The filter value the parallel deflater should use, matching what libpng
+// would pick for the same strategy.
+static int png_filter_value(SkPNGImageEncoder::FilterStrategy strategy,
+                            int colorType) {
+    switch (strategy) {
+        case SkPNGImageEncoder::kDefault_FilterStrategy:
+            // libpng doesn't filter palette images by default.
+            return (colorType & PNG_COLOR_MASK_PALETTE) ?
+                   PNG_FILTER_VALUE_NONE : kAdaptive_PNGFilter;
+        case SkPNGImageEncoder::kNone_FilterStrategy:
+            return PNG_FILTER_VALUE_NONE;
+        case SkPNGImageEncoder::kSub_FilterStrategy:
+            return PNG_FILTER_VALUE_SUB;
+        case SkPNGImageEncoder::kUp_FilterStrategy:
+            return PNG_FILTER_VALUE_UP;
+        case SkPNGImageEncoder::kAverage_FilterStrategy:
+            return PNG_FILTER_VALUE_AVG;
+        case SkPNGImageEncoder::kPaeth_FilterStrategy:
+            return PNG_FILTER_VALUE_PAETH;
+        default:
+            return kAdaptive_PNGFilter;
+    }
+}
+
+static bool do_encode(SkWStream* stream, const SkBitmap& bitmap,
+                      const SkPNGImageEncoder::Options& options,
+                      const bool& hasAlpha, int colorType,
+                      int bitDepth, SkBitmap::Config config,
+                      png_color_8& sig_bit) {
+
+    const int level = options.fCompressionLevel;
+    SkASSERT(SkPNGImageEncoder::Options::kDefault_CompressionLevel == level ||
+             (level >= Z_NO_COMPRESSION && level <= Z_BEST_COMPRESSION));
+
+    SkPNGRowSource source;
+    source.fPixels = (const char*)bitmap.getPixels();
+    source.fRowBytes = bitmap.rowBytes();
+    source.fWidth = bitmap.width();
+    source.fProc = choose_proc(config, hasAlpha);
+    if (colorType & PNG_COLOR_MASK_PALETTE) {
+        source.fBytesPerPixel = 1;
+    } else {
+        source.fBytesPerPixel = (colorType & PNG_COLOR_MASK_ALPHA) ? 4 : 3;
+    }
+    source.fPNGRowBytes = bitmap.width() * source.fBytesPerPixel;
+
+    // Deflate up front, so that nothing below the setjmp needs cleaning up.
+    SkPNGParallelDeflater deflater;
+    bool deflated = false;
+    if (0 != options.fThreadCount && 8 == bitDepth) {
+        deflated = deflater.deflate(source, bitmap.height(), level,
+                                    png_filter_value(options.fFilterStrategy,
+                                                     colorType),
+                                    options.fThreadCount);
+    }
 
     png_structp png_ptr;
     png_infop info_ptr;
@@ -1121,6 +1665,16 @@ bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
 
     png_set_write_fn(png_ptr, (void*)stream, sk_write_fn, png_flush_ptr_NULL);
 
+    if (!deflated) {
+        if (SkPNGImageEncoder::Options::kDefault_CompressionLevel != level) {
+            png_set_compression_level(png_ptr, level);
+        }
+        if (SkPNGImageEncoder::kDefault_FilterStrategy != options.fFilterStrategy) {
+            png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE,
+                           png_filter_flags(options.fFilterStrategy));
+        }
+    }
+
     /* Set the image information here.  Width and height are up to 2^31,
     * bit_depth is one of 1, 2, 4, 8, or 16, but valid values also depend on
     * the color_type selected. color_type is one of PNG_COLOR_TYPE_GRAY,
@@ -1150,19 +1704,19 @@ bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
     png_set_sBIT(png_ptr, info_ptr, &sig_bit);
     png_write_info(png_ptr, info_ptr);
 
-    const char* srcImage = (const char*)bitmap.getPixels();
-    SkAutoSMalloc<1024> rowStorage(bitmap.width() << 2);
-    char* storage = (char*)rowStorage.get();
-    transform_scanline_proc proc = choose_proc(config, hasAlpha);
+    if (deflated) {
+        deflater.writeChunks(png_ptr);
+    } else {
+        SkAutoSMalloc<1024> rowStorage(bitmap.width() << 2);
+        png_bytep row_ptr = (png_bytep)rowStorage.get();
 
-    for (int y = 0; y < bitmap.height(); y++) {
-        png_bytep row_ptr = (png_bytep)storage;
-        proc(srcImage, bitmap.width(), storage);
-        png_write_rows(png_ptr, &row_ptr, 1);
-        srcImage += bitmap.rowBytes();
-    }
+        for (int y = 0; y < bitmap.height(); y++) {
+            source.transformRow(y, row_ptr);
+            png_write_rows(png_ptr, &row_ptr, 1);
+        }
 
-    png_write_end(png_ptr, info_ptr);
+        png_write_end(png_ptr, info_ptr);
+    }
 
     /* clean up after the write, and free any memory allocated */
     png_destroy_write_struct(&png_ptr, &info_ptr);
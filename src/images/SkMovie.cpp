@@ -82,6 +82,16 @@ const SkBitmap& SkMovie::bitmap()
     return fBitmap;
 }
 
+void SkMovie::setFrameCacheLimit(size_t bytes)
+{
+    this->onSetFrameCacheLimit(bytes);
+}
+
+bool SkMovie::predecodeFrames()
+{
+    return this->onPredecodeFrames();
+}
+
 ////////////////////////////////////////////////////////////////////
 
 #include "SkStream.h"
@@ -8,14 +8,47 @@
 
 
 #include "SkMovie.h"
+#include "SkMovie_gif.h"
 #include "SkColor.h"
 #include "SkColorPriv.h"
+#include "SkRunnable.h"
 #include "SkStream.h"
+#include "SkTArray.h"
 #include "SkTemplates.h"
+#include "SkThread.h"
+#include "SkThreadPool.h"
 #include "SkUtils.h"
 
 #include "gif_lib.h"
 
+// Composites the frames of a GIF in order, keeping the state (the canvas and
+// the "restore to previous" backup) needed to move on to the next frame.
+class SkGIFCompositor {
+public:
+    SkGIFCompositor() : fLastDrawIndex(-1), fPaintingColor(0) {}
+
+    int lastDrawIndex() const { return fLastDrawIndex; }
+    const SkBitmap& bitmap() const { return fBitmap; }
+
+    // Draw frames up to and including 'index', starting over from the first
+    // frame if we are already past it.
+    bool drawTo(const GifFileType* gif, int index);
+
+    // Take 'keyframe' as the result of having drawn up to frame 'index'.
+    // Frame 'index' must not have "restore to previous" disposal, since we
+    // don't have the backup it would restore. On failure, the next drawTo()
+    // starts over from the first frame.
+    bool resetTo(const GifFileType* gif, const SkBitmap& keyframe, int index);
+
+private:
+    bool allocBitmaps(const GifFileType* gif);
+
+    SkBitmap fBitmap;
+    SkBitmap fBackup;
+    int fLastDrawIndex;
+    SkColor fPaintingColor;
+};
+
 class SkGIFMovie : public SkMovie {
 public:
     SkGIFMovie(SkStream* stream);
@@ -25,12 +58,40 @@ protected:
     virtual bool onGetInfo(Info*);
     virtual bool onSetTime(SkMSec);
     virtual bool onGetBitmap(SkBitmap*);
+    virtual void onSetFrameCacheLimit(size_t);
+    virtual bool onPredecodeFrames();
 
 private:
+    class PredecodeRunnable : public SkRunnable {
+    public:
+        explicit PredecodeRunnable(SkGIFMovie* movie) : fMovie(movie) {}
+        virtual void run() SK_OVERRIDE { fMovie->predecode(); }
+    private:
+        SkGIFMovie* fMovie;
+    };
+
+    // Caller must hold fCacheMutex.
+    bool shouldCache(int index) const {
+        return fCacheInterval > 0 && 0 == index % fCacheInterval;
+    }
+    void cacheFrame(int index, const SkBitmap& frame);
+    // Runs on fPredecodeThread.
+    void predecode();
+
     GifFileType* fGIF;
     int fCurrIndex;
     int fLastDrawIndex;
-    SkBitmap fBackup;
+    SkGIFCompositor fCompositor;
+
+    // Fully composited frames, indexed by frame; empty where not cached.
+    SkMutex fCacheMutex;
+    SkTArray<SkBitmap> fFrameCache;
+    // Every fCacheInterval'th frame is cached, or none if 0.
+    int fCacheInterval;
+
+    SkThreadPool* fPredecodeThread;
+    PredecodeRunnable fPredecodeRunnable;
+    volatile bool fAbortPredecode;
 };
 
 static int Decode(GifFileType* fileType, GifByteType* out, int size) {
@@ -39,6 +100,12 @@ static int Decode(GifFileType* fileType, GifByteType* out, int size) {
 }
 
 SkGIFMovie::SkGIFMovie(SkStream* stream)
+    : fCurrIndex(-1)
+    , fLastDrawIndex(-1)
+    , fCacheInterval(0)
+    , fPredecodeThread(NULL)
+    , fPredecodeRunnable(this)
+    , fAbortPredecode(false)
 {
 #if GIFLIB_MAJOR < 5
     fGIF = DGifOpen( stream, Decode );
@@ -52,13 +119,17 @@ SkGIFMovie::SkGIFMovie(SkStream* stream)
     {
         DGifCloseFile(fGIF);
         fGIF = NULL;
+        return;
     }
-    fCurrIndex = -1;
-    fLastDrawIndex = -1;
+    fFrameCache.push_back_n(fGIF->ImageCount);
 }
 
 SkGIFMovie::~SkGIFMovie()
 {
+    // Deleting the pool waits for any predecode in progress to bail out.
+    fAbortPredecode = true;
+    SkDELETE(fPredecodeThread);
+
     if (fGIF)
         DGifCloseFile(fGIF);
 }
@@ -336,48 +407,145 @@ static void disposeFrameIfNeeded(SkBitmap* bm, const SavedImage* cur, const Save
     }
 }
 
-bool SkGIFMovie::onGetBitmap(SkBitmap* bm)
+// The color that the canvas is cleared to, and that "restore to background"
+// disposal fills with.
+static SkColor painting_color(const GifFileType* gif)
 {
-    const GifFileType* gif = fGIF;
-    if (NULL == gif)
-        return false;
+    bool trans;
+    int disposal;
+    getTransparencyAndDisposalMethod(&gif->SavedImages[0], &trans, &disposal);
+    if (!trans && gif->SColorMap != NULL) {
+        const GifColorType& col = gif->SColorMap->Colors[gif->SBackGroundColor];
+        return SkColorSetARGB(0xFF, col.Red, col.Green, col.Blue);
+    }
+    return SkColorSetARGB(0, 0, 0, 0);
+}
 
-    if (gif->ImageCount < 1) {
+static bool is_restore_to_previous(const SavedImage* frame)
+{
+    bool trans;
+    int disposal;
+    getTransparencyAndDisposalMethod(frame, &trans, &disposal);
+    return 3 == disposal;
+}
+
+bool SkGIFCompositor::allocBitmaps(const GifFileType* gif)
+{
+    // create bitmap
+    fBitmap.setConfig(SkBitmap::kARGB_8888_Config, gif->SWidth, gif->SHeight, 0);
+    if (!fBitmap.allocPixels(NULL)) {
         return false;
     }
-
-    const int width = gif->SWidth;
-    const int height = gif->SHeight;
-    if (width <= 0 || height <= 0) {
+    // create bitmap for backup
+    fBackup.setConfig(SkBitmap::kARGB_8888_Config, gif->SWidth, gif->SHeight, 0);
+    if (!fBackup.allocPixels(NULL)) {
         return false;
     }
+    return true;
+}
+
+bool SkGIFCompositor::drawTo(const GifFileType* gif, int lastIndex)
+{
+    SkASSERT(lastIndex >= 0 && lastIndex < gif->ImageCount);
 
     // no need to draw
-    if (fLastDrawIndex >= 0 && fLastDrawIndex == fCurrIndex) {
+    if (fLastDrawIndex >= 0 && fLastDrawIndex == lastIndex) {
         return true;
     }
 
     int startIndex = fLastDrawIndex + 1;
-    if (fLastDrawIndex < 0 || !bm->readyToDraw()) {
+    if (fLastDrawIndex < 0 || !fBitmap.readyToDraw()) {
         // first time
-
         startIndex = 0;
-
-        // create bitmap
-        bm->setConfig(SkBitmap::kARGB_8888_Config, width, height, 0);
-        if (!bm->allocPixels(NULL)) {
+        if (!this->allocBitmaps(gif)) {
             return false;
         }
-        // create bitmap for backup
-        fBackup.setConfig(SkBitmap::kARGB_8888_Config, width, height, 0);
-        if (!fBackup.allocPixels(NULL)) {
-            return false;
-        }
-    } else if (startIndex > fCurrIndex) {
+    } else if (startIndex > lastIndex) {
         // rewind to 1st frame for repeat
         startIndex = 0;
     }
 
+    // draw each frames - not intelligent way
+    for (int i = startIndex; i <= lastIndex; i++) {
+        const SavedImage* cur = &gif->SavedImages[i];
+        if (i == 0) {
+            fPaintingColor = painting_color(gif);
+            fBitmap.eraseColor(fPaintingColor);
+            fBackup.eraseColor(fPaintingColor);
+        } else {
+            // Dispose previous frame before move to next frame.
+            const SavedImage* prev = &gif->SavedImages[i-1];
+            disposeFrameIfNeeded(&fBitmap, prev, cur, &fBackup, fPaintingColor);
+        }
+
+        // Draw frame
+        // We can skip this process if this index is not last and disposal
+        // method == 2 or method == 3
+        if (i == lastIndex || !checkIfWillBeCleared(cur)) {
+            drawFrame(&fBitmap, cur, gif->SColorMap);
+        }
+    }
+    fBitmap.notifyPixelsChanged();
+
+    // save index
+    fLastDrawIndex = lastIndex;
+    return true;
+}
+
+bool SkGIFCompositor::resetTo(const GifFileType* gif, const SkBitmap& keyframe,
+                              int index)
+{
+    SkASSERT(!is_restore_to_previous(&gif->SavedImages[index]));
+
+    const bool needBitmaps = fLastDrawIndex < 0 || !fBitmap.readyToDraw();
+    // Until the keyframe is copied, fBitmap holds neither it nor what was
+    // drawn before.
+    fLastDrawIndex = -1;
+    if (needBitmaps && !this->allocBitmaps(gif)) {
+        return false;
+    }
+    SkAutoLockPixels alp(keyframe);
+    if (!keyframe.copyPixelsTo(fBitmap.getPixels(), fBitmap.getSize(),
+                               fBitmap.rowBytes())) {
+        return false;
+    }
+    fBitmap.notifyPixelsChanged();
+    fPaintingColor = painting_color(gif);
+    fLastDrawIndex = index;
+    return true;
+}
+
+void SkGIFMovie::cacheFrame(int index, const SkBitmap& frame)
+{
+    SkBitmap copy;
+    if (!frame.copyTo(&copy, SkBitmap::kARGB_8888_Config)) {
+        return;
+    }
+    copy.setImmutable();
+
+    SkAutoMutexAcquire ac(fCacheMutex);
+    // The limit may have changed while we were copying.
+    if (this->shouldCache(index)) {
+        fFrameCache[index].swap(copy);
+    }
+}
+
+bool SkGIFMovie::onGetBitmap(SkBitmap* bm)
+{
+    const GifFileType* gif = fGIF;
+    if (NULL == gif)
+        return false;
+
+    if (gif->ImageCount < 1) {
+        return false;
+    }
+
+    const int width = gif->SWidth;
+    const int height = gif->SHeight;
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
     int lastIndex = fCurrIndex;
     if (lastIndex < 0) {
         // first time
@@ -387,52 +555,121 @@ bool SkGIFMovie::onGetBitmap(SkBitmap* bm)
         lastIndex = fGIF->ImageCount - 1;
     }
 
-    SkColor bgColor = SkPackARGB32(0, 0, 0, 0);
-    if (gif->SColorMap != NULL) {
-        const GifColorType& col = gif->SColorMap->Colors[fGIF->SBackGroundColor];
-        bgColor = SkColorSetARGB(0xFF, col.Red, col.Green, col.Blue);
+    // no need to draw
+    if (fLastDrawIndex >= 0 && fLastDrawIndex == lastIndex) {
+        return true;
     }
 
-    static SkColor paintingColor = SkPackARGB32(0, 0, 0, 0);
-    // draw each frames - not intelligent way
-    for (int i = startIndex; i <= lastIndex; i++) {
-        const SavedImage* cur = &fGIF->SavedImages[i];
-        if (i == 0) {
-            bool trans;
-            int disposal;
-            getTransparencyAndDisposalMethod(cur, &trans, &disposal);
-            if (!trans && gif->SColorMap != NULL) {
-                paintingColor = bgColor;
-            } else {
-                paintingColor = SkColorSetARGB(0, 0, 0, 0);
-            }
-
-            bm->eraseColor(paintingColor);
-            fBackup.eraseColor(paintingColor);
-        } else {
-            // Dispose previous frame before move to next frame.
-            const SavedImage* prev = &fGIF->SavedImages[i-1];
-            disposeFrameIfNeeded(bm, prev, cur, &fBackup, paintingColor);
+    bool cacheResult = false;
+    {
+        SkAutoMutexAcquire ac(fCacheMutex);
+        if (!fFrameCache[lastIndex].isNull()) {
+            *bm = fFrameCache[lastIndex];
+            fLastDrawIndex = lastIndex;
+            return true;
         }
 
-        // Draw frame
-        // We can skip this process if this index is not last and disposal
-        // method == 2 or method == 3
-        if (i == lastIndex || !checkIfWillBeCleared(cur)) {
-            drawFrame(bm, cur, gif->SColorMap);
+        // Rather than replaying from the first frame (or from wherever the
+        // compositor got to), start from the closest earlier keyframe.
+        int drawnIndex = fCompositor.lastDrawIndex();
+        if (drawnIndex > lastIndex) {
+            drawnIndex = -1;
         }
+        for (int i = lastIndex - 1; i > drawnIndex; i--) {
+            // If the compositor cannot take this keyframe, try an earlier
+            // one, and failing that, replay from the first frame.
+            if (!fFrameCache[i].isNull() &&
+                !is_restore_to_previous(&gif->SavedImages[i]) &&
+                fCompositor.resetTo(gif, fFrameCache[i], i)) {
+                break;
+            }
+        }
+        cacheResult = this->shouldCache(lastIndex);
     }
 
-    // save index
+    if (!fCompositor.drawTo(gif, lastIndex)) {
+        return false;
+    }
+    if (cacheResult) {
+        this->cacheFrame(lastIndex, fCompositor.bitmap());
+    }
+
+    *bm = fCompositor.bitmap();
     fLastDrawIndex = lastIndex;
     return true;
 }
 
+void SkGIFMovie::onSetFrameCacheLimit(size_t bytes)
+{
+    if (NULL == fGIF || fGIF->ImageCount < 1) {
+        return;
+    }
+
+    const size_t frameBytes = (size_t)fGIF->SWidth * fGIF->SHeight * sizeof(SkPMColor);
+    const size_t maxFrames = frameBytes > 0 ? bytes / frameBytes : 0;
+    const int count = fGIF->ImageCount;
+
+    SkAutoMutexAcquire ac(fCacheMutex);
+    if (0 == maxFrames) {
+        fCacheInterval = 0;
+    } else if (maxFrames >= (size_t)count) {
+        fCacheInterval = 1;
+    } else {
+        fCacheInterval = (count + maxFrames - 1) / maxFrames;
+    }
+
+    // Drop whatever no longer fits the new spacing.
+    for (int i = 0; i < count; i++) {
+        if (!this->shouldCache(i)) {
+            fFrameCache[i].reset();
+        }
+    }
+}
+
+bool SkGIFMovie::onPredecodeFrames()
+{
+    if (NULL == fGIF) {
+        return false;
+    }
+    {
+        SkAutoMutexAcquire ac(fCacheMutex);
+        if (0 == fCacheInterval) {
+            return false;
+        }
+    }
+    if (NULL == fPredecodeThread) {
+        fPredecodeThread = SkNEW_ARGS(SkThreadPool, (1));
+    }
+    // Already cached frames are skipped, so queueing this again (e.g. after
+    // raising the limit) only does the new work.
+    fPredecodeThread->add(&fPredecodeRunnable);
+    return true;
+}
+
+void SkGIFMovie::predecode()
+{
+    // Our own compositor, so that the caller's thread can keep using
+    // fCompositor while we work.
+    SkGIFCompositor compositor;
+    for (int i = 0; i < fGIF->ImageCount && !fAbortPredecode; i++) {
+        {
+            SkAutoMutexAcquire ac(fCacheMutex);
+            if (!this->shouldCache(i) || !fFrameCache[i].isNull()) {
+                continue;
+            }
+        }
+        if (!compositor.drawTo(fGIF, i)) {
+            return;
+        }
+        this->cacheFrame(i, compositor.bitmap());
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SkTRegistry.h"
 
-SkMovie* Factory(SkStream* stream) {
+SkMovie* CreateGIFMovie(SkStream* stream) {
     char buf[GIF_STAMP_LEN];
     if (stream->read(buf, GIF_STAMP_LEN) == GIF_STAMP_LEN) {
         if (memcmp(GIF_STAMP,   buf, GIF_STAMP_LEN) == 0 ||
@@ -446,4 +683,4 @@ SkMovie* Factory(SkStream* stream) {
     return NULL;
 }
 
-static SkTRegistry<SkMovie*(*)(SkStream*)> gReg(Factory);
+static SkTRegistry<SkMovie*(*)(SkStream*)> gReg(CreateGIFMovie);
@@ -0,0 +1,20 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMovie_gif_DEFINED
+#define SkMovie_gif_DEFINED
+
+class SkMovie;
+class SkStream;
+
+/**
+ *  The GIF movie's registered factory, declared so that SkForceLinking() can
+ *  keep it linked in. Returns NULL if the stream is not a GIF.
+ */
+SkMovie* CreateGIFMovie(SkStream*);
+
+#endif // SkMovie_gif_DEFINED
@@ -8,16 +8,24 @@
 
 #include "SkScaledBitmapSampler.h"
 #include "SkBitmap.h"
+#include "SkBlitRow.h"
 #include "SkColorPriv.h"
+#include "SkConvertRow.h"
 #include "SkDither.h"
 #include "SkTypes.h"
 
 // 8888
 
+// When we are not subsampling, the src pixels are contiguous, and the
+// (possibly SIMD) SkConvertRow procs can do the work.
+
 static bool Sample_Gray_D8888(void* SK_RESTRICT dstRow,
                               const uint8_t* SK_RESTRICT src,
                               int width, int deltaSrc, int, const SkPMColor[]) {
     SkPMColor* SK_RESTRICT dst = (SkPMColor*)dstRow;
+    if (1 == deltaSrc) {
+        return SkConvertRow::Factory(SkConvertRow::kGray_SrcFormat)(dst, src, width);
+    }
     for (int x = 0; x < width; x++) {
         dst[x] = SkPackARGB32(0xFF, src[0], src[0], src[0]);
         src += deltaSrc;
@@ -29,6 +37,12 @@ static bool Sample_RGBx_D8888(void* SK_RESTRICT dstRow,
                               const uint8_t* SK_RESTRICT src,
                               int width, int deltaSrc, int, const SkPMColor[]) {
     SkPMColor* SK_RESTRICT dst = (SkPMColor*)dstRow;
+    if (3 == deltaSrc) {
+        return SkConvertRow::Factory(SkConvertRow::kRGB_SrcFormat)(dst, src, width);
+    }
+    if (4 == deltaSrc) {
+        return SkConvertRow::Factory(SkConvertRow::kRGBX_SrcFormat)(dst, src, width);
+    }
     for (int x = 0; x < width; x++) {
         dst[x] = SkPackARGB32(0xFF, src[0], src[1], src[2]);
         src += deltaSrc;
@@ -40,6 +54,9 @@ static bool Sample_RGBA_D8888(void* SK_RESTRICT dstRow,
                               const uint8_t* SK_RESTRICT src,
                               int width, int deltaSrc, int, const SkPMColor[]) {
     SkPMColor* SK_RESTRICT dst = (SkPMColor*)dstRow;
+    if (4 == deltaSrc) {
+        return SkConvertRow::Factory(SkConvertRow::kRGBA_SrcFormat)(dst, src, width);
+    }
     unsigned alphaMask = 0xFF;
     for (int x = 0; x < width; x++) {
         unsigned alpha = src[3];
@@ -52,6 +69,62 @@ static bool Sample_RGBA_D8888(void* SK_RESTRICT dstRow,
 
 // 565
 
+// RGB and Index rows are expanded to SkPMColors in small chunks, and then
+// handed to the SkBlitRow 565 procs, so that both steps can use the
+// platform's optimized versions.
+static const int kTmpRowPixels = 256;
+
+static void Blit_D565(uint16_t* SK_RESTRICT dst,
+                      const SkPMColor* SK_RESTRICT src,
+                      int count, int x, int y, bool dither) {
+    SkBlitRow::Proc proc = SkBlitRow::Factory(dither ? SkBlitRow::kDither_Flag : 0,
+                                              SkBitmap::kRGB_565_Config);
+    proc(dst, src, count, 0xFF, x, y);
+}
+
+static void RGBx_To_D565(void* SK_RESTRICT dstRow,
+                         const uint8_t* SK_RESTRICT src,
+                         int width, int deltaSrc, int y, bool dither) {
+    uint16_t* SK_RESTRICT dst = (uint16_t*)dstRow;
+    SkConvertRow::Proc convert = NULL;
+    if (3 == deltaSrc) {
+        convert = SkConvertRow::Factory(SkConvertRow::kRGB_SrcFormat);
+    } else if (4 == deltaSrc) {
+        convert = SkConvertRow::Factory(SkConvertRow::kRGBX_SrcFormat);
+    }
+
+    SkPMColor tmp[kTmpRowPixels];
+    for (int x = 0; x < width; x += kTmpRowPixels) {
+        int n = SkMin32(width - x, kTmpRowPixels);
+        if (convert) {
+            convert(tmp, src, n);
+            src += n * deltaSrc;
+        } else {
+            for (int i = 0; i < n; i++) {
+                tmp[i] = SkPackARGB32(0xFF, src[0], src[1], src[2]);
+                src += deltaSrc;
+            }
+        }
+        Blit_D565(dst + x, tmp, n, x, y, dither);
+    }
+}
+
+static void Index_To_D565(void* SK_RESTRICT dstRow,
+                          const uint8_t* SK_RESTRICT src,
+                          int width, int deltaSrc, int y,
+                          const SkPMColor ctable[], bool dither) {
+    uint16_t* SK_RESTRICT dst = (uint16_t*)dstRow;
+    SkPMColor tmp[kTmpRowPixels];
+    for (int x = 0; x < width; x += kTmpRowPixels) {
+        int n = SkMin32(width - x, kTmpRowPixels);
+        for (int i = 0; i < n; i++) {
+            tmp[i] = ctable[*src];
+            src += deltaSrc;
+        }
+        Blit_D565(dst + x, tmp, n, x, y, dither);
+    }
+}
+
 static bool Sample_Gray_D565(void* SK_RESTRICT dstRow,
                              const uint8_t* SK_RESTRICT src,
                              int width, int deltaSrc, int, const SkPMColor[]) {
@@ -77,12 +150,8 @@ static bool Sample_Gray_D565_D(void* SK_RESTRICT dstRow,
 
 static bool Sample_RGBx_D565(void* SK_RESTRICT dstRow,
                              const uint8_t* SK_RESTRICT src,
-                             int width, int deltaSrc, int, const SkPMColor[]) {
-    uint16_t* SK_RESTRICT dst = (uint16_t*)dstRow;
-    for (int x = 0; x < width; x++) {
-        dst[x] = SkPack888ToRGB16(src[0], src[1], src[2]);
-        src += deltaSrc;
-    }
+                             int width, int deltaSrc, int y, const SkPMColor[]) {
+    RGBx_To_D565(dstRow, src, width, deltaSrc, y, false);
     return false;
 }
 
@@ -101,12 +170,7 @@ static bool Sample_D565_D565(void* SK_RESTRICT dstRow,
 static bool Sample_RGBx_D565_D(void* SK_RESTRICT dstRow,
                                const uint8_t* SK_RESTRICT src,
                            int width, int deltaSrc, int y, const SkPMColor[]) {
-    uint16_t* SK_RESTRICT dst = (uint16_t*)dstRow;
-    DITHER_565_SCAN(y);
-    for (int x = 0; x < width; x++) {
-        dst[x] = SkDitherRGBTo565(src[0], src[1], src[2], DITHER_VALUE(x));
-        src += deltaSrc;
-    }
+    RGBx_To_D565(dstRow, src, width, deltaSrc, y, true);
     return false;
 }
 
@@ -216,29 +280,15 @@ static bool Sample_Index_D8888(void* SK_RESTRICT dstRow,
 
 static bool Sample_Index_D565(void* SK_RESTRICT dstRow,
                                const uint8_t* SK_RESTRICT src,
-                       int width, int deltaSrc, int, const SkPMColor ctable[]) {
-
-    uint16_t* SK_RESTRICT dst = (uint16_t*)dstRow;
-    for (int x = 0; x < width; x++) {
-        dst[x] = SkPixel32ToPixel16(ctable[*src]);
-        src += deltaSrc;
-    }
+                       int width, int deltaSrc, int y, const SkPMColor ctable[]) {
+    Index_To_D565(dstRow, src, width, deltaSrc, y, ctable, false);
     return false;
 }
 
 static bool Sample_Index_D565_D(void* SK_RESTRICT dstRow,
                                 const uint8_t* SK_RESTRICT src, int width,
                                 int deltaSrc, int y, const SkPMColor ctable[]) {
-
-    uint16_t* SK_RESTRICT dst = (uint16_t*)dstRow;
-    DITHER_565_SCAN(y);
-
-    for (int x = 0; x < width; x++) {
-        SkPMColor c = ctable[*src];
-        dst[x] = SkDitherRGBTo565(SkGetPackedR32(c), SkGetPackedG32(c),
-                                  SkGetPackedB32(c), DITHER_VALUE(x));
-        src += deltaSrc;
-    }
+    Index_To_D565(dstRow, src, width, deltaSrc, y, ctable, true);
     return false;
 }
 
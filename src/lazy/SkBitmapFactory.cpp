@@ -12,6 +12,8 @@
 #include "SkImageCache.h"
 #include "SkImagePriv.h"
 #include "SkLazyPixelRef.h"
+#include "SkRunnable.h"
+#include "SkThreadPool.h"
 
 SK_DEFINE_INST_COUNT(SkBitmapFactory::CacheSelector)
 
@@ -81,3 +83,43 @@ bool SkBitmapFactory::installPixelRef(SkData* data, SkBitmap* dst) {
         return fDecodeProc(data->data(), data->size(), &info, &target);
     }
 }
+
+namespace {
+class PrefetchRunnable : public SkRunnable {
+
+public:
+    PrefetchRunnable(SkPixelRef* pixelRef, SkRunnable* done)
+        : fPixelRef(SkSafeRef(pixelRef))
+        , fDone(done) {}
+
+    virtual void run() SK_OVERRIDE {
+        if (fPixelRef != NULL) {
+            // Locking decodes into the cache. Unlocking leaves the pixels there, unpinned.
+            fPixelRef->lockPixels();
+            fPixelRef->unlockPixels();
+            fPixelRef->unref();
+        }
+        if (fDone != NULL) {
+            fDone->run();
+        }
+        // SkThreadPool does not take ownership.
+        SkDELETE(this);
+    }
+
+private:
+    SkPixelRef* fPixelRef;
+    SkRunnable* fDone;
+};
+}
+
+void SkBitmapFactory::Prefetch(const SkBitmap bitmaps[], int count, SkThreadPool* pool,
+                               SkRunnable* done) {
+    for (int i = 0; i < count; i++) {
+        SkRunnable* runnable = SkNEW_ARGS(PrefetchRunnable, (bitmaps[i].pixelRef(), done));
+        if (NULL == pool) {
+            runnable->run();
+        } else {
+            pool->add(runnable);
+        }
+    }
+}
@@ -6,16 +6,21 @@
  */
 
 #include "SkLruImageCache.h"
+#include "SkTDynamicHash.h"
+#include "SkThread.h"
+#include "SkTInternalLList.h"
 
 SK_DEFINE_INST_COUNT(SkImageCache)
 SK_DEFINE_INST_COUNT(SkLruImageCache)
 
 static intptr_t NextGenerationID() {
-    static intptr_t gNextID;
+    // IDs are handed out without holding any shard's lock.
+    static int32_t gNextID;
+    int32_t id;
     do {
-        gNextID++;
-    } while (SkImageCache::UNINITIALIZED_ID == gNextID);
-    return gNextID;
+        id = sk_atomic_inc(&gNextID) + 1;
+    } while (SkImageCache::UNINITIALIZED_ID == id);
+    return id;
 }
 
 class CachedPixels : public SkNoncopyable {
@@ -34,7 +39,7 @@ public:
 
     void* getData() { return fAddr; }
 
-    intptr_t getID() const { return fID; }
+    const intptr_t& getID() const { return fID; }
 
     size_t getLength() const { return fLength; }
 
@@ -52,28 +57,108 @@ private:
     SK_DECLARE_INTERNAL_LLIST_INTERFACE(CachedPixels);
 };
 
-////////////////////////////////////////////////////////////////////////////////////
+/**
+ *  One slice of the cache. Every member is guarded by fMutex. Unpinned pixels are kept in LRU
+ *  order, and pinned pixels on a separate list, so that purging never has to step over them.
+ */
+class SkLruImageCache::Shard : public ::SkNoncopyable {
 
-SkLruImageCache::SkLruImageCache(size_t budget)
-    : fRamBudget(budget)
-    , fRamUsed(0) {}
+public:
+    ~Shard() {
+        // Don't worry about updating pointers. All will be deleted.
+        SkASSERT(fPinned.isEmpty());
+        DeleteAll(&fPinned);
+        DeleteAll(&fLRU);
+    }
 
-SkLruImageCache::~SkLruImageCache() {
-    // Don't worry about updating pointers. All will be deleted.
-    Iter iter;
-    CachedPixels* pixels = iter.init(fLRU, Iter::kTail_IterStart);
-    while (pixels != NULL) {
-        CachedPixels* prev = iter.prev();
+    CachedPixels* find(intptr_t ID) const {
+        return fHash.find(ID);
+    }
+
+    /** Add pixels, which must be pinned. */
+    void add(CachedPixels* pixels) {
+        SkASSERT(pixels->isLocked());
+        fHash.add(pixels);
+        fPinned.addToHead(pixels);
+    }
+
+    void pin(CachedPixels* pixels) {
+        fLRU.remove(pixels);
+        pixels->lock();
+        fPinned.addToHead(pixels);
+    }
+
+    void unpin(CachedPixels* pixels) {
+        fPinned.remove(pixels);
+        pixels->unlock();
+        fLRU.addToHead(pixels);
+    }
+
+    /** Free pixels, which must not be pinned. Returns the number of bytes freed. */
+    size_t remove(CachedPixels* pixels) {
         SkASSERT(!pixels->isLocked());
-#ifdef SK_DEBUG
-        fRamUsed -= pixels->getLength();
-#endif
+        const size_t size = pixels->getLength();
+        fHash.remove(pixels->getID());
+        fLRU.remove(pixels);
         SkDELETE(pixels);
-        pixels = prev;
+        return size;
+    }
+
+    /**
+     *  Free the least recently used pixels which are not pinned. Returns the number of bytes
+     *  freed, which is 0 if all the pixels in this shard are pinned.
+     */
+    size_t purgeOldest() {
+        CachedPixels* pixels = fLRU.tail();
+        return NULL == pixels ? 0 : this->remove(pixels);
     }
+
 #ifdef SK_DEBUG
-    SkASSERT(fRamUsed == 0);
+    // fMutex is mutable so that getMemoryStatus can be const
+    mutable
 #endif
+    SkMutex fMutex;
+
+private:
+    static const intptr_t& IDFromPixels(const CachedPixels& pixels) {
+        return pixels.getID();
+    }
+
+    static uint32_t HashFromID(const intptr_t& id) {
+        // The low kShardBits pick the shard, so they are the same for every ID in it.
+        return SkToU32(id >> kShardBits);
+    }
+
+    static bool EqPixelsID(const CachedPixels& pixels, const intptr_t& id) {
+        return pixels.getID() == id;
+    }
+
+    static void DeleteAll(SkTInternalLList<CachedPixels>* list) {
+        CachedPixels* pixels;
+        while (NULL != (pixels = list->head())) {
+            list->remove(pixels);
+            SkDELETE(pixels);
+        }
+    }
+
+    typedef SkTDynamicHash<CachedPixels, intptr_t, IDFromPixels, HashFromID, EqPixelsID> Hash;
+
+    // Linked list of recently used unpinned pixels. Head is the most recently used, and tail is
+    // the least.
+    SkTInternalLList<CachedPixels> fLRU;
+    SkTInternalLList<CachedPixels> fPinned;
+    Hash                           fHash;
+};
+
+////////////////////////////////////////////////////////////////////////////////////
+
+SkLruImageCache::SkLruImageCache(size_t budget)
+    : fShards(SkNEW_ARRAY(Shard, kShardCount))
+    , fRamBudget(budget)
+    , fRamUsed(0) {}
+
+SkLruImageCache::~SkLruImageCache() {
+    SkDELETE_ARRAY(fShards);
 }
 
 #ifdef SK_DEBUG
@@ -81,8 +166,9 @@ SkImageCache::MemoryStatus SkLruImageCache::getMemoryStatus(intptr_t ID) const {
     if (SkImageCache::UNINITIALIZED_ID == ID) {
         return SkImageCache::kFreed_MemoryStatus;
     }
-    SkAutoMutexAcquire ac(&fMutex);
-    CachedPixels* pixels = this->findByID(ID);
+    Shard& shard = this->shardFor(ID);
+    SkAutoMutexAcquire ac(&shard.fMutex);
+    CachedPixels* pixels = shard.find(ID);
     if (NULL == pixels) {
         return SkImageCache::kFreed_MemoryStatus;
     }
@@ -93,114 +179,122 @@ SkImageCache::MemoryStatus SkLruImageCache::getMemoryStatus(intptr_t ID) const {
 }
 
 void SkLruImageCache::purgeAllUnpinnedCaches() {
-    SkAutoMutexAcquire ac(&fMutex);
     this->purgeTilAtOrBelow(0);
 }
 #endif
 
 size_t SkLruImageCache::setImageCacheLimit(size_t newLimit) {
-    size_t oldLimit = fRamBudget;
-    SkAutoMutexAcquire ac(&fMutex);
-    fRamBudget = newLimit;
+    size_t oldLimit;
+    {
+        SkAutoMutexAcquire ac(&fBudgetMutex);
+        oldLimit = fRamBudget;
+        fRamBudget = newLimit;
+    }
     this->purgeIfNeeded();
     return oldLimit;
 }
 
+SkLruImageCache::Shard& SkLruImageCache::shardFor(intptr_t ID) const {
+    return fShards[ID & (kShardCount - 1)];
+}
+
+size_t SkLruImageCache::getImageCacheUsed() const {
+    SkAutoMutexAcquire ac(&fBudgetMutex);
+    return fRamUsed;
+}
+
+void SkLruImageCache::didAllocate(size_t bytes) {
+    SkAutoMutexAcquire ac(&fBudgetMutex);
+    fRamUsed += bytes;
+}
+
+void SkLruImageCache::didFree(size_t bytes) {
+    SkAutoMutexAcquire ac(&fBudgetMutex);
+    SkASSERT(bytes <= fRamUsed);
+    fRamUsed -= bytes;
+}
+
 void* SkLruImageCache::allocAndPinCache(size_t bytes, intptr_t* ID) {
-    SkAutoMutexAcquire ac(&fMutex);
     CachedPixels* pixels = SkNEW_ARGS(CachedPixels, (bytes));
     if (ID != NULL) {
         *ID = pixels->getID();
     }
     pixels->lock();
-    fRamUsed += bytes;
-    fLRU.addToHead(pixels);
+    {
+        Shard& shard = this->shardFor(pixels->getID());
+        SkAutoMutexAcquire ac(&shard.fMutex);
+        shard.add(pixels);
+        this->didAllocate(bytes);
+    }
     this->purgeIfNeeded();
     return pixels->getData();
 }
 
 void* SkLruImageCache::pinCache(intptr_t ID, SkImageCache::DataStatus* status) {
     SkASSERT(ID != SkImageCache::UNINITIALIZED_ID);
-    SkAutoMutexAcquire ac(&fMutex);
-    CachedPixels* pixels = this->findByID(ID);
+    Shard& shard = this->shardFor(ID);
+    SkAutoMutexAcquire ac(&shard.fMutex);
+    CachedPixels* pixels = shard.find(ID);
     if (NULL == pixels) {
         return NULL;
     }
-    if (pixels != fLRU.head()) {
-        fLRU.remove(pixels);
-        fLRU.addToHead(pixels);
-    }
     SkASSERT(status != NULL);
     // This cache will never return pinned memory whose data has been overwritten.
     *status = SkImageCache::kRetained_DataStatus;
-    pixels->lock();
+    shard.pin(pixels);
     return pixels->getData();
 }
 
 void SkLruImageCache::releaseCache(intptr_t ID) {
     SkASSERT(ID != SkImageCache::UNINITIALIZED_ID);
-    SkAutoMutexAcquire ac(&fMutex);
-    CachedPixels* pixels = this->findByID(ID);
-    SkASSERT(pixels != NULL);
-    pixels->unlock();
+    {
+        Shard& shard = this->shardFor(ID);
+        SkAutoMutexAcquire ac(&shard.fMutex);
+        CachedPixels* pixels = shard.find(ID);
+        SkASSERT(pixels != NULL);
+        shard.unpin(pixels);
+    }
     this->purgeIfNeeded();
 }
 
 void SkLruImageCache::throwAwayCache(intptr_t ID) {
     SkASSERT(ID != SkImageCache::UNINITIALIZED_ID);
-    SkAutoMutexAcquire ac(&fMutex);
-    CachedPixels* pixels = this->findByID(ID);
+    Shard& shard = this->shardFor(ID);
+    SkAutoMutexAcquire ac(&shard.fMutex);
+    CachedPixels* pixels = shard.find(ID);
     if (pixels != NULL) {
         if (pixels->isLocked()) {
-            pixels->unlock();
-        }
-        this->removePixels(pixels);
-    }
-}
-
-void SkLruImageCache::removePixels(CachedPixels* pixels) {
-    // Mutex is already locked.
-    SkASSERT(!pixels->isLocked());
-    const size_t size = pixels->getLength();
-    SkASSERT(size <= fRamUsed);
-    fLRU.remove(pixels);
-    SkDELETE(pixels);
-    fRamUsed -= size;
-}
-
-CachedPixels* SkLruImageCache::findByID(intptr_t ID) const {
-    // Mutex is already locked.
-    Iter iter;
-    // Start from the head, most recently used.
-    CachedPixels* pixels = iter.init(fLRU, Iter::kHead_IterStart);
-    while (pixels != NULL) {
-        if (pixels->getID() == ID) {
-            return pixels;
+            shard.unpin(pixels);
         }
-        pixels = iter.next();
+        this->didFree(shard.remove(pixels));
     }
-    return NULL;
 }
 
 void SkLruImageCache::purgeIfNeeded() {
-    // Mutex is already locked.
-    if (fRamBudget > 0) {
-        this->purgeTilAtOrBelow(fRamBudget);
+    size_t budget;
+    {
+        SkAutoMutexAcquire ac(&fBudgetMutex);
+        budget = fRamBudget;
+    }
+    if (budget > 0) {
+        this->purgeTilAtOrBelow(budget);
     }
 }
 
 void SkLruImageCache::purgeTilAtOrBelow(size_t limit) {
-    // Mutex is already locked.
-    if (fRamUsed > limit) {
-        Iter iter;
-        // Start from the tail, least recently used.
-        CachedPixels* pixels = iter.init(fLRU, Iter::kTail_IterStart);
-        while (pixels != NULL && fRamUsed > limit) {
-            CachedPixels* prev = iter.prev();
-            if (!pixels->isLocked()) {
-                this->removePixels(pixels);
+    // Free one set of pixels from each shard in turn, so that a busy shard does not lose all of
+    // its pixels while the others hold on to older ones. Only one shard is locked at a time.
+    bool purged = true;
+    while (purged && this->getImageCacheUsed() > limit) {
+        purged = false;
+        for (int i = 0; i < kShardCount && this->getImageCacheUsed() > limit; ++i) {
+            Shard& shard = fShards[i];
+            SkAutoMutexAcquire ac(&shard.fMutex);
+            size_t freed = shard.purgeOldest();
+            if (freed > 0) {
+                this->didFree(freed);
+                purged = true;
             }
-            pixels = prev;
         }
     }
 }
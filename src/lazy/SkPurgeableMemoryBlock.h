@@ -10,6 +10,13 @@
 
 #include "SkTypes.h"
 
+// ports.gyp builds SkPurgeableMemoryBlock_linux.cpp, which purges unpinned blocks itself, for
+// skia_os "linux" and "chromeos" only. Those are the SK_BUILD_FOR_UNIX builds for Linux.
+#if defined(SK_BUILD_FOR_UNIX) && defined(__linux__) && !defined(__native_client__)
+    #define SK_PURGEABLE_MEMORY_BLOCK_LINUX
+    #include "SkTInternalLList.h"
+#endif
+
 class SkPurgeableMemoryBlock : public SkNoncopyable {
 
 public:
@@ -26,6 +33,14 @@ public:
      */
     static SkPurgeableMemoryBlock* Create(size_t size);
 
+    /**
+     *  Set the number of bytes that unpinned blocks may use before the least recently unpinned
+     *  ones are purged, on platforms where Skia rather than the OS decides when to purge (Linux).
+     *  Lowering it purges immediately. Elsewhere this does nothing.
+     *  @return The previous budget, or 0 if the platform has none.
+     */
+    static size_t SetUnpinnedBudget(size_t bytes);
+
 #ifdef SK_DEBUG
     /**
      *  Whether the platform supports one shot purge of all unpinned blocks. If so,
@@ -83,6 +98,15 @@ private:
 #ifdef SK_BUILD_FOR_ANDROID
     int         fFD;
 #endif
+#ifdef SK_PURGEABLE_MEMORY_BLOCK_LINUX
+    // Unpinned blocks are purged by SkPurgeableMemoryBlock_linux.cpp rather than the OS, so it
+    // keeps them in a list and knows which ones it has handed to the kernel. fSavedWords holds
+    // the first word of each page of a purged block whose pages may still come back.
+    bool        fPurged;
+    uint32_t*   fSavedWords;
+    SK_DECLARE_INTERNAL_LLIST_INTERFACE(SkPurgeableMemoryBlock);
+    friend class SkPurgeableMemoryBudget;
+#endif
 
     // Unimplemented default constructor is private, to prevent manual creation.
     SkPurgeableMemoryBlock();
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmapFilter_opts_arm_neon.h"
+
+#include <arm_neon.h>
+
+// These follow the SSE2 versions in SkBitmapFilter_opts_SSE2.cpp, and give the
+// same results as the portable code in SkConvolver.cpp: the products and sums
+// are exact in 32 bits, and the saturating narrows clamp to [0, 255].
+
+namespace {
+
+// Accumulate the four pixels in |src8| (16 bytes), weighted by the first
+// |count| (at most 4) of the coefficients in |coeff|, into |accum|.
+template <int count>
+inline int32x4_t accumulate4(int32x4_t accum, uint8x16_t src8, int16x4_t coeff) {
+    // [16] a1 b1 g1 r1 a0 b0 g0 r0
+    int16x8_t src16 = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(src8)));
+    accum = vmlal_lane_s16(accum, vget_low_s16(src16), coeff, 0);
+    if (count > 1) {
+        accum = vmlal_lane_s16(accum, vget_high_s16(src16), coeff, 1);
+    }
+    if (count > 2) {
+        // [16] a3 b3 g3 r3 a2 b2 g2 r2
+        src16 = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(src8)));
+        accum = vmlal_lane_s16(accum, vget_low_s16(src16), coeff, 2);
+    }
+    if (count > 3) {
+        accum = vmlal_lane_s16(accum, vget_high_s16(src16), coeff, 3);
+    }
+    return accum;
+}
+
+// Accumulate |length| pixels from |row|, which must be readable for up to 3
+// pixels past them, weighted by |filterValues|, which must be readable for up
+// to 3 values past them.
+inline int32x4_t convolve_pixel(const unsigned char* row,
+                                const SkConvolutionFilter1D::ConvolutionFixed* filterValues,
+                                int length, int32x4_t accum) {
+    for (int filterX = 0; filterX < length >> 2; filterX++) {
+        accum = accumulate4<4>(accum, vld1q_u8(row), vld1_s16(filterValues));
+        row += 16;
+        filterValues += 4;
+    }
+    switch (length & 3) {
+        case 1:
+            accum = accumulate4<1>(accum, vld1q_u8(row), vld1_s16(filterValues));
+            break;
+        case 2:
+            accum = accumulate4<2>(accum, vld1q_u8(row), vld1_s16(filterValues));
+            break;
+        case 3:
+            accum = accumulate4<3>(accum, vld1q_u8(row), vld1_s16(filterValues));
+            break;
+    }
+    return accum;
+}
+
+// Shift out the fixed point fraction and clamp the channels to 8 bits.
+inline uint8x8_t pack_pixels(int32x4_t accum0, int32x4_t accum1) {
+    accum0 = vshrq_n_s32(accum0, SkConvolutionFilter1D::kShiftBits);
+    accum1 = vshrq_n_s32(accum1, SkConvolutionFilter1D::kShiftBits);
+    return vqmovn_u16(vcombine_u16(vqmovun_s32(accum0), vqmovun_s32(accum1)));
+}
+
+inline void store_pixel(unsigned char* out, uint8x8_t pixels) {
+    vst1_lane_u32(reinterpret_cast<uint32_t*>(out), vreinterpret_u32_u8(pixels), 0);
+}
+
+template <bool hasAlpha>
+inline uint8x16_t fix_alpha(uint8x16_t pixels) {
+    uint32x4_t p = vreinterpretq_u32_u8(pixels);
+    if (hasAlpha) {
+        // Make sure the alpha channel is at least as large as the maximum of
+        // the color channels, as ConvolveVertically() does.
+        uint8x16_t max = vmaxq_u8(pixels, vreinterpretq_u8_u32(vshrq_n_u32(p, 8)));
+        max = vmaxq_u8(max, vreinterpretq_u8_u32(vshrq_n_u32(p, 16)));
+        max = vreinterpretq_u8_u32(vshlq_n_u32(vreinterpretq_u32_u8(max), 24));
+        return vmaxq_u8(pixels, max);
+    }
+    return vreinterpretq_u8_u32(vorrq_u32(p, vdupq_n_u32(0xFF000000)));
+}
+
+template <bool hasAlpha>
+void convolveVertically(const SkConvolutionFilter1D::ConvolutionFixed* filterValues,
+                        int filterLength,
+                        unsigned char* const* sourceDataRows,
+                        int pixelWidth,
+                        unsigned char* outRow) {
+    // The rows of the circular buffer are padded to a multiple of 16 pixels,
+    // so four pixels can always be loaded.
+    for (int outX = 0; outX < pixelWidth; outX += 4) {
+        int32x4_t accum0 = vdupq_n_s32(0);
+        int32x4_t accum1 = vdupq_n_s32(0);
+        int32x4_t accum2 = vdupq_n_s32(0);
+        int32x4_t accum3 = vdupq_n_s32(0);
+        for (int filterY = 0; filterY < filterLength; filterY++) {
+            int16x4_t coeff = vdup_n_s16(filterValues[filterY]);
+            uint8x16_t src8 = vld1q_u8(&sourceDataRows[filterY][outX << 2]);
+            int16x8_t src16 = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(src8)));
+            accum0 = vmlal_s16(accum0, vget_low_s16(src16), coeff);
+            accum1 = vmlal_s16(accum1, vget_high_s16(src16), coeff);
+            src16 = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(src8)));
+            accum2 = vmlal_s16(accum2, vget_low_s16(src16), coeff);
+            accum3 = vmlal_s16(accum3, vget_high_s16(src16), coeff);
+        }
+
+        uint8x16_t pixels = fix_alpha<hasAlpha>(vcombine_u8(pack_pixels(accum0, accum1),
+                                                            pack_pixels(accum2, accum3)));
+        if (outX + 4 <= pixelWidth) {
+            vst1q_u8(outRow, pixels);
+        } else {
+            uint32_t tail[4];
+            vst1q_u32(tail, vreinterpretq_u32_u8(pixels));
+            memcpy(outRow, tail, (pixelWidth - outX) * 4);
+        }
+        outRow += 16;
+    }
+}
+
+}  // namespace
+
+void convolveHorizontally_NEON(const unsigned char* srcData,
+                               const SkConvolutionFilter1D& filter,
+                               unsigned char* outRow,
+                               bool /*hasAlpha*/) {
+    int numValues = filter.numValues();
+    for (int outX = 0; outX < numValues; outX++) {
+        int filterOffset, filterLength;
+        const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
+            filter.FilterForValue(outX, &filterOffset, &filterLength);
+        int32x4_t accum = convolve_pixel(&srcData[filterOffset << 2], filterValues,
+                                         filterLength, vdupq_n_s32(0));
+        store_pixel(outRow, pack_pixels(accum, accum));
+        outRow += 4;
+    }
+}
+
+void convolve4RowsHorizontally_NEON(const unsigned char* srcData[4],
+                                    const SkConvolutionFilter1D& filter,
+                                    unsigned char* outRow[4]) {
+    int numValues = filter.numValues();
+    for (int outX = 0; outX < numValues; outX++) {
+        int filterOffset, filterLength;
+        const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
+            filter.FilterForValue(outX, &filterOffset, &filterLength);
+        int start = filterOffset << 2;
+        int32x4_t accum0 = convolve_pixel(&srcData[0][start], filterValues, filterLength,
+                                          vdupq_n_s32(0));
+        int32x4_t accum1 = convolve_pixel(&srcData[1][start], filterValues, filterLength,
+                                          vdupq_n_s32(0));
+        int32x4_t accum2 = convolve_pixel(&srcData[2][start], filterValues, filterLength,
+                                          vdupq_n_s32(0));
+        int32x4_t accum3 = convolve_pixel(&srcData[3][start], filterValues, filterLength,
+                                          vdupq_n_s32(0));
+
+        uint8x8_t pixels01 = pack_pixels(accum0, accum1);
+        uint8x8_t pixels23 = pack_pixels(accum2, accum3);
+        int out = outX << 2;
+        vst1_lane_u32(reinterpret_cast<uint32_t*>(&outRow[0][out]),
+                      vreinterpret_u32_u8(pixels01), 0);
+        vst1_lane_u32(reinterpret_cast<uint32_t*>(&outRow[1][out]),
+                      vreinterpret_u32_u8(pixels01), 1);
+        vst1_lane_u32(reinterpret_cast<uint32_t*>(&outRow[2][out]),
+                      vreinterpret_u32_u8(pixels23), 0);
+        vst1_lane_u32(reinterpret_cast<uint32_t*>(&outRow[3][out]),
+                      vreinterpret_u32_u8(pixels23), 1);
+    }
+}
+
+void convolveVertically_NEON(const SkConvolutionFilter1D::ConvolutionFixed* filterValues,
+                             int filterLength,
+                             unsigned char* const* sourceDataRows,
+                             int pixelWidth,
+                             unsigned char* outRow,
+                             bool hasAlpha) {
+    if (hasAlpha) {
+        convolveVertically<true>(filterValues, filterLength, sourceDataRows,
+                                 pixelWidth, outRow);
+    } else {
+        convolveVertically<false>(filterValues, filterLength, sourceDataRows,
+                                  pixelWidth, outRow);
+    }
+}
+
+void applySIMDPadding_NEON(SkConvolutionFilter1D* filter) {
+    // Pad the coefficients of the last filter, so that loading four of them
+    // at a time never reads past the end.
+    for (int i = 0; i < 8; ++i) {
+        filter->addFilterValue(static_cast<SkConvolutionFilter1D::ConvolutionFixed>(0));
+    }
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBitmapFilter_opts_arm_neon_DEFINED
+#define SkBitmapFilter_opts_arm_neon_DEFINED
+
+#include "SkConvolver.h"
+
+void convolveVertically_NEON(const SkConvolutionFilter1D::ConvolutionFixed* filterValues,
+                             int filterLength,
+                             unsigned char* const* sourceDataRows,
+                             int pixelWidth,
+                             unsigned char* outRow,
+                             bool hasAlpha);
+void convolve4RowsHorizontally_NEON(const unsigned char* srcData[4],
+                                    const SkConvolutionFilter1D& filter,
+                                    unsigned char* outRow[4]);
+void convolveHorizontally_NEON(const unsigned char* srcData,
+                               const SkConvolutionFilter1D& filter,
+                               unsigned char* outRow,
+                               bool hasAlpha);
+void applySIMDPadding_NEON(SkConvolutionFilter1D* filter);
+
+#endif
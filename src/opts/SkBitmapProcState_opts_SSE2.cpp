@@ -9,7 +9,9 @@
 
 #include <emmintrin.h>
 #include "SkBitmapProcState_opts_SSE2.h"
+#include "SkColorTable.h"
 #include "SkPaint.h"
+#include "SkShader.h"
 #include "SkUtils.h"
 
 void S32_opaque_D32_filter_DX_SSE2(const SkBitmapProcState& s,
@@ -439,8 +441,8 @@ void ClampX_ClampY_nofilter_scale_SSE2(const SkBitmapProcState& s,
         // than max 16bit interger in the real world.
         if ((count >= 8) && (maxX <= 0xFFFF)) {
             while (((size_t)xy & 0x0F) != 0) {
-                *xy++ = pack_two_shorts(SkClampMax((fx + dx) >> 16, maxX),
-                                        SkClampMax(fx >> 16, maxX));
+                *xy++ = pack_two_shorts(SkClampMax(fx >> 16, maxX),
+                                        SkClampMax((fx + dx) >> 16, maxX));
                 fx += 2 * dx;
                 count -= 2;
             }
@@ -764,3 +766,313 @@ void S32_D16_filter_DX_SSE2(const SkBitmapProcState& s,
 
     } while (--count > 0);
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * The fused scale shaderprocs of SkBitmapProcState_procs.h, for opaque 8888
+ * and Index8 sources. They compute the source x (and subpixel bits) of four
+ * pixels at a time, and filter four pixels at a time, giving the same results
+ * as the portable ones.
+ */
+
+namespace {
+
+SK_COMPILE_ASSERT(sizeof(SkFractionalInt) == 8, fractional_int_is_64bit);
+
+// Return the 16.16 positions of four pixels at a time: fx + i * dx. Like
+// the portable procs they are accumulated as SkFractionalInt, whose high
+// 32 bits are the SkFixed value.
+class FixedSteps {
+public:
+    FixedSteps(SkFractionalInt fx, SkFractionalInt dx) {
+        const SkFractionalInt x01[2] = { fx, fx + dx };
+        const SkFractionalInt x23[2] = { fx + 2 * dx, fx + 3 * dx };
+        const SkFractionalInt step[2] = { 4 * dx, 4 * dx };
+        fX01 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x01));
+        fX23 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x23));
+        fStep = _mm_loadu_si128(reinterpret_cast<const __m128i*>(step));
+    }
+
+    __m128i next() {
+        __m128i fx = _mm_unpacklo_epi64(_mm_shuffle_epi32(fX01, _MM_SHUFFLE(3, 1, 3, 1)),
+                                        _mm_shuffle_epi32(fX23, _MM_SHUFFLE(3, 1, 3, 1)));
+        fX01 = _mm_add_epi64(fX01, fStep);
+        fX23 = _mm_add_epi64(fX23, fStep);
+        return fx;
+    }
+
+private:
+    __m128i fX01, fX23, fStep;
+};
+
+// The tile macros of SkBitmapProcState_procs.h, for one coordinate...
+template <SkShader::TileMode tileMode>
+inline unsigned tile(SkFixed fx, unsigned max) {
+    switch (tileMode) {
+        case SkShader::kClamp_TileMode:
+            return SkClampMax(fx >> 16, max);
+        case SkShader::kRepeat_TileMode:
+            return (fx & 0xFFFF) * (max + 1) >> 16;
+        case SkShader::kMirror_TileMode:
+        default:
+            return ((fx ^ (fx << 15 >> 31)) & 0xFFFF) * (max + 1) >> 16;
+    }
+}
+
+template <SkShader::TileMode tileMode>
+inline unsigned tile_low_bits(SkFixed fx, unsigned max) {
+    if (SkShader::kClamp_TileMode == tileMode) {
+        return (fx >> 12) & 0xF;
+    }
+    return ((fx & 0xFFFF) * (max + 1) >> 12) & 0xF;
+}
+
+// ... and for four of them. width is max + 1, which must fit in 16 bits.
+template <SkShader::TileMode tileMode>
+inline __m128i tile(__m128i fx, __m128i max, __m128i width) {
+    if (SkShader::kClamp_TileMode == tileMode) {
+        __m128i x = _mm_srai_epi32(fx, 16);
+        x = _mm_andnot_si128(_mm_srai_epi32(x, 31), x);
+        __m128i over = _mm_cmpgt_epi32(x, max);
+        return _mm_or_si128(_mm_and_si128(over, max), _mm_andnot_si128(over, x));
+    }
+    if (SkShader::kMirror_TileMode == tileMode) {
+        fx = _mm_xor_si128(fx, _mm_srai_epi32(_mm_slli_epi32(fx, 15), 31));
+    }
+    // The high 16 bits of each lane are 0, so this is the high half of the
+    // 32 bit product (fx & 0xFFFF) * width.
+    return _mm_mulhi_epu16(_mm_and_si128(fx, _mm_set1_epi32(0xFFFF)), width);
+}
+
+template <SkShader::TileMode tileMode>
+inline __m128i tile_low_bits(__m128i fx, __m128i width) {
+    if (SkShader::kClamp_TileMode == tileMode) {
+        return _mm_and_si128(_mm_srli_epi32(fx, 12), _mm_set1_epi32(0xF));
+    }
+    __m128i product = _mm_mullo_epi16(_mm_and_si128(fx, _mm_set1_epi32(0xFFFF)), width);
+    return _mm_and_si128(_mm_srli_epi32(product, 12), _mm_set1_epi32(0xF));
+}
+
+// Sources: the type of their pixels, and how to turn one into a SkPMColor.
+class S32Source {
+public:
+    typedef uint32_t Type;
+
+    explicit S32Source(const SkBitmapProcState& s) {
+        SkASSERT(s.fBitmap->config() == SkBitmap::kARGB_8888_Config);
+    }
+
+    SkPMColor operator()(uint32_t src) const { return src; }
+};
+
+class SI8Source {
+public:
+    typedef uint8_t Type;
+
+    explicit SI8Source(const SkBitmapProcState& s)
+        : fColorTable(s.fBitmap->getColorTable())
+        , fTable(fColorTable->lockColors()) {
+        SkASSERT(s.fBitmap->config() == SkBitmap::kIndex8_Config);
+    }
+
+    ~SI8Source() { fColorTable->unlockColors(false); }
+
+    SkPMColor operator()(uint8_t src) const { return fTable[src]; }
+
+private:
+    SkColorTable*               fColorTable;
+    const SkPMColor* SK_RESTRICT fTable;
+};
+
+// Filter two pixels, whose components are expanded to 16 bits, with the same
+// weights as Filter_32_opaque. The weighted sums fit in 16 bits.
+inline __m128i filter2(__m128i c00, __m128i c01, __m128i c10, __m128i c11,
+                       __m128i allX, __m128i allY, __m128i negY) {
+    __m128i negX = _mm_sub_epi16(_mm_set1_epi16(16), allX);
+    __m128i top = _mm_add_epi16(_mm_mullo_epi16(c00, negX), _mm_mullo_epi16(c01, allX));
+    __m128i bottom = _mm_add_epi16(_mm_mullo_epi16(c10, negX), _mm_mullo_epi16(c11, allX));
+    __m128i sum = _mm_add_epi16(_mm_mullo_epi16(top, negY), _mm_mullo_epi16(bottom, allY));
+    return _mm_srli_epi16(sum, 8);
+}
+
+// Filter four pixels, given their four samples and their x weights (one per
+// 32 bit lane).
+inline __m128i filter4(__m128i p00, __m128i p01, __m128i p10, __m128i p11,
+                       __m128i subX, __m128i allY, __m128i negY) {
+    const __m128i zero = _mm_setzero_si128();
+    // (x0, x0, x1, x1, x2, x2, x3, x3) for the 16 bit halves of the lanes
+    subX = _mm_or_si128(subX, _mm_slli_epi32(subX, 16));
+    __m128i lo = filter2(_mm_unpacklo_epi8(p00, zero), _mm_unpacklo_epi8(p01, zero),
+                         _mm_unpacklo_epi8(p10, zero), _mm_unpacklo_epi8(p11, zero),
+                         _mm_unpacklo_epi32(subX, subX), allY, negY);
+    __m128i hi = filter2(_mm_unpackhi_epi8(p00, zero), _mm_unpackhi_epi8(p01, zero),
+                         _mm_unpackhi_epi8(p10, zero), _mm_unpackhi_epi8(p11, zero),
+                         _mm_unpackhi_epi32(subX, subX), allY, negY);
+    return _mm_packus_epi16(lo, hi);
+}
+
+template <typename Source>
+inline const typename Source::Type* get_row(const SkBitmapProcState& s, unsigned y) {
+    const char* srcAddr = static_cast<const char*>(s.fBitmap->getPixels());
+    return reinterpret_cast<const typename Source::Type*>(srcAddr + y * s.fBitmap->rowBytes());
+}
+
+template <SkShader::TileMode tileMode, typename Source>
+void nofilter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                 SkPMColor* SK_RESTRICT colors, int count) {
+    SkASSERT((s.fInvType & ~(SkMatrix::kTranslate_Mask |
+                             SkMatrix::kScale_Mask)) == 0);
+    SkASSERT(count > 0 && colors != NULL);
+    SkASSERT(s.fFilterLevel == SkPaint::kNone_FilterLevel);
+    SkASSERT(s.fAlphaScale == 256);
+
+    const unsigned maxX = s.fBitmap->width() - 1;
+    SkPoint pt;
+    s.fInvProc(s.fInvMatrix, SkIntToScalar(x) + SK_ScalarHalf,
+               SkIntToScalar(y) + SK_ScalarHalf, &pt);
+    SkFixed fy = SkFractionalIntToFixed(SkScalarToFractionalInt(pt.fY));
+    const typename Source::Type* SK_RESTRICT row =
+        get_row<Source>(s, tile<tileMode>(fy, s.fBitmap->height() - 1));
+
+    Source source(s);
+    FixedSteps steps(SkScalarToFractionalInt(pt.fX), s.fInvSxFractionalInt);
+    const __m128i max = _mm_set1_epi32(maxX);
+    const __m128i width = _mm_set1_epi32(maxX + 1);
+    while (count > 0) {
+        uint32_t x0[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(x0),
+                         tile<tileMode>(steps.next(), max, width));
+        int n = SkMin32(count, 4);
+        for (int i = 0; i < n; ++i) {
+            colors[i] = source(row[x0[i]]);
+        }
+        colors += 4;
+        count -= 4;
+    }
+}
+
+template <SkShader::TileMode tileMode, typename Source>
+void filter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                               SkPMColor* SK_RESTRICT colors, int count) {
+    SkASSERT((s.fInvType & ~(SkMatrix::kTranslate_Mask |
+                             SkMatrix::kScale_Mask)) == 0);
+    SkASSERT(count > 0 && colors != NULL);
+    SkASSERT(s.fFilterLevel != SkPaint::kNone_FilterLevel);
+    SkASSERT(s.fAlphaScale == 256);
+
+    const unsigned maxX = s.fBitmap->width() - 1;
+    const SkFixed oneX = s.fFilterOneX;
+    SkPoint pt;
+    s.fInvProc(s.fInvMatrix, SkIntToScalar(x) + SK_ScalarHalf,
+               SkIntToScalar(y) + SK_ScalarHalf, &pt);
+    SkFixed fy = SkScalarToFixed(pt.fY) - (s.fFilterOneY >> 1);
+    const unsigned maxY = s.fBitmap->height() - 1;
+    const typename Source::Type* SK_RESTRICT row0 =
+        get_row<Source>(s, tile<tileMode>(fy, maxY));
+    const typename Source::Type* SK_RESTRICT row1 =
+        get_row<Source>(s, tile<tileMode>(fy + s.fFilterOneY, maxY));
+
+    // The weights of the top and bottom rows, for every 16 bit component.
+    const __m128i allY = _mm_set1_epi16(tile_low_bits<tileMode>(fy, maxY));
+    const __m128i negY = _mm_sub_epi16(_mm_set1_epi16(16), allY);
+
+    Source source(s);
+    FixedSteps steps(SkScalarToFractionalInt(pt.fX) - (SkFixedToFractionalInt(oneX) >> 1),
+                     s.fInvSxFractionalInt);
+    const __m128i max = _mm_set1_epi32(maxX);
+    const __m128i width = _mm_set1_epi32(maxX + 1);
+    const __m128i one = _mm_set1_epi32(oneX);
+    while (count > 0) {
+        __m128i fx = steps.next();
+        uint32_t x0[4], x1[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(x0), tile<tileMode>(fx, max, width));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(x1),
+                         tile<tileMode>(_mm_add_epi32(fx, one), max, width));
+
+        __m128i subX = tile_low_bits<tileMode>(fx, width);
+
+        if (count >= 4) {
+            __m128i p00 = _mm_setr_epi32(source(row0[x0[0]]), source(row0[x0[1]]),
+                                         source(row0[x0[2]]), source(row0[x0[3]]));
+            __m128i p01 = _mm_setr_epi32(source(row0[x1[0]]), source(row0[x1[1]]),
+                                         source(row0[x1[2]]), source(row0[x1[3]]));
+            __m128i p10 = _mm_setr_epi32(source(row1[x0[0]]), source(row1[x0[1]]),
+                                         source(row1[x0[2]]), source(row1[x0[3]]));
+            __m128i p11 = _mm_setr_epi32(source(row1[x1[0]]), source(row1[x1[1]]),
+                                         source(row1[x1[2]]), source(row1[x1[3]]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(colors),
+                             filter4(p00, p01, p10, p11, subX, allY, negY));
+        } else {
+            SkPMColor a00[4] = { 0 }, a01[4] = { 0 }, a10[4] = { 0 }, a11[4] = { 0 };
+            for (int i = 0; i < count; ++i) {
+                a00[i] = source(row0[x0[i]]);
+                a01[i] = source(row0[x1[i]]);
+                a10[i] = source(row1[x0[i]]);
+                a11[i] = source(row1[x1[i]]);
+            }
+            SkPMColor tmp[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(tmp),
+                filter4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a00)),
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(a01)),
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(a10)),
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(a11)),
+                        subX, allY, negY));
+            memcpy(colors, tmp, count * sizeof(SkPMColor));
+        }
+        colors += 4;
+        count -= 4;
+    }
+}
+
+} // namespace
+
+void Repeat_S32_opaque_D32_nofilter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                       SkPMColor* colors, int count) {
+    nofilter_DX_shaderproc_SSE2<SkShader::kRepeat_TileMode, S32Source>(s, x, y, colors, count);
+}
+
+void Mirror_S32_opaque_D32_nofilter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                       SkPMColor* colors, int count) {
+    nofilter_DX_shaderproc_SSE2<SkShader::kMirror_TileMode, S32Source>(s, x, y, colors, count);
+}
+
+void Clamp_S32_opaque_D32_filter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                    SkPMColor* colors, int count) {
+    filter_DX_shaderproc_SSE2<SkShader::kClamp_TileMode, S32Source>(s, x, y, colors, count);
+}
+
+void Repeat_S32_opaque_D32_filter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                     SkPMColor* colors, int count) {
+    filter_DX_shaderproc_SSE2<SkShader::kRepeat_TileMode, S32Source>(s, x, y, colors, count);
+}
+
+void Mirror_S32_opaque_D32_filter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                     SkPMColor* colors, int count) {
+    filter_DX_shaderproc_SSE2<SkShader::kMirror_TileMode, S32Source>(s, x, y, colors, count);
+}
+
+void Repeat_SI8_opaque_D32_nofilter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                       SkPMColor* colors, int count) {
+    nofilter_DX_shaderproc_SSE2<SkShader::kRepeat_TileMode, SI8Source>(s, x, y, colors, count);
+}
+
+void Mirror_SI8_opaque_D32_nofilter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                       SkPMColor* colors, int count) {
+    nofilter_DX_shaderproc_SSE2<SkShader::kMirror_TileMode, SI8Source>(s, x, y, colors, count);
+}
+
+void Clamp_SI8_opaque_D32_filter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                    SkPMColor* colors, int count) {
+    filter_DX_shaderproc_SSE2<SkShader::kClamp_TileMode, SI8Source>(s, x, y, colors, count);
+}
+
+void Repeat_SI8_opaque_D32_filter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                     SkPMColor* colors, int count) {
+    filter_DX_shaderproc_SSE2<SkShader::kRepeat_TileMode, SI8Source>(s, x, y, colors, count);
+}
+
+void Mirror_SI8_opaque_D32_filter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                     SkPMColor* colors, int count) {
+    filter_DX_shaderproc_SSE2<SkShader::kMirror_TileMode, SI8Source>(s, x, y, colors, count);
+}
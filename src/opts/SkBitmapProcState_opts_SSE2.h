@@ -28,3 +28,25 @@ void ClampX_ClampY_nofilter_affine_SSE2(const SkBitmapProcState& s,
 void S32_D16_filter_DX_SSE2(const SkBitmapProcState& s,
                                   const uint32_t* xy,
                                   int count, uint16_t* colors);
+
+// The fused scale shaderprocs of SkBitmapProcState_procs.h.
+void Repeat_S32_opaque_D32_nofilter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                       SkPMColor* colors, int count);
+void Mirror_S32_opaque_D32_nofilter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                       SkPMColor* colors, int count);
+void Clamp_S32_opaque_D32_filter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                    SkPMColor* colors, int count);
+void Repeat_S32_opaque_D32_filter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                     SkPMColor* colors, int count);
+void Mirror_S32_opaque_D32_filter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                     SkPMColor* colors, int count);
+void Repeat_SI8_opaque_D32_nofilter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                       SkPMColor* colors, int count);
+void Mirror_SI8_opaque_D32_nofilter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                       SkPMColor* colors, int count);
+void Clamp_SI8_opaque_D32_filter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                    SkPMColor* colors, int count);
+void Repeat_SI8_opaque_D32_filter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                     SkPMColor* colors, int count);
+void Mirror_SI8_opaque_D32_filter_DX_shaderproc_SSE2(const SkBitmapProcState& s, int x, int y,
+                                                     SkPMColor* colors, int count);
@@ -9,6 +9,7 @@
 #include "SkBlitRow_opts_SSE2.h"
 #include "SkBitmapProcState_opts_SSE2.h"
 #include "SkColorPriv.h"
+#include "SkDither.h"
 #include "SkUtils.h"
 
 #include <emmintrin.h>
@@ -851,3 +852,106 @@ void SkBlitLCD16OpaqueRow_SSE2(SkPMColor dst[], const uint16_t mask[],
         width--;
     }
 }
+
+/* Extract one 8-bit component (at the given shift) of eight SkPMColors into
+ * eight 16-bit lanes.
+ */
+static inline __m128i SkGetPackedComponent8_SSE2(__m128i lo, __m128i hi,
+                                                 int shift) {
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    lo = _mm_and_si128(_mm_srli_epi32(lo, shift), mask);
+    hi = _mm_and_si128(_mm_srli_epi32(hi, shift), mask);
+    return _mm_packs_epi32(lo, hi);
+}
+
+static inline __m128i SkPackRGB16_SSE2(__m128i r, __m128i g, __m128i b) {
+    return _mm_or_si128(_mm_slli_epi16(r, SK_R16_SHIFT),
+                        _mm_or_si128(_mm_slli_epi16(g, SK_G16_SHIFT),
+                                     _mm_slli_epi16(b, SK_B16_SHIFT)));
+}
+
+/* SSE2 version of S32_D565_Opaque()
+ * portable version is in core/SkBlitRow_D16.cpp
+ */
+void S32_D565_Opaque_SSE2(uint16_t* SK_RESTRICT dst,
+                          const SkPMColor* SK_RESTRICT src, int count,
+                          U8CPU alpha, int /*x*/, int /*y*/) {
+    SkASSERT(255 == alpha);
+
+    while (count >= 8) {
+        __m128i src_lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        __m128i src_hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+
+        __m128i r = SkGetPackedComponent8_SSE2(src_lo, src_hi, SK_R32_SHIFT);
+        __m128i g = SkGetPackedComponent8_SSE2(src_lo, src_hi, SK_G32_SHIFT);
+        __m128i b = SkGetPackedComponent8_SSE2(src_lo, src_hi, SK_B32_SHIFT);
+
+        __m128i d = SkPackRGB16_SSE2(_mm_srli_epi16(r, 8 - SK_R16_BITS),
+                                     _mm_srli_epi16(g, 8 - SK_G16_BITS),
+                                     _mm_srli_epi16(b, 8 - SK_B16_BITS));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), d);
+
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
+
+    while (count > 0) {
+        SkPMColor c = *src++;
+        SkPMColorAssert(c);
+        *dst++ = SkPixel32ToPixel16_ToU16(c);
+        count--;
+    }
+}
+
+/* SSE2 version of S32_D565_Opaque_Dither()
+ * portable version is in core/SkBlitRow_D16.cpp
+ */
+void S32_D565_Opaque_Dither_SSE2(uint16_t* SK_RESTRICT dst,
+                                 const SkPMColor* SK_RESTRICT src,
+                                 int count, U8CPU alpha, int x, int y) {
+    SkASSERT(255 == alpha);
+
+    DITHER_565_SCAN(y);
+    if (count >= 8) {
+        // The dither matrix repeats every 4 pixels, so the dither values for
+        // 8 pixels starting at x are the same for every group of 8.
+        __m128i dither = _mm_setr_epi16(DITHER_VALUE(x),     DITHER_VALUE(x + 1),
+                                        DITHER_VALUE(x + 2), DITHER_VALUE(x + 3),
+                                        DITHER_VALUE(x + 4), DITHER_VALUE(x + 5),
+                                        DITHER_VALUE(x + 6), DITHER_VALUE(x + 7));
+        __m128i dither_g = _mm_srli_epi16(dither, 1);
+
+        while (count >= 8) {
+            __m128i src_lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            __m128i src_hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+
+            __m128i r = SkGetPackedComponent8_SSE2(src_lo, src_hi, SK_R32_SHIFT);
+            __m128i g = SkGetPackedComponent8_SSE2(src_lo, src_hi, SK_G32_SHIFT);
+            __m128i b = SkGetPackedComponent8_SSE2(src_lo, src_hi, SK_B32_SHIFT);
+
+            // SkDITHER_R32_FOR_565 etc.: c + d - (c >> (bits + 1))
+            r = _mm_sub_epi16(_mm_add_epi16(r, dither), _mm_srli_epi16(r, 5));
+            g = _mm_sub_epi16(_mm_add_epi16(g, dither_g), _mm_srli_epi16(g, 6));
+            b = _mm_sub_epi16(_mm_add_epi16(b, dither), _mm_srli_epi16(b, 5));
+
+            __m128i d = SkPackRGB16_SSE2(_mm_srli_epi16(r, 8 - SK_R16_BITS),
+                                         _mm_srli_epi16(g, 8 - SK_G16_BITS),
+                                         _mm_srli_epi16(b, 8 - SK_B16_BITS));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), d);
+
+            src += 8;
+            dst += 8;
+            count -= 8;
+            x += 8;
+        }
+    }
+
+    while (count > 0) {
+        SkPMColor c = *src++;
+        SkPMColorAssert(c);
+        *dst++ = SkDitherRGB32To565(c, DITHER_VALUE(x));
+        DITHER_INC_X(x);
+        count--;
+    }
+}
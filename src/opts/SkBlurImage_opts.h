@@ -0,0 +1,52 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBlurImage_opts_DEFINED
+#define SkBlurImage_opts_DEFINED
+
+#include "SkColorPriv.h"
+
+/**
+ *  Box blurs each of the height rows of src (width SkPMColors each, srcStride apart) with a kernel
+ *  of kernelSize pixels covering leftOffset pixels to the left and rightOffset to the right.
+ *  Each result channel is sum / kernelSize, rounded down like the portable code. Procs may compute
+ *  it as (sum * ceil((1 << 24) / kernelSize)) >> 24, which is exact for kernelSize up to
+ *  SK_MAX_PLATFORM_BOX_BLUR_KERNEL, so they are not called with larger kernels.
+ *  A "transposing" proc writes src row y as dst column y, so dst is width rows of height pixels;
+ *  blurring twice that way blurs in X and then in Y while only ever reading along rows.
+ *  Otherwise dst is laid out like src, with a stride of width.
+ */
+#define SK_MAX_PLATFORM_BOX_BLUR_KERNEL 256
+
+typedef void (*SkBoxBlurProc)(const SkPMColor* src, int srcStride, SkPMColor* dst,
+                              int kernelSize, int leftOffset, int rightOffset,
+                              int width, int height);
+
+/**
+ *  The A8 box blur pass of SkBlurMask: blurs each of the height rows of src (width bytes each,
+ *  srcRowBytes apart) into rows of width + 2 * max(leftRadius, rightRadius) bytes. If transpose,
+ *  src row y is written as dst column y (dst row stride height), otherwise as dst row y.
+ *  Each result is (outerSum * outerScale + innerSum * innerScale + half) >> 24, where outerSum
+ *  covers the full kernel and innerSum the kernel without its two end taps (innerScale is 0 for
+ *  a plain box blur).
+ */
+typedef void (*SkBoxBlurA8Proc)(const uint8_t* src, int srcRowBytes, uint8_t* dst,
+                                int leftRadius, int rightRadius, int width, int height,
+                                bool transpose, uint32_t outerScale, uint32_t innerScale);
+
+/**
+ *  Return platform specific box blur procs, or false if there are none and the portable code
+ *  should be used.
+ */
+bool SkBoxBlurGetPlatformProcs(SkBoxBlurProc* boxBlurX, SkBoxBlurProc* boxBlurXT);
+
+/**
+ *  Return a platform specific A8 box blur pass, or NULL.
+ */
+SkBoxBlurA8Proc SkBoxBlurA8GetPlatformProc();
+
+#endif
@@ -0,0 +1,349 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <emmintrin.h>
+#include "SkBlurImage_opts_SSE2.h"
+#include "SkTemplates.h"
+
+namespace {
+
+// (sum * scale) in each 32-bit lane. SSE2 has no multiply that keeps the low halves of 32-bit
+// products (PMULLD), but all of ours fit in 32 bits, so two widening multiplies will do.
+inline __m128i mul32(const __m128i& sum, const __m128i& scale) {
+    __m128i even = _mm_mul_epu32(sum, scale);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(sum, 32), scale);
+    return _mm_or_si128(even, _mm_slli_epi64(odd, 32));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SkPMColor box blur. Each sum is one register, with a 32-bit lane per channel.
+
+inline __m128i expand(SkPMColor c) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i v = _mm_cvtsi32_si128(c);
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zero), zero);
+}
+
+// sum / kernelSize, given scale = ceil((1 << 24) / kernelSize). The error of scale is less than
+// kernelSize / (1 << 24) per unit of sum, and sum <= 255 * kernelSize, so it stays below one
+// kernelSize-th for kernels up to SK_MAX_PLATFORM_BOX_BLUR_KERNEL and the result is exact.
+inline __m128i average(const __m128i& sum, const __m128i& scale) {
+    return _mm_srli_epi32(mul32(sum, scale), 24);
+}
+
+// Blurs four rows at once, so that a transposed result is four adjacent pixels written with a
+// single store instead of four writes a row apart.
+template<bool transpose>
+void box_blur_SSE2(const SkPMColor* src, int srcStride, SkPMColor* dst, int kernelSize,
+                   int leftOffset, int rightOffset, int width, int height)
+{
+    const int rightBorder = SkMin32(rightOffset + 1, width);
+    const int dstStrideX = transpose ? height : 1;
+    const int dstStrideY = transpose ? 1 : width;
+    SkASSERT(kernelSize <= SK_MAX_PLATFORM_BOX_BLUR_KERNEL);
+    const __m128i scale = _mm_set1_epi32(((1 << 24) + kernelSize - 1) / kernelSize);
+    const __m128i zero = _mm_setzero_si128();
+
+    int y = 0;
+    for (; y + 4 <= height; y += 4) {
+        const SkPMColor* s0 = src;
+        const SkPMColor* s1 = s0 + srcStride;
+        const SkPMColor* s2 = s1 + srcStride;
+        const SkPMColor* s3 = s2 + srcStride;
+        __m128i sum0 = zero, sum1 = zero, sum2 = zero, sum3 = zero;
+        for (int i = 0; i < rightBorder; ++i) {
+            sum0 = _mm_add_epi32(sum0, expand(s0[i]));
+            sum1 = _mm_add_epi32(sum1, expand(s1[i]));
+            sum2 = _mm_add_epi32(sum2, expand(s2[i]));
+            sum3 = _mm_add_epi32(sum3, expand(s3[i]));
+        }
+
+        SkPMColor* dptr = dst;
+        for (int x = 0; x < width; ++x) {
+            __m128i result = _mm_packus_epi16(
+                    _mm_packs_epi32(average(sum0, scale), average(sum1, scale)),
+                    _mm_packs_epi32(average(sum2, scale), average(sum3, scale)));
+            if (transpose) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dptr), result);
+            } else {
+                dptr[0] = _mm_cvtsi128_si32(result);
+                dptr[width] = _mm_cvtsi128_si32(_mm_srli_si128(result, 4));
+                dptr[2 * width] = _mm_cvtsi128_si32(_mm_srli_si128(result, 8));
+                dptr[3 * width] = _mm_cvtsi128_si32(_mm_srli_si128(result, 12));
+            }
+            if (x >= leftOffset) {
+                int l = x - leftOffset;
+                sum0 = _mm_sub_epi32(sum0, expand(s0[l]));
+                sum1 = _mm_sub_epi32(sum1, expand(s1[l]));
+                sum2 = _mm_sub_epi32(sum2, expand(s2[l]));
+                sum3 = _mm_sub_epi32(sum3, expand(s3[l]));
+            }
+            if (x + rightOffset + 1 < width) {
+                int r = x + rightOffset + 1;
+                sum0 = _mm_add_epi32(sum0, expand(s0[r]));
+                sum1 = _mm_add_epi32(sum1, expand(s1[r]));
+                sum2 = _mm_add_epi32(sum2, expand(s2[r]));
+                sum3 = _mm_add_epi32(sum3, expand(s3[r]));
+            }
+            dptr += dstStrideX;
+        }
+        src += 4 * srcStride;
+        dst += 4 * dstStrideY;
+    }
+
+    for (; y < height; ++y) {
+        __m128i sum = zero;
+        for (int i = 0; i < rightBorder; ++i) {
+            sum = _mm_add_epi32(sum, expand(src[i]));
+        }
+
+        SkPMColor* dptr = dst;
+        for (int x = 0; x < width; ++x) {
+            __m128i result = average(sum, scale);
+            result = _mm_packus_epi16(_mm_packs_epi32(result, zero), zero);
+            *dptr = _mm_cvtsi128_si32(result);
+            if (x >= leftOffset) {
+                sum = _mm_sub_epi32(sum, expand(src[x - leftOffset]));
+            }
+            if (x + rightOffset + 1 < width) {
+                sum = _mm_add_epi32(sum, expand(src[x + rightOffset + 1]));
+            }
+            dptr += dstStrideX;
+        }
+        src += srcStride;
+        dst += dstStrideY;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// A8 box blur. Strips of 16 rows are transposed, so that a single register holds a byte of each
+// of the 16 rows, and the 16 sliding windows advance together.
+
+// Transposes the 16x16 block of bytes in r. Each round interleaves register i with register
+// i + 8, which rotates the 8 bit (register, byte) index of every element left by one bit; four
+// rounds swap the register and byte halves of the index.
+inline void transpose16x16(__m128i r[16]) {
+    for (int round = 0; round < 4; ++round) {
+        __m128i t[16];
+        for (int i = 0; i < 8; ++i) {
+            t[2 * i]     = _mm_unpacklo_epi8(r[i], r[i + 8]);
+            t[2 * i + 1] = _mm_unpackhi_epi8(r[i], r[i + 8]);
+        }
+        for (int i = 0; i < 16; ++i) {
+            r[i] = t[i];
+        }
+    }
+}
+
+struct Sums16 {
+    __m128i fLanes[4];
+
+    void setZero() {
+        fLanes[0] = fLanes[1] = fLanes[2] = fLanes[3] = _mm_setzero_si128();
+    }
+
+    // Load 16 bytes and widen them to 32 bits.
+    void load(const uint8_t* src) {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        fLanes[0] = _mm_unpacklo_epi16(lo, zero);
+        fLanes[1] = _mm_unpackhi_epi16(lo, zero);
+        fLanes[2] = _mm_unpacklo_epi16(hi, zero);
+        fLanes[3] = _mm_unpackhi_epi16(hi, zero);
+    }
+
+    void add(const Sums16& other) {
+        for (int i = 0; i < 4; ++i) {
+            fLanes[i] = _mm_add_epi32(fLanes[i], other.fLanes[i]);
+        }
+    }
+
+    void sub(const Sums16& other) {
+        for (int i = 0; i < 4; ++i) {
+            fLanes[i] = _mm_sub_epi32(fLanes[i], other.fLanes[i]);
+        }
+    }
+};
+
+class A8Writer {
+public:
+    A8Writer(uint8_t* dst, uint32_t outerScale, uint32_t innerScale, uint32_t half)
+        : fDst(dst)
+        , fOuterScale(_mm_set1_epi32(outerScale))
+        , fInnerScale(_mm_set1_epi32(innerScale))
+        , fHalf(_mm_set1_epi32(half))
+        , fInterp(innerScale != 0) {}
+
+    void write(const Sums16& outer, const Sums16& inner) {
+        __m128i v[4];
+        for (int i = 0; i < 4; ++i) {
+            __m128i sum = mul32(outer.fLanes[i], fOuterScale);
+            if (fInterp) {
+                sum = _mm_add_epi32(sum, mul32(inner.fLanes[i], fInnerScale));
+            }
+            v[i] = _mm_srli_epi32(_mm_add_epi32(sum, fHalf), 24);
+        }
+        __m128i result = _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]),
+                                          _mm_packs_epi32(v[2], v[3]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(fDst), result);
+        fDst += 16;
+    }
+
+    void writeZero() {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(fDst), _mm_setzero_si128());
+        fDst += 16;
+    }
+
+private:
+    uint8_t*      fDst;
+    const __m128i fOuterScale;
+    const __m128i fInnerScale;
+    const __m128i fHalf;
+    const bool    fInterp;
+};
+
+} // namespace
+
+void SkBoxBlurA8_SSE2(const uint8_t* src, int srcRowBytes, uint8_t* dst,
+                      int leftRadius, int rightRadius, int width, int height,
+                      bool transpose, uint32_t outerScale, uint32_t innerScale) {
+#ifndef SK_DISABLE_BLUR_ROUNDING
+    const uint32_t half = 1 << 23;
+#else
+    const uint32_t half = 0;
+#endif
+    const int diameter = leftRadius + rightRadius;
+    const int border = SkMin32(width, diameter);
+    const int newWidth = width + SkMax32(leftRadius, rightRadius) * 2;
+    const bool interp = innerScale != 0;
+    const __m128i zero = _mm_setzero_si128();
+
+    // The current strip, one column of 16 bytes per source x, and its results, one column per
+    // destination x.
+    SkAutoTMalloc<uint8_t> storage((width + newWidth) * 16);
+    uint8_t* columns = storage.get();
+    uint8_t* results = columns + width * 16;
+
+    for (int y0 = 0; y0 < height; y0 += 16) {
+        const int rows = SkMin32(16, height - y0);
+        const uint8_t* strip = src + y0 * srcRowBytes;
+
+        int x = 0;
+        for (; x + 16 <= width; x += 16) {
+            __m128i r[16];
+            for (int i = 0; i < 16; ++i) {
+                r[i] = i < rows ? _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(strip + i * srcRowBytes + x)) : zero;
+            }
+            transpose16x16(r);
+            for (int i = 0; i < 16; ++i) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(columns + (x + i) * 16), r[i]);
+            }
+        }
+        for (; x < width; ++x) {
+            for (int i = 0; i < 16; ++i) {
+                columns[x * 16 + i] = i < rows ? strip[i * srcRowBytes + x] : 0;
+            }
+        }
+
+        // The same four phases as boxBlur() and boxBlurInterp() in SkBlurMask.cpp.
+        A8Writer writer(results, outerScale, innerScale, half);
+        Sums16 outer, inner, value;
+        outer.setZero();
+        inner.setZero();
+        const uint8_t* right = columns;
+        const uint8_t* left = columns;
+        for (int i = leftRadius; i < rightRadius; ++i) {
+            writer.writeZero();
+        }
+        for (x = 0; x < border; ++x) {
+            if (interp) {
+                inner = outer;
+            }
+            value.load(right);
+            right += 16;
+            outer.add(value);
+            writer.write(outer, inner);
+        }
+        for (x = width; x < diameter; ++x) {
+            writer.write(outer, inner);
+        }
+        for (x = diameter; x < width; ++x) {
+            Sums16 leftValue;
+            leftValue.load(left);
+            left += 16;
+            if (interp) {
+                inner = outer;
+                inner.sub(leftValue);
+            }
+            value.load(right);
+            right += 16;
+            outer.add(value);
+            writer.write(outer, inner);
+            outer.sub(leftValue);
+        }
+        for (x = 0; x < border; ++x) {
+            value.load(left);
+            left += 16;
+            if (interp) {
+                inner = outer;
+                inner.sub(value);
+                writer.write(outer, inner);
+                outer = inner;
+            } else {
+                writer.write(outer, inner);
+                outer.sub(value);
+            }
+        }
+        for (int i = rightRadius; i < leftRadius; ++i) {
+            writer.writeZero();
+        }
+
+        if (transpose) {
+            // Each result column is (part of) a destination row.
+            uint8_t* dptr = dst + y0;
+            for (x = 0; x < newWidth; ++x) {
+                if (16 == rows) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dptr),
+                                     _mm_loadu_si128(
+                                             reinterpret_cast<const __m128i*>(results + x * 16)));
+                } else {
+                    memcpy(dptr, results + x * 16, rows);
+                }
+                dptr += height;
+            }
+        } else {
+            for (x = 0; x < newWidth; x += 16) {
+                const int count = SkMin32(16, newWidth - x);
+                __m128i r[16];
+                for (int i = 0; i < 16; ++i) {
+                    r[i] = i < count ? _mm_loadu_si128(
+                            reinterpret_cast<const __m128i*>(results + (x + i) * 16)) : zero;
+                }
+                transpose16x16(r);
+                for (int i = 0; i < rows; ++i) {
+                    uint8_t* dptr = dst + (y0 + i) * newWidth + x;
+                    if (16 == count) {
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(dptr), r[i]);
+                    } else {
+                        uint8_t tmp[16];
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(tmp), r[i]);
+                        memcpy(dptr, tmp, count);
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool SkBoxBlurGetPlatformProcs_SSE2(SkBoxBlurProc* boxBlurX, SkBoxBlurProc* boxBlurXT) {
+    *boxBlurX = box_blur_SSE2<false>;
+    *boxBlurXT = box_blur_SSE2<true>;
+    return true;
+}
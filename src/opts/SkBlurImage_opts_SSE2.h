@@ -0,0 +1,19 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBlurImage_opts_SSE2_DEFINED
+#define SkBlurImage_opts_SSE2_DEFINED
+
+#include "SkBlurImage_opts.h"
+
+bool SkBoxBlurGetPlatformProcs_SSE2(SkBoxBlurProc* boxBlurX, SkBoxBlurProc* boxBlurXT);
+
+void SkBoxBlurA8_SSE2(const uint8_t* src, int srcRowBytes, uint8_t* dst,
+                      int leftRadius, int rightRadius, int width, int height,
+                      bool transpose, uint32_t outerScale, uint32_t innerScale);
+
+#endif
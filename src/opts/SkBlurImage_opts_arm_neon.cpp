@@ -0,0 +1,63 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBlurImage_opts_arm_neon.h"
+
+#include <arm_neon.h>
+
+namespace {
+
+// Widens the four bytes of c to a 32-bit lane each, keeping their memory order.
+inline uint32x4_t expand(SkPMColor c) {
+    uint8x8_t v = vreinterpret_u8_u32(vdup_n_u32(c));
+    return vmovl_u16(vget_low_u16(vmovl_u8(v)));
+}
+
+template<bool transpose>
+void box_blur_neon(const SkPMColor* src, int srcStride, SkPMColor* dst, int kernelSize,
+                   int leftOffset, int rightOffset, int width, int height)
+{
+    const int rightBorder = SkMin32(rightOffset + 1, width);
+    const int dstStrideX = transpose ? height : 1;
+    const int dstStrideY = transpose ? 1 : width;
+    SkASSERT(kernelSize <= SK_MAX_PLATFORM_BOX_BLUR_KERNEL);
+    // sum / kernelSize, exactly for kernels up to SK_MAX_PLATFORM_BOX_BLUR_KERNEL. See the SSE2
+    // average().
+    const uint32x4_t scale = vdupq_n_u32(((1 << 24) + kernelSize - 1) / kernelSize);
+    for (int y = 0; y < height; ++y) {
+        uint32x4_t sum = vdupq_n_u32(0);
+        for (int i = 0; i < rightBorder; ++i) {
+            sum = vaddq_u32(sum, expand(src[i]));
+        }
+
+        SkPMColor* dptr = dst;
+        for (int x = 0; x < width; ++x) {
+            // Every channel average is at most 255, so narrowing cannot saturate.
+            uint32x4_t result = vshrq_n_u32(vmulq_u32(sum, scale), 24);
+            uint16x4_t result16 = vmovn_u32(result);
+            uint8x8_t result8 = vmovn_u16(vcombine_u16(result16, result16));
+            *dptr = vget_lane_u32(vreinterpret_u32_u8(result8), 0);
+            if (x >= leftOffset) {
+                sum = vsubq_u32(sum, expand(src[x - leftOffset]));
+            }
+            if (x + rightOffset + 1 < width) {
+                sum = vaddq_u32(sum, expand(src[x + rightOffset + 1]));
+            }
+            dptr += dstStrideX;
+        }
+        src += srcStride;
+        dst += dstStrideY;
+    }
+}
+
+} // namespace
+
+bool SkBoxBlurGetPlatformProcs_NEON(SkBoxBlurProc* boxBlurX, SkBoxBlurProc* boxBlurXT) {
+    *boxBlurX = box_blur_neon<false>;
+    *boxBlurXT = box_blur_neon<true>;
+    return true;
+}
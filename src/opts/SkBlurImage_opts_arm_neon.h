@@ -0,0 +1,14 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkBlurImage_opts_arm_neon_DEFINED
+#define SkBlurImage_opts_arm_neon_DEFINED
+
+#include "SkBlurImage_opts.h"
+
+bool SkBoxBlurGetPlatformProcs_NEON(SkBoxBlurProc* boxBlurX, SkBoxBlurProc* boxBlurXT);
+
+#endif
@@ -0,0 +1,18 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBlurImage_opts.h"
+
+// Platform impl of the box blur procs with no overrides
+
+bool SkBoxBlurGetPlatformProcs(SkBoxBlurProc*, SkBoxBlurProc*) {
+    return false;
+}
+
+SkBoxBlurA8Proc SkBoxBlurA8GetPlatformProc() {
+    return NULL;
+}
@@ -0,0 +1,227 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <emmintrin.h>
+#include "SkConvertRow_opts_SSE2.h"
+#include "SkColorPriv.h"
+
+// The kernels below shuffle bytes around, so they only know how to produce
+// SkPMColors that are R,G,B,A or B,G,R,A in memory.
+#if SK_PMCOLOR_BYTE_ORDER(B,G,R,A) || SK_PMCOLOR_BYTE_ORDER(R,G,B,A)
+
+namespace {
+
+// True if the src R and B bytes need to trade places on their way into an
+// SkPMColor.
+#if SK_PMCOLOR_BYTE_ORDER(B,G,R,A)
+static const bool kRGB_NeedsSwap = true;
+#else
+static const bool kRGB_NeedsSwap = false;
+#endif
+
+// Swap bytes 0 and 2 of each 32-bit lane, leaving bytes 1 and 3 alone.
+static inline __m128i swap_rb_SSE2(__m128i pixels) {
+    const __m128i ag_mask = _mm_set1_epi32(0xFF00FF00);
+    const __m128i lo_mask = _mm_set1_epi32(0x000000FF);
+    __m128i ag = _mm_and_si128(pixels, ag_mask);
+    __m128i r = _mm_and_si128(_mm_srli_epi32(pixels, 16), lo_mask);
+    __m128i b = _mm_slli_epi32(_mm_and_si128(pixels, lo_mask), 16);
+    return _mm_or_si128(ag, _mm_or_si128(r, b));
+}
+
+// Premultiply two pixels that have been unpacked into 16-bit lanes,
+// (c0, c1, c2, a, c0, c1, c2, a), and optionally swap c0 and c2.
+// Computes SkMulDiv255Round(c, a) exactly for each color channel.
+template <bool SWAP>
+static inline __m128i premul_unpacked_SSE2(__m128i pixels) {
+    // Select lane 3 (alpha) in each half, then force the alpha lanes of the
+    // multiplier to 255 so alpha survives the divide by 255 unchanged.
+    __m128i scale = _mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3));
+    scale = _mm_shufflehi_epi16(scale, _MM_SHUFFLE(3, 3, 3, 3));
+    scale = _mm_or_si128(_mm_and_si128(scale, _mm_set_epi16(0, -1, -1, -1,
+                                                            0, -1, -1, -1)),
+                         _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0));
+
+    // prod <= 255 * 255, so the rounding below fits in 16 bits.
+    __m128i prod = _mm_mullo_epi16(pixels, scale);
+    prod = _mm_add_epi16(prod, _mm_set1_epi16(128));
+    prod = _mm_add_epi16(prod, _mm_srli_epi16(prod, 8));
+    prod = _mm_srli_epi16(prod, 8);
+
+    if (SWAP) {
+        prod = _mm_shufflelo_epi16(prod, _MM_SHUFFLE(3, 0, 1, 2));
+        prod = _mm_shufflehi_epi16(prod, _MM_SHUFFLE(3, 0, 1, 2));
+    }
+    return prod;
+}
+
+// Returns true if every byte 3 (alpha) of the four pixels is 0xFF.
+static inline bool all_opaque_SSE2(__m128i pixels) {
+    __m128i a = _mm_or_si128(pixels, _mm_set1_epi32(0x00FFFFFF));
+    a = _mm_cmpeq_epi8(a, _mm_set1_epi32(0xFFFFFFFF));
+    return 0xFFFF == _mm_movemask_epi8(a);
+}
+
+// 4-byte unpremultiplied src to SkPMColor. SRC_BGRA is true if the src is
+// B,G,R,A in memory, false if it is R,G,B,A.
+template <bool SRC_BGRA>
+static bool premul_4888_SSE2(SkPMColor* SK_RESTRICT dst,
+                             const uint8_t* SK_RESTRICT src, int count) {
+    const bool SWAP = (SRC_BGRA != kRGB_NeedsSwap);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i alphaAnd = _mm_set1_epi32(0xFFFFFFFF);
+
+    while (count >= 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        alphaAnd = _mm_and_si128(alphaAnd, pixels);
+
+        __m128i result;
+        if (all_opaque_SSE2(pixels)) {
+            // Nothing to multiply; this is the common case for most images.
+            result = SWAP ? swap_rb_SSE2(pixels) : pixels;
+        } else {
+            __m128i lo = premul_unpacked_SSE2<SWAP>(_mm_unpacklo_epi8(pixels, zero));
+            __m128i hi = premul_unpacked_SSE2<SWAP>(_mm_unpackhi_epi8(pixels, zero));
+            result = _mm_packus_epi16(lo, hi);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), result);
+
+        src += 16;
+        dst += 4;
+        count -= 4;
+    }
+
+    bool hadAlpha = !all_opaque_SSE2(alphaAnd);
+    for (int i = 0; i < count; i++) {
+        unsigned a = src[3];
+        if (SRC_BGRA) {
+            dst[i] = SkPremultiplyARGBInline(a, src[2], src[1], src[0]);
+        } else {
+            dst[i] = SkPremultiplyARGBInline(a, src[0], src[1], src[2]);
+        }
+        hadAlpha |= (0xFF != a);
+        src += 4;
+    }
+    return hadAlpha;
+}
+
+static bool RGBA_To_PMColor_SSE2(SkPMColor* SK_RESTRICT dst,
+                                 const uint8_t* SK_RESTRICT src, int count) {
+    return premul_4888_SSE2<false>(dst, src, count);
+}
+
+static bool BGRA_To_PMColor_SSE2(SkPMColor* SK_RESTRICT dst,
+                                 const uint8_t* SK_RESTRICT src, int count) {
+    return premul_4888_SSE2<true>(dst, src, count);
+}
+
+static bool RGBX_To_PMColor_SSE2(SkPMColor* SK_RESTRICT dst,
+                                 const uint8_t* SK_RESTRICT src, int count) {
+    const __m128i alpha = _mm_set1_epi32(0xFF000000);
+    while (count >= 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        if (kRGB_NeedsSwap) {
+            pixels = swap_rb_SSE2(pixels);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                         _mm_or_si128(pixels, alpha));
+        src += 16;
+        dst += 4;
+        count -= 4;
+    }
+    for (int i = 0; i < count; i++) {
+        dst[i] = SkPackARGB32(0xFF, src[0], src[1], src[2]);
+        src += 4;
+    }
+    return false;
+}
+
+// memcpy rather than a cast, since src need not be aligned for a uint32_t.
+// Compilers turn it into a single load.
+static inline uint32_t load_unaligned_32(const uint8_t* src) {
+    uint32_t value;
+    memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+static bool RGB_To_PMColor_SSE2(SkPMColor* SK_RESTRICT dst,
+                                const uint8_t* SK_RESTRICT src, int count) {
+    const __m128i alpha = _mm_set1_epi32(0xFF000000);
+    // Each 32-bit load picks up one byte of the following pixel, so stop one
+    // pixel early to avoid reading past the end of the row.
+    while (count > 4) {
+        __m128i pixels = _mm_set_epi32(load_unaligned_32(src + 9),
+                                       load_unaligned_32(src + 6),
+                                       load_unaligned_32(src + 3),
+                                       load_unaligned_32(src + 0));
+        if (kRGB_NeedsSwap) {
+            pixels = swap_rb_SSE2(pixels);
+        }
+        // Setting alpha also stomps on the byte borrowed from the next pixel.
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                         _mm_or_si128(pixels, alpha));
+        src += 12;
+        dst += 4;
+        count -= 4;
+    }
+    for (int i = 0; i < count; i++) {
+        dst[i] = SkPackARGB32(0xFF, src[0], src[1], src[2]);
+        src += 3;
+    }
+    return false;
+}
+
+static bool Gray_To_PMColor_SSE2(SkPMColor* SK_RESTRICT dst,
+                                 const uint8_t* SK_RESTRICT src, int count) {
+    const __m128i alpha = _mm_set1_epi8(0xFF);
+    while (count >= 16) {
+        __m128i gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        // (g, g) and (g, 0xFF) byte pairs, interleaved into (g, g, g, 0xFF).
+        __m128i gg_lo = _mm_unpacklo_epi8(gray, gray);
+        __m128i gg_hi = _mm_unpackhi_epi8(gray, gray);
+        __m128i ga_lo = _mm_unpacklo_epi8(gray, alpha);
+        __m128i ga_hi = _mm_unpackhi_epi8(gray, alpha);
+
+        __m128i* d = reinterpret_cast<__m128i*>(dst);
+        _mm_storeu_si128(d + 0, _mm_unpacklo_epi16(gg_lo, ga_lo));
+        _mm_storeu_si128(d + 1, _mm_unpackhi_epi16(gg_lo, ga_lo));
+        _mm_storeu_si128(d + 2, _mm_unpacklo_epi16(gg_hi, ga_hi));
+        _mm_storeu_si128(d + 3, _mm_unpackhi_epi16(gg_hi, ga_hi));
+
+        src += 16;
+        dst += 16;
+        count -= 16;
+    }
+    for (int i = 0; i < count; i++) {
+        dst[i] = SkPackARGB32(0xFF, src[i], src[i], src[i]);
+    }
+    return false;
+}
+
+}  // namespace
+
+SkConvertRow::Proc SkConvertRow_PlatformProcs_SSE2(SkConvertRow::SrcFormat format) {
+    static const SkConvertRow::Proc gProcs[] = {
+        Gray_To_PMColor_SSE2,
+        RGB_To_PMColor_SSE2,
+        RGBX_To_PMColor_SSE2,
+        RGBA_To_PMColor_SSE2,
+        BGRA_To_PMColor_SSE2,
+    };
+    SK_COMPILE_ASSERT(SK_ARRAY_COUNT(gProcs) == SkConvertRow::kSrcFormatCount,
+                      gProcs_has_the_wrong_number_of_entries);
+    SkASSERT((unsigned)format < SkConvertRow::kSrcFormatCount);
+    return gProcs[format];
+}
+
+#else
+
+SkConvertRow::Proc SkConvertRow_PlatformProcs_SSE2(SkConvertRow::SrcFormat) {
+    return NULL;
+}
+
+#endif
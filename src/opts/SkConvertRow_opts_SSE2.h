@@ -0,0 +1,18 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkConvertRow_opts_SSE2_DEFINED
+#define SkConvertRow_opts_SSE2_DEFINED
+
+#include "SkConvertRow.h"
+
+/** Returns the SSE2 proc for the given SrcFormat, or NULL if there is none
+    (e.g. SkPMColor is neither R,G,B,A nor B,G,R,A in memory).
+ */
+SkConvertRow::Proc SkConvertRow_PlatformProcs_SSE2(SkConvertRow::SrcFormat);
+
+#endif
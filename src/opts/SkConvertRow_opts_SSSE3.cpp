@@ -0,0 +1,95 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <tmmintrin.h>  // SSSE3
+#include "SkConvertRow_opts_SSSE3.h"
+#include "SkColorPriv.h"
+
+// pshufb lets us expand packed 3-byte pixels (and reorder 4-byte ones) in a
+// single instruction, which SSE2 can only emulate with scalar loads.
+#if SK_PMCOLOR_BYTE_ORDER(B,G,R,A) || SK_PMCOLOR_BYTE_ORDER(R,G,B,A)
+
+namespace {
+
+// Indices into the src for each byte of four SkPMColors. -1 (0x80) zeroes the
+// alpha byte, which is then set with an OR.
+#if SK_PMCOLOR_BYTE_ORDER(B,G,R,A)
+#define RGB_SHUFFLE     2,  1,  0, -1,  5,  4,  3, -1,  8,  7,  6, -1, 11, 10,  9, -1
+#define RGBX_SHUFFLE    2,  1,  0, -1,  6,  5,  4, -1, 10,  9,  8, -1, 14, 13, 12, -1
+#else
+#define RGB_SHUFFLE     0,  1,  2, -1,  3,  4,  5, -1,  6,  7,  8, -1,  9, 10, 11, -1
+#define RGBX_SHUFFLE    0,  1,  2, -1,  4,  5,  6, -1,  8,  9, 10, -1, 12, 13, 14, -1
+#endif
+
+static inline __m128i make_shuffle(char b0, char b1, char b2, char b3,
+                                   char b4, char b5, char b6, char b7,
+                                   char b8, char b9, char b10, char b11,
+                                   char b12, char b13, char b14, char b15) {
+    return _mm_setr_epi8(b0, b1, b2, b3, b4, b5, b6, b7,
+                         b8, b9, b10, b11, b12, b13, b14, b15);
+}
+
+static bool RGB_To_PMColor_SSSE3(SkPMColor* SK_RESTRICT dst,
+                                 const uint8_t* SK_RESTRICT src, int count) {
+    const __m128i shuffle = make_shuffle(RGB_SHUFFLE);
+    const __m128i alpha = _mm_set1_epi32(0xFF000000);
+    // Four pixels only use 12 of the 16 bytes we load, so make sure the load
+    // stays inside the row.
+    while (count >= 6) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        pixels = _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), pixels);
+        src += 12;
+        dst += 4;
+        count -= 4;
+    }
+    for (int i = 0; i < count; i++) {
+        dst[i] = SkPackARGB32(0xFF, src[0], src[1], src[2]);
+        src += 3;
+    }
+    return false;
+}
+
+static bool RGBX_To_PMColor_SSSE3(SkPMColor* SK_RESTRICT dst,
+                                  const uint8_t* SK_RESTRICT src, int count) {
+    const __m128i shuffle = make_shuffle(RGBX_SHUFFLE);
+    const __m128i alpha = _mm_set1_epi32(0xFF000000);
+    while (count >= 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        pixels = _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), pixels);
+        src += 16;
+        dst += 4;
+        count -= 4;
+    }
+    for (int i = 0; i < count; i++) {
+        dst[i] = SkPackARGB32(0xFF, src[0], src[1], src[2]);
+        src += 4;
+    }
+    return false;
+}
+
+}  // namespace
+
+SkConvertRow::Proc SkConvertRow_PlatformProcs_SSSE3(SkConvertRow::SrcFormat format) {
+    switch (format) {
+        case SkConvertRow::kRGB_SrcFormat:
+            return RGB_To_PMColor_SSSE3;
+        case SkConvertRow::kRGBX_SrcFormat:
+            return RGBX_To_PMColor_SSSE3;
+        default:
+            return NULL;
+    }
+}
+
+#else
+
+SkConvertRow::Proc SkConvertRow_PlatformProcs_SSSE3(SkConvertRow::SrcFormat) {
+    return NULL;
+}
+
+#endif
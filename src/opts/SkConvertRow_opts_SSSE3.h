@@ -0,0 +1,18 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkConvertRow_opts_SSSE3_DEFINED
+#define SkConvertRow_opts_SSSE3_DEFINED
+
+#include "SkConvertRow.h"
+
+/** Returns the SSSE3 proc for the given SrcFormat, or NULL if SSSE3 offers
+    nothing over the SSE2 version.
+ */
+SkConvertRow::Proc SkConvertRow_PlatformProcs_SSSE3(SkConvertRow::SrcFormat);
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkConvertRow_opts_arm_neon.h"
+
+#include "SkColorPriv.h"
+
+#include <arm_neon.h>
+
+// vld3/vld4/vst4 (de)interleave bytes in memory order, so all we need is the
+// memory position of each SkPMColor component.
+#if SK_PMCOLOR_BYTE_ORDER(B,G,R,A) || SK_PMCOLOR_BYTE_ORDER(R,G,B,A)
+
+#if SK_PMCOLOR_BYTE_ORDER(B,G,R,A)
+    #define PM_R_IDX    2
+    #define PM_B_IDX    0
+#else
+    #define PM_R_IDX    0
+    #define PM_B_IDX    2
+#endif
+#define PM_G_IDX        1
+#define PM_A_IDX        3
+
+// Computes SkMulDiv255Round(color, alpha) for 8 lanes.
+static inline uint8x8_t mul_div255_round_neon(uint8x8_t color, uint8x8_t alpha) {
+    uint16x8_t prod = vmull_u8(color, alpha);
+    prod = vaddq_u16(prod, vdupq_n_u16(128));
+    return vshrn_n_u16(vaddq_u16(prod, vshrq_n_u16(prod, 8)), 8);
+}
+
+template <bool SRC_BGRA>
+static bool premul_4888_neon(SkPMColor* SK_RESTRICT dst,
+                             const uint8_t* SK_RESTRICT src, int count) {
+    uint8x8_t alphaAnd = vdup_n_u8(0xFF);
+    while (count >= 8) {
+        uint8x8x4_t s = vld4_u8(src);
+        uint8x8_t a = s.val[3];
+        alphaAnd = vand_u8(alphaAnd, a);
+
+        uint8x8x4_t d;
+        d.val[PM_R_IDX] = mul_div255_round_neon(s.val[SRC_BGRA ? 2 : 0], a);
+        d.val[PM_G_IDX] = mul_div255_round_neon(s.val[1], a);
+        d.val[PM_B_IDX] = mul_div255_round_neon(s.val[SRC_BGRA ? 0 : 2], a);
+        d.val[PM_A_IDX] = a;
+        vst4_u8(reinterpret_cast<uint8_t*>(dst), d);
+
+        src += 32;
+        dst += 8;
+        count -= 8;
+    }
+
+    uint64_t alphaBits = vget_lane_u64(vreinterpret_u64_u8(alphaAnd), 0);
+    bool hadAlpha = (~static_cast<uint64_t>(0) != alphaBits);
+    for (int i = 0; i < count; i++) {
+        unsigned a = src[3];
+        if (SRC_BGRA) {
+            dst[i] = SkPremultiplyARGBInline(a, src[2], src[1], src[0]);
+        } else {
+            dst[i] = SkPremultiplyARGBInline(a, src[0], src[1], src[2]);
+        }
+        hadAlpha |= (0xFF != a);
+        src += 4;
+    }
+    return hadAlpha;
+}
+
+static bool RGBA_To_PMColor_neon(SkPMColor* SK_RESTRICT dst,
+                                 const uint8_t* SK_RESTRICT src, int count) {
+    return premul_4888_neon<false>(dst, src, count);
+}
+
+static bool BGRA_To_PMColor_neon(SkPMColor* SK_RESTRICT dst,
+                                 const uint8_t* SK_RESTRICT src, int count) {
+    return premul_4888_neon<true>(dst, src, count);
+}
+
+static bool RGBX_To_PMColor_neon(SkPMColor* SK_RESTRICT dst,
+                                 const uint8_t* SK_RESTRICT src, int count) {
+    while (count >= 8) {
+        uint8x8x4_t s = vld4_u8(src);
+        uint8x8x4_t d;
+        d.val[PM_R_IDX] = s.val[0];
+        d.val[PM_G_IDX] = s.val[1];
+        d.val[PM_B_IDX] = s.val[2];
+        d.val[PM_A_IDX] = vdup_n_u8(0xFF);
+        vst4_u8(reinterpret_cast<uint8_t*>(dst), d);
+
+        src += 32;
+        dst += 8;
+        count -= 8;
+    }
+    for (int i = 0; i < count; i++) {
+        dst[i] = SkPackARGB32(0xFF, src[0], src[1], src[2]);
+        src += 4;
+    }
+    return false;
+}
+
+static bool RGB_To_PMColor_neon(SkPMColor* SK_RESTRICT dst,
+                                const uint8_t* SK_RESTRICT src, int count) {
+    while (count >= 8) {
+        uint8x8x3_t s = vld3_u8(src);
+        uint8x8x4_t d;
+        d.val[PM_R_IDX] = s.val[0];
+        d.val[PM_G_IDX] = s.val[1];
+        d.val[PM_B_IDX] = s.val[2];
+        d.val[PM_A_IDX] = vdup_n_u8(0xFF);
+        vst4_u8(reinterpret_cast<uint8_t*>(dst), d);
+
+        src += 24;
+        dst += 8;
+        count -= 8;
+    }
+    for (int i = 0; i < count; i++) {
+        dst[i] = SkPackARGB32(0xFF, src[0], src[1], src[2]);
+        src += 3;
+    }
+    return false;
+}
+
+static bool Gray_To_PMColor_neon(SkPMColor* SK_RESTRICT dst,
+                                 const uint8_t* SK_RESTRICT src, int count) {
+    while (count >= 8) {
+        uint8x8_t g = vld1_u8(src);
+        uint8x8x4_t d;
+        d.val[PM_R_IDX] = g;
+        d.val[PM_G_IDX] = g;
+        d.val[PM_B_IDX] = g;
+        d.val[PM_A_IDX] = vdup_n_u8(0xFF);
+        vst4_u8(reinterpret_cast<uint8_t*>(dst), d);
+
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
+    for (int i = 0; i < count; i++) {
+        dst[i] = SkPackARGB32(0xFF, src[i], src[i], src[i]);
+    }
+    return false;
+}
+
+const SkConvertRow::Proc sk_convertrow_platform_procs_arm_neon[] = {
+    Gray_To_PMColor_neon,
+    RGB_To_PMColor_neon,
+    RGBX_To_PMColor_neon,
+    RGBA_To_PMColor_neon,
+    BGRA_To_PMColor_neon,
+};
+
+#else
+
+const SkConvertRow::Proc sk_convertrow_platform_procs_arm_neon[] = {
+    NULL, NULL, NULL, NULL, NULL,
+};
+
+#endif
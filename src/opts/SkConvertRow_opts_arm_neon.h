@@ -0,0 +1,14 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkConvertRow_opts_arm_neon_DEFINED
+#define SkConvertRow_opts_arm_neon_DEFINED
+
+#include "SkConvertRow.h"
+
+extern const SkConvertRow::Proc sk_convertrow_platform_procs_arm_neon[];
+
+#endif
@@ -0,0 +1,14 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkConvertRow.h"
+
+// Platform impl of Platform_procs with no overrides
+
+SkConvertRow::Proc SkConvertRow::PlatformProcs(SrcFormat) {
+    return NULL;
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGradient_opts_DEFINED
+#define SkGradient_opts_DEFINED
+
+#include "SkColorPriv.h"
+#include "SkShader.h"
+
+/*
+ *  The procs below shade count pixels of a gradient span, by looking up the 32 bit color
+ *  table that SkGradientShaderBase builds: 256 colors, followed by their dithered versions.
+ *  toggle is the offset into the table of the first pixel's dither row, and alternates with
+ *  toggle ^ 256 from pixel to pixel. The results match the portable code exactly.
+ */
+
+/**
+ *  Linear gradients: pixel i is at 16.16 fx + i * dx. For the clamp mode the caller must
+ *  ensure that all of them are in [0, 0xFFFF].
+ */
+typedef void (*SkLinearGradientSpanProc)(SkFixed fx, SkFixed dx, const SkPMColor cache[],
+                                         int toggle, SkPMColor dst[], int count);
+
+/**
+ *  Radial gradients: pixel i is at (fx, fy) + i * (dx, dy), in units of the radius.
+ *  sqrtTable is SkRadialGradient's 2048 entry square root table, which the clamp mode uses.
+ */
+typedef void (*SkRadialGradientSpanProc)(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
+                                         const uint8_t sqrtTable[], const SkPMColor cache[],
+                                         int toggle, SkPMColor dst[], int count);
+
+/**
+ *  Two point conical gradients, with the state of SkTwoPointConicalGradient's TwoPtRadial
+ *  at the first pixel. Pixels outside the cone are set to 0. fA must not be 0: the caller
+ *  handles that (linear) case.
+ */
+struct SkConicalSpanParams {
+    float   fA;
+    float   fRadius;
+    float   fDRadius;
+    float   fRadius2;
+    float   fRelX, fRelY;   //!< incremented by fIncX, fIncY per pixel
+    float   fIncX, fIncY;
+    float   fB;             //!< incremented by fDB per pixel
+    float   fDB;
+};
+
+typedef void (*SkConicalGradientSpanProc)(const SkConicalSpanParams& params,
+                                          const SkPMColor cache[], int toggle,
+                                          SkPMColor dst[], int count);
+
+/**
+ *  Return a platform specific span proc for the tile mode, or NULL if the portable code
+ *  should be used.
+ */
+SkLinearGradientSpanProc SkLinearGradientGetPlatformProc(SkShader::TileMode);
+SkRadialGradientSpanProc SkRadialGradientGetPlatformProc(SkShader::TileMode);
+SkConicalGradientSpanProc SkConicalGradientGetPlatformProc(SkShader::TileMode);
+
+#endif
@@ -0,0 +1,351 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGradient_opts_SSE2.h"
+
+#include <emmintrin.h>
+
+namespace {
+
+// SkGradientShaderBase::kDitherStride32
+const int kDitherStride = 256;
+
+// Four pixels are shaded at a time. Since that is an even number, every group of four
+// starts with the same dither row.
+inline __m128i dither_toggles(int toggle) {
+    return _mm_setr_epi32(toggle, toggle ^ kDitherStride, toggle, toggle ^ kDitherStride);
+}
+
+// Return the 16.16 values fx, fx + dx, fx + 2 * dx, fx + 3 * dx, wrapping on overflow as
+// the portable code does.
+inline __m128i fixed_steps(SkFixed fx, SkFixed dx) {
+    uint32_t udx = dx;
+    return _mm_add_epi32(_mm_set1_epi32(fx),
+                         _mm_setr_epi32(0, udx, 2 * udx, 3 * udx));
+}
+
+// Return x, x + dx, (x + dx) + dx, ((x + dx) + dx) + dx, and advance x past them. The
+// portable code steps its float coordinates one pixel at a time, so we do too, to round the
+// same way.
+inline __m128 float_steps(float* x, float dx) {
+    float x0 = *x;
+    float x1 = x0 + dx;
+    float x2 = x1 + dx;
+    float x3 = x2 + dx;
+    *x = x3 + dx;
+    return _mm_setr_ps(x0, x1, x2, x3);
+}
+
+// Write cache[index] for the four lanes of index. The table offsets are less than 2^16, so
+// they can be extracted from the register directly.
+inline void lookup4(__m128i index, const SkPMColor cache[], SkPMColor dst[]) {
+    dst[0] = cache[_mm_extract_epi16(index, 0)];
+    dst[1] = cache[_mm_extract_epi16(index, 2)];
+    dst[2] = cache[_mm_extract_epi16(index, 4)];
+    dst[3] = cache[_mm_extract_epi16(index, 6)];
+}
+
+// Write cache[index] for the first count (at most 4) lanes of index.
+inline void lookup(__m128i index, const SkPMColor cache[], SkPMColor dst[], int count) {
+    if (4 == count) {
+        lookup4(index, cache, dst);
+        return;
+    }
+    int32_t i[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(i), index);
+    for (int k = 0; k < count; ++k) {
+        dst[k] = cache[i[k]];
+    }
+}
+
+// As lookup(), but lanes whose draw mask is clear are set to 0.
+inline void lookup_masked(__m128i index, __m128i draw, const SkPMColor cache[],
+                          SkPMColor dst[], int count) {
+    int32_t i[4], d[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(i), index);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(d), draw);
+    for (int k = 0; k < count; ++k) {
+        dst[k] = d[k] ? cache[i[k]] : 0;
+    }
+}
+
+// Map 16.16 values to an 8 bit table index, as the tile procs in SkGradientShaderPriv.h do.
+template <SkShader::TileMode tileMode>
+inline __m128i tile_index(__m128i fx) {
+    switch (tileMode) {
+        case SkShader::kClamp_TileMode: {
+            // SkClampMax(fx, 0xFFFF), done with a saturating pack: fx is first shifted down
+            // so that its range fits in 16 bits.
+            __m128i x = _mm_srai_epi32(fx, 8);
+            x = _mm_packs_epi32(x, x);
+            x = _mm_max_epi16(x, _mm_setzero_si128());
+            x = _mm_min_epi16(x, _mm_set1_epi16(0xFF));
+            return _mm_unpacklo_epi16(x, _mm_setzero_si128());
+        }
+        case SkShader::kRepeat_TileMode:
+            return _mm_and_si128(_mm_srli_epi32(fx, 8), _mm_set1_epi32(0xFF));
+        case SkShader::kMirror_TileMode:
+        default: {
+            __m128i s = _mm_srai_epi32(_mm_slli_epi32(fx, 15), 31);
+            return _mm_and_si128(_mm_srli_epi32(_mm_xor_si128(fx, s), 8),
+                                 _mm_set1_epi32(0xFF));
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <SkShader::TileMode tileMode>
+void linear_SSE2(SkFixed fx, SkFixed dx, const SkPMColor cache[], int toggle,
+                 SkPMColor dst[], int count) {
+    const __m128i toggles = dither_toggles(toggle);
+    const __m128i step = _mm_set1_epi32((uint32_t)dx * 4);
+    __m128i x = fixed_steps(fx, dx);
+    for (; count >= 4; count -= 4) {
+        lookup(_mm_add_epi32(tile_index<tileMode>(x), toggles), cache, dst, 4);
+        x = _mm_add_epi32(x, step);
+        dst += 4;
+    }
+    if (count > 0) {
+        lookup(_mm_add_epi32(tile_index<tileMode>(x), toggles), cache, dst, count);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Same precision as the portable code: 15 bit coordinates, pinned to [-0x8000, 0x7FFF] and
+// squared into an index of the 2048 entry square root table.
+void radial_clamp_SSE2(SkScalar sfx, SkScalar sdx, SkScalar sfy, SkScalar sdy,
+                       const uint8_t sqrtTable[], const SkPMColor cache[], int toggle,
+                       SkPMColor dst[], int count) {
+    const SkFixed fx = SkScalarToFixed(sfx) >> 1;
+    const SkFixed dx = SkScalarToFixed(sdx) >> 1;
+    const SkFixed fy = SkScalarToFixed(sfy) >> 1;
+    const SkFixed dy = SkScalarToFixed(sdy) >> 1;
+
+    const __m128i toggles = dither_toggles(toggle);
+    const __m128i stepX = _mm_set1_epi32((uint32_t)dx * 4);
+    const __m128i stepY = _mm_set1_epi32((uint32_t)dy * 4);
+    const __m128i maxIndex = _mm_set1_epi32(0x7FF);
+    __m128i x = fixed_steps(fx, dx);
+    __m128i y = fixed_steps(fy, dy);
+    while (count > 0) {
+        // Pin with a saturating pack, then interleave x and y so that one multiply-add
+        // computes x * x + y * y.
+        __m128i xy = _mm_unpacklo_epi16(_mm_packs_epi32(x, x), _mm_packs_epi32(y, y));
+        __m128i fi = _mm_srli_epi32(_mm_madd_epi16(xy, xy), 14 + 16 - 11);
+        fi = _mm_min_epi16(fi, maxIndex);
+
+        int32_t i[4], t[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(i), fi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(t), toggles);
+        int n = count < 4 ? count : 4;
+        for (int k = 0; k < n; ++k) {
+            dst[k] = cache[t[k] + sqrtTable[i[k]]];
+        }
+
+        x = _mm_add_epi32(x, stepX);
+        y = _mm_add_epi32(y, stepY);
+        dst += 4;
+        count -= 4;
+    }
+}
+
+#ifdef SK_SCALAR_IS_FLOAT
+void radial_mirror_SSE2(SkScalar sfx, SkScalar sdx, SkScalar sfy, SkScalar sdy,
+                        const uint8_t[], const SkPMColor cache[], int toggle,
+                        SkPMColor dst[], int count) {
+    const __m128i toggles = dither_toggles(toggle);
+    const __m128 fixed1 = _mm_set1_ps(SK_Fixed1);
+    while (count > 0) {
+        __m128 x = float_steps(&sfx, sdx);
+        __m128 y = float_steps(&sfy, sdy);
+        __m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+        __m128i fi = _mm_cvttps_epi32(_mm_mul_ps(dist, fixed1));
+
+        int n = count < 4 ? count : 4;
+        lookup(_mm_add_epi32(tile_index<SkShader::kMirror_TileMode>(fi), toggles), cache, dst, n);
+        dst += 4;
+        count -= 4;
+    }
+}
+#endif
+
+// Lanes that overflowed to a negative value become SK_FixedMax.
+inline __m128i pin_overflow(__m128i x) {
+    __m128i overflow = _mm_srai_epi32(x, 31);
+    return _mm_or_si128(_mm_andnot_si128(overflow, x),
+                        _mm_and_si128(overflow, _mm_set1_epi32(SK_FixedMax)));
+}
+
+// SkFixedSquare for each lane of x, which must not be negative: the low 32 bits of
+// (x * x) >> 16, which SkFixedSquare_portable also pins on overflow.
+inline __m128i fixed_square(__m128i x) {
+    __m128i even = _mm_srli_epi64(_mm_mul_epu32(x, x), 16);
+    __m128i odd = _mm_srli_epi64(x, 32);
+    odd = _mm_srli_epi64(_mm_mul_epu32(odd, odd), 16);
+    even = _mm_shuffle_epi32(even, _MM_SHUFFLE(3, 1, 2, 0));
+    odd = _mm_shuffle_epi32(odd, _MM_SHUFFLE(3, 1, 2, 0));
+    __m128i square = _mm_unpacklo_epi32(even, odd);
+#ifndef SkLONGLONG
+    square = pin_overflow(square);
+#endif
+    return square;
+}
+
+inline __m128i abs_epi32(__m128i x) {
+    __m128i s = _mm_srai_epi32(x, 31);
+    return _mm_sub_epi32(_mm_xor_si128(x, s), s);
+}
+
+// SkFixedSqrt, which is the integer square root of n << 16. That is less than 2^47, so
+// doubles hold it exactly, and truncating their correctly rounded square root gives the
+// same result.
+inline __m128i fixed_sqrt(__m128i n) {
+    const __m128d fixed1 = _mm_set1_pd(SK_Fixed1);
+    __m128d lo = _mm_sqrt_pd(_mm_mul_pd(_mm_cvtepi32_pd(n), fixed1));
+    __m128d hi = _mm_sqrt_pd(_mm_mul_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(n,
+                                                 _MM_SHUFFLE(1, 0, 3, 2))), fixed1));
+    return _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+}
+
+void radial_repeat_SSE2(SkScalar sfx, SkScalar sdx, SkScalar sfy, SkScalar sdy,
+                        const uint8_t[], const SkPMColor cache[], int toggle,
+                        SkPMColor dst[], int count) {
+    const SkFixed fx = SkScalarToFixed(sfx);
+    const SkFixed dx = SkScalarToFixed(sdx);
+    const SkFixed fy = SkScalarToFixed(sfy);
+    const SkFixed dy = SkScalarToFixed(sdy);
+
+    const __m128i toggles = dither_toggles(toggle);
+    const __m128i stepX = _mm_set1_epi32((uint32_t)dx * 4);
+    const __m128i stepY = _mm_set1_epi32((uint32_t)dy * 4);
+    __m128i x = fixed_steps(fx, dx);
+    __m128i y = fixed_steps(fy, dy);
+    while (count > 0) {
+        __m128i magSq = pin_overflow(_mm_add_epi32(fixed_square(abs_epi32(x)),
+                                                   fixed_square(abs_epi32(y))));
+        __m128i fi = tile_index<SkShader::kRepeat_TileMode>(fixed_sqrt(magSq));
+
+        int n = count < 4 ? count : 4;
+        lookup(_mm_add_epi32(fi, toggles), cache, dst, n);
+        x = _mm_add_epi32(x, stepX);
+        y = _mm_add_epi32(y, stepY);
+        dst += 4;
+        count -= 4;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// TwoPtRadial::nextT() for four pixels, with the quadratic's branches turned into masks.
+// Returns the 16.16 t of each pixel, or TwoPtRadial::kDontDrawT.
+inline __m128i conical_t(const SkConicalSpanParams& p, __m128 relX, __m128 relY, __m128 b) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 a = _mm_set1_ps(p.fA);
+    const __m128 radius = _mm_set1_ps(p.fRadius);
+    const __m128 dRadius = _mm_set1_ps(p.fDRadius);
+
+    __m128 c = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(relX, relX), _mm_mul_ps(relY, relY)),
+                          _mm_set1_ps(p.fRadius2));
+    __m128 r = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(_mm_set1_ps(4 * p.fA), c));
+    __m128 noRoots = _mm_cmplt_ps(r, zero);
+    r = _mm_sqrt_ps(r);
+
+    // Q = -0.5 * (B < 0 ? B - R : B + R)
+    __m128 negB = _mm_cmplt_ps(b, zero);
+    __m128 q = _mm_or_ps(_mm_and_ps(negB, _mm_sub_ps(b, r)),
+                         _mm_andnot_ps(negB, _mm_add_ps(b, r)));
+    q = _mm_mul_ps(q, _mm_set1_ps(-0.5f));
+
+    __m128 r0 = _mm_div_ps(q, a);
+    __m128 r1 = _mm_div_ps(c, q);
+    __m128 lo = _mm_min_ps(r0, r1);
+    __m128 hi = _mm_max_ps(r0, r1);
+    // If Q is 0, the only root is 0.
+    __m128 zeroQ = _mm_cmpeq_ps(q, zero);
+    lo = _mm_andnot_ps(zeroQ, lo);
+    hi = _mm_andnot_ps(zeroQ, hi);
+
+    // Prefer the bigger t if it gives a radius > 0.
+    __m128 useLo = _mm_cmple_ps(_mm_add_ps(radius, _mm_mul_ps(hi, dRadius)), zero);
+    __m128 t = _mm_or_ps(_mm_and_ps(useLo, lo), _mm_andnot_ps(useLo, hi));
+    __m128 dontDraw = _mm_or_ps(noRoots,
+                                _mm_cmple_ps(_mm_add_ps(radius, _mm_mul_ps(t, dRadius)), zero));
+
+    // As in SkFloatToFixed, out of range values become 0x80000000, which also means don't draw.
+    __m128i tFixed = _mm_cvttps_epi32(_mm_mul_ps(t, _mm_set1_ps(SK_Fixed1)));
+    __m128i dontDrawT = _mm_castps_si128(dontDraw);
+    return _mm_or_si128(_mm_andnot_si128(dontDrawT, tFixed),
+                        _mm_and_si128(dontDrawT, _mm_set1_epi32((int)0x80000000)));
+}
+
+template <SkShader::TileMode tileMode>
+void conical_SSE2(const SkConicalSpanParams& params, const SkPMColor cache[], int toggle,
+                  SkPMColor dst[], int count) {
+    SkASSERT(0 != params.fA);
+
+    const __m128i toggles = dither_toggles(toggle);
+    const __m128i dontDrawT = _mm_set1_epi32((int)0x80000000);
+    float relX = params.fRelX;
+    float relY = params.fRelY;
+    float b = params.fB;
+    while (count > 0) {
+        __m128 x = float_steps(&relX, params.fIncX);
+        __m128 y = float_steps(&relY, params.fIncY);
+        __m128i t = conical_t(params, x, y, float_steps(&b, params.fDB));
+        __m128i draw = _mm_xor_si128(_mm_cmpeq_epi32(t, dontDrawT), _mm_set1_epi32(-1));
+
+        int n = count < 4 ? count : 4;
+        lookup_masked(_mm_add_epi32(tile_index<tileMode>(t), toggles), draw, cache, dst, n);
+        dst += 4;
+        count -= 4;
+    }
+}
+
+} // namespace
+
+SkLinearGradientSpanProc SkLinearGradientGetPlatformProc_SSE2(SkShader::TileMode tileMode) {
+    switch (tileMode) {
+        case SkShader::kClamp_TileMode:
+            return linear_SSE2<SkShader::kClamp_TileMode>;
+        case SkShader::kRepeat_TileMode:
+            return linear_SSE2<SkShader::kRepeat_TileMode>;
+        case SkShader::kMirror_TileMode:
+            return linear_SSE2<SkShader::kMirror_TileMode>;
+        default:
+            return NULL;
+    }
+}
+
+SkRadialGradientSpanProc SkRadialGradientGetPlatformProc_SSE2(SkShader::TileMode tileMode) {
+    switch (tileMode) {
+        case SkShader::kClamp_TileMode:
+            return radial_clamp_SSE2;
+        case SkShader::kRepeat_TileMode:
+            return radial_repeat_SSE2;
+#ifdef SK_SCALAR_IS_FLOAT
+        case SkShader::kMirror_TileMode:
+            return radial_mirror_SSE2;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+SkConicalGradientSpanProc SkConicalGradientGetPlatformProc_SSE2(SkShader::TileMode tileMode) {
+    switch (tileMode) {
+        case SkShader::kClamp_TileMode:
+            return conical_SSE2<SkShader::kClamp_TileMode>;
+        case SkShader::kRepeat_TileMode:
+            return conical_SSE2<SkShader::kRepeat_TileMode>;
+        case SkShader::kMirror_TileMode:
+            return conical_SSE2<SkShader::kMirror_TileMode>;
+        default:
+            return NULL;
+    }
+}
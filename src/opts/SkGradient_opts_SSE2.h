@@ -0,0 +1,17 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGradient_opts_SSE2_DEFINED
+#define SkGradient_opts_SSE2_DEFINED
+
+#include "SkGradient_opts.h"
+
+SkLinearGradientSpanProc SkLinearGradientGetPlatformProc_SSE2(SkShader::TileMode);
+SkRadialGradientSpanProc SkRadialGradientGetPlatformProc_SSE2(SkShader::TileMode);
+SkConicalGradientSpanProc SkConicalGradientGetPlatformProc_SSE2(SkShader::TileMode);
+
+#endif
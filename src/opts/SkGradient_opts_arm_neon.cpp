@@ -0,0 +1,137 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGradient_opts_arm_neon.h"
+
+#include <arm_neon.h>
+
+namespace {
+
+// SkGradientShaderBase::kDitherStride32
+const int kDitherStride = 256;
+
+// Four pixels are shaded at a time. Since that is an even number, every group of four
+// starts with the same dither row.
+inline int32x4_t dither_toggles(int toggle) {
+    const int32_t t[4] = { toggle, toggle ^ kDitherStride, toggle, toggle ^ kDitherStride };
+    return vld1q_s32(t);
+}
+
+// Return the 16.16 values fx, fx + dx, fx + 2 * dx, fx + 3 * dx, wrapping on overflow as
+// the portable code does.
+inline int32x4_t fixed_steps(SkFixed fx, SkFixed dx) {
+    uint32_t udx = dx;
+    const int32_t steps[4] = { 0, (int32_t)udx, (int32_t)(2 * udx), (int32_t)(3 * udx) };
+    return vaddq_s32(vdupq_n_s32(fx), vld1q_s32(steps));
+}
+
+// Write cache[index] for the first count (at most 4) lanes of index.
+inline void lookup(int32x4_t index, const SkPMColor cache[], SkPMColor dst[], int count) {
+    int32_t i[4];
+    vst1q_s32(i, index);
+    for (int k = 0; k < count; ++k) {
+        dst[k] = cache[i[k]];
+    }
+}
+
+// Map 16.16 values to an 8 bit table index, as the tile procs in SkGradientShaderPriv.h do.
+template <SkShader::TileMode tileMode>
+inline int32x4_t tile_index(int32x4_t fx) {
+    switch (tileMode) {
+        case SkShader::kClamp_TileMode:
+            return vmaxq_s32(vminq_s32(vshrq_n_s32(fx, 8), vdupq_n_s32(0xFF)), vdupq_n_s32(0));
+        case SkShader::kRepeat_TileMode:
+            return vandq_s32(vshrq_n_s32(fx, 8), vdupq_n_s32(0xFF));
+        case SkShader::kMirror_TileMode:
+        default: {
+            int32x4_t s = vshrq_n_s32(vshlq_n_s32(fx, 15), 31);
+            return vandq_s32(vshrq_n_s32(veorq_s32(fx, s), 8), vdupq_n_s32(0xFF));
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <SkShader::TileMode tileMode>
+void linear_NEON(SkFixed fx, SkFixed dx, const SkPMColor cache[], int toggle,
+                 SkPMColor dst[], int count) {
+    const int32x4_t toggles = dither_toggles(toggle);
+    const int32x4_t step = vdupq_n_s32((int32_t)((uint32_t)dx * 4));
+    int32x4_t x = fixed_steps(fx, dx);
+    for (; count >= 4; count -= 4) {
+        lookup(vaddq_s32(tile_index<tileMode>(x), toggles), cache, dst, 4);
+        x = vaddq_s32(x, step);
+        dst += 4;
+    }
+    if (count > 0) {
+        lookup(vaddq_s32(tile_index<tileMode>(x), toggles), cache, dst, count);
+    }
+}
+
+// Same precision as the portable code: 15 bit coordinates, pinned to [-0x8000, 0x7FFF] and
+// squared into an index of the 2048 entry square root table.
+void radial_clamp_NEON(SkScalar sfx, SkScalar sdx, SkScalar sfy, SkScalar sdy,
+                       const uint8_t sqrtTable[], const SkPMColor cache[], int toggle,
+                       SkPMColor dst[], int count) {
+    const SkFixed fx = SkScalarToFixed(sfx) >> 1;
+    const SkFixed dx = SkScalarToFixed(sdx) >> 1;
+    const SkFixed fy = SkScalarToFixed(sfy) >> 1;
+    const SkFixed dy = SkScalarToFixed(sdy) >> 1;
+
+    const int32x4_t toggles = dither_toggles(toggle);
+    const int32x4_t stepX = vdupq_n_s32((int32_t)((uint32_t)dx * 4));
+    const int32x4_t stepY = vdupq_n_s32((int32_t)((uint32_t)dy * 4));
+    int32x4_t x = fixed_steps(fx, dx);
+    int32x4_t y = fixed_steps(fy, dy);
+    while (count > 0) {
+        // Pin with a saturating narrow; the squares then fit in 32 bits unsigned.
+        int16x4_t xx = vqmovn_s32(x);
+        int16x4_t yy = vqmovn_s32(y);
+        uint32x4_t fi = vaddq_u32(vreinterpretq_u32_s32(vmull_s16(xx, xx)),
+                                  vreinterpretq_u32_s32(vmull_s16(yy, yy)));
+        fi = vminq_u32(vshrq_n_u32(fi, 14 + 16 - 11), vdupq_n_u32(0x7FF));
+
+        uint32_t i[4];
+        int32_t t[4];
+        vst1q_u32(i, fi);
+        vst1q_s32(t, toggles);
+        int n = count < 4 ? count : 4;
+        for (int k = 0; k < n; ++k) {
+            dst[k] = cache[t[k] + sqrtTable[i[k]]];
+        }
+
+        x = vaddq_s32(x, stepX);
+        y = vaddq_s32(y, stepY);
+        dst += 4;
+        count -= 4;
+    }
+}
+
+} // namespace
+
+SkLinearGradientSpanProc SkLinearGradientGetPlatformProc_NEON(SkShader::TileMode tileMode) {
+    switch (tileMode) {
+        case SkShader::kClamp_TileMode:
+            return linear_NEON<SkShader::kClamp_TileMode>;
+        case SkShader::kRepeat_TileMode:
+            return linear_NEON<SkShader::kRepeat_TileMode>;
+        case SkShader::kMirror_TileMode:
+            return linear_NEON<SkShader::kMirror_TileMode>;
+        default:
+            return NULL;
+    }
+}
+
+// NEON has no exact square root, which the other radial modes and the conical procs need to
+// match the portable code, so only the clamp mode (which uses a table) is sped up.
+SkRadialGradientSpanProc SkRadialGradientGetPlatformProc_NEON(SkShader::TileMode tileMode) {
+    return SkShader::kClamp_TileMode == tileMode ? radial_clamp_NEON : NULL;
+}
+
+SkConicalGradientSpanProc SkConicalGradientGetPlatformProc_NEON(SkShader::TileMode) {
+    return NULL;
+}
@@ -0,0 +1,17 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGradient_opts_arm_neon_DEFINED
+#define SkGradient_opts_arm_neon_DEFINED
+
+#include "SkGradient_opts.h"
+
+SkLinearGradientSpanProc SkLinearGradientGetPlatformProc_NEON(SkShader::TileMode);
+SkRadialGradientSpanProc SkRadialGradientGetPlatformProc_NEON(SkShader::TileMode);
+SkConicalGradientSpanProc SkConicalGradientGetPlatformProc_NEON(SkShader::TileMode);
+
+#endif
@@ -0,0 +1,22 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGradient_opts.h"
+
+// Platform impl of the gradient span procs with no overrides
+
+SkLinearGradientSpanProc SkLinearGradientGetPlatformProc(SkShader::TileMode) {
+    return NULL;
+}
+
+SkRadialGradientSpanProc SkRadialGradientGetPlatformProc(SkShader::TileMode) {
+    return NULL;
+}
+
+SkConicalGradientSpanProc SkConicalGradientGetPlatformProc(SkShader::TileMode) {
+    return NULL;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkLighting_opts_DEFINED
+#define SkLighting_opts_DEFINED
+
+#include "SkColorPriv.h"
+
+enum SkLightingLightType {
+    kDistant_SkLightingLightType,
+    kPoint_SkLightingLightType,
+    kSpot_SkLightingLightType
+};
+
+enum SkLightingType {
+    kDiffuse_SkLightingType,
+    kSpecular_SkLightingType
+};
+
+/**
+ *  The parameters of a lighting filter and its (already transformed) light, as floats.
+ */
+struct SkLightingParams {
+    float fSurfaceScale;            //!< the filter's surface scale, divided by 255
+    float fLight[3];                //!< direction of a distant light, or location of the others
+    float fColor[3];
+    float fK;                       //!< kd for diffuse lighting, ks for specular lighting
+    float fShininess;               //!< specular lighting only
+
+    // Spot lights only.
+    float fS[3];
+    float fSpecularExponent;
+    float fCosOuterConeAngle;
+    float fCosInnerConeAngle;
+    float fConeScale;
+};
+
+/**
+ *  Lights count pixels of row y, starting at column x. For pixel i, gradientX[i] and
+ *  gradientY[i] are the Sobel gradients of the alpha channel around it, and alpha[i] is its
+ *  alpha. The lit pixels are written to dst.
+ */
+typedef void (*SkLightingRowProc)(const SkLightingParams& params,
+                                  const float gradientX[], const float gradientY[],
+                                  const int alpha[], int x, int y, int count, SkPMColor dst[]);
+
+/**
+ *  Return a platform specific lighting proc, or NULL if the portable code should be used.
+ */
+SkLightingRowProc SkLightingGetPlatformProc(SkLightingLightType lightType,
+                                            SkLightingType lightingType);
+
+#endif
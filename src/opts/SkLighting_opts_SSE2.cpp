@@ -0,0 +1,194 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkLighting_opts_SSE2.h"
+#include "SkFloatingPoint.h"
+
+#include <emmintrin.h>
+
+namespace {
+
+// Four 3D vectors, one per lane. The operations below are done in the same order as the
+// scalar ones in SkPoint3, so that the results match the portable code.
+struct Vec3 {
+    __m128 fX, fY, fZ;
+};
+
+inline __m128 dot(const Vec3& a, const Vec3& b) {
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.fX, b.fX), _mm_mul_ps(a.fY, b.fY)),
+                      _mm_mul_ps(a.fZ, b.fZ));
+}
+
+inline void normalize(Vec3* v) {
+    __m128 scale = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(dot(*v, *v)));
+    v->fX = _mm_mul_ps(v->fX, scale);
+    v->fY = _mm_mul_ps(v->fY, scale);
+    v->fZ = _mm_mul_ps(v->fZ, scale);
+}
+
+inline __m128 negate(__m128 x) {
+    return _mm_xor_ps(x, _mm_set1_ps(-0.0f));
+}
+
+inline __m128 select(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// SkScalarClampMax(x, max), which also clamps to 0 from below.
+inline __m128 clamp_max(__m128 x, __m128 max) {
+    return _mm_max_ps(_mm_setzero_ps(), _mm_min_ps(max, x));
+}
+
+// There is no SSE2 pow, so take it one lane at a time.
+inline __m128 pow_lanes(__m128 base, float exp) {
+    float b[4];
+    _mm_storeu_ps(b, base);
+    for (int i = 0; i < 4; ++i) {
+        b[i] = sk_float_pow(b[i], exp);
+    }
+    return _mm_loadu_ps(b);
+}
+
+inline __m128i floor_to_int(__m128 x) {
+    __m128i truncated = _mm_cvttps_epi32(x);
+    // Truncation rounds negative values up, so subtract one from those.
+    __m128 greater = _mm_cmpgt_ps(_mm_cvtepi32_ps(truncated), x);
+    return _mm_add_epi32(truncated, _mm_castps_si128(greater));
+}
+
+inline __m128i pack_argb(__m128i a, __m128i r, __m128i g, __m128i b) {
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(a, SK_A32_SHIFT),
+                                     _mm_slli_epi32(r, SK_R32_SHIFT)),
+                        _mm_or_si128(_mm_slli_epi32(g, SK_G32_SHIFT),
+                                     _mm_slli_epi32(b, SK_B32_SHIFT)));
+}
+
+template <SkLightingLightType lightType, SkLightingType lightingType>
+inline __m128i light4(const SkLightingParams& params, __m128 gradientX, __m128 gradientY,
+                      __m128 z, __m128 x, __m128 y) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 surfaceScale = _mm_set1_ps(params.fSurfaceScale);
+
+    Vec3 normal = { _mm_mul_ps(negate(gradientX), surfaceScale),
+                    _mm_mul_ps(negate(gradientY), surfaceScale),
+                    one };
+    normalize(&normal);
+
+    Vec3 surfaceToLight;
+    if (kDistant_SkLightingLightType == lightType) {
+        surfaceToLight.fX = _mm_set1_ps(params.fLight[0]);
+        surfaceToLight.fY = _mm_set1_ps(params.fLight[1]);
+        surfaceToLight.fZ = _mm_set1_ps(params.fLight[2]);
+    } else {
+        surfaceToLight.fX = _mm_sub_ps(_mm_set1_ps(params.fLight[0]), x);
+        surfaceToLight.fY = _mm_sub_ps(_mm_set1_ps(params.fLight[1]), y);
+        surfaceToLight.fZ = _mm_sub_ps(_mm_set1_ps(params.fLight[2]),
+                                       _mm_mul_ps(z, surfaceScale));
+        normalize(&surfaceToLight);
+    }
+
+    Vec3 lightColor = { _mm_set1_ps(params.fColor[0]),
+                        _mm_set1_ps(params.fColor[1]),
+                        _mm_set1_ps(params.fColor[2]) };
+    if (kSpot_SkLightingLightType == lightType) {
+        Vec3 s = { _mm_set1_ps(params.fS[0]), _mm_set1_ps(params.fS[1]),
+                   _mm_set1_ps(params.fS[2]) };
+        __m128 cosAngle = negate(dot(surfaceToLight, s));
+        __m128 cosOuter = _mm_set1_ps(params.fCosOuterConeAngle);
+        __m128 scale = pow_lanes(cosAngle, params.fSpecularExponent);
+        __m128 edgeScale = _mm_mul_ps(_mm_mul_ps(scale, _mm_sub_ps(cosAngle, cosOuter)),
+                                      _mm_set1_ps(params.fConeScale));
+        scale = select(_mm_cmplt_ps(cosAngle, _mm_set1_ps(params.fCosInnerConeAngle)),
+                       edgeScale, scale);
+        scale = _mm_andnot_ps(_mm_cmplt_ps(cosAngle, cosOuter), scale);
+        lightColor.fX = _mm_mul_ps(lightColor.fX, scale);
+        lightColor.fY = _mm_mul_ps(lightColor.fY, scale);
+        lightColor.fZ = _mm_mul_ps(lightColor.fZ, scale);
+    }
+
+    __m128 colorScale;
+    if (kDiffuse_SkLightingType == lightingType) {
+        colorScale = _mm_mul_ps(_mm_set1_ps(params.fK), dot(normal, surfaceToLight));
+    } else {
+        Vec3 halfDir = surfaceToLight;
+        halfDir.fZ = _mm_add_ps(halfDir.fZ, one);   // eye position is always (0, 0, 1)
+        normalize(&halfDir);
+        colorScale = _mm_mul_ps(_mm_set1_ps(params.fK),
+                                pow_lanes(dot(normal, halfDir), params.fShininess));
+    }
+    colorScale = clamp_max(colorScale, one);
+
+    __m128 r = _mm_mul_ps(lightColor.fX, colorScale);
+    __m128 g = _mm_mul_ps(lightColor.fY, colorScale);
+    __m128 b = _mm_mul_ps(lightColor.fZ, colorScale);
+    __m128i a;
+    if (kDiffuse_SkLightingType == lightingType) {
+        a = _mm_set1_epi32(255);
+    } else {
+        // SkPoint3::maxComponent()
+        a = floor_to_int(select(_mm_cmpgt_ps(r, g), _mm_max_ps(r, b), _mm_max_ps(g, b)));
+    }
+    return pack_argb(a, floor_to_int(r), floor_to_int(g), floor_to_int(b));
+}
+
+template <SkLightingLightType lightType, SkLightingType lightingType>
+void light_row_SSE2(const SkLightingParams& params,
+                    const float gradientX[], const float gradientY[], const int alpha[],
+                    int x, int y, int count, SkPMColor dst[]) {
+    const __m128 four = _mm_set1_ps(4.0f);
+    const __m128 fy = _mm_set1_ps(static_cast<float>(y));
+    __m128 fx = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)),
+                           _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(alpha + i));
+        __m128 z = _mm_cvtepi32_ps(a);
+        __m128i result = light4<lightType, lightingType>(params, _mm_loadu_ps(gradientX + i),
+                                                          _mm_loadu_ps(gradientY + i),
+                                                          z, fx, fy);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+        fx = _mm_add_ps(fx, four);
+    }
+    if (i < count) {
+        float gx[4] = { 0, 0, 0, 0 };
+        float gy[4] = { 0, 0, 0, 0 };
+        int a[4] = { 0, 0, 0, 0 };
+        for (int j = 0; j < count - i; ++j) {
+            gx[j] = gradientX[i + j];
+            gy[j] = gradientY[i + j];
+            a[j] = alpha[i + j];
+        }
+        __m128 z = _mm_cvtepi32_ps(_mm_setr_epi32(a[0], a[1], a[2], a[3]));
+        __m128i result = light4<lightType, lightingType>(params, _mm_loadu_ps(gx),
+                                                          _mm_loadu_ps(gy), z, fx, fy);
+        SkPMColor c[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(c), result);
+        for (int j = 0; j < count - i; ++j) {
+            dst[i + j] = c[j];
+        }
+    }
+}
+
+} // namespace
+
+SkLightingRowProc SkLightingGetPlatformProc_SSE2(SkLightingLightType lightType,
+                                                 SkLightingType lightingType) {
+    bool diffuse = kDiffuse_SkLightingType == lightingType;
+    switch (lightType) {
+        case kDistant_SkLightingLightType:
+            return diffuse ? light_row_SSE2<kDistant_SkLightingLightType, kDiffuse_SkLightingType>
+                           : light_row_SSE2<kDistant_SkLightingLightType, kSpecular_SkLightingType>;
+        case kPoint_SkLightingLightType:
+            return diffuse ? light_row_SSE2<kPoint_SkLightingLightType, kDiffuse_SkLightingType>
+                           : light_row_SSE2<kPoint_SkLightingLightType, kSpecular_SkLightingType>;
+        case kSpot_SkLightingLightType:
+            return diffuse ? light_row_SSE2<kSpot_SkLightingLightType, kDiffuse_SkLightingType>
+                           : light_row_SSE2<kSpot_SkLightingLightType, kSpecular_SkLightingType>;
+        default:
+            return NULL;
+    }
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkLighting_opts_SSE2_DEFINED
+#define SkLighting_opts_SSE2_DEFINED
+
+#include "SkLighting_opts.h"
+
+SkLightingRowProc SkLightingGetPlatformProc_SSE2(SkLightingLightType lightType,
+                                                 SkLightingType lightingType);
+
+#endif
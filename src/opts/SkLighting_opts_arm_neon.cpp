@@ -0,0 +1,187 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkLighting_opts_arm_neon.h"
+#include "SkFloatingPoint.h"
+
+#include <arm_neon.h>
+
+namespace {
+
+// Four 3D vectors, one per lane.
+struct Vec3 {
+    float32x4_t fX, fY, fZ;
+};
+
+inline float32x4_t dot(const Vec3& a, const Vec3& b) {
+    return vaddq_f32(vaddq_f32(vmulq_f32(a.fX, b.fX), vmulq_f32(a.fY, b.fY)),
+                     vmulq_f32(a.fZ, b.fZ));
+}
+
+// NEON has no divide or square root, so refine the reciprocal square root estimate with two
+// Newton-Raphson steps. The results are within a unit of the portable code, not identical.
+inline void normalize(Vec3* v) {
+    float32x4_t lengthSquared = dot(*v, *v);
+    float32x4_t scale = vrsqrteq_f32(lengthSquared);
+    scale = vmulq_f32(scale, vrsqrtsq_f32(vmulq_f32(lengthSquared, scale), scale));
+    scale = vmulq_f32(scale, vrsqrtsq_f32(vmulq_f32(lengthSquared, scale), scale));
+    v->fX = vmulq_f32(v->fX, scale);
+    v->fY = vmulq_f32(v->fY, scale);
+    v->fZ = vmulq_f32(v->fZ, scale);
+}
+
+// SkScalarClampMax(x, max), which also clamps to 0 from below.
+inline float32x4_t clamp_max(float32x4_t x, float32x4_t max) {
+    return vmaxq_f32(vdupq_n_f32(0), vminq_f32(max, x));
+}
+
+// There is no NEON pow, so take it one lane at a time.
+inline float32x4_t pow_lanes(float32x4_t base, float exp) {
+    float b[4];
+    vst1q_f32(b, base);
+    for (int i = 0; i < 4; ++i) {
+        b[i] = sk_float_pow(b[i], exp);
+    }
+    return vld1q_f32(b);
+}
+
+inline uint32x4_t floor_to_int(float32x4_t x) {
+    int32x4_t truncated = vcvtq_s32_f32(x);
+    // Truncation rounds negative values up, so subtract one from those.
+    uint32x4_t greater = vcgtq_f32(vcvtq_f32_s32(truncated), x);
+    return vaddq_u32(vreinterpretq_u32_s32(truncated), greater);
+}
+
+inline uint32x4_t pack_argb(uint32x4_t a, uint32x4_t r, uint32x4_t g, uint32x4_t b) {
+    return vorrq_u32(vorrq_u32(vshlq_n_u32(a, SK_A32_SHIFT), vshlq_n_u32(r, SK_R32_SHIFT)),
+                     vorrq_u32(vshlq_n_u32(g, SK_G32_SHIFT), vshlq_n_u32(b, SK_B32_SHIFT)));
+}
+
+template <SkLightingLightType lightType, SkLightingType lightingType>
+inline uint32x4_t light4(const SkLightingParams& params, float32x4_t gradientX,
+                         float32x4_t gradientY, float32x4_t z, float32x4_t x, float32x4_t y) {
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t surfaceScale = vdupq_n_f32(params.fSurfaceScale);
+
+    Vec3 normal = { vmulq_f32(vnegq_f32(gradientX), surfaceScale),
+                    vmulq_f32(vnegq_f32(gradientY), surfaceScale),
+                    one };
+    normalize(&normal);
+
+    Vec3 surfaceToLight;
+    if (kDistant_SkLightingLightType == lightType) {
+        surfaceToLight.fX = vdupq_n_f32(params.fLight[0]);
+        surfaceToLight.fY = vdupq_n_f32(params.fLight[1]);
+        surfaceToLight.fZ = vdupq_n_f32(params.fLight[2]);
+    } else {
+        surfaceToLight.fX = vsubq_f32(vdupq_n_f32(params.fLight[0]), x);
+        surfaceToLight.fY = vsubq_f32(vdupq_n_f32(params.fLight[1]), y);
+        surfaceToLight.fZ = vsubq_f32(vdupq_n_f32(params.fLight[2]),
+                                      vmulq_f32(z, surfaceScale));
+        normalize(&surfaceToLight);
+    }
+
+    Vec3 lightColor = { vdupq_n_f32(params.fColor[0]),
+                        vdupq_n_f32(params.fColor[1]),
+                        vdupq_n_f32(params.fColor[2]) };
+    if (kSpot_SkLightingLightType == lightType) {
+        Vec3 s = { vdupq_n_f32(params.fS[0]), vdupq_n_f32(params.fS[1]),
+                   vdupq_n_f32(params.fS[2]) };
+        float32x4_t cosAngle = vnegq_f32(dot(surfaceToLight, s));
+        float32x4_t cosOuter = vdupq_n_f32(params.fCosOuterConeAngle);
+        float32x4_t scale = pow_lanes(cosAngle, params.fSpecularExponent);
+        float32x4_t edgeScale = vmulq_f32(vmulq_f32(scale, vsubq_f32(cosAngle, cosOuter)),
+                                          vdupq_n_f32(params.fConeScale));
+        scale = vbslq_f32(vcltq_f32(cosAngle, vdupq_n_f32(params.fCosInnerConeAngle)),
+                          edgeScale, scale);
+        scale = vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(scale),
+                                                vcltq_f32(cosAngle, cosOuter)));
+        lightColor.fX = vmulq_f32(lightColor.fX, scale);
+        lightColor.fY = vmulq_f32(lightColor.fY, scale);
+        lightColor.fZ = vmulq_f32(lightColor.fZ, scale);
+    }
+
+    float32x4_t colorScale;
+    if (kDiffuse_SkLightingType == lightingType) {
+        colorScale = vmulq_f32(vdupq_n_f32(params.fK), dot(normal, surfaceToLight));
+    } else {
+        Vec3 halfDir = surfaceToLight;
+        halfDir.fZ = vaddq_f32(halfDir.fZ, one);    // eye position is always (0, 0, 1)
+        normalize(&halfDir);
+        colorScale = vmulq_f32(vdupq_n_f32(params.fK),
+                               pow_lanes(dot(normal, halfDir), params.fShininess));
+    }
+    colorScale = clamp_max(colorScale, one);
+
+    float32x4_t r = vmulq_f32(lightColor.fX, colorScale);
+    float32x4_t g = vmulq_f32(lightColor.fY, colorScale);
+    float32x4_t b = vmulq_f32(lightColor.fZ, colorScale);
+    uint32x4_t a;
+    if (kDiffuse_SkLightingType == lightingType) {
+        a = vdupq_n_u32(255);
+    } else {
+        a = floor_to_int(vmaxq_f32(vmaxq_f32(r, g), b));
+    }
+    return pack_argb(a, floor_to_int(r), floor_to_int(g), floor_to_int(b));
+}
+
+template <SkLightingLightType lightType, SkLightingType lightingType>
+void light_row_NEON(const SkLightingParams& params,
+                    const float gradientX[], const float gradientY[], const int alpha[],
+                    int x, int y, int count, SkPMColor dst[]) {
+    static const float kLaneOffsets[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+    const float32x4_t four = vdupq_n_f32(4.0f);
+    const float32x4_t fy = vdupq_n_f32(static_cast<float>(y));
+    float32x4_t fx = vaddq_f32(vdupq_n_f32(static_cast<float>(x)), vld1q_f32(kLaneOffsets));
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t z = vcvtq_f32_s32(vld1q_s32(alpha + i));
+        uint32x4_t result = light4<lightType, lightingType>(params, vld1q_f32(gradientX + i),
+                                                             vld1q_f32(gradientY + i),
+                                                             z, fx, fy);
+        vst1q_u32(dst + i, result);
+        fx = vaddq_f32(fx, four);
+    }
+    if (i < count) {
+        float gx[4] = { 0, 0, 0, 0 };
+        float gy[4] = { 0, 0, 0, 0 };
+        int a[4] = { 0, 0, 0, 0 };
+        for (int j = 0; j < count - i; ++j) {
+            gx[j] = gradientX[i + j];
+            gy[j] = gradientY[i + j];
+            a[j] = alpha[i + j];
+        }
+        float32x4_t z = vcvtq_f32_s32(vld1q_s32(a));
+        uint32x4_t result = light4<lightType, lightingType>(params, vld1q_f32(gx),
+                                                             vld1q_f32(gy), z, fx, fy);
+        SkPMColor c[4];
+        vst1q_u32(c, result);
+        for (int j = 0; j < count - i; ++j) {
+            dst[i + j] = c[j];
+        }
+    }
+}
+
+} // namespace
+
+SkLightingRowProc SkLightingGetPlatformProc_NEON(SkLightingLightType lightType,
+                                                 SkLightingType lightingType) {
+    bool diffuse = kDiffuse_SkLightingType == lightingType;
+    switch (lightType) {
+        case kDistant_SkLightingLightType:
+            return diffuse ? light_row_NEON<kDistant_SkLightingLightType, kDiffuse_SkLightingType>
+                           : light_row_NEON<kDistant_SkLightingLightType, kSpecular_SkLightingType>;
+        case kPoint_SkLightingLightType:
+            return diffuse ? light_row_NEON<kPoint_SkLightingLightType, kDiffuse_SkLightingType>
+                           : light_row_NEON<kPoint_SkLightingLightType, kSpecular_SkLightingType>;
+        case kSpot_SkLightingLightType:
+            return diffuse ? light_row_NEON<kSpot_SkLightingLightType, kDiffuse_SkLightingType>
+                           : light_row_NEON<kSpot_SkLightingLightType, kSpecular_SkLightingType>;
+        default:
+            return NULL;
+    }
+}
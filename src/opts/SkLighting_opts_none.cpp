@@ -0,0 +1,14 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkLighting_opts.h"
+
+// Platform impl of the lighting procs with no overrides
+
+SkLightingRowProc SkLightingGetPlatformProc(SkLightingLightType, SkLightingType) {
+    return NULL;
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMatrixConvolution_opts_DEFINED
+#define SkMatrixConvolution_opts_DEFINED
+
+#include "SkColorPriv.h"
+
+/**
+ *  Convolves count pixels with a kernelWidth x kernelHeight kernel, in row order, without
+ *  bounds checks: the kernel window of dst[i] starts at src + i, and spans kernelHeight rows
+ *  of srcStride pixels. Each channel is floor(sum * gain + bias), clamped to [0, 255].
+ *
+ *  The procs that convolve alpha then clamp the color channels to alpha. The others set alpha
+ *  to 255, leaving the unpremultiplied colors to be premultiplied by the caller.
+ */
+typedef void (*SkMatrixConvolutionProc)(const SkPMColor* src, int srcStride,
+                                        const float kernel[], int kernelWidth, int kernelHeight,
+                                        float gain, float bias, SkPMColor dst[], int count);
+
+/**
+ *  Return a platform specific matrix convolution proc, or NULL if the portable code should be
+ *  used.
+ */
+SkMatrixConvolutionProc SkMatrixConvolutionGetPlatformProc(int kernelWidth, int kernelHeight,
+                                                           bool convolveAlpha);
+
+#endif
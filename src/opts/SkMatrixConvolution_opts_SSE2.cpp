@@ -0,0 +1,98 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMatrixConvolution_opts_SSE2.h"
+
+#include <emmintrin.h>
+
+namespace {
+
+// Each pixel is convolved in one register, a channel per lane, in the same order as the
+// portable code, so the results match it exactly.
+inline __m128 load_pixel(SkPMColor pixel) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i p = _mm_unpacklo_epi8(_mm_cvtsi32_si128(pixel), zero);
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(p, zero));
+}
+
+template <bool convolveAlpha>
+inline SkPMColor store_pixel(__m128 sum, __m128 gain, __m128 bias) {
+    __m128 c = _mm_add_ps(_mm_mul_ps(sum, gain), bias);
+    // Clamping before truncating gives the same result as clamping floor(c).
+    c = _mm_min_ps(_mm_max_ps(c, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+    __m128i ci;
+    if (convolveAlpha) {
+        const int kA = SK_A32_SHIFT / 8;
+        __m128 a = _mm_cvtepi32_ps(_mm_cvttps_epi32(c));
+        a = _mm_shuffle_ps(a, a, _MM_SHUFFLE(kA, kA, kA, kA));
+        ci = _mm_cvttps_epi32(_mm_min_ps(c, a));
+    } else {
+        ci = _mm_cvttps_epi32(c);
+    }
+    ci = _mm_packs_epi32(ci, ci);
+    ci = _mm_packus_epi16(ci, ci);
+    SkPMColor result = _mm_cvtsi128_si32(ci);
+    return convolveAlpha ? result : result | (0xFFu << SK_A32_SHIFT);
+}
+
+template <int kernelWidth, int kernelHeight, bool convolveAlpha>
+void convolve_fixed_SSE2(const SkPMColor* src, int srcStride,
+                         const float kernel[], int, int,
+                         float gain, float bias, SkPMColor dst[], int count) {
+    __m128 k[kernelWidth * kernelHeight];
+    for (int i = 0; i < kernelWidth * kernelHeight; ++i) {
+        k[i] = _mm_set1_ps(kernel[i]);
+    }
+    const __m128 g = _mm_set1_ps(gain);
+    const __m128 b = _mm_set1_ps(bias);
+    for (int x = 0; x < count; ++x) {
+        __m128 sum = _mm_setzero_ps();
+        const SkPMColor* row = src + x;
+        for (int cy = 0; cy < kernelHeight; ++cy) {
+            for (int cx = 0; cx < kernelWidth; ++cx) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(load_pixel(row[cx]),
+                                                 k[cy * kernelWidth + cx]));
+            }
+            row += srcStride;
+        }
+        dst[x] = store_pixel<convolveAlpha>(sum, g, b);
+    }
+}
+
+template <bool convolveAlpha>
+void convolve_SSE2(const SkPMColor* src, int srcStride,
+                   const float kernel[], int kernelWidth, int kernelHeight,
+                   float gain, float bias, SkPMColor dst[], int count) {
+    const __m128 g = _mm_set1_ps(gain);
+    const __m128 b = _mm_set1_ps(bias);
+    for (int x = 0; x < count; ++x) {
+        __m128 sum = _mm_setzero_ps();
+        const SkPMColor* row = src + x;
+        const float* k = kernel;
+        for (int cy = 0; cy < kernelHeight; ++cy) {
+            for (int cx = 0; cx < kernelWidth; ++cx) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(load_pixel(row[cx]), _mm_set1_ps(*k++)));
+            }
+            row += srcStride;
+        }
+        dst[x] = store_pixel<convolveAlpha>(sum, g, b);
+    }
+}
+
+} // namespace
+
+SkMatrixConvolutionProc SkMatrixConvolutionGetPlatformProc_SSE2(int kernelWidth,
+                                                                int kernelHeight,
+                                                                bool convolveAlpha) {
+    if (3 == kernelWidth && 3 == kernelHeight) {
+        return convolveAlpha ? convolve_fixed_SSE2<3, 3, true> : convolve_fixed_SSE2<3, 3, false>;
+    }
+    if (5 == kernelWidth && 5 == kernelHeight) {
+        return convolveAlpha ? convolve_fixed_SSE2<5, 5, true> : convolve_fixed_SSE2<5, 5, false>;
+    }
+    return convolveAlpha ? convolve_SSE2<true> : convolve_SSE2<false>;
+}
@@ -0,0 +1,17 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMatrixConvolution_opts_SSE2_DEFINED
+#define SkMatrixConvolution_opts_SSE2_DEFINED
+
+#include "SkMatrixConvolution_opts.h"
+
+SkMatrixConvolutionProc SkMatrixConvolutionGetPlatformProc_SSE2(int kernelWidth,
+                                                                int kernelHeight,
+                                                                bool convolveAlpha);
+
+#endif
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMatrixConvolution_opts_arm_neon.h"
+
+#include <arm_neon.h>
+
+namespace {
+
+// Each pixel is convolved in one register, a channel per lane.
+inline float32x4_t load_pixel(SkPMColor pixel) {
+    uint8x8_t p = vreinterpret_u8_u32(vdup_n_u32(pixel));
+    return vcvtq_f32_u32(vmovl_u16(vget_low_u16(vmovl_u8(p))));
+}
+
+template <bool convolveAlpha>
+inline SkPMColor store_pixel(float32x4_t sum, float32x4_t gain, float32x4_t bias) {
+    float32x4_t c = vaddq_f32(vmulq_f32(sum, gain), bias);
+    // Clamping before truncating gives the same result as clamping floor(c).
+    c = vminq_f32(vmaxq_f32(c, vdupq_n_f32(0)), vdupq_n_f32(255.0f));
+    if (convolveAlpha) {
+        const int kA = SK_A32_SHIFT / 8;
+        float32x4_t a = vcvtq_f32_u32(vcvtq_u32_f32(c));
+        c = vminq_f32(c, vdupq_n_f32(vgetq_lane_f32(a, kA)));
+    }
+    uint16x4_t c16 = vmovn_u32(vcvtq_u32_f32(c));
+    uint8x8_t c8 = vmovn_u16(vcombine_u16(c16, c16));
+    SkPMColor result = vget_lane_u32(vreinterpret_u32_u8(c8), 0);
+    return convolveAlpha ? result : result | (0xFFu << SK_A32_SHIFT);
+}
+
+template <int kernelWidth, int kernelHeight, bool convolveAlpha>
+void convolve_fixed_NEON(const SkPMColor* src, int srcStride,
+                         const float kernel[], int, int,
+                         float gain, float bias, SkPMColor dst[], int count) {
+    float32x4_t k[kernelWidth * kernelHeight];
+    for (int i = 0; i < kernelWidth * kernelHeight; ++i) {
+        k[i] = vdupq_n_f32(kernel[i]);
+    }
+    const float32x4_t g = vdupq_n_f32(gain);
+    const float32x4_t b = vdupq_n_f32(bias);
+    for (int x = 0; x < count; ++x) {
+        float32x4_t sum = vdupq_n_f32(0);
+        const SkPMColor* row = src + x;
+        for (int cy = 0; cy < kernelHeight; ++cy) {
+            for (int cx = 0; cx < kernelWidth; ++cx) {
+                sum = vaddq_f32(sum, vmulq_f32(load_pixel(row[cx]), k[cy * kernelWidth + cx]));
+            }
+            row += srcStride;
+        }
+        dst[x] = store_pixel<convolveAlpha>(sum, g, b);
+    }
+}
+
+template <bool convolveAlpha>
+void convolve_NEON(const SkPMColor* src, int srcStride,
+                   const float kernel[], int kernelWidth, int kernelHeight,
+                   float gain, float bias, SkPMColor dst[], int count) {
+    const float32x4_t g = vdupq_n_f32(gain);
+    const float32x4_t b = vdupq_n_f32(bias);
+    for (int x = 0; x < count; ++x) {
+        float32x4_t sum = vdupq_n_f32(0);
+        const SkPMColor* row = src + x;
+        const float* k = kernel;
+        for (int cy = 0; cy < kernelHeight; ++cy) {
+            for (int cx = 0; cx < kernelWidth; ++cx) {
+                sum = vaddq_f32(sum, vmulq_n_f32(load_pixel(row[cx]), *k++));
+            }
+            row += srcStride;
+        }
+        dst[x] = store_pixel<convolveAlpha>(sum, g, b);
+    }
+}
+
+} // namespace
+
+SkMatrixConvolutionProc SkMatrixConvolutionGetPlatformProc_NEON(int kernelWidth,
+                                                                int kernelHeight,
+                                                                bool convolveAlpha) {
+    if (3 == kernelWidth && 3 == kernelHeight) {
+        return convolveAlpha ? convolve_fixed_NEON<3, 3, true> : convolve_fixed_NEON<3, 3, false>;
+    }
+    if (5 == kernelWidth && 5 == kernelHeight) {
+        return convolveAlpha ? convolve_fixed_NEON<5, 5, true> : convolve_fixed_NEON<5, 5, false>;
+    }
+    return convolveAlpha ? convolve_NEON<true> : convolve_NEON<false>;
+}
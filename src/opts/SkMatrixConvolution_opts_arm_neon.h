@@ -0,0 +1,16 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkMatrixConvolution_opts_arm_neon_DEFINED
+#define SkMatrixConvolution_opts_arm_neon_DEFINED
+
+#include "SkMatrixConvolution_opts.h"
+
+SkMatrixConvolutionProc SkMatrixConvolutionGetPlatformProc_NEON(int kernelWidth,
+                                                                int kernelHeight,
+                                                                bool convolveAlpha);
+
+#endif
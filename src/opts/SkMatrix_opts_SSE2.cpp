@@ -0,0 +1,234 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <emmintrin.h>
+#include "SkMatrix_opts_SSE2.h"
+
+namespace {
+
+enum MatrixKind {
+    kIdentity_MatrixKind,
+    kTrans_MatrixKind,
+    kScale_MatrixKind,
+    kScaleTrans_MatrixKind,
+    kAffine_MatrixKind,
+    kAffineTrans_MatrixKind,
+    kPersp_MatrixKind
+};
+
+// The matrix, with each value in all four lanes, and the scale and translate
+// values also interleaved as (x, y, x, y) for the kinds that don't mix x and y.
+struct Splats {
+    __m128  fScaleX, fSkewX, fTransX;
+    __m128  fSkewY, fScaleY, fTransY;
+    __m128  fPersp0, fPersp1, fPersp2;
+    __m128  fScaleXY, fTransXY;
+
+    explicit Splats(const SkMatrix& m) {
+        fScaleX = _mm_set1_ps(m[SkMatrix::kMScaleX]);
+        fSkewX  = _mm_set1_ps(m[SkMatrix::kMSkewX]);
+        fTransX = _mm_set1_ps(m[SkMatrix::kMTransX]);
+        fSkewY  = _mm_set1_ps(m[SkMatrix::kMSkewY]);
+        fScaleY = _mm_set1_ps(m[SkMatrix::kMScaleY]);
+        fTransY = _mm_set1_ps(m[SkMatrix::kMTransY]);
+        fPersp0 = _mm_set1_ps(m[SkMatrix::kMPersp0]);
+        fPersp1 = _mm_set1_ps(m[SkMatrix::kMPersp1]);
+        fPersp2 = _mm_set1_ps(m[SkMatrix::kMPersp2]);
+        fScaleXY = _mm_setr_ps(m[SkMatrix::kMScaleX], m[SkMatrix::kMScaleY],
+                               m[SkMatrix::kMScaleX], m[SkMatrix::kMScaleY]);
+        fTransXY = _mm_setr_ps(m[SkMatrix::kMTransX], m[SkMatrix::kMTransY],
+                               m[SkMatrix::kMTransX], m[SkMatrix::kMTransY]);
+    }
+};
+
+// Map the four points at src to (x0, y0, x1, y1) and (x2, y2, x3, y3), with the
+// operations of the portable procs in SkMatrix.cpp, in the same order, so that
+// the results are identical.
+template <MatrixKind kind>
+inline void map4(const Splats& m, const SkPoint src[4], __m128* lo, __m128* hi) {
+    const float* s = &src[0].fX;
+    __m128 p01 = _mm_loadu_ps(s);
+    __m128 p23 = _mm_loadu_ps(s + 4);
+
+    switch (kind) {
+        case kIdentity_MatrixKind:
+            *lo = p01;
+            *hi = p23;
+            return;
+        case kTrans_MatrixKind:
+            *lo = _mm_add_ps(p01, m.fTransXY);
+            *hi = _mm_add_ps(p23, m.fTransXY);
+            return;
+        case kScale_MatrixKind:
+            *lo = _mm_mul_ps(p01, m.fScaleXY);
+            *hi = _mm_mul_ps(p23, m.fScaleXY);
+            return;
+        case kScaleTrans_MatrixKind:
+            *lo = _mm_add_ps(_mm_mul_ps(p01, m.fScaleXY), m.fTransXY);
+            *hi = _mm_add_ps(_mm_mul_ps(p23, m.fScaleXY), m.fTransXY);
+            return;
+        default:
+            break;
+    }
+
+    // The other kinds mix x and y, so split the points into xs and ys.
+    __m128 x = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 y = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(3, 1, 3, 1));
+    __m128 dx, dy;
+    if (kAffine_MatrixKind == kind) {
+        dx = _mm_add_ps(_mm_mul_ps(x, m.fScaleX), _mm_mul_ps(y, m.fSkewX));
+        dy = _mm_add_ps(_mm_mul_ps(x, m.fSkewY), _mm_mul_ps(y, m.fScaleY));
+    } else if (kAffineTrans_MatrixKind == kind) {
+        dx = _mm_add_ps(_mm_mul_ps(x, m.fScaleX),
+                        _mm_add_ps(_mm_mul_ps(y, m.fSkewX), m.fTransX));
+        dy = _mm_add_ps(_mm_mul_ps(x, m.fSkewY),
+                        _mm_add_ps(_mm_mul_ps(y, m.fScaleY), m.fTransY));
+    } else {
+        dx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m.fScaleX), _mm_mul_ps(y, m.fSkewX)),
+                        m.fTransX);
+        dy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m.fSkewY), _mm_mul_ps(y, m.fScaleY)),
+                        m.fTransY);
+        __m128 z = _mm_add_ps(_mm_mul_ps(x, m.fPersp0),
+                              _mm_add_ps(_mm_mul_ps(y, m.fPersp1), m.fPersp2));
+        // if (z) { z = 1 / z; }
+        __m128 nonZero = _mm_cmpneq_ps(z, _mm_setzero_ps());
+        z = _mm_or_ps(_mm_and_ps(nonZero, _mm_div_ps(_mm_set1_ps(SK_Scalar1), z)),
+                      _mm_andnot_ps(nonZero, z));
+        dx = _mm_mul_ps(dx, z);
+        dy = _mm_mul_ps(dy, z);
+    }
+    *lo = _mm_unpacklo_ps(dx, dy);
+    *hi = _mm_unpackhi_ps(dx, dy);
+}
+
+template <MatrixKind kind>
+void map_pts_SSE2(const SkMatrix& matrix, SkPoint dst[], const SkPoint src[], int count) {
+    const Splats m(matrix);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 lo, hi;
+        map4<kind>(m, &src[i], &lo, &hi);
+        _mm_storeu_ps(&dst[i].fX, lo);
+        _mm_storeu_ps(&dst[i].fX + 4, hi);
+    }
+    if (i < count) {
+        matrix.getMapPtsProc()(matrix, &dst[i], &src[i], count - i);
+    }
+}
+
+// Map the points, and find their bounds as SkRect::setBoundsCheck() does: the
+// points are multiplied into accum, which stays zero unless one of them is
+// infinite or NaN.
+template <MatrixKind kind>
+bool map_pts_bounds_SSE2(const SkMatrix& matrix, SkPoint dst[], const SkPoint src[],
+                         int count, SkRect* bounds) {
+    SkASSERT(count >= 4);
+    const Splats m(matrix);
+
+    __m128 lo, hi;
+    map4<kind>(m, src, &lo, &hi);
+    _mm_storeu_ps(&dst[0].fX, lo);
+    _mm_storeu_ps(&dst[0].fX + 4, hi);
+    __m128 min = _mm_min_ps(lo, hi);
+    __m128 max = _mm_max_ps(lo, hi);
+    __m128 accum = _mm_mul_ps(_mm_mul_ps(_mm_setzero_ps(), lo), hi);
+
+    int i = 4;
+    for (; i + 4 <= count; i += 4) {
+        map4<kind>(m, &src[i], &lo, &hi);
+        _mm_storeu_ps(&dst[i].fX, lo);
+        _mm_storeu_ps(&dst[i].fX + 4, hi);
+        min = _mm_min_ps(min, _mm_min_ps(lo, hi));
+        max = _mm_max_ps(max, _mm_max_ps(lo, hi));
+        accum = _mm_mul_ps(_mm_mul_ps(accum, lo), hi);
+    }
+    if (i < count) {
+        matrix.getMapPtsProc()(matrix, &dst[i], &src[i], count - i);
+        for (; i < count; ++i) {
+            __m128 pt = _mm_setr_ps(dst[i].fX, dst[i].fY, dst[i].fX, dst[i].fY);
+            min = _mm_min_ps(min, pt);
+            max = _mm_max_ps(max, pt);
+            accum = _mm_mul_ps(accum, pt);
+        }
+    }
+
+    if (_mm_movemask_ps(_mm_cmpneq_ps(accum, accum))) {
+        bounds->setEmpty();
+        return false;
+    }
+
+    // (x, y, x, y) -> (x, y)
+    min = _mm_min_ps(min, _mm_movehl_ps(min, min));
+    max = _mm_max_ps(max, _mm_movehl_ps(max, max));
+    float ltrb[4];
+    _mm_storeu_ps(ltrb, _mm_movelh_ps(min, max));
+    bounds->set(ltrb[0], ltrb[1], ltrb[2], ltrb[3]);
+    return true;
+}
+
+MatrixKind matrix_kind(SkMatrix::TypeMask mask) {
+    if (mask & SkMatrix::kPerspective_Mask) {
+        return kPersp_MatrixKind;
+    }
+    if (mask & SkMatrix::kAffine_Mask) {
+        return (mask & SkMatrix::kTranslate_Mask) ? kAffineTrans_MatrixKind
+                                                  : kAffine_MatrixKind;
+    }
+    switch ((unsigned)mask) {
+        case SkMatrix::kTranslate_Mask:
+            return kTrans_MatrixKind;
+        case SkMatrix::kScale_Mask:
+            return kScale_MatrixKind;
+        case SkMatrix::kScale_Mask | SkMatrix::kTranslate_Mask:
+            return kScaleTrans_MatrixKind;
+        default:
+            return kIdentity_MatrixKind;
+    }
+}
+
+} // namespace
+
+SkMatrix::MapPtsProc SkMatrix_PlatformMapPtsProc_SSE2(SkMatrix::TypeMask mask) {
+    switch (matrix_kind(mask)) {
+        case kTrans_MatrixKind:
+            return map_pts_SSE2<kTrans_MatrixKind>;
+        case kScale_MatrixKind:
+            return map_pts_SSE2<kScale_MatrixKind>;
+        case kScaleTrans_MatrixKind:
+            return map_pts_SSE2<kScaleTrans_MatrixKind>;
+        case kAffine_MatrixKind:
+            return map_pts_SSE2<kAffine_MatrixKind>;
+        case kAffineTrans_MatrixKind:
+            return map_pts_SSE2<kAffineTrans_MatrixKind>;
+        case kPersp_MatrixKind:
+            return map_pts_SSE2<kPersp_MatrixKind>;
+        default:
+            // the portable identity proc is a memcpy
+            return NULL;
+    }
+}
+
+SkMatrix::MapPtsBoundsProc SkMatrix_PlatformMapPtsBoundsProc_SSE2(SkMatrix::TypeMask mask) {
+    switch (matrix_kind(mask)) {
+        case kIdentity_MatrixKind:
+            return map_pts_bounds_SSE2<kIdentity_MatrixKind>;
+        case kTrans_MatrixKind:
+            return map_pts_bounds_SSE2<kTrans_MatrixKind>;
+        case kScale_MatrixKind:
+            return map_pts_bounds_SSE2<kScale_MatrixKind>;
+        case kScaleTrans_MatrixKind:
+            return map_pts_bounds_SSE2<kScaleTrans_MatrixKind>;
+        case kAffine_MatrixKind:
+            return map_pts_bounds_SSE2<kAffine_MatrixKind>;
+        case kAffineTrans_MatrixKind:
+            return map_pts_bounds_SSE2<kAffineTrans_MatrixKind>;
+        case kPersp_MatrixKind:
+            return map_pts_bounds_SSE2<kPersp_MatrixKind>;
+    }
+    return NULL;
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMatrix_opts_SSE2_DEFINED
+#define SkMatrix_opts_SSE2_DEFINED
+
+#include "SkMatrix.h"
+
+SkMatrix::MapPtsProc SkMatrix_PlatformMapPtsProc_SSE2(SkMatrix::TypeMask);
+SkMatrix::MapPtsBoundsProc SkMatrix_PlatformMapPtsBoundsProc_SSE2(SkMatrix::TypeMask);
+
+#endif
@@ -0,0 +1,18 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMatrix.h"
+
+// Platform impl of the matrix point mapping procs with no overrides
+
+SkMatrix::MapPtsProc SkMatrix::PlatformMapPtsProc(TypeMask) {
+    return NULL;
+}
+
+SkMatrix::MapPtsBoundsProc SkMatrix::PlatformMapPtsBoundsProc(TypeMask) {
+    return NULL;
+}
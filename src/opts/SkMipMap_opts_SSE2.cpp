@@ -0,0 +1,76 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <emmintrin.h>
+#include "SkMipMap_opts_SSE2.h"
+#include "SkColorPriv.h"
+
+namespace {
+
+// Sum the 2x2 blocks made of pixels 0, 1 and 2, 3 of rows a and b. The
+// 16-bit sums of their even bytes are returned in the low half of even, and
+// those of their odd bytes in the low half of odd.
+inline void sum_pairs(__m128i a, __m128i b, __m128i* even, __m128i* odd) {
+    const __m128i mask = _mm_set1_epi16(0x00FF);
+
+    // Add the rows, then each odd pixel to the even one before it.
+    __m128i e = _mm_add_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+    __m128i o = _mm_add_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+    e = _mm_add_epi16(e, _mm_srli_epi64(e, 32));
+    o = _mm_add_epi16(o, _mm_srli_epi64(o, 32));
+
+    // The sums are in 32-bit lanes 0 and 2; move them to 0 and 1.
+    *even = _mm_shuffle_epi32(e, _MM_SHUFFLE(3, 1, 2, 0));
+    *odd = _mm_shuffle_epi32(o, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+void downsample_row32_SSE2(void* dst, const void* src0, const void* src1,
+                           int count) {
+    SkPMColor* d = (SkPMColor*)dst;
+    const SkPMColor* p0 = (const SkPMColor*)src0;
+    const SkPMColor* p1 = (const SkPMColor*)src1;
+
+    // Four destination pixels at a time, from eight pixels of each row. The
+    // sums of four bytes fit easily in 16 bits, so the results are exact.
+    for (; count >= 4; count -= 4) {
+        __m128i lo0 = _mm_loadu_si128((const __m128i*)p0);
+        __m128i hi0 = _mm_loadu_si128((const __m128i*)(p0 + 4));
+        __m128i lo1 = _mm_loadu_si128((const __m128i*)p1);
+        __m128i hi1 = _mm_loadu_si128((const __m128i*)(p1 + 4));
+
+        __m128i evenLo, oddLo, evenHi, oddHi;
+        sum_pairs(lo0, lo1, &evenLo, &oddLo);
+        sum_pairs(hi0, hi1, &evenHi, &oddHi);
+
+        __m128i even = _mm_srli_epi16(_mm_unpacklo_epi64(evenLo, evenHi), 2);
+        __m128i odd = _mm_srli_epi16(_mm_unpacklo_epi64(oddLo, oddHi), 2);
+        _mm_storeu_si128((__m128i*)d, _mm_or_si128(even, _mm_slli_epi16(odd, 8)));
+
+        p0 += 8;
+        p1 += 8;
+        d += 4;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        SkPMColor c, ag, rb;
+
+        c = p0[0]; ag = (c >> 8) & 0xFF00FF; rb = c & 0xFF00FF;
+        c = p0[1]; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+        c = p1[0]; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+        c = p1[1]; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+
+        d[i] = ((rb >> 2) & 0xFF00FF) | ((ag << 6) & 0xFF00FF00);
+        p0 += 2;
+        p1 += 2;
+    }
+}
+
+} // namespace
+
+SkMipMap::DownsampleProc SkMipMap_PlatformDownsampleProc_SSE2(SkBitmap::Config config) {
+    return SkBitmap::kARGB_8888_Config == config ? downsample_row32_SSE2 : NULL;
+}
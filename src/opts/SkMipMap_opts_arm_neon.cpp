@@ -0,0 +1,64 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMipMap_opts_arm_neon.h"
+#include "SkColorPriv.h"
+
+#include <arm_neon.h>
+
+namespace {
+
+void downsample_row32_NEON(void* dst, const void* src0, const void* src1,
+                           int count) {
+    SkPMColor* d = (SkPMColor*)dst;
+    const SkPMColor* p0 = (const SkPMColor*)src0;
+    const SkPMColor* p1 = (const SkPMColor*)src1;
+
+    // Four destination pixels at a time. vld2 splits eight pixels of a row
+    // into the even and odd ones, so the four pixels of each 2x2 block are
+    // in the same lane of the four vectors.
+    for (; count >= 4; count -= 4) {
+        uint32x4x2_t r0 = vld2q_u32(p0);
+        uint32x4x2_t r1 = vld2q_u32(p1);
+        uint8x16_t e0 = vreinterpretq_u8_u32(r0.val[0]);
+        uint8x16_t o0 = vreinterpretq_u8_u32(r0.val[1]);
+        uint8x16_t e1 = vreinterpretq_u8_u32(r1.val[0]);
+        uint8x16_t o1 = vreinterpretq_u8_u32(r1.val[1]);
+
+        uint16x8_t sumLo = vaddq_u16(vaddl_u8(vget_low_u8(e0), vget_low_u8(o0)),
+                                     vaddl_u8(vget_low_u8(e1), vget_low_u8(o1)));
+        uint16x8_t sumHi = vaddq_u16(vaddl_u8(vget_high_u8(e0), vget_high_u8(o0)),
+                                     vaddl_u8(vget_high_u8(e1), vget_high_u8(o1)));
+
+        // Truncate, as the portable code does.
+        uint8x16_t avg = vcombine_u8(vshrn_n_u16(sumLo, 2), vshrn_n_u16(sumHi, 2));
+        vst1q_u32(d, vreinterpretq_u32_u8(avg));
+
+        p0 += 8;
+        p1 += 8;
+        d += 4;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        SkPMColor c, ag, rb;
+
+        c = p0[0]; ag = (c >> 8) & 0xFF00FF; rb = c & 0xFF00FF;
+        c = p0[1]; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+        c = p1[0]; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+        c = p1[1]; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+
+        d[i] = ((rb >> 2) & 0xFF00FF) | ((ag << 6) & 0xFF00FF00);
+        p0 += 2;
+        p1 += 2;
+    }
+}
+
+} // namespace
+
+SkMipMap::DownsampleProc SkMipMap_PlatformDownsampleProc_NEON(SkBitmap::Config config) {
+    return SkBitmap::kARGB_8888_Config == config ? downsample_row32_NEON : NULL;
+}
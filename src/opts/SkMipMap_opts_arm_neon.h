@@ -0,0 +1,15 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMipMap_opts_arm_neon_DEFINED
+#define SkMipMap_opts_arm_neon_DEFINED
+
+#include "SkMipMap.h"
+
+SkMipMap::DownsampleProc SkMipMap_PlatformDownsampleProc_NEON(SkBitmap::Config);
+
+#endif
@@ -0,0 +1,14 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMipMap.h"
+
+// Platform impl of the mipmap downsample proc with no overrides
+
+SkMipMap::DownsampleProc SkMipMap::PlatformDownsampleProc(SkBitmap::Config) {
+    return NULL;
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMorphology_opts_DEFINED
+#define SkMorphology_opts_DEFINED
+
+#include "SkColorPriv.h"
+
+enum SkMorphologyProcType {
+    kDilateX_SkMorphologyProcType,
+    kDilateY_SkMorphologyProcType,
+    kErodeX_SkMorphologyProcType,
+    kErodeY_SkMorphologyProcType
+};
+
+/**
+ *  Dilates (per channel maximum) or erodes (per channel minimum) height lines of width pixels,
+ *  over a window of radius pixels on either side, clamped to the line. Pixel i of line j is at
+ *  src[i * srcStrideX + j * srcStrideY], and likewise for dst. The X procs expect lines along
+ *  rows (srcStrideX == 1), the Y procs lines along columns (srcStrideY == 1).
+ */
+typedef void (*SkMorphologyProc)(const SkPMColor* src, SkPMColor* dst, int radius,
+                                 int width, int height, int srcStrideX, int srcStrideY,
+                                 int dstStrideX, int dstStrideY);
+
+/**
+ *  Return a platform specific morphology proc, or NULL if the portable code should be used.
+ */
+SkMorphologyProc SkMorphologyGetPlatformProc(SkMorphologyProcType type);
+
+#endif
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMorphology_opts_SSE2.h"
+#include "SkTemplates.h"
+
+#include <emmintrin.h>
+
+namespace {
+
+enum MorphType {
+    kErode,
+    kDilate
+};
+
+enum MorphDirection {
+    kX,
+    kY
+};
+
+template<MorphType type>
+inline __m128i morph_op(__m128i a, __m128i b) {
+    return kDilate == type ? _mm_max_epu8(a, b) : _mm_min_epu8(a, b);
+}
+
+// Loads pixel i of count (at most 4) adjacent lines into one register, one line per lane.
+inline __m128i load_lanes(const SkPMColor* p, int stride, int count) {
+    if (1 == stride && 4 == count) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+    SkPMColor c[4] = { 0, 0, 0, 0 };
+    for (int j = 0; j < count; ++j) {
+        c[j] = p[j * stride];
+    }
+    return _mm_setr_epi32(c[0], c[1], c[2], c[3]);
+}
+
+inline void store_lanes(SkPMColor* p, int stride, int count, __m128i v) {
+    if (1 == stride && 4 == count) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+        return;
+    }
+    SkPMColor c[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(c), v);
+    for (int j = 0; j < count; ++j) {
+        p[j * stride] = c[j];
+    }
+}
+
+/*
+ *  The van Herk/Gil-Werman pass of SkMorphologyImageFilter.cpp, with each register holding one
+ *  pixel of four lines. Lines along rows are gathered four at a time; lines along columns are
+ *  taken sixteen at a time, so that each row of the window is one 64 byte run.
+ *  g and h hold vecs registers per padded position.
+ */
+template<MorphType type>
+void morph_lanes(const SkPMColor* src, SkPMColor* dst, int radius, int width, int lanes,
+                 int srcStrideX, int srcStrideY, int dstStrideX, int dstStrideY,
+                 int vecs, __m128i* g, __m128i* h) {
+    const __m128i identity = kDilate == type ? _mm_setzero_si128() : _mm_set1_epi32(-1);
+    const int window = 2 * radius + 1;
+    const int n = width + 2 * radius;
+
+    int counts[4];
+    for (int v = 0; v < vecs; ++v) {
+        counts[v] = SkMax32(0, SkMin32(4, lanes - 4 * v));
+    }
+
+    int pos = 0;
+    for (int i = 0; i < n; ++i) {
+        __m128i* gi = g + i * vecs;
+        bool inside = i >= radius && i < radius + width;
+        const SkPMColor* p = src + (i - radius) * srcStrideX;
+        for (int v = 0; v < vecs; ++v) {
+            __m128i e = inside ? load_lanes(p + 4 * v * srcStrideY, srcStrideY, counts[v])
+                               : identity;
+            gi[v] = 0 == pos ? e : morph_op<type>(gi[v - vecs], e);
+        }
+        if (++pos == window) {
+            pos = 0;
+        }
+    }
+
+    pos = (n - 1) % window;
+    for (int i = n - 1; i >= 0; --i) {
+        __m128i* hi = h + i * vecs;
+        bool inside = i >= radius && i < radius + width;
+        const SkPMColor* p = src + (i - radius) * srcStrideX;
+        bool blockEnd = window - 1 == pos || n - 1 == i;
+        for (int v = 0; v < vecs; ++v) {
+            __m128i e = inside ? load_lanes(p + 4 * v * srcStrideY, srcStrideY, counts[v])
+                               : identity;
+            hi[v] = blockEnd ? e : morph_op<type>(hi[v + vecs], e);
+        }
+        if (--pos < 0) {
+            pos = window - 1;
+        }
+    }
+
+    for (int x = 0; x < width; ++x) {
+        const __m128i* hx = h + x * vecs;
+        const __m128i* gx = g + (x + 2 * radius) * vecs;
+        SkPMColor* d = dst + x * dstStrideX;
+        for (int v = 0; v < vecs; ++v) {
+            store_lanes(d + 4 * v * dstStrideY, dstStrideY, counts[v],
+                        morph_op<type>(hx[v], gx[v]));
+        }
+    }
+}
+
+template<MorphType type, MorphDirection direction>
+void morph_SSE2(const SkPMColor* src, SkPMColor* dst, int radius, int width, int height,
+                int srcStrideX, int srcStrideY, int dstStrideX, int dstStrideY)
+{
+    radius = SkMin32(radius, width - 1);
+    const int vecs = kY == direction ? 4 : 1;
+    const int n = width + 2 * radius;
+    // One extra register, so that the buffers can be 16 byte aligned.
+    SkAutoMalloc storage((2 * n * vecs + 1) * sizeof(__m128i));
+    size_t address = reinterpret_cast<size_t>(storage.get());
+    __m128i* g = reinterpret_cast<__m128i*>((address + 15) & ~static_cast<size_t>(15));
+    __m128i* h = g + n * vecs;
+    for (int y = 0; y < height; y += 4 * vecs) {
+        int lanes = SkMin32(4 * vecs, height - y);
+        morph_lanes<type>(src + y * srcStrideY, dst + y * dstStrideY, radius, width, lanes,
+                          srcStrideX, srcStrideY, dstStrideX, dstStrideY, vecs, g, h);
+    }
+}
+
+}  // namespace
+
+SkMorphologyProc SkMorphologyGetPlatformProc_SSE2(SkMorphologyProcType type) {
+    switch (type) {
+        case kDilateX_SkMorphologyProcType:
+            return morph_SSE2<kDilate, kX>;
+        case kDilateY_SkMorphologyProcType:
+            return morph_SSE2<kDilate, kY>;
+        case kErodeX_SkMorphologyProcType:
+            return morph_SSE2<kErode, kX>;
+        case kErodeY_SkMorphologyProcType:
+            return morph_SSE2<kErode, kY>;
+        default:
+            return NULL;
+    }
+}
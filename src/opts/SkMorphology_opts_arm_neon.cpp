@@ -0,0 +1,144 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMorphology_opts_arm_neon.h"
+#include "SkTemplates.h"
+
+#include <arm_neon.h>
+
+namespace {
+
+enum MorphType {
+    kErode,
+    kDilate
+};
+
+enum MorphDirection {
+    kX,
+    kY
+};
+
+template<MorphType type>
+inline uint8x16_t morph_op(uint8x16_t a, uint8x16_t b) {
+    return kDilate == type ? vmaxq_u8(a, b) : vminq_u8(a, b);
+}
+
+// Loads pixel i of count (at most 4) adjacent lines into one register, one line per lane.
+inline uint8x16_t load_lanes(const SkPMColor* p, int stride, int count) {
+    if (1 == stride && 4 == count) {
+        return vreinterpretq_u8_u32(vld1q_u32(p));
+    }
+    SkPMColor c[4] = { 0, 0, 0, 0 };
+    for (int j = 0; j < count; ++j) {
+        c[j] = p[j * stride];
+    }
+    return vreinterpretq_u8_u32(vld1q_u32(c));
+}
+
+inline void store_lanes(SkPMColor* p, int stride, int count, uint8x16_t v) {
+    if (1 == stride && 4 == count) {
+        vst1q_u32(p, vreinterpretq_u32_u8(v));
+        return;
+    }
+    SkPMColor c[4];
+    vst1q_u32(c, vreinterpretq_u32_u8(v));
+    for (int j = 0; j < count; ++j) {
+        p[j * stride] = c[j];
+    }
+}
+
+// See morph_lanes() in SkMorphology_opts_SSE2.cpp.
+template<MorphType type>
+void morph_lanes(const SkPMColor* src, SkPMColor* dst, int radius, int width, int lanes,
+                 int srcStrideX, int srcStrideY, int dstStrideX, int dstStrideY,
+                 int vecs, uint8x16_t* g, uint8x16_t* h) {
+    const uint8x16_t identity = vdupq_n_u8(kDilate == type ? 0 : 0xFF);
+    const int window = 2 * radius + 1;
+    const int n = width + 2 * radius;
+
+    int counts[4];
+    for (int v = 0; v < vecs; ++v) {
+        counts[v] = SkMax32(0, SkMin32(4, lanes - 4 * v));
+    }
+
+    int pos = 0;
+    for (int i = 0; i < n; ++i) {
+        uint8x16_t* gi = g + i * vecs;
+        bool inside = i >= radius && i < radius + width;
+        const SkPMColor* p = src + (i - radius) * srcStrideX;
+        for (int v = 0; v < vecs; ++v) {
+            uint8x16_t e = inside ? load_lanes(p + 4 * v * srcStrideY, srcStrideY, counts[v])
+                                  : identity;
+            gi[v] = 0 == pos ? e : morph_op<type>(gi[v - vecs], e);
+        }
+        if (++pos == window) {
+            pos = 0;
+        }
+    }
+
+    pos = (n - 1) % window;
+    for (int i = n - 1; i >= 0; --i) {
+        uint8x16_t* hi = h + i * vecs;
+        bool inside = i >= radius && i < radius + width;
+        const SkPMColor* p = src + (i - radius) * srcStrideX;
+        bool blockEnd = window - 1 == pos || n - 1 == i;
+        for (int v = 0; v < vecs; ++v) {
+            uint8x16_t e = inside ? load_lanes(p + 4 * v * srcStrideY, srcStrideY, counts[v])
+                                  : identity;
+            hi[v] = blockEnd ? e : morph_op<type>(hi[v + vecs], e);
+        }
+        if (--pos < 0) {
+            pos = window - 1;
+        }
+    }
+
+    for (int x = 0; x < width; ++x) {
+        const uint8x16_t* hx = h + x * vecs;
+        const uint8x16_t* gx = g + (x + 2 * radius) * vecs;
+        SkPMColor* d = dst + x * dstStrideX;
+        for (int v = 0; v < vecs; ++v) {
+            store_lanes(d + 4 * v * dstStrideY, dstStrideY, counts[v],
+                        morph_op<type>(hx[v], gx[v]));
+        }
+    }
+}
+
+template<MorphType type, MorphDirection direction>
+void morph_neon(const SkPMColor* src, SkPMColor* dst, int radius, int width, int height,
+                int srcStrideX, int srcStrideY, int dstStrideX, int dstStrideY)
+{
+    radius = SkMin32(radius, width - 1);
+    const int vecs = kY == direction ? 4 : 1;
+    const int n = width + 2 * radius;
+    // One extra register, so that the buffers can be 16 byte aligned.
+    SkAutoMalloc storage((2 * n * vecs + 1) * sizeof(uint8x16_t));
+    size_t address = reinterpret_cast<size_t>(storage.get());
+    uint8x16_t* g = reinterpret_cast<uint8x16_t*>((address + 15) & ~static_cast<size_t>(15));
+    uint8x16_t* h = g + n * vecs;
+    for (int y = 0; y < height; y += 4 * vecs) {
+        int lanes = SkMin32(4 * vecs, height - y);
+        morph_lanes<type>(src + y * srcStrideY, dst + y * dstStrideY, radius, width, lanes,
+                          srcStrideX, srcStrideY, dstStrideX, dstStrideY, vecs, g, h);
+    }
+}
+
+}  // namespace
+
+SkMorphologyProc SkMorphologyGetPlatformProc_NEON(SkMorphologyProcType type) {
+    switch (type) {
+        case kDilateX_SkMorphologyProcType:
+            return morph_neon<kDilate, kX>;
+        case kDilateY_SkMorphologyProcType:
+            return morph_neon<kDilate, kY>;
+        case kErodeX_SkMorphologyProcType:
+            return morph_neon<kErode, kX>;
+        case kErodeY_SkMorphologyProcType:
+            return morph_neon<kErode, kY>;
+        default:
+            return NULL;
+    }
+}
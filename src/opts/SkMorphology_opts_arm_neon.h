@@ -0,0 +1,14 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkMorphology_opts_arm_neon_DEFINED
+#define SkMorphology_opts_arm_neon_DEFINED
+
+#include "SkMorphology_opts.h"
+
+SkMorphologyProc SkMorphologyGetPlatformProc_NEON(SkMorphologyProcType type);
+
+#endif
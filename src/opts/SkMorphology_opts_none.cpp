@@ -0,0 +1,14 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMorphology_opts.h"
+
+// Platform impl of the morphology procs with no overrides
+
+SkMorphologyProc SkMorphologyGetPlatformProc(SkMorphologyProcType) {
+    return NULL;
+}
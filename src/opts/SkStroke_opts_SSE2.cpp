@@ -0,0 +1,51 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <emmintrin.h>
+#include "SkStroke_opts_SSE2.h"
+
+// Four lines at a time, with the same operations as SkPoint::setNormalize(), so that the
+// results are identical: SSE2 division and square root are correctly rounded, as the
+// scalar ones are. Lines that are too long for their squared length to be finite are
+// handed back to the portable code, which uses doubles for them.
+void SkStrokerPriv_UnitNormals_SSE2(const SkPoint pts[], int count, SkVector unitNormals[]) {
+    const __m128 nearlyZero2 = _mm_set1_ps(SK_ScalarNearlyZero * SK_ScalarNearlyZero);
+    const __m128 infinity = _mm_set1_ps(SK_ScalarInfinity);
+    const __m128 one = _mm_set1_ps(SK_Scalar1);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const float* p = &pts[i].fX;
+        __m128 d01 = _mm_sub_ps(_mm_loadu_ps(p + 2), _mm_loadu_ps(p));
+        __m128 d23 = _mm_sub_ps(_mm_loadu_ps(p + 6), _mm_loadu_ps(p + 4));
+        __m128 dx = _mm_shuffle_ps(d01, d23, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 dy = _mm_shuffle_ps(d01, d23, _MM_SHUFFLE(3, 1, 3, 1));
+
+        __m128 mag2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        // Same test as SkPath::IsLineDegenerate(), which is also false for NaNs.
+        __m128 valid = _mm_cmpgt_ps(mag2, nearlyZero2);
+        __m128 scale = _mm_div_ps(one, _mm_sqrt_ps(mag2));
+
+        // rotateCCW: (x, y) -> (y, -x)
+        __m128 nx = _mm_and_ps(_mm_mul_ps(dy, scale), valid);
+        __m128 ny = _mm_and_ps(_mm_xor_ps(_mm_mul_ps(dx, scale), signBit), valid);
+        float* dst = &unitNormals[i].fX;
+        _mm_storeu_ps(dst, _mm_unpacklo_ps(nx, ny));
+        _mm_storeu_ps(dst + 4, _mm_unpackhi_ps(nx, ny));
+
+        int overflow = _mm_movemask_ps(_mm_andnot_ps(_mm_cmplt_ps(mag2, infinity), valid));
+        if (overflow) {
+            for (int k = 0; k < 4; ++k) {
+                if (overflow & (1 << k)) {
+                    SkStrokerPriv::UnitNormals(&pts[i + k], 1, &unitNormals[i + k]);
+                }
+            }
+        }
+    }
+    SkStrokerPriv::UnitNormals(&pts[i], count - i, &unitNormals[i]);
+}
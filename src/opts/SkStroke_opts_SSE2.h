@@ -0,0 +1,15 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStroke_opts_SSE2_DEFINED
+#define SkStroke_opts_SSE2_DEFINED
+
+#include "SkStrokerPriv.h"
+
+void SkStrokerPriv_UnitNormals_SSE2(const SkPoint pts[], int count, SkVector unitNormals[]);
+
+#endif
@@ -0,0 +1,14 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkStrokerPriv.h"
+
+// Platform impl of the stroker's unit normals proc with no overrides
+
+SkStrokerPriv::UnitNormalsProc SkStrokerPriv::PlatformUnitNormalsProc() {
+    return NULL;
+}
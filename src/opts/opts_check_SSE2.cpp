@@ -12,6 +12,16 @@
 #include "SkBlitRow.h"
 #include "SkBlitRect_opts_SSE2.h"
 #include "SkBlitRow_opts_SSE2.h"
+#include "SkBlurImage_opts_SSE2.h"
+#include "SkConvertRow_opts_SSE2.h"
+#include "SkConvertRow_opts_SSSE3.h"
+#include "SkGradient_opts_SSE2.h"
+#include "SkLighting_opts_SSE2.h"
+#include "SkMatrix_opts_SSE2.h"
+#include "SkMatrixConvolution_opts_SSE2.h"
+#include "SkMipMap_opts_SSE2.h"
+#include "SkMorphology_opts_SSE2.h"
+#include "SkStroke_opts_SSE2.h"
 #include "SkUtils_opts_SSE2.h"
 #include "SkUtils.h"
 
@@ -159,6 +169,38 @@ void SkBitmapProcState::platformProcs() {
                 fShaderProc32 = highQualityFilter_SSE2;
             }
         }
+
+        static const struct {
+            ShaderProc32    fProc;
+            ShaderProc32    fProcSSE2;
+        } gScaleShaderProcs[] = {
+            { Repeat_S32_opaque_D32_nofilter_DX_shaderproc,
+              Repeat_S32_opaque_D32_nofilter_DX_shaderproc_SSE2 },
+            { Mirror_S32_opaque_D32_nofilter_DX_shaderproc,
+              Mirror_S32_opaque_D32_nofilter_DX_shaderproc_SSE2 },
+            { Clamp_S32_opaque_D32_filter_DX_shaderproc,
+              Clamp_S32_opaque_D32_filter_DX_shaderproc_SSE2 },
+            { Repeat_S32_opaque_D32_filter_DX_shaderproc,
+              Repeat_S32_opaque_D32_filter_DX_shaderproc_SSE2 },
+            { Mirror_S32_opaque_D32_filter_DX_shaderproc,
+              Mirror_S32_opaque_D32_filter_DX_shaderproc_SSE2 },
+            { Repeat_SI8_opaque_D32_nofilter_DX_shaderproc,
+              Repeat_SI8_opaque_D32_nofilter_DX_shaderproc_SSE2 },
+            { Mirror_SI8_opaque_D32_nofilter_DX_shaderproc,
+              Mirror_SI8_opaque_D32_nofilter_DX_shaderproc_SSE2 },
+            { Clamp_SI8_opaque_D32_filter_DX_shaderproc,
+              Clamp_SI8_opaque_D32_filter_DX_shaderproc_SSE2 },
+            { Repeat_SI8_opaque_D32_filter_DX_shaderproc,
+              Repeat_SI8_opaque_D32_filter_DX_shaderproc_SSE2 },
+            { Mirror_SI8_opaque_D32_filter_DX_shaderproc,
+              Mirror_SI8_opaque_D32_filter_DX_shaderproc_SSE2 },
+        };
+        for (size_t i = 0; i < SK_ARRAY_COUNT(gScaleShaderProcs); ++i) {
+            if (fShaderProc32 == gScaleShaderProcs[i].fProc) {
+                fShaderProc32 = gScaleShaderProcs[i].fProcSSE2;
+                break;
+            }
+        }
     }
 }
 
@@ -169,8 +211,26 @@ static SkBlitRow::Proc32 platform_32_procs[] = {
     S32A_Blend_BlitRow32_SSE2,          // S32A_Blend,
 };
 
+static SkBlitRow::Proc platform_565_procs[] = {
+    // no dither
+    S32_D565_Opaque_SSE2,               // S32_D565_Opaque
+    NULL,                               // S32_D565_Blend
+    NULL,                               // S32A_D565_Opaque
+    NULL,                               // S32A_D565_Blend
+
+    // dither
+    S32_D565_Opaque_Dither_SSE2,        // S32_D565_Opaque_Dither
+    NULL,                               // S32_D565_Blend_Dither
+    NULL,                               // S32A_D565_Opaque_Dither
+    NULL,                               // S32A_D565_Blend_Dither
+};
+
 SkBlitRow::Proc SkBlitRow::PlatformProcs565(unsigned flags) {
-    return NULL;
+    if (cachedHasSSE2()) {
+        return platform_565_procs[flags];
+    } else {
+        return NULL;
+    }
 }
 
 SkBlitRow::ColorProc SkBlitRow::PlatformColorProc() {
@@ -257,3 +317,115 @@ SkBlitRow::ColorRectProc PlatformColorRectProcFactory() {
         return NULL;
     }
 }
+
+SkConvertRow::Proc SkConvertRow::PlatformProcs(SrcFormat format) {
+    Proc proc = NULL;
+    if (cachedHasSSSE3()) {
+        proc = SkConvertRow_PlatformProcs_SSSE3(format);
+    }
+    if (NULL == proc && cachedHasSSE2()) {
+        proc = SkConvertRow_PlatformProcs_SSE2(format);
+    }
+    return proc;
+}
+
+bool SkBoxBlurGetPlatformProcs(SkBoxBlurProc* boxBlurX, SkBoxBlurProc* boxBlurXT) {
+    if (cachedHasSSE2()) {
+        return SkBoxBlurGetPlatformProcs_SSE2(boxBlurX, boxBlurXT);
+    } else {
+        return false;
+    }
+}
+
+SkBoxBlurA8Proc SkBoxBlurA8GetPlatformProc() {
+    if (cachedHasSSE2()) {
+        return SkBoxBlurA8_SSE2;
+    } else {
+        return NULL;
+    }
+}
+
+SkMorphologyProc SkMorphologyGetPlatformProc(SkMorphologyProcType type) {
+    if (cachedHasSSE2()) {
+        return SkMorphologyGetPlatformProc_SSE2(type);
+    } else {
+        return NULL;
+    }
+}
+
+SkLightingRowProc SkLightingGetPlatformProc(SkLightingLightType lightType,
+                                            SkLightingType lightingType) {
+    if (cachedHasSSE2()) {
+        return SkLightingGetPlatformProc_SSE2(lightType, lightingType);
+    } else {
+        return NULL;
+    }
+}
+
+SkMatrixConvolutionProc SkMatrixConvolutionGetPlatformProc(int kernelWidth, int kernelHeight,
+                                                           bool convolveAlpha) {
+    if (cachedHasSSE2()) {
+        return SkMatrixConvolutionGetPlatformProc_SSE2(kernelWidth, kernelHeight, convolveAlpha);
+    } else {
+        return NULL;
+    }
+}
+
+SkLinearGradientSpanProc SkLinearGradientGetPlatformProc(SkShader::TileMode tileMode) {
+    if (cachedHasSSE2()) {
+        return SkLinearGradientGetPlatformProc_SSE2(tileMode);
+    } else {
+        return NULL;
+    }
+}
+
+SkRadialGradientSpanProc SkRadialGradientGetPlatformProc(SkShader::TileMode tileMode) {
+    if (cachedHasSSE2()) {
+        return SkRadialGradientGetPlatformProc_SSE2(tileMode);
+    } else {
+        return NULL;
+    }
+}
+
+SkConicalGradientSpanProc SkConicalGradientGetPlatformProc(SkShader::TileMode tileMode) {
+    if (cachedHasSSE2()) {
+        return SkConicalGradientGetPlatformProc_SSE2(tileMode);
+    } else {
+        return NULL;
+    }
+}
+
+SkMipMap::DownsampleProc SkMipMap::PlatformDownsampleProc(SkBitmap::Config config) {
+    if (cachedHasSSE2()) {
+        return SkMipMap_PlatformDownsampleProc_SSE2(config);
+    } else {
+        return NULL;
+    }
+}
+
+SkMatrix::MapPtsProc SkMatrix::PlatformMapPtsProc(TypeMask mask) {
+#ifdef SK_SCALAR_IS_FLOAT
+    if (cachedHasSSE2()) {
+        return SkMatrix_PlatformMapPtsProc_SSE2(mask);
+    }
+#endif
+    return NULL;
+}
+
+SkMatrix::MapPtsBoundsProc SkMatrix::PlatformMapPtsBoundsProc(TypeMask mask) {
+#ifdef SK_SCALAR_IS_FLOAT
+    if (cachedHasSSE2()) {
+        return SkMatrix_PlatformMapPtsBoundsProc_SSE2(mask);
+    }
+#endif
+    return NULL;
+}
+
+SkStrokerPriv::UnitNormalsProc SkStrokerPriv::PlatformUnitNormalsProc() {
+#ifdef SK_SCALAR_IS_FLOAT
+    if (cachedHasSSE2()) {
+        return SkStrokerPriv_UnitNormals_SSE2;
+    }
+#endif
+    return NULL;
+}
@@ -14,6 +14,15 @@
  */
 
 #include "SkBlitRow.h"
+#include "SkBlurImage_opts.h"
+#include "SkConvertRow.h"
+#include "SkGradient_opts.h"
+#include "SkLighting_opts.h"
+#include "SkMatrix.h"
+#include "SkMatrixConvolution_opts.h"
+#include "SkMipMap.h"
+#include "SkMorphology_opts.h"
+#include "SkStrokerPriv.h"
 #include "SkUtils.h"
 
 #include "SkUtilsArm.h"
@@ -23,6 +32,16 @@ extern "C" void memset16_neon(uint16_t dst[], uint16_t value, int count);
 extern "C" void memset32_neon(uint32_t dst[], uint32_t value, int count);
 #endif
 
+#if !SK_ARM_NEON_IS_NONE
+#include "SkBlurImage_opts_arm_neon.h"
+#include "SkConvertRow_opts_arm_neon.h"
+#include "SkGradient_opts_arm_neon.h"
+#include "SkLighting_opts_arm_neon.h"
+#include "SkMatrixConvolution_opts_arm_neon.h"
+#include "SkMipMap_opts_arm_neon.h"
+#include "SkMorphology_opts_arm_neon.h"
+#endif
+
 #if defined(SK_CPU_LENDIAN)
 extern "C" void arm_memset16(uint16_t* dst, uint16_t value, int count);
 extern "C" void arm_memset32(uint32_t* dst, uint32_t value, int count);
@@ -65,3 +84,140 @@ SkMemset32Proc SkMemset32GetPlatformProc() {
 SkBlitRow::ColorRectProc PlatformColorRectProcFactory() {
     return NULL;
 }
+
+// There are no ARMv6 versions of these, only NEON ones.
+static const SkConvertRow::Proc sk_convertrow_platform_procs_arm[] = {
+    NULL, NULL, NULL, NULL, NULL,
+};
+
+SkConvertRow::Proc SkConvertRow::PlatformProcs(SrcFormat format) {
+    SkASSERT((unsigned)format < kSrcFormatCount);
+    return SK_ARM_NEON_WRAP(sk_convertrow_platform_procs_arm)[format];
+}
+
+bool SkBoxBlurGetPlatformProcs(SkBoxBlurProc* boxBlurX, SkBoxBlurProc* boxBlurXT) {
+#if SK_ARM_NEON_IS_NONE
+    return false;
+#else
+#if SK_ARM_NEON_IS_DYNAMIC
+    if (!sk_cpu_arm_has_neon()) {
+        return false;
+    }
+#endif
+    return SkBoxBlurGetPlatformProcs_NEON(boxBlurX, boxBlurXT);
+#endif
+}
+
+// There is no NEON version of the A8 pass yet.
+SkBoxBlurA8Proc SkBoxBlurA8GetPlatformProc() {
+    return NULL;
+}
+
+SkMorphologyProc SkMorphologyGetPlatformProc(SkMorphologyProcType type) {
+#if SK_ARM_NEON_IS_NONE
+    return NULL;
+#else
+#if SK_ARM_NEON_IS_DYNAMIC
+    if (!sk_cpu_arm_has_neon()) {
+        return NULL;
+    }
+#endif
+    return SkMorphologyGetPlatformProc_NEON(type);
+#endif
+}
+
+SkLightingRowProc SkLightingGetPlatformProc(SkLightingLightType lightType,
+                                            SkLightingType lightingType) {
+#if SK_ARM_NEON_IS_NONE
+    return NULL;
+#else
+#if SK_ARM_NEON_IS_DYNAMIC
+    if (!sk_cpu_arm_has_neon()) {
+        return NULL;
+    }
+#endif
+    return SkLightingGetPlatformProc_NEON(lightType, lightingType);
+#endif
+}
+
+SkMatrixConvolutionProc SkMatrixConvolutionGetPlatformProc(int kernelWidth, int kernelHeight,
+                                                           bool convolveAlpha) {
+#if SK_ARM_NEON_IS_NONE
+    return NULL;
+#else
+#if SK_ARM_NEON_IS_DYNAMIC
+    if (!sk_cpu_arm_has_neon()) {
+        return NULL;
+    }
+#endif
+    return SkMatrixConvolutionGetPlatformProc_NEON(kernelWidth, kernelHeight, convolveAlpha);
+#endif
+}
+
+SkLinearGradientSpanProc SkLinearGradientGetPlatformProc(SkShader::TileMode tileMode) {
+#if SK_ARM_NEON_IS_NONE
+    return NULL;
+#else
+#if SK_ARM_NEON_IS_DYNAMIC
+    if (!sk_cpu_arm_has_neon()) {
+        return NULL;
+    }
+#endif
+    return SkLinearGradientGetPlatformProc_NEON(tileMode);
+#endif
+}
+
+SkRadialGradientSpanProc SkRadialGradientGetPlatformProc(SkShader::TileMode tileMode) {
+#if SK_ARM_NEON_IS_NONE
+    return NULL;
+#else
+#if SK_ARM_NEON_IS_DYNAMIC
+    if (!sk_cpu_arm_has_neon()) {
+        return NULL;
+    }
+#endif
+    return SkRadialGradientGetPlatformProc_NEON(tileMode);
+#endif
+}
+
+SkConicalGradientSpanProc SkConicalGradientGetPlatformProc(SkShader::TileMode tileMode) {
+#if SK_ARM_NEON_IS_NONE
+    return NULL;
+#else
+#if SK_ARM_NEON_IS_DYNAMIC
+    if (!sk_cpu_arm_has_neon()) {
+        return NULL;
+    }
+#endif
+    return SkConicalGradientGetPlatformProc_NEON(tileMode);
+#endif
+}
+
+SkMipMap::DownsampleProc SkMipMap::PlatformDownsampleProc(SkBitmap::Config config) {
+#if SK_ARM_NEON_IS_NONE
+    return NULL;
+#else
+#if SK_ARM_NEON_IS_DYNAMIC
+    if (!sk_cpu_arm_has_neon()) {
+        return NULL;
+    }
+#endif
+    return SkMipMap_PlatformDownsampleProc_NEON(config);
+#endif
+}
+
+// ARMv7 NEON flushes denormals to zero, which the portable (VFP) procs do not, so
+// it cannot match them exactly and the portable procs are used.
+SkMatrix::MapPtsProc SkMatrix::PlatformMapPtsProc(TypeMask) {
+    return NULL;
+}
+
+SkMatrix::MapPtsBoundsProc SkMatrix::PlatformMapPtsBoundsProc(TypeMask) {
+    return NULL;
+}
+
+// ARMv7 NEON only has estimates of the reciprocal square root, which cannot match
+// SkPoint::setNormalize() exactly, so the portable unit normals are used.
+SkStrokerPriv::UnitNormalsProc SkStrokerPriv::PlatformUnitNormalsProc() {
+    return NULL;
+}
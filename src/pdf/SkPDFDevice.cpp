@@ -27,6 +27,7 @@
 #include "SkPDFTypes.h"
 #include "SkPDFUtils.h"
 #include "SkRect.h"
+#include "SkRRect.h"
 #include "SkString.h"
 #include "SkTextFormatParams.h"
 #include "SkTemplates.h"
@@ -899,6 +900,14 @@ void SkPDFDevice::drawRect(const SkDraw& d, const SkRect& rect,
                           &content.entry()->fContent);
 }
 
+void SkPDFDevice::drawRRect(const SkDraw& d, const SkRRect& rrect,
+                            const SkPaint& paint) {
+    // SkBitmapDevice would draw a blurred rrect into our bitmap.
+    SkPath path;
+    path.addRRect(rrect);
+    drawPath(d, path, paint, NULL, true);
+}
+
 void SkPDFDevice::drawPath(const SkDraw& d, const SkPath& origPath,
                            const SkPaint& paint, const SkMatrix* prePathMatrix,
                            bool pathIsMutable) {
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkDiscardableMemory.h"
+#include "SkPurgeableMemoryBlock.h"
+
+/**
+ *  SkDiscardableMemory on top of SkPurgeableMemoryBlock, which on Linux keeps unpinned blocks
+ *  within a budget and hands the oldest ones back to the kernel.
+ */
+class SkPurgeableDiscardableMemory : public SkDiscardableMemory {
+
+public:
+    SkPurgeableDiscardableMemory(SkPurgeableMemoryBlock* block, void* addr)
+        : fBlock(block)
+        , fAddr(addr)
+        , fLocked(true)
+        , fDiscarded(false) {}
+
+    virtual ~SkPurgeableDiscardableMemory() {
+        SkASSERT(!fLocked);
+        SkDELETE(fBlock);
+    }
+
+    virtual bool lock() SK_OVERRIDE {
+        SkASSERT(!fLocked);
+        if (fDiscarded) {
+            return false;
+        }
+        SkPurgeableMemoryBlock::PinResult pinResult;
+        void* addr = fBlock->pin(&pinResult);
+        if (NULL == addr) {
+            fDiscarded = true;
+            return false;
+        }
+        if (SkPurgeableMemoryBlock::kRetained_PinResult != pinResult) {
+            // The data is gone for good. Leave the block pinned, so that it does not count
+            // against the budget of unpinned blocks until it is deleted.
+            fDiscarded = true;
+            return false;
+        }
+        fAddr = addr;
+        fLocked = true;
+        return true;
+    }
+
+    virtual void* data() SK_OVERRIDE {
+        SkASSERT(fLocked);
+        return fAddr;
+    }
+
+    virtual void unlock() SK_OVERRIDE {
+        SkASSERT(fLocked);
+        fBlock->unpin();
+        fLocked = false;
+    }
+
+private:
+    SkPurgeableMemoryBlock* fBlock;
+    void*                   fAddr;
+    bool                    fLocked;
+    bool                    fDiscarded;
+};
+
+SkDiscardableMemory* SkDiscardableMemory::Create(size_t bytes) {
+    SkPurgeableMemoryBlock* block = SkPurgeableMemoryBlock::Create(bytes);
+    if (NULL == block) {
+        return NULL;
+    }
+    SkPurgeableMemoryBlock::PinResult pinResult;
+    void* addr = block->pin(&pinResult);
+    if (NULL == addr) {
+        SkDELETE(block);
+        return NULL;
+    }
+    return SkNEW_ARGS(SkPurgeableDiscardableMemory, (block, addr));
+}
@@ -15,6 +15,10 @@ bool SkPurgeableMemoryBlock::IsSupported() {
     return true;
 }
 
+size_t SkPurgeableMemoryBlock::SetUnpinnedBudget(size_t) {
+    return 0;
+}
+
 #ifdef SK_DEBUG
 bool SkPurgeableMemoryBlock::PlatformSupportsPurgingAllUnpinnedBlocks() {
     return false;
@@ -0,0 +1,229 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPurgeableMemoryBlock.h"
+
+#include "SkThread.h"
+#include "SkTInternalLList.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef SK_PURGEABLE_MEMORY_BLOCK_LINUX
+    #error "SkPurgeableMemoryBlock.h does not lay out the block for this port."
+#endif
+
+// Linux has no equivalent of ashmem or purgeable VM regions that can tell us whether a block was
+// purged, so the blocks manage their own budget: unpinned blocks are kept, most recently unpinned
+// first, until they use more than the budget, and then the oldest are handed back to the kernel.
+// SkPurgeableMemoryBlock::SetUnpinnedBudget() changes it at runtime.
+#ifndef SK_DEFAULT_PURGEABLE_MEMORY_BUDGET
+    #define SK_DEFAULT_PURGEABLE_MEMORY_BUDGET     (32 * 1024 * 1024)
+#endif
+
+SK_DECLARE_STATIC_MUTEX(gPurgeableBudgetMutex);
+
+// Written over the first word of each page of a purged block. Pages the kernel takes back read
+// as zero, so any other value shows that the page still holds its data.
+static const uint32_t kPurgedCanary = 0x5AFEC0DE;
+
+static uint32_t* page_word(void* addr, size_t page) {
+    return reinterpret_cast<uint32_t*>(static_cast<char*>(addr) + page * getpagesize());
+}
+
+/**
+ *  Tracks the unpinned blocks. All functions must be called with gPurgeableBudgetMutex held.
+ */
+class SkPurgeableMemoryBudget {
+
+public:
+    static void AddUnpinned(SkPurgeableMemoryBlock* block) {
+        SkASSERT(!block->fPinned && !block->fPurged);
+        Unpinned().addToHead(block);
+        gUnpinnedBytes += block->fSize;
+        PurgeTilAtOrBelow(gBudget, false);
+    }
+
+    static void RemoveUnpinned(SkPurgeableMemoryBlock* block) {
+        SkASSERT(!block->fPinned && !block->fPurged);
+        SkASSERT(block->fSize <= gUnpinnedBytes);
+        Unpinned().remove(block);
+        gUnpinnedBytes -= block->fSize;
+    }
+
+    /**
+     *  Hand the block's pages back to the kernel. Unless discard is true, and if the kernel
+     *  supports MADV_FREE, it only takes the pages it needs, and the block can get its data back
+     *  when it is pinned again (see Unpurge()).
+     */
+    static void Purge(SkPurgeableMemoryBlock* block, bool discard) {
+        RemoveUnpinned(block);
+        block->fPurged = true;
+#ifdef MADV_FREE
+        if (!discard) {
+            const size_t pageCount = block->fSize / getpagesize();
+            uint32_t* saved = static_cast<uint32_t*>(sk_malloc_throw(pageCount * sizeof(uint32_t)));
+            for (size_t i = 0; i < pageCount; ++i) {
+                uint32_t* word = page_word(block->fAddr, i);
+                saved[i] = *word;
+                *word = kPurgedCanary;
+            }
+            if (0 == madvise(block->fAddr, block->fSize, MADV_FREE)) {
+                block->fSavedWords = saved;
+                return;
+            }
+            // Kernels before 4.5 do not know MADV_FREE.
+            sk_free(saved);
+        }
+#endif
+        (void) madvise(block->fAddr, block->fSize, MADV_DONTNEED);
+    }
+
+    /**
+     *  Take a purged block back from the kernel. Returns true if none of its pages were taken,
+     *  so it still holds its data.
+     */
+    static bool Unpurge(SkPurgeableMemoryBlock* block) {
+        SkASSERT(block->fPurged);
+        block->fPurged = false;
+        uint32_t* saved = block->fSavedWords;
+        if (NULL == saved) {
+            return false;
+        }
+        block->fSavedWords = NULL;
+
+        bool retained = true;
+        const size_t pageCount = block->fSize / getpagesize();
+        for (size_t i = 0; i < pageCount; ++i) {
+            // Writing to a page takes it back from MADV_FREE, so the swap both checks that the
+            // kernel still has the page and keeps it from taking the page later.
+            uint32_t* word = page_word(block->fAddr, i);
+            retained &= __sync_bool_compare_and_swap(word, kPurgedCanary, saved[i]);
+        }
+        sk_free(saved);
+        return retained;
+    }
+
+    static void PurgeTilAtOrBelow(size_t limit, bool discard) {
+        while (gUnpinnedBytes > limit) {
+            SkPurgeableMemoryBlock* oldest = Unpinned().tail();
+            SkASSERT(oldest != NULL);
+            Purge(oldest, discard);
+        }
+    }
+
+    static size_t SetBudget(size_t budget) {
+        size_t prevBudget = gBudget;
+        gBudget = budget;
+        PurgeTilAtOrBelow(gBudget, false);
+        return prevBudget;
+    }
+
+private:
+    static SkTInternalLList<SkPurgeableMemoryBlock>& Unpinned() {
+        static SkTInternalLList<SkPurgeableMemoryBlock> gUnpinned;
+        return gUnpinned;
+    }
+
+    static size_t gUnpinnedBytes;
+    static size_t gBudget;
+};
+
+size_t SkPurgeableMemoryBudget::gUnpinnedBytes;
+size_t SkPurgeableMemoryBudget::gBudget = SK_DEFAULT_PURGEABLE_MEMORY_BUDGET;
+
+size_t SkPurgeableMemoryBlock::SetUnpinnedBudget(size_t bytes) {
+    SkAutoMutexAcquire ac(&gPurgeableBudgetMutex);
+    return SkPurgeableMemoryBudget::SetBudget(bytes);
+}
+
+bool SkPurgeableMemoryBlock::IsSupported() {
+    return true;
+}
+
+#ifdef SK_DEBUG
+bool SkPurgeableMemoryBlock::PlatformSupportsPurgingAllUnpinnedBlocks() {
+    return true;
+}
+
+bool SkPurgeableMemoryBlock::PurgeAllUnpinnedBlocks() {
+    // Stand in for the kernel taking back every page, so the data is always lost.
+    SkAutoMutexAcquire ac(&gPurgeableBudgetMutex);
+    SkPurgeableMemoryBudget::PurgeTilAtOrBelow(0, true);
+    return true;
+}
+
+bool SkPurgeableMemoryBlock::purge() {
+    SkASSERT(!fPinned);
+    SkAutoMutexAcquire ac(&gPurgeableBudgetMutex);
+    if (NULL == fAddr || fPurged) {
+        return false;
+    }
+    SkPurgeableMemoryBudget::Purge(this, true);
+    return true;
+}
+#endif
+
+static size_t round_to_page_size(size_t size) {
+    const size_t mask = getpagesize() - 1;
+    return (size + mask) & ~mask;
+}
+
+SkPurgeableMemoryBlock::SkPurgeableMemoryBlock(size_t size)
+    : fAddr(NULL)
+    , fSize(round_to_page_size(size))
+    , fPinned(false)
+    , fPurged(false)
+    , fSavedWords(NULL) {
+}
+
+SkPurgeableMemoryBlock::~SkPurgeableMemoryBlock() {
+    if (NULL == fAddr) {
+        return;
+    }
+    {
+        // Another thread's unpin() may purge this block, so only look at fPurged with the lock.
+        SkAutoMutexAcquire ac(&gPurgeableBudgetMutex);
+        if (!fPinned && !fPurged) {
+            SkPurgeableMemoryBudget::RemoveUnpinned(this);
+        }
+        sk_free(fSavedWords);
+    }
+    munmap(fAddr, fSize);
+}
+
+void* SkPurgeableMemoryBlock::pin(SkPurgeableMemoryBlock::PinResult* pinResult) {
+    SkASSERT(!fPinned);
+    SkASSERT(pinResult != NULL);
+    if (NULL == fAddr) {
+        void* addr = mmap(NULL, fSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED == addr) {
+            SkDebugf("mmap failed\n");
+            return NULL;
+        }
+        fAddr = addr;
+        *pinResult = kUninitialized_PinResult;
+    } else {
+        SkAutoMutexAcquire ac(&gPurgeableBudgetMutex);
+        if (fPurged) {
+            *pinResult = SkPurgeableMemoryBudget::Unpurge(this) ? kRetained_PinResult
+                                                                : kUninitialized_PinResult;
+        } else {
+            SkPurgeableMemoryBudget::RemoveUnpinned(this);
+            *pinResult = kRetained_PinResult;
+        }
+    }
+    fPinned = true;
+    return fAddr;
+}
+
+void SkPurgeableMemoryBlock::unpin() {
+    SkASSERT(fPinned);
+    SkAutoMutexAcquire ac(&gPurgeableBudgetMutex);
+    fPinned = false;
+    SkPurgeableMemoryBudget::AddUnpinned(this);
+}
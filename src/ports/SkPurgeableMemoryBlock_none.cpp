@@ -11,6 +11,10 @@ bool SkPurgeableMemoryBlock::IsSupported() {
     return false;
 }
 
+size_t SkPurgeableMemoryBlock::SetUnpinnedBudget(size_t) {
+    return 0;
+}
+
 #ifdef SK_DEBUG
 bool SkPurgeableMemoryBlock::PlatformSupportsPurgingAllUnpinnedBlocks() {
     return false;
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkImageFilterTiler.h"
+
+#include "SkBitmap.h"
+#include "SkMatrix.h"
+#include "SkRunnable.h"
+#include "SkTDArray.h"
+#include "SkThreadPool.h"
+
+namespace {
+
+/**
+ *  Filters the part of the source that one tile of the result depends on, and copies the tile
+ *  into the result. Tiles write to disjoint parts of the result, so they can run concurrently.
+ */
+class FilterTile : public SkRunnable {
+public:
+    FilterTile(SkImageFilter* filter, SkImageFilter::Proxy* proxy, const SkBitmap& src,
+               const SkMatrix& ctm, const SkIRect& srcBounds, const SkIRect& tile,
+               SkBitmap* result, const SkIPoint& resultOrigin)
+        : fFilter(filter)
+        , fProxy(proxy)
+        , fSrc(src)
+        , fCTM(ctm)
+        , fSrcBounds(srcBounds)
+        , fTile(tile)
+        , fResult(result)
+        , fResultOrigin(resultOrigin)
+        , fSuccess(false) {}
+
+    virtual void run() SK_OVERRIDE {
+        SkBitmap subset;
+        if (!fSrc.extractSubset(&subset, fSrcBounds)) {
+            return;
+        }
+
+        // Filter the subset as if it were the whole source, which puts its top left at (0, 0).
+        SkMatrix ctm = fCTM;
+        ctm.postTranslate(SkIntToScalar(-fSrcBounds.fLeft), SkIntToScalar(-fSrcBounds.fTop));
+        SkBitmap filtered;
+        SkIPoint offset = SkIPoint::Make(0, 0);
+        if (!fFilter->filterImage(fProxy, subset, ctm, &filtered, &offset) ||
+            filtered.config() != SkBitmap::kARGB_8888_Config) {
+            return;
+        }
+
+        SkAutoLockPixels alp(filtered);
+        if (!filtered.getPixels()) {
+            return;
+        }
+        SkIRect filteredBounds = SkIRect::MakeXYWH(fSrcBounds.fLeft + offset.fX,
+                                                   fSrcBounds.fTop + offset.fY,
+                                                   filtered.width(), filtered.height());
+        SkIRect r = fTile;
+        if (r.intersect(filteredBounds)) {
+            size_t bytes = r.width() * sizeof(SkPMColor);
+            for (int y = r.fTop; y < r.fBottom; ++y) {
+                memcpy(fResult->getAddr32(r.fLeft - fResultOrigin.fX, y - fResultOrigin.fY),
+                       filtered.getAddr32(r.fLeft - filteredBounds.fLeft,
+                                          y - filteredBounds.fTop),
+                       bytes);
+            }
+        }
+        fSuccess = true;
+    }
+
+    bool success() const { return fSuccess; }
+
+private:
+    SkImageFilter*          fFilter;
+    SkImageFilter::Proxy*   fProxy;
+    const SkBitmap&         fSrc;
+    const SkMatrix&         fCTM;
+    SkIRect                 fSrcBounds;
+    SkIRect                 fTile;
+    SkBitmap*               fResult;
+    SkIPoint                fResultOrigin;
+    bool                    fSuccess;
+};
+
+}  // namespace
+
+bool SkImageFilterTiler::filterImage(SkImageFilter* filter, SkImageFilter::Proxy* proxy,
+                                     const SkBitmap& src, const SkMatrix& ctm,
+                                     SkBitmap* result, SkIPoint* offset) const {
+    SkIRect srcBounds, dstBounds;
+    src.getBounds(&srcBounds);
+    if (fTileSize <= 0 || src.config() != SkBitmap::kARGB_8888_Config ||
+        !filter->filterBounds(srcBounds, ctm, &dstBounds) ||
+        (dstBounds.width() <= fTileSize && dstBounds.height() <= fTileSize)) {
+        return filter->filterImage(proxy, src, ctm, result, offset);
+    }
+
+    SkAutoLockPixels alp(src);
+    if (!src.getPixels()) {
+        return false;
+    }
+
+    SkBitmap dst;
+    dst.setConfig(SkBitmap::kARGB_8888_Config, dstBounds.width(), dstBounds.height());
+    if (!dst.allocPixels()) {
+        return false;
+    }
+    dst.eraseColor(SK_ColorTRANSPARENT);
+    SkAutoLockPixels alpDst(dst);
+    const SkIPoint dstOrigin = SkIPoint::Make(dstBounds.fLeft, dstBounds.fTop);
+
+    SkTDArray<FilterTile*> tiles;
+    bool tiled = true;
+    for (int y = dstBounds.fTop; tiled && y < dstBounds.fBottom; y += fTileSize) {
+        for (int x = dstBounds.fLeft; x < dstBounds.fRight; x += fTileSize) {
+            SkIRect tile = SkIRect::MakeLTRB(x, y, SkMin32(x + fTileSize, dstBounds.fRight),
+                                             SkMin32(y + fTileSize, dstBounds.fBottom));
+            SkIRect needed;
+            if (!filter->filterInputBounds(tile, ctm, &needed)) {
+                tiled = false;
+                break;
+            }
+            if (!needed.intersect(srcBounds)) {
+                // Nothing in the source reaches this tile.
+                continue;
+            }
+            *tiles.append() = SkNEW_ARGS(FilterTile, (filter, proxy, src, ctm, needed, tile,
+                                                      &dst, dstOrigin));
+        }
+    }
+
+    if (tiled) {
+        // The pool's destructor waits for all of the tiles to finish.
+        SkThreadPool pool(fThreadCount);
+        for (int i = 0; i < tiles.count(); i++) {
+            pool.add(tiles[i]);
+        }
+    }
+    for (int i = 0; tiled && i < tiles.count(); i++) {
+        // A tile may fail where the whole would not (e.g. if a crop rect misses it), so take
+        // the safe route.
+        tiled = tiles[i]->success();
+    }
+    tiles.deleteAll();
+
+    if (!tiled) {
+        return filter->filterImage(proxy, src, ctm, result, offset);
+    }
+    *result = dst;
+    offset->fX += dstBounds.fLeft;
+    offset->fY += dstBounds.fTop;
+    return true;
+}
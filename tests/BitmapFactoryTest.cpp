@@ -11,6 +11,7 @@
 #include "SkBitmapFactory.h"
 #include "SkCanvas.h"
 #include "SkColor.h"
+#include "SkCountdown.h"
 #include "SkData.h"
 #include "SkImageDecoder.h"
 #include "SkImageEncoder.h"
@@ -20,6 +21,7 @@
 #include "SkPurgeableImageCache.h"
 #include "SkStream.h"
 #include "SkTemplates.h"
+#include "SkThreadPool.h"
 #include "Test.h"
 
 static SkBitmap* create_bitmap() {
@@ -134,6 +136,78 @@ static void test_factory(skiatest::Reporter* reporter, SkImageCache* cache, SkDa
     }
 }
 
+// The budget is shared by all of the cache's shards, and pinned memory is never freed.
+static void test_lru_budget(skiatest::Reporter* reporter) {
+    static const size_t kBlockSize = 1000;
+    static const int kCount = 50;
+    SkLruImageCache cache(10 * kBlockSize);
+
+    intptr_t pinned = SkImageCache::UNINITIALIZED_ID;
+    REPORTER_ASSERT(reporter, cache.allocAndPinCache(kBlockSize, &pinned) != NULL);
+
+    intptr_t IDs[kCount];
+    for (int i = 0; i < kCount; i++) {
+        REPORTER_ASSERT(reporter, cache.allocAndPinCache(kBlockSize, &IDs[i]) != NULL);
+        cache.releaseCache(IDs[i]);
+        REPORTER_ASSERT(reporter, cache.getImageCacheUsed() <= 10 * kBlockSize);
+    }
+    REPORTER_ASSERT(reporter, cache.getMemoryStatus(pinned) == SkImageCache::kPinned_MemoryStatus);
+    // The most recent one has not been purged.
+    REPORTER_ASSERT(reporter, cache.getMemoryStatus(IDs[kCount - 1])
+                              == SkImageCache::kUnpinned_MemoryStatus);
+
+    // Pinning it again keeps it from being purged.
+    SkImageCache::DataStatus status;
+    REPORTER_ASSERT(reporter, cache.pinCache(IDs[kCount - 1], &status) != NULL);
+    cache.purgeAllUnpinnedCaches();
+    REPORTER_ASSERT(reporter, cache.getImageCacheUsed() == 2 * kBlockSize);
+    for (int i = 0; i < kCount - 1; i++) {
+        REPORTER_ASSERT(reporter, cache.getMemoryStatus(IDs[i])
+                                  == SkImageCache::kFreed_MemoryStatus);
+    }
+    REPORTER_ASSERT(reporter, cache.getMemoryStatus(IDs[kCount - 1])
+                              == SkImageCache::kPinned_MemoryStatus);
+    cache.releaseCache(IDs[kCount - 1]);
+    cache.purgeAllUnpinnedCaches();
+    REPORTER_ASSERT(reporter, cache.getImageCacheUsed() == kBlockSize);
+    REPORTER_ASSERT(reporter, cache.getMemoryStatus(IDs[kCount - 1])
+                              == SkImageCache::kFreed_MemoryStatus);
+    cache.releaseCache(pinned);
+    cache.throwAwayCache(pinned);
+    REPORTER_ASSERT(reporter, cache.getImageCacheUsed() == 0);
+}
+
+static void test_prefetch(skiatest::Reporter* reporter, SkData* encodedData) {
+    static const int kCount = 4;
+    SkAutoTUnref<SkLruImageCache> cache(SkNEW_ARGS(SkLruImageCache, (0)));
+    SkBitmapFactory factory(&SkImageDecoder::DecodeMemoryToTarget);
+    factory.setImageCache(cache);
+
+    SkBitmap bitmaps[kCount];
+    for (int i = 0; i < kCount; i++) {
+        REPORTER_ASSERT(reporter, factory.installPixelRef(encodedData, &bitmaps[i]));
+    }
+    REPORTER_ASSERT(reporter, cache->getImageCacheUsed() == 0);
+
+    SkCountdown countdown(kCount);
+    SkThreadPool pool(2);
+    SkBitmapFactory::Prefetch(bitmaps, kCount, &pool, &countdown);
+    countdown.wait();
+
+    REPORTER_ASSERT(reporter, cache->getImageCacheUsed() > 0);
+    SkLazyPixelRef::ResetCacheStats();
+    for (int i = 0; i < kCount; i++) {
+        SkLazyPixelRef* lazyRef = static_cast<SkLazyPixelRef*>(bitmaps[i].pixelRef());
+        REPORTER_ASSERT(reporter, cache->getMemoryStatus(lazyRef->getCacheId())
+                                  == SkImageCache::kUnpinned_MemoryStatus);
+        SkAutoLockPixels alp(bitmaps[i]);
+        REPORTER_ASSERT(reporter, bitmaps[i].readyToDraw());
+    }
+    // Every lock found its pixels already decoded.
+    REPORTER_ASSERT(reporter, SkLazyPixelRef::GetCacheHits() == kCount);
+    REPORTER_ASSERT(reporter, SkLazyPixelRef::GetCacheMisses() == 0);
+}
+
 class ImageCacheHolder : public SkNoncopyable {
 
 public:
@@ -189,6 +263,11 @@ static void TestBitmapFactory(skiatest::Reporter* reporter) {
             test_factory(reporter, cache, encodedBitmap, *bitmap.get());
         }
     }
+
+    test_lru_budget(reporter);
+    if (encodeSucceeded) {
+        test_prefetch(reporter, encodedBitmap);
+    }
 }
 
 #include "TestClassDef.h"
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#include "SkBitmap.h"
+#include "SkBitmapProcState.h"
+#include "SkBitmapScaler.h"
+#include "SkColorPriv.h"
+#include "SkRandom.h"
+#include "SkResampleCache.h"
+#include "SkThreadPool.h"
+
+static void make_bitmap(SkBitmap* bm, SkMWCRandom& rand, bool opaque) {
+    int w = 1 + rand.nextU() % 150;
+    int h = 1 + rand.nextU() % 150;
+    bm->setConfig(SkBitmap::kARGB_8888_Config, w, h);
+    bm->allocPixels();
+    SkAutoLockPixels alp(*bm);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            U8CPU a = opaque ? 0xFF : rand.nextU() & 0xFF;
+            *bm->getAddr32(x, y) = SkPreMultiplyARGB(a, rand.nextU() & 0xFF,
+                                                     rand.nextU() & 0xFF, rand.nextU() & 0xFF);
+        }
+    }
+    bm->setIsOpaque(opaque);
+}
+
+static bool equal_pixels(const SkBitmap& a, const SkBitmap& b) {
+    if (a.width() != b.width() || a.height() != b.height()) {
+        return false;
+    }
+    SkAutoLockPixels alpa(a);
+    SkAutoLockPixels alpb(b);
+    for (int y = 0; y < a.height(); ++y) {
+        if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * sizeof(SkPMColor))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The platform's convolution procs, and any number of threads, must give the same pixels
+// as the portable code on one thread.
+static void TestBitmapScalerProcs(skiatest::Reporter* reporter) {
+    SkConvolutionProcs portable;
+    sk_bzero(&portable, sizeof(portable));
+    SkConvolutionProcs platform;
+    sk_bzero(&platform, sizeof(platform));
+    SkBitmapProcState::platformConvolutionProcs(&platform);
+
+    const int threadCounts[] = { 3, SkThreadPool::kThreadPerCore };
+
+    SkMWCRandom rand;
+    for (int i = 0; i < 40; ++i) {
+        SkBitmap src;
+        make_bitmap(&src, rand, SkToBool(i & 1));
+        int dstWidth = 1 + rand.nextU() % 150;
+        int dstHeight = 1 + rand.nextU() % 150;
+        SkBitmapScaler::ResizeMethod method = static_cast<SkBitmapScaler::ResizeMethod>(
+            rand.nextRangeU(SkBitmapScaler::RESIZE_FIRST_ALGORITHM_METHOD,
+                            SkBitmapScaler::RESIZE_LAST_ALGORITHM_METHOD));
+
+        SkBitmap expected;
+        REPORTER_ASSERT(reporter, SkBitmapScaler::Resize(&expected, src, method,
+                                                         dstWidth, dstHeight, portable));
+
+        SkBitmap result;
+        REPORTER_ASSERT(reporter, SkBitmapScaler::Resize(&result, src, method,
+                                                         dstWidth, dstHeight, platform));
+        REPORTER_ASSERT(reporter, equal_pixels(expected, result));
+
+        for (size_t j = 0; j < SK_ARRAY_COUNT(threadCounts); ++j) {
+            REPORTER_ASSERT(reporter, SkBitmapScaler::Resize(&result, src, method,
+                                                             dstWidth, dstHeight, platform,
+                                                             NULL, threadCounts[j]));
+            REPORTER_ASSERT(reporter, equal_pixels(expected, result));
+        }
+    }
+}
+
+// Resizing to the same size again must find both filters in SkResampleCache, and give the
+// same pixels as computing them.
+static void TestBitmapScalerCache(skiatest::Reporter* reporter) {
+    SkConvolutionProcs procs;
+    sk_bzero(&procs, sizeof(procs));
+    SkBitmapProcState::platformConvolutionProcs(&procs);
+
+    SkMWCRandom rand;
+    SkBitmap src;
+    make_bitmap(&src, rand, false);
+
+    SkResampleCache::PurgeAll();
+    SkResampleCache::Stats before, after;
+    SkResampleCache::GetStats(&before);
+    SkBitmap computed;
+    REPORTER_ASSERT(reporter, SkBitmapScaler::Resize(&computed, src,
+                                                     SkBitmapScaler::RESIZE_LANCZOS3,
+                                                     37, 23, procs));
+    SkResampleCache::GetStats(&after);
+    REPORTER_ASSERT(reporter, after.fHits == before.fHits);
+    REPORTER_ASSERT(reporter, after.fMisses == before.fMisses + 2);
+
+    SkBitmap cached;
+    REPORTER_ASSERT(reporter, SkBitmapScaler::Resize(&cached, src,
+                                                     SkBitmapScaler::RESIZE_LANCZOS3,
+                                                     37, 23, procs));
+    SkResampleCache::GetStats(&before);
+    REPORTER_ASSERT(reporter, before.fHits == after.fHits + 2);
+    REPORTER_ASSERT(reporter, equal_pixels(computed, cached));
+
+    // A different method or size is a different filter.
+    REPORTER_ASSERT(reporter, SkBitmapScaler::Resize(&cached, src,
+                                                     SkBitmapScaler::RESIZE_MITCHELL,
+                                                     37, 24, procs));
+    SkResampleCache::GetStats(&after);
+    REPORTER_ASSERT(reporter, after.fMisses == before.fMisses + 2);
+}
+
+static void TestBitmapScaler(skiatest::Reporter* reporter) {
+    TestBitmapScalerProcs(reporter);
+    TestBitmapScalerCache(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("BitmapScaler", TestBitmapScalerClass, TestBitmapScaler)
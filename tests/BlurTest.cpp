@@ -6,11 +6,16 @@
  * found in the LICENSE file.
  */
 #include "Test.h"
+#include "SkBitmapDevice.h"
 #include "SkBlurMask.h"
+#include "SkBlurImageFilter.h"
+#include "SkBlurMaskCache.h"
 #include "SkBlurMaskFilter.h"
 #include "SkCanvas.h"
 #include "SkMath.h"
 #include "SkPaint.h"
+#include "SkRandom.h"
+#include "SkRRect.h"
 #if SK_SUPPORT_GPU
 #include "GrContextFactory.h"
 #include "SkGpuDevice.h"
@@ -379,8 +384,314 @@ static void test_sigma_range(skiatest::Reporter* reporter, GrContextFactory* fac
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static bool blur_image(SkScalar sigmaX, SkScalar sigmaY, const SkBitmap& src, SkBitmap* dst) {
+    SkAutoTUnref<SkImageFilter> filter(new SkBlurImageFilter(sigmaX, sigmaY));
+    SkIPoint offset = SkIPoint::Make(0, 0);
+    return filter->filterImage(NULL, src, SkMatrix::I(), dst, &offset);
+}
+
+static void transpose(const SkBitmap& src, SkBitmap* dst) {
+    dst->setConfig(SkBitmap::kARGB_8888_Config, src.height(), src.width());
+    dst->allocPixels();
+    for (int y = 0; y < src.height(); ++y) {
+        for (int x = 0; x < src.width(); ++x) {
+            *dst->getAddr32(y, x) = *src.getAddr32(x, y);
+        }
+    }
+}
+
+static int max_channel_diff(SkPMColor a, SkPMColor b) {
+    int diff = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        diff = SkMax32(diff, SkAbs32((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF)));
+    }
+    return diff;
+}
+
+// Blurring the transpose of an image, with the sigmas swapped, should give the transpose of
+// the blurred image. The passes of a single axis blur are done in the same order either way,
+// so those match exactly; with both axes the X and Y roundings happen in a different order.
+static void test_blur_image_filter_transpose(skiatest::Reporter* reporter,
+                                             const SkBitmap& src, SkScalar sigmaX,
+                                             SkScalar sigmaY, int tolerance) {
+    SkBitmap srcT, blurred, blurredT, expected;
+    transpose(src, &srcT);
+    REPORTER_ASSERT(reporter, blur_image(sigmaX, sigmaY, src, &blurred));
+    REPORTER_ASSERT(reporter, blur_image(sigmaY, sigmaX, srcT, &blurredT));
+    transpose(blurredT, &expected);
+    REPORTER_ASSERT(reporter, blurred.width() == expected.width() &&
+                              blurred.height() == expected.height());
+
+    int maxDiff = 0;
+    SkAutoLockPixels alp0(blurred), alp1(expected);
+    for (int y = 0; y < blurred.height(); ++y) {
+        for (int x = 0; x < blurred.width(); ++x) {
+            maxDiff = SkMax32(maxDiff, max_channel_diff(*blurred.getAddr32(x, y),
+                                                        *expected.getAddr32(x, y)));
+        }
+    }
+    REPORTER_ASSERT(reporter, maxDiff <= tolerance);
+}
+
+// One pass of SkBlurImageFilter along rows: the kernel is clipped to the image, but the sum is
+// still divided by the whole kernel size, rounding down.
+static void ref_box_blur_x(const SkBitmap& src, SkBitmap* dst, int kernelSize,
+                           int leftOffset, int rightOffset) {
+    dst->setConfig(SkBitmap::kARGB_8888_Config, src.width(), src.height());
+    dst->allocPixels();
+    for (int y = 0; y < src.height(); ++y) {
+        for (int x = 0; x < src.width(); ++x) {
+            int sums[4] = { 0, 0, 0, 0 };
+            for (int i = SkMax32(x - leftOffset, 0);
+                 i <= SkMin32(x + rightOffset, src.width() - 1); ++i) {
+                for (int c = 0; c < 4; ++c) {
+                    sums[c] += (*src.getAddr32(i, y) >> (8 * c)) & 0xFF;
+                }
+            }
+            SkPMColor result = 0;
+            for (int c = 0; c < 4; ++c) {
+                result |= (sums[c] / kernelSize) << (8 * c);
+            }
+            *dst->getAddr32(x, y) = result;
+        }
+    }
+}
+
+// An X only blur is three passes along rows, with the kernels of SkBlurImageFilter.
+static void test_blur_image_filter_x(skiatest::Reporter* reporter, const SkBitmap& src,
+                                     SkScalar sigma) {
+    int d = static_cast<int>(floorf(SkScalarToFloat(sigma) * 3.0f *
+                                    sqrtf(2.0f * SkScalarToFloat(SK_ScalarPI)) / 4.0f + 0.5f));
+    int lowOffset = (d - 1) / 2;
+    int highOffset = d / 2;
+    int kernelSize3 = d | 1;
+
+    SkBitmap pass1, pass2, expected, blurred;
+    ref_box_blur_x(src, &pass1, d, lowOffset, highOffset);
+    ref_box_blur_x(pass1, &pass2, d, highOffset, lowOffset);
+    ref_box_blur_x(pass2, &expected, kernelSize3, highOffset, highOffset);
+    REPORTER_ASSERT(reporter, blur_image(sigma, 0, src, &blurred));
+
+    bool same = true;
+    SkAutoLockPixels alp(blurred);
+    for (int y = 0; y < src.height(); ++y) {
+        for (int x = 0; x < src.width(); ++x) {
+            same &= *blurred.getAddr32(x, y) == *expected.getAddr32(x, y);
+        }
+    }
+    REPORTER_ASSERT(reporter, same);
+}
+
+static void test_blur_image_filter(skiatest::Reporter* reporter) {
+    // Each pass divides exactly, so away from the edges an opaque image stays opaque.
+    SkBitmap opaque;
+    opaque.setConfig(SkBitmap::kARGB_8888_Config, 40, 30);
+    opaque.allocPixels();
+    opaque.eraseColor(SK_ColorWHITE);
+    static const SkScalar kSigmas[][2] = {
+        { SkIntToScalar(3), SkIntToScalar(3) },
+        { SkIntToScalar(3), 0 },
+        { 0, SkIntToScalar(3) },
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kSigmas); ++i) {
+        SkBitmap blurred;
+        REPORTER_ASSERT(reporter, blur_image(kSigmas[i][0], kSigmas[i][1], opaque, &blurred));
+        SkAutoLockPixels alp(blurred);
+        REPORTER_ASSERT(reporter, SkPreMultiplyColor(SK_ColorWHITE) == *blurred.getAddr32(20, 15));
+    }
+
+    // Odd sizes, so that the SIMD procs have leftover rows.
+    SkBitmap src;
+    src.setConfig(SkBitmap::kARGB_8888_Config, 37, 23);
+    src.allocPixels();
+    SkRandom rand;
+    for (int y = 0; y < src.height(); ++y) {
+        for (int x = 0; x < src.width(); ++x) {
+            *src.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+    test_blur_image_filter_transpose(reporter, src, SkIntToScalar(4), 0, 0);
+    test_blur_image_filter_transpose(reporter, src, SkFloatToScalar(2.5f), 0, 0);
+    test_blur_image_filter_transpose(reporter, src, SkIntToScalar(2), SkIntToScalar(5), 3);
+
+    // The platform procs and the portable code both truncate, for kernels on either side of
+    // SK_MAX_PLATFORM_BOX_BLUR_KERNEL (sigma 120 is a kernel of 227, and 200 one of 377).
+    SkBitmap wide;
+    wide.setConfig(SkBitmap::kARGB_8888_Config, 301, 5);
+    wide.allocPixels();
+    for (int y = 0; y < wide.height(); ++y) {
+        for (int x = 0; x < wide.width(); ++x) {
+            *wide.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+    test_blur_image_filter_x(reporter, wide, SkFloatToScalar(2.5f));
+    test_blur_image_filter_x(reporter, wide, SkIntToScalar(120));
+    test_blur_image_filter_x(reporter, wide, SkIntToScalar(200));
+}
+
+// Draws shape, blurred, at two positions an integer offset apart, and checks that the second
+// is drawn from the cache and looks the same.
+static void test_blur_mask_cache_shape(skiatest::Reporter* reporter, const SkPath& shape) {
+    static const int kOffset = 100;
+    SkBitmap bitmap;
+    bitmap.setConfig(SkBitmap::kARGB_8888_Config, 2 * kOffset, kOffset);
+    bitmap.allocPixels();
+    bitmap.eraseColor(SK_ColorWHITE);
+
+    SkCanvas canvas(bitmap);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setMaskFilter(SkBlurMaskFilter::Create(SkBlurMaskFilter::kNormal_BlurStyle,
+                                                 SkIntToScalar(3)))->unref();
+
+    SkBlurMaskCache::Stats before, after;
+    SkBlurMaskCache::GetStats(&before);
+    canvas.drawPath(shape, paint);
+    canvas.translate(SkIntToScalar(kOffset), 0);
+    canvas.drawPath(shape, paint);
+    SkBlurMaskCache::GetStats(&after);
+    REPORTER_ASSERT(reporter, after.fHits > before.fHits);
+
+    bool same = true;
+    SkAutoLockPixels alp(bitmap);
+    for (int y = 0; y < kOffset; ++y) {
+        for (int x = 0; x < kOffset; ++x) {
+            same &= *bitmap.getAddr32(x, y) == *bitmap.getAddr32(x + kOffset, y);
+        }
+    }
+    REPORTER_ASSERT(reporter, same);
+}
+
+static void test_blur_mask_cache(skiatest::Reporter* reporter) {
+    SkPath path;
+    // A rect takes the nine-patch path...
+    path.addRect(SkRect::MakeLTRB(SkFloatToScalar(20.25f), SkFloatToScalar(20.5f),
+                                  SkFloatToScalar(70.75f), SkIntToScalar(75)));
+    test_blur_mask_cache_shape(reporter, path);
+
+    // ...and a pair of nested rects the nine-patch path that blurs a mask.
+    path.addRect(SkRect::MakeLTRB(SkIntToScalar(40), SkIntToScalar(40),
+                                  SkIntToScalar(50), SkIntToScalar(55)));
+    path.setFillType(SkPath::kEvenOdd_FillType);
+    test_blur_mask_cache_shape(reporter, path);
+
+    // Anything else is cached by the contents of its mask.
+    path.reset();
+    path.addRoundRect(SkRect::MakeLTRB(SkFloatToScalar(20.25f), SkFloatToScalar(20.5f),
+                                       SkFloatToScalar(70.75f), SkIntToScalar(75)),
+                      SkIntToScalar(8), SkIntToScalar(8));
+    test_blur_mask_cache_shape(reporter, path);
+
+    // The cache stays within its budget.
+    size_t oldLimit = SkBlurMaskCache::SetByteLimit(0);
+    SkBlurMaskCache::Stats stats;
+    SkBlurMaskCache::GetStats(&stats);
+    REPORTER_ASSERT(reporter, 0 == stats.fCount && 0 == stats.fBytesUsed);
+    SkBlurMaskCache::SetByteLimit(oldLimit);
+}
+
+// A blurred rrect is drawn as a nine-patch; check that against blurring the whole path.
+static void test_blur_rrect(skiatest::Reporter* reporter, const SkRRect& rrect,
+                            SkBlurMaskFilter::BlurStyle style, SkScalar sigma) {
+    SkBitmap nine, whole;
+    SkBitmap* bitmaps[] = { &nine, &whole };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(bitmaps); ++i) {
+        bitmaps[i]->setConfig(SkBitmap::kARGB_8888_Config, 200, 150);
+        bitmaps[i]->allocPixels();
+        bitmaps[i]->eraseColor(SK_ColorWHITE);
+    }
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setMaskFilter(SkBlurMaskFilter::Create(style, sigma))->unref();
+
+    SkCanvas nineCanvas(nine);
+    nineCanvas.drawRRect(rrect, paint);
+    SkCanvas wholeCanvas(whole);
+    SkPath path;
+    path.addRRect(rrect);
+    wholeCanvas.drawPath(path, paint);
+
+    int maxDiff = 0;
+    SkAutoLockPixels alp0(nine), alp1(whole);
+    for (int y = 0; y < nine.height(); ++y) {
+        for (int x = 0; x < nine.width(); ++x) {
+            maxDiff = SkMax32(maxDiff, max_channel_diff(*nine.getAddr32(x, y),
+                                                        *whole.getAddr32(x, y)));
+        }
+    }
+    REPORTER_ASSERT(reporter, maxDiff <= 1);
+}
+
+static void test_blur_rrects(skiatest::Reporter* reporter) {
+    const SkRect r = SkRect::MakeLTRB(SkFloatToScalar(30.25f), SkFloatToScalar(20.5f),
+                                      SkFloatToScalar(170.75f), SkIntToScalar(120));
+    SkRRect simple;
+    simple.setRectXY(r, SkIntToScalar(10), SkIntToScalar(6));
+
+    SkRRect complex;
+    SkVector radii[4] = {
+        { SkIntToScalar(4), SkIntToScalar(4) },
+        { SkIntToScalar(15), SkIntToScalar(10) },
+        { 0, 0 },
+        { SkIntToScalar(8), SkIntToScalar(20) },
+    };
+    complex.setRectRadii(r, radii);
+
+    for (int style = 0; style < SkBlurMaskFilter::kBlurStyleCount; ++style) {
+        SkBlurMaskFilter::BlurStyle blurStyle = (SkBlurMaskFilter::BlurStyle)style;
+        test_blur_rrect(reporter, simple, blurStyle, SkIntToScalar(2));
+        test_blur_rrect(reporter, simple, blurStyle, SkFloatToScalar(5.5f));
+        test_blur_rrect(reporter, complex, blurStyle, SkIntToScalar(3));
+    }
+}
+
+// Counts the rrects that reach the virtual drawPath().
+class DrawPathCountDevice : public SkBitmapDevice {
+public:
+    DrawPathCountDevice(const SkBitmap& bm) : INHERITED(bm), fCount(0) {}
+
+    virtual void drawPath(const SkDraw& draw, const SkPath& path, const SkPaint& paint,
+                          const SkMatrix* prePathMatrix, bool pathIsMutable) SK_OVERRIDE {
+        ++fCount;
+        INHERITED::drawPath(draw, path, paint, prePathMatrix, pathIsMutable);
+    }
+
+    int fCount;
+
+private:
+    typedef SkBitmapDevice INHERITED;
+};
+
+// A blurred rrect that can't be drawn as a nine-patch (here, because it is
+// rotated) must still reach subclasses that only override drawPath().
+static void test_blur_rrect_fallback(skiatest::Reporter* reporter) {
+    SkBitmap bm;
+    bm.setConfig(SkBitmap::kARGB_8888_Config, 100, 100);
+    bm.allocPixels();
+    bm.eraseColor(SK_ColorWHITE);
+
+    SkAutoTUnref<DrawPathCountDevice> device(SkNEW_ARGS(DrawPathCountDevice, (bm)));
+    SkCanvas canvas(device);
+    canvas.rotate(SkIntToScalar(30));
+
+    SkPaint paint;
+    paint.setMaskFilter(SkBlurMaskFilter::Create(SkBlurMaskFilter::kNormal_BlurStyle,
+                                                 SkIntToScalar(3)))->unref();
+    SkRRect rrect;
+    rrect.setRectXY(SkRect::MakeLTRB(SkIntToScalar(20), SkIntToScalar(10),
+                                     SkIntToScalar(60), SkIntToScalar(40)),
+                    SkIntToScalar(5), SkIntToScalar(5));
+    canvas.drawRRect(rrect, paint);
+    REPORTER_ASSERT(reporter, 1 == device->fCount);
+}
+
 static void test_blur(skiatest::Reporter* reporter, GrContextFactory* factory) {
     test_blur_drawing(reporter);
+    test_blur_rrects(reporter);
+    test_blur_rrect_fallback(reporter);
+    test_blur_mask_cache(reporter);
+    test_blur_image_filter(reporter);
     test_sigma_range(reporter, factory);
 }
 
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#include "SkBlitRow.h"
+#include "SkColorPriv.h"
+#include "SkConvertRow.h"
+#include "SkDither.h"
+#include "SkRandom.h"
+
+static const int kMaxPixels = 67;
+
+static SkPMColor reference_convert(SkConvertRow::SrcFormat format,
+                                   const uint8_t* src) {
+    switch (format) {
+        case SkConvertRow::kGray_SrcFormat:
+            return SkPackARGB32(0xFF, src[0], src[0], src[0]);
+        case SkConvertRow::kRGB_SrcFormat:
+        case SkConvertRow::kRGBX_SrcFormat:
+            return SkPackARGB32(0xFF, src[0], src[1], src[2]);
+        case SkConvertRow::kRGBA_SrcFormat:
+            return SkPreMultiplyARGB(src[3], src[0], src[1], src[2]);
+        case SkConvertRow::kBGRA_SrcFormat:
+            return SkPreMultiplyARGB(src[3], src[2], src[1], src[0]);
+        default:
+            SkASSERT(false);
+            return 0;
+    }
+}
+
+static const int gBytesPerPixel[] = { 1, 3, 4, 4, 4 };
+
+// Compare the (possibly platform-specific) procs against the scalar math, for
+// every count up to kMaxPixels and with a misaligned src.
+static void test_convert_procs(skiatest::Reporter* reporter) {
+    SkRandom rand;
+    // +1 so that we can offset src by a byte.
+    uint8_t src[kMaxPixels * 4 + 1];
+    SkPMColor dst[kMaxPixels];
+
+    for (int f = 0; f < SkConvertRow::kSrcFormatCount; ++f) {
+        SkConvertRow::SrcFormat format = (SkConvertRow::SrcFormat)f;
+        SkConvertRow::Proc proc = SkConvertRow::Factory(format);
+        const int bpp = gBytesPerPixel[f];
+
+        for (int count = 0; count <= kMaxPixels; ++count) {
+            for (int offset = 0; offset <= 1; ++offset) {
+                // Alternate between opaque and translucent rows.
+                bool opaqueRow = (count & 1) != 0;
+                for (size_t i = 0; i < sizeof(src); ++i) {
+                    src[i] = rand.nextU() & 0xFF;
+                }
+                if (opaqueRow && bpp == 4) {
+                    for (int i = 0; i < count; ++i) {
+                        src[offset + i * 4 + 3] = 0xFF;
+                    }
+                }
+
+                const uint8_t* s = src + offset;
+                bool hadAlpha = proc(dst, s, count);
+
+                bool expectedAlpha = false;
+                for (int i = 0; i < count; ++i) {
+                    SkPMColor expected = reference_convert(format, s + i * bpp);
+                    REPORTER_ASSERT(reporter, expected == dst[i]);
+                    expectedAlpha |= (0xFF != SkGetPackedA32(expected));
+                }
+                REPORTER_ASSERT(reporter, expectedAlpha == hadAlpha);
+            }
+        }
+    }
+}
+
+static void test_565_procs(skiatest::Reporter* reporter) {
+    SkRandom rand;
+    SkPMColor src[kMaxPixels];
+    uint16_t dst[kMaxPixels];
+
+    for (int i = 0; i < kMaxPixels; ++i) {
+        src[i] = rand.nextU() | SkPackARGB32(0xFF, 0, 0, 0);
+    }
+
+    SkBlitRow::Proc opaque = SkBlitRow::Factory(0, SkBitmap::kRGB_565_Config);
+    SkBlitRow::Proc dither = SkBlitRow::Factory(SkBlitRow::kDither_Flag,
+                                                SkBitmap::kRGB_565_Config);
+    for (int count = 0; count <= kMaxPixels; ++count) {
+        int x = count & 7;
+        int y = count & 3;
+
+        opaque(dst, src, count, 0xFF, x, y);
+        for (int i = 0; i < count; ++i) {
+            REPORTER_ASSERT(reporter, SkPixel32ToPixel16_ToU16(src[i]) == dst[i]);
+        }
+
+        dither(dst, src, count, 0xFF, x, y);
+        DITHER_565_SCAN(y);
+        for (int i = 0; i < count; ++i) {
+            uint16_t expected = SkDitherRGB32To565(src[i], DITHER_VALUE(x + i));
+            REPORTER_ASSERT(reporter, expected == dst[i]);
+        }
+    }
+}
+
+static void TestConvertRow(skiatest::Reporter* reporter) {
+    test_convert_procs(reporter);
+    test_565_procs(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("ConvertRow", TestConvertRowClass, TestConvertRow)
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#include "SkDiscardableMemory.h"
+#include "SkPurgeableMemoryBlock.h"
+#include "SkTemplates.h"
+
+static const size_t kSize = 3 * 4096 + 100;
+
+// Memory unlocked over the budget is handed to the OS, which may still give its data back.
+static void test_over_budget(skiatest::Reporter* reporter) {
+    SkAutoTDelete<SkDiscardableMemory> dm(SkDiscardableMemory::Create(kSize));
+    if (NULL == dm.get()) {
+        return;
+    }
+    char* data = static_cast<char*>(dm->data());
+    for (size_t i = 0; i < kSize; ++i) {
+        data[i] = static_cast<char>(i * 7);
+    }
+
+    size_t prevBudget = SkPurgeableMemoryBlock::SetUnpinnedBudget(1);
+    dm->unlock();
+    if (dm->lock()) {
+        data = static_cast<char*>(dm->data());
+        bool same = true;
+        for (size_t i = 0; i < kSize; ++i) {
+            same &= data[i] == static_cast<char>(i * 7);
+        }
+        REPORTER_ASSERT(reporter, same);
+        dm->unlock();
+    }
+    size_t budget = SkPurgeableMemoryBlock::SetUnpinnedBudget(prevBudget);
+#ifdef SK_PURGEABLE_MEMORY_BLOCK_LINUX
+    REPORTER_ASSERT(reporter, 1 == budget);
+#else
+    REPORTER_ASSERT(reporter, 0 == budget);
+#endif
+}
+
+static void TestDiscardableMemory(skiatest::Reporter* reporter) {
+    SkAutoTDelete<SkDiscardableMemory> dm(SkDiscardableMemory::Create(kSize));
+    if (NULL == dm.get()) {
+        // Not supported on this platform.
+        return;
+    }
+
+    // Create returns the memory locked.
+    char* data = static_cast<char*>(dm->data());
+    REPORTER_ASSERT(reporter, data != NULL);
+    for (size_t i = 0; i < kSize; ++i) {
+        data[i] = static_cast<char>(i);
+    }
+    dm->unlock();
+
+    // Well within any budget, so the data is still there.
+    REPORTER_ASSERT(reporter, dm->lock());
+    data = static_cast<char*>(dm->data());
+    bool same = true;
+    for (size_t i = 0; i < kSize; ++i) {
+        same &= data[i] == static_cast<char>(i);
+    }
+    REPORTER_ASSERT(reporter, same);
+    dm->unlock();
+
+#ifdef SK_DEBUG
+    if (SkPurgeableMemoryBlock::PlatformSupportsPurgingAllUnpinnedBlocks() &&
+        SkPurgeableMemoryBlock::PurgeAllUnpinnedBlocks()) {
+        // Once discarded, the memory can never be locked again.
+        REPORTER_ASSERT(reporter, !dm->lock());
+        REPORTER_ASSERT(reporter, !dm->lock());
+    }
+#endif
+
+    test_over_budget(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("DiscardableMemory", TestDiscardableMemoryClass, TestDiscardableMemory)
@@ -8,6 +8,7 @@
 #include "Test.h"
 #include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkColorPriv.h"
 #include "SkShader.h"
 #include "SkRandom.h"
 #include "SkMatrixUtils.h"
@@ -239,6 +240,193 @@ static bool check_for_all_zeros(const SkBitmap& bm) {
     return true;
 }
 
+// Returns the index of the pixel i of a bitmap of width n, when it is tiled.
+static int tile_index(SkShader::TileMode mode, int i, int n) {
+    switch (mode) {
+        case SkShader::kClamp_TileMode:
+            return SkPin32(i, 0, n - 1);
+        case SkShader::kRepeat_TileMode:
+            return ((i % n) + n) % n;
+        default:
+            i = ((i % (2 * n)) + 2 * n) % (2 * n);
+            return i < n ? i : 2 * n - 1 - i;
+    }
+}
+
+static SkPMColor get_tiled_color(const SkBitmap& bm, SkShader::TileMode mode,
+                                 int x, int y) {
+    x = tile_index(mode, x, bm.width());
+    y = tile_index(mode, y, bm.height());
+    return bm.getConfig() == SkBitmap::kIndex8_Config ?
+        bm.getIndex8Color(x, y) : *bm.getAddr32(x, y);
+}
+
+// The expected color of a sample at (x, y) in 1/16 pixels: the bilerp of the
+// 4 nearest pixels with 4 bits of weight, or the one it falls in.
+static SkPMColor expected_color(const SkBitmap& bm, SkShader::TileMode mode,
+                                bool filter, int x, int y) {
+    if (!filter) {
+        return get_tiled_color(bm, mode, x >> 4, y >> 4);
+    }
+    x -= 8;
+    y -= 8;
+    int subX = x & 0xF;
+    int subY = y & 0xF;
+    SkPMColor c00 = get_tiled_color(bm, mode, x >> 4, y >> 4);
+    SkPMColor c01 = get_tiled_color(bm, mode, (x >> 4) + 1, y >> 4);
+    SkPMColor c10 = get_tiled_color(bm, mode, x >> 4, (y >> 4) + 1);
+    SkPMColor c11 = get_tiled_color(bm, mode, (x >> 4) + 1, (y >> 4) + 1);
+    SkPMColor result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        unsigned sum = ((c00 >> shift) & 0xFF) * (16 - subX) * (16 - subY) +
+                       ((c01 >> shift) & 0xFF) * subX * (16 - subY) +
+                       ((c10 >> shift) & 0xFF) * (16 - subX) * subY +
+                       ((c11 >> shift) & 0xFF) * subX * subY;
+        result |= (sum >> 8) << shift;
+    }
+    return result;
+}
+
+// Scale only bitmap shaders have their own shaderprocs (which do the work of
+// the matrix and sample procs in one pass). Draw with scales and
+// translations which are exact in fixed point, and compare the results with
+// the expected ones.
+static void test_scale_shaderprocs(skiatest::Reporter* reporter) {
+    static const int kSize = 16;
+    static const int kDstSize = 40;
+
+    SkMWCRandom rand;
+    SkPMColor colors[256];
+    for (int i = 0; i < 256; ++i) {
+        colors[i] = SkPreMultiplyColor(rand.nextU() | 0xFF000000);
+    }
+
+    SkBitmap srcs[2];
+    srcs[0].setConfig(SkBitmap::kARGB_8888_Config, kSize, kSize);
+    srcs[0].allocPixels();
+    SkColorTable* ctable = new SkColorTable(colors, 256);
+    srcs[1].setConfig(SkBitmap::kIndex8_Config, kSize, kSize);
+    srcs[1].allocPixels(ctable);
+    ctable->unref();
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            unsigned index = rand.nextU() & 0xFF;
+            *srcs[0].getAddr32(x, y) = colors[index];
+            *srcs[1].getAddr8(x, y) = index;
+        }
+    }
+
+    SkBitmap dst;
+    dst.setConfig(SkBitmap::kARGB_8888_Config, kDstSize, kDstSize);
+    dst.allocPixels();
+    SkCanvas canvas(dst);
+
+    static const SkShader::TileMode gModes[] = {
+        SkShader::kClamp_TileMode,
+        SkShader::kRepeat_TileMode,
+        SkShader::kMirror_TileMode,
+    };
+    // the scale is 1 << log2Scale, or 1 / (1 << -log2Scale)
+    static const int gLog2Scales[] = { 1, 2, -1 };
+    static const int gTranslates[] = { 0, 3, -21 };
+
+    for (size_t s = 0; s < SK_ARRAY_COUNT(srcs); ++s) {
+        for (size_t m = 0; m < SK_ARRAY_COUNT(gModes); ++m) {
+            SkShader* shader = SkShader::CreateBitmapShader(srcs[s], gModes[m], gModes[m]);
+            SkPaint paint;
+            paint.setShader(shader)->unref();
+            for (int filter = 0; filter < 2; ++filter) {
+                paint.setFilterBitmap(SkToBool(filter));
+                for (size_t i = 0; i < SK_ARRAY_COUNT(gLog2Scales); ++i) {
+                    for (size_t t = 0; t < SK_ARRAY_COUNT(gTranslates); ++t) {
+                        int log2Scale = gLog2Scales[i];
+                        int translate = gTranslates[t];
+                        SkScalar scale = log2Scale > 0 ? SkIntToScalar(1 << log2Scale)
+                                                       : SK_Scalar1 / (1 << -log2Scale);
+                        SkMatrix matrix;
+                        matrix.setScale(scale, scale);
+                        matrix.postTranslate(SkIntToScalar(translate), SkIntToScalar(translate));
+                        shader->setLocalMatrix(matrix);
+
+                        dst.eraseColor(0);
+                        canvas.drawPaint(paint);
+
+                        bool ok = true;
+                        for (int y = 0; y < kDstSize && ok; ++y) {
+                            for (int x = 0; x < kDstSize && ok; ++x) {
+                                // the center of the pixel in the bitmap, in 1/16 pixels
+                                int srcX = (32 * (x - translate) + 16);
+                                int srcY = (32 * (y - translate) + 16);
+                                if (log2Scale > 0) {
+                                    srcX >>= log2Scale + 1;
+                                    srcY >>= log2Scale + 1;
+                                } else {
+                                    srcX <<= -log2Scale - 1;
+                                    srcY <<= -log2Scale - 1;
+                                }
+                                ok = *dst.getAddr32(x, y) ==
+                                     expected_color(srcs[s], gModes[m], SkToBool(filter),
+                                                    srcX, srcY);
+                            }
+                        }
+                        REPORTER_ASSERT(reporter, ok);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Clamp nofilter scales must sample the same pixels as the clamp matrixproc,
+// which steps through x in SkFixed when the whole span is inside the bitmap.
+// Draw such spans at scales which are not exact in fixed point, and compare
+// them with the pixels that the SkFixed steps land on.
+static void test_clamp_nofilter_scale(skiatest::Reporter* reporter) {
+    static const int kSize = 16;
+
+    SkBitmap src;
+    src.setConfig(SkBitmap::kARGB_8888_Config, kSize, 1);
+    src.allocPixels();
+    for (int x = 0; x < kSize; ++x) {
+        *src.getAddr32(x, 0) = SkPackARGB32(0xFF, x, x, x);
+    }
+
+    SkBitmap dst;
+    dst.setConfig(SkBitmap::kARGB_8888_Config, 4 * kSize, 1);
+    dst.allocPixels();
+    SkCanvas canvas(dst);
+
+    SkShader* shader = SkShader::CreateBitmapShader(src, SkShader::kClamp_TileMode,
+                                                    SkShader::kClamp_TileMode);
+    SkPaint paint;
+    paint.setShader(shader)->unref();
+
+    for (int width = kSize + 1; width <= 4 * kSize; ++width) {
+        SkMatrix matrix;
+        matrix.setScale(SkIntToScalar(width) / kSize, SK_Scalar1);
+        shader->setLocalMatrix(matrix);
+
+        // stop before the last pixel of src, so the span is never clamped
+        const int count = (kSize - 1) * width / kSize;
+        dst.eraseColor(0);
+        canvas.drawRect(SkRect::MakeWH(SkIntToScalar(count), SK_Scalar1), paint);
+
+        SkMatrix inv;
+        REPORTER_ASSERT(reporter, matrix.invert(&inv));
+        SkPoint pt;
+        inv.mapXY(SK_ScalarHalf, SK_ScalarHalf, &pt);
+        SkFixed fx = SkScalarToFixed(pt.fX);
+        const SkFixed dx = SkScalarToFixed(inv.getScaleX());
+
+        bool ok = true;
+        for (int x = 0; x < count; ++x) {
+            ok &= *dst.getAddr32(x, 0) == *src.getAddr32(fx >> 16, 0);
+            fx += dx;
+        }
+        REPORTER_ASSERT(reporter, ok);
+    }
+}
+
 static const int gWidth = 256;
 static const int gHeight = 256;
 
@@ -268,6 +456,8 @@ static void TestDrawBitmapRect(skiatest::Reporter* reporter) {
     test_giantrepeat_crbug118018(reporter);
 
     test_treatAsSprite(reporter);
+    test_scale_shaderprocs(reporter);
+    test_clamp_nofilter_scale(reporter);
 }
 
 #include "TestClassDef.h"
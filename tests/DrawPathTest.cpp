@@ -8,6 +8,7 @@
 #include "Test.h"
 #include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkCornerPathEffect.h"
 #include "SkDashPathEffect.h"
 #include "SkSurface.h"
 
@@ -308,6 +309,96 @@ static void test_crbug_165432(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, filteredPath.isEmpty());
 }
 
+static void draw_clipped(const SkPath& path, const SkRect& clip, SkBitmap* bm) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, 200, 200);
+    bm->allocPixels();
+    bm->eraseColor(SK_ColorTRANSPARENT);
+
+    SkCanvas canvas(*bm);
+    canvas.clipRect(clip);
+    SkPaint paint;
+    canvas.drawPath(path, paint);
+}
+
+// Dashes that are not a single line are stroked one at a time, and the ones outside of the
+// cull rect are dropped.
+static void test_dash_segments(skiatest::Reporter* reporter) {
+    SkPath path;
+    path.moveTo(10, 10);
+    for (int i = 1; i < 10; ++i) {
+        path.lineTo(SkIntToScalar(i * 20), SkIntToScalar(10 + (i & 1) * 40));
+    }
+    path.quadTo(200, 150, 100, 190);
+    path.lineTo(10, 100);
+
+    SkScalar intervals[] = { 12, 5 };
+    SkDashPathEffect dash(intervals, 2, 3);
+
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(4);
+    paint.setStrokeCap(SkPaint::kRound_Cap);
+    paint.setPathEffect(&dash);
+
+    // The same as dashing the whole path, and then stroking it.
+    SkStrokeRec hairlineRec(SkStrokeRec::kHairline_InitStyle);
+    SkPath dashed;
+    REPORTER_ASSERT(reporter, dash.filterPath(&dashed, path, &hairlineRec, NULL));
+    SkStrokeRec strokeRec(paint);
+    SkPath expected;
+    strokeRec.applyToPath(&expected, dashed);
+
+    SkPath actual;
+    REPORTER_ASSERT(reporter, paint.getFillPath(path, &actual));
+    REPORTER_ASSERT(reporter, actual == expected);
+
+    const SkRect cull = { 30, 20, 150, 120 };
+    SkPath culled;
+    REPORTER_ASSERT(reporter, paint.getFillPath(path, &culled, &cull));
+    REPORTER_ASSERT(reporter, culled.countPoints() > 0);
+    REPORTER_ASSERT(reporter, culled.countPoints() < actual.countPoints());
+
+    SkBitmap culledBitmap, expectedBitmap;
+    draw_clipped(culled, cull, &culledBitmap);
+    draw_clipped(expected, cull, &expectedBitmap);
+    SkAutoLockPixels alp0(culledBitmap), alp1(expectedBitmap);
+    REPORTER_ASSERT(reporter, 0 == memcmp(culledBitmap.getPixels(), expectedBitmap.getPixels(),
+                                          culledBitmap.getSize()));
+
+    // Hairlines are not stroked, but are culled.
+    paint.setStrokeWidth(0);
+    SkPath hairlineCulled;
+    REPORTER_ASSERT(reporter, !paint.getFillPath(path, &hairlineCulled, &cull));
+    REPORTER_ASSERT(reporter, hairlineCulled.countPoints() > 0);
+    REPORTER_ASSERT(reporter, hairlineCulled.countPoints() < dashed.countPoints());
+
+    // Inside a composed effect the dashes are left for the caller to stroke,
+    // so that the outer effect gets the dashes and the rec it expects.
+    paint.setStrokeWidth(4);
+    SkCornerPathEffect corner(5);
+    SkComposePathEffect compose(&corner, &dash);
+    paint.setPathEffect(&compose);
+
+    SkStrokeRec composeRec(paint);
+    SkPath cornered;
+    REPORTER_ASSERT(reporter, corner.filterPath(&cornered, dashed, &composeRec, NULL));
+    REPORTER_ASSERT(reporter, composeRec.getStyle() == SkStrokeRec::kStroke_Style);
+    composeRec.applyToPath(&expected, cornered);
+    REPORTER_ASSERT(reporter, paint.getFillPath(path, &actual));
+    REPORTER_ASSERT(reporter, actual == expected);
+
+    SkSumPathEffect sum(&dash, &corner);
+    paint.setPathEffect(&sum);
+    SkStrokeRec sumRec(paint);
+    SkPath summed;
+    REPORTER_ASSERT(reporter, sum.filterPath(&summed, path, &sumRec, NULL));
+    REPORTER_ASSERT(reporter, sumRec.getStyle() == SkStrokeRec::kStroke_Style);
+    sumRec.applyToPath(&expected, summed);
+    REPORTER_ASSERT(reporter, paint.getFillPath(path, &actual));
+    REPORTER_ASSERT(reporter, actual == expected);
+    paint.setPathEffect(NULL);
+}
+
 static void TestDrawPath(skiatest::Reporter* reporter) {
     test_giantaa();
     test_bug533();
@@ -320,6 +411,7 @@ static void TestDrawPath(skiatest::Reporter* reporter) {
     if (false) test_crbug131181();
     test_infinite_dash(reporter);
     test_crbug_165432(reporter);
+    test_dash_segments(reporter);
     test_big_aa_rect(reporter);
 }
 
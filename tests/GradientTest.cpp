@@ -12,6 +12,8 @@
 #include "SkGradientShader.h"
 #include "SkShader.h"
 #include "SkTemplates.h"
+#include "SkUnitMappers.h"
+#include "gradients/SkGradientTableCache.h"
 
 struct GradRec {
     int             fColorCount;
@@ -192,9 +194,165 @@ static void TestGradientShaders(skiatest::Reporter* reporter) {
     }
 }
 
+static uint32_t table_id(SkShader* shader) {
+    SkBitmap bitmap;
+    shader->asABitmap(&bitmap, NULL, NULL);
+    return bitmap.getGenerationID();
+}
+
+static void draw_gradient(SkShader* shader, U8CPU alpha, SkBitmap* result) {
+    result->setConfig(SkBitmap::kARGB_8888_Config, 40, 4);
+    result->allocPixels();
+    result->eraseColor(SK_ColorTRANSPARENT);
+    SkPaint paint;
+    paint.setShader(shader);
+    paint.setAlpha(alpha);
+    paint.setDither(true);
+    SkBitmapDevice device(*result);
+    SkCanvas canvas(&device);
+    canvas.drawPaint(paint);
+}
+
+static bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels alpA(a), alpB(b);
+    return 0 == memcmp(a.getPixels(), b.getPixels(), a.getSize());
+}
+
+// Ensure that equal gradients share their color tables, and that the shared tables match
+// freshly built ones.
+static void TestGradientTableCache(skiatest::Reporter* reporter) {
+    const SkPoint pts[] = {
+        { 0, 0 },
+        { SkIntToScalar(40), 0 }
+    };
+    const SkPoint otherPts[] = {
+        { SkIntToScalar(5), 0 },
+        { SkIntToScalar(30), SkIntToScalar(4) }
+    };
+    const SkColor colors[] = { SK_ColorRED, 0x8000FF00, SK_ColorBLUE };
+    const SkColor otherColors[] = { SK_ColorRED, 0x8000FF00, SK_ColorBLACK };
+    const SkScalar pos[] = { 0, SkFloatToScalar(0.3f), SK_Scalar1 };
+
+    SkGradientTableCache::PurgeAll();
+    SkAutoTUnref<SkShader> a(SkGradientShader::CreateLinear(pts, colors, pos, 3,
+                                                            SkShader::kClamp_TileMode));
+    SkAutoTUnref<SkShader> b(SkGradientShader::CreateLinear(otherPts, colors, pos, 3,
+                                                            SkShader::kMirror_TileMode));
+    SkAutoTUnref<SkShader> c(SkGradientShader::CreateLinear(pts, otherColors, pos, 3,
+                                                            SkShader::kClamp_TileMode));
+    SkAutoTUnref<SkShader> d(SkGradientShader::CreateLinear(pts, colors, NULL, 3,
+                                                            SkShader::kClamp_TileMode));
+    REPORTER_ASSERT(reporter, table_id(a) == table_id(b));
+    REPORTER_ASSERT(reporter, table_id(a) != table_id(c));
+    REPORTER_ASSERT(reporter, table_id(a) != table_id(d));
+
+    // Mappers are part of the key.
+    SkAutoTUnref<SkUnitMapper> mapper4(SkNEW_ARGS(SkDiscreteMapper, (4)));
+    SkAutoTUnref<SkUnitMapper> otherMapper4(SkNEW_ARGS(SkDiscreteMapper, (4)));
+    SkAutoTUnref<SkUnitMapper> mapper5(SkNEW_ARGS(SkDiscreteMapper, (5)));
+    SkAutoTUnref<SkShader> e(SkGradientShader::CreateLinear(pts, colors, pos, 3,
+                                                            SkShader::kClamp_TileMode,
+                                                            mapper4));
+    SkAutoTUnref<SkShader> f(SkGradientShader::CreateLinear(pts, colors, pos, 3,
+                                                            SkShader::kClamp_TileMode,
+                                                            otherMapper4));
+    SkAutoTUnref<SkShader> g(SkGradientShader::CreateLinear(pts, colors, pos, 3,
+                                                            SkShader::kClamp_TileMode,
+                                                            mapper5));
+    REPORTER_ASSERT(reporter, table_id(e) == table_id(f));
+    REPORTER_ASSERT(reporter, table_id(e) != table_id(a));
+    REPORTER_ASSERT(reporter, table_id(e) != table_id(g));
+
+    // Drawing with tables from the cache, at several alphas, matches drawing with new ones.
+    static const U8CPU gAlphas[] = { 0xFF, 0x80, 0xFF, 0x33 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gAlphas); ++i) {
+        SkBitmap cached, built;
+        draw_gradient(a, gAlphas[i], &cached);
+        SkGradientTableCache::PurgeAll();
+        SkAutoTUnref<SkShader> fresh(SkGradientShader::CreateLinear(pts, colors, pos, 3,
+                                                                    SkShader::kClamp_TileMode));
+        draw_gradient(fresh, gAlphas[i], &built);
+        REPORTER_ASSERT(reporter, same_pixels(cached, built));
+
+        SkGradientTableCache::Stats before, after;
+        SkGradientTableCache::GetStats(&before);
+        SkAutoTUnref<SkShader> again(SkGradientShader::CreateLinear(pts, colors, pos, 3,
+                                                                    SkShader::kClamp_TileMode));
+        draw_gradient(again, gAlphas[i], &built);
+        SkGradientTableCache::GetStats(&after);
+        REPORTER_ASSERT(reporter, after.fHits == before.fHits + 1);
+        REPORTER_ASSERT(reporter, same_pixels(cached, built));
+    }
+}
+
+// Shade each row in one span, and again in spans of 1 to 9 pixels. Since the gradients below
+// map pixels to exactly representable positions, the results must match, which checks that
+// the span procs handle their dither rows and leftover pixels correctly.
+static void test_span_splits(skiatest::Reporter* reporter, SkShader* shader) {
+    const int kWidth = 80;
+    SkBitmap device;
+    device.setConfig(SkBitmap::kARGB_8888_Config, kWidth, 4);
+    SkPaint paint;
+    paint.setDither(true);
+    bool setContext = shader->setContext(device, paint, SkMatrix::I());
+    REPORTER_ASSERT(reporter, setContext);
+    if (!setContext) {
+        return;
+    }
+    for (int y = 0; y < device.height(); ++y) {
+        SkPMColor whole[kWidth], pieces[kWidth];
+        shader->shadeSpan(0, y, whole, kWidth);
+        for (int n = 1; n <= 9; ++n) {
+            for (int x = 0; x < kWidth; x += n) {
+                shader->shadeSpan(x, y, pieces + x, SkMin32(n, kWidth - x));
+            }
+            REPORTER_ASSERT(reporter, 0 == memcmp(whole, pieces, sizeof(whole)));
+        }
+    }
+    shader->endContext();
+}
+
+static void TestGradientSpans(skiatest::Reporter* reporter) {
+    const SkColor colors[] = { SK_ColorRED, 0x8000FF00, SK_ColorBLUE, SK_ColorWHITE };
+    const SkPoint linearPts[] = {
+        { SkIntToScalar(8), 0 },
+        { SkIntToScalar(24), 0 }
+    };
+    // The clamped ends of a linear gradient are shaded separately, so keep them out of view.
+    const SkPoint clampPts[] = {
+        { SkIntToScalar(-24), 0 },
+        { SkIntToScalar(104), 0 }
+    };
+    const SkPoint center = { SkIntToScalar(40), SkIntToScalar(2) };
+    const SkPoint start = { SkIntToScalar(32), SkIntToScalar(2) };
+
+    static const SkShader::TileMode gModes[] = {
+        SkShader::kClamp_TileMode,
+        SkShader::kRepeat_TileMode,
+        SkShader::kMirror_TileMode,
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gModes); ++i) {
+        SkShader::TileMode mode = gModes[i];
+        const SkPoint* pts = SkShader::kClamp_TileMode == mode ? clampPts : linearPts;
+        SkAutoTUnref<SkShader> linear(SkGradientShader::CreateLinear(pts, colors, NULL, 4,
+                                                                     mode));
+        test_span_splits(reporter, linear);
+
+        SkAutoTUnref<SkShader> radial(SkGradientShader::CreateRadial(center, SkIntToScalar(16),
+                                                                     colors, NULL, 4, mode));
+        test_span_splits(reporter, radial);
+
+        SkAutoTUnref<SkShader> conical(SkGradientShader::CreateTwoPointConical(
+                start, SkIntToScalar(4), center, SkIntToScalar(32), colors, NULL, 4, mode));
+        test_span_splits(reporter, conical);
+    }
+}
+
 static void TestGradients(skiatest::Reporter* reporter) {
     TestGradientShaders(reporter);
     TestConstantGradient(reporter);
+    TestGradientTableCache(reporter);
+    TestGradientSpans(reporter);
 }
 #include "TestClassDef.h"
 DEFINE_TESTCLASS("Gradients", TestGradientsClass, TestGradients)
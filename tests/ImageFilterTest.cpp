@@ -7,9 +7,26 @@
  */
 
 #include "Test.h"
+#include "SkBitmap.h"
+#include "SkBitmapDevice.h"
+#include "SkBlurImageFilter.h"
+#include "SkCanvas.h"
 #include "SkColorMatrixFilter.h"
 #include "SkColorFilterImageFilter.h"
+#include "SkColorPriv.h"
+#include "SkDeviceImageFilterProxy.h"
+#include "SkDisplacementMapEffect.h"
+#include "SkImageFilterCache.h"
+#include "SkImageFilterTiler.h"
+#include "SkLightingImageFilter.h"
+#include "SkMatrix.h"
+#include "SkMatrixConvolutionImageFilter.h"
+#include "SkMergeImageFilter.h"
+#include "SkMorphologyImageFilter.h"
+#include "SkOffsetImageFilter.h"
+#include "SkRandom.h"
 #include "SkRect.h"
+#include "SkUnPreMultiply.h"
 
 class ImageFilterTest {
 public:
@@ -41,7 +58,529 @@ public:
         return SkColorFilterImageFilter::Create(filter, input);
     }
 
+    // The direct O(radius) morphology, clamping the window to the image.
+    static SkPMColor morph_ref(const SkBitmap& src, int x, int y, int rx, int ry, bool dilate) {
+        int result[4];
+        for (int c = 0; c < 4; ++c) {
+            result[c] = dilate ? 0 : 255;
+        }
+        for (int sy = SkMax32(0, y - ry); sy <= SkMin32(src.height() - 1, y + ry); ++sy) {
+            for (int sx = SkMax32(0, x - rx); sx <= SkMin32(src.width() - 1, x + rx); ++sx) {
+                SkPMColor p = *src.getAddr32(sx, sy);
+                for (int c = 0; c < 4; ++c) {
+                    int v = (p >> (8 * c)) & 0xFF;
+                    result[c] = dilate ? SkMax32(result[c], v) : SkMin32(result[c], v);
+                }
+            }
+        }
+        return result[0] | (result[1] << 8) | (result[2] << 16) | (result[3] << 24);
+    }
+
+    static void test_morphology(skiatest::Reporter* reporter) {
+        SkBitmap src;
+        src.setConfig(SkBitmap::kARGB_8888_Config, 37, 23);
+        src.allocPixels();
+        SkMWCRandom rand;
+        for (int y = 0; y < src.height(); ++y) {
+            for (int x = 0; x < src.width(); ++x) {
+                U8CPU a = rand.nextU() & 0xFF;
+                *src.getAddr32(x, y) = SkPackARGB32(a, rand.nextULessThan(a + 1),
+                                                    rand.nextULessThan(a + 1),
+                                                    rand.nextULessThan(a + 1));
+            }
+        }
+
+        static const SkIPoint gRadii[] = {
+            { 1, 0 }, { 0, 2 }, { 3, 5 }, { 7, 1 }, { 20, 40 },
+        };
+        for (size_t i = 0; i < SK_ARRAY_COUNT(gRadii); ++i) {
+            for (int dilate = 0; dilate < 2; ++dilate) {
+                int rx = gRadii[i].fX, ry = gRadii[i].fY;
+                SkAutoTUnref<SkImageFilter> filter(dilate ?
+                    static_cast<SkImageFilter*>(new SkDilateImageFilter(rx, ry)) :
+                    static_cast<SkImageFilter*>(new SkErodeImageFilter(rx, ry)));
+                SkBitmap dst;
+                SkIPoint offset = SkIPoint::Make(0, 0);
+                REPORTER_ASSERT(reporter, filter->filterImage(NULL, src, SkMatrix::I(),
+                                                              &dst, &offset));
+                SkAutoLockPixels alp(dst);
+                bool match = true;
+                for (int y = 0; y < src.height(); ++y) {
+                    for (int x = 0; x < src.width(); ++x) {
+                        match &= *dst.getAddr32(x, y) == morph_ref(src, x, y, rx, ry, dilate != 0);
+                    }
+                }
+                REPORTER_ASSERT(reporter, match);
+            }
+        }
+    }
+
+    // Checks that filtering tile by tile gives the same pixels as filtering in one piece.
+    static void test_tiled(skiatest::Reporter* reporter) {
+        SkBitmap src;
+        src.setConfig(SkBitmap::kARGB_8888_Config, 203, 151);
+        src.allocPixels();
+        src.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas srcCanvas(src);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        SkMWCRandom rand;
+        for (int i = 0; i < 20; ++i) {
+            paint.setColor(rand.nextU() | 0xFF000000);
+            srcCanvas.drawCircle(rand.nextUScalar1() * 203, rand.nextUScalar1() * 151,
+                                 rand.nextUScalar1() * 40, paint);
+        }
+
+        SkPoint3 direction(SK_Scalar1, SK_Scalar1, SK_Scalar1);
+        SkAutoTUnref<SkImageFilter> lighting(SkLightingImageFilter::CreateDistantLitDiffuse(
+            direction, SK_ColorWHITE, SkIntToScalar(2), SK_Scalar1));
+        SkAutoTUnref<SkImageFilter> blur(new SkBlurImageFilter(SkIntToScalar(3),
+                                                               SkIntToScalar(2), lighting));
+        SkAutoTUnref<SkImageFilter> dilate(new SkDilateImageFilter(2, 3));
+        SkAutoTUnref<SkImageFilter> offset(new SkOffsetImageFilter(SkIntToScalar(5),
+                                                                   SkIntToScalar(-3), dilate));
+        SkAutoTUnref<SkImageFilter> merge(new SkMergeImageFilter(blur, offset));
+        SkAutoTUnref<SkImageFilter> displace(new SkDisplacementMapEffect(
+            SkDisplacementMapEffect::kR_ChannelSelectorType,
+            SkDisplacementMapEffect::kG_ChannelSelectorType, SkIntToScalar(12), merge));
+
+        SkBitmapDevice device(SkBitmap::kARGB_8888_Config, 1, 1);
+        SkDeviceImageFilterProxy proxy(&device);
+
+        SkBitmap whole;
+        SkIPoint wholeOffset = SkIPoint::Make(0, 0);
+        REPORTER_ASSERT(reporter, displace->filterImage(&proxy, src, SkMatrix::I(),
+                                                        &whole, &wholeOffset));
+
+        for (int threads = 0; threads <= 3; threads += 3) {
+            SkImageFilterTiler tiler(32, threads);
+            SkBitmap tiled;
+            SkIPoint tiledOffset = SkIPoint::Make(0, 0);
+            REPORTER_ASSERT(reporter, tiler.filterImage(displace, &proxy, src, SkMatrix::I(),
+                                                        &tiled, &tiledOffset));
+
+            // The tiled result may be larger, but only by transparent pixels.
+            SkAutoLockPixels alpWhole(whole), alpTiled(tiled);
+            SkIRect wholeBounds = SkIRect::MakeXYWH(wholeOffset.fX, wholeOffset.fY,
+                                                    whole.width(), whole.height());
+            SkIRect tiledBounds = SkIRect::MakeXYWH(tiledOffset.fX, tiledOffset.fY,
+                                                    tiled.width(), tiled.height());
+            REPORTER_ASSERT(reporter, tiledBounds.contains(wholeBounds));
+            bool match = true;
+            for (int y = tiledBounds.fTop; y < tiledBounds.fBottom; ++y) {
+                for (int x = tiledBounds.fLeft; x < tiledBounds.fRight; ++x) {
+                    SkPMColor expected = wholeBounds.contains(x, y) ?
+                        *whole.getAddr32(x - wholeBounds.fLeft, y - wholeBounds.fTop) : 0;
+                    match &= expected == *tiled.getAddr32(x - tiledBounds.fLeft,
+                                                          y - tiledBounds.fTop);
+                }
+            }
+            REPORTER_ASSERT(reporter, match);
+        }
+    }
+
+    struct LightingRef {
+        enum Light { kDistant, kPoint, kSpot } fLight;
+        bool        fSpecular;
+        SkPoint3    fPoint;         // direction of a distant light, else location
+        SkPoint3    fTarget;
+        SkScalar    fSpotExponent, fCutoffAngle;
+        SkScalar    fK, fShininess;
+    };
+
+    static void normalize(double v[3]) {
+        double scale = 1 / sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        v[0] *= scale;
+        v[1] *= scale;
+        v[2] *= scale;
+    }
+
+    static double dot(const double a[3], const double b[3]) {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    // The lighting of interior pixel (x, y) of src, in doubles.
+    static SkPMColor lighting_ref(const SkBitmap& src, int x, int y, const LightingRef& ref,
+                                  SkColor color, SkScalar surfaceScale) {
+        int m[3][3];
+        for (int j = 0; j < 3; ++j) {
+            for (int i = 0; i < 3; ++i) {
+                m[j][i] = SkGetPackedA32(*src.getAddr32(x + i - 1, y + j - 1));
+            }
+        }
+        double scale = surfaceScale / 255.0;
+        double normal[3] = {
+            -scale * (-m[0][0] + m[0][2] - 2 * m[1][0] + 2 * m[1][2] - m[2][0] + m[2][2]) / 4,
+            -scale * (-m[0][0] + m[2][0] - 2 * m[0][1] + 2 * m[2][1] - m[0][2] + m[2][2]) / 4,
+            1 };
+        normalize(normal);
+        double toLight[3] = { ref.fPoint.fX, ref.fPoint.fY, ref.fPoint.fZ };
+        if (LightingRef::kDistant != ref.fLight) {
+            toLight[0] -= x;
+            toLight[1] -= y;
+            toLight[2] -= m[1][1] * scale;
+            normalize(toLight);
+        }
+        double lightColor[3] = { (double)SkColorGetR(color), (double)SkColorGetG(color),
+                                 (double)SkColorGetB(color) };
+        if (LightingRef::kSpot == ref.fLight) {
+            double s[3] = { ref.fTarget.fX - ref.fPoint.fX, ref.fTarget.fY - ref.fPoint.fY,
+                            ref.fTarget.fZ - ref.fPoint.fZ };
+            normalize(s);
+            double cosAngle = -dot(toLight, s);
+            double cosOuter = cos(ref.fCutoffAngle * SK_ScalarPI / 180);
+            double spotScale = 0;
+            if (cosAngle >= cosOuter) {
+                spotScale = pow(cosAngle, (double)ref.fSpotExponent);
+                if (cosAngle < cosOuter + 0.016) {
+                    spotScale *= (cosAngle - cosOuter) / 0.016;
+                }
+            }
+            for (int i = 0; i < 3; ++i) {
+                lightColor[i] *= spotScale;
+            }
+        }
+        double colorScale;
+        if (ref.fSpecular) {
+            double halfDir[3] = { toLight[0], toLight[1], toLight[2] + 1 };
+            normalize(halfDir);
+            colorScale = ref.fK * pow(dot(normal, halfDir), (double)ref.fShininess);
+        } else {
+            colorScale = ref.fK * dot(normal, toLight);
+        }
+        colorScale = SkTMax(0.0, SkTMin(colorScale, 1.0));
+        int c[3];
+        for (int i = 0; i < 3; ++i) {
+            c[i] = (int)floor(lightColor[i] * colorScale);
+        }
+        int a = ref.fSpecular ? SkMax32(c[0], SkMax32(c[1], c[2])) : 255;
+        return SkPackARGB32(a, c[0], c[1], c[2]);
+    }
+
+    static bool within_one(SkPMColor a, SkPMColor b) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            if (SkAbs32(((a >> shift) & 0xFF) - ((b >> shift) & 0xFF)) > 1) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Checks the interior of every kind of lighting against the reference.
+    static void test_lighting(skiatest::Reporter* reporter) {
+        SkBitmap src;
+        src.setConfig(SkBitmap::kARGB_8888_Config, 61, 43);
+        src.allocPixels();
+        SkMWCRandom rand;
+        for (int y = 0; y < src.height(); ++y) {
+            for (int x = 0; x < src.width(); ++x) {
+                int a = 128 + SkScalarRoundToInt(100 * sinf(x * 0.2f) * cosf(y * 0.3f)) +
+                        (rand.nextU() & 7);
+                *src.getAddr32(x, y) = SkPackARGB32(a, 0, 0, 0);
+            }
+        }
+
+        const SkColor color = SkColorSetRGB(0xFF, 0xE0, 0x90);
+        const SkScalar surfaceScale = SkIntToScalar(3);
+        SkPoint3 direction(SkFloatToScalar(0.3f), SkFloatToScalar(-0.5f),
+                           SkFloatToScalar(0.8f));
+        SkPoint3 location(SkIntToScalar(20), SkIntToScalar(10), SkIntToScalar(40));
+        SkPoint3 target(SkIntToScalar(40), SkIntToScalar(30), 0);
+        SkScalar spotExponent = SkFloatToScalar(2.5f), cutoff = SkIntToScalar(40);
+        SkScalar kd = SkFloatToScalar(1.5f), ks = SkFloatToScalar(1.2f);
+        SkScalar shininess = SkFloatToScalar(7.5f);
+
+        const LightingRef refs[] = {
+            { LightingRef::kDistant, false, direction, target, 0, 0, kd, 0 },
+            { LightingRef::kPoint, false, location, target, 0, 0, kd, 0 },
+            { LightingRef::kSpot, false, location, target, spotExponent, cutoff, kd, 0 },
+            { LightingRef::kDistant, true, direction, target, 0, 0, ks, shininess },
+            { LightingRef::kPoint, true, location, target, 0, 0, ks, shininess },
+            { LightingRef::kSpot, true, location, target, spotExponent, cutoff, ks, shininess },
+        };
+        SkImageFilter* filters[] = {
+            SkLightingImageFilter::CreateDistantLitDiffuse(
+                direction, color, surfaceScale, kd),
+            SkLightingImageFilter::CreatePointLitDiffuse(
+                location, color, surfaceScale, kd),
+            SkLightingImageFilter::CreateSpotLitDiffuse(
+                location, target, spotExponent, cutoff, color, surfaceScale, kd),
+            SkLightingImageFilter::CreateDistantLitSpecular(
+                direction, color, surfaceScale, ks, shininess),
+            SkLightingImageFilter::CreatePointLitSpecular(
+                location, color, surfaceScale, ks, shininess),
+            SkLightingImageFilter::CreateSpotLitSpecular(
+                location, target, spotExponent, cutoff, color, surfaceScale, ks, shininess),
+        };
+
+        SkBitmapDevice device(SkBitmap::kARGB_8888_Config, 1, 1);
+        SkDeviceImageFilterProxy proxy(&device);
+        for (size_t i = 0; i < SK_ARRAY_COUNT(refs); ++i) {
+            SkAutoTUnref<SkImageFilter> filter(filters[i]);
+            SkBitmap result;
+            SkIPoint offset = SkIPoint::Make(0, 0);
+            REPORTER_ASSERT(reporter, filter->filterImage(&proxy, src, SkMatrix::I(),
+                                                          &result, &offset));
+            REPORTER_ASSERT(reporter, result.width() == src.width() &&
+                                      result.height() == src.height());
+            SkAutoLockPixels alp(result);
+            bool match = true;
+            for (int y = 1; y < src.height() - 1; ++y) {
+                for (int x = 1; x < src.width() - 1; ++x) {
+                    match &= within_one(*result.getAddr32(x, y),
+                                        lighting_ref(src, x, y, refs[i], color, surfaceScale));
+                }
+            }
+            REPORTER_ASSERT(reporter, match);
+        }
+    }
+
+    static SkPMColor convolution_ref(const SkBitmap& src, int x, int y, const SkISize& size,
+                                     const SkScalar kernel[], SkScalar gain, SkScalar bias,
+                                     const SkIPoint& target,
+                                     SkMatrixConvolutionImageFilter::TileMode tileMode,
+                                     bool convolveAlpha) {
+        double sums[4] = { 0, 0, 0, 0 };
+        for (int cy = 0; cy < size.height(); ++cy) {
+            for (int cx = 0; cx < size.width(); ++cx) {
+                int sx = x + cx - target.fX, sy = y + cy - target.fY;
+                SkPMColor c = 0;
+                switch (tileMode) {
+                    case SkMatrixConvolutionImageFilter::kClamp_TileMode:
+                        c = *src.getAddr32(SkPin32(sx, 0, src.width() - 1),
+                                           SkPin32(sy, 0, src.height() - 1));
+                        break;
+                    case SkMatrixConvolutionImageFilter::kRepeat_TileMode:
+                        c = *src.getAddr32((sx % src.width() + src.width()) % src.width(),
+                                           (sy % src.height() + src.height()) % src.height());
+                        break;
+                    case SkMatrixConvolutionImageFilter::kClampToBlack_TileMode:
+                        if (sx >= 0 && sx < src.width() && sy >= 0 && sy < src.height()) {
+                            c = *src.getAddr32(sx, sy);
+                        }
+                        break;
+                }
+                if (!convolveAlpha) {
+                    SkColor u = SkUnPreMultiply::PMColorToColor(c);
+                    c = SkPackARGB32NoCheck(SkColorGetA(u), SkColorGetR(u), SkColorGetG(u),
+                                            SkColorGetB(u));
+                }
+                double k = SkScalarToDouble(kernel[cy * size.width() + cx]);
+                sums[0] += SkGetPackedA32(c) * k;
+                sums[1] += SkGetPackedR32(c) * k;
+                sums[2] += SkGetPackedG32(c) * k;
+                sums[3] += SkGetPackedB32(c) * k;
+            }
+        }
+        int c[4];
+        for (int i = 0; i < 4; ++i) {
+            double v = floor(sums[i] * SkScalarToDouble(gain) + SkScalarToDouble(bias));
+            c[i] = (int)SkTMax(0.0, SkTMin(v, 255.0));
+        }
+        int a = convolveAlpha ? c[0] : 255;
+        for (int i = 1; i < 4; ++i) {
+            c[i] = SkMin32(c[i], a);
+        }
+        if (!convolveAlpha) {
+            return SkPreMultiplyARGB(SkGetPackedA32(*src.getAddr32(x, y)), c[1], c[2], c[3]);
+        }
+        return SkPackARGB32(a, c[1], c[2], c[3]);
+    }
+
+    // Checks small, separable and generic kernels against the reference, in every tile mode.
+    static void test_matrix_convolution(skiatest::Reporter* reporter) {
+        SkBitmap src;
+        src.setConfig(SkBitmap::kARGB_8888_Config, 37, 29);
+        src.allocPixels();
+        SkMWCRandom rand;
+        for (int y = 0; y < src.height(); ++y) {
+            for (int x = 0; x < src.width(); ++x) {
+                *src.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU() | 0x40000000);
+            }
+        }
+
+        // A sharpening 3x3, binomial 5x5 and 7x5 (separable), and a generic 4x4.
+        static const float k3x3[] = { 0, -1, 0, -1, 5, -1, 0, -1, 0 };
+        static const float b5[] = { 1, 4, 6, 4, 1 };
+        static const float b7[] = { 1, 6, 15, 20, 15, 6, 1 };
+            float k5x5[25], k7x5[35], k4x4[16];
+        for (int i = 0; i < 25; ++i) {
+            k5x5[i] = b5[i / 5] * b5[i % 5];
+        }
+        for (int i = 0; i < 35; ++i) {
+            k7x5[i] = b5[i / 7] * b7[i % 7];
+        }
+        for (int i = 0; i < 16; ++i) {
+            k4x4[i] = (float)((i * 7) % 5) - 1;
+        }
+        const struct {
+            SkISize fSize;
+            const float* fKernel;
+            float fGain;
+            SkIPoint fTarget;
+        } kernels[] = {
+            { SkISize::Make(3, 3), k3x3, 1, SkIPoint::Make(1, 1) },
+            { SkISize::Make(5, 5), k5x5, 1 / 256.0f, SkIPoint::Make(2, 2) },
+            { SkISize::Make(7, 5), k7x5, 1 / 1024.0f, SkIPoint::Make(5, 0) },
+            { SkISize::Make(4, 4), k4x4, 0.25f, SkIPoint::Make(1, 2) },
+        };
+        static const SkMatrixConvolutionImageFilter::TileMode gModes[] = {
+            SkMatrixConvolutionImageFilter::kClamp_TileMode,
+            SkMatrixConvolutionImageFilter::kRepeat_TileMode,
+            SkMatrixConvolutionImageFilter::kClampToBlack_TileMode,
+        };
+
+        SkBitmapDevice device(SkBitmap::kARGB_8888_Config, 1, 1);
+        SkDeviceImageFilterProxy proxy(&device);
+        for (size_t i = 0; i < SK_ARRAY_COUNT(kernels); ++i) {
+            SkScalar kernel[35];
+            for (int j = 0; j < kernels[i].fSize.width() * kernels[i].fSize.height(); ++j) {
+                kernel[j] = SkFloatToScalar(kernels[i].fKernel[j]);
+            }
+            SkScalar gain = SkFloatToScalar(kernels[i].fGain);
+            SkScalar bias = SkIntToScalar(3);
+            for (size_t mode = 0; mode < SK_ARRAY_COUNT(gModes); ++mode) {
+                for (int convolveAlpha = 0; convolveAlpha < 2; ++convolveAlpha) {
+                    SkAutoTUnref<SkImageFilter> filter(new SkMatrixConvolutionImageFilter(
+                        kernels[i].fSize, kernel, gain, bias, kernels[i].fTarget, gModes[mode],
+                        SkToBool(convolveAlpha)));
+                    SkBitmap result;
+                    SkIPoint offset = SkIPoint::Make(0, 0);
+                    REPORTER_ASSERT(reporter, filter->filterImage(&proxy, src, SkMatrix::I(),
+                                                                  &result, &offset));
+                    REPORTER_ASSERT(reporter, result.width() == src.width() &&
+                                              result.height() == src.height());
+                    SkAutoLockPixels alp(result);
+                    bool match = true;
+                    for (int y = 0; y < src.height(); ++y) {
+                        for (int x = 0; x < src.width(); ++x) {
+                            match &= within_one(*result.getAddr32(x, y),
+                                convolution_ref(src, x, y, kernels[i].fSize, kernel, gain, bias,
+                                                kernels[i].fTarget, gModes[mode],
+                                                SkToBool(convolveAlpha)));
+                        }
+                    }
+                    REPORTER_ASSERT(reporter, match);
+                }
+            }
+        }
+    }
+
+    static bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+        if (a.width() != b.width() || a.height() != b.height()) {
+            return false;
+        }
+        SkAutoLockPixels alpA(a), alpB(b);
+        for (int y = 0; y < a.height(); ++y) {
+            if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * sizeof(SkPMColor))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void test_cache(skiatest::Reporter* reporter) {
+        SkBitmap src;
+        src.setConfig(SkBitmap::kARGB_8888_Config, 64, 48);
+        src.allocPixels();
+        src.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas srcCanvas(src);
+        SkPaint paint;
+        paint.setColor(SK_ColorRED);
+        srcCanvas.drawCircle(SkIntToScalar(30), SkIntToScalar(20), SkIntToScalar(15), paint);
+
+        // The blur is shared by both inputs of the merge.
+        SkAutoTUnref<SkImageFilter> blur(new SkBlurImageFilter(SkIntToScalar(2),
+                                                               SkIntToScalar(2)));
+        SkAutoTUnref<SkImageFilter> merge(new SkMergeImageFilter(blur, blur));
+
+        SkAutoTUnref<SkImageFilterCache> cache(new SkImageFilterCache(1024 * 1024));
+        SkBitmapDevice device(SkBitmap::kARGB_8888_Config, 1, 1);
+        SkDeviceImageFilterProxy uncachedProxy(&device);
+        SkDeviceImageFilterProxy proxy(&device, cache);
+
+        SkBitmap expected;
+        SkIPoint expectedOffset = SkIPoint::Make(0, 0);
+        REPORTER_ASSERT(reporter, merge->filterImage(&uncachedProxy, src, SkMatrix::I(),
+                                                     &expected, &expectedOffset));
+
+        SkImageFilterCache::Stats stats;
+        SkBitmap result;
+        SkIPoint offset = SkIPoint::Make(0, 0);
+        REPORTER_ASSERT(reporter, merge->filterImage(&proxy, src, SkMatrix::I(),
+                                                     &result, &offset));
+        cache->getStats(&stats);
+        REPORTER_ASSERT(reporter, 1 == stats.fHits);    // the second use of the blur
+        REPORTER_ASSERT(reporter, 2 == stats.fMisses);
+        REPORTER_ASSERT(reporter, 2 == stats.fCount);
+        REPORTER_ASSERT(reporter, expectedOffset == offset);
+        REPORTER_ASSERT(reporter, same_pixels(expected, result));
+
+        // The offset of a hit is relative to the offset passed in.
+        offset.set(7, -3);
+        REPORTER_ASSERT(reporter, merge->filterImage(&proxy, src, SkMatrix::I(),
+                                                     &result, &offset));
+        cache->getStats(&stats);
+        REPORTER_ASSERT(reporter, 2 == stats.fHits);
+        REPORTER_ASSERT(reporter, 2 == stats.fMisses);
+        REPORTER_ASSERT(reporter, expectedOffset + SkIPoint::Make(7, -3) == offset);
+        REPORTER_ASSERT(reporter, same_pixels(expected, result));
+
+        // A different matrix misses.
+        SkMatrix matrix;
+        matrix.setScale(SK_Scalar1 / 2, SK_Scalar1 / 2);
+        offset.set(0, 0);
+        REPORTER_ASSERT(reporter, merge->filterImage(&proxy, src, matrix, &result, &offset));
+        cache->getStats(&stats);
+        REPORTER_ASSERT(reporter, 3 == stats.fHits);
+        REPORTER_ASSERT(reporter, 4 == stats.fMisses);
+
+        // Changing the pixels of src misses, and gives the new result.
+        srcCanvas.drawCircle(SkIntToScalar(10), SkIntToScalar(30), SkIntToScalar(8), paint);
+        expectedOffset.set(0, 0);
+        REPORTER_ASSERT(reporter, merge->filterImage(&uncachedProxy, src, SkMatrix::I(),
+                                                     &expected, &expectedOffset));
+        offset.set(0, 0);
+        REPORTER_ASSERT(reporter, merge->filterImage(&proxy, src, SkMatrix::I(),
+                                                     &result, &offset));
+        cache->getStats(&stats);
+        REPORTER_ASSERT(reporter, 4 == stats.fHits);
+        REPORTER_ASSERT(reporter, 6 == stats.fMisses);
+        REPORTER_ASSERT(reporter, same_pixels(expected, result));
+
+        // Shrinking the budget evicts the least recently used results.
+        size_t resultSize = result.getSize();
+        cache->setByteLimit(4 * resultSize + 1024);
+        cache->getStats(&stats);
+        REPORTER_ASSERT(reporter, stats.fBytesUsed <= 4 * resultSize + 1024);
+        REPORTER_ASSERT(reporter, stats.fCount < 6);
+        cache->purgeAll();
+        cache->getStats(&stats);
+        REPORTER_ASSERT(reporter, 0 == stats.fCount);
+        REPORTER_ASSERT(reporter, 0 == stats.fBytesUsed);
+
+        // Drawing through a canvas uses its cache.
+        SkBitmap dst;
+        dst.setConfig(SkBitmap::kARGB_8888_Config, 100, 100);
+        dst.allocPixels();
+        SkCanvas canvas(dst);
+        canvas.setImageFilterCache(cache);
+        SkPaint filterPaint;
+        filterPaint.setImageFilter(merge);
+        canvas.drawSprite(src, 10, 10, &filterPaint);
+        canvas.drawSprite(src, 10, 10, &filterPaint);
+        SkImageFilterCache::Stats canvasStats;
+        cache->getStats(&canvasStats);
+        REPORTER_ASSERT(reporter, stats.fHits + 2 == canvasStats.fHits);
+    }
+
     static void Test(skiatest::Reporter* reporter) {
+        test_morphology(reporter);
+        test_tiled(reporter);
+        test_cache(reporter);
+        test_lighting(reporter);
+        test_matrix_convolution(reporter);
+
         {
             // Check that two non-clipping color matrices concatenate into a single filter.
             SkAutoTUnref<SkImageFilter> halfBrightness(make_scale(0.5f));
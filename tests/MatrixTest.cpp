@@ -679,6 +679,81 @@ static void test_matrix_homogeneous(skiatest::Reporter* reporter) {
 
 }
 
+// mapPoints() and mapPointsWithBounds() use platform procs when there are enough
+// points; check that they match the portable procs exactly, including the
+// leftover points and mapping in place.
+static void test_matrix_map_points(skiatest::Reporter* reporter) {
+    SkMatrix mats[8];
+    mats[0].setTranslate(10, -20);
+    mats[1].setScale(3, SK_Scalar1 / 3);
+    mats[2].setScale(-2, 5, 7, 11);
+    mats[3].setRotate(30);
+    mats[4].setRotate(-45, 10, 20);
+    mats[5].setSkew(SK_Scalar1 / 2, 2);
+    mats[5].preScale(3, 4);
+    mats[6].setRotate(60, 50, 50);
+    mats[6].setPerspX(SkScalarToPersp(SK_Scalar1 / 1000));
+    mats[7].setTranslate(5, 5);
+    mats[7].setPerspY(SkScalarToPersp(-SK_Scalar1 / 100));
+
+    const int kMaxCount = 19;
+    SkMWCRandom rand;
+    SkPoint src[kMaxCount];
+    for (int i = 0; i < kMaxCount; ++i) {
+        src[i].set(rand.nextRangeScalar(-300, 300), rand.nextRangeScalar(-300, 300));
+    }
+    // points that map to z == 0 for mats[7]
+    src[5].set(0, 100);
+#ifdef SK_SCALAR_IS_FLOAT
+    // denormals, which must not be flushed to zero, in the first group of four
+    // and a later one
+    src[2].set(1e-39f, -3e-40f);
+    src[9].set(-2e-39f, 5e-41f);
+#endif
+
+    for (size_t m = 0; m < SK_ARRAY_COUNT(mats); ++m) {
+        const SkMatrix& mat = mats[m];
+        SkMatrix::MapPtsProc portable = SkMatrix::GetMapPtsProc(mat.getType());
+        for (int count = 0; count <= kMaxCount; ++count) {
+            SkPoint expected[kMaxCount], dst[kMaxCount];
+            portable(mat, expected, src, count);
+
+            mat.mapPoints(dst, src, count);
+            REPORTER_ASSERT(reporter, !memcmp(expected, dst, count * sizeof(SkPoint)));
+
+            memcpy(dst, src, sizeof(src));
+            mat.mapPoints(dst, count);
+            REPORTER_ASSERT(reporter, !memcmp(expected, dst, count * sizeof(SkPoint)));
+
+            if (count > 0) {
+                SkRect expectedBounds, bounds;
+                bool expectedFinite = expectedBounds.setBoundsCheck(expected, count);
+                bool isFinite = mat.mapPointsWithBounds(dst, src, count, &bounds);
+                REPORTER_ASSERT(reporter, !memcmp(expected, dst, count * sizeof(SkPoint)));
+                REPORTER_ASSERT(reporter, expectedFinite == isFinite);
+                REPORTER_ASSERT(reporter, expectedBounds == bounds);
+            }
+        }
+    }
+
+#ifdef SK_SCALAR_IS_FLOAT
+    // a point that is not finite, in the first group of four, a later one, or
+    // the leftovers, makes the bounds empty
+    for (int bad = 0; bad < kMaxCount; bad += 5) {
+        SkPoint pts[kMaxCount];
+        memcpy(pts, src, sizeof(src));
+        pts[bad].fY = SK_ScalarInfinity;
+        for (size_t m = 0; m < SK_ARRAY_COUNT(mats); ++m) {
+            SkRect bounds;
+            SkPoint dst[kMaxCount];
+            REPORTER_ASSERT(reporter,
+                            !mats[m].mapPointsWithBounds(dst, pts, kMaxCount, &bounds));
+            REPORTER_ASSERT(reporter, bounds.isEmpty());
+        }
+    }
+#endif
+}
+
 static void TestMatrix(skiatest::Reporter* reporter) {
     SkMatrix    mat, inverse, iden1, iden2;
 
@@ -801,6 +876,7 @@ static void TestMatrix(skiatest::Reporter* reporter) {
     test_matrix_recttorect(reporter);
     test_matrix_decomposition(reporter);
     test_matrix_homogeneous(reporter);
+    test_matrix_map_points(reporter);
 }
 
 #include "TestClassDef.h"
@@ -8,7 +8,10 @@
 #include "Test.h"
 #include "SkMipMap.h"
 #include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
 #include "SkRandom.h"
+#include "SkShader.h"
 
 static void make_bitmap(SkBitmap* bm, SkMWCRandom& rand) {
     // for now, Build needs a min size of 2, otherwise it will return NULL.
@@ -20,7 +23,7 @@ static void make_bitmap(SkBitmap* bm, SkMWCRandom& rand) {
     bm->eraseColor(SK_ColorWHITE);
 }
 
-static void TestMipMap(skiatest::Reporter* reporter) {
+static void test_levels(skiatest::Reporter* reporter) {
     SkBitmap bm;
     SkMWCRandom rand;
 
@@ -55,5 +58,117 @@ static void TestMipMap(skiatest::Reporter* reporter) {
     }
 }
 
+static SkPMColor average(SkPMColor a, SkPMColor b, SkPMColor c, SkPMColor d) {
+    unsigned sa = SkGetPackedA32(a) + SkGetPackedA32(b) + SkGetPackedA32(c) + SkGetPackedA32(d);
+    unsigned sr = SkGetPackedR32(a) + SkGetPackedR32(b) + SkGetPackedR32(c) + SkGetPackedR32(d);
+    unsigned sg = SkGetPackedG32(a) + SkGetPackedG32(b) + SkGetPackedG32(c) + SkGetPackedG32(d);
+    unsigned sb = SkGetPackedB32(a) + SkGetPackedB32(b) + SkGetPackedB32(c) + SkGetPackedB32(d);
+    return SkPackARGB32(sa >> 2, sr >> 2, sg >> 2, sb >> 2);
+}
+
+// Every level (including the lazily built ones, and whichever downsample
+// proc the platform uses) must be the exact 2x2 box filter of the one above.
+static void test_level_pixels(skiatest::Reporter* reporter) {
+    SkMWCRandom rand;
+
+    for (int i = 0; i < 20; ++i) {
+        SkBitmap bm;
+        bm.setConfig(SkBitmap::kARGB_8888_Config, 2 + rand.nextU() % 100,
+                     2 + rand.nextU() % 100);
+        bm.allocPixels();
+        for (int y = 0; y < bm.height(); ++y) {
+            for (int x = 0; x < bm.width(); ++x) {
+                unsigned a = rand.nextU() & 0xFF;
+                *bm.getAddr32(x, y) = SkPackARGB32(a, rand.nextU() % (a + 1),
+                                                   rand.nextU() % (a + 1),
+                                                   rand.nextU() % (a + 1));
+            }
+        }
+        SkAutoTUnref<SkMipMap> mm(SkMipMap::Build(bm));
+
+        SkAutoLockPixels alp(bm);
+        SkMipMap::Level src;
+        src.fPixels = bm.getPixels();
+        src.fRowBytes = SkToU32(bm.rowBytes());
+        src.fWidth = bm.width();
+        src.fHeight = bm.height();
+        for (int index = 1; index <= mm->countLevels(); ++index) {
+            SkMipMap::Level dst;
+            REPORTER_ASSERT(reporter, mm->getLevel(index, &dst));
+            REPORTER_ASSERT(reporter, dst.fWidth == src.fWidth / 2);
+            REPORTER_ASSERT(reporter, dst.fHeight == src.fHeight / 2);
+
+            int mismatches = 0;
+            for (uint32_t y = 0; y < dst.fHeight; ++y) {
+                const SkPMColor* s0 = (const SkPMColor*)((const char*)src.fPixels +
+                                                         2 * y * src.fRowBytes);
+                const SkPMColor* s1 = (const SkPMColor*)((const char*)s0 + src.fRowBytes);
+                const SkPMColor* d = (const SkPMColor*)((const char*)dst.fPixels +
+                                                        y * dst.fRowBytes);
+                for (uint32_t x = 0; x < dst.fWidth; ++x) {
+                    SkPMColor expected = average(s0[2 * x], s0[2 * x + 1],
+                                                 s1[2 * x], s1[2 * x + 1]);
+                    mismatches += expected != d[x];
+                }
+            }
+            REPORTER_ASSERT(reporter, 0 == mismatches);
+            src = dst;
+        }
+        REPORTER_ASSERT(reporter, !mm->getLevel(mm->countLevels() + 1, NULL));
+    }
+}
+
+// Draw bm scaled by scale with the filter level, and return the difference
+// between the lightest and darkest green values in the result.
+static int draw_and_measure_spread(const SkBitmap& bm, SkScalar scale,
+                                   SkPaint::FilterLevel filterLevel) {
+    SkBitmap dst;
+    dst.setConfig(SkBitmap::kARGB_8888_Config, 64, 64);
+    dst.allocPixels();
+    dst.eraseColor(SK_ColorWHITE);
+
+    SkCanvas canvas(dst);
+    canvas.scale(scale, scale);
+    SkPaint paint;
+    paint.setFilterLevel(filterLevel);
+    canvas.drawBitmap(bm, 0, 0, &paint);
+
+    int lo = 255, hi = 0;
+    for (int y = 8; y < 56; ++y) {
+        for (int x = 8; x < 56; ++x) {
+            int g = SkGetPackedG32(*dst.getAddr32(x, y));
+            lo = SkMin32(lo, g);
+            hi = SkMax32(hi, g);
+        }
+    }
+    return hi - lo;
+}
+
+// Columns of alternating black and white pixels average to a flat gray in
+// the first mip level. Between the two levels, medium filtering should blend
+// that in, so the stripes alias less than with plain bilerp.
+static void test_trilinear(skiatest::Reporter* reporter) {
+    SkBitmap bm;
+    bm.setConfig(SkBitmap::kARGB_8888_Config, 128, 128);
+    bm.allocPixels();
+    for (int y = 0; y < bm.height(); ++y) {
+        for (int x = 0; x < bm.width(); ++x) {
+            *bm.getAddr32(x, y) = (x & 1) ? SK_ColorWHITE : SK_ColorBLACK;
+        }
+    }
+
+    const SkScalar scale = SkFloatToScalar(0.7f);
+    int lowSpread = draw_and_measure_spread(bm, scale, SkPaint::kLow_FilterLevel);
+    int mediumSpread = draw_and_measure_spread(bm, scale, SkPaint::kMedium_FilterLevel);
+    REPORTER_ASSERT(reporter, lowSpread > 0);
+    REPORTER_ASSERT(reporter, mediumSpread < lowSpread);
+}
+
+static void TestMipMap(skiatest::Reporter* reporter) {
+    test_levels(reporter);
+    test_level_pixels(reporter);
+    test_trilinear(reporter);
+}
+
 #include "TestClassDef.h"
 DEFINE_TESTCLASS("MipMap", MipMapTestClass, TestMipMap)
@@ -0,0 +1,252 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkData.h"
+#include "SkForceLinking.h"
+#include "SkMovie.h"
+#include "SkStream.h"
+#include "SkTDArray.h"
+
+__SK_FORCE_IMAGE_DECODER_LINKING;
+
+// A frame of the test GIF: a rect of one color from the global color table.
+struct GIFFrame {
+    int fLeft, fTop, fWidth, fHeight;
+    int fColorIndex;
+    int fDisposal;  // 1: none, 2: restore to background, 3: restore to previous
+};
+
+static const SkColor gGIFColors[] = {
+    SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE, SK_ColorBLACK
+};
+static const int kGIFBackgroundIndex = 3;
+static const int kGIFSize = 8;
+static const int kGIFFrameMSec = 100;
+
+static const GIFFrame gGIFFrames[] = {
+    { 0, 0, 8, 8, 0, 1 },
+    { 0, 0, 4, 4, 1, 3 },   // restored away by the next frame
+    { 4, 4, 4, 4, 2, 1 },
+    { 0, 0, 2, 2, 2, 2 },   // cleared to the background by the next frame
+    { 6, 0, 2, 2, 1, 3 },   // restored away by the next frame
+    { 2, 2, 2, 2, 2, 1 },
+};
+static const int kGIFFrameCount = SK_ARRAY_COUNT(gGIFFrames);
+
+static void write_u16(SkWStream* stream, int value) {
+    stream->write8(value & 0xFF);
+    stream->write8(value >> 8);
+}
+
+// Write count pixels of colorIndex as 3 bit LZW codes. A clear code before every
+// other pixel keeps the decoder's table (and so the code size) from growing.
+static void write_gif_pixels(SkWStream* stream, int colorIndex, int count) {
+    static const int kClearCode = 4;
+    static const int kEndCode = 5;
+
+    SkTDArray<int> codes;
+    for (int i = 0; i < count; ++i) {
+        if (0 == (i & 1)) {
+            *codes.append() = kClearCode;
+        }
+        *codes.append() = colorIndex;
+    }
+    *codes.append() = kEndCode;
+
+    SkTDArray<uint8_t> bytes;
+    uint32_t bits = 0;
+    int bitCount = 0;
+    for (int i = 0; i < codes.count(); ++i) {
+        bits |= codes[i] << bitCount;
+        bitCount += 3;
+        while (bitCount >= 8) {
+            *bytes.append() = bits & 0xFF;
+            bits >>= 8;
+            bitCount -= 8;
+        }
+    }
+    if (bitCount > 0) {
+        *bytes.append() = bits;
+    }
+
+    stream->write8(2);  // minimum code size
+    for (int i = 0; i < bytes.count(); i += 255) {
+        int n = SkMin32(255, bytes.count() - i);
+        stream->write8(n);
+        stream->write(&bytes[i], n);
+    }
+    stream->write8(0);
+}
+
+static SkData* make_gif() {
+    SkDynamicMemoryWStream stream;
+    stream.write("GIF89a", 6);
+    write_u16(&stream, kGIFSize);
+    write_u16(&stream, kGIFSize);
+    stream.write8(0x81);    // a global color table of 4 colors
+    stream.write8(kGIFBackgroundIndex);
+    stream.write8(0);
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gGIFColors); ++i) {
+        stream.write8(SkColorGetR(gGIFColors[i]));
+        stream.write8(SkColorGetG(gGIFColors[i]));
+        stream.write8(SkColorGetB(gGIFColors[i]));
+    }
+
+    for (int i = 0; i < kGIFFrameCount; ++i) {
+        const GIFFrame& frame = gGIFFrames[i];
+        // graphic control extension
+        stream.write8(0x21);
+        stream.write8(0xF9);
+        stream.write8(4);
+        stream.write8(frame.fDisposal << 2);
+        write_u16(&stream, kGIFFrameMSec / 10);
+        stream.write8(0);
+        stream.write8(0);
+        // image descriptor
+        stream.write8(0x2C);
+        write_u16(&stream, frame.fLeft);
+        write_u16(&stream, frame.fTop);
+        write_u16(&stream, frame.fWidth);
+        write_u16(&stream, frame.fHeight);
+        stream.write8(0);
+        write_gif_pixels(&stream, frame.fColorIndex, frame.fWidth * frame.fHeight);
+    }
+    stream.write8(0x3B);
+    return stream.copyToData();
+}
+
+static void fill_rect(SkPMColor pixels[], const GIFFrame& frame, int colorIndex) {
+    SkPMColor color = SkPreMultiplyColor(gGIFColors[colorIndex]);
+    for (int y = frame.fTop; y < frame.fTop + frame.fHeight; ++y) {
+        for (int x = frame.fLeft; x < frame.fLeft + frame.fWidth; ++x) {
+            pixels[y * kGIFSize + x] = color;
+        }
+    }
+}
+
+// What the movie should show at frame index.
+static void composite_gif(int index, SkPMColor pixels[]) {
+    static const GIFFrame kScreen = { 0, 0, kGIFSize, kGIFSize, 0, 0 };
+    SkPMColor saved[kGIFSize * kGIFSize];
+    for (int i = 0; i <= index; ++i) {
+        if (0 == i) {
+            fill_rect(pixels, kScreen, kGIFBackgroundIndex);
+        } else if (2 == gGIFFrames[i - 1].fDisposal) {
+            fill_rect(pixels, gGIFFrames[i - 1], kGIFBackgroundIndex);
+        } else if (3 == gGIFFrames[i - 1].fDisposal) {
+            memcpy(pixels, saved, sizeof(saved));
+        }
+        if (3 == gGIFFrames[i].fDisposal) {
+            memcpy(saved, pixels, sizeof(saved));
+        }
+        fill_rect(pixels, gGIFFrames[i], gGIFFrames[i].fColorIndex);
+    }
+}
+
+// Seek to frame index, and check what the movie shows there.
+static void check_frame(skiatest::Reporter* reporter, SkMovie* movie, int index) {
+    movie->setTime(index * kGIFFrameMSec + kGIFFrameMSec / 2);
+    const SkBitmap& bm = movie->bitmap();
+    REPORTER_ASSERT(reporter, kGIFSize == bm.width() && kGIFSize == bm.height());
+    if (kGIFSize != bm.width() || kGIFSize != bm.height()) {
+        return;
+    }
+
+    SkPMColor expected[kGIFSize * kGIFSize];
+    composite_gif(index, expected);
+    SkAutoLockPixels alp(bm);
+    bool same = true;
+    for (int y = 0; y < kGIFSize; ++y) {
+        for (int x = 0; x < kGIFSize; ++x) {
+            same &= *bm.getAddr32(x, y) == expected[y * kGIFSize + x];
+        }
+    }
+    REPORTER_ASSERT(reporter, same);
+}
+
+static void test_seek(skiatest::Reporter* reporter, SkData* gif) {
+    SkAutoTUnref<SkMovie> movie(SkMovie::DecodeMemory(gif->data(), gif->size()));
+    REPORTER_ASSERT(reporter, kGIFFrameCount * kGIFFrameMSec == (int)movie->duration());
+
+    for (int i = 0; i < kGIFFrameCount; ++i) {
+        check_frame(reporter, movie, i);
+    }
+    // Seeking backwards replays from the first frame.
+    static const int kSeeks[] = { 5, 2, 4, 1, 0, 3 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kSeeks); ++i) {
+        check_frame(reporter, movie, kSeeks[i]);
+    }
+}
+
+static void test_keyframes(skiatest::Reporter* reporter, SkData* gif) {
+    SkAutoTUnref<SkMovie> movie(SkMovie::DecodeMemory(gif->data(), gif->size()));
+
+    // Room for two of the six frames, so frames 0 and 3 are kept.
+    const size_t frameBytes = kGIFSize * kGIFSize * sizeof(SkPMColor);
+    movie->setFrameCacheLimit(2 * frameBytes);
+    for (int i = 0; i < kGIFFrameCount; ++i) {
+        check_frame(reporter, movie, i);
+    }
+
+    check_frame(reporter, movie, 3);
+    REPORTER_ASSERT(reporter, movie->bitmap().isImmutable());
+    check_frame(reporter, movie, 1);
+    REPORTER_ASSERT(reporter, !movie->bitmap().isImmutable());
+
+    // These resume from the keyframe before them, including across a frame that
+    // is restored to the one before it.
+    static const int kSeeks[] = { 5, 4, 2, 5, 1, 2 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kSeeks); ++i) {
+        check_frame(reporter, movie, kSeeks[i]);
+    }
+
+    movie->setFrameCacheLimit(0);
+    check_frame(reporter, movie, 3);
+    REPORTER_ASSERT(reporter, !movie->bitmap().isImmutable());
+    check_frame(reporter, movie, 0);
+}
+
+static void test_predecode(skiatest::Reporter* reporter, SkData* gif) {
+    SkAutoTUnref<SkMovie> movie(SkMovie::DecodeMemory(gif->data(), gif->size()));
+
+    // There is nowhere to predecode to without a frame cache.
+    REPORTER_ASSERT(reporter, !movie->predecodeFrames());
+
+    movie->setFrameCacheLimit(kGIFFrameCount * kGIFSize * kGIFSize * sizeof(SkPMColor));
+    REPORTER_ASSERT(reporter, movie->predecodeFrames());
+    // Seek around while the frames are being predecoded.
+    for (int i = kGIFFrameCount - 1; i >= 0; --i) {
+        check_frame(reporter, movie, i);
+    }
+    for (int i = 0; i < kGIFFrameCount; ++i) {
+        check_frame(reporter, movie, i);
+    }
+
+    // A movie can go away while it is predecoding.
+    SkAutoTUnref<SkMovie> other(SkMovie::DecodeMemory(gif->data(), gif->size()));
+    other->setFrameCacheLimit(kGIFFrameCount * kGIFSize * kGIFSize * sizeof(SkPMColor));
+    REPORTER_ASSERT(reporter, other->predecodeFrames());
+}
+
+static void TestMovie(skiatest::Reporter* reporter) {
+    SkAutoDataUnref gif(make_gif());
+    SkAutoTUnref<SkMovie> movie(SkMovie::DecodeMemory(gif->data(), gif->size()));
+    if (NULL == movie.get()) {
+        // this build has no GIF support
+        return;
+    }
+
+    test_seek(reporter, gif);
+    test_keyframes(reporter, gif);
+    test_predecode(reporter, gif);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("Movie", MovieTestClass, TestMovie)
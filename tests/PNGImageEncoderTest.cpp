@@ -0,0 +1,151 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkData.h"
+#include "SkForceLinking.h"
+#include "SkImageDecoder.h"
+#include "SkPNGImageEncoder.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "SkThreadPool.h"
+
+__SK_FORCE_IMAGE_DECODER_LINKING;
+
+// Tall enough that the parallel encoder splits it into several blocks.
+static const int kWidth = 300;
+static const int kHeight = 700;
+
+static void make_bitmap(SkBitmap* bm, bool opaque, int colorCount) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, kWidth, kHeight);
+    bm->allocPixels();
+
+    SkRandom rand;
+    SkPMColor colors[256];
+    for (int i = 0; i < colorCount; ++i) {
+        U8CPU a = opaque ? 0xFF : rand.nextU() & 0xFF;
+        colors[i] = SkPreMultiplyARGB(a, rand.nextU() & 0xFF,
+                                      rand.nextU() & 0xFF, rand.nextU() & 0xFF);
+    }
+    for (int y = 0; y < kHeight; ++y) {
+        SkPMColor* row = bm->getAddr32(0, y);
+        for (int x = 0; x < kWidth; ++x) {
+            if (colorCount > 0) {
+                // Runs of colors, like a map tile.
+                row[x] = colors[((x / 7) + (y / 5) * 3) % colorCount];
+            } else {
+                // A gradient with some noise, so every filter gets a workout.
+                U8CPU a = opaque ? 0xFF : (x + y) & 0xFF;
+                row[x] = SkPreMultiplyARGB(a, x & 0xFF, y & 0xFF,
+                                           (x * y + (rand.nextU() & 7)) & 0xFF);
+            }
+        }
+    }
+    bm->setIsOpaque(opaque);
+}
+
+static bool encode_and_decode(const SkBitmap& src,
+                              const SkPNGImageEncoder::Options& options,
+                              SkBitmap* dst) {
+    SkPNGImageEncoder encoder(options);
+    SkAutoTUnref<SkData> data(encoder.encodeData(src, SkImageEncoder::kDefaultQuality));
+    if (NULL == data.get()) {
+        return false;
+    }
+    return SkImageDecoder::DecodeMemory(data->data(), data->size(), dst,
+                                        SkBitmap::kARGB_8888_Config,
+                                        SkImageDecoder::kDecodePixels_Mode);
+}
+
+static bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    if (a.width() != b.width() || a.height() != b.height() ||
+        a.config() != b.config()) {
+        return false;
+    }
+    SkAutoLockPixels alpa(a);
+    SkAutoLockPixels alpb(b);
+    for (int y = 0; y < a.height(); ++y) {
+        if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * 4)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Every combination of options must decode to the same pixels as the
+// default options.
+static void test_options(skiatest::Reporter* reporter, const SkBitmap& src) {
+    SkBitmap expected;
+    REPORTER_ASSERT(reporter,
+                    encode_and_decode(src, SkPNGImageEncoder::Options(), &expected));
+
+    static const SkPNGImageEncoder::FilterStrategy gStrategies[] = {
+        SkPNGImageEncoder::kDefault_FilterStrategy,
+        SkPNGImageEncoder::kNone_FilterStrategy,
+        SkPNGImageEncoder::kSub_FilterStrategy,
+        SkPNGImageEncoder::kUp_FilterStrategy,
+        SkPNGImageEncoder::kAverage_FilterStrategy,
+        SkPNGImageEncoder::kPaeth_FilterStrategy,
+        SkPNGImageEncoder::kAdaptive_FilterStrategy,
+    };
+    static const int gThreadCounts[] = { 0, 1, 3, SkThreadPool::kThreadPerCore };
+    static const int gLevels[] = { 1, SkPNGImageEncoder::Options::kDefault_CompressionLevel };
+
+    for (size_t s = 0; s < SK_ARRAY_COUNT(gStrategies); ++s) {
+        for (size_t t = 0; t < SK_ARRAY_COUNT(gThreadCounts); ++t) {
+            for (size_t l = 0; l < SK_ARRAY_COUNT(gLevels); ++l) {
+                for (int palette = 0; palette <= 1; ++palette) {
+                    SkPNGImageEncoder::Options options;
+                    options.fFilterStrategy = gStrategies[s];
+                    options.fThreadCount = gThreadCounts[t];
+                    options.fCompressionLevel = gLevels[l];
+                    options.fPaletteReduction = SkToBool(palette);
+
+                    SkBitmap actual;
+                    REPORTER_ASSERT(reporter,
+                                    encode_and_decode(src, options, &actual));
+                    REPORTER_ASSERT(reporter, same_pixels(expected, actual));
+                }
+            }
+        }
+    }
+}
+
+// Palette reduction should kick in for few colors, and shrink the output.
+static void test_palette_size(skiatest::Reporter* reporter) {
+    SkBitmap src;
+    make_bitmap(&src, false, 16);
+
+    SkPNGImageEncoder::Options options;
+    SkAutoTUnref<SkData> truecolor(SkPNGImageEncoder(options).encodeData(src, 100));
+    options.fPaletteReduction = true;
+    SkAutoTUnref<SkData> palette(SkPNGImageEncoder(options).encodeData(src, 100));
+
+    REPORTER_ASSERT(reporter, NULL != truecolor.get() && NULL != palette.get());
+    if (NULL != truecolor.get() && NULL != palette.get()) {
+        REPORTER_ASSERT(reporter, palette->size() < truecolor->size());
+    }
+}
+
+static void TestPNGImageEncoder(skiatest::Reporter* reporter) {
+    SkBitmap bm;
+    make_bitmap(&bm, true, 0);
+    test_options(reporter, bm);
+    make_bitmap(&bm, false, 0);
+    test_options(reporter, bm);
+    make_bitmap(&bm, true, 200);
+    test_options(reporter, bm);
+    make_bitmap(&bm, false, 256);
+    test_options(reporter, bm);
+
+    test_palette_size(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("PNGImageEncoder", PNGImageEncoderTestClass, TestPNGImageEncoder)
@@ -6,7 +6,9 @@
  * found in the LICENSE file.
  */
 #include "Test.h"
+#include "SkGraphics.h"
 #include "SkPathMeasure.h"
+#include "SkPathMeasureCache.h"
 
 static void test_small_segment3() {
 #ifdef SK_SCALAR_IS_FLOAT
@@ -79,6 +81,149 @@ static void test_small_segment() {
 #endif
 }
 
+static void test_curve_lengths(skiatest::Reporter* reporter) {
+    SkPath path;
+    path.addCircle(0, 0, 100 * SK_Scalar1);
+    SkPathMeasure meas(path, false);
+    REPORTER_ASSERT(reporter, SkScalarNearlyEqual(meas.getLength(), 200 * SK_ScalarPI,
+                                                  SK_Scalar1));
+
+    // a cubic whose control points are on the chord, a third of the way along
+    path.reset();
+    path.moveTo(0, 0);
+    path.cubicTo(100 * SK_Scalar1, 0, 200 * SK_Scalar1, 0, 300 * SK_Scalar1, 0);
+    meas.setPath(&path, false);
+    REPORTER_ASSERT(reporter, SkScalarNearlyEqual(meas.getLength(), 300 * SK_Scalar1));
+
+    SkPoint position;
+    REPORTER_ASSERT(reporter, meas.getPosTan(150 * SK_Scalar1, &position, NULL));
+    REPORTER_ASSERT(reporter, SkScalarNearlyEqual(position.fX, 150 * SK_Scalar1));
+    REPORTER_ASSERT(reporter, position.fY == 0);
+}
+
+static void test_batch_postan(skiatest::Reporter* reporter) {
+    SkPath path;
+    path.moveTo(0, 0);
+    path.lineTo(100 * SK_Scalar1, 0);
+    path.quadTo(200 * SK_Scalar1, 0, 200 * SK_Scalar1, 100 * SK_Scalar1);
+    path.cubicTo(200 * SK_Scalar1, 200 * SK_Scalar1, 0, 200 * SK_Scalar1,
+                 0, 100 * SK_Scalar1);
+    SkPathMeasure meas(path, true);
+    SkScalar length = meas.getLength();
+
+    // increasing runs, going backwards, repeats, and out of range distances
+    const SkScalar distances[] = {
+        -SK_Scalar1, 0, SK_Scalar1, 50 * SK_Scalar1, 100 * SK_Scalar1, 150 * SK_Scalar1,
+        150 * SK_Scalar1, length / 2, 10 * SK_Scalar1, length - SK_Scalar1, length,
+        length + SK_Scalar1, 120 * SK_Scalar1,
+    };
+    const int count = SK_ARRAY_COUNT(distances);
+
+    SkPoint positions[count];
+    SkVector tangents[count];
+    REPORTER_ASSERT(reporter, meas.getPosTan(distances, count, positions, tangents));
+    for (int i = 0; i < count; ++i) {
+        SkPoint position;
+        SkVector tangent;
+        REPORTER_ASSERT(reporter, meas.getPosTan(distances[i], &position, &tangent));
+        REPORTER_ASSERT(reporter, positions[i] == position);
+        REPORTER_ASSERT(reporter, tangents[i] == tangent);
+    }
+
+    // either array may be null
+    SkPoint positions2[count];
+    REPORTER_ASSERT(reporter, meas.getPosTan(distances, count, positions2, NULL));
+    REPORTER_ASSERT(reporter, !memcmp(positions, positions2, sizeof(positions)));
+
+    SkPath empty;
+    meas.setPath(&empty, false);
+    REPORTER_ASSERT(reporter, !meas.getPosTan(distances, count, positions, tangents));
+}
+
+static void test_cache(skiatest::Reporter* reporter) {
+    SkPath path;
+    path.moveTo(0, 0);
+    path.lineTo(10 * SK_Scalar1, 0);
+    path.moveTo(0, 10 * SK_Scalar1);
+    path.quadTo(10 * SK_Scalar1, 10 * SK_Scalar1, 10 * SK_Scalar1, 20 * SK_Scalar1);
+
+    SkPathMeasureCache cache(1024 * 1024);
+    SkPathMeasureCache::Stats stats;
+
+    SkPathMeasureTable* table = SkNEW(SkPathMeasureTable);
+    table->fComplete = true;
+    REPORTER_ASSERT(reporter, NULL == cache.find(SkPathMeasureCache::Key(path, false)));
+    cache.add(SkPathMeasureCache::Key(path, false), table);
+
+    // a copy shares the path ref, and so the key
+    SkPath copy(path);
+    SkPathMeasureTable* found = cache.find(SkPathMeasureCache::Key(copy, false));
+    REPORTER_ASSERT(reporter, table == found);
+    SkSafeUnref(found);
+    table->unref();
+
+    // forceClosed is part of the key, and editing the path changes its ID
+    REPORTER_ASSERT(reporter, NULL == cache.find(SkPathMeasureCache::Key(path, true)));
+    copy.lineTo(0, 0);
+    REPORTER_ASSERT(reporter, NULL == cache.find(SkPathMeasureCache::Key(copy, false)));
+
+    cache.getStats(&stats);
+    REPORTER_ASSERT(reporter, 1 == stats.fCount);
+    REPORTER_ASSERT(reporter, 1 == stats.fHits);
+    REPORTER_ASSERT(reporter, 3 == stats.fMisses);
+
+    cache.setByteLimit(0);
+    cache.getStats(&stats);
+    REPORTER_ASSERT(reporter, 0 == stats.fCount);
+    REPORTER_ASSERT(reporter, 0 == stats.fBytesUsed);
+
+    // Measures that share a cached table see the same contours as one that
+    // builds its own. Other tests may use the global cache at the same time,
+    // so only check that its counts grow.
+    SkPathMeasure uncached(path, false);
+    SkScalar lengths[2];
+    lengths[0] = uncached.getLength();
+    REPORTER_ASSERT(reporter, uncached.nextContour());
+    lengths[1] = uncached.getLength();
+    REPORTER_ASSERT(reporter, !uncached.nextContour());
+
+    size_t oldLimit = SkGraphics::SetPathMeasureCacheByteLimit(1024 * 1024);
+    SkPathMeasureCache::GetStats(&stats);
+    int hits = stats.fHits;
+    for (int i = 0; i < 2; ++i) {
+        SkPathMeasure meas(path, false);
+        REPORTER_ASSERT(reporter, lengths[0] == meas.getLength());
+        REPORTER_ASSERT(reporter, meas.nextContour());
+        REPORTER_ASSERT(reporter, lengths[1] == meas.getLength());
+        REPORTER_ASSERT(reporter, !meas.nextContour());
+        REPORTER_ASSERT(reporter, !meas.nextContour());
+    }
+    SkPathMeasureCache::GetStats(&stats);
+    REPORTER_ASSERT(reporter, stats.fHits > hits);
+
+    // Transforming a path whose points are not shared moves them in place,
+    // which must not find the table of the path before it moved.
+    SkPath line;
+    line.moveTo(0, 0);
+    line.lineTo(100 * SK_Scalar1, 0);
+    {
+        SkPathMeasure meas(line, false);
+        REPORTER_ASSERT(reporter, 100 * SK_Scalar1 == meas.getLength());
+    }
+    SkMatrix scale;
+    scale.setScale(3 * SK_Scalar1, 3 * SK_Scalar1);
+    line.transform(scale);
+    {
+        SkPathMeasure meas(line, false);
+        REPORTER_ASSERT(reporter, 300 * SK_Scalar1 == meas.getLength());
+        SkPoint pos;
+        REPORTER_ASSERT(reporter, meas.getPosTan(meas.getLength(), &pos, NULL));
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(pos.fX, 300 * SK_Scalar1));
+        REPORTER_ASSERT(reporter, SkScalarNearlyZero(pos.fY));
+    }
+    SkGraphics::SetPathMeasureCacheByteLimit(oldLimit);
+}
+
 static void TestPathMeasure(skiatest::Reporter* reporter) {
     SkPath  path;
 
@@ -206,6 +351,9 @@ static void TestPathMeasure(skiatest::Reporter* reporter) {
     test_small_segment();
     test_small_segment2();
     test_small_segment3();
+    test_curve_lengths(reporter);
+    test_batch_postan(reporter);
+    test_cache(reporter);
 }
 
 #include "TestClassDef.h"
@@ -1741,6 +1741,21 @@ static void test_transform(skiatest::Reporter* reporter) {
         SkPoint newPt = SkPoint::Make(pts[i].fX * 2, pts[i].fY * 3);
         REPORTER_ASSERT(reporter, newPt == pts1[i]);
     }
+
+    // the bounds found while transforming (here because they can't just be
+    // mapped) are the bounds of the new points
+    matrix.setRotate(30, SkIntToScalar(5), SkIntToScalar(5));
+    p.transform(matrix, &p1);
+    count = p1.getPoints(pts1, 7);
+    SkRect bounds;
+    REPORTER_ASSERT(reporter, bounds.setBoundsCheck(pts1, count));
+    REPORTER_ASSERT(reporter, p1.isFinite());
+    REPORTER_ASSERT(reporter, p1.getBounds() == bounds);
+
+    SkPath p2(p);
+    p2.transform(matrix);
+    REPORTER_ASSERT(reporter, p2 == p1);
+    REPORTER_ASSERT(reporter, p2.getBounds() == bounds);
 }
 
 static void test_zero_length_paths(skiatest::Reporter* reporter) {
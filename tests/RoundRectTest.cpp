@@ -6,6 +6,7 @@
  */
 
 #include "Test.h"
+#include "SkMatrix.h"
 #include "SkRRect.h"
 
 static const SkScalar kWidth = 100.0f;
@@ -451,7 +452,39 @@ static void test_round_rect_contains_rect(skiatest::Reporter* reporter) {
     }
 }
 
+static void test_round_rect_transform(skiatest::Reporter* reporter) {
+    SkRRect rr;
+    SkVector radii[4] = {
+        { SkIntToScalar(1), SkIntToScalar(2) },
+        { SkIntToScalar(3), SkIntToScalar(4) },
+        { SkIntToScalar(5), SkIntToScalar(6) },
+        { SkIntToScalar(7), SkIntToScalar(8) },
+    };
+    rr.setRectRadii(SkRect::MakeLTRB(0, 0, SkIntToScalar(40), SkIntToScalar(50)), radii);
+
+    SkMatrix matrix;
+    matrix.setScale(SkIntToScalar(2), SkIntToScalar(-1));
+    matrix.postTranslate(SkIntToScalar(10), SkIntToScalar(100));
+    SkRRect dst;
+    REPORTER_ASSERT(reporter, rr.transform(matrix, &dst));
+    REPORTER_ASSERT(reporter, dst.rect() == SkRect::MakeLTRB(SkIntToScalar(10),
+                                                             SkIntToScalar(50),
+                                                             SkIntToScalar(90),
+                                                             SkIntToScalar(100)));
+    // Flipped vertically, so the lower left corner is now the upper left.
+    SkVector ul = dst.radii(SkRRect::kUpperLeft_Corner);
+    SkVector lr = dst.radii(SkRRect::kLowerRight_Corner);
+    REPORTER_ASSERT(reporter, ul.fX == SkIntToScalar(14) && ul.fY == SkIntToScalar(8));
+    REPORTER_ASSERT(reporter, lr.fX == SkIntToScalar(6) && lr.fY == SkIntToScalar(4));
+
+    matrix.setRotate(SkIntToScalar(30));
+    SkRRect unchanged = dst;
+    REPORTER_ASSERT(reporter, !rr.transform(matrix, &dst));
+    REPORTER_ASSERT(reporter, unchanged == dst);
+}
+
 static void TestRoundRect(skiatest::Reporter* reporter) {
+    test_round_rect_transform(reporter);
     test_round_rect_basic(reporter);
     test_round_rect_rects(reporter);
     test_round_rect_ovals(reporter);
@@ -6,10 +6,18 @@
  */
 
 #include "Test.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
 #include "SkPaint.h"
 #include "SkPath.h"
+#include "SkRandom.h"
 #include "SkRect.h"
 #include "SkStroke.h"
+#include "SkStrokeCache.h"
+#include "SkStrokeRec.h"
+#include "SkStrokerPriv.h"
+#include "SkTDArray.h"
 
 static bool equal(const SkRect& a, const SkRect& b) {
     return  SkScalarNearlyEqual(a.left(), b.left()) &&
@@ -55,8 +63,398 @@ static void test_strokerect(skiatest::Reporter* reporter) {
     }
 }
 
+static void make_polyline(SkPath* path) {
+    path->moveTo(0, 0);
+    for (int i = 1; i < 20; ++i) {
+        path->lineTo(SkIntToScalar(i * 10), SkIntToScalar((i & 1) * 25));
+    }
+}
+
+static void test_strokecache(skiatest::Reporter* reporter) {
+    SkPath path;
+    make_polyline(&path);
+
+    SkStroke stroke;
+    stroke.setWidth(SkIntToScalar(4));
+    stroke.setJoin(SkPaint::kMiter_Join);
+    stroke.setMiterLimit(SkIntToScalar(4));
+
+    SkStrokeCache cache(1024 * 1024);
+    SkStrokeCache::Stats stats;
+    SkPath result;
+
+    REPORTER_ASSERT(reporter, !cache.find(SkStrokeCache::Key(path, stroke), &result));
+    SkPath stroked;
+    stroke.strokePath(path, &stroked);
+    cache.add(SkStrokeCache::Key(path, stroke), stroked);
+
+    // A copy of the path has the same contents, so it should hit.
+    SkPath copy(path);
+    REPORTER_ASSERT(reporter, cache.find(SkStrokeCache::Key(copy, stroke), &result));
+    REPORTER_ASSERT(reporter, result == stroked);
+    cache.getStats(&stats);
+    REPORTER_ASSERT(reporter, 1 == stats.fHits && 1 == stats.fMisses && 1 == stats.fCount);
+    REPORTER_ASSERT(reporter, stats.fBytesUsed > 0);
+
+    // Editing the path, or changing any stroke parameter, should miss.
+    copy.lineTo(0, 0);
+    REPORTER_ASSERT(reporter, !cache.find(SkStrokeCache::Key(copy, stroke), &result));
+
+    // So should moving a path whose points are not shared, which transforms them in place.
+    SkPath moved;
+    make_polyline(&moved);
+    cache.add(SkStrokeCache::Key(moved, stroke), stroked);
+    REPORTER_ASSERT(reporter, cache.find(SkStrokeCache::Key(moved, stroke), &result));
+    moved.offset(SkIntToScalar(50), SkIntToScalar(50));
+    REPORTER_ASSERT(reporter, !cache.find(SkStrokeCache::Key(moved, stroke), &result));
+    SkMatrix scale;
+    scale.setScale(SkIntToScalar(3), SkIntToScalar(3));
+    moved.transform(scale);
+    REPORTER_ASSERT(reporter, !cache.find(SkStrokeCache::Key(moved, stroke), &result));
+
+    SkStroke other(stroke);
+    other.setWidth(SkIntToScalar(5));
+    REPORTER_ASSERT(reporter, !cache.find(SkStrokeCache::Key(path, other), &result));
+    other = stroke;
+    other.setCap(SkPaint::kRound_Cap);
+    REPORTER_ASSERT(reporter, !cache.find(SkStrokeCache::Key(path, other), &result));
+    other = stroke;
+    other.setJoin(SkPaint::kBevel_Join);
+    REPORTER_ASSERT(reporter, !cache.find(SkStrokeCache::Key(path, other), &result));
+    other = stroke;
+    other.setMiterLimit(SkIntToScalar(2));
+    REPORTER_ASSERT(reporter, !cache.find(SkStrokeCache::Key(path, other), &result));
+    other = stroke;
+    other.setDoFill(true);
+    REPORTER_ASSERT(reporter, !cache.find(SkStrokeCache::Key(path, other), &result));
+
+    // The miter limit does not matter for the other joins.
+    SkStroke round(stroke);
+    round.setJoin(SkPaint::kRound_Join);
+    other = round;
+    other.setMiterLimit(SkIntToScalar(2));
+    REPORTER_ASSERT(reporter, SkStrokeCache::Key(path, round) == SkStrokeCache::Key(path, other));
+
+    cache.purgeAll();
+    cache.getStats(&stats);
+    REPORTER_ASSERT(reporter, 0 == stats.fCount && 0 == stats.fBytesUsed);
+    REPORTER_ASSERT(reporter, !cache.find(SkStrokeCache::Key(path, stroke), &result));
+
+    // Strokes too big for the limit are not kept.
+    SkStrokeCache tiny(64);
+    tiny.add(SkStrokeCache::Key(path, stroke), stroked);
+    tiny.getStats(&stats);
+    REPORTER_ASSERT(reporter, 0 == stats.fCount);
+
+    // Through the global cache, strokePath() should give the same results as without it,
+    // including when stroking a path into itself.
+    size_t prevLimit = SkStrokeCache::SetByteLimit(1024 * 1024);
+    for (int i = 0; i < 2; ++i) {
+        SkPath cached;
+        stroke.strokePath(path, &cached);
+        REPORTER_ASSERT(reporter, cached == stroked);
+
+        SkPath inPlace(path);
+        stroke.strokePath(inPlace, &inPlace);
+        REPORTER_ASSERT(reporter, inPlace == stroked);
+    }
+    SkPath moving;
+    make_polyline(&moving);
+    SkPath before, after;
+    stroke.strokePath(moving, &before);
+    moving.offset(SkIntToScalar(50), SkIntToScalar(50));
+    stroke.strokePath(moving, &after);
+    SkRect movedBounds = before.getBounds();
+    movedBounds.offset(SkIntToScalar(50), SkIntToScalar(50));
+    REPORTER_ASSERT(reporter, after.getBounds() == movedBounds);
+
+    // With the cache off, strokes do not look in it at all.
+    SkStrokeCache::SetByteLimit(0);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::IsEnabled());
+    SkStrokeCache::Stats offStats;
+    SkStrokeCache::GetStats(&offStats);
+    stroke.strokePath(path, &result);
+    stroke.strokePath(path, SkRect::MakeWH(SkIntToScalar(50), SkIntToScalar(50)), &result);
+    SkStrokeCache::GetStats(&stats);
+    REPORTER_ASSERT(reporter, offStats.fHits == stats.fHits && offStats.fMisses == stats.fMisses);
+    SkStrokeCache::SetByteLimit(prevLimit);
+}
+
+static void test_unitnormals(skiatest::Reporter* reporter) {
+    SkStrokerPriv::UnitNormalsProc proc = SkStrokerPriv::PlatformUnitNormalsProc();
+    if (NULL == proc) {
+        return;
+    }
+
+    SkRandom rand;
+    SkPoint pts[101];
+    for (int i = 0; i < 101; ++i) {
+        switch (rand.nextU() % 8) {
+            case 0:     // degenerate
+                pts[i] = pts[i > 0 ? i - 1 : 0];
+                break;
+            case 1:     // nearly degenerate
+                pts[i] = pts[i > 0 ? i - 1 : 0];
+                pts[i].fX += SK_ScalarNearlyZero * rand.nextRangeF(0, 2);
+                break;
+            case 2:     // too long to square
+                pts[i].set(rand.nextRangeF(-1e30f, 1e30f), rand.nextRangeF(-1e30f, 1e30f));
+                break;
+            default:
+                pts[i].set(rand.nextRangeF(-1000, 1000), rand.nextRangeF(-1000, 1000));
+                break;
+        }
+    }
+
+    for (int count = 0; count <= 100; ++count) {
+        SkVector expected[100], actual[100];
+        SkStrokerPriv::UnitNormals(pts, count, expected);
+        proc(pts, count, actual);
+        REPORTER_ASSERT(reporter, 0 == memcmp(expected, actual, count * sizeof(SkVector)));
+    }
+}
+
+// Stroking a path that only has lines takes the polyline stroker. Prefixing it with a
+// contour that has a quad sends it through the general stroker instead, and the quad's
+// contour is finished before the lines are started, so the rest of the result must be the
+// same.
+static void check_polyline(skiatest::Reporter* reporter, const SkPath& path,
+                           const SkStroke& stroke) {
+    SkPath quad;
+    quad.moveTo(-100, -100);
+    quad.quadTo(-50, -150, 0, -100);
+
+    SkPath general(quad), generalStroked, quadStroked, polylineStroked;
+    general.addPath(path);
+    stroke.strokePath(general, &generalStroked);
+    stroke.strokePath(quad, &quadStroked);
+    stroke.strokePath(path, &polylineStroked);
+
+    SkTDArray<SkPoint> generalPts;
+    SkTDArray<uint8_t> generalVerbs;
+    generalPts.setCount(generalStroked.countPoints());
+    generalVerbs.setCount(generalStroked.countVerbs());
+    generalStroked.getPoints(generalPts.begin(), generalPts.count());
+    generalStroked.getVerbs(generalVerbs.begin(), generalVerbs.count());
+
+    SkTDArray<SkPoint> pts;
+    SkTDArray<uint8_t> verbs;
+    pts.setCount(polylineStroked.countPoints());
+    verbs.setCount(polylineStroked.countVerbs());
+    polylineStroked.getPoints(pts.begin(), pts.count());
+    polylineStroked.getVerbs(verbs.begin(), verbs.count());
+
+    int skipPts = quadStroked.countPoints();
+    int skipVerbs = quadStroked.countVerbs();
+    REPORTER_ASSERT(reporter, generalPts.count() == skipPts + pts.count());
+    REPORTER_ASSERT(reporter, generalVerbs.count() == skipVerbs + verbs.count());
+    if (generalPts.count() == skipPts + pts.count() &&
+            generalVerbs.count() == skipVerbs + verbs.count()) {
+        REPORTER_ASSERT(reporter, 0 == memcmp(&generalPts[skipPts], pts.begin(),
+                                              pts.count() * sizeof(SkPoint)));
+        REPORTER_ASSERT(reporter, 0 == memcmp(&generalVerbs[skipVerbs], verbs.begin(),
+                                              verbs.count()));
+    }
+    uint32_t segmentMask = 0;
+    for (int i = 0; i < verbs.count(); ++i) {
+        switch (verbs[i]) {
+            case SkPath::kLine_Verb:  segmentMask |= SkPath::kLine_SegmentMask;  break;
+            case SkPath::kQuad_Verb:  segmentMask |= SkPath::kQuad_SegmentMask;  break;
+            case SkPath::kCubic_Verb: segmentMask |= SkPath::kCubic_SegmentMask; break;
+            default: break;
+        }
+    }
+    REPORTER_ASSERT(reporter, polylineStroked.getSegmentMasks() == segmentMask);
+
+    // Editing the result must work as it does on any other path.
+    SkPath edited(polylineStroked);
+    edited.lineTo(5, 5);
+    REPORTER_ASSERT(reporter, edited.countPoints() == polylineStroked.countPoints() + 2);
+}
+
+static void test_polyline_stroker(skiatest::Reporter* reporter) {
+    SkRandom rand;
+    SkPath zigzag, polygon, contours, degenerate;
+
+    make_polyline(&zigzag);
+
+    polygon.moveTo(10, 10);
+    for (int i = 0; i < 30; ++i) {
+        polygon.lineTo(rand.nextRangeF(0, 200), rand.nextRangeF(0, 200));
+    }
+    polygon.close();
+
+    contours.moveTo(0, 0);
+    contours.lineTo(50, 0);
+    contours.lineTo(0, 0);          // 180 degree turn
+    contours.moveTo(20, 20);
+    contours.lineTo(70, 30);
+    contours.lineTo(20, 60);
+    contours.close();
+    contours.moveTo(100, 100);      // lone moveTo
+    contours.moveTo(100, 100);
+    contours.lineTo(150, 120);
+
+    degenerate.moveTo(0, 0);
+    degenerate.lineTo(0, 0);
+    degenerate.lineTo(30, 0);
+    degenerate.lineTo(30, SK_ScalarNearlyZero / 2);
+    degenerate.lineTo(30, 30);
+    degenerate.lineTo(30, 30);
+    degenerate.lineTo(60, 35);
+    degenerate.lineTo(60, 35);
+    degenerate.moveTo(5, 5);        // contour of a single degenerate line
+    degenerate.lineTo(5, 5);
+
+    const SkPath* paths[] = { &zigzag, &polygon, &contours, &degenerate };
+    const SkScalar widths[] = { SK_Scalar1 / 2, SkIntToScalar(4), SkIntToScalar(40) };
+
+    for (size_t p = 0; p < SK_ARRAY_COUNT(paths); ++p) {
+        for (int cap = 0; cap < SkPaint::kCapCount; ++cap) {
+            for (int join = 0; join < SkPaint::kJoinCount; ++join) {
+                for (size_t w = 0; w < SK_ARRAY_COUNT(widths); ++w) {
+                    SkStroke stroke;
+                    stroke.setCap((SkPaint::Cap)cap);
+                    stroke.setJoin((SkPaint::Join)join);
+                    stroke.setWidth(widths[w]);
+                    stroke.setMiterLimit(SkIntToScalar(1 + (int)w * 3));
+                    check_polyline(reporter, *paths[p], stroke);
+                }
+            }
+        }
+    }
+}
+
+static void draw_clipped(const SkPath& path, const SkRect& clip, SkBitmap* bm) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, 100, 100);
+    bm->allocPixels();
+    bm->eraseColor(SK_ColorTRANSPARENT);
+
+    SkCanvas canvas(*bm);
+    canvas.clipRect(clip);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    canvas.drawPath(path, paint);
+}
+
+// Stroke path with and without culling to clip, and check that they draw the same inside it.
+// The outlines are not made of the same edges, so allow for a subsample of difference where
+// a pixel is on the edge of the stroke.
+static void check_culled_stroke(skiatest::Reporter* reporter, const SkPath& path,
+                                const SkPaint& paint, const SkRect& clip) {
+    SkStrokeRec rec(paint);
+    SkPath stroked, culled;
+    REPORTER_ASSERT(reporter, rec.applyToPath(&stroked, path));
+    REPORTER_ASSERT(reporter, rec.applyToPath(&culled, path, &clip));
+
+    SkBitmap strokedBitmap, culledBitmap;
+    draw_clipped(stroked, clip, &strokedBitmap);
+    draw_clipped(culled, clip, &culledBitmap);
+    SkAutoLockPixels alp0(strokedBitmap), alp1(culledBitmap);
+    int maxDiff = 0;
+    for (int y = 0; y < strokedBitmap.height(); ++y) {
+        for (int x = 0; x < strokedBitmap.width(); ++x) {
+            int diff = SkGetPackedA32(*strokedBitmap.getAddr32(x, y)) -
+                       SkGetPackedA32(*culledBitmap.getAddr32(x, y));
+            maxDiff = SkMax32(maxDiff, SkAbs32(diff));
+        }
+    }
+    REPORTER_ASSERT(reporter, maxDiff <= 16);
+}
+
+static void test_cullpath(skiatest::Reporter* reporter) {
+    const SkRect clip = { 20, 20, 80, 80 };
+    SkRect bounds = clip;
+    bounds.outset(5, 5);
+
+    SkPath path, culled;
+    path.moveTo(30, 30);
+    path.lineTo(70, 70);
+    path.quadTo(75, 30, 30, 70);
+    REPORTER_ASSERT(reporter, !SkStroke::CullPath(path, bounds, &culled));
+
+    // Only the left edge is dropped. The segments after it are joined to the ones before it
+    // where the contour is closed, and kept in one open contour.
+    path.reset();
+    path.moveTo(30, 30);
+    path.lineTo(30, 60);
+    path.lineTo(-200, 60);
+    path.lineTo(-200, 30);
+    path.close();
+    REPORTER_ASSERT(reporter, SkStroke::CullPath(path, bounds, &culled));
+    REPORTER_ASSERT(reporter, 4 == culled.countPoints());
+    REPORTER_ASSERT(reporter, 4 == culled.countVerbs());   // no close
+    SkPoint pts[4];
+    culled.getPoints(pts, 4);
+    REPORTER_ASSERT(reporter, pts[0] == SkPoint::Make(-200, 30));
+    REPORTER_ASSERT(reporter, pts[1] == SkPoint::Make(30, 30));
+    REPORTER_ASSERT(reporter, pts[2] == SkPoint::Make(30, 60));
+    REPORTER_ASSERT(reporter, pts[3] == SkPoint::Make(-200, 60));
+
+    // Nothing is left of a path that is entirely outside.
+    path.reset();
+    path.moveTo(200, 0);
+    path.cubicTo(300, 0, 200, 100, 300, 100);
+    REPORTER_ASSERT(reporter, SkStroke::CullPath(path, bounds, &culled));
+    REPORTER_ASSERT(reporter, culled.isEmpty());
+
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(6);
+
+    path.reset();
+    path.moveTo(50, 50);
+    SkRandom rand;
+    for (int i = 0; i < 50; ++i) {
+        path.lineTo(rand.nextRangeScalar(-100, 200), rand.nextRangeScalar(-100, 200));
+    }
+    path.quadTo(150, -50, 60, 40);
+    path.close();
+
+    for (int join = 0; join < SkPaint::kJoinCount; ++join) {
+        paint.setStrokeJoin((SkPaint::Join)join);
+        for (int cap = 0; cap < SkPaint::kCapCount; ++cap) {
+            paint.setStrokeCap((SkPaint::Cap)cap);
+            check_culled_stroke(reporter, path, paint, clip);
+        }
+    }
+
+    // Culled strokes are cached for the path and the bounds they were culled to.
+    SkStroke stroke(paint);
+    SkStrokeCache::Key key(path, stroke), culledKey(path, stroke, &bounds);
+    SkRect otherBounds = bounds;
+    otherBounds.offset(10, 0);
+    REPORTER_ASSERT(reporter, !(key == culledKey));
+    REPORTER_ASSERT(reporter, !(culledKey == SkStrokeCache::Key(path, stroke, &otherBounds)));
+
+    SkPath uncached;
+    SkStroke uncachedStroke(stroke);
+    uncachedStroke.setUseCache(false);
+    uncachedStroke.strokePath(path, bounds, &uncached);
+
+    size_t prevLimit = SkStrokeCache::SetByteLimit(1024 * 1024);
+    SkStrokeCache::Stats before, after;
+    SkStrokeCache::GetStats(&before);
+    for (int i = 0; i < 2; ++i) {
+        SkPath cached;
+        stroke.strokePath(path, bounds, &cached);
+        REPORTER_ASSERT(reporter, cached == uncached);
+
+        SkPath inPlace(path);
+        stroke.strokePath(inPlace, bounds, &inPlace);
+        REPORTER_ASSERT(reporter, inPlace == uncached);
+    }
+    SkStrokeCache::GetStats(&after);
+    REPORTER_ASSERT(reporter, after.fHits >= before.fHits + 3);
+    SkStrokeCache::SetByteLimit(prevLimit);
+}
+
 static void TestStroke(skiatest::Reporter* reporter) {
     test_strokerect(reporter);
+    test_strokecache(reporter);
+    test_unitnormals(reporter);
+    test_polyline_stroker(reporter);
+    test_cullpath(reporter);
 }
 
 #include "TestClassDef.h"